@@ -0,0 +1,7 @@
+// Pairs with PackedMesh.vert: a fixed light in the mesh's own space, so
+// cooked meshes can be looked at without a material.
+float4 main(float2 TexCoord : TEXCOORD0, float3 Normal : TEXCOORD1) : SV_Target0
+{
+    float light = saturate(dot(normalize(Normal), normalize(float3(0.4f, 0.7f, 0.6f))));
+    return float4((0.25f + 0.75f * light).xxx, 1.0f);
+}
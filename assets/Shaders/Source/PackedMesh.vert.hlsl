@@ -0,0 +1,41 @@
+// Vertices packed by the cook target (PackedMeshVertex in src/mesh.hpp):
+// SHORT4_NORM positions scaled back by the mesh's own offset and scale,
+// BYTE4_NORM octahedral normals and HALF2 texture coordinates.
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 transform : packoffset(c0);
+    float4 PositionOffset : packoffset(c4);
+    float4 PositionScale : packoffset(c5);
+};
+
+struct Input
+{
+    float4 Position : TEXCOORD0;
+    float4 Normal : TEXCOORD1;
+    float2 TexCoord : TEXCOORD2;
+};
+
+struct Output
+{
+    float2 TexCoord : TEXCOORD0;
+    float3 Normal : TEXCOORD1;
+    float4 Position : SV_Position;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy -= t * float2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    return normalize(n);
+}
+
+Output main(Input input)
+{
+    Output output;
+    float3 position = PositionOffset.xyz + PositionScale.xyz * input.Position.xyz;
+    output.TexCoord = input.TexCoord;
+    output.Normal = DecodeOctahedral(input.Normal.xy);
+    output.Position = mul(transform, float4(position, 1.0f));
+    return output;
+}
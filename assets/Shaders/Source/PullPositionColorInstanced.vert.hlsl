@@ -0,0 +1,38 @@
+struct InstanceData
+{
+    float4x4 Model;
+    float4 Color;
+};
+
+struct Input
+{
+    float3 Position : TEXCOORD0;
+    float4 Color : TEXCOORD1;
+    uint InstanceIndex : SV_InstanceID;
+};
+
+struct Output
+{
+    float4 Color : TEXCOORD0;
+    float4 Position : SV_Position;
+};
+
+StructuredBuffer<InstanceData> InstanceBuffer : register(t0, space0);
+
+cbuffer UniformBlock : register(b0, space1)
+{
+    float4x4 ViewProjectionMatrix : packoffset(c0);
+    uint BaseInstance : packoffset(c4.x);
+};
+
+Output main(Input input)
+{
+    // SV_InstanceID starts at 0 on every backend, whatever first_instance was
+    InstanceData instance = InstanceBuffer[BaseInstance + input.InstanceIndex];
+
+    Output output;
+    output.Color = input.Color * instance.Color;
+    float4 world = mul(instance.Model, float4(input.Position, 1.0f));
+    output.Position = mul(ViewProjectionMatrix, world);
+    return output;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Each benchmark is a subcommand of VideoGame_bench, taking the remaining
+// command line arguments and returning a process exit code.
+typedef int (*BenchFunction)(int argc, char *argv[]);
+
+int BenchBatching(int argc, char *argv[]);
+int BenchCulling(int argc, char *argv[]);
+int BenchFrameAllocator(int argc, char *argv[]);
+int BenchFrameLoop(int argc, char *argv[]);
+int BenchHDR(int argc, char *argv[]);
+int BenchInput(int argc, char *argv[]);
+int BenchJobs(int argc, char *argv[]);
+int BenchLODs(int argc, char *argv[]);
+int BenchMeshes(int argc, char *argv[]);
+int BenchMips(int argc, char *argv[]);
+int BenchPipelines(int argc, char *argv[]);
+int BenchProfiler(int argc, char *argv[]);
+int BenchRenderGraph(int argc, char *argv[]);
+int BenchRenderQueue(int argc, char *argv[]);
+int BenchScheduler(int argc, char *argv[]);
+int BenchTextures(int argc, char *argv[]);
+int BenchTimestep(int argc, char *argv[]);
+int BenchTransforms(int argc, char *argv[]);
+int BenchUpload(int argc, char *argv[]);
+
+// Milliseconds since start (SDL_GetTicksNS).
+static inline double BenchElapsedMS(Uint64 start)
+{
+    return (SDL_GetTicksNS() - start) / 1e6;
+}
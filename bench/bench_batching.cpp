@@ -0,0 +1,338 @@
+#include <SDL3/SDL.h>
+#include <batching.hpp>
+
+#include "bench.hpp"
+
+// 100k sprites in eight texture runs, kept as structure-of-arrays streams the
+// way a sprite system would, and 100k mesh instances scattered over 32 meshes
+// and 8 materials. Both batchers run on a frame allocator without a GPU
+// device: everything up to the upload happens, the draws are replayed through
+// a render queue without a render pass, and the packed bytes are compared
+// between paths and threads.
+#define BENCH_BATCH_SPRITES 100000
+#define BENCH_BATCH_TEXTURES 8
+#define BENCH_BATCH_INSTANCES 100000
+#define BENCH_BATCH_MESHES 32
+#define BENCH_BATCH_MATERIALS 8
+#define BENCH_BATCH_FRAMES 20
+// Two, so every other frame packs at an offset into the allocator's buffer
+#define BENCH_BATCH_FRAMES_IN_FLIGHT 2
+
+static const char *PATH_NAMES[] = { "auto", "scalar", "sse2" };
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static float RandomFloat(Uint32 *seed, float low, float high)
+{
+    return low + NextRandom(seed) / 16777216.0f * (high - low);
+}
+
+typedef struct BenchSprites
+{
+    float *streams[10];             // x, y, z, rotation, scale_x, scale_y, u, v, w, h
+    Uint32 *color;
+    Uint32 count;
+} BenchSprites;
+
+static bool CreateBenchSprites(Uint32 count, BenchSprites *sprites)
+{
+    sprites->count = count;
+    sprites->color = static_cast<Uint32*>(SDL_malloc(count * sizeof(Uint32)));
+    bool ok = sprites->color != NULL;
+    for (int s = 0; s < 10; s++) {
+        sprites->streams[s] = static_cast<float*>(SDL_malloc(count * sizeof(float)));
+        ok = ok && sprites->streams[s] != NULL;
+    }
+    if (!ok) {
+        return false;
+    }
+    Uint32 seed = 31337;
+    for (Uint32 i = 0; i < count; i++) {
+        sprites->streams[0][i] = RandomFloat(&seed, 0.0f, 1920.0f);
+        sprites->streams[1][i] = RandomFloat(&seed, 0.0f, 1080.0f);
+        sprites->streams[2][i] = RandomFloat(&seed, 0.0f, 1.0f);
+        sprites->streams[3][i] = RandomFloat(&seed, 0.0f, 2.0f * SDL_PI_F);
+        sprites->streams[4][i] = RandomFloat(&seed, 8.0f, 64.0f);
+        sprites->streams[5][i] = RandomFloat(&seed, 8.0f, 64.0f);
+        sprites->streams[6][i] = (NextRandom(&seed) % 4) * 0.25f;
+        sprites->streams[7][i] = (NextRandom(&seed) % 4) * 0.25f;
+        sprites->streams[8][i] = 0.25f;
+        sprites->streams[9][i] = 0.25f;
+        sprites->color[i] = NextRandom(&seed) | 0xFF000000u;
+    }
+    return true;
+}
+
+static void DestroyBenchSprites(BenchSprites *sprites)
+{
+    for (int s = 0; s < 10; s++) {
+        SDL_free(sprites->streams[s]);
+    }
+    SDL_free(sprites->color);
+}
+
+// Streams for sprites [first, first + count).
+static SpriteStreams GetSpriteStreams(const BenchSprites *sprites, Uint32 first, Uint32 count)
+{
+    SpriteStreams streams;
+    streams.x = sprites->streams[0] + first;
+    streams.y = sprites->streams[1] + first;
+    streams.z = sprites->streams[2] + first;
+    streams.rotation = sprites->streams[3] + first;
+    streams.scale_x = sprites->streams[4] + first;
+    streams.scale_y = sprites->streams[5] + first;
+    streams.u = sprites->streams[6] + first;
+    streams.v = sprites->streams[7] + first;
+    streams.w = sprites->streams[8] + first;
+    streams.h = sprites->streams[9] + first;
+    streams.color = sprites->color + first;
+    streams.count = count;
+    return streams;
+}
+
+// Single-threaded packing: sprites, then instances on every path. False if
+// an instance path writes different bytes from the scalar one.
+static bool BenchPackPaths(const BenchSprites *sprites, GPUSprite *out)
+{
+    SDL_Log("Packing, one thread, mean of %d frames:", BENCH_BATCH_FRAMES);
+    SpriteStreams streams = GetSpriteStreams(sprites, 0, sprites->count);
+    Uint64 start = SDL_GetTicksNS();
+    for (int frame = 0; frame < BENCH_BATCH_FRAMES; frame++) {
+        PackSprites(&streams, 0, sprites->count, out);
+    }
+    double sprite_ms = BenchElapsedMS(start) / BENCH_BATCH_FRAMES;
+    SDL_Log("  sprites          %7.3f ms  %8.0f sprites/ms", sprite_ms, sprite_ms > 0.0 ? sprites->count / sprite_ms : 0.0);
+
+    // Instances are gathered in the order grouping leaves them, which is all over the source
+    const Uint32 count = BENCH_BATCH_INSTANCES;
+    GPUInstance *source = static_cast<GPUInstance*>(SDL_malloc(count * sizeof(GPUInstance)));
+    GPUInstance *packed = static_cast<GPUInstance*>(SDL_malloc(count * sizeof(GPUInstance)));
+    GPUInstance *expected = static_cast<GPUInstance*>(SDL_malloc(count * sizeof(GPUInstance)));
+    Uint32 *order = static_cast<Uint32*>(SDL_malloc(count * sizeof(Uint32)));
+    if (source == NULL || packed == NULL || expected == NULL || order == NULL) {
+        SDL_free(order);
+        SDL_free(expected);
+        SDL_free(packed);
+        SDL_free(source);
+        return false;
+    }
+    Uint32 seed = 7;
+    for (Uint32 i = 0; i < count; i++) {
+        for (int e = 0; e < 16; e++) {
+            source[i].model[e] = RandomFloat(&seed, -1.0f, 1.0f);
+        }
+        for (int c = 0; c < 4; c++) {
+            source[i].color[c] = RandomFloat(&seed, 0.0f, 1.0f);
+        }
+        order[i] = i;
+    }
+    for (Uint32 i = count - 1; i > 0; i--) {
+        Uint32 j = NextRandom(&seed) % (i + 1);
+        Uint32 swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+    PackInstances(source, order, count, expected, BATCH_PACK_SCALAR);
+
+    bool all_match = true;
+    double scalar_ms = 0.0;
+    for (int path = BATCH_PACK_SCALAR; path <= BATCH_PACK_SSE2; path++) {
+        if (ResolveBatchPackPath((BatchPackPath)path) != path) {
+            SDL_Log("  instances %-6s not supported on this CPU/compiler", PATH_NAMES[path]);
+            continue;
+        }
+        SDL_memset(packed, 0, count * sizeof(GPUInstance));
+        start = SDL_GetTicksNS();
+        for (int frame = 0; frame < BENCH_BATCH_FRAMES; frame++) {
+            PackInstances(source, order, count, packed, (BatchPackPath)path);
+        }
+        double mean_ms = BenchElapsedMS(start) / BENCH_BATCH_FRAMES;
+        bool matches = SDL_memcmp(packed, expected, count * sizeof(GPUInstance)) == 0;
+        if (path == BATCH_PACK_SCALAR) {
+            scalar_ms = mean_ms;
+        }
+        SDL_Log("  instances %-6s %7.3f ms  %8.0f instances/ms (%.2fx)  %s", PATH_NAMES[path], mean_ms,
+                mean_ms > 0.0 ? count / mean_ms : 0.0, mean_ms > 0.0 ? scalar_ms / mean_ms : 0.0,
+                matches ? "matches" : "MISMATCH");
+        all_match = all_match && matches;
+    }
+
+    SDL_free(order);
+    SDL_free(expected);
+    SDL_free(packed);
+    SDL_free(source);
+    return all_match;
+}
+
+// The whole SpriteBatch frame with the job system; the packed buffer must
+// match single-threaded packing.
+static bool BenchSpriteBatch(const BenchSprites *sprites, JobSystem *jobs, RenderQueue *queue, const GPUSprite *expected)
+{
+    SpriteBatch *batch = CreateSpriteBatch(jobs, sprites->count);
+    FrameAllocator *frame_allocator = CreateFrameAllocator(NULL, BENCH_BATCH_FRAMES_IN_FLIGHT, 0,
+                                                           (sprites->count + 1) * sizeof(GPUSprite));
+    if (batch == NULL || frame_allocator == NULL) {
+        SDL_Log("Failed to create sprite batch");
+        DestroyFrameAllocator(frame_allocator);
+        DestroySpriteBatch(batch);
+        return false;
+    }
+    SDL_GPUTextureSamplerBinding textures[BENCH_BATCH_TEXTURES];
+    for (int t = 0; t < BENCH_BATCH_TEXTURES; t++) {
+        textures[t].texture = reinterpret_cast<SDL_GPUTexture*>((uintptr_t)(t + 1) * 16);
+        textures[t].sampler = NULL;
+    }
+    const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    double pack_ms = 0.0;
+    SpriteBatchStats stats;
+    RenderQueueStats queue_stats;
+    for (int frame = 0; frame < BENCH_BATCH_FRAMES; frame++) {
+        BeginFrameAllocator(frame_allocator);
+        ClearSpriteBatch(batch);
+        Uint32 per_texture = sprites->count / BENCH_BATCH_TEXTURES;
+        for (int t = 0; t < BENCH_BATCH_TEXTURES; t++) {
+            Uint32 first = t * per_texture;
+            Uint32 count = t == BENCH_BATCH_TEXTURES - 1 ? sprites->count - first : per_texture;
+            SpriteStreams streams = GetSpriteStreams(sprites, first, count);
+            AddSprites(batch, &textures[t], &streams);
+        }
+        UploadSpriteBatch(batch, frame_allocator);
+
+        ResetRenderQueue(queue);
+        SubmitSpriteBatch(batch, AcquireRenderBucket(queue), reinterpret_cast<SDL_GPUGraphicsPipeline*>(16), 0, 0, identity);
+        SortRenderQueue(queue);
+        ExecuteRenderQueue(queue, NULL, NULL, 0, 255);
+        FlushFrameAllocator(frame_allocator, NULL);
+        SubmitFrameAllocator(frame_allocator, NULL);
+        stats = GetSpriteBatchStats(batch);
+        queue_stats = GetRenderQueueStats(queue);
+        pack_ms += stats.pack_ms;
+    }
+
+    // Packed by chunks on the workers; must match the single-threaded pack
+    const GPUSprite *packed = GetHeadlessSpriteData(batch);
+    bool matches = packed != NULL && SDL_memcmp(packed, expected, sprites->count * sizeof(GPUSprite)) == 0;
+
+    double mean_ms = pack_ms / BENCH_BATCH_FRAMES;
+    SDL_Log("Sprite batch, %d workers: %u sprites in %u chunks, %.3f ms  %8.0f sprites/ms; %u draws, %u sampler binds",
+            GetJobWorkerCount(jobs), stats.sprites, stats.chunks, mean_ms, mean_ms > 0.0 ? stats.sprites / mean_ms : 0.0,
+            queue_stats.draws, queue_stats.sampler_binds);
+    bool ok = matches && queue_stats.draws == BENCH_BATCH_TEXTURES && stats.sprites == sprites->count;
+    if (!ok) {
+        SDL_Log("  MISMATCH");
+    }
+    DestroyFrameAllocator(frame_allocator);
+    DestroySpriteBatch(batch);
+    return ok;
+}
+
+static bool BenchInstances(Uint32 count, JobSystem *jobs, RenderQueue *queue)
+{
+    InstanceBatcher *batcher = CreateInstanceBatcher(jobs, count);
+    FrameAllocator *frame_allocator = CreateFrameAllocator(NULL, BENCH_BATCH_FRAMES_IN_FLIGHT, 0, (count + 1) * sizeof(GPUInstance));
+    if (batcher == NULL || frame_allocator == NULL) {
+        SDL_Log("Failed to create instance batcher");
+        DestroyFrameAllocator(frame_allocator);
+        DestroyInstanceBatcher(batcher);
+        return false;
+    }
+    for (int m = 0; m < BENCH_BATCH_MESHES; m++) {
+        InstanceMesh mesh;
+        SDL_zero(mesh);
+        mesh.vertex_buffer.buffer = reinterpret_cast<SDL_GPUBuffer*>((uintptr_t)(m + 1) * 16);
+        mesh.num_elements = 36;
+        AddInstanceMesh(batcher, &mesh);
+    }
+    for (int m = 0; m < BENCH_BATCH_MATERIALS; m++) {
+        InstanceMaterial material;
+        SDL_zero(material);
+        material.pipeline = reinterpret_cast<SDL_GPUGraphicsPipeline*>((uintptr_t)(m % 2 + 1) * 16);
+        material.pipeline_id = m % 2;
+        AddInstanceMaterial(batcher, &material);
+    }
+
+    Uint32 seed = 99;
+    float model[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    const float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    double sort_ms = 0.0, pack_ms = 0.0;
+    InstanceBatchStats stats;
+    RenderQueueStats queue_stats;
+    bool uploaded = true;
+    for (int frame = 0; frame < BENCH_BATCH_FRAMES; frame++) {
+        BeginFrameAllocator(frame_allocator);
+        ClearInstanceBatcher(batcher);
+        for (Uint32 i = 0; i < count; i++) {
+            model[12] = RandomFloat(&seed, -100.0f, 100.0f);
+            model[14] = RandomFloat(&seed, -100.0f, 100.0f);
+            AddInstance(batcher, NextRandom(&seed) % BENCH_BATCH_MESHES, NextRandom(&seed) % BENCH_BATCH_MATERIALS, model, color);
+        }
+        uploaded = UploadInstanceBatcher(batcher, frame_allocator) && uploaded;
+
+        ResetRenderQueue(queue);
+        SubmitInstanceBatcher(batcher, AcquireRenderBucket(queue), 0, identity);
+        SortRenderQueue(queue);
+        ExecuteRenderQueue(queue, NULL, NULL, 0, 255);
+        FlushFrameAllocator(frame_allocator, NULL);
+        SubmitFrameAllocator(frame_allocator, NULL);
+        stats = GetInstanceBatchStats(batcher);
+        queue_stats = GetRenderQueueStats(queue);
+        sort_ms += stats.sort_ms;
+        pack_ms += stats.pack_ms;
+    }
+    double mean_ms = (sort_ms + pack_ms) / BENCH_BATCH_FRAMES;
+    SDL_Log("Instances, %d workers: %u instances, grouping %.3f ms, packing %.3f ms  %8.0f instances/ms; "
+            "%u draws, %u pipeline binds",
+            GetJobWorkerCount(jobs), stats.instances, sort_ms / BENCH_BATCH_FRAMES, pack_ms / BENCH_BATCH_FRAMES,
+            mean_ms > 0.0 ? stats.instances / mean_ms : 0.0, queue_stats.draws, queue_stats.pipeline_binds);
+    bool ok = uploaded && queue_stats.draws == BENCH_BATCH_MESHES * BENCH_BATCH_MATERIALS && stats.instances == count;
+    if (!ok) {
+        SDL_Log("  MISMATCH: expected %d draws", BENCH_BATCH_MESHES * BENCH_BATCH_MATERIALS);
+    }
+    DestroyFrameAllocator(frame_allocator);
+    DestroyInstanceBatcher(batcher);
+    return ok;
+}
+
+int BenchBatching(int argc, char *argv[])
+{
+    Uint32 count = argc > 0 ? (Uint32)SDL_max(SDL_atoi(argv[0]), 64) : BENCH_BATCH_SPRITES;
+    BenchSprites sprites;
+    SDL_zero(sprites);
+    GPUSprite *out = static_cast<GPUSprite*>(SDL_malloc(count * sizeof(GPUSprite)));
+    GPUSprite *expected = static_cast<GPUSprite*>(SDL_malloc(count * sizeof(GPUSprite)));
+    RenderQueue *queue = CreateRenderQueue();
+    if (!CreateBenchSprites(count, &sprites) || out == NULL || expected == NULL || queue == NULL) {
+        SDL_Log("Out of memory");
+        return 1;
+    }
+
+    int result = BenchPackPaths(&sprites, out) ? 0 : 1;
+    SpriteStreams streams = GetSpriteStreams(&sprites, 0, count);
+    PackSprites(&streams, 0, count, expected);
+
+    // Serial, then on every core
+    int worker_counts[] = { 0, -1 };
+    for (int worker_count : worker_counts) {
+        JobSystem *jobs = CreateJobSystem(worker_count);
+        if (jobs == NULL) {
+            result = 1;
+            continue;
+        }
+        if (!BenchSpriteBatch(&sprites, jobs, queue, expected) || !BenchInstances(BENCH_BATCH_INSTANCES, jobs, queue)) {
+            result = 1;
+        }
+        DestroyJobSystem(jobs);
+    }
+
+    DestroyRenderQueue(queue);
+    SDL_free(expected);
+    SDL_free(out);
+    DestroyBenchSprites(&sprites);
+    return result;
+}
@@ -0,0 +1,172 @@
+#include <SDL3/SDL.h>
+#include <culling.hpp>
+
+#include "bench.hpp"
+
+// 1M boxes scattered through a 1 km cube, seen from the middle by a 60 degree
+// camera turning through 8 headings. The same bounds go into one world as
+// dynamic objects (brute force) and one as static objects (BVH); both must
+// agree on every path, before and after 1% of the static objects move a few
+// metres.
+#define BENCH_CULL_OBJECTS 1000000
+#define BENCH_CULL_HALF_SIZE 500.0f
+#define BENCH_CULL_VIEWS 8
+#define BENCH_CULL_MOVED_PERCENT 1
+#define BENCH_CULL_MOVE_DISTANCE 4.0f
+
+static const char *PATH_NAMES[] = { "auto", "scalar", "sse2", "avx2" };
+
+// glm::perspective * rotation about Y, column-major.
+static void BuildViewProjection(float yaw, float view_projection[16])
+{
+    const float fov = 60.0f * SDL_PI_F / 180.0f, aspect = 16.0f / 9.0f, near_plane = 0.1f, far_plane = 400.0f;
+    float f = 1.0f / SDL_tanf(fov * 0.5f);
+    float projection[16] = {};
+    projection[0] = f / aspect;
+    projection[5] = f;
+    projection[10] = (far_plane + near_plane) / (near_plane - far_plane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * far_plane * near_plane / (near_plane - far_plane);
+    float c = SDL_cosf(yaw), s = SDL_sinf(yaw);
+    float view[16] = { c, 0.0f, s, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -s, 0.0f, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                sum += projection[k * 4 + row] * view[column * 4 + k];
+            }
+            view_projection[column * 4 + row] = sum;
+        }
+    }
+}
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static void RandomBounds(Uint32 *seed, CullBounds *bounds)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        bounds->center[axis] = (NextRandom(seed) / 16777216.0f * 2.0f - 1.0f) * BENCH_CULL_HALF_SIZE;
+        bounds->extents[axis] = 0.25f + NextRandom(seed) / 16777216.0f * 2.0f;
+    }
+    bounds->radius = 0.0f;
+}
+
+static int CompareEntities(const void *a, const void *b)
+{
+    Uint32 x = entt::to_integral(*static_cast<const entt::entity*>(a));
+    Uint32 y = entt::to_integral(*static_cast<const entt::entity*>(b));
+    return x < y ? -1 : x > y;
+}
+
+static bool SameSet(entt::entity *a, Uint32 a_count, entt::entity *b, Uint32 b_count)
+{
+    if (a_count != b_count) {
+        return false;
+    }
+    SDL_qsort(a, a_count, sizeof(entt::entity), CompareEntities);
+    SDL_qsort(b, b_count, sizeof(entt::entity), CompareEntities);
+    return SDL_memcmp(a, b, a_count * sizeof(entt::entity)) == 0;
+}
+
+// Culls every view with every path; returns false on any disagreement with the reference.
+static bool RunViews(const char *label, const CullWorld *world, const CullWorld *reference,
+                     entt::entity *visible, entt::entity *expected)
+{
+    bool all_match = true;
+    SDL_Log("%s, mean of %d views:", label, BENCH_CULL_VIEWS);
+    double scalar_ms = 0.0;
+    for (int path = CULL_SCALAR; path <= CULL_AVX2; path++) {
+        if (ResolveCullPath((CullPath)path) != path) {
+            SDL_Log("  %-6s not supported on this CPU/compiler", PATH_NAMES[path]);
+            continue;
+        }
+        double total_ms = 0.0;
+        Uint64 visible_total = 0;
+        CullViewStats stats;
+        bool matches = true;
+        for (int view = 0; view < BENCH_CULL_VIEWS; view++) {
+            float view_projection[16];
+            Frustum frustum;
+            BuildViewProjection(view * 2.0f * SDL_PI_F / BENCH_CULL_VIEWS, view_projection);
+            ExtractFrustum(view_projection, &frustum);
+
+            Uint64 start = SDL_GetTicksNS();
+            Uint32 count = CullFrustum(world, &frustum, (CullPath)path, visible, &stats);
+            total_ms += BenchElapsedMS(start);
+            visible_total += count;
+
+            Uint32 expected_count = CullFrustum(reference, &frustum, CULL_SCALAR, expected, NULL);
+            matches = SameSet(visible, count, expected, expected_count) && matches;
+        }
+        double mean_ms = total_ms / BENCH_CULL_VIEWS;
+        if (path == CULL_SCALAR) {
+            scalar_ms = mean_ms;
+        }
+        SDL_Log("  %-6s %8.3f ms (%.2fx)  %7llu visible  %7u tested  %6u nodes, %5u inside  %s", PATH_NAMES[path], mean_ms,
+                mean_ms > 0.0 ? scalar_ms / mean_ms : 0.0, (unsigned long long)(visible_total / BENCH_CULL_VIEWS),
+                stats.tested, stats.nodes_visited, stats.nodes_inside, matches ? "matches" : "MISMATCH");
+        all_match = all_match && matches;
+    }
+    return all_match;
+}
+
+int BenchCulling(int argc, char *argv[])
+{
+    Uint32 count = argc > 0 ? (Uint32)SDL_max(SDL_atoi(argv[0]), 1) : BENCH_CULL_OBJECTS;
+    entt::registry registry;
+    CullWorld *dynamic_world = CreateCullWorld(count);
+    CullWorld *static_world = CreateCullWorld(0);
+    entt::entity *entities = static_cast<entt::entity*>(SDL_malloc(count * sizeof(entt::entity)));
+    CullBounds *bounds = static_cast<CullBounds*>(SDL_malloc(count * sizeof(CullBounds)));
+    entt::entity *visible = static_cast<entt::entity*>(SDL_malloc(count * sizeof(entt::entity)));
+    entt::entity *expected = static_cast<entt::entity*>(SDL_malloc(count * sizeof(entt::entity)));
+    if (dynamic_world == NULL || static_world == NULL || entities == NULL || bounds == NULL || visible == NULL || expected == NULL) {
+        SDL_Log("Out of memory");
+        return 1;
+    }
+
+    Uint32 seed = 12345;
+    for (Uint32 i = 0; i < count; i++) {
+        RandomBounds(&seed, &bounds[i]);
+        entities[i] = registry.create();
+        AddCullObject(dynamic_world, entities[i], &bounds[i], false);
+        AddCullObject(static_world, entities[i], &bounds[i], true);
+    }
+    Uint64 start = SDL_GetTicksNS();
+    UpdateCullWorld(static_world);
+    CullStats stats = GetCullStats(static_world);
+    SDL_Log("%u objects; BVH build %.1f ms, %u nodes, depth %u", count, BenchElapsedMS(start), stats.bvh_nodes, stats.bvh_depth);
+
+    int result = 0;
+    if (!RunViews("Dynamic (brute force)", dynamic_world, dynamic_world, visible, expected) ||
+        !RunViews("Static (BVH)", static_world, dynamic_world, visible, expected)) {
+        result = 1;
+    }
+
+    // Move a scattered 1%; the BVH refits instead of rebuilding.
+    for (Uint32 i = 0; i < count; i += 100 / BENCH_CULL_MOVED_PERCENT) {
+        for (int axis = 0; axis < 3; axis++) {
+            bounds[i].center[axis] += (NextRandom(&seed) / 16777216.0f * 2.0f - 1.0f) * BENCH_CULL_MOVE_DISTANCE;
+        }
+        SetCullBounds(dynamic_world, entities[i], &bounds[i]);
+        SetCullBounds(static_world, entities[i], &bounds[i]);
+    }
+    start = SDL_GetTicksNS();
+    UpdateCullWorld(static_world);
+    SDL_Log("Moved %d%% of the static objects; refit %.3f ms", BENCH_CULL_MOVED_PERCENT, BenchElapsedMS(start));
+    if (!RunViews("Static (BVH) after refit", static_world, dynamic_world, visible, expected)) {
+        result = 1;
+    }
+
+    DestroyCullWorld(static_world);
+    DestroyCullWorld(dynamic_world);
+    SDL_free(expected);
+    SDL_free(visible);
+    SDL_free(bounds);
+    SDL_free(entities);
+    return result;
+}
@@ -0,0 +1,201 @@
+#include <SDL3/SDL.h>
+#include <frame_allocator.hpp>
+
+#include "bench.hpp"
+
+// Per-draw transient data as a renderer would produce it: 10k draws a frame,
+// each with 64-256 bytes of uniforms and a few hundred bytes of dynamic
+// vertices. The frame allocator runs headless, so only the CPU side is timed,
+// against malloc/free of the same blocks.
+#define BENCH_FRAME_DRAWS 10000
+#define BENCH_FRAME_FRAMES 200
+#define BENCH_FRAMES_IN_FLIGHT 3
+#define BENCH_FRAME_CPU_BYTES (4 * 1024 * 1024)
+#define BENCH_FRAME_GPU_BYTES (8 * 1024 * 1024)
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static bool IsAligned(const void *pointer, size_t alignment)
+{
+    return ((uintptr_t)pointer & (alignment - 1)) == 0;
+}
+
+static bool CheckArena(void)
+{
+    FrameArena arena;
+    if (!InitFrameArena(&arena, 4096)) {
+        return false;
+    }
+    bool ok = true;
+    Uint8 *previous_end = arena.base;
+    for (size_t alignment = 1; alignment <= 256 && ok; alignment *= 2) {
+        Uint8 *memory = static_cast<Uint8*>(FrameArenaAlloc(&arena, 3, alignment));
+        if (memory == NULL || !IsAligned(memory, alignment) || memory < previous_end) {
+            SDL_Log("FAIL: arena allocation with alignment %u is misplaced", (unsigned)alignment);
+            ok = false;
+        }
+        previous_end = memory + 3;
+    }
+    // Above the base's own alignment the address still has to line up
+    void *page = FrameArenaAlloc(&arena, 16, 1024);
+    if (ok && (page == NULL || !IsAligned(page, 1024))) {
+        SDL_Log("FAIL: arena allocation with alignment 1024 is misplaced");
+        ok = false;
+    }
+    if (ok && FrameArenaAlloc(&arena, arena.capacity, 1) != NULL) {
+        SDL_Log("FAIL: arena handed out more than its capacity");
+        ok = false;
+    }
+    ResetFrameArena(&arena);
+    if (ok && FrameArenaAlloc(&arena, arena.capacity, 1) != arena.base) {
+        SDL_Log("FAIL: a reset arena does not start over at its base");
+        ok = false;
+    }
+    FreeFrameArena(&arena);
+    return ok;
+}
+
+// Slots rotate, keep their data until they come round again and reset then.
+static bool CheckFrames(FrameAllocator *allocator)
+{
+    FrameAllocatorStats stats = GetFrameAllocatorStats(allocator);
+    Uint32 region = stats.gpu_capacity;
+    Uint8 *first_cpu[BENCH_FRAMES_IN_FLIGHT];
+    Uint32 first_offset[BENCH_FRAMES_IN_FLIGHT];
+
+    for (Uint32 frame = 0; frame < 3 * BENCH_FRAMES_IN_FLIGHT; frame++) {
+        Uint32 slot = frame % BENCH_FRAMES_IN_FLIGHT;
+        BeginFrameAllocator(allocator);
+        Uint8 *cpu = static_cast<Uint8*>(FrameAlloc(allocator, 100 + frame, 16));
+        FrameBufferAllocation first, aligned;
+        if (cpu == NULL || !FrameAllocBuffer(allocator, 100, 0, &first) || !FrameAllocBuffer(allocator, 64, 512, &aligned)) {
+            SDL_Log("FAIL: frame %u could not allocate", frame);
+            return false;
+        }
+        if (first.offset % FRAME_BUFFER_ALIGNMENT != 0 || aligned.offset % 512 != 0 || aligned.offset < first.offset + 100 ||
+            first.offset / region != slot || (aligned.offset + 63) / region != slot) {
+            SDL_Log("FAIL: frame %u buffer offsets %u and %u are misaligned or outside slot %u", frame, first.offset, aligned.offset, slot);
+            return false;
+        }
+        if (frame < BENCH_FRAMES_IN_FLIGHT) {
+            first_cpu[slot] = cpu;
+            first_offset[slot] = first.offset;
+        } else if (cpu != first_cpu[slot] || first.offset != first_offset[slot]) {
+            SDL_Log("FAIL: frame %u did not reuse slot %u from the start", frame, slot);
+            return false;
+        }
+
+        // The frames still in flight keep what they wrote
+        for (Uint32 i = 1; i < BENCH_FRAMES_IN_FLIGHT && frame >= i; i++) {
+            Uint32 other = (frame - i) % BENCH_FRAMES_IN_FLIGHT;
+            if (first_cpu[other][0] != (Uint8)(frame - i) || first_cpu[other][99 + frame - i] != (Uint8)(frame - i)) {
+                SDL_Log("FAIL: frame %u overwrote frame %u", frame, frame - i);
+                return false;
+            }
+        }
+        SDL_memset(cpu, frame, 100 + frame);
+        SDL_memset(first.data, frame, 100);
+
+        FlushFrameAllocator(allocator, NULL);
+        SubmitFrameAllocator(allocator, NULL);
+    }
+
+    // Too big for a frame: counted, nothing handed out
+    BeginFrameAllocator(allocator);
+    FrameBufferAllocation too_big;
+    bool overflowed = FrameAlloc(allocator, BENCH_FRAME_CPU_BYTES + 1, 1) == NULL && !FrameAllocBuffer(allocator, region + 1, 0, &too_big);
+    SubmitFrameAllocator(allocator, NULL);
+    stats = GetFrameAllocatorStats(allocator);
+    if (!overflowed || stats.failures != 2 || stats.cpu_last_frame != 0 || stats.cpu_high_water != 100 + 3 * BENCH_FRAMES_IN_FLIGHT - 1) {
+        SDL_Log("FAIL: overflow gave %u failures, last frame %u bytes, high water %u bytes",
+                stats.failures, (unsigned)stats.cpu_last_frame, (unsigned)stats.cpu_high_water);
+        return false;
+    }
+    return true;
+}
+
+int BenchFrameAllocator(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (!CheckArena()) {
+        return 1;
+    }
+    FrameAllocator *allocator = CreateFrameAllocator(NULL, BENCH_FRAMES_IN_FLIGHT, BENCH_FRAME_CPU_BYTES, BENCH_FRAME_GPU_BYTES);
+    if (allocator == NULL) {
+        return 1;
+    }
+    if (!CheckFrames(allocator)) {
+        DestroyFrameAllocator(allocator);
+        return 1;
+    }
+
+    Uint32 sizes[BENCH_FRAME_DRAWS];
+    Uint32 seed = 1;
+    for (Uint32 i = 0; i < BENCH_FRAME_DRAWS; i++) {
+        sizes[i] = 64 + (NextRandom(&seed) % 4) * 64;
+    }
+
+    void **blocks = static_cast<void**>(SDL_malloc(BENCH_FRAME_DRAWS * sizeof(void*)));
+    if (blocks == NULL) {
+        DestroyFrameAllocator(allocator);
+        return 1;
+    }
+    Uint64 start = SDL_GetTicksNS();
+    Uint64 checksum = 0;
+    for (Uint32 frame = 0; frame < BENCH_FRAME_FRAMES; frame++) {
+        for (Uint32 i = 0; i < BENCH_FRAME_DRAWS; i++) {
+            blocks[i] = SDL_malloc(sizes[i]);
+            if (blocks[i] != NULL) {
+                SDL_memset(blocks[i], (int)i, 16);
+                checksum += static_cast<Uint8*>(blocks[i])[15];
+            }
+        }
+        for (Uint32 i = 0; i < BENCH_FRAME_DRAWS; i++) {
+            SDL_free(blocks[i]);
+        }
+    }
+    double malloc_ms = BenchElapsedMS(start);
+    SDL_free(blocks);
+
+    start = SDL_GetTicksNS();
+    Uint32 vertex_bytes = 0;
+    for (Uint32 frame = 0; frame < BENCH_FRAME_FRAMES; frame++) {
+        BeginFrameAllocator(allocator);
+        for (Uint32 i = 0; i < BENCH_FRAME_DRAWS; i++) {
+            Uint8 *uniforms = static_cast<Uint8*>(FrameAlloc(allocator, sizes[i], 16));
+            if (uniforms != NULL) {
+                SDL_memset(uniforms, (int)i, 16);
+                checksum -= uniforms[15];
+            }
+            FrameBufferAllocation vertices;
+            if (FrameAllocBuffer(allocator, 3 * sizes[i], 16, &vertices)) {
+                vertex_bytes += 3 * sizes[i];
+            }
+        }
+        FlushFrameAllocator(allocator, NULL);
+        SubmitFrameAllocator(allocator, NULL);
+    }
+    double frame_ms = BenchElapsedMS(start);
+
+    FrameAllocatorStats stats = GetFrameAllocatorStats(allocator);
+    DestroyFrameAllocator(allocator);
+    if (checksum != 0 || stats.failures != 2) {
+        SDL_Log("FAIL: arena and malloc runs disagree, or %u allocations failed", stats.failures - 2);
+        return 1;
+    }
+
+    Uint32 allocations = BENCH_FRAME_DRAWS * BENCH_FRAME_FRAMES;
+    SDL_Log("%d frames of %d draws, %d frames in flight", BENCH_FRAME_FRAMES, BENCH_FRAME_DRAWS, BENCH_FRAMES_IN_FLIGHT);
+    SDL_Log("  malloc/free  %8.2f ms  %6.1f ns/allocation", malloc_ms, malloc_ms * 1e6 / allocations);
+    SDL_Log("  frame arena  %8.2f ms  %6.1f ns/allocation (CPU and GPU)", frame_ms, frame_ms * 1e6 / (2 * allocations));
+    SDL_Log("  high water   %.1f/%.1f KB CPU, %.1f/%.1f KB GPU per frame, %.1f MB of vertices",
+            stats.cpu_high_water / 1024.0, stats.cpu_capacity / 1024.0, stats.gpu_high_water / 1024.0,
+            stats.gpu_capacity / 1024.0, vertex_bytes / (1024.0 * 1024.0));
+    return 0;
+}
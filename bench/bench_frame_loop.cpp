@@ -0,0 +1,716 @@
+#include <SDL3/SDL.h>
+#include <entt/entt.hpp>
+#include <batching.hpp>
+#include <culling.hpp>
+#include <frame_allocator.hpp>
+#include <jobs.hpp>
+#include <render_graph.hpp>
+#include <render_queue.hpp>
+#include <transform.hpp>
+
+#include "bench.hpp"
+
+// The CPU side of SDL_AppIterate without a window or device: replayed input
+// moves objects and the camera, then the transform update, culling, instance
+// batching and render extraction (queue sort and replay, render graph
+// compile) run as they do in the game. Each stage is timed per frame and every
+// SDL allocation is counted.
+//
+//   VideoGame_bench frameloop [frames] [--objects N] [--replay file] [--record file] [--json file]
+//
+// Without --replay the input is a generated camera orbit with bursts of
+// moving objects; --record writes it out for later runs. The replay runs
+// twice on one scene, put back to its starting state in between, and both
+// passes must produce the same frames, so a regression in determinism fails
+// the run; the second, warm pass is the one reported.
+#define BENCH_LOOP_DEFAULT_FRAMES 600
+#define BENCH_LOOP_DEFAULT_OBJECTS 20000
+#define BENCH_LOOP_HALF_SIZE 200.0f
+#define BENCH_LOOP_MESHES 16
+#define BENCH_LOOP_MATERIALS 8
+#define BENCH_LOOP_FRAMES_IN_FLIGHT 3
+// One object in BENCH_LOOP_ANCHOR_RATIO anchors children and never moves
+#define BENCH_LOOP_ANCHOR_RATIO 16
+
+typedef enum BenchLoopStage
+{
+    BENCH_STAGE_INPUT,
+    BENCH_STAGE_SIMULATION,
+    BENCH_STAGE_CULLING,
+    BENCH_STAGE_BATCHING,
+    BENCH_STAGE_EXTRACTION,
+    BENCH_STAGE_FRAME,
+    BENCH_STAGE_COUNT
+} BenchLoopStage;
+
+static const char *STAGE_NAMES[BENCH_STAGE_COUNT] = { "input", "simulation", "culling", "batching", "extraction", "frame" };
+
+// One frame of recorded input.
+typedef struct BenchReplayFrame
+{
+    float eye[3];
+    float target[3];
+    Uint32 moved;               // Objects the player's actions moved this frame
+} BenchReplayFrame;
+
+typedef struct BenchLoopScene
+{
+    entt::registry registry;
+    Uint32 count;
+    entt::entity *entities;
+    Uint8 *meshes;              // Per entity index
+    Uint8 *materials;
+    LocalTransform *initial;    // Per entities[] slot, what ResetScene puts back
+    CullBounds bounds[BENCH_LOOP_MESHES];
+    TransformHierarchy *transforms;
+    CullWorld *culling;
+    JobSystem *jobs;
+    InstanceBatcher *batcher;
+    RenderQueue *queue;
+    RenderGraph *graph;
+    FrameAllocator *frame_allocator;
+} BenchLoopScene;
+
+typedef struct BenchLoopResults
+{
+    double *stage_ms[BENCH_STAGE_COUNT];        // Per frame
+    Uint32 *allocations;                        // Per frame
+    Uint64 *checksums;                          // Per frame
+    Uint64 visible;
+    Uint64 draws;
+} BenchLoopResults;
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+static SDL_malloc_func original_malloc;
+static SDL_calloc_func original_calloc;
+static SDL_realloc_func original_realloc;
+static SDL_free_func original_free;
+static SDL_AtomicInt allocation_count;
+
+static void* SDLCALL CountingMalloc(size_t size)
+{
+    SDL_AddAtomicInt(&allocation_count, 1);
+    return original_malloc(size);
+}
+
+static void* SDLCALL CountingCalloc(size_t count, size_t size)
+{
+    SDL_AddAtomicInt(&allocation_count, 1);
+    return original_calloc(count, size);
+}
+
+static void* SDLCALL CountingRealloc(void *memory, size_t size)
+{
+    SDL_AddAtomicInt(&allocation_count, 1);
+    return original_realloc(memory, size);
+}
+
+// Forwards to the functions in place before, so memory allocated before the
+// hook (or after it is removed) is freed by the allocator that made it.
+static void StartCountingAllocations(void)
+{
+    SDL_GetMemoryFunctions(&original_malloc, &original_calloc, &original_realloc, &original_free);
+    SDL_SetMemoryFunctions(CountingMalloc, CountingCalloc, CountingRealloc, original_free);
+}
+
+static void StopCountingAllocations(void)
+{
+    SDL_SetMemoryFunctions(original_malloc, original_calloc, original_realloc, original_free);
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static float RandomFloat(Uint32 *seed, float low, float high)
+{
+    return low + (high - low) * (NextRandom(seed) / 16777216.0f);
+}
+
+// A camera circling the field while it looks across it, with a burst of
+// movement (an explosion, a crowd starting to run) once a second.
+static void GenerateReplay(BenchReplayFrame *frames, Uint32 num_frames, Uint32 num_objects)
+{
+    for (Uint32 i = 0; i < num_frames; i++) {
+        float angle = i * 0.01f;
+        BenchReplayFrame *frame = &frames[i];
+        frame->eye[0] = SDL_cosf(angle) * 120.0f;
+        frame->eye[1] = 30.0f + 10.0f * SDL_sinf(angle * 3.0f);
+        frame->eye[2] = SDL_sinf(angle) * 120.0f;
+        frame->target[0] = SDL_cosf(angle + 2.0f) * 60.0f;
+        frame->target[1] = 0.0f;
+        frame->target[2] = SDL_sinf(angle + 2.0f) * 60.0f;
+        frame->moved = i % 60 == 0 ? num_objects / 2 : num_objects / 50;
+    }
+}
+
+static bool SaveReplay(const char *path, const BenchReplayFrame *frames, Uint32 num_frames)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (io == NULL) {
+        SDL_Log("Failed to write %s: %s", path, SDL_GetError());
+        return false;
+    }
+    SDL_IOprintf(io, "# frameloop replay: eye xyz, target xyz, objects moved\n");
+    for (Uint32 i = 0; i < num_frames; i++) {
+        const BenchReplayFrame *frame = &frames[i];
+        SDL_IOprintf(io, "%.6g %.6g %.6g %.6g %.6g %.6g %u\n", frame->eye[0], frame->eye[1], frame->eye[2],
+                     frame->target[0], frame->target[1], frame->target[2], frame->moved);
+    }
+    return SDL_CloseIO(io);
+}
+
+// Returns the frames read, at most max_frames, or 0 on a malformed file.
+static Uint32 LoadReplay(const char *path, BenchReplayFrame *frames, Uint32 max_frames)
+{
+    char *text = static_cast<char*>(SDL_LoadFile(path, NULL));
+    if (text == NULL) {
+        SDL_Log("Failed to read %s: %s", path, SDL_GetError());
+        return 0;
+    }
+    Uint32 count = 0;
+    char *line = text;
+    while (*line != '\0' && count < max_frames) {
+        char *end = SDL_strchr(line, '\n');
+        if (end != NULL) {
+            *end = '\0';
+        }
+        if (*line != '#' && *line != '\0' && *line != '\r') {
+            float values[7];
+            char *cursor = line;
+            for (int i = 0; i < 7; i++) {
+                char *next;
+                values[i] = (float)SDL_strtod(cursor, &next);
+                if (next == cursor) {
+                    SDL_Log("%s: malformed frame %u", path, count);
+                    SDL_free(text);
+                    return 0;
+                }
+                cursor = next;
+            }
+            BenchReplayFrame *frame = &frames[count++];
+            SDL_memcpy(frame->eye, values, sizeof(frame->eye));
+            SDL_memcpy(frame->target, values + 3, sizeof(frame->target));
+            frame->moved = (Uint32)values[6];
+        }
+        if (end == NULL) {
+            break;
+        }
+        line = end + 1;
+    }
+    SDL_free(text);
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Scene
+// ---------------------------------------------------------------------------
+
+// glm::perspective(60 degrees) * glm::lookAt, column-major.
+static void BuildViewProjection(const float eye[3], const float target[3], float view_projection[16])
+{
+    float forward[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    float length = SDL_sqrtf(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+    for (int i = 0; i < 3; i++) {
+        forward[i] /= length;
+    }
+    // right = normalize(cross(forward, up)) with up = +Y; up' = cross(right, forward)
+    float right[3] = { -forward[2], 0.0f, forward[0] };
+    length = SDL_sqrtf(right[0] * right[0] + right[2] * right[2]);
+    right[0] /= length;
+    right[2] /= length;
+    float up[3] = { right[1] * forward[2] - right[2] * forward[1], right[2] * forward[0] - right[0] * forward[2],
+                    right[0] * forward[1] - right[1] * forward[0] };
+    float view[16] = {
+        right[0], up[0], -forward[0], 0.0f,
+        right[1], up[1], -forward[1], 0.0f,
+        right[2], up[2], -forward[2], 0.0f,
+        -(right[0] * eye[0] + right[1] * eye[1] + right[2] * eye[2]),
+        -(up[0] * eye[0] + up[1] * eye[1] + up[2] * eye[2]),
+        forward[0] * eye[0] + forward[1] * eye[1] + forward[2] * eye[2], 1.0f,
+    };
+
+    const float fov = 60.0f * SDL_PI_F / 180.0f, aspect = 16.0f / 9.0f, near_plane = 0.1f, far_plane = 400.0f;
+    float f = 1.0f / SDL_tanf(fov * 0.5f);
+    float projection[16] = {};
+    projection[0] = f / aspect;
+    projection[5] = f;
+    projection[10] = (far_plane + near_plane) / (near_plane - far_plane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * far_plane * near_plane / (near_plane - far_plane);
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                sum += projection[k * 4 + row] * view[column * 4 + k];
+            }
+            view_projection[column * 4 + row] = sum;
+        }
+    }
+}
+
+static Uint32 EntityIndex(entt::entity entity)
+{
+    return (Uint32)entt::to_entity(entity);
+}
+
+static void DestroyScene(BenchLoopScene *scene)
+{
+    DestroyFrameAllocator(scene->frame_allocator);
+    DestroyRenderGraph(scene->graph);
+    DestroyRenderQueue(scene->queue);
+    DestroyInstanceBatcher(scene->batcher);
+    DestroyJobSystem(scene->jobs);
+    DestroyCullWorld(scene->culling);
+    DestroyTransformHierarchy(scene->transforms);
+    SDL_free(scene->initial);
+    SDL_free(scene->materials);
+    SDL_free(scene->meshes);
+    SDL_free(scene->entities);
+}
+
+// The same scene every time: objects scattered over the field, one in eight
+// of the others parented to an anchor, in BENCH_LOOP_MESHES shapes and
+// BENCH_LOOP_MATERIALS materials over two pipelines.
+static bool CreateScene(BenchLoopScene *scene, Uint32 count)
+{
+    scene->count = count;
+    scene->entities = static_cast<entt::entity*>(SDL_malloc(count * sizeof(entt::entity)));
+    scene->meshes = static_cast<Uint8*>(SDL_malloc(count));
+    scene->materials = static_cast<Uint8*>(SDL_malloc(count));
+    scene->initial = static_cast<LocalTransform*>(SDL_malloc(count * sizeof(LocalTransform)));
+    scene->transforms = CreateTransformHierarchy(count);
+    scene->culling = CreateCullWorld(count);
+    scene->jobs = CreateJobSystem(-1);
+    scene->batcher = scene->jobs != NULL ? CreateInstanceBatcher(scene->jobs, count) : NULL;
+    scene->queue = CreateRenderQueue();
+    scene->graph = CreateRenderGraph(NULL);
+    scene->frame_allocator = CreateFrameAllocator(NULL, BENCH_LOOP_FRAMES_IN_FLIGHT, count * sizeof(entt::entity) + 64 * 1024,
+                                                  (count + 1) * sizeof(GPUInstance));
+    if (scene->entities == NULL || scene->meshes == NULL || scene->materials == NULL || scene->initial == NULL || scene->transforms == NULL ||
+        scene->culling == NULL || scene->batcher == NULL || scene->queue == NULL || scene->graph == NULL ||
+        scene->frame_allocator == NULL) {
+        return false;
+    }
+
+    Uint32 seed = 7;
+    for (int m = 0; m < BENCH_LOOP_MESHES; m++) {
+        CullBounds *bounds = &scene->bounds[m];
+        SDL_zerop(bounds);
+        for (int axis = 0; axis < 3; axis++) {
+            bounds->extents[axis] = RandomFloat(&seed, 0.5f, 3.0f);
+        }
+        InstanceMesh mesh;
+        SDL_zero(mesh);
+        mesh.vertex_buffer.buffer = reinterpret_cast<SDL_GPUBuffer*>((uintptr_t)(m + 1) * 16);
+        mesh.num_elements = 36;
+        AddInstanceMesh(scene->batcher, &mesh);
+    }
+    for (int m = 0; m < BENCH_LOOP_MATERIALS; m++) {
+        InstanceMaterial material;
+        SDL_zero(material);
+        material.pipeline = reinterpret_cast<SDL_GPUGraphicsPipeline*>((uintptr_t)(m % 2 + 1) * 16);
+        material.pipeline_id = m % 2;
+        AddInstanceMaterial(scene->batcher, &material);
+    }
+
+    Uint32 num_anchors = count / BENCH_LOOP_ANCHOR_RATIO;
+    for (Uint32 i = 0; i < count; i++) {
+        entt::entity entity = scene->registry.create();
+        scene->entities[i] = entity;
+        Uint32 index = EntityIndex(entity);
+        if (index >= count) {
+            return false;
+        }
+        scene->meshes[index] = (Uint8)(NextRandom(&seed) % BENCH_LOOP_MESHES);
+        scene->materials[index] = (Uint8)(NextRandom(&seed) % BENCH_LOOP_MATERIALS);
+
+        bool child = i >= num_anchors && num_anchors > 0 && NextRandom(&seed) % 8 == 0;
+        entt::entity parent = child ? scene->entities[NextRandom(&seed) % num_anchors] : entt::null;
+        LocalTransform local = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+        float spread = child ? 5.0f : BENCH_LOOP_HALF_SIZE;
+        local.position[0] = RandomFloat(&seed, -spread, spread);
+        local.position[1] = child ? RandomFloat(&seed, 0.0f, 4.0f) : 0.0f;
+        local.position[2] = RandomFloat(&seed, -spread, spread);
+        if (!AddTransform(scene->transforms, entity, parent)) {
+            return false;
+        }
+        SetLocalTransform(scene->transforms, entity, &local);
+        scene->initial[i] = local;
+    }
+    UpdateTransforms(scene->transforms, TRANSFORM_UPDATE_AUTO);
+    for (Uint32 i = 0; i < count; i++) {
+        entt::entity entity = scene->entities[i];
+        float model[16];
+        CullBounds bounds;
+        GetWorldMatrix(scene->transforms, entity, model);
+        TransformCullBounds(&scene->bounds[scene->meshes[EntityIndex(entity)]], model, &bounds);
+        AddCullObject(scene->culling, entity, &bounds, true);
+    }
+    UpdateCullWorld(scene->culling);
+    return true;
+}
+
+// Moves every object back to where CreateScene put it. The BVH is only
+// refitted, so culling sees the same tree as on a fresh scene.
+static void ResetScene(BenchLoopScene *scene)
+{
+    for (Uint32 i = 0; i < scene->count; i++) {
+        SetLocalTransform(scene->transforms, scene->entities[i], &scene->initial[i]);
+    }
+    UpdateTransforms(scene->transforms, TRANSFORM_UPDATE_AUTO);
+    for (Uint32 i = 0; i < scene->count; i++) {
+        entt::entity entity = scene->entities[i];
+        float model[16];
+        CullBounds bounds;
+        GetWorldMatrix(scene->transforms, entity, model);
+        TransformCullBounds(&scene->bounds[scene->meshes[EntityIndex(entity)]], model, &bounds);
+        SetCullBounds(scene->culling, entity, &bounds);
+    }
+    UpdateCullWorld(scene->culling);
+}
+
+static Uint64 HashValue(Uint64 hash, Uint64 value)
+{
+    // 64-bit FNV-1a over the value's bytes
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void NoPass(const RenderPassContext *context, void *userdata)
+{
+    (void)context;
+    (void)userdata;
+}
+
+// The frame's passes as the game declares them, plus a debug view nothing
+// reads, which the graph culls.
+static bool CompileFrameGraph(RenderGraph *graph)
+{
+    ResetRenderGraph(graph);
+    RenderTextureDesc swapchain_desc = { "Swapchain", SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM, 1920, 1080, SDL_GPU_SAMPLECOUNT_1 };
+    RenderTextureDesc depth_desc = { "Depth", SDL_GPU_TEXTUREFORMAT_D32_FLOAT, 1920, 1080, SDL_GPU_SAMPLECOUNT_1 };
+    RenderTextureDesc debug_desc = { "Debug", SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 1920, 1080, SDL_GPU_SAMPLECOUNT_1 };
+    RenderResource swapchain = ImportRenderTexture(graph, reinterpret_cast<SDL_GPUTexture*>(16), &swapchain_desc);
+    RenderResource depth = CreateRenderTexture(graph, &depth_desc);
+    RenderResource debug = CreateRenderTexture(graph, &debug_desc);
+    SetRenderGraphOutput(graph, swapchain);
+
+    SDL_FColor clear_color = { 0.45f, 0.55f, 0.60f, 1.0f };
+    const RenderPassDesc scene_pass = { "Scene", RENDER_PASS_GRAPHICS, NoPass, NULL, NULL, false };
+    int pass = AddRenderPass(graph, &scene_pass);
+    AddRenderPassColorTarget(graph, pass, swapchain, SDL_GPU_LOADOP_CLEAR, clear_color);
+    SetRenderPassDepthTarget(graph, pass, depth, SDL_GPU_LOADOP_CLEAR, 1.0f);
+    const RenderPassDesc debug_pass = { "Debug", RENDER_PASS_GRAPHICS, NoPass, NULL, NULL, false };
+    pass = AddRenderPass(graph, &debug_pass);
+    AddRenderPassColorTarget(graph, pass, debug, SDL_GPU_LOADOP_CLEAR, clear_color);
+    const RenderPassDesc imgui_pass = { "ImGui", RENDER_PASS_GRAPHICS, NoPass, NULL, NULL, false };
+    pass = AddRenderPass(graph, &imgui_pass);
+    AddRenderPassColorTarget(graph, pass, swapchain, SDL_GPU_LOADOP_LOAD, clear_color);
+    return CompileRenderGraph(graph);
+}
+
+// One frame of SDL_AppIterate's CPU work. Returns a checksum of what it produced.
+static Uint64 RunFrame(BenchLoopScene *scene, const BenchReplayFrame *input, Uint32 frame_index, double stage_ms[BENCH_STAGE_COUNT],
+                       Uint32 *num_visible, Uint32 *num_draws)
+{
+    Uint64 frame_start = SDL_GetTicksNS();
+
+    // Input: the recorded actions move objects; anchors stay put so their children only move when picked
+    Uint64 start = SDL_GetTicksNS();
+    Uint32 num_anchors = scene->count / BENCH_LOOP_ANCHOR_RATIO;
+    Uint32 movable = scene->count - num_anchors;
+    Uint32 moved = SDL_min(input->moved, movable);
+    Uint32 first_moved = (frame_index * 7919u) % movable;
+    for (Uint32 i = 0; i < moved; i++) {
+        entt::entity entity = scene->entities[num_anchors + (first_moved + i) % movable];
+        LocalTransform local;
+        GetLocalTransform(scene->transforms, entity, &local);
+        float angle = 0.05f * (float)((frame_index + i) % 16);
+        local.position[0] += SDL_cosf(angle) * 0.25f;
+        local.position[2] += SDL_sinf(angle) * 0.25f;
+        local.rotation[1] = SDL_sinf(angle * 0.5f);
+        local.rotation[3] = SDL_cosf(angle * 0.5f);
+        SetLocalTransform(scene->transforms, entity, &local);
+    }
+    BeginFrameAllocator(scene->frame_allocator);
+    float *view_projection = static_cast<float*>(FrameAlloc(scene->frame_allocator, 16 * sizeof(float), 16));
+    BuildViewProjection(input->eye, input->target, view_projection);
+    stage_ms[BENCH_STAGE_INPUT] = BenchElapsedMS(start);
+
+    start = SDL_GetTicksNS();
+    UpdateTransforms(scene->transforms, TRANSFORM_UPDATE_AUTO);
+    stage_ms[BENCH_STAGE_SIMULATION] = BenchElapsedMS(start);
+
+    // Culling: refit the moved objects' bounds, then the camera's visible set
+    start = SDL_GetTicksNS();
+    for (Uint32 i = 0; i < moved; i++) {
+        entt::entity entity = scene->entities[num_anchors + (first_moved + i) % movable];
+        float model[16];
+        CullBounds bounds;
+        GetWorldMatrix(scene->transforms, entity, model);
+        TransformCullBounds(&scene->bounds[scene->meshes[EntityIndex(entity)]], model, &bounds);
+        SetCullBounds(scene->culling, entity, &bounds);
+    }
+    UpdateCullWorld(scene->culling);
+    Frustum frustum;
+    ExtractFrustum(view_projection, &frustum);
+    entt::entity *visible = static_cast<entt::entity*>(FrameAlloc(scene->frame_allocator, scene->count * sizeof(entt::entity), alignof(entt::entity)));
+    *num_visible = CullFrustum(scene->culling, &frustum, CULL_AUTO, visible, NULL);
+    stage_ms[BENCH_STAGE_CULLING] = BenchElapsedMS(start);
+
+    start = SDL_GetTicksNS();
+    ClearInstanceBatcher(scene->batcher);
+    const float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (Uint32 i = 0; i < *num_visible; i++) {
+        float model[16];
+        Uint32 index = EntityIndex(visible[i]);
+        GetWorldMatrix(scene->transforms, visible[i], model);
+        AddInstance(scene->batcher, scene->meshes[index], scene->materials[index], model, color);
+    }
+    UploadInstanceBatcher(scene->batcher, scene->frame_allocator);
+    stage_ms[BENCH_STAGE_BATCHING] = BenchElapsedMS(start);
+
+    start = SDL_GetTicksNS();
+    ResetRenderQueue(scene->queue);
+    SubmitInstanceBatcher(scene->batcher, AcquireRenderBucket(scene->queue), 0, view_projection);
+    SortRenderQueue(scene->queue);
+    ExecuteRenderQueue(scene->queue, NULL, NULL, 0, 255);
+    bool compiled = CompileFrameGraph(scene->graph);
+    FlushFrameAllocator(scene->frame_allocator, NULL);
+    SubmitFrameAllocator(scene->frame_allocator, NULL);
+    stage_ms[BENCH_STAGE_EXTRACTION] = BenchElapsedMS(start);
+    stage_ms[BENCH_STAGE_FRAME] = BenchElapsedMS(frame_start);
+
+    RenderQueueStats queue_stats = GetRenderQueueStats(scene->queue);
+    RenderGraphStats graph_stats = GetRenderGraphStats(scene->graph);
+    *num_draws = queue_stats.draws;
+    Uint64 checksum = 0xcbf29ce484222325ULL;
+    for (Uint32 i = 0; i < *num_visible; i++) {
+        checksum = HashValue(checksum, entt::to_integral(visible[i]));
+    }
+    checksum = HashValue(checksum, queue_stats.draws);
+    checksum = HashValue(checksum, queue_stats.pipeline_binds);
+    checksum = HashValue(checksum, queue_stats.buffer_binds);
+    checksum = HashValue(checksum, GetInstanceBatchStats(scene->batcher).instances);
+    checksum = HashValue(checksum, compiled ? graph_stats.groups << 8 | graph_stats.culled : 0);
+    return checksum;
+}
+
+static void RunReplay(BenchLoopScene *scene, const BenchReplayFrame *frames, Uint32 num_frames, BenchLoopResults *results)
+{
+    results->visible = 0;
+    results->draws = 0;
+    StartCountingAllocations();
+    for (Uint32 i = 0; i < num_frames; i++) {
+        double stage_ms[BENCH_STAGE_COUNT];
+        Uint32 num_visible, num_draws;
+        int allocations_before = SDL_GetAtomicInt(&allocation_count);
+        results->checksums[i] = RunFrame(scene, &frames[i], i, stage_ms, &num_visible, &num_draws);
+        results->allocations[i] = (Uint32)(SDL_GetAtomicInt(&allocation_count) - allocations_before);
+        for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+            results->stage_ms[stage][i] = stage_ms[stage];
+        }
+        results->visible += num_visible;
+        results->draws += num_draws;
+    }
+    StopCountingAllocations();
+}
+
+// ---------------------------------------------------------------------------
+// Report
+// ---------------------------------------------------------------------------
+
+typedef struct BenchDistribution
+{
+    double mean;
+    double p50;
+    double p99;
+    double max;
+} BenchDistribution;
+
+static int CompareDoubles(const void *a, const void *b)
+{
+    double x = *static_cast<const double*>(a), y = *static_cast<const double*>(b);
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Nearest-rank percentiles; sorts values.
+static BenchDistribution Summarize(double *values, Uint32 count)
+{
+    BenchDistribution distribution = {};
+    SDL_qsort(values, count, sizeof(double), CompareDoubles);
+    for (Uint32 i = 0; i < count; i++) {
+        distribution.mean += values[i] / count;
+    }
+    distribution.p50 = values[(Uint32)SDL_ceil(0.50 * count) - 1];
+    distribution.p99 = values[(Uint32)SDL_ceil(0.99 * count) - 1];
+    distribution.max = values[count - 1];
+    return distribution;
+}
+
+static bool WriteJSON(const char *path, const char *replay, Uint32 num_frames, Uint32 num_objects, int workers,
+                      const BenchDistribution stages[BENCH_STAGE_COUNT], const BenchDistribution *allocations,
+                      Uint32 cold_allocations, const BenchLoopResults *results)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (io == NULL) {
+        SDL_Log("Failed to write %s: %s", path, SDL_GetError());
+        return false;
+    }
+    SDL_IOprintf(io, "{\n  \"bench\": \"frameloop\",\n  \"replay\": \"%s\",\n  \"frames\": %u,\n  \"objects\": %u,\n  \"workers\": %d,\n",
+                 replay, num_frames, num_objects, workers);
+    SDL_IOprintf(io, "  \"deterministic\": true,\n  \"visible_per_frame\": %.1f,\n  \"draws_per_frame\": %.1f,\n",
+                 (double)results->visible / num_frames, (double)results->draws / num_frames);
+    SDL_IOprintf(io, "  \"stages_ms\": {\n");
+    for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+        const BenchDistribution *d = &stages[stage];
+        SDL_IOprintf(io, "    \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+                     STAGE_NAMES[stage], d->mean, d->p50, d->p99, d->max, stage + 1 < BENCH_STAGE_COUNT ? "," : "");
+    }
+    SDL_IOprintf(io, "  },\n  \"allocations_per_frame\": { \"mean\": %.2f, \"p50\": %.0f, \"p99\": %.0f, \"max\": %.0f, \"first_pass_total\": %u }\n}\n",
+                 allocations->mean, allocations->p50, allocations->p99, allocations->max, cold_allocations);
+    return SDL_CloseIO(io);
+}
+
+static void FreeResults(BenchLoopResults *results)
+{
+    for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+        SDL_free(results->stage_ms[stage]);
+    }
+    SDL_free(results->allocations);
+    SDL_free(results->checksums);
+}
+
+static bool AllocateResults(BenchLoopResults *results, Uint32 num_frames)
+{
+    SDL_zerop(results);
+    bool ok = true;
+    for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+        results->stage_ms[stage] = static_cast<double*>(SDL_malloc(num_frames * sizeof(double)));
+        ok = ok && results->stage_ms[stage] != NULL;
+    }
+    results->allocations = static_cast<Uint32*>(SDL_malloc(num_frames * sizeof(Uint32)));
+    results->checksums = static_cast<Uint64*>(SDL_malloc(num_frames * sizeof(Uint64)));
+    return ok && results->allocations != NULL && results->checksums != NULL;
+}
+
+int BenchFrameLoop(int argc, char *argv[])
+{
+    Uint32 num_frames = BENCH_LOOP_DEFAULT_FRAMES;
+    Uint32 num_objects = BENCH_LOOP_DEFAULT_OBJECTS;
+    const char *replay_path = NULL;
+    const char *record_path = NULL;
+    const char *json_path = NULL;
+    for (int i = 0; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (SDL_strcmp(argv[i], "--objects") == 0 && has_value) {
+            num_objects = (Uint32)SDL_strtol(argv[++i], NULL, 10);
+        } else if (SDL_strcmp(argv[i], "--replay") == 0 && has_value) {
+            replay_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--record") == 0 && has_value) {
+            record_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--json") == 0 && has_value) {
+            json_path = argv[++i];
+        } else if (argv[i][0] != '-') {
+            num_frames = (Uint32)SDL_strtol(argv[i], NULL, 10);
+        } else {
+            SDL_Log("Unknown option %s", argv[i]);
+            return 1;
+        }
+    }
+    if (num_frames == 0 || num_objects < BENCH_LOOP_ANCHOR_RATIO) {
+        SDL_Log("Need at least 1 frame and %d objects", BENCH_LOOP_ANCHOR_RATIO);
+        return 1;
+    }
+
+    BenchReplayFrame *frames = static_cast<BenchReplayFrame*>(SDL_malloc(num_frames * sizeof(BenchReplayFrame)));
+    if (frames == NULL) {
+        return 1;
+    }
+    if (replay_path != NULL) {
+        num_frames = LoadReplay(replay_path, frames, num_frames);
+    } else {
+        GenerateReplay(frames, num_frames, num_objects);
+    }
+    if (num_frames == 0 || (record_path != NULL && !SaveReplay(record_path, frames, num_frames))) {
+        SDL_free(frames);
+        return 1;
+    }
+
+    // Cold pass first on the fresh scene: the buffers that grow to fit a frame grow here, so its
+    // allocations are the warm-up cost. The warm pass replays the same frames with them sized.
+    BenchLoopResults cold, warm;
+    SDL_zero(cold);
+    SDL_zero(warm);
+    bool ok = AllocateResults(&cold, num_frames) && AllocateResults(&warm, num_frames);
+    if (ok) {
+        BenchLoopScene scene;
+        ok = CreateScene(&scene, num_objects);
+        if (ok) {
+            RunReplay(&scene, frames, num_frames, &cold);
+            ResetScene(&scene);
+            RunReplay(&scene, frames, num_frames, &warm);
+        } else {
+            SDL_Log("Failed to create the scene");
+        }
+        DestroyScene(&scene);
+    }
+    for (Uint32 i = 0; ok && i < num_frames; i++) {
+        if (cold.checksums[i] != warm.checksums[i]) {
+            SDL_Log("FAIL: replaying frame %u gave a different result the second time", i);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        BenchDistribution stages[BENCH_STAGE_COUNT];
+        for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+            stages[stage] = Summarize(warm.stage_ms[stage], num_frames);
+        }
+        Uint32 cold_allocations = 0;
+        double *allocations = warm.stage_ms[0];     // Reuse: its timings are summarized already
+        for (Uint32 i = 0; i < num_frames; i++) {
+            cold_allocations += cold.allocations[i];
+            allocations[i] = warm.allocations[i];
+        }
+        BenchDistribution allocation_distribution = Summarize(allocations, num_frames);
+
+        int workers = 0;
+        JobSystem *jobs = CreateJobSystem(-1);
+        if (jobs != NULL) {
+            workers = GetJobWorkerCount(jobs);
+            DestroyJobSystem(jobs);
+        }
+        SDL_Log("%u frames, %u objects, %d workers, %.0f visible and %.0f draws per frame, replay %s", num_frames, num_objects,
+                workers, (double)warm.visible / num_frames, (double)warm.draws / num_frames, replay_path != NULL ? replay_path : "generated");
+        SDL_Log("  %-11s %8s %8s %8s %8s", "stage (ms)", "mean", "p50", "p99", "max");
+        for (int stage = 0; stage < BENCH_STAGE_COUNT; stage++) {
+            SDL_Log("  %-11s %8.3f %8.3f %8.3f %8.3f", STAGE_NAMES[stage], stages[stage].mean, stages[stage].p50,
+                    stages[stage].p99, stages[stage].max);
+        }
+        SDL_Log("  allocations per frame: mean %.2f, p99 %.0f, max %.0f (first pass %u in total)",
+                allocation_distribution.mean, allocation_distribution.p99, allocation_distribution.max, cold_allocations);
+        if (json_path != NULL) {
+            ok = WriteJSON(json_path, replay_path != NULL ? replay_path : "generated", num_frames, num_objects, workers,
+                           stages, &allocation_distribution, cold_allocations, &warm);
+        }
+    }
+
+    FreeResults(&warm);
+    FreeResults(&cold);
+    SDL_free(frames);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <SDL3/SDL.h>
+#include <hdr_image.hpp>
+#include <jobs.hpp>
+
+#include "bench.hpp"
+
+// The shipped memorial.hdr is small; the conversion is measured on an
+// 8192x4096 image tiled from it, the size of our largest environment maps.
+#define BENCH_HDR_WIDTH 8192
+#define BENCH_HDR_HEIGHT 4096
+#define BENCH_HDR_RUNS 5
+
+static const char *PATH_NAMES[] = { "auto", "scalar", "sse2", "avx2" };
+
+int BenchHDR(int argc, char *argv[])
+{
+    char full_path[256];
+    if (argc > 0) {
+        SDL_strlcpy(full_path, argv[0], sizeof(full_path));
+    } else {
+        SDL_snprintf(full_path, sizeof(full_path), "%s../%s", SDL_GetBasePath(), "assets/Images/memorial.hdr");
+    }
+
+    size_t file_size;
+    void *file_data = SDL_LoadFile(full_path, &file_size);
+    if (file_data == NULL) {
+        SDL_Log("Failed to load %s", full_path);
+        return 1;
+    }
+
+    Uint32 width, height;
+    if (!ParseHDRHeader(file_data, file_size, &width, &height)) {
+        SDL_Log("Failed to parse %s: %s", full_path, SDL_GetError());
+        SDL_free(file_data);
+        return 1;
+    }
+
+    // RLE pass alone, then the whole decode (RLE + conversion to half on the job system).
+    JobSystem *jobs = CreateJobSystem(-1);
+    if (jobs == NULL) {
+        SDL_free(file_data);
+        return 1;
+    }
+    Uint8 *rgbe = static_cast<Uint8*>(SDL_malloc((size_t)width * height * 4));
+    double rle_ms = 1e30, decode_ms = 1e30;
+    for (int run = 0; run < BENCH_HDR_RUNS; run++) {
+        Uint64 start = SDL_GetTicksNS();
+        DecodeHDRScanlines(file_data, file_size, rgbe, width, height);
+        rle_ms = SDL_min(rle_ms, BenchElapsedMS(start));
+
+        HDRImage image;
+        start = SDL_GetTicksNS();
+        if (DecodeHDR(file_data, file_size, HDR_PIXELFORMAT_RGBA16F, jobs, &image)) {
+            decode_ms = SDL_min(decode_ms, BenchElapsedMS(start));
+            FreeHDRImage(&image);
+        }
+    }
+    SDL_Log("%s: %ux%u, %.1f KB", full_path, width, height, file_size / 1024.0);
+    SDL_Log("  RLE decode        %8.3f ms  %7.1f Mpix/s", rle_ms, width * height / (rle_ms * 1e3));
+    SDL_Log("  full decode (f16) %8.3f ms  %7.1f Mpix/s  (%d threads)", decode_ms, width * height / (decode_ms * 1e3), GetJobWorkerCount(jobs) + 1);
+    DestroyJobSystem(jobs);
+
+    const Uint32 count = BENCH_HDR_WIDTH * BENCH_HDR_HEIGHT;
+    Uint8 *tiled = static_cast<Uint8*>(SDL_malloc((size_t)count * 4));
+    for (Uint32 y = 0; y < BENCH_HDR_HEIGHT; y++) {
+        for (Uint32 x = 0; x < BENCH_HDR_WIDTH; x++) {
+            SDL_memcpy(tiled + ((size_t)y * BENCH_HDR_WIDTH + x) * 4, rgbe + ((size_t)(y % height) * width + x % width) * 4, 4);
+        }
+    }
+    SDL_free(rgbe);
+    SDL_free(file_data);
+
+    float *reference_float = static_cast<float*>(SDL_malloc((size_t)count * 4 * sizeof(float)));
+    float *output_float = static_cast<float*>(SDL_malloc((size_t)count * 4 * sizeof(float)));
+    Uint16 *reference_half = static_cast<Uint16*>(SDL_malloc((size_t)count * 4 * sizeof(Uint16)));
+    Uint16 *output_half = static_cast<Uint16*>(SDL_malloc((size_t)count * 4 * sizeof(Uint16)));
+    ConvertRGBEToFloat(tiled, reference_float, count, HDR_CONVERT_SCALAR);
+    ConvertRGBEToHalf(tiled, reference_half, count, HDR_CONVERT_SCALAR);
+
+    SDL_Log("RGBE conversion, %ux%u, one thread, best of %d:", BENCH_HDR_WIDTH, BENCH_HDR_HEIGHT, BENCH_HDR_RUNS);
+    double scalar_ms[2] = { 0.0, 0.0 };
+    int result = 0;
+    for (int path = HDR_CONVERT_SCALAR; path <= HDR_CONVERT_AVX2; path++) {
+        if (ResolveHDRConvertPath((HDRConvertPath)path) != path) {
+            SDL_Log("  %-6s not supported on this CPU/compiler", PATH_NAMES[path]);
+            continue;
+        }
+
+        double float_ms = 1e30, half_ms = 1e30;
+        for (int run = 0; run < BENCH_HDR_RUNS; run++) {
+            Uint64 start = SDL_GetTicksNS();
+            ConvertRGBEToFloat(tiled, output_float, count, (HDRConvertPath)path);
+            float_ms = SDL_min(float_ms, BenchElapsedMS(start));
+
+            start = SDL_GetTicksNS();
+            ConvertRGBEToHalf(tiled, output_half, count, (HDRConvertPath)path);
+            half_ms = SDL_min(half_ms, BenchElapsedMS(start));
+        }
+        if (path == HDR_CONVERT_SCALAR) {
+            scalar_ms[0] = float_ms;
+            scalar_ms[1] = half_ms;
+        }
+
+        bool matches = SDL_memcmp(output_float, reference_float, (size_t)count * 4 * sizeof(float)) == 0 &&
+                       SDL_memcmp(output_half, reference_half, (size_t)count * 4 * sizeof(Uint16)) == 0;
+        SDL_Log("  %-6s f32 %8.3f ms %7.1f Mpix/s (%.2fx)   f16 %8.3f ms %7.1f Mpix/s (%.2fx)   %s",
+                PATH_NAMES[path],
+                float_ms, count / (float_ms * 1e3), scalar_ms[0] / float_ms,
+                half_ms, count / (half_ms * 1e3), scalar_ms[1] / half_ms,
+                matches ? "matches scalar" : "MISMATCH");
+        if (!matches) {
+            result = 1;
+        }
+    }
+
+    SDL_free(tiled);
+    SDL_free(reference_float);
+    SDL_free(output_float);
+    SDL_free(reference_half);
+    SDL_free(output_half);
+    return result;
+}
@@ -0,0 +1,396 @@
+#include <SDL3/SDL.h>
+#include <fixed_timestep.hpp>
+#include <input.hpp>
+
+#include "bench.hpp"
+
+// The input ring under a producer thread pushing as fast as it can while this
+// thread consumes: every event must arrive once, in order, and the latched
+// pointer must never be seen half-written. Several producers at once, as an
+// event watch sees when other threads push events, must not lose or reorder
+// each other's events either. Then presses at random times are
+// fed to 120 Hz ticks driven by render loops at different rates: each press
+// must land in the tick its timestamp falls in, whatever the frame rate,
+// where sampling input once a frame would misjudge it by up to a frame.
+// Last, a model of 1 kHz mouse input and 8 ms of frame CPU work compares the
+// pointer sampled at frame start with the one latched just before submit.
+#define BENCH_INPUT_EVENTS 2000000
+#define BENCH_INPUT_RING 4096
+#define BENCH_INPUT_PRODUCERS 4
+#define BENCH_INPUT_PRODUCER_EVENTS 200000
+#define BENCH_INPUT_HZ 120
+#define BENCH_INPUT_PRESSES 4000
+#define BENCH_INPUT_SECONDS 10
+#define BENCH_INPUT_BOUNDARY_NS 200000  // The timestep's frame time snapping keeps ticks this close to the clock
+#define BENCH_INPUT_FRAMES 600
+#define BENCH_INPUT_CPU_NS 8000000ull   // Frame start to submit in the latency model
+
+typedef struct InputProducer
+{
+    InputRecorder *recorder;
+    Uint32 full;                // Pushes retried because the ring was full
+} InputProducer;
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+// Pointer motion with x = i, y = -i, timestamp i + 1, so a torn read shows
+static int InputProducerThread(void *data)
+{
+    InputProducer *producer = static_cast<InputProducer*>(data);
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_EVENT_MOUSE_MOTION;
+    for (Uint32 i = 0; i < BENCH_INPUT_EVENTS; i++) {
+        event.motion.timestamp = i + 1;
+        event.motion.x = (float)i;
+        event.motion.y = -(float)i;
+        while (!RecordInputEvent(producer->recorder, &event)) {
+            producer->full++;
+            SDL_DelayNS(1000);
+        }
+    }
+    return 0;
+}
+
+static bool CheckRing()
+{
+    InputRecorder *recorder = CreateInputRecorder(BENCH_INPUT_RING);
+    if (recorder == NULL) {
+        return false;
+    }
+    InputProducer producer = { recorder, 0 };
+    InputEvent events[256];
+    Uint64 start = SDL_GetTicksNS();
+    SDL_Thread *thread = SDL_CreateThread(InputProducerThread, "InputProducer", &producer);
+    if (thread == NULL) {
+        SDL_Log("FAIL: could not create thread: %s", SDL_GetError());
+        DestroyInputRecorder(recorder);
+        return false;
+    }
+
+    bool ok = true;
+    Uint32 received = 0, latches = 0;
+    Uint64 last_latch = 0;
+    while (ok && received < BENCH_INPUT_EVENTS) {
+        Uint32 count = ConsumeInputEvents(recorder, SDL_MAX_UINT64, events, SDL_arraysize(events));
+        for (Uint32 i = 0; ok && i < count; i++, received++) {
+            const InputEvent *event = &events[i];
+            if (event->type != INPUT_MOUSE_MOTION || event->timestamp != received + 1 || event->x != (float)received ||
+                event->y != -(float)received) {
+                SDL_Log("FAIL: event %u arrived as %llu (%.0f, %.0f)", received, (unsigned long long)event->timestamp,
+                        event->x, event->y);
+                ok = false;
+            }
+        }
+        float x, y;
+        Uint64 timestamp;
+        if (GetLatestPointer(recorder, &x, &y, &timestamp)) {
+            if (x != -y || timestamp != (Uint64)x + 1 || timestamp < last_latch) {
+                SDL_Log("FAIL: latched pointer (%.0f, %.0f) at %llu after %llu", x, y, (unsigned long long)timestamp,
+                        (unsigned long long)last_latch);
+                ok = false;
+            }
+            last_latch = timestamp;
+            latches++;
+        }
+        if (count == 0) {
+            SDL_DelayNS(1000);  // Back off, and let the producer have the core if there is only one
+        }
+    }
+    SDL_WaitThread(thread, NULL);
+    double ms = BenchElapsedMS(start);
+
+    InputStats stats = GetInputStats(recorder);
+    SDL_Log("Ring: %u events through %d slots in %.1f ms (%.1f ns each), %u full retries, high water %u, %u pointer latches read",
+            received, BENCH_INPUT_RING, ms, ms * 1e6 / BENCH_INPUT_EVENTS, producer.full, stats.queued_high_water, latches);
+    if (ok && (stats.recorded != BENCH_INPUT_EVENTS || stats.consumed != BENCH_INPUT_EVENTS || stats.queued != 0 ||
+               stats.dropped != producer.full || stats.queued_high_water > BENCH_INPUT_RING)) {
+        SDL_Log("FAIL: stats say %u recorded, %u consumed, %u queued, %u dropped", stats.recorded, stats.consumed,
+                stats.queued, stats.dropped);
+        ok = false;
+    }
+    DestroyInputRecorder(recorder);
+    return ok;
+}
+
+typedef struct KeyProducer
+{
+    InputRecorder *recorder;
+    SDL_AtomicInt *stop;        // Set when the consumer gives up on the ring
+    Uint16 index;
+} KeyProducer;
+
+// Key events whose device is the producer and timestamp its own count
+static int KeyProducerThread(void *data)
+{
+    KeyProducer *producer = static_cast<KeyProducer*>(data);
+    InputEvent event = {};
+    event.type = INPUT_KEY;
+    event.device = producer->index;
+    for (Uint32 i = 0; i < BENCH_INPUT_PRODUCER_EVENTS; i++) {
+        event.timestamp = i;
+        event.down = (i & 1) == 0;
+        while (!PushInputEvent(producer->recorder, &event)) {
+            if (SDL_GetAtomicInt(producer->stop)) {
+                return 0;
+            }
+            SDL_DelayNS(1000);
+        }
+    }
+    return 0;
+}
+
+static bool CheckProducers()
+{
+    InputRecorder *recorder = CreateInputRecorder(BENCH_INPUT_RING);
+    if (recorder == NULL) {
+        return false;
+    }
+    KeyProducer producers[BENCH_INPUT_PRODUCERS];
+    SDL_Thread *threads[BENCH_INPUT_PRODUCERS];
+    Uint32 next[BENCH_INPUT_PRODUCERS] = {};
+    SDL_AtomicInt stop = {};
+    bool ok = true;
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < BENCH_INPUT_PRODUCERS; i++) {
+        producers[i].recorder = recorder;
+        producers[i].stop = &stop;
+        producers[i].index = (Uint16)i;
+        threads[i] = SDL_CreateThread(KeyProducerThread, "KeyProducer", &producers[i]);
+        if (threads[i] == NULL) {
+            SDL_Log("FAIL: could not create thread: %s", SDL_GetError());
+            ok = false;
+        }
+    }
+
+    // Each producer's events in its own order, none missing or doubled. After a
+    // failure the ring is still drained until it stops filling, and then the
+    // producers are told to give up.
+    Uint32 received = 0, expected = 0;
+    for (int i = 0; i < BENCH_INPUT_PRODUCERS; i++) {
+        expected += threads[i] != NULL ? BENCH_INPUT_PRODUCER_EVENTS : 0;
+    }
+    InputEvent events[256];
+    Uint64 last_progress = SDL_GetTicksNS();
+    while (received < expected) {
+        Uint32 count = ConsumeInputEvents(recorder, SDL_MAX_UINT64, events, SDL_arraysize(events));
+        received += count;
+        // Nothing for a second with the ring empty: the rest were lost, not late
+        if (count > 0) {
+            last_progress = SDL_GetTicksNS();
+        } else if (SDL_GetTicksNS() - last_progress > 1000000000ull) {
+            SDL_Log("FAIL: %u of %u events lost", expected - received, expected);
+            ok = false;
+            break;
+        }
+        for (Uint32 i = 0; ok && i < count; i++) {
+            const InputEvent *event = &events[i];
+            if (event->type != INPUT_KEY || event->device >= BENCH_INPUT_PRODUCERS || event->timestamp != next[event->device] ||
+                event->down != ((event->timestamp & 1) == 0)) {
+                SDL_Log("FAIL: producer %u event %llu arrived after %u", event->device, (unsigned long long)event->timestamp,
+                        event->device < BENCH_INPUT_PRODUCERS ? next[event->device] : 0);
+                ok = false;
+            } else {
+                next[event->device]++;
+            }
+        }
+        if (count == 0) {
+            SDL_DelayNS(1000);
+        }
+    }
+    // A corrupted ring can look full forever
+    SDL_SetAtomicInt(&stop, 1);
+    for (int i = 0; i < BENCH_INPUT_PRODUCERS; i++) {
+        if (threads[i] != NULL) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+    }
+    SDL_Log("Ring: %d producers pushed %u events in %.1f ms, %u consumed%s", BENCH_INPUT_PRODUCERS, expected,
+            BenchElapsedMS(start), received, ok ? " in per-producer order" : "");
+    DestroyInputRecorder(recorder);
+    return ok;
+}
+
+typedef struct TickInput
+{
+    InputRecorder *recorder;
+    FixedTimestep *timestep;
+    Sint32 *press_ticks;        // Tick each press landed in
+    Uint64 previous_end;
+    bool ordered;               // Every press fell inside the tick that took it
+} TickInput;
+
+static void ConsumeTick(Uint64 tick, double, void *userdata)
+{
+    TickInput *input = static_cast<TickInput*>(userdata);
+    Uint64 end = input->timestep->tick_end_ns;
+    InputEvent events[64];
+    Uint32 count;
+    while ((count = ConsumeInputEvents(input->recorder, end, events, SDL_arraysize(events))) > 0) {
+        for (Uint32 i = 0; i < count; i++) {
+            input->press_ticks[events[i].code] = (Sint32)tick;
+            input->ordered = input->ordered && events[i].timestamp >= input->previous_end && events[i].timestamp < end;
+        }
+    }
+    input->previous_end = end;
+}
+
+static bool CheckTickAssignment()
+{
+    static const struct { const char *name; double hz; } loops[] = {
+        { "30 Hz", 30.0 }, { "60 Hz", 60.0 }, { "144 Hz", 144.0 }, { "240 Hz", 240.0 }, { "variable", 0.0 },
+    };
+    const Uint64 origin_ns = 1000000000ull;   // Clock time the simulation starts at
+    const Uint64 period_ns = 1000000000ull / BENCH_INPUT_HZ;
+    Uint64 *press_times = static_cast<Uint64*>(SDL_malloc(BENCH_INPUT_PRESSES * sizeof(Uint64)));
+    Sint32 *press_ticks = static_cast<Sint32*>(SDL_malloc(BENCH_INPUT_PRESSES * sizeof(Sint32)));
+    InputRecorder *recorder = CreateInputRecorder(BENCH_INPUT_RING);
+    if (press_times == NULL || press_ticks == NULL || recorder == NULL) {
+        SDL_free(press_times);
+        SDL_free(press_ticks);
+        DestroyInputRecorder(recorder);
+        return false;
+    }
+    // Sorted random times, as a device delivers them
+    Uint32 seed = 25;
+    Uint64 span_ns = (Uint64)BENCH_INPUT_SECONDS * 1000000000ull;
+    for (Uint32 i = 0; i < BENCH_INPUT_PRESSES; i++) {
+        press_times[i] = origin_ns + span_ns * i / BENCH_INPUT_PRESSES + (NextRandom(&seed) % (Uint32)(span_ns / BENCH_INPUT_PRESSES));
+    }
+
+    bool ok = true;
+    SDL_Log("%d presses over %d s into %d Hz ticks:", BENCH_INPUT_PRESSES, BENCH_INPUT_SECONDS, BENCH_INPUT_HZ);
+    SDL_Log("  %-10s %7s %10s %12s   %s", "loop", "frames", "misplaced", "near edges", "sampled per frame instead: error avg/max ms");
+    for (Uint32 l = 0; ok && l < SDL_arraysize(loops); l++) {
+        FixedTimestep timestep;
+        InitFixedTimestep(&timestep, BENCH_INPUT_HZ, 8);
+        TickInput input = { recorder, &timestep, press_ticks, 0, true };
+        for (Uint32 i = 0; i < BENCH_INPUT_PRESSES; i++) {
+            press_ticks[i] = -1;
+        }
+
+        Uint32 frames = 0, next_press = 0;
+        Uint64 now_ns = origin_ns, frame_error_ns = 0, frame_error_max_ns = 0;
+        Uint32 frame_seed = 7;
+        while (now_ns < origin_ns + span_ns + period_ns) {
+            Uint64 elapsed_ns = loops[l].hz > 0.0 ? (Uint64)((frames + 1) * 1e9 / loops[l].hz) - (Uint64)(frames * 1e9 / loops[l].hz)
+                                                  : 2000000 + NextRandom(&frame_seed) % 38000000;
+            now_ns += elapsed_ns;
+            frames++;
+            // Whatever happened before the frame began was pumped by then
+            for (; next_press < BENCH_INPUT_PRESSES && press_times[next_press] <= now_ns; next_press++) {
+                InputEvent event = {};
+                event.timestamp = press_times[next_press];
+                event.type = INPUT_KEY;
+                event.code = (Uint16)next_press;
+                event.down = true;
+                if (!PushInputEvent(recorder, &event)) {
+                    SDL_Log("FAIL: ring full");
+                    ok = false;
+                }
+                // A game reading input once a frame would time the press at the frame
+                Uint64 error_ns = now_ns - press_times[next_press];
+                frame_error_ns += error_ns;
+                frame_error_max_ns = SDL_max(frame_error_max_ns, error_ns);
+            }
+            Uint32 due = AccumulateFixedTimestep(&timestep, elapsed_ns);
+            SetFixedTickClock(&timestep, now_ns);
+            RunFixedTicks(&timestep, due, ConsumeTick, &input);
+        }
+
+        // Tick k covers [origin + k * period, origin + (k + 1) * period)
+        Uint32 misplaced = 0, near_edges = 0;
+        for (Uint32 i = 0; i < BENCH_INPUT_PRESSES; i++) {
+            Uint64 offset_ns = press_times[i] - origin_ns;
+            Sint32 expected = (Sint32)(offset_ns * BENCH_INPUT_HZ / 1000000000ull);
+            Uint64 edge_ns = offset_ns * BENCH_INPUT_HZ % 1000000000ull / BENCH_INPUT_HZ;
+            bool near_edge = edge_ns < BENCH_INPUT_BOUNDARY_NS || period_ns - edge_ns < BENCH_INPUT_BOUNDARY_NS;
+            if (press_ticks[i] != expected) {
+                if (near_edge && SDL_abs(press_ticks[i] - expected) == 1) {
+                    near_edges++;
+                } else {
+                    misplaced++;
+                }
+            }
+        }
+        SDL_Log("  %-10s %7u %10u %12u   %.2f / %.2f", loops[l].name, frames, misplaced, near_edges,
+                frame_error_ns / 1e6 / BENCH_INPUT_PRESSES, frame_error_max_ns / 1e6);
+        if (misplaced > 0 || !input.ordered || GetInputStats(recorder).queued != 0) {
+            SDL_Log("FAIL: %s put %u presses in the wrong tick%s", loops[l].name, misplaced,
+                    input.ordered ? "" : ", some outside the tick that took them");
+            ok = false;
+        }
+    }
+
+    SDL_free(press_times);
+    SDL_free(press_ticks);
+    DestroyInputRecorder(recorder);
+    return ok;
+}
+
+// 1 kHz pointer motion; each 60 Hz frame starts, works for BENCH_INPUT_CPU_NS
+// and submits. Early: the pointer as of frame start. Latched: pumped and read
+// again just before submit.
+static bool CheckLateLatch()
+{
+    InputRecorder *recorder = CreateInputRecorder(BENCH_INPUT_RING);
+    if (recorder == NULL) {
+        return false;
+    }
+    InputLatency early = {}, latched = {};
+    InputEvent events[64];
+    SDL_Event motion;
+    SDL_zero(motion);
+    motion.type = SDL_EVENT_MOUSE_MOTION;
+    Uint64 next_motion_ns = 1, frame_ns = 0;
+
+    // Events up to time_ns arrive, as pumping at time_ns would deliver them
+    auto pump = [&](Uint64 time_ns) {
+        for (; next_motion_ns <= time_ns; next_motion_ns += 1000000) {
+            motion.motion.timestamp = next_motion_ns;
+            motion.motion.x = (float)(next_motion_ns / 1000000);
+            RecordInputEvent(recorder, &motion);
+        }
+    };
+    for (Uint32 frame = 0; frame < BENCH_INPUT_FRAMES; frame++) {
+        frame_ns += 1000000000ull / 60;
+        pump(frame_ns);
+        float x, y;
+        Uint64 early_ns, latched_ns;
+        GetLatestPointer(recorder, &x, &y, &early_ns);
+
+        Uint64 submit_ns = frame_ns + BENCH_INPUT_CPU_NS;
+        pump(submit_ns - 100000);
+        GetLatestPointer(recorder, &x, &y, &latched_ns);
+        AddInputLatencySample(&early, (submit_ns - early_ns) / 1e6);
+        AddInputLatencySample(&latched, (submit_ns - latched_ns) / 1e6);
+        while (ConsumeInputEvents(recorder, SDL_MAX_UINT64, events, SDL_arraysize(events)) > 0) {
+        }
+    }
+    InputLatencyStats early_stats = GetInputLatencyStats(&early), latched_stats = GetInputLatencyStats(&latched);
+    SDL_Log("Input to submit, %d ms of frame work: sampled at frame start %.2f ms avg, %.2f p99; latched %.2f ms avg, %.2f p99",
+            (int)(BENCH_INPUT_CPU_NS / 1000000), early_stats.average_ms, early_stats.p99_ms, latched_stats.average_ms,
+            latched_stats.p99_ms);
+    DestroyInputRecorder(recorder);
+    if (latched_stats.samples != INPUT_LATENCY_SAMPLES || latched_stats.max_ms > 1.1 ||
+        early_stats.average_ms < BENCH_INPUT_CPU_NS / 1e6) {
+        SDL_Log("FAIL: latching should leave at most the 1 ms between motion events");
+        return false;
+    }
+    return true;
+}
+
+int BenchInput(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    bool ok = CheckRing();
+    ok = ok && CheckProducers();
+    ok = ok && CheckTickAssignment();
+    ok = ok && CheckLateLatch();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+
+#include "bench.hpp"
+
+// Job system microbenchmarks: what one job costs to submit and run, how
+// often work is stolen, and how a compute-bound frame scales with workers.
+#define BENCH_JOBS_EMPTY 200000
+#define BENCH_JOBS_TREE_DEPTH 7     // 4^7 = 16384 leaves, spawned from inside jobs
+#define BENCH_JOBS_TREE_FANOUT 4
+#define BENCH_JOBS_WORK_ITEMS 2048
+#define BENCH_JOBS_WORK_ITERATIONS 20000
+#define BENCH_JOBS_REPEATS 5
+#define BENCH_JOBS_PARALLEL_OUTER 64     // LOW jobs, each running a ParallelFor
+#define BENCH_JOBS_PARALLEL_FOR 256
+#define BENCH_JOBS_PARALLEL_ITERATIONS 1000
+
+typedef struct TreeJob
+{
+    JobSystem *jobs;
+    int depth;
+} TreeJob;
+
+static void EmptyJob(void *)
+{
+}
+
+static void TreeJobFunction(void *userdata)
+{
+    const TreeJob *parent = static_cast<const TreeJob*>(userdata);
+    if (parent->depth == 0) {
+        return;
+    }
+    TreeJob children[BENCH_JOBS_TREE_FANOUT];
+    JobCounter counter;
+    SDL_SetAtomicInt(&counter.pending, 0);
+    for (int i = 0; i < BENCH_JOBS_TREE_FANOUT; i++) {
+        children[i].jobs = parent->jobs;
+        children[i].depth = parent->depth - 1;
+        SubmitJob(parent->jobs, TreeJobFunction, &children[i], &counter);
+    }
+    WaitForCounter(parent->jobs, &counter);
+}
+
+// A fixed amount of floating point work, the kind a culling or animation chunk does.
+static void WorkJob(void *userdata)
+{
+    float *result = static_cast<float*>(userdata);
+    float x = *result;
+    for (int i = 0; i < BENCH_JOBS_WORK_ITERATIONS; i++) {
+        x = x * 0.999f + 0.5f;
+    }
+    *result = x;
+}
+
+// ParallelFor run from LOW jobs, the way the asset loader's decodes use it.
+typedef struct ParallelForCheck
+{
+    JobSystem *jobs;
+    SDL_AtomicInt *hits;        // BENCH_JOBS_PARALLEL_OUTER * BENCH_JOBS_PARALLEL_FOR
+    float *results;             // Same size; keeps the per-item work from being optimised away
+    SDL_ThreadID main_thread;
+    SDL_AtomicInt on_main_thread;
+} ParallelForCheck;
+
+typedef struct ParallelForOuter
+{
+    ParallelForCheck *check;
+    Uint32 index;
+} ParallelForOuter;
+
+static void CountParallelForItem(Uint32 index, void *userdata)
+{
+    const ParallelForOuter *outer = static_cast<const ParallelForOuter*>(userdata);
+    Uint32 item = outer->index * BENCH_JOBS_PARALLEL_FOR + index;
+    float x = (float)index;
+    for (int i = 0; i < BENCH_JOBS_PARALLEL_ITERATIONS; i++) {
+        x = x * 0.999f + 0.5f;
+    }
+    outer->check->results[item] = x;
+    if (SDL_GetCurrentThreadID() == outer->check->main_thread) {
+        SDL_AddAtomicInt(&outer->check->on_main_thread, 1);
+    }
+    SDL_AddAtomicInt(&outer->check->hits[item], 1);
+}
+
+static void ParallelForLowJob(void *userdata)
+{
+    ParallelForOuter *outer = static_cast<ParallelForOuter*>(userdata);
+    ParallelFor(outer->check->jobs, BENCH_JOBS_PARALLEL_FOR, CountParallelForItem, outer);
+}
+
+// Every index runs exactly once, and with workers none of the LOW work lands
+// on the main thread while it waits, first on other work and then on the LOW
+// jobs themselves.
+static bool CheckParallelFor(JobSystem *jobs, int workers)
+{
+    ParallelForCheck check;
+    check.jobs = jobs;
+    check.hits = static_cast<SDL_AtomicInt*>(SDL_calloc(BENCH_JOBS_PARALLEL_OUTER * BENCH_JOBS_PARALLEL_FOR, sizeof(SDL_AtomicInt)));
+    check.results = static_cast<float*>(SDL_malloc(BENCH_JOBS_PARALLEL_OUTER * BENCH_JOBS_PARALLEL_FOR * sizeof(float)));
+    check.main_thread = SDL_GetCurrentThreadID();
+    SDL_SetAtomicInt(&check.on_main_thread, 0);
+    if (check.hits == NULL || check.results == NULL) {
+        SDL_free(check.hits);
+        SDL_free(check.results);
+        return false;
+    }
+
+    ParallelForOuter outers[BENCH_JOBS_PARALLEL_OUTER];
+    JobCounter low_counter;
+    SDL_SetAtomicInt(&low_counter.pending, 0);
+    for (Uint32 i = 0; i < BENCH_JOBS_PARALLEL_OUTER; i++) {
+        outers[i].check = &check;
+        outers[i].index = i;
+        SubmitJobWithPriority(jobs, ParallelForLowJob, &outers[i], &low_counter, JOB_PRIORITY_LOW);
+    }
+    float work = 0.0f;
+    JobCounter frame_counter;
+    SDL_SetAtomicInt(&frame_counter.pending, 0);
+    SubmitJob(jobs, WorkJob, &work, &frame_counter);
+    WaitForCounter(jobs, &frame_counter);
+    WaitForCounter(jobs, &low_counter);
+
+    bool ok = workers == 0 || SDL_GetAtomicInt(&check.on_main_thread) == 0;
+    if (!ok) {
+        SDL_Log("FAIL: %d LOW ParallelFor items ran on the waiting main thread", SDL_GetAtomicInt(&check.on_main_thread));
+    }
+    for (Uint32 i = 0; i < BENCH_JOBS_PARALLEL_OUTER * BENCH_JOBS_PARALLEL_FOR && ok; i++) {
+        if (SDL_GetAtomicInt(&check.hits[i]) != 1) {
+            SDL_Log("FAIL: ParallelFor item %u ran %d times", i, SDL_GetAtomicInt(&check.hits[i]));
+            ok = false;
+        }
+    }
+    SDL_free(check.hits);
+    SDL_free(check.results);
+    return ok;
+}
+
+static int CountTreeJobs(int depth)
+{
+    int count = 1;
+    int level = 1;
+    for (int i = 0; i < depth; i++) {
+        level *= BENCH_JOBS_TREE_FANOUT;
+        count += level;
+    }
+    return count;
+}
+
+// Best of BENCH_JOBS_REPEATS; the stats are for all of them.
+static double TimeSpawnFromMain(JobSystem *jobs)
+{
+    double best_ms = 0.0;
+    for (int repeat = 0; repeat < BENCH_JOBS_REPEATS; repeat++) {
+        JobCounter counter;
+        SDL_SetAtomicInt(&counter.pending, 0);
+        Uint64 start = SDL_GetTicksNS();
+        for (int i = 0; i < BENCH_JOBS_EMPTY; i++) {
+            SubmitJob(jobs, EmptyJob, NULL, &counter);
+        }
+        WaitForCounter(jobs, &counter);
+        double elapsed_ms = BenchElapsedMS(start);
+        best_ms = repeat == 0 ? elapsed_ms : SDL_min(best_ms, elapsed_ms);
+    }
+    return best_ms;
+}
+
+static double TimeTree(JobSystem *jobs)
+{
+    double best_ms = 0.0;
+    for (int repeat = 0; repeat < BENCH_JOBS_REPEATS; repeat++) {
+        TreeJob root = { jobs, BENCH_JOBS_TREE_DEPTH };
+        JobCounter counter;
+        SDL_SetAtomicInt(&counter.pending, 0);
+        Uint64 start = SDL_GetTicksNS();
+        SubmitJob(jobs, TreeJobFunction, &root, &counter);
+        WaitForCounter(jobs, &counter);
+        double elapsed_ms = BenchElapsedMS(start);
+        best_ms = repeat == 0 ? elapsed_ms : SDL_min(best_ms, elapsed_ms);
+    }
+    return best_ms;
+}
+
+static double TimeWork(JobSystem *jobs, float *results)
+{
+    double best_ms = 0.0;
+    for (int repeat = 0; repeat < BENCH_JOBS_REPEATS; repeat++) {
+        JobCounter counter;
+        SDL_SetAtomicInt(&counter.pending, 0);
+        for (int i = 0; i < BENCH_JOBS_WORK_ITEMS; i++) {
+            results[i] = (float)i;
+        }
+        Uint64 start = SDL_GetTicksNS();
+        for (int i = 0; i < BENCH_JOBS_WORK_ITEMS; i++) {
+            SubmitJob(jobs, WorkJob, &results[i], &counter);
+        }
+        WaitForCounter(jobs, &counter);
+        double elapsed_ms = BenchElapsedMS(start);
+        best_ms = repeat == 0 ? elapsed_ms : SDL_min(best_ms, elapsed_ms);
+    }
+    return best_ms;
+}
+
+static void LogSteals(const char *label, JobSystemStats before, JobSystemStats after)
+{
+    Uint32 executed = after.executed - before.executed;
+    Uint32 stolen = after.stolen - before.stolen;
+    Uint32 attempts = after.steal_attempts - before.steal_attempts;
+    SDL_Log("    %-14s %5.1f%% of %u jobs stolen, %.1f%% of %u steal attempts succeeded", label,
+            executed > 0 ? 100.0 * stolen / executed : 0.0, executed,
+            attempts > 0 ? 100.0 * stolen / attempts : 0.0, attempts);
+}
+
+int BenchJobs(int argc, char *argv[])
+{
+    int max_workers = GetWorkerThreadCount() - 1;
+    if (argc > 0) {
+        max_workers = SDL_max(SDL_atoi(argv[0]), 0);
+    }
+    float *results = static_cast<float*>(SDL_malloc(BENCH_JOBS_WORK_ITEMS * sizeof(float)));
+    float *expected = static_cast<float*>(SDL_malloc(BENCH_JOBS_WORK_ITEMS * sizeof(float)));
+    for (int i = 0; i < BENCH_JOBS_WORK_ITEMS; i++) {
+        expected[i] = (float)i;
+        WorkJob(&expected[i]);
+    }
+
+    int tree_jobs = CountTreeJobs(BENCH_JOBS_TREE_DEPTH);
+    SDL_Log("%d empty jobs from the main thread, a %d-job tree spawned from jobs, and %d jobs of %d iterations; best of %d:",
+            BENCH_JOBS_EMPTY, tree_jobs, BENCH_JOBS_WORK_ITEMS, BENCH_JOBS_WORK_ITERATIONS, BENCH_JOBS_REPEATS);
+
+    int result = 0;
+    double single_ms = 0.0;
+    // 0 workers is the main thread alone: the scaling baseline.
+    for (int workers = 0; workers <= max_workers; workers = workers == 0 ? 1 : workers * 2) {
+        JobSystem *jobs = CreateJobSystem(workers);
+        if (jobs == NULL) {
+            result = 1;
+            break;
+        }
+
+        JobSystemStats before = GetJobSystemStats(jobs);
+        double spawn_ms = TimeSpawnFromMain(jobs);
+        JobSystemStats after_spawn = GetJobSystemStats(jobs);
+        double tree_ms = TimeTree(jobs);
+        JobSystemStats after_tree = GetJobSystemStats(jobs);
+        double work_ms = TimeWork(jobs, results);
+        JobSystemStats after_work = GetJobSystemStats(jobs);
+        if (workers == 0) {
+            single_ms = work_ms;
+        }
+
+        bool matches = SDL_memcmp(results, expected, BENCH_JOBS_WORK_ITEMS * sizeof(float)) == 0;
+        SDL_Log("  %2d workers: spawn %6.1f ns/job, tree %6.1f ns/job, work %8.3f ms (%.2fx)  %s", workers,
+                spawn_ms * 1e6 / BENCH_JOBS_EMPTY, tree_ms * 1e6 / tree_jobs, work_ms,
+                work_ms > 0.0 && single_ms > 0.0 ? single_ms / work_ms : 1.0, matches ? "ok" : "WRONG RESULTS");
+        if (workers > 0) {
+            LogSteals("spawn", before, after_spawn);
+            LogSteals("tree", after_spawn, after_tree);
+            LogSteals("work", after_tree, after_work);
+        }
+        if (!matches || !CheckParallelFor(jobs, workers)) {
+            result = 1;
+        }
+        DestroyJobSystem(jobs);
+    }
+
+    SDL_free(expected);
+    SDL_free(results);
+    return result;
+}
@@ -0,0 +1,265 @@
+#include <SDL3/SDL.h>
+#include <lod.hpp>
+#include <mesh.hpp>
+
+#include "bench.hpp"
+
+// LOD chain generation for a bumpy 65k-triangle sphere, then a fly-through of
+// a field of them selecting LODs every frame, reporting the triangles
+// submitted with and without LOD. The sphere's surface is known exactly, so
+// each level's claimed error is checked to bound how far its triangles really
+// stray from it; selection is checked to never show more than the pixel
+// threshold of that real deviation, and hysteresis to cut the number of LOD
+// switches.
+#define BENCH_LOD_RINGS 128
+#define BENCH_LOD_SEGMENTS 256
+#define BENCH_LOD_RADIUS 10.0f
+#define BENCH_LOD_GRID 64               // Objects per side
+#define BENCH_LOD_SPACING 40.0f
+#define BENCH_LOD_FRAMES 600
+#define BENCH_LOD_THRESHOLD 1.0f        // Pixels
+#define BENCH_LOD_HYSTERESIS 0.25f
+#define BENCH_LOD_VIEWPORT_HEIGHT 1080.0f
+
+static float SurfaceRadius(float theta, float phi)
+{
+    return BENCH_LOD_RADIUS + 0.4f * SDL_sinf(phi * 7.0f) * SDL_sinf(theta * 5.0f);
+}
+
+// Distance from a point to the surface r = SurfaceRadius(theta, phi), to first
+// order: the radial gap over the gradient's length. The bumps are steep near
+// the poles, where the radial gap alone would overstate it well over half again.
+static float SurfaceDistance(const float q[3])
+{
+    float r = SDL_sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    float theta = SDL_acosf(SDL_clamp(q[1] / r, -1.0f, 1.0f));
+    float phi = SDL_atan2f(q[2], q[0]);
+    float d_theta = 0.4f * 5.0f * SDL_sinf(phi * 7.0f) * SDL_cosf(theta * 5.0f) / r;
+    float sin_theta = SDL_sinf(theta);
+    // sin(5 theta) / sin(theta) goes to 5 at the poles
+    float d_phi = 0.4f * 7.0f * SDL_cosf(phi * 7.0f) * (sin_theta > 1e-4f ? SDL_sinf(theta * 5.0f) / sin_theta : 5.0f) / r;
+    return SDL_fabsf(r - SurfaceRadius(theta, phi)) / SDL_sqrtf(1.0f + d_theta * d_theta + d_phi * d_phi);
+}
+
+static bool GenerateSphere(Mesh *mesh)
+{
+    const Uint32 row = BENCH_LOD_SEGMENTS + 1;
+    mesh->num_vertices = (BENCH_LOD_RINGS + 1) * row;
+    mesh->num_indices = BENCH_LOD_RINGS * BENCH_LOD_SEGMENTS * 6;
+    mesh->vertices = static_cast<MeshVertex*>(SDL_malloc(mesh->num_vertices * sizeof(MeshVertex)));
+    mesh->indices = static_cast<Uint32*>(SDL_malloc(mesh->num_indices * sizeof(Uint32)));
+    if (mesh->vertices == NULL || mesh->indices == NULL) {
+        return false;
+    }
+    for (Uint32 ring = 0; ring <= BENCH_LOD_RINGS; ring++) {
+        float theta = SDL_PI_F * ring / BENCH_LOD_RINGS;
+        for (Uint32 segment = 0; segment <= BENCH_LOD_SEGMENTS; segment++) {
+            // Both ends of a ring meet at the same point, so the UV seam has duplicate positions
+            float phi = 2.0f * SDL_PI_F * (segment % BENCH_LOD_SEGMENTS) / BENCH_LOD_SEGMENTS;
+            float n[3] = { SDL_sinf(theta) * SDL_cosf(phi), SDL_cosf(theta), SDL_sinf(theta) * SDL_sinf(phi) };
+            if (ring == 0 || ring == BENCH_LOD_RINGS) {
+                n[0] = 0.0f;
+                n[2] = 0.0f;
+            }
+            float radius = SurfaceRadius(theta, phi);
+            MeshVertex *vertex = &mesh->vertices[ring * row + segment];
+            for (int axis = 0; axis < 3; axis++) {
+                vertex->position[axis] = n[axis] * radius;
+                vertex->normal[axis] = n[axis];
+            }
+            vertex->uv[0] = (float)segment / BENCH_LOD_SEGMENTS;
+            vertex->uv[1] = (float)ring / BENCH_LOD_RINGS;
+        }
+    }
+    Uint32 *index = mesh->indices;
+    for (Uint32 ring = 0; ring < BENCH_LOD_RINGS; ring++) {
+        for (Uint32 segment = 0; segment < BENCH_LOD_SEGMENTS; segment++) {
+            Uint32 a = ring * row + segment, b = a + 1, c = a + row, d = c + 1;
+            // Counter-clockwise seen from outside
+            *index++ = a; *index++ = b; *index++ = d;
+            *index++ = a; *index++ = d; *index++ = c;
+        }
+    }
+    return true;
+}
+
+// How far a LOD's triangles stray from the analytic surface, sampled at
+// their centroids and edge midpoints, where a coarse triangle cuts deepest.
+static float MeasureDeviation(const Mesh *mesh, const Uint32 *indices, Uint32 num_indices, Uint32 *inward)
+{
+    float deviation = 0.0f;
+    *inward = 0;
+    for (Uint32 i = 0; i < num_indices; i += 3) {
+        const float *p[3] = { mesh->vertices[indices[i]].position, mesh->vertices[indices[i + 1]].position,
+                              mesh->vertices[indices[i + 2]].position };
+        const float weights[4][3] = { { 1 / 3.0f, 1 / 3.0f, 1 / 3.0f }, { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.5f, 0.5f }, { 0.5f, 0.0f, 0.5f } };
+        for (int s = 0; s < 4; s++) {
+            float q[3];
+            for (int axis = 0; axis < 3; axis++) {
+                q[axis] = weights[s][0] * p[0][axis] + weights[s][1] * p[1][axis] + weights[s][2] * p[2][axis];
+            }
+            deviation = SDL_max(deviation, SurfaceDistance(q));
+        }
+        float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+        float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+        float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        if (n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2] < 0.0f) {
+            (*inward)++;
+        }
+    }
+    return deviation;
+}
+
+// deviations gets each LOD's measured deviation, over what LOD 0's own
+// triangles already have.
+static bool CheckChain(const Mesh *mesh, const MeshLODChain *chain, float *deviations)
+{
+    if (chain->num_lods < 4) {
+        SDL_Log("FAIL: only %u LODs", chain->num_lods);
+        return false;
+    }
+    float base_deviation = 0.0f;
+    for (Uint32 l = 0; l < chain->num_lods; l++) {
+        const MeshLOD *lod = &chain->lods[l];
+        const Uint32 *indices = &chain->indices[lod->first_index];
+        for (Uint32 i = 0; i < lod->num_indices; i += 3) {
+            if (indices[i] >= mesh->num_vertices || indices[i + 1] >= mesh->num_vertices || indices[i + 2] >= mesh->num_vertices ||
+                indices[i] == indices[i + 1] || indices[i + 1] == indices[i + 2] || indices[i] == indices[i + 2]) {
+                SDL_Log("FAIL: LOD %u has a bad or degenerate triangle", l);
+                return false;
+            }
+        }
+        Uint32 inward;
+        float deviation = MeasureDeviation(mesh, indices, lod->num_indices, &inward);
+        MeshStats stats = AnalyzeMesh(indices, lod->num_indices, mesh->num_vertices, sizeof(PackedMeshVertex));
+        SDL_Log("  LOD %u  %6u triangles  error %.4f (%.3f%% of radius)  measured %.4f  ACMR %.2f",
+                l, lod->num_indices / 3, lod->error, 100.0f * lod->error / BENCH_LOD_RADIUS, deviation, stats.acmr);
+        if (l == 0) {
+            base_deviation = deviation;
+            deviations[l] = 0.0f;
+            continue;
+        }
+        deviations[l] = SDL_max(deviation - base_deviation, 0.0f);
+        const MeshLOD *previous = &chain->lods[l - 1];
+        // The error is a bound: LOD 0 strays from the surface by base_deviation, and this one
+        // from LOD 0 by at most error, give or take float rounding
+        if (lod->num_indices >= previous->num_indices || lod->error < previous->error ||
+            deviations[l] > lod->error * 1.001f || inward > 0) {
+            SDL_Log("FAIL: LOD %u is not smaller, understates its error or has %u triangles facing inward", l, inward);
+            return false;
+        }
+    }
+    return true;
+}
+
+// glm::perspective(60 degrees), column-major.
+static void BuildProjection(float projection[16])
+{
+    const float fov = 60.0f * SDL_PI_F / 180.0f, aspect = 16.0f / 9.0f, near_plane = 0.1f, far_plane = 4000.0f;
+    float f = 1.0f / SDL_tanf(fov * 0.5f);
+    SDL_memset(projection, 0, 16 * sizeof(float));
+    projection[0] = f / aspect;
+    projection[5] = f;
+    projection[10] = (far_plane + near_plane) / (near_plane - far_plane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * far_plane * near_plane / (near_plane - far_plane);
+}
+
+typedef struct FlyThrough
+{
+    Uint64 triangles;
+    Uint64 full_triangles;
+    Uint32 switches;
+    Uint32 over_threshold;
+    double select_ms;
+} FlyThrough;
+
+// The camera crosses the field low and slowly bobs back and forth, as a
+// player's does; every object is submitted, culling aside.
+static void RunFlyThrough(const MeshLODChain *chain, const float *deviations, float hysteresis, Uint8 *current, FlyThrough *result)
+{
+    SDL_zerop(result);
+    SDL_memset(current, 0, BENCH_LOD_GRID * BENCH_LOD_GRID);
+    float projection[16];
+    BuildProjection(projection);
+    const float extent = BENCH_LOD_GRID * BENCH_LOD_SPACING;
+    for (Uint32 frame = 0; frame < BENCH_LOD_FRAMES; frame++) {
+        float t = (float)frame / BENCH_LOD_FRAMES;
+        float eye[3] = { -0.1f * extent + 1.2f * extent * t + 3.0f * SDL_sinf(frame * 0.3f), 15.0f, extent * 0.5f };
+        LODView view;
+        InitLODView(&view, projection, BENCH_LOD_VIEWPORT_HEIGHT, eye, BENCH_LOD_THRESHOLD, hysteresis);
+
+        Uint64 start = SDL_GetTicksNS();
+        for (Uint32 i = 0; i < BENCH_LOD_GRID * BENCH_LOD_GRID; i++) {
+            float center[3] = { (i % BENCH_LOD_GRID) * BENCH_LOD_SPACING, 0.0f, (i / BENCH_LOD_GRID) * BENCH_LOD_SPACING };
+            Uint32 lod = SelectLOD(&view, center, BENCH_LOD_RADIUS * 1.05f, chain->lods, chain->num_lods, 1.0f, current[i]);
+            result->switches += lod != current[i];
+            current[i] = (Uint8)lod;
+            result->triangles += chain->lods[lod].num_indices / 3;
+            result->full_triangles += chain->lods[0].num_indices / 3;
+        }
+        result->select_ms += BenchElapsedMS(start);
+
+        for (Uint32 i = 0; i < BENCH_LOD_GRID * BENCH_LOD_GRID; i++) {
+            float center[3] = { (i % BENCH_LOD_GRID) * BENCH_LOD_SPACING, 0.0f, (i / BENCH_LOD_GRID) * BENCH_LOD_SPACING };
+            if (GetLODPixelError(&view, center, BENCH_LOD_RADIUS * 1.05f, deviations[current[i]]) > BENCH_LOD_THRESHOLD) {
+                result->over_threshold++;
+            }
+        }
+    }
+}
+
+int BenchLODs(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    Mesh mesh;
+    SDL_zero(mesh);
+    if (!GenerateSphere(&mesh)) {
+        FreeMesh(&mesh);
+        return 1;
+    }
+    OptimizeVertexCache(mesh.indices, mesh.num_indices, mesh.num_vertices);
+
+    MeshLODChain chain;
+    Uint64 start = SDL_GetTicksNS();
+    bool built = BuildMeshLODChain(&mesh, 0.5f, 256, &chain);
+    double build_ms = BenchElapsedMS(start);
+    if (!built) {
+        FreeMesh(&mesh);
+        return 1;
+    }
+    SDL_Log("%u LODs built in %.1f ms, %.1f KB of indices for all of them", chain.num_lods, build_ms, chain.num_indices * 4 / 1024.0);
+    float deviations[MESH_MAX_LODS];
+    bool ok = CheckChain(&mesh, &chain, deviations);
+
+    Uint8 *current = static_cast<Uint8*>(SDL_malloc(BENCH_LOD_GRID * BENCH_LOD_GRID));
+    FlyThrough with_hysteresis, without_hysteresis;
+    if (ok && current != NULL) {
+        RunFlyThrough(&chain, deviations, BENCH_LOD_HYSTERESIS, current, &with_hysteresis);
+        RunFlyThrough(&chain, deviations, 0.0f, current, &without_hysteresis);
+
+        Uint32 objects = BENCH_LOD_GRID * BENCH_LOD_GRID;
+        SDL_Log("%u objects, %d frames, %.1f pixel threshold:", objects, BENCH_LOD_FRAMES, BENCH_LOD_THRESHOLD);
+        SDL_Log("  without LOD      %10.0f triangles/frame", (double)with_hysteresis.full_triangles / BENCH_LOD_FRAMES);
+        SDL_Log("  with LOD         %10.0f triangles/frame (%.1f%%)", (double)with_hysteresis.triangles / BENCH_LOD_FRAMES,
+                100.0 * with_hysteresis.triangles / with_hysteresis.full_triangles);
+        SDL_Log("  LOD switches     %10.1f/frame with %.0f%% hysteresis, %.1f/frame without",
+                (double)with_hysteresis.switches / BENCH_LOD_FRAMES, 100.0f * BENCH_LOD_HYSTERESIS,
+                (double)without_hysteresis.switches / BENCH_LOD_FRAMES);
+        SDL_Log("  selection        %10.1f ns/object", with_hysteresis.select_ms * 1e6 / ((double)objects * BENCH_LOD_FRAMES));
+
+        if (with_hysteresis.triangles >= with_hysteresis.full_triangles || with_hysteresis.over_threshold > 0 ||
+            without_hysteresis.over_threshold > 0 || with_hysteresis.switches >= without_hysteresis.switches) {
+            SDL_Log("FAIL: LOD saved nothing, showed %u objects over the threshold, or hysteresis did not reduce switching",
+                    with_hysteresis.over_threshold + without_hysteresis.over_threshold);
+            ok = false;
+        }
+    }
+
+    SDL_free(current);
+    FreeMeshLODChain(&chain);
+    FreeMesh(&mesh);
+    return ok ? 0 : 1;
+}
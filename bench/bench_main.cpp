@@ -0,0 +1,69 @@
+// Headless benchmarks for the engine's CPU-side systems. No window or GPU.
+//
+//   VideoGame_bench <name> [args...]
+//   VideoGame_bench all
+
+#include <SDL3/SDL.h>
+
+#include "bench.hpp"
+
+typedef struct BenchEntry
+{
+    const char *name;
+    BenchFunction fn;
+    const char *description;
+} BenchEntry;
+
+static const BenchEntry benches[] = {
+    { "batching", BenchBatching, "Instance grouping and pull-style sprite packing, instance packing scalar vs SSE2, on the job system [count]" },
+    { "culling", BenchCulling, "Frustum culling of 1M objects, brute force vs BVH, scalar vs SSE2 vs AVX2 [count]" },
+    { "frames", BenchFrameAllocator, "Per-frame arena and GPU ring checks, bump allocation vs malloc/free" },
+    { "frameloop", BenchFrameLoop, "Headless frame loop replay, per-stage p50/p99/max and allocations per frame [frames] [--json file]" },
+    { "hdr", BenchHDR, "Radiance RGBE decode, scalar vs SSE2 vs AVX2 [file.hdr]" },
+    { "input", BenchInput, "Input ring under a producer thread, presses into fixed ticks by timestamp, late-latched vs frame-start latency" },
+    { "jobs", BenchJobs, "Job system spawn cost, steal rate and scaling [max workers]" },
+    { "lods", BenchLODs, "Quadric LOD chain generation and screen-space-error selection, triangles per frame with and without LOD" },
+    { "meshes", BenchMeshes, "Mesh import, vertex cache/overdraw/fetch optimization and quantization, ACMR and size [file.obj]" },
+    { "mips", BenchMips, "Mip chain generation, box vs Kaiser, sRGB vs UNORM [size]" },
+    { "pipelines", BenchPipelines, "Pipeline cache keying, lookup and manifest prewarm checks, ns per request" },
+    { "profiler", BenchProfiler, "Profiler zone cost, concurrent ring reads, slot reuse and Chrome trace export [trace.json]" },
+    { "rendergraph", BenchRenderGraph, "Render graph ordering, culling, merging and aliasing checks, compile time" },
+    { "renderqueue", BenchRenderQueue, "Draw packet submission, radix sort and redundant bind skipping [count]" },
+    { "scheduler", BenchScheduler, "ECS systems on the job system vs serial, with a determinism check" },
+    { "textures", BenchTextures, "DDS/ASTC parsing of the shipped images, truncated, edge-case and random headers, ns per parse" },
+    { "timestep", BenchTimestep, "Fixed-timestep simulation under different render rates: identical ticks, interpolation, tick cap" },
+    { "transforms", BenchTransforms, "100k-transform hierarchy update, scalar vs SSE2 vs AVX2" },
+    { "upload", BenchUpload, "Upload ring wrap, full-ring, frame budget and all-or-nothing mip set checks on a headless upload manager, ns per allocation" },
+};
+
+static void PrintUsage(const char *program)
+{
+    SDL_Log("Usage: %s <name> [args...] | all", program);
+    for (const BenchEntry &bench : benches) {
+        SDL_Log("  %-10s %s", bench.name, bench.description);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    bool run_all = SDL_strcmp(argv[1], "all") == 0;
+    int result = 0;
+    bool found = false;
+    for (const BenchEntry &bench : benches) {
+        if (run_all || SDL_strcmp(argv[1], bench.name) == 0) {
+            SDL_Log("== %s ==", bench.name);
+            result |= bench.fn(run_all ? 0 : argc - 2, run_all ? NULL : argv + 2);
+            found = true;
+        }
+    }
+    if (!found) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    return result;
+}
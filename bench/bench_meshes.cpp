@@ -0,0 +1,294 @@
+#include <SDL3/SDL.h>
+#include <mesh.hpp>
+
+#include "bench.hpp"
+
+// The cook target's mesh path on a generated sphere, or on an OBJ given on
+// the command line: import, vertex cache, overdraw and fetch optimization,
+// then quantization. Reports ACMR (vertex shader runs per triangle through a
+// 16-entry FIFO) after each step and the size of the packed mesh, and checks
+// that no triangle was lost or flipped and that quantization stays within
+// the formats' precision.
+#define BENCH_MESH_RINGS 128
+#define BENCH_MESH_SEGMENTS 256
+
+typedef struct BenchText
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+} BenchText;
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static bool AppendText(BenchText *text, const char *format, ...)
+{
+    if (text->capacity - text->size < 128) {
+        size_t capacity = SDL_max(text->capacity * 2, (size_t)65536);
+        char *data = static_cast<char*>(SDL_realloc(text->data, capacity));
+        if (data == NULL) {
+            return false;
+        }
+        text->data = data;
+        text->capacity = capacity;
+    }
+    va_list args;
+    va_start(args, format);
+    int written = SDL_vsnprintf(text->data + text->size, text->capacity - text->size, format, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= text->capacity - text->size) {
+        return false;
+    }
+    text->size += (size_t)written;
+    return true;
+}
+
+// A bumpy UV sphere written as OBJ, so the import and its vertex merging are
+// part of the test. Faces are quads, fanned by the importer.
+static char* GenerateSphereOBJ(void)
+{
+    BenchText text = {};
+    bool ok = AppendText(&text, "# generated sphere\n");
+    for (int ring = 0; ring <= BENCH_MESH_RINGS && ok; ring++) {
+        float theta = SDL_PI_F * ring / BENCH_MESH_RINGS;
+        for (int segment = 0; segment <= BENCH_MESH_SEGMENTS && ok; segment++) {
+            float phi = 2.0f * SDL_PI_F * segment / BENCH_MESH_SEGMENTS;
+            float n[3] = { SDL_sinf(theta) * SDL_cosf(phi), SDL_cosf(theta), SDL_sinf(theta) * SDL_sinf(phi) };
+            float radius = 10.0f + 0.25f * SDL_sinf(phi * 7.0f) * SDL_sinf(theta * 5.0f);
+            ok = AppendText(&text, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\nvt %.6f %.6f\n", n[0] * radius, n[1] * radius + 3.0f,
+                            n[2] * radius, n[0], n[1], n[2], (float)segment / BENCH_MESH_SEGMENTS, 1.0f - (float)ring / BENCH_MESH_RINGS);
+        }
+    }
+    const int row = BENCH_MESH_SEGMENTS + 1;
+    for (int ring = 0; ring < BENCH_MESH_RINGS && ok; ring++) {
+        for (int segment = 0; segment < BENCH_MESH_SEGMENTS && ok; segment++) {
+            int a = ring * row + segment + 1, b = a + 1, c = a + row, d = c + 1;
+            // Counter-clockwise seen from outside
+            ok = AppendText(&text, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d, c, c, c);
+        }
+    }
+    if (!ok) {
+        SDL_free(text.data);
+        return NULL;
+    }
+    return text.data;
+}
+
+// A DCC exporter's order is usually no better than this.
+static void ShuffleTriangles(Uint32 *indices, Uint32 num_indices)
+{
+    Uint32 seed = 5;
+    for (Uint32 t = num_indices / 3; t > 1; t--) {
+        Uint32 other = NextRandom(&seed) % t;
+        for (int c = 0; c < 3; c++) {
+            Uint32 swap = indices[(t - 1) * 3 + c];
+            indices[(t - 1) * 3 + c] = indices[other * 3 + c];
+            indices[other * 3 + c] = swap;
+        }
+    }
+}
+
+// Order-independent, but sensitive to each triangle's corners and winding.
+static Uint64 HashTriangles(const Mesh *mesh)
+{
+    Uint64 sum = 0;
+    for (Uint32 t = 0; t + 2 < mesh->num_indices; t += 3) {
+        // Rotate so the winding, not the starting corner, is what counts
+        Uint32 start = 0;
+        for (Uint32 c = 1; c < 3; c++) {
+            if (SDL_memcmp(&mesh->vertices[mesh->indices[t + c]], &mesh->vertices[mesh->indices[t + start]], sizeof(MeshVertex)) < 0) {
+                start = c;
+            }
+        }
+        Uint64 hash = 0xcbf29ce484222325ULL;
+        for (Uint32 c = 0; c < 3; c++) {
+            const Uint8 *bytes = reinterpret_cast<const Uint8*>(&mesh->vertices[mesh->indices[t + (start + c) % 3]]);
+            for (size_t i = 0; i < sizeof(MeshVertex); i++) {
+                hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+            }
+        }
+        sum += hash;
+    }
+    return sum;
+}
+
+// A cube of quads with negative indices and no normals or texture coordinates.
+static bool CheckOBJParser(void)
+{
+    static const char cube[] =
+        "# cube\n"
+        "o cube\n"
+        "v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\n"
+        "v -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+        "s 1\n"
+        "f 1 4 3 2\nf 5 6 7 8\nf 1 2 6 5\n"
+        "f -5 -1 -2 -6\r\n"
+        "f 2 3 7 6 # comment\n"
+        "f 1 5 8 4\n";
+    Mesh mesh;
+    if (!ParseOBJ(cube, &mesh)) {
+        SDL_Log("FAIL: cube OBJ did not parse: %s", SDL_GetError());
+        return false;
+    }
+    bool ok = mesh.num_vertices == 8 && mesh.num_indices == 36;
+    for (Uint32 v = 0; v < mesh.num_vertices && ok; v++) {
+        const MeshVertex *vertex = &mesh.vertices[v];
+        float dot = vertex->normal[0] * vertex->position[0] + vertex->normal[1] * vertex->position[1] + vertex->normal[2] * vertex->position[2];
+        ok = dot > 0.5f * SDL_sqrtf(3.0f);
+    }
+    if (!ok) {
+        SDL_Log("FAIL: cube OBJ gave %u vertices and %u indices, or inward normals", mesh.num_vertices, mesh.num_indices);
+    }
+    FreeMesh(&mesh);
+
+    if (ok && (ParseOBJ("v 0 0 0\nv 1 0 0\nf 1 2 3\n", &mesh) || ParseOBJ("v 0 0\n", &mesh))) {
+        SDL_Log("FAIL: a malformed OBJ parsed");
+        FreeMesh(&mesh);
+        ok = false;
+    }
+    return ok;
+}
+
+static bool CheckQuantization(const Mesh *mesh, const PackedMeshVertex *packed, const MeshQuantization *quantization)
+{
+    float position_error = 0.0f, uv_error = 0.0f, min_dot = 1.0f;
+    for (Uint32 v = 0; v < mesh->num_vertices; v++) {
+        const MeshVertex *original = &mesh->vertices[v];
+        MeshVertex unpacked;
+        UnpackMeshVertex(&packed[v], quantization, &unpacked);
+        for (int axis = 0; axis < 3; axis++) {
+            // In units of the axis's quantization step
+            float error = SDL_fabsf(unpacked.position[axis] - original->position[axis]) * 32767.0f / quantization->scale[axis];
+            position_error = SDL_max(position_error, error);
+        }
+        for (int axis = 0; axis < 2; axis++) {
+            float error = SDL_fabsf(unpacked.uv[axis] - original->uv[axis]) / SDL_max(SDL_fabsf(original->uv[axis]), 1.0f);
+            uv_error = SDL_max(uv_error, error);
+        }
+        float dot = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            dot += unpacked.normal[axis] * original->normal[axis];
+        }
+        min_dot = SDL_min(min_dot, dot);
+    }
+    float normal_degrees = SDL_acosf(SDL_min(min_dot, 1.0f)) * 180.0f / SDL_PI_F;
+    SDL_Log("  quantization error: position %.2f steps, normal %.2f degrees, uv %.5f relative",
+            position_error, normal_degrees, uv_error);
+    // Half a step plus float rounding; 8-bit octahedral is good to about a degree
+    if (position_error > 0.51f || normal_degrees > 1.5f || uv_error > 1.0f / 2048.0f) {
+        SDL_Log("FAIL: quantization error is larger than the formats allow");
+        return false;
+    }
+    return true;
+}
+
+static void LogStats(const char *step, const Mesh *mesh, double ms)
+{
+    MeshStats stats = AnalyzeMesh(mesh->indices, mesh->num_indices, mesh->num_vertices, sizeof(MeshVertex));
+    SDL_Log("  %-14s ACMR %.3f  ATVR %.3f  overfetch %.2f  %8.2f ms", step, stats.acmr, stats.atvr, stats.overfetch, ms);
+}
+
+static bool RunMesh(Mesh *mesh)
+{
+    Uint64 triangles = HashTriangles(mesh);
+    MeshStats before = AnalyzeMesh(mesh->indices, mesh->num_indices, mesh->num_vertices, sizeof(MeshVertex));
+    SDL_Log("%u vertices, %u triangles", mesh->num_vertices, mesh->num_indices / 3);
+    LogStats("input", mesh, 0.0);
+
+    Uint64 start = SDL_GetTicksNS();
+    OptimizeVertexCache(mesh->indices, mesh->num_indices, mesh->num_vertices);
+    LogStats("vertex cache", mesh, BenchElapsedMS(start));
+    MeshStats cache = AnalyzeMesh(mesh->indices, mesh->num_indices, mesh->num_vertices, sizeof(MeshVertex));
+
+    start = SDL_GetTicksNS();
+    OptimizeOverdraw(mesh->indices, mesh->num_indices, mesh->vertices, mesh->num_vertices, MESH_OVERDRAW_THRESHOLD);
+    LogStats("overdraw", mesh, BenchElapsedMS(start));
+    MeshStats overdraw = AnalyzeMesh(mesh->indices, mesh->num_indices, mesh->num_vertices, sizeof(MeshVertex));
+
+    start = SDL_GetTicksNS();
+    Uint32 original_vertices = mesh->num_vertices;
+    mesh->num_vertices = OptimizeVertexFetch(mesh->vertices, mesh->indices, mesh->num_indices, mesh->num_vertices);
+    LogStats("vertex fetch", mesh, BenchElapsedMS(start));
+    MeshStats fetch = AnalyzeMesh(mesh->indices, mesh->num_indices, mesh->num_vertices, sizeof(MeshVertex));
+
+    if (HashTriangles(mesh) != triangles) {
+        SDL_Log("FAIL: optimization changed the triangles");
+        return false;
+    }
+    // Overdraw ordering gives up a little of the cache win, within its threshold
+    if (cache.acmr > before.acmr || overdraw.acmr > cache.acmr * MESH_OVERDRAW_THRESHOLD + 0.01f ||
+        fetch.acmr != overdraw.acmr || fetch.overfetch > overdraw.overfetch) {
+        SDL_Log("FAIL: a step made the mesh worse");
+        return false;
+    }
+
+    MeshQuantization quantization;
+    ComputeMeshQuantization(mesh->vertices, mesh->num_vertices, &quantization);
+    PackedMeshVertex *packed = static_cast<PackedMeshVertex*>(SDL_malloc(mesh->num_vertices * sizeof(PackedMeshVertex)));
+    if (packed == NULL) {
+        return false;
+    }
+    start = SDL_GetTicksNS();
+    PackMeshVertices(mesh->vertices, mesh->num_vertices, &quantization, packed);
+    double pack_ms = BenchElapsedMS(start);
+    bool ok = CheckQuantization(mesh, packed, &quantization);
+    SDL_free(packed);
+
+    Uint64 float_vertex_bytes = (Uint64)original_vertices * sizeof(MeshVertex);
+    Uint64 packed_vertex_bytes = (Uint64)mesh->num_vertices * sizeof(PackedMeshVertex);
+    Uint64 index_bytes = (Uint64)mesh->num_indices * sizeof(Uint32);
+    Uint64 packed_index_bytes = (Uint64)mesh->num_indices * (mesh->num_vertices <= 0x10000 ? sizeof(Uint16) : sizeof(Uint32));
+    SDL_Log("  vertices %7.1f KB -> %7.1f KB (%.0f%%), indices %7.1f KB -> %7.1f KB, packed in %.2f ms",
+            float_vertex_bytes / 1024.0, packed_vertex_bytes / 1024.0, 100.0 * packed_vertex_bytes / float_vertex_bytes,
+            index_bytes / 1024.0, packed_index_bytes / 1024.0, pack_ms);
+    SDL_Log("  vertex shader input per draw: %.1f KB -> %.1f KB",
+            before.acmr * (mesh->num_indices / 3) * sizeof(MeshVertex) / 1024.0,
+            fetch.acmr * (mesh->num_indices / 3) * sizeof(PackedMeshVertex) / 1024.0);
+    return ok;
+}
+
+int BenchMeshes(int argc, char *argv[])
+{
+    if (!CheckOBJParser()) {
+        return 1;
+    }
+
+    Mesh mesh;
+    if (argc > 0) {
+        if (!LoadOBJ(argv[0], &mesh)) {
+            SDL_Log("Failed to load %s: %s", argv[0], SDL_GetError());
+            return 1;
+        }
+        SDL_Log("%s as exported:", argv[0]);
+    } else {
+        char *obj = GenerateSphereOBJ();
+        if (obj == NULL) {
+            return 1;
+        }
+        Uint64 start = SDL_GetTicksNS();
+        bool parsed = ParseOBJ(obj, &mesh);
+        double parse_ms = BenchElapsedMS(start);
+        size_t obj_size = SDL_strlen(obj);
+        SDL_free(obj);
+        if (!parsed) {
+            SDL_Log("FAIL: generated OBJ did not parse: %s", SDL_GetError());
+            return 1;
+        }
+        Uint32 expected_vertices = (BENCH_MESH_RINGS + 1) * (BENCH_MESH_SEGMENTS + 1);
+        if (mesh.num_vertices != expected_vertices || mesh.num_indices != BENCH_MESH_RINGS * BENCH_MESH_SEGMENTS * 6) {
+            SDL_Log("FAIL: generated OBJ gave %u vertices, expected %u", mesh.num_vertices, expected_vertices);
+            FreeMesh(&mesh);
+            return 1;
+        }
+        SDL_Log("Imported %.1f MB of OBJ in %.2f ms; sphere with shuffled triangles:", obj_size / (1024.0 * 1024.0), parse_ms);
+        ShuffleTriangles(mesh.indices, mesh.num_indices);
+    }
+
+    bool ok = RunMesh(&mesh);
+    FreeMesh(&mesh);
+    return ok ? 0 : 1;
+}
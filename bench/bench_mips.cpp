@@ -0,0 +1,68 @@
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+#include <mipmap.hpp>
+
+#include "bench.hpp"
+
+// A full chain for a 4096x4096 sRGB texture, the largest the game ships.
+#define BENCH_MIPS_SIZE 4096
+#define BENCH_MIPS_RUNS 3
+
+int BenchMips(int argc, char *argv[])
+{
+    Uint32 size = BENCH_MIPS_SIZE;
+    if (argc > 0) {
+        size = (Uint32)SDL_atoi(argv[0]);
+        if (size == 0) {
+            SDL_Log("Bad size %s", argv[0]);
+            return 1;
+        }
+    }
+
+    // Noise, so nothing downstream can skip work on flat regions.
+    Uint8 *pixels = static_cast<Uint8*>(SDL_malloc((size_t)size * size * 4));
+    Uint32 seed = 0x9E3779B9;
+    for (size_t i = 0; i < (size_t)size * size * 4; i++) {
+        seed = seed * 1664525 + 1013904223;
+        pixels[i] = (Uint8)(seed >> 24);
+    }
+
+#ifdef SDL_SSE2_INTRINSICS
+    const char *path = "sse2";
+#else
+    const char *path = "scalar";
+#endif
+    JobSystem *jobs = CreateJobSystem(-1);
+    if (jobs == NULL) {
+        SDL_free(pixels);
+        return 1;
+    }
+    SDL_Log("%ux%u RGBA8, full chain, %s, %d threads, best of %d:", size, size, path, GetJobWorkerCount(jobs) + 1, BENCH_MIPS_RUNS);
+
+    static const struct { const char *name; bool srgb; MipFilter filter; } cases[] = {
+        { "box, unorm", false, MIP_FILTER_BOX },
+        { "box, srgb", true, MIP_FILTER_BOX },
+        { "kaiser, unorm", false, MIP_FILTER_KAISER },
+        { "kaiser, srgb", true, MIP_FILTER_KAISER },
+    };
+    int result = 0;
+    for (const auto &bench_case : cases) {
+        double best_ms = 1e30;
+        for (int run = 0; run < BENCH_MIPS_RUNS; run++) {
+            MipChain chain;
+            Uint64 start = SDL_GetTicksNS();
+            if (!GenerateMipChain(pixels, size, size, size * 4, bench_case.srgb, bench_case.filter, 0, jobs, &chain)) {
+                SDL_Log("  %s: out of memory", bench_case.name);
+                result = 1;
+                break;
+            }
+            best_ms = SDL_min(best_ms, BenchElapsedMS(start));
+            FreeMipChain(&chain);
+        }
+        SDL_Log("  %-14s %8.3f ms  %7.1f Mpix/s (source)", bench_case.name, best_ms, (double)size * size / (best_ms * 1e3));
+    }
+
+    DestroyJobSystem(jobs);
+    SDL_free(pixels);
+    return result;
+}
@@ -0,0 +1,271 @@
+#include <SDL3/SDL.h>
+#include <pipeline_cache.hpp>
+
+#include "bench.hpp"
+
+// Pipeline permutations as a material system would request them: 8 shader
+// pairs, each with opaque/alpha/additive blending, 2 cull modes, 3 target
+// formats and with or without depth. The cache runs without a device, so this
+// measures keying, lookup and the manifest, not driver compile time.
+#define BENCH_PIPELINE_SHADERS 8
+#define BENCH_PIPELINE_BLENDS 3
+#define BENCH_PIPELINE_CULLS 2
+#define BENCH_PIPELINE_FORMATS 3
+#define BENCH_PIPELINE_DEPTHS 2
+#define BENCH_PIPELINE_PERMUTATIONS (BENCH_PIPELINE_SHADERS * BENCH_PIPELINE_BLENDS * BENCH_PIPELINE_CULLS * BENCH_PIPELINE_FORMATS * BENCH_PIPELINE_DEPTHS)
+#define BENCH_PIPELINE_REQUESTS 1000000
+
+static const SDL_GPUTextureFormat bench_formats[BENCH_PIPELINE_FORMATS] = {
+    SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM,
+    SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB,
+    SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+};
+
+// A create-info with the arrays it points to.
+typedef struct BenchPipelineDesc
+{
+    char vertex_shader[64];
+    char fragment_shader[64];
+    SDL_GPUGraphicsPipelineCreateInfo create_info;
+    SDL_GPUVertexBufferDescription vertex_buffer;
+    SDL_GPUVertexAttribute vertex_attributes[2];
+    SDL_GPUColorTargetDescription color_target;
+} BenchPipelineDesc;
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static void PointArrays(BenchPipelineDesc *desc)
+{
+    desc->create_info.vertex_input_state.vertex_buffer_descriptions = &desc->vertex_buffer;
+    desc->create_info.vertex_input_state.vertex_attributes = desc->vertex_attributes;
+    desc->create_info.target_info.color_target_descriptions = &desc->color_target;
+}
+
+static void MakePermutation(Uint32 index, BenchPipelineDesc *desc)
+{
+    SDL_zerop(desc);
+    Uint32 shader = index % BENCH_PIPELINE_SHADERS;
+    index /= BENCH_PIPELINE_SHADERS;
+    Uint32 blend = index % BENCH_PIPELINE_BLENDS;
+    index /= BENCH_PIPELINE_BLENDS;
+    Uint32 cull = index % BENCH_PIPELINE_CULLS;
+    index /= BENCH_PIPELINE_CULLS;
+    Uint32 format = index % BENCH_PIPELINE_FORMATS;
+    index /= BENCH_PIPELINE_FORMATS;
+    bool depth = index % BENCH_PIPELINE_DEPTHS != 0;
+
+    SDL_snprintf(desc->vertex_shader, sizeof(desc->vertex_shader), "assets/Shaders/Material%u.vert", shader);
+    SDL_snprintf(desc->fragment_shader, sizeof(desc->fragment_shader), "assets/Shaders/Material%u.frag", shader);
+
+    desc->vertex_buffer.slot = 0;
+    desc->vertex_buffer.pitch = 20;
+    desc->vertex_buffer.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
+    desc->vertex_attributes[0] = { 0, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, 0 };
+    desc->vertex_attributes[1] = { 1, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, 12 };
+    desc->create_info.vertex_input_state.num_vertex_buffers = 1;
+    desc->create_info.vertex_input_state.num_vertex_attributes = 2;
+    desc->create_info.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+    desc->create_info.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_FILL;
+    desc->create_info.rasterizer_state.cull_mode = cull != 0 ? SDL_GPU_CULLMODE_BACK : SDL_GPU_CULLMODE_NONE;
+    desc->create_info.rasterizer_state.front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE;
+
+    desc->color_target.format = bench_formats[format];
+    if (blend != 0) {
+        SDL_GPUColorTargetBlendState *state = &desc->color_target.blend_state;
+        state->enable_blend = true;
+        state->src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA;
+        state->dst_color_blendfactor = blend == 1 ? SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA : SDL_GPU_BLENDFACTOR_ONE;
+        state->color_blend_op = SDL_GPU_BLENDOP_ADD;
+        state->src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+        state->dst_alpha_blendfactor = blend == 1 ? SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA : SDL_GPU_BLENDFACTOR_ONE;
+        state->alpha_blend_op = SDL_GPU_BLENDOP_ADD;
+    }
+    desc->create_info.target_info.num_color_targets = 1;
+    if (depth) {
+        desc->create_info.depth_stencil_state.enable_depth_test = true;
+        desc->create_info.depth_stencil_state.enable_depth_write = blend == 0;
+        desc->create_info.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_LESS;
+        desc->create_info.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
+        desc->create_info.target_info.has_depth_stencil_target = true;
+    }
+    PointArrays(desc);
+}
+
+static Uint64 HashDesc(const BenchPipelineDesc *desc)
+{
+    return HashPipelineDesc(desc->vertex_shader, desc->fragment_shader, &desc->create_info);
+}
+
+// Every field that reaches the driver must change the key.
+static bool CheckKeyCoverage(void)
+{
+    BenchPipelineDesc base;
+    MakePermutation(0, &base);
+    Uint64 base_key = HashDesc(&base);
+
+    BenchPipelineDesc copy = base;
+    PointArrays(&copy);
+    copy.create_info.props = 1;
+    if (HashDesc(&copy) != base_key) {
+        SDL_Log("FAIL: equal state in other arrays, or props, changed the key");
+        return false;
+    }
+
+    typedef void (*Mutation)(BenchPipelineDesc *desc);
+    static const struct { const char *name; Mutation mutate; } mutations[] = {
+        { "vertex shader", [](BenchPipelineDesc *d) { d->vertex_shader[0] = 'b'; } },
+        { "fragment shader", [](BenchPipelineDesc *d) { d->fragment_shader[0] = 'b'; } },
+        { "vertex pitch", [](BenchPipelineDesc *d) { d->vertex_buffer.pitch = 24; } },
+        { "input rate", [](BenchPipelineDesc *d) { d->vertex_buffer.input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE; } },
+        { "attribute format", [](BenchPipelineDesc *d) { d->vertex_attributes[1].format = SDL_GPU_VERTEXELEMENTFORMAT_HALF2; } },
+        { "attribute offset", [](BenchPipelineDesc *d) { d->vertex_attributes[1].offset = 16; } },
+        { "attribute count", [](BenchPipelineDesc *d) { d->create_info.vertex_input_state.num_vertex_attributes = 1; } },
+        { "primitive type", [](BenchPipelineDesc *d) { d->create_info.primitive_type = SDL_GPU_PRIMITIVETYPE_LINELIST; } },
+        { "fill mode", [](BenchPipelineDesc *d) { d->create_info.rasterizer_state.fill_mode = SDL_GPU_FILLMODE_LINE; } },
+        { "front face", [](BenchPipelineDesc *d) { d->create_info.rasterizer_state.front_face = SDL_GPU_FRONTFACE_CLOCKWISE; } },
+        { "depth bias", [](BenchPipelineDesc *d) { d->create_info.rasterizer_state.depth_bias_slope_factor = 1.5f; } },
+        { "depth clip", [](BenchPipelineDesc *d) { d->create_info.rasterizer_state.enable_depth_clip = true; } },
+        { "sample count", [](BenchPipelineDesc *d) { d->create_info.multisample_state.sample_count = SDL_GPU_SAMPLECOUNT_4; } },
+        { "stencil op", [](BenchPipelineDesc *d) { d->create_info.depth_stencil_state.front_stencil_state.pass_op = SDL_GPU_STENCILOP_REPLACE; } },
+        { "stencil mask", [](BenchPipelineDesc *d) { d->create_info.depth_stencil_state.write_mask = 0xff; } },
+        { "depth compare", [](BenchPipelineDesc *d) { d->create_info.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_GREATER; } },
+        { "color write mask", [](BenchPipelineDesc *d) { d->color_target.blend_state.enable_color_write_mask = true; } },
+        { "alpha blend op", [](BenchPipelineDesc *d) { d->color_target.blend_state.alpha_blend_op = SDL_GPU_BLENDOP_MAX; } },
+        { "target format", [](BenchPipelineDesc *d) { d->color_target.format = SDL_GPU_TEXTUREFORMAT_R10G10B10A2_UNORM; } },
+        { "depth format", [](BenchPipelineDesc *d) { d->create_info.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D24_UNORM; } },
+    };
+    for (Uint32 i = 0; i < SDL_arraysize(mutations); i++) {
+        BenchPipelineDesc mutated = base;
+        PointArrays(&mutated);
+        mutations[i].mutate(&mutated);
+        if (HashDesc(&mutated) == base_key) {
+            SDL_Log("FAIL: %s does not change the key", mutations[i].name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CheckStats(const char *phase, const PipelineCacheStats *stats, Uint32 pipelines, Uint32 hits, Uint32 misses, Uint32 prewarmed)
+{
+    if (stats->pipelines != pipelines || stats->hits != hits || stats->misses != misses ||
+        stats->prewarmed != prewarmed || stats->failures != 0) {
+        SDL_Log("FAIL: %s: %u pipelines, %u hits, %u misses, %u prewarmed, %u failures; expected %u, %u, %u, %u, 0",
+                phase, stats->pipelines, stats->hits, stats->misses, stats->prewarmed, stats->failures,
+                pipelines, hits, misses, prewarmed);
+        return false;
+    }
+    return true;
+}
+
+// Requests every permutation through cache, saves the manifest to path and
+// prewarms a second, empty cache from it.
+static bool RunPipelineCache(const BenchPipelineDesc *descs, const Uint32 *requests, PipelineCache *cache,
+                             PipelineCache *prewarmed, const char *path)
+{
+    Uint64 start = SDL_GetTicksNS();
+    Uint64 checksum = 0;
+    for (Uint32 i = 0; i < BENCH_PIPELINE_REQUESTS; i++) {
+        checksum += HashDesc(&descs[requests[i]]);
+    }
+    double hash_ms = BenchElapsedMS(start);
+
+    start = SDL_GetTicksNS();
+    for (Uint32 i = 0; i < BENCH_PIPELINE_REQUESTS; i++) {
+        const BenchPipelineDesc *desc = &descs[requests[i]];
+        GetCachedPipeline(cache, desc->vertex_shader, desc->fragment_shader, &desc->create_info);
+    }
+    double lookup_ms = BenchElapsedMS(start);
+    PipelineCacheStats stats = GetPipelineCacheStats(cache);
+    if (!CheckStats("requests", &stats, BENCH_PIPELINE_PERMUTATIONS, BENCH_PIPELINE_REQUESTS - BENCH_PIPELINE_PERMUTATIONS,
+                    BENCH_PIPELINE_PERMUTATIONS, 0)) {
+        return false;
+    }
+
+    // The next run: prewarm from the manifest, then nothing is created on request
+    if (!SavePipelineManifest(cache, path)) {
+        return false;
+    }
+    start = SDL_GetTicksNS();
+    int count = PrewarmPipelineCache(prewarmed, path);
+    double prewarm_ms = BenchElapsedMS(start);
+    if (count != BENCH_PIPELINE_PERMUTATIONS) {
+        SDL_Log("FAIL: prewarmed %d of %d pipelines", count, BENCH_PIPELINE_PERMUTATIONS);
+        return false;
+    }
+    for (Uint32 i = 0; i < BENCH_PIPELINE_PERMUTATIONS; i++) {
+        GetCachedPipeline(prewarmed, descs[i].vertex_shader, descs[i].fragment_shader, &descs[i].create_info);
+    }
+    stats = GetPipelineCacheStats(prewarmed);
+    if (!CheckStats("after prewarm", &stats, BENCH_PIPELINE_PERMUTATIONS, BENCH_PIPELINE_PERMUTATIONS, 0, BENCH_PIPELINE_PERMUTATIONS)) {
+        return false;
+    }
+
+    // A torn manifest is rejected; a missing one is a first run
+    size_t size;
+    void *manifest = SDL_LoadFile(path, &size);
+    bool truncated = manifest != NULL && SDL_SaveFile(path, manifest, size - 7);
+    SDL_free(manifest);
+    PipelineCache *torn = CreatePipelineCache(NULL, NULL, NULL);
+    int torn_count = torn != NULL && truncated ? PrewarmPipelineCache(torn, path) : 0;
+    DestroyPipelineCache(torn);
+    SDL_RemovePath(path);
+    if (torn_count != -1 || PrewarmPipelineCache(prewarmed, path) != 0) {
+        SDL_Log("FAIL: truncated manifest gave %d, missing manifest was not ignored", torn_count);
+        return false;
+    }
+
+    SDL_Log("%d permutations, %d requests (checksum %llx)", BENCH_PIPELINE_PERMUTATIONS, BENCH_PIPELINE_REQUESTS,
+            (unsigned long long)checksum);
+    SDL_Log("  hash     %8.2f ms  %6.1f ns/request", hash_ms, hash_ms * 1e6 / BENCH_PIPELINE_REQUESTS);
+    SDL_Log("  lookup   %8.2f ms  %6.1f ns/request, %.2f%% hits", lookup_ms, lookup_ms * 1e6 / BENCH_PIPELINE_REQUESTS,
+            100.0 * (BENCH_PIPELINE_REQUESTS - BENCH_PIPELINE_PERMUTATIONS) / BENCH_PIPELINE_REQUESTS);
+    SDL_Log("  manifest %8.3f ms to prewarm %d pipelines, 0 created on request", prewarm_ms, count);
+    return true;
+}
+
+int BenchPipelines(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (!CheckKeyCoverage()) {
+        return 1;
+    }
+
+    BenchPipelineDesc *descs = static_cast<BenchPipelineDesc*>(SDL_malloc(BENCH_PIPELINE_PERMUTATIONS * sizeof(BenchPipelineDesc)));
+    Uint32 *requests = static_cast<Uint32*>(SDL_malloc(BENCH_PIPELINE_REQUESTS * sizeof(Uint32)));
+    if (descs == NULL || requests == NULL) {
+        SDL_free(descs);
+        SDL_free(requests);
+        return 1;
+    }
+    for (Uint32 i = 0; i < BENCH_PIPELINE_PERMUTATIONS; i++) {
+        MakePermutation(i, &descs[i]);
+        PointArrays(&descs[i]);
+    }
+    // Every permutation once, then random repeats
+    Uint32 seed = 1;
+    for (Uint32 i = 0; i < BENCH_PIPELINE_REQUESTS; i++) {
+        requests[i] = i < BENCH_PIPELINE_PERMUTATIONS ? i : NextRandom(&seed) % BENCH_PIPELINE_PERMUTATIONS;
+    }
+
+    int result = 1;
+    char path[512];
+    SDL_snprintf(path, sizeof(path), "%sbench_pipelines.manifest", SDL_GetBasePath());
+    PipelineCache *cache = CreatePipelineCache(NULL, NULL, NULL);
+    PipelineCache *prewarmed = CreatePipelineCache(NULL, NULL, NULL);
+    if (cache != NULL && prewarmed != NULL && RunPipelineCache(descs, requests, cache, prewarmed, path)) {
+        result = 0;
+    }
+
+    DestroyPipelineCache(prewarmed);
+    DestroyPipelineCache(cache);
+    SDL_free(requests);
+    SDL_free(descs);
+    return result;
+}
@@ -0,0 +1,205 @@
+#include <SDL3/SDL.h>
+#include <profiler.hpp>
+
+#include "bench.hpp"
+
+// Cost of a zone, then worker threads recording nested zones while this
+// thread keeps copying them out, the way the timeline window does mid-frame.
+// Every copied event must be whole and properly nested, a ring that wraps
+// must keep its newest events, a second round of threads must reuse the
+// first round's slots, and the exported trace must hold every event.
+#define BENCH_PROFILER_ZONES 1000000
+#define BENCH_PROFILER_THREADS 4
+#define BENCH_PROFILER_ROUNDS 2
+#define BENCH_PROFILER_FRAMES 1000
+#define BENCH_PROFILER_INNER 3          // Zones inside each worker frame
+
+typedef struct ProfilerWorker
+{
+    int index;
+    SDL_AtomicInt *starting;    // Workers not yet registered; all are alive together so none share a slot
+    SDL_AtomicInt *running;
+} ProfilerWorker;
+
+static int ProfilerWorkerThread(void *data)
+{
+    ProfilerWorker *worker = static_cast<ProfilerWorker*>(data);
+    char name[32];
+    SDL_snprintf(name, sizeof(name), "Worker %d", worker->index);
+    SetProfilerThreadName(name);
+    SDL_AddAtomicInt(worker->starting, -1);
+    while (SDL_GetAtomicInt(worker->starting) > 0) {
+        SDL_Delay(1);
+    }
+    volatile Uint32 sink = 0;
+    for (int frame = 0; frame < BENCH_PROFILER_FRAMES; frame++) {
+        PROFILE_ZONE("Outer");
+        for (int i = 0; i < BENCH_PROFILER_INNER; i++) {
+            PROFILE_ZONE("Inner");
+            for (int spin = 0; spin < 200; spin++) {
+                sink = sink + spin;
+            }
+        }
+    }
+    SDL_AddAtomicInt(worker->running, -1);
+    return 0;
+}
+
+// Each Inner must sit inside an Outer on its own thread, one level down.
+static bool CheckEvents(const ProfileEvent *events, Uint32 num_events)
+{
+    for (Uint32 i = 0; i < num_events; i++) {
+        const ProfileEvent *event = &events[i];
+        if (event->end < event->start || event->name == NULL) {
+            SDL_Log("FAIL: torn event %u", i);
+            return false;
+        }
+        bool outer = SDL_strcmp(event->name, "Outer") == 0, inner = SDL_strcmp(event->name, "Inner") == 0;
+        if ((!outer && !inner) || event->depth != (inner ? 1 : 0)) {
+            SDL_Log("FAIL: event %u is %s at depth %u", i, event->name, event->depth);
+            return false;
+        }
+    }
+    return true;
+}
+
+static Uint32 CountOccurrences(const char *text, const char *pattern)
+{
+    Uint32 count = 0;
+    size_t length = SDL_strlen(pattern);
+    for (const char *found = SDL_strstr(text, pattern); found != NULL; found = SDL_strstr(found + length, pattern)) {
+        count++;
+    }
+    return count;
+}
+
+int BenchProfiler(int argc, char *argv[])
+{
+    const char *trace_path = argc > 0 ? argv[0] : "bench_profiler_trace.json";
+#if !PROFILER_ENABLED
+    (void)trace_path;
+    SDL_Log("Zones are compiled out (PROFILER_ENABLED=0); nothing to measure");
+    return 0;
+#else
+    SetProfilerThreadName("Bench");
+
+    // Zones on one thread: the ring wraps many times over
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < BENCH_PROFILER_ZONES; i++) {
+        PROFILE_ZONE("Empty");
+    }
+    double zone_ms = BenchElapsedMS(start);
+    SDL_Log("Empty zone: %.1f ns", zone_ms * 1e6 / BENCH_PROFILER_ZONES);
+
+    bool ok = true;
+    ProfileEvent *events = static_cast<ProfileEvent*>(SDL_malloc(PROFILER_MAX_THREADS * PROFILER_EVENTS_PER_THREAD * sizeof(ProfileEvent)));
+    if (events == NULL) {
+        return 1;
+    }
+    Uint32 num_events = CopyProfilerEvents(0, SDL_MAX_UINT64, events, PROFILER_MAX_THREADS * PROFILER_EVENTS_PER_THREAD);
+    ProfilerStats stats = GetProfilerStats();
+    if (num_events == 0 || num_events > PROFILER_EVENTS_PER_THREAD || stats.overwritten == 0) {
+        SDL_Log("FAIL: wrapped ring gave %u events, %llu overwritten", num_events, (unsigned long long)stats.overwritten);
+        ok = false;
+    }
+    // The newest survive, in order
+    for (Uint32 i = 1; ok && i < num_events; i++) {
+        if (events[i].end < events[i - 1].end) {
+            SDL_Log("FAIL: wrapped ring out of order at %u", i);
+            ok = false;
+        }
+    }
+
+    // Workers record while this thread reads, as the timeline window would
+    Uint64 window_start = SDL_GetPerformanceCounter();
+    Uint32 reads = 0, slots = 0;
+    Uint64 read_ns = 0;
+    for (int round = 0; ok && round < BENCH_PROFILER_ROUNDS; round++) {
+        SDL_AtomicInt starting, running;
+        SDL_SetAtomicInt(&starting, BENCH_PROFILER_THREADS);
+        SDL_SetAtomicInt(&running, BENCH_PROFILER_THREADS);
+        ProfilerWorker workers[BENCH_PROFILER_THREADS];
+        SDL_Thread *threads[BENCH_PROFILER_THREADS];
+        for (int i = 0; i < BENCH_PROFILER_THREADS; i++) {
+            workers[i].index = i;
+            workers[i].starting = &starting;
+            workers[i].running = &running;
+            threads[i] = SDL_CreateThread(ProfilerWorkerThread, "ProfilerBench", &workers[i]);
+            if (threads[i] == NULL) {
+                SDL_Log("FAIL: could not create thread: %s", SDL_GetError());
+                SDL_AddAtomicInt(&starting, -1);
+                SDL_AddAtomicInt(&running, -1);
+                ok = false;
+            }
+        }
+        while (ok && SDL_GetAtomicInt(&running) > 0) {
+            MarkProfilerFrame();
+            Uint64 read_start = SDL_GetTicksNS();
+            num_events = CopyProfilerEvents(window_start, SDL_MAX_UINT64, events, PROFILER_MAX_THREADS * PROFILER_EVENTS_PER_THREAD);
+            read_ns += SDL_GetTicksNS() - read_start;
+            reads++;
+            ok = CheckEvents(events, num_events);
+        }
+        for (int i = 0; i < BENCH_PROFILER_THREADS; i++) {
+            if (threads[i] != NULL) {
+                SDL_WaitThread(threads[i], NULL);
+            }
+        }
+        // Exited threads' slots are free for the next round's
+        if (round == 0) {
+            slots = GetProfilerStats().threads;
+        } else if (ok && GetProfilerStats().threads != slots) {
+            SDL_Log("FAIL: %u thread slots after round %d, %u after the first", GetProfilerStats().threads, round + 1, slots);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        num_events = CopyProfilerEvents(window_start, SDL_MAX_UINT64, events, PROFILER_MAX_THREADS * PROFILER_EVENTS_PER_THREAD);
+        ok = CheckEvents(events, num_events);
+        Uint32 expected = BENCH_PROFILER_ROUNDS * BENCH_PROFILER_THREADS * BENCH_PROFILER_FRAMES * (BENCH_PROFILER_INNER + 1);
+        SDL_Log("%d rounds of %d threads recorded %u zones in %u slots while %u concurrent copies ran, %.1f us each",
+                BENCH_PROFILER_ROUNDS, BENCH_PROFILER_THREADS, num_events, slots, reads, reads > 0 ? read_ns / 1e3 / reads : 0.0);
+        if (ok && num_events != expected) {
+            SDL_Log("FAIL: %u of %u worker zones copied", num_events, expected);
+            ok = false;
+        }
+        for (Uint32 i = 0; ok && i < num_events; i++) {
+            if (SDL_strncmp(GetProfilerThreadName(events[i].thread), "Worker ", 7) != 0) {
+                SDL_Log("FAIL: zone on unnamed thread %s", GetProfilerThreadName(events[i].thread));
+                ok = false;
+            }
+        }
+    }
+
+    Uint64 frame_start, frame_end;
+    if (ok && (!GetProfilerFrame(1, &frame_start, &frame_end) || frame_end < frame_start || frame_start < window_start)) {
+        SDL_Log("FAIL: frame marks");
+        ok = false;
+    }
+
+    // Every event in the rings, as a trace
+    if (ok) {
+        Uint32 all_events = CopyProfilerEvents(0, SDL_MAX_UINT64, events, PROFILER_MAX_THREADS * PROFILER_EVENTS_PER_THREAD);
+        start = SDL_GetTicksNS();
+        ok = WriteProfilerTrace(trace_path);
+        double write_ms = BenchElapsedMS(start);
+        size_t size = 0;
+        char *trace = ok ? static_cast<char*>(SDL_LoadFile(trace_path, &size)) : NULL;
+        Uint32 written = trace != NULL ? CountOccurrences(trace, "\"ph\":\"X\"") : 0;
+        SDL_Log("Trace: %u events, %.1f KB in %.2f ms", written, size / 1024.0, write_ms);
+        if (trace == NULL || written != all_events || trace[0] != '{' || SDL_strstr(trace, "]}") == NULL ||
+            SDL_strstr(trace, "\"name\":\"Worker 0\"") == NULL) {
+            SDL_Log("FAIL: trace holds %u of %u events or is malformed", written, all_events);
+            ok = false;
+        }
+        SDL_free(trace);
+        if (argc == 0) {
+            SDL_RemovePath(trace_path);
+        }
+    }
+
+    SDL_free(events);
+    return ok ? 0 : 1;
+#endif
+}
@@ -0,0 +1,254 @@
+#include <SDL3/SDL.h>
+#include <render_graph.hpp>
+
+#include "bench.hpp"
+
+// Compiles small graphs whose ordering, culling, merging, store op and
+// aliasing decisions are known and checks them, then times compiling a
+// 62-pass frame. No GPU device: the graph is only compiled, never executed.
+#define BENCH_GRAPH_COMPILES 10000
+#define BENCH_GRAPH_WIDTH 1920
+#define BENCH_GRAPH_HEIGHT 1080
+
+static void EmptyPass(const RenderPassContext *context, void *userdata)
+{
+    (void)context;
+    (void)userdata;
+}
+
+static bool Expect(bool condition, const char *what)
+{
+    if (!condition) {
+        SDL_Log("  FAILED: %s", what);
+    }
+    return condition;
+}
+
+static RenderTextureDesc TextureDesc(const char *name, SDL_GPUTextureFormat format, Uint32 width, Uint32 height)
+{
+    RenderTextureDesc desc = { name, format, width, height, SDL_GPU_SAMPLECOUNT_1 };
+    return desc;
+}
+
+static int AddPass(RenderGraph *graph, const char *name, RenderPassType type)
+{
+    RenderPassDesc desc = { name, type, EmptyPass, NULL, NULL, false };
+    return AddRenderPass(graph, &desc);
+}
+
+static RenderResource ImportSwapchain(RenderGraph *graph)
+{
+    RenderTextureDesc desc = TextureDesc("Swapchain", SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM, BENCH_GRAPH_WIDTH, BENCH_GRAPH_HEIGHT);
+    RenderResource swapchain = ImportRenderTexture(graph, reinterpret_cast<SDL_GPUTexture*>(16), &desc);
+    SetRenderGraphOutput(graph, swapchain);
+    return swapchain;
+}
+
+// The main loop's frame: scene and ImGui both draw to the swapchain.
+static bool CheckSwapchainMerge(RenderGraph *graph)
+{
+    const SDL_FColor clear = { 0.0f, 0.0f, 0.0f, 1.0f };
+    ResetRenderGraph(graph);
+    RenderResource swapchain = ImportSwapchain(graph);
+    int scene = AddPass(graph, "Scene", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, scene, swapchain, SDL_GPU_LOADOP_CLEAR, clear);
+    int imgui = AddPass(graph, "ImGui", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, imgui, swapchain, SDL_GPU_LOADOP_LOAD, clear);
+
+    bool ok = Expect(CompileRenderGraph(graph), "swapchain graph compiles");
+    RenderGraphStats stats = GetRenderGraphStats(graph);
+    ok = Expect(stats.groups == 1 && stats.merged == 1, "scene and ImGui share one render pass") && ok;
+    ok = Expect(GetRenderPassInfo(graph, scene).order == 0 && GetRenderPassInfo(graph, imgui).order == 1, "scene before ImGui") && ok;
+    ok = Expect(GetRenderTargetStoreOp(graph, imgui, swapchain) == SDL_GPU_STOREOP_STORE, "swapchain is stored") && ok;
+    return ok;
+}
+
+// Shadows, an HDR scene, a compute bloom, tone mapping, FXAA and UI, plus a
+// debug view nothing reads and a blur chain whose first and last textures
+// can share memory.
+static bool CheckDeferredFrame(RenderGraph *graph)
+{
+    const SDL_FColor clear = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const Uint32 w = BENCH_GRAPH_WIDTH, h = BENCH_GRAPH_HEIGHT;
+    ResetRenderGraph(graph);
+    RenderResource swapchain = ImportSwapchain(graph);
+    RenderTextureDesc desc = TextureDesc("Shadow map", SDL_GPU_TEXTUREFORMAT_D32_FLOAT, 2048, 2048);
+    RenderResource shadow = CreateRenderTexture(graph, &desc);
+    desc = TextureDesc("HDR", SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, w, h);
+    RenderResource hdr = CreateRenderTexture(graph, &desc);
+    desc = TextureDesc("Depth", SDL_GPU_TEXTUREFORMAT_D32_FLOAT, w, h);
+    RenderResource depth = CreateRenderTexture(graph, &desc);
+    desc = TextureDesc("Debug", SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, w, h);
+    RenderResource debug = CreateRenderTexture(graph, &desc);
+    desc = TextureDesc("Bloom A", SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, w / 2, h / 2);
+    RenderResource bloom_a = CreateRenderTexture(graph, &desc);
+    desc.name = "Bloom B";
+    RenderResource bloom_b = CreateRenderTexture(graph, &desc);
+    desc.name = "Bloom C";
+    RenderResource bloom_c = CreateRenderTexture(graph, &desc);
+    desc = TextureDesc("LDR", SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, w, h);
+    RenderResource ldr = CreateRenderTexture(graph, &desc);
+
+    int shadows = AddPass(graph, "Shadows", RENDER_PASS_GRAPHICS);
+    SetRenderPassDepthTarget(graph, shadows, shadow, SDL_GPU_LOADOP_CLEAR, 1.0f);
+    int opaque = AddPass(graph, "Opaque", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, opaque, hdr, SDL_GPU_LOADOP_CLEAR, clear);
+    SetRenderPassDepthTarget(graph, opaque, depth, SDL_GPU_LOADOP_CLEAR, 1.0f);
+    AddRenderPassRead(graph, opaque, shadow);
+    int debug_view = AddPass(graph, "Debug view", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, debug_view, debug, SDL_GPU_LOADOP_CLEAR, clear);
+    AddRenderPassRead(graph, debug_view, depth);
+    int translucent = AddPass(graph, "Translucent", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, translucent, hdr, SDL_GPU_LOADOP_LOAD, clear);
+    SetRenderPassDepthTarget(graph, translucent, depth, SDL_GPU_LOADOP_LOAD, 1.0f);
+    int bright = AddPass(graph, "Bloom bright", RENDER_PASS_COMPUTE);
+    AddRenderPassRead(graph, bright, hdr);
+    AddRenderPassStorageWrite(graph, bright, bloom_a);
+    int blur_x = AddPass(graph, "Bloom blur X", RENDER_PASS_COMPUTE);
+    AddRenderPassRead(graph, blur_x, bloom_a);
+    AddRenderPassStorageWrite(graph, blur_x, bloom_b);
+    int blur_y = AddPass(graph, "Bloom blur Y", RENDER_PASS_COMPUTE);
+    AddRenderPassRead(graph, blur_y, bloom_b);
+    AddRenderPassStorageWrite(graph, blur_y, bloom_c);
+    int tonemap = AddPass(graph, "Tone map", RENDER_PASS_GRAPHICS);
+    AddRenderPassRead(graph, tonemap, hdr);
+    AddRenderPassRead(graph, tonemap, bloom_c);
+    AddRenderPassColorTarget(graph, tonemap, ldr, SDL_GPU_LOADOP_DONT_CARE, clear);
+    int fxaa = AddPass(graph, "FXAA", RENDER_PASS_GRAPHICS);
+    AddRenderPassRead(graph, fxaa, ldr);
+    AddRenderPassColorTarget(graph, fxaa, swapchain, SDL_GPU_LOADOP_DONT_CARE, clear);
+    int ui = AddPass(graph, "UI", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, ui, swapchain, SDL_GPU_LOADOP_LOAD, clear);
+
+    bool ok = Expect(CompileRenderGraph(graph), "deferred graph compiles");
+    RenderGraphStats stats = GetRenderGraphStats(graph);
+    ok = Expect(GetRenderPassInfo(graph, debug_view).culled && stats.culled == 1, "only the debug view is culled") && ok;
+    ok = Expect(GetRenderResourceSlot(graph, debug) < 0, "the culled pass's target is not allocated") && ok;
+    ok = Expect(GetRenderPassInfo(graph, opaque).group == GetRenderPassInfo(graph, translucent).group, "translucent joins the opaque render pass") && ok;
+    ok = Expect(GetRenderPassInfo(graph, fxaa).group == GetRenderPassInfo(graph, ui).group, "UI joins the FXAA render pass") && ok;
+    ok = Expect(stats.merged == 2 && stats.groups == 7, "seven render and compute passes") && ok;
+    const int chain[] = { shadows, opaque, translucent, bright, blur_x, blur_y, tonemap, fxaa, ui };
+    for (Uint32 i = 1; i < SDL_arraysize(chain); i++) {
+        ok = Expect(GetRenderPassInfo(graph, chain[i - 1]).order < GetRenderPassInfo(graph, chain[i]).order, "dependency order") && ok;
+    }
+    ok = Expect(GetRenderTargetStoreOp(graph, translucent, depth) == SDL_GPU_STOREOP_DONT_CARE, "scene depth is not stored") && ok;
+    ok = Expect(GetRenderTargetStoreOp(graph, translucent, hdr) == SDL_GPU_STOREOP_STORE, "HDR is stored for the bloom") && ok;
+    ok = Expect(GetRenderResourceSlot(graph, bloom_a) == GetRenderResourceSlot(graph, bloom_c), "bloom C reuses bloom A") && ok;
+    ok = Expect(GetRenderResourceSlot(graph, bloom_a) != GetRenderResourceSlot(graph, bloom_b), "bloom B overlaps bloom A") && ok;
+    ok = Expect(GetRenderResourceSlot(graph, shadow) != GetRenderResourceSlot(graph, depth), "shadow and scene depth differ in size") && ok;
+    ok = Expect(stats.transient_textures == 7 && stats.physical_textures == 6, "seven transient textures in six") && ok;
+    return ok;
+}
+
+// Two independent passes declared between a clear and a load of the same
+// target: the load moves up to merge with the clear.
+static bool CheckMergeReorder(RenderGraph *graph)
+{
+    const SDL_FColor clear = { 0.0f, 0.0f, 0.0f, 1.0f };
+    ResetRenderGraph(graph);
+    RenderResource swapchain = ImportSwapchain(graph);
+    RenderTextureDesc desc = TextureDesc("Minimap", SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 256, 256);
+    RenderResource minimap = CreateRenderTexture(graph, &desc);
+
+    int world = AddPass(graph, "World", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, world, swapchain, SDL_GPU_LOADOP_CLEAR, clear);
+    int map = AddPass(graph, "Minimap", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, map, minimap, SDL_GPU_LOADOP_CLEAR, clear);
+    int effects = AddPass(graph, "Effects", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, effects, swapchain, SDL_GPU_LOADOP_LOAD, clear);
+    int hud = AddPass(graph, "HUD", RENDER_PASS_GRAPHICS);
+    AddRenderPassRead(graph, hud, minimap);
+    AddRenderPassColorTarget(graph, hud, swapchain, SDL_GPU_LOADOP_LOAD, clear);
+
+    bool ok = Expect(CompileRenderGraph(graph), "reorder graph compiles");
+    ok = Expect(GetRenderPassInfo(graph, effects).order == 1 && GetRenderPassInfo(graph, map).order == 2, "effects move ahead of the minimap") && ok;
+    ok = Expect(GetRenderPassInfo(graph, world).group == GetRenderPassInfo(graph, effects).group, "world and effects merge") && ok;
+    ok = Expect(GetRenderPassInfo(graph, hud).group != GetRenderPassInfo(graph, world).group, "HUD starts a new render pass after the minimap") && ok;
+    return ok;
+}
+
+static bool CheckErrors(RenderGraph *graph)
+{
+    ResetRenderGraph(graph);
+    RenderResource swapchain = ImportSwapchain(graph);
+    RenderTextureDesc desc = TextureDesc("Never written", SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 64, 64);
+    RenderResource unwritten = CreateRenderTexture(graph, &desc);
+    int pass = AddPass(graph, "Reader", RENDER_PASS_GRAPHICS);
+    AddRenderPassRead(graph, pass, unwritten);
+    AddRenderPassColorTarget(graph, pass, swapchain, SDL_GPU_LOADOP_CLEAR, SDL_FColor{ 0.0f, 0.0f, 0.0f, 1.0f });
+    bool ok = Expect(!CompileRenderGraph(graph), "reading an unwritten transient fails");
+    ok = Expect(!AddRenderPassStorageWrite(graph, pass, swapchain), "graphics passes have no storage writes") && ok;
+    return ok;
+}
+
+// A 62-pass frame: 15 chains of a clear, two loads and a compute resolve,
+// composited by two passes. Every fourth chain is never composited.
+static void BuildLargeGraph(RenderGraph *graph)
+{
+    const SDL_FColor clear = { 0.0f, 0.0f, 0.0f, 1.0f };
+    ResetRenderGraph(graph);
+    RenderResource swapchain = ImportSwapchain(graph);
+    RenderResource results[15];
+    for (int c = 0; c < 15; c++) {
+        RenderTextureDesc desc = TextureDesc("Chain target", SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, 1024, 1024);
+        RenderResource target = CreateRenderTexture(graph, &desc);
+        desc.name = "Chain result";
+        results[c] = CreateRenderTexture(graph, &desc);
+        int pass = AddPass(graph, "Clear", RENDER_PASS_GRAPHICS);
+        AddRenderPassColorTarget(graph, pass, target, SDL_GPU_LOADOP_CLEAR, clear);
+        for (int i = 0; i < 2; i++) {
+            pass = AddPass(graph, "Load", RENDER_PASS_GRAPHICS);
+            AddRenderPassColorTarget(graph, pass, target, SDL_GPU_LOADOP_LOAD, clear);
+        }
+        pass = AddPass(graph, "Resolve", RENDER_PASS_COMPUTE);
+        AddRenderPassRead(graph, pass, target);
+        AddRenderPassStorageWrite(graph, pass, results[c]);
+    }
+    int composite = AddPass(graph, "Composite", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, composite, swapchain, SDL_GPU_LOADOP_CLEAR, clear);
+    int composite_rest = AddPass(graph, "Composite rest", RENDER_PASS_GRAPHICS);
+    AddRenderPassColorTarget(graph, composite_rest, swapchain, SDL_GPU_LOADOP_LOAD, clear);
+    int reads = 0;
+    for (int c = 0; c < 15; c++) {
+        if (c % 4 != 3) {
+            AddRenderPassRead(graph, reads++ < RENDER_PASS_MAX_READS ? composite : composite_rest, results[c]);
+        }
+    }
+}
+
+int BenchRenderGraph(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    RenderGraph *graph = CreateRenderGraph(NULL);
+    if (graph == NULL) {
+        SDL_Log("Out of memory");
+        return 1;
+    }
+    bool ok = CheckSwapchainMerge(graph);
+    ok = CheckDeferredFrame(graph) && ok;
+    RenderGraphStats stats = GetRenderGraphStats(graph);
+    SDL_Log("Deferred frame: %u passes, %u culled, %u merged, %u render/compute passes, %u stores skipped",
+            stats.passes, stats.culled, stats.merged, stats.groups, stats.stores_skipped);
+    SDL_Log("  %u transient textures in %u: %.1f MB without aliasing, %.1f MB with",
+            stats.transient_textures, stats.physical_textures,
+            stats.transient_bytes / (1024.0 * 1024.0), stats.allocated_bytes / (1024.0 * 1024.0));
+    ok = CheckMergeReorder(graph) && ok;
+    ok = CheckErrors(graph) && ok;
+    SDL_Log("Decision checks: %s", ok ? "all passed" : "FAILED");
+
+    BuildLargeGraph(graph);
+    Uint64 start = SDL_GetTicksNS();
+    bool compiled = true;
+    for (int i = 0; i < BENCH_GRAPH_COMPILES; i++) {
+        compiled = CompileRenderGraph(graph) && compiled;
+    }
+    double mean_us = BenchElapsedMS(start) * 1000.0 / BENCH_GRAPH_COMPILES;
+    stats = GetRenderGraphStats(graph);
+    SDL_Log("Compile, %u passes: %.2f us; %u culled, %u merged, %u transient textures in %u",
+            stats.passes, mean_us, stats.culled, stats.merged, stats.transient_textures, stats.physical_textures);
+    ok = Expect(compiled, "large graph compiles") && ok;
+
+    DestroyRenderGraph(graph);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+#include <render_queue.hpp>
+
+#include "bench.hpp"
+
+// A synthetic scene of 100k draws over 16 pipelines, 256 materials (each a
+// texture and a colour) and 64 meshes, submitted in scene order by one job per
+// chunk. Nothing is drawn: the queue replays without a render pass and only
+// counts the binds it would issue. The same packets with a constant key keep
+// submission order and give the unsorted baseline.
+#define BENCH_QUEUE_PACKETS 100000
+#define BENCH_QUEUE_FRAMES 20
+#define BENCH_QUEUE_CHUNK 4096
+#define BENCH_QUEUE_PIPELINES 16
+#define BENCH_QUEUE_MATERIALS 256
+#define BENCH_QUEUE_MESHES 64
+#define BENCH_QUEUE_SORT_KEYS 1000000
+
+typedef struct BenchObject
+{
+    Uint32 pipeline;
+    Uint32 material;
+    Uint32 mesh;
+    float depth;
+    float transform[16];
+} BenchObject;
+
+typedef struct BenchSubmit
+{
+    RenderQueue *queue;
+    const BenchObject *objects;
+    Uint32 first;
+    Uint32 last;
+    bool sorted;
+    SDL_AtomicInt failures;
+} BenchSubmit;
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+// Stand-ins for GPU objects; the queue only compares them.
+template <typename T>
+static T* FakeHandle(Uint32 kind, Uint32 index)
+{
+    return reinterpret_cast<T*>((uintptr_t)(kind << 24 | (index + 1) << 4));
+}
+
+static void SubmitChunk(void *userdata)
+{
+    BenchSubmit *chunk = static_cast<BenchSubmit*>(userdata);
+    RenderBucket *bucket = AcquireRenderBucket(chunk->queue);
+    if (bucket == NULL) {
+        SDL_AddAtomicInt(&chunk->failures, 1);
+        return;
+    }
+    for (Uint32 i = chunk->first; i < chunk->last; i++) {
+        const BenchObject *object = &chunk->objects[i];
+        DrawPacket packet;
+        SDL_zero(packet);
+        Uint32 depth = QuantizeSortDepth(object->depth, 0.1f, 1000.0f, false);
+        packet.sort_key = chunk->sorted ? MakeOpaqueSortKey(0, object->pipeline, object->material, depth, object->material) : 0;
+        packet.pipeline = FakeHandle<SDL_GPUGraphicsPipeline>(1, object->pipeline);
+        packet.vertex_buffer.buffer = FakeHandle<SDL_GPUBuffer>(2, object->mesh);
+        packet.index_buffer.buffer = FakeHandle<SDL_GPUBuffer>(3, object->mesh);
+        packet.index_element_size = SDL_GPU_INDEXELEMENTSIZE_16BIT;
+        packet.fragment_samplers[0].texture = FakeHandle<SDL_GPUTexture>(4, object->material);
+        packet.fragment_samplers[0].sampler = FakeHandle<SDL_GPUSampler>(5, 0);
+        packet.num_fragment_samplers = 1;
+        packet.num_elements = 36;
+        packet.num_instances = 1;
+        float color[4] = { (object->material & 7) / 7.0f, (object->material >> 3 & 7) / 7.0f, (object->material >> 6) / 3.0f, 1.0f };
+        if (!SubmitDrawPacket(bucket, &packet, object->transform, sizeof(object->transform), color, sizeof(color))) {
+            SDL_AddAtomicInt(&chunk->failures, 1);
+            return;
+        }
+    }
+}
+
+// Submits every object across the job system, then sorts and replays the
+// queue; returns false if any submission failed.
+static bool RunFrame(JobSystem *jobs, RenderQueue *queue, const BenchObject *objects, Uint32 count, bool sorted,
+                     BenchSubmit *chunks, double *submit_ms)
+{
+    ResetRenderQueue(queue);
+    Uint64 start = SDL_GetTicksNS();
+    Uint32 num_chunks = (count + BENCH_QUEUE_CHUNK - 1) / BENCH_QUEUE_CHUNK;
+    JobCounter counter = {};
+    for (Uint32 i = 0; i < num_chunks; i++) {
+        chunks[i].queue = queue;
+        chunks[i].objects = objects;
+        chunks[i].first = i * BENCH_QUEUE_CHUNK;
+        chunks[i].last = SDL_min(chunks[i].first + BENCH_QUEUE_CHUNK, count);
+        chunks[i].sorted = sorted;
+        SDL_SetAtomicInt(&chunks[i].failures, 0);
+        SubmitJob(jobs, SubmitChunk, &chunks[i], &counter);
+    }
+    WaitForCounter(jobs, &counter);
+    *submit_ms += BenchElapsedMS(start);
+
+    SortRenderQueue(queue);
+    ExecuteRenderQueue(queue, NULL, NULL, 0, 255);
+
+    bool ok = true;
+    for (Uint32 i = 0; i < num_chunks; i++) {
+        ok = ok && SDL_GetAtomicInt(&chunks[i].failures) == 0;
+    }
+    return ok;
+}
+
+static void LogFrame(const char *label, const RenderQueueStats *stats, double submit_ms, double sort_ms, double execute_ms)
+{
+    SDL_Log("%s: submit %.3f ms, sort %.3f ms, replay %.3f ms", label, submit_ms, sort_ms, execute_ms);
+    SDL_Log("  %u draws from %u buckets; issued/skipped: pipelines %u/%u, buffers %u/%u, samplers %u/%u, uniforms %u/%u",
+            stats->draws, stats->buckets, stats->pipeline_binds, stats->pipeline_binds_skipped,
+            stats->buffer_binds, stats->buffer_binds_skipped, stats->sampler_binds, stats->sampler_binds_skipped,
+            stats->uniform_pushes, stats->uniform_pushes_skipped);
+}
+
+typedef struct KeyIndex
+{
+    Uint64 key;
+    Uint32 index;
+} KeyIndex;
+
+static int CompareKeyIndex(const void *a, const void *b)
+{
+    const KeyIndex *x = static_cast<const KeyIndex*>(a);
+    const KeyIndex *y = static_cast<const KeyIndex*>(b);
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// Radix sort against qsort with the index as tie-break, i.e. a stable sort.
+static bool CheckRadixSort()
+{
+    Uint32 count = BENCH_QUEUE_SORT_KEYS;
+    Uint64 *keys = static_cast<Uint64*>(SDL_malloc(count * sizeof(Uint64)));
+    Uint32 *values = static_cast<Uint32*>(SDL_malloc(count * sizeof(Uint32)));
+    Uint64 *temp_keys = static_cast<Uint64*>(SDL_malloc(count * sizeof(Uint64)));
+    Uint32 *temp_values = static_cast<Uint32*>(SDL_malloc(count * sizeof(Uint32)));
+    KeyIndex *expected = static_cast<KeyIndex*>(SDL_malloc(count * sizeof(KeyIndex)));
+    if (keys == NULL || values == NULL || temp_keys == NULL || temp_values == NULL || expected == NULL) {
+        SDL_Log("Out of memory");
+        return false;
+    }
+
+    // Few distinct layers and pipelines, like real keys, so there are ties
+    Uint32 seed = 777;
+    for (Uint32 i = 0; i < count; i++) {
+        keys[i] = MakeOpaqueSortKey(NextRandom(&seed) % 3, NextRandom(&seed) % 16, NextRandom(&seed) % 512,
+                                    NextRandom(&seed) % 64, NextRandom(&seed) % 8);
+        values[i] = i;
+        expected[i].key = keys[i];
+        expected[i].index = i;
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    RadixSortKeys(keys, values, temp_keys, temp_values, count);
+    double radix_ms = BenchElapsedMS(start);
+    start = SDL_GetTicksNS();
+    SDL_qsort(expected, count, sizeof(KeyIndex), CompareKeyIndex);
+    double qsort_ms = BenchElapsedMS(start);
+
+    bool matches = true;
+    for (Uint32 i = 0; i < count && matches; i++) {
+        matches = keys[i] == expected[i].key && values[i] == expected[i].index;
+    }
+    SDL_Log("Sort %u keys: radix %.2f ms, qsort %.2f ms (%.1fx)  %s", count, radix_ms, qsort_ms,
+            radix_ms > 0.0 ? qsort_ms / radix_ms : 0.0, matches ? "matches" : "MISMATCH");
+
+    SDL_free(expected);
+    SDL_free(temp_values);
+    SDL_free(temp_keys);
+    SDL_free(values);
+    SDL_free(keys);
+    return matches;
+}
+
+int BenchRenderQueue(int argc, char *argv[])
+{
+    Uint32 count = argc > 0 ? (Uint32)SDL_max(SDL_atoi(argv[0]), 1) : BENCH_QUEUE_PACKETS;
+    Uint32 num_chunks = (count + BENCH_QUEUE_CHUNK - 1) / BENCH_QUEUE_CHUNK;
+    if (num_chunks > RENDER_QUEUE_MAX_BUCKETS) {
+        SDL_Log("At most %d packets", RENDER_QUEUE_MAX_BUCKETS * BENCH_QUEUE_CHUNK);
+        return 1;
+    }
+
+    int result = CheckRadixSort() ? 0 : 1;
+
+    BenchObject *objects = static_cast<BenchObject*>(SDL_malloc(count * sizeof(BenchObject)));
+    BenchSubmit *chunks = static_cast<BenchSubmit*>(SDL_calloc(num_chunks, sizeof(BenchSubmit)));
+    RenderQueue *queue = CreateRenderQueue();
+    JobSystem *jobs = CreateJobSystem(-1);
+    if (objects == NULL || chunks == NULL || queue == NULL || jobs == NULL) {
+        SDL_Log("Out of memory");
+        return 1;
+    }
+
+    Uint32 seed = 4242;
+    for (Uint32 i = 0; i < count; i++) {
+        BenchObject *object = &objects[i];
+        object->material = NextRandom(&seed) % BENCH_QUEUE_MATERIALS;
+        object->pipeline = object->material % BENCH_QUEUE_PIPELINES;
+        object->mesh = NextRandom(&seed) % BENCH_QUEUE_MESHES;
+        object->depth = 0.1f + NextRandom(&seed) / 16777216.0f * 999.9f;
+        for (int j = 0; j < 16; j++) {
+            object->transform[j] = (j % 5 == 0) ? 1.0f : 0.0f;
+        }
+        // Objects of a mesh share a transform, so sorting can repeat uniform data
+        object->transform[12] = (float)(object->mesh % 8);
+        object->transform[13] = (float)(object->mesh / 8);
+    }
+    SDL_Log("%u packets, %d workers", count, GetJobWorkerCount(jobs));
+
+    const char *labels[] = { "Submission order", "Sorted by key" };
+    for (int sorted = 0; sorted <= 1; sorted++) {
+        double submit_ms = 0.0, sort_ms = 0.0, execute_ms = 0.0;
+        RenderQueueStats stats;
+        SDL_zero(stats);
+        for (int frame = 0; frame < BENCH_QUEUE_FRAMES; frame++) {
+            if (!RunFrame(jobs, queue, objects, count, sorted != 0, chunks, &submit_ms)) {
+                SDL_Log("Submission failed: %s", SDL_GetError());
+                result = 1;
+                break;
+            }
+            stats = GetRenderQueueStats(queue);
+            sort_ms += stats.sort_ms;
+            execute_ms += stats.execute_ms;
+        }
+        LogFrame(labels[sorted], &stats, submit_ms / BENCH_QUEUE_FRAMES, sort_ms / BENCH_QUEUE_FRAMES,
+                 execute_ms / BENCH_QUEUE_FRAMES);
+        if (stats.draws != count) {
+            SDL_Log("  MISMATCH: %u draws for %u packets", stats.draws, count);
+            result = 1;
+        }
+    }
+
+    DestroyJobSystem(jobs);
+    DestroyRenderQueue(queue);
+    SDL_free(chunks);
+    SDL_free(objects);
+    return result;
+}
@@ -0,0 +1,206 @@
+#include <SDL3/SDL.h>
+#include <scheduler.hpp>
+
+#include "bench.hpp"
+
+// A synthetic frame of five systems over 200k entities: movement, spin and
+// bounds (chunked, partly independent), plus a cull count and a checksum that
+// depend on them. The same world is stepped once serially and once on the
+// job system; the components have to come out byte-identical.
+#define BENCH_SCHEDULER_ENTITIES 200000
+#define BENCH_SCHEDULER_FRAMES 50
+#define BENCH_SCHEDULER_CHUNK 4096
+
+typedef struct Position { float x, y, z; } Position;
+typedef struct Velocity { float x, y, z; } Velocity;
+typedef struct Spin { float angle, rate; } Spin;
+typedef struct Bounds { float min[3], max[3]; } Bounds;
+typedef struct Visible { bool visible; } Visible;
+
+typedef struct BenchWorld
+{
+    entt::registry registry;
+    SDL_AtomicInt visible_count;
+    Uint64 checksum;
+} BenchWorld;
+
+static void MoveSystem(SystemContext *context, entt::registry &registry, void *)
+{
+    ForEachChunked<Position, const Velocity>(context, registry, BENCH_SCHEDULER_CHUNK,
+        [](entt::entity, Position &position, const Velocity &velocity) {
+            position.x += velocity.x * (1.0f / 60.0f);
+            position.y += velocity.y * (1.0f / 60.0f);
+            position.z += velocity.z * (1.0f / 60.0f);
+            if (position.y < 0.0f) {
+                position.y = -position.y;
+            }
+        });
+}
+
+static void SpinSystem(SystemContext *context, entt::registry &registry, void *)
+{
+    ForEachChunked<Spin>(context, registry, BENCH_SCHEDULER_CHUNK, [](entt::entity, Spin &spin) {
+        spin.angle = SDL_fmodf(spin.angle + spin.rate * (1.0f / 60.0f), 2.0f * SDL_PI_F);
+    });
+}
+
+static void BoundsSystem(SystemContext *context, entt::registry &registry, void *)
+{
+    ForEachChunked<Bounds, const Position, const Spin>(context, registry, BENCH_SCHEDULER_CHUNK,
+        [](entt::entity, Bounds &bounds, const Position &position, const Spin &spin) {
+            float extent = 0.5f + 0.25f * SDL_fabsf(SDL_sinf(spin.angle));
+            bounds.min[0] = position.x - extent;
+            bounds.min[1] = position.y - extent;
+            bounds.min[2] = position.z - extent;
+            bounds.max[0] = position.x + extent;
+            bounds.max[1] = position.y + extent;
+            bounds.max[2] = position.z + extent;
+        });
+}
+
+static void CullSystem(SystemContext *context, entt::registry &registry, void *userdata)
+{
+    BenchWorld *world = static_cast<BenchWorld*>(userdata);
+    SDL_SetAtomicInt(&world->visible_count, 0);
+    ForEachChunked<Visible, const Bounds>(context, registry, BENCH_SCHEDULER_CHUNK,
+        [world](entt::entity, Visible &visible, const Bounds &bounds) {
+            visible.visible = bounds.max[0] > -100.0f && bounds.min[0] < 100.0f &&
+                              bounds.max[2] > -100.0f && bounds.min[2] < 100.0f;
+            if (visible.visible) {
+                SDL_AddAtomicInt(&world->visible_count, 1);
+            }
+        });
+}
+
+// Serial on purpose: a reduction whose result depends on iteration order.
+static void ChecksumSystem(SystemContext *, entt::registry &registry, void *userdata)
+{
+    BenchWorld *world = static_cast<BenchWorld*>(userdata);
+    Uint64 hash = 14695981039346656037ull;
+    for (auto [entity, position, visible] : registry.view<const Position, const Visible>().each()) {
+        Uint32 bits;
+        SDL_memcpy(&bits, &position.x, sizeof(bits));
+        hash = (hash ^ (bits + visible.visible)) * 1099511628211ull;
+    }
+    world->checksum = hash;
+}
+
+static void CreateWorld(BenchWorld *world)
+{
+    Uint32 seed = 12345;
+    for (Uint32 i = 0; i < BENCH_SCHEDULER_ENTITIES; i++) {
+        entt::entity entity = world->registry.create();
+        seed = seed * 1664525 + 1013904223;
+        float r = (float)(seed >> 8) / 16777216.0f;
+        world->registry.emplace<Position>(entity, Position{ (r - 0.5f) * 400.0f, r * 10.0f, (0.5f - r) * 400.0f });
+        world->registry.emplace<Velocity>(entity, Velocity{ r - 0.5f, -1.0f, 0.5f - r });
+        // Not every entity spins or is drawn, so the views differ in size.
+        if (i % 3 != 0) {
+            world->registry.emplace<Spin>(entity, Spin{ 0.0f, r * 4.0f });
+            world->registry.emplace<Bounds>(entity);
+        }
+        if (i % 5 != 0) {
+            world->registry.emplace<Visible>(entity);
+        }
+    }
+}
+
+static SystemScheduler* CreateBenchScheduler(JobSystem *jobs, BenchWorld *world)
+{
+    const ComponentID position[] = { GetComponentID<Position>() };
+    const ComponentID velocity[] = { GetComponentID<Velocity>() };
+    const ComponentID spin[] = { GetComponentID<Spin>() };
+    const ComponentID bounds[] = { GetComponentID<Bounds>() };
+    const ComponentID visible[] = { GetComponentID<Visible>() };
+    const ComponentID position_spin[] = { GetComponentID<Position>(), GetComponentID<Spin>() };
+    const ComponentID position_visible[] = { GetComponentID<Position>(), GetComponentID<Visible>() };
+    const ComponentID world_data[] = { GetComponentID<BenchWorld>() };
+    const SystemDesc systems[] = {
+        { "move", MoveSystem, NULL, velocity, 1, position, 1 },
+        { "spin", SpinSystem, NULL, NULL, 0, spin, 1 },
+        { "bounds", BoundsSystem, NULL, position_spin, 2, bounds, 1 },
+        { "cull", CullSystem, world, bounds, 1, visible, 1 },
+        { "checksum", ChecksumSystem, world, position_visible, 2, world_data, 1 },
+    };
+
+    SystemScheduler *scheduler = CreateSystemScheduler(jobs);
+    for (const SystemDesc &desc : systems) {
+        if (AddSystem(scheduler, &desc) < 0) {
+            SDL_Log("AddSystem(%s): %s", desc.name, SDL_GetError());
+        }
+    }
+    return scheduler;
+}
+
+template <typename T>
+static bool ComponentsMatch(entt::registry &a, entt::registry &b)
+{
+    auto view = a.view<const T>();
+    if (view.size() != b.view<const T>().size()) {
+        return false;
+    }
+    for (entt::entity entity : view) {
+        if (!b.all_of<T>(entity) || SDL_memcmp(&a.get<T>(entity), &b.get<T>(entity), sizeof(T)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int BenchScheduler(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    JobSystem *jobs = CreateJobSystem(-1);
+    if (jobs == NULL) {
+        SDL_Log("CreateJobSystem: %s", SDL_GetError());
+        return 1;
+    }
+    BenchWorld *serial_world = new BenchWorld();
+    BenchWorld *parallel_world = new BenchWorld();
+    CreateWorld(serial_world);
+    CreateWorld(parallel_world);
+    SystemScheduler *serial = CreateBenchScheduler(jobs, serial_world);
+    SystemScheduler *parallel = CreateBenchScheduler(jobs, parallel_world);
+
+    double serial_ms = 0.0;
+    double parallel_ms = 0.0;
+    bool checksums_match = true;
+    for (int frame = 0; frame < BENCH_SCHEDULER_FRAMES; frame++) {
+        Uint64 start = SDL_GetTicksNS();
+        RunSystems(serial, serial_world->registry, true);
+        serial_ms += BenchElapsedMS(start);
+
+        start = SDL_GetTicksNS();
+        RunSystems(parallel, parallel_world->registry, false);
+        parallel_ms += BenchElapsedMS(start);
+
+        checksums_match = checksums_match && serial_world->checksum == parallel_world->checksum &&
+            SDL_GetAtomicInt(&serial_world->visible_count) == SDL_GetAtomicInt(&parallel_world->visible_count);
+    }
+
+    bool matches = checksums_match &&
+                   ComponentsMatch<Position>(serial_world->registry, parallel_world->registry) &&
+                   ComponentsMatch<Spin>(serial_world->registry, parallel_world->registry) &&
+                   ComponentsMatch<Bounds>(serial_world->registry, parallel_world->registry) &&
+                   ComponentsMatch<Visible>(serial_world->registry, parallel_world->registry);
+
+    SchedulerStats stats = GetSchedulerStats(parallel);
+    SDL_Log("%d entities, %u systems, critical path %u, %d workers, mean of %d frames:", BENCH_SCHEDULER_ENTITIES,
+            stats.num_systems, stats.critical_path, GetJobWorkerCount(jobs), BENCH_SCHEDULER_FRAMES);
+    for (Uint32 i = 0; i < stats.num_systems; i++) {
+        SystemStats system = GetSystemStats(parallel, (int)i);
+        SDL_Log("  %-8s %8.3f ms avg  %8.3f ms max  %3u chunks  %u deps", system.name, system.average_ms,
+                system.max_ms, system.chunks_last_frame, system.num_dependencies);
+    }
+    SDL_Log("  serial   %8.3f ms", serial_ms / BENCH_SCHEDULER_FRAMES);
+    SDL_Log("  parallel %8.3f ms (%.2fx)  %s", parallel_ms / BENCH_SCHEDULER_FRAMES,
+            parallel_ms > 0.0 ? serial_ms / parallel_ms : 0.0, matches ? "matches serial" : "MISMATCH");
+
+    DestroySystemScheduler(parallel);
+    DestroySystemScheduler(serial);
+    delete parallel_world;
+    delete serial_world;
+    DestroyJobSystem(jobs);
+    return matches ? 0 : 1;
+}
@@ -0,0 +1,442 @@
+#include <SDL3/SDL.h>
+#include <compressed_texture.hpp>
+
+#include "bench.hpp"
+
+// The DDS and ASTC parsers on the shipped images, on truncations of them,
+// on hand-built headers at the edges the parsers guard (DX10 arrays and
+// cubes, mip and layer counts, sizes that would overflow) and on random
+// bytes. Every input is copied into a buffer of exactly its size, so a read
+// past the end shows up under ASan. No GPU: only parsing is run and timed.
+#define BENCH_TEXTURE_GARBAGE 200000
+#define BENCH_TEXTURE_GARBAGE_MAX 512
+#define BENCH_TEXTURE_PARSES 20000
+
+#define DDS_DATA_OFFSET (4 + 124)
+#define DDS_DX10_DATA_OFFSET (4 + 124 + 20)
+
+typedef struct ShippedTexture
+{
+    const char *file_name;
+    SDL_GPUTextureFormat format;
+} ShippedTexture;
+
+static const ShippedTexture SHIPPED_DDS[] = {
+    { "assets/Images/bcn/BC1.dds", SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM },
+    { "assets/Images/bcn/BC1_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB },
+    { "assets/Images/bcn/BC2.dds", SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM },
+    { "assets/Images/bcn/BC2_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM_SRGB },
+    { "assets/Images/bcn/BC3.dds", SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM },
+    { "assets/Images/bcn/BC3_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB },
+    { "assets/Images/bcn/BC4.dds", SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM },
+    { "assets/Images/bcn/BC5.dds", SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM },
+    { "assets/Images/bcn/BC6H_S.dds", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT },
+    { "assets/Images/bcn/BC6H_U.dds", SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT },
+    { "assets/Images/bcn/BC7.dds", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM },
+    { "assets/Images/bcn/BC7_SRGB.dds", SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB },
+};
+
+// Some of the shipped files hold a different block size than their name says
+// (10x5.astc is 8x6), so the expected block size comes from the header.
+static const char *SHIPPED_ASTC[] = {
+    "assets/Images/astc/4x4.astc", "assets/Images/astc/5x4.astc", "assets/Images/astc/5x5.astc",
+    "assets/Images/astc/6x5.astc", "assets/Images/astc/6x6.astc", "assets/Images/astc/8x5.astc",
+    "assets/Images/astc/8x6.astc", "assets/Images/astc/8x8.astc", "assets/Images/astc/10x5.astc",
+    "assets/Images/astc/10x6.astc", "assets/Images/astc/10x8.astc", "assets/Images/astc/10x10.astc",
+    "assets/Images/astc/12x10.astc", "assets/Images/astc/12x12.astc",
+};
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static void WriteU32(Uint8 *bytes, Uint32 value)
+{
+    bytes[0] = (Uint8)value;
+    bytes[1] = (Uint8)(value >> 8);
+    bytes[2] = (Uint8)(value >> 16);
+    bytes[3] = (Uint8)(value >> 24);
+}
+
+static void WriteU24(Uint8 *bytes, Uint32 value)
+{
+    bytes[0] = (Uint8)value;
+    bytes[1] = (Uint8)(value >> 8);
+    bytes[2] = (Uint8)(value >> 16);
+}
+
+// Parses that pointed outside their input, over every check
+static Uint32 escaped_parses = 0;
+
+// Parses a copy of size bytes of data that ends exactly at its allocation.
+static bool ParseExact(const Uint8 *data, size_t size, bool astc, CompressedImage *image)
+{
+    Uint8 *copy = static_cast<Uint8*>(SDL_malloc(size > 0 ? size : 1));
+    if (copy == NULL) {
+        return false;
+    }
+    SDL_memcpy(copy, data, size);
+    bool parsed = astc ? ParseASTC(copy, size, false, image) : ParseDDS(copy, size, image);
+    // The data pointer dies with the copy; the range is what callers may check
+    if (parsed && (image->data < copy || image->data + image->data_size > copy + size)) {
+        SDL_Log("FAIL: parsed data [%p, +%" SDL_PRIu64 ") is outside the %u-byte input",
+                (const void*)image->data, image->data_size, (unsigned)size);
+        escaped_parses++;
+        parsed = false;
+    }
+    image->data = NULL;
+    SDL_free(copy);
+    return parsed;
+}
+
+static void* LoadAsset(const char *file_name, size_t *size)
+{
+    char full_path[256];
+    SDL_snprintf(full_path, sizeof(full_path), "%s../%s", SDL_GetBasePath(), file_name);
+    void *data = SDL_LoadFile(full_path, size);
+    if (data == NULL) {
+        SDL_Log("FAIL: could not load %s", full_path);
+    }
+    return data;
+}
+
+// Every shipped file parses to its format with the data filling the rest of
+// the file, and shorter prefixes of it are refused: all of them through the
+// header and the first mips, then a stride through the rest and the last bytes.
+static bool CheckShippedFile(const char *file_name, bool astc, SDL_GPUTextureFormat format, double *parse_ns)
+{
+    size_t size;
+    Uint8 *data = static_cast<Uint8*>(LoadAsset(file_name, &size));
+    if (data == NULL) {
+        return false;
+    }
+
+    bool ok = true;
+    CompressedImage image;
+    if (!ParseExact(data, size, astc, &image)) {
+        SDL_Log("FAIL: %s does not parse: %s", file_name, SDL_GetError());
+        ok = false;
+    } else {
+        size_t header_size = astc ? 16 : (size - (size_t)image.data_size);
+        if (astc) {
+            Uint32 block_width = data[4], block_height = data[5];
+            if (image.block_width != block_width || image.block_height != block_height || image.block_size != 16) {
+                SDL_Log("FAIL: %s parsed as %ux%u blocks, header says %ux%u", file_name,
+                        image.block_width, image.block_height, block_width, block_height);
+                ok = false;
+            }
+            CompressedImage srgb_image;
+            if (!ParseASTC(data, size, true, &srgb_image) || srgb_image.format == image.format) {
+                SDL_Log("FAIL: %s parsed with srgb set keeps the UNORM format", file_name);
+                ok = false;
+            }
+            format = image.format;
+        } else if (header_size != DDS_DATA_OFFSET && header_size != DDS_DX10_DATA_OFFSET) {
+            SDL_Log("FAIL: %s has %u bytes before its data, not a DDS header's", file_name, (unsigned)header_size);
+            ok = false;
+        }
+        if (image.format != format || image.width != 256 || image.height != 256 || image.num_layers != 1 ||
+            image.type != SDL_GPU_TEXTURETYPE_2D || image.num_mips != (astc ? 1u : 9u) ||
+            header_size + image.data_size != size) {
+            SDL_Log("FAIL: %s parsed as format %d %ux%u, %u mips, %u layers, %" SDL_PRIu64 " of %u bytes",
+                    file_name, (int)image.format, image.width, image.height, image.num_mips, image.num_layers,
+                    image.data_size, (unsigned)size);
+            ok = false;
+        }
+    }
+
+    for (size_t prefix = 0; prefix < size && ok;
+         prefix = (prefix < 1024 || prefix + 16 >= size) ? prefix + 1 : SDL_min(prefix + 997, size - 16)) {
+        CompressedImage truncated;
+        if (ParseExact(data, prefix, astc, &truncated)) {
+            SDL_Log("FAIL: %s truncated to %u of %u bytes still parses", file_name, (unsigned)prefix, (unsigned)size);
+            ok = false;
+        }
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < BENCH_TEXTURE_PARSES; i++) {
+        if (astc) {
+            ParseASTC(data, size, false, &image);
+        } else {
+            ParseDDS(data, size, &image);
+        }
+    }
+    *parse_ns += (double)(SDL_GetTicksNS() - start) / BENCH_TEXTURE_PARSES;
+
+    SDL_free(data);
+    return ok;
+}
+
+// A DDS header in front of data_size zero bytes. fourcc "DX10" adds the
+// extended header with dxgi_format, dimension, misc_flag and array_size.
+typedef struct TestDDS
+{
+    Uint32 width;
+    Uint32 height;
+    Uint32 mips;
+    Uint32 caps2;
+    Uint32 pixel_flags;
+    Uint32 fourcc;
+    Uint32 dxgi_format;
+    Uint32 dimension;
+    Uint32 misc_flag;
+    Uint32 array_size;
+} TestDDS;
+
+static Uint8* BuildDDS(const TestDDS *test, size_t data_size, size_t *size)
+{
+    bool dx10 = test->fourcc == SDL_FOURCC('D', 'X', '1', '0');
+    size_t offset = dx10 ? DDS_DX10_DATA_OFFSET : DDS_DATA_OFFSET;
+    *size = offset + data_size;
+    Uint8 *bytes = static_cast<Uint8*>(SDL_calloc(1, *size));
+    if (bytes == NULL) {
+        return NULL;
+    }
+    WriteU32(bytes, SDL_FOURCC('D', 'D', 'S', ' '));
+    Uint8 *header = bytes + 4;
+    WriteU32(header, 124);
+    WriteU32(header + 8, test->height);
+    WriteU32(header + 12, test->width);
+    WriteU32(header + 24, test->mips);
+    WriteU32(header + 72, 32);
+    WriteU32(header + 76, test->pixel_flags);
+    WriteU32(header + 80, test->fourcc);
+    WriteU32(header + 108, test->caps2);
+    if (dx10) {
+        Uint8 *extended = bytes + DDS_DATA_OFFSET;
+        WriteU32(extended, test->dxgi_format);
+        WriteU32(extended + 4, test->dimension);
+        WriteU32(extended + 8, test->misc_flag);
+        WriteU32(extended + 12, test->array_size);
+    }
+    return bytes;
+}
+
+typedef struct DDSCase
+{
+    const char *name;
+    TestDDS header;
+    size_t data_size;
+    bool parses;
+    SDL_GPUTextureType type;    // When it parses
+    Uint32 num_layers;
+    Uint32 num_mips;
+} DDSCase;
+
+#define FOURCC_DX10 SDL_FOURCC('D', 'X', '1', '0')
+#define FOURCC_DXT1 SDL_FOURCC('D', 'X', 'T', '1')
+#define DDPF_FOURCC 0x4
+
+// 8 bytes per BC1 block: a 64x64 chain with all 7 mips is 2744 bytes, its top mip 2048.
+#define BC1_64_CHAIN 2744
+#define BC1_64_TOP 2048
+
+static const DDSCase DDS_CASES[] = {
+    { "legacy BC1, all mips", { 64, 64, 7, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_CHAIN, true, SDL_GPU_TEXTURETYPE_2D, 1, 7 },
+    { "legacy BC1, mip count 0 means 1", { 64, 64, 0, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_TOP, true, SDL_GPU_TEXTURETYPE_2D, 1, 1 },
+    { "legacy BC1, one byte short", { 64, 64, 7, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_CHAIN - 1, false },
+    { "legacy BC1, one mip more than 64x64 has", { 64, 64, 8, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_CHAIN + 8, false },
+    { "legacy BC1, 4 billion mips", { 64, 64, 0xFFFFFFFF, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_CHAIN, false },
+    { "legacy cubemap", { 64, 64, 1, 0xFE00, DDPF_FOURCC, FOURCC_DXT1 }, 6 * BC1_64_TOP, true, SDL_GPU_TEXTURETYPE_CUBE, 6, 1 },
+    { "legacy cubemap missing a face", { 64, 64, 1, 0x7E00, DDPF_FOURCC, FOURCC_DXT1 }, 6 * BC1_64_TOP, false },
+    { "legacy cubemap, not square", { 64, 32, 1, 0xFE00, DDPF_FOURCC, FOURCC_DXT1 }, 6 * BC1_64_TOP, false },
+    { "volume", { 64, 64, 1, 0x200000, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_TOP, false },
+    { "uncompressed legacy", { 64, 64, 1, 0, 0x40, 0 }, 64 * 64 * 4, false },
+    { "unknown FourCC", { 64, 64, 1, 0, DDPF_FOURCC, SDL_FOURCC('A', 'B', 'C', 'D') }, BC1_64_TOP, false },
+    { "zero width", { 0, 64, 1, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_TOP, false },
+    { "width past the limit", { 32768, 4, 1, 0, DDPF_FOURCC, FOURCC_DXT1 }, 65536, false },
+    { "4 billion by 4 billion", { 0xFFFFFFFF, 0xFFFFFFFF, 1, 0, DDPF_FOURCC, FOURCC_DXT1 }, BC1_64_TOP, false },
+    { "DX10 BC7 array of 3", { 64, 64, 7, 0, DDPF_FOURCC, FOURCC_DX10, 98, 3, 0, 3 }, 3 * 2 * BC1_64_CHAIN, true, SDL_GPU_TEXTURETYPE_2D_ARRAY, 3, 7 },
+    { "DX10 BC7 array of 3, last layer short", { 64, 64, 7, 0, DDPF_FOURCC, FOURCC_DX10, 98, 3, 0, 3 }, 3 * 2 * BC1_64_CHAIN - 16, false },
+    { "DX10 cube array of 2", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0x4, 2 }, 12 * BC1_64_TOP, true, SDL_GPU_TEXTURETYPE_CUBE_ARRAY, 12, 1 },
+    { "DX10 cube, not square", { 64, 32, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0x4, 1 }, 6 * BC1_64_TOP, false },
+    { "DX10 array size 0", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0, 0 }, BC1_64_TOP, false },
+    { "DX10 array size past the limit", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0, 4096 }, BC1_64_TOP, false },
+    { "DX10 4 billion layers", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0, 0xFFFFFFFF }, BC1_64_TOP, false },
+    // Within the array limit, but its 12288 faces are past the layer limit
+    { "DX10 2048 cubes", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 3, 0x4, 2048 }, BC1_64_TOP, false },
+    { "DX10 1D texture", { 64, 1, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 2, 0, 1 }, 128, false },
+    { "DX10 3D texture", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 71, 4, 0, 1 }, BC1_64_TOP, false },
+    { "DX10 unknown DXGI format", { 64, 64, 1, 0, DDPF_FOURCC, FOURCC_DX10, 1000, 3, 0, 1 }, BC1_64_TOP, false },
+    { "DX10 RGBA16F, 1x1 blocks", { 3, 5, 3, 0, DDPF_FOURCC, FOURCC_DX10, 10, 3, 0, 1 }, (15 + 2 + 1) * 8, true, SDL_GPU_TEXTURETYPE_2D, 1, 3 },
+    // 16384^2 RGBA32F with every mip in 2048 layers: ~2.9 TB, summed without wrapping and refused
+    { "DX10 size past 4 GB", { 16384, 16384, 15, 0, DDPF_FOURCC, FOURCC_DX10, 2, 3, 0, 2048 }, BC1_64_TOP, false },
+};
+
+static bool CheckDDSCases(void)
+{
+    bool ok = true;
+    for (const DDSCase &test : DDS_CASES) {
+        size_t size;
+        Uint8 *bytes = BuildDDS(&test.header, test.data_size, &size);
+        if (bytes == NULL) {
+            return false;
+        }
+        CompressedImage image;
+        bool parsed = ParseExact(bytes, size, false, &image);
+        if (parsed != test.parses) {
+            SDL_Log("FAIL: DDS %s %s", test.name, parsed ? "parses" : "is refused");
+            SDL_Log("  %s", SDL_GetError());
+            ok = false;
+        } else if (parsed && (image.type != test.type || image.num_layers != test.num_layers ||
+                              image.num_mips != test.num_mips || image.data_size != test.data_size)) {
+            SDL_Log("FAIL: DDS %s parsed as type %d, %u layers, %u mips, %" SDL_PRIu64 " bytes", test.name,
+                    (int)image.type, image.num_layers, image.num_mips, image.data_size);
+            ok = false;
+        }
+
+        // The headers alone, cut anywhere, never parse
+        size_t header_size = size - test.data_size;
+        for (size_t prefix = 0; prefix < header_size && ok; prefix++) {
+            if (ParseExact(bytes, prefix, false, &image)) {
+                SDL_Log("FAIL: DDS %s cut to %u header bytes parses", test.name, (unsigned)prefix);
+                ok = false;
+            }
+        }
+        SDL_free(bytes);
+    }
+    return ok;
+}
+
+typedef struct ASTCCase
+{
+    const char *name;
+    Uint8 block[3];
+    Uint32 size[3];
+    size_t data_size;
+    bool parses;
+} ASTCCase;
+
+static const ASTCCase ASTC_CASES[] = {
+    { "6x6, 100x50", { 6, 6, 1 }, { 100, 50, 1 }, 17 * 9 * 16, true },
+    { "6x6, 100x50, one byte short", { 6, 6, 1 }, { 100, 50, 1 }, 17 * 9 * 16 - 1, false },
+    { "12x12, 1x1", { 12, 12, 1 }, { 1, 1, 1 }, 16, true },
+    { "3x3 blocks", { 3, 3, 1 }, { 64, 64, 1 }, 22 * 22 * 16, false },
+    { "4x12 blocks", { 4, 12, 1 }, { 64, 64, 1 }, 16 * 6 * 16, false },
+    { "3D blocks", { 4, 4, 4 }, { 64, 64, 4 }, 16 * 16 * 16, false },
+    { "depth 2", { 4, 4, 1 }, { 64, 64, 2 }, 2 * 16 * 16 * 16, false },
+    { "depth 0", { 4, 4, 1 }, { 64, 64, 0 }, 16 * 16 * 16, false },
+    { "zero height", { 4, 4, 1 }, { 64, 0, 1 }, 16, false },
+    { "16M wide", { 4, 4, 1 }, { 0xFFFFFF, 4, 1 }, 16, false },
+};
+
+static bool CheckASTCCases(void)
+{
+    bool ok = true;
+    for (const ASTCCase &test : ASTC_CASES) {
+        size_t size = 16 + test.data_size;
+        Uint8 *bytes = static_cast<Uint8*>(SDL_calloc(1, size));
+        if (bytes == NULL) {
+            return false;
+        }
+        WriteU32(bytes, 0x5CA1AB13);
+        SDL_memcpy(bytes + 4, test.block, 3);
+        for (int axis = 0; axis < 3; axis++) {
+            WriteU24(bytes + 7 + axis * 3, test.size[axis]);
+        }
+        CompressedImage image;
+        bool parsed = ParseExact(bytes, size, true, &image);
+        if (parsed != test.parses) {
+            SDL_Log("FAIL: ASTC %s %s", test.name, parsed ? "parses" : "is refused");
+            SDL_Log("  %s", SDL_GetError());
+            ok = false;
+        } else if (parsed && image.data_size != test.data_size) {
+            SDL_Log("FAIL: ASTC %s parsed as %" SDL_PRIu64 " bytes", test.name, image.data_size);
+            ok = false;
+        }
+        SDL_free(bytes);
+    }
+    return ok;
+}
+
+// Random bytes, half of them behind a valid magic and a third of those behind
+// a whole plausible header, so the parsers get past their first checks.
+// Counts how many parsed; ParseExact fails any that points outside its input.
+static void CheckGarbage(bool astc, Uint32 *accepted, double *parse_ns)
+{
+    Uint8 bytes[BENCH_TEXTURE_GARBAGE_MAX];
+    Uint32 seed = astc ? 11 : 5;
+    *accepted = 0;
+    Uint64 start = SDL_GetTicksNS();
+    for (int i = 0; i < BENCH_TEXTURE_GARBAGE; i++) {
+        size_t size = NextRandom(&seed) % BENCH_TEXTURE_GARBAGE_MAX;
+        for (size_t b = 0; b < size; b++) {
+            bytes[b] = (Uint8)NextRandom(&seed);
+        }
+        Uint32 shape = NextRandom(&seed) % 6;
+        if (astc && shape < 3 && size >= 16) {
+            WriteU32(bytes, 0x5CA1AB13);
+            if (shape == 0) {
+                bytes[4] = (Uint8)(4 + NextRandom(&seed) % 9);
+                bytes[5] = (Uint8)(4 + NextRandom(&seed) % 9);
+                bytes[6] = 1;
+                WriteU24(bytes + 7, NextRandom(&seed) % 64);
+                WriteU24(bytes + 10, NextRandom(&seed) % 64);
+                WriteU24(bytes + 13, 1);
+            }
+        } else if (!astc && shape < 3 && size >= DDS_DX10_DATA_OFFSET) {
+            WriteU32(bytes, SDL_FOURCC('D', 'D', 'S', ' '));
+            if (shape == 0) {
+                WriteU32(bytes + 4, 124);
+                WriteU32(bytes + 4 + 8, NextRandom(&seed) % 16);
+                WriteU32(bytes + 4 + 12, NextRandom(&seed) % 16);
+                WriteU32(bytes + 4 + 24, NextRandom(&seed) % 6);
+                WriteU32(bytes + 4 + 72, 32);
+                WriteU32(bytes + 4 + 76, DDPF_FOURCC);
+                WriteU32(bytes + 4 + 80, (NextRandom(&seed) & 1) ? FOURCC_DXT1 : FOURCC_DX10);
+                WriteU32(bytes + 4 + 108, NextRandom(&seed) & 0x200 ? 0xFE00 : 0);
+                WriteU32(bytes + DDS_DATA_OFFSET, 71 + NextRandom(&seed) % 3);
+                WriteU32(bytes + DDS_DATA_OFFSET + 4, 3);
+                WriteU32(bytes + DDS_DATA_OFFSET + 8, NextRandom(&seed) & 0x4);
+                WriteU32(bytes + DDS_DATA_OFFSET + 12, 1 + NextRandom(&seed) % 3);
+            }
+        }
+        CompressedImage image;
+        if (ParseExact(bytes, size, astc, &image)) {
+            (*accepted)++;
+        }
+    }
+    *parse_ns = (double)(SDL_GetTicksNS() - start) / BENCH_TEXTURE_GARBAGE;
+}
+
+int BenchTextures(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    int result = 0;
+
+    double dds_ns = 0.0, astc_ns = 0.0;
+    for (const ShippedTexture &texture : SHIPPED_DDS) {
+        result |= CheckShippedFile(texture.file_name, false, texture.format, &dds_ns) ? 0 : 1;
+    }
+    for (const char *file_name : SHIPPED_ASTC) {
+        result |= CheckShippedFile(file_name, true, SDL_GPU_TEXTUREFORMAT_INVALID, &astc_ns) ? 0 : 1;
+    }
+    SDL_Log("Shipped files: %u DDS, %u ASTC, truncations refused; %.0f ns per DDS parse, %.0f ns per ASTC parse",
+            (unsigned)SDL_arraysize(SHIPPED_DDS), (unsigned)SDL_arraysize(SHIPPED_ASTC),
+            dds_ns / SDL_arraysize(SHIPPED_DDS), astc_ns / SDL_arraysize(SHIPPED_ASTC));
+
+    result |= CheckDDSCases() ? 0 : 1;
+    result |= CheckASTCCases() ? 0 : 1;
+    SDL_Log("Edge headers: %u DDS, %u ASTC", (unsigned)SDL_arraysize(DDS_CASES), (unsigned)SDL_arraysize(ASTC_CASES));
+
+    for (int astc = 0; astc < 2; astc++) {
+        Uint32 accepted;
+        double garbage_ns;
+        CheckGarbage(astc != 0, &accepted, &garbage_ns);
+        SDL_Log("Garbage %s: %d inputs up to %d bytes, %u parsed; %.0f ns each (with the copy)",
+                astc ? "ASTC" : "DDS", BENCH_TEXTURE_GARBAGE, BENCH_TEXTURE_GARBAGE_MAX, accepted, garbage_ns);
+    }
+    if (escaped_parses > 0) {
+        SDL_Log("FAIL: %u parses pointed outside their input", escaped_parses);
+        result = 1;
+    }
+
+    if (result == 0) {
+        SDL_Log("All texture parser checks passed");
+    }
+    return result;
+}
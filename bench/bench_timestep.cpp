@@ -0,0 +1,373 @@
+#include <SDL3/SDL.h>
+#include <fixed_timestep.hpp>
+#include <scheduler.hpp>
+#include <transform.hpp>
+
+#include "bench.hpp"
+
+// A 120 Hz simulation of bouncing, spinning parents with orbiting children,
+// stepped through the scheduler and the transform hierarchy, driven by
+// render loops at different rates: steady 30, 60, 144 and 240 Hz, a jittery
+// variable rate, and 60 Hz with regular stalls the per-frame cap drops
+// ticks from. Every loop must produce the same world at every tick. A
+// constant-velocity probe checks that interpolated rendering moves smoothly,
+// and a model of ticks that cost more than they simulate shows the cap
+// bounding frame time where an uncapped loop spirals.
+#define BENCH_TIMESTEP_HZ 120
+#define BENCH_TIMESTEP_MAX_TICKS 8
+#define BENCH_TIMESTEP_SECONDS 5
+#define BENCH_TIMESTEP_PARENTS 256
+#define BENCH_TIMESTEP_CHILDREN 15
+#define BENCH_TIMESTEP_CHUNK 64
+#define BENCH_TIMESTEP_MAX_RECORDED (BENCH_TIMESTEP_HZ * BENCH_TIMESTEP_SECONDS + 1)
+#define BENCH_TIMESTEP_BOX 50.0f
+#define BENCH_TIMESTEP_PROBE_SPEED 3.0f     // Units per second along x
+
+typedef struct Motion { float position[3], velocity[3]; } Motion;
+typedef struct Spin { float rotation[4], rate[4]; } Spin;    // rate: the rotation applied each tick
+typedef struct Orbit { float radius, angle, speed; } Orbit;
+
+typedef struct TimestepWorld
+{
+    entt::registry registry;
+    TransformHierarchy *transforms;
+    SystemScheduler *scheduler;
+    entt::entity probe;
+    float dt;
+    Uint64 hashes[BENCH_TIMESTEP_MAX_RECORDED];
+    Uint64 ticks;
+    float probe_previous[16];
+    float probe_current[16];
+} TimestepWorld;
+
+typedef struct TimestepLoop
+{
+    const char *name;
+    double hz;                  // Render rate; 0 for variable
+    bool stalls;
+} TimestepLoop;
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+static float RandomFloat(Uint32 *seed, float low, float high)
+{
+    return low + (high - low) * (NextRandom(seed) & 0xFFFF) / 65535.0f;
+}
+
+static void MoveSystem(SystemContext *context, entt::registry &registry, void *userdata)
+{
+    float dt = static_cast<TimestepWorld*>(userdata)->dt;
+    ForEachChunked<Motion>(context, registry, BENCH_TIMESTEP_CHUNK, [dt](entt::entity, Motion &motion) {
+        for (int axis = 0; axis < 3; axis++) {
+            motion.position[axis] += motion.velocity[axis] * dt;
+            if (SDL_fabsf(motion.position[axis]) > BENCH_TIMESTEP_BOX && motion.position[axis] * motion.velocity[axis] > 0.0f) {
+                motion.velocity[axis] = -motion.velocity[axis];
+            }
+        }
+    });
+}
+
+static void SpinSystem(SystemContext *context, entt::registry &registry, void *)
+{
+    ForEachChunked<Spin>(context, registry, BENCH_TIMESTEP_CHUNK, [](entt::entity, Spin &spin) {
+        const float *a = spin.rotation, *b = spin.rate;
+        float q[4] = {
+            a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+            a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+            a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+            a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2],
+        };
+        float length = SDL_sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        for (int i = 0; i < 4; i++) {
+            spin.rotation[i] = q[i] / length;
+        }
+    });
+}
+
+static void OrbitSystem(SystemContext *context, entt::registry &registry, void *userdata)
+{
+    float dt = static_cast<TimestepWorld*>(userdata)->dt;
+    ForEachChunked<Orbit>(context, registry, BENCH_TIMESTEP_CHUNK, [dt](entt::entity, Orbit &orbit) {
+        orbit.angle = SDL_fmodf(orbit.angle + orbit.speed * dt, 2.0f * SDL_PI_F);
+    });
+}
+
+// Serial: the hierarchy isn't safe to write from several threads
+static void TransformSystem(SystemContext *, entt::registry &registry, void *userdata)
+{
+    TimestepWorld *world = static_cast<TimestepWorld*>(userdata);
+    for (auto [entity, motion, spin] : registry.view<const Motion, const Spin>().each()) {
+        LocalTransform local = { { motion.position[0], motion.position[1], motion.position[2] },
+                                 { spin.rotation[0], spin.rotation[1], spin.rotation[2], spin.rotation[3] },
+                                 { 1.0f, 1.0f, 1.0f } };
+        SetLocalTransform(world->transforms, entity, &local);
+    }
+    for (auto [entity, orbit] : registry.view<const Orbit>().each()) {
+        SetLocalPosition(world->transforms, entity, orbit.radius * SDL_cosf(orbit.angle), 0.0f, orbit.radius * SDL_sinf(orbit.angle));
+    }
+    UpdateTransforms(world->transforms, TRANSFORM_UPDATE_AUTO);
+}
+
+static bool CreateTimestepWorld(TimestepWorld *world, JobSystem *jobs)
+{
+    world->dt = 1.0f / BENCH_TIMESTEP_HZ;
+    world->ticks = 0;
+    world->transforms = CreateTransformHierarchy((BENCH_TIMESTEP_PARENTS + 1) * (BENCH_TIMESTEP_CHILDREN + 1));
+    world->scheduler = CreateSystemScheduler(jobs);
+    if (world->transforms == NULL || world->scheduler == NULL) {
+        return false;
+    }
+
+    Uint32 seed = 24;
+    for (int p = 0; p < BENCH_TIMESTEP_PARENTS; p++) {
+        entt::entity parent = world->registry.create();
+        AddTransform(world->transforms, parent, entt::null);
+        Motion motion;
+        Spin spin;
+        for (int axis = 0; axis < 3; axis++) {
+            motion.position[axis] = RandomFloat(&seed, -BENCH_TIMESTEP_BOX, BENCH_TIMESTEP_BOX);
+            motion.velocity[axis] = RandomFloat(&seed, -20.0f, 20.0f);
+        }
+        float axis[3] = { RandomFloat(&seed, -1.0f, 1.0f), RandomFloat(&seed, -1.0f, 1.0f), 1.0f };
+        float length = SDL_sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        float half_angle = RandomFloat(&seed, 0.5f, 4.0f) * world->dt * 0.5f;
+        for (int i = 0; i < 3; i++) {
+            spin.rotation[i] = 0.0f;
+            spin.rate[i] = axis[i] / length * SDL_sinf(half_angle);
+        }
+        spin.rotation[3] = 1.0f;
+        spin.rate[3] = SDL_cosf(half_angle);
+        world->registry.emplace<Motion>(parent, motion);
+        world->registry.emplace<Spin>(parent, spin);
+
+        for (int c = 0; c < BENCH_TIMESTEP_CHILDREN; c++) {
+            entt::entity child = world->registry.create();
+            AddTransform(world->transforms, child, parent);
+            Orbit orbit = { RandomFloat(&seed, 1.0f, 5.0f), RandomFloat(&seed, 0.0f, 6.0f), RandomFloat(&seed, -3.0f, 3.0f) };
+            world->registry.emplace<Orbit>(child, orbit);
+        }
+    }
+    // Moves at constant speed and never bounces, so where it should be drawn is known exactly
+    world->probe = world->registry.create();
+    AddTransform(world->transforms, world->probe, entt::null);
+    Motion probe_motion = { { 0.0f, 0.0f, 0.0f }, { BENCH_TIMESTEP_PROBE_SPEED, 0.0f, 0.0f } };
+    Spin probe_spin = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } };
+    world->registry.emplace<Motion>(world->probe, probe_motion);
+    world->registry.emplace<Spin>(world->probe, probe_spin);
+
+    const ComponentID motion[] = { GetComponentID<Motion>() };
+    const ComponentID spin[] = { GetComponentID<Spin>() };
+    const ComponentID orbit[] = { GetComponentID<Orbit>() };
+    const ComponentID transform_reads[] = { GetComponentID<Motion>(), GetComponentID<Spin>(), GetComponentID<Orbit>() };
+    const ComponentID transform_writes[] = { GetComponentID<TransformHierarchy>() };
+    const SystemDesc systems[] = {
+        { "move", MoveSystem, world, NULL, 0, motion, 1 },
+        { "spin", SpinSystem, world, NULL, 0, spin, 1 },
+        { "orbit", OrbitSystem, world, NULL, 0, orbit, 1 },
+        { "transforms", TransformSystem, world, transform_reads, 3, transform_writes, 1 },
+    };
+    for (const SystemDesc &system : systems) {
+        if (AddSystem(world->scheduler, &system) < 0) {
+            return false;
+        }
+    }
+    UpdateTransforms(world->transforms, TRANSFORM_UPDATE_AUTO);
+    GetWorldMatrix(world->transforms, world->probe, world->probe_current);
+    SDL_memcpy(world->probe_previous, world->probe_current, sizeof(world->probe_current));
+    return true;
+}
+
+static void DestroyTimestepWorld(TimestepWorld *world)
+{
+    DestroySystemScheduler(world->scheduler);
+    DestroyTransformHierarchy(world->transforms);
+}
+
+static void SimulateTick(Uint64 tick, double, void *userdata)
+{
+    TimestepWorld *world = static_cast<TimestepWorld*>(userdata);
+    SDL_memcpy(world->probe_previous, world->probe_current, sizeof(world->probe_current));
+    RunSystems(world->scheduler, world->registry, false);
+    GetWorldMatrix(world->transforms, world->probe, world->probe_current);
+
+    Uint64 hash = 14695981039346656037ull;
+    for (auto entity : world->registry.view<entt::entity>()) {
+        float matrix[16];
+        GetWorldMatrix(world->transforms, entity, matrix);
+        Uint32 words[16];
+        SDL_memcpy(words, matrix, sizeof(words));
+        for (int i = 0; i < 16; i++) {
+            hash = (hash ^ words[i]) * 1099511628211ull;
+        }
+    }
+    if (tick < BENCH_TIMESTEP_MAX_RECORDED) {
+        world->hashes[tick] = hash;
+    }
+    world->ticks = tick + 1;
+}
+
+typedef struct LoopResult
+{
+    Uint32 frames;
+    Uint32 ticks_per_frame[BENCH_TIMESTEP_MAX_TICKS + 1];
+    float interpolated_error;   // Largest distance of the drawn probe from where it should be
+    float raw_error;            // The same, drawing the latest tick as is
+    FixedTimestepStats stats;
+} LoopResult;
+
+// Renders for BENCH_TIMESTEP_SECONDS of wall time, all of it simulated here
+// instead of waiting for a clock.
+static bool RunLoop(const TimestepLoop *loop, JobSystem *jobs, TimestepWorld *world, LoopResult *result)
+{
+    SDL_zerop(result);
+    if (!CreateTimestepWorld(world, jobs)) {
+        return false;
+    }
+    FixedTimestep timestep;
+    InitFixedTimestep(&timestep, BENCH_TIMESTEP_HZ, BENCH_TIMESTEP_MAX_TICKS);
+
+    Uint32 seed = 99;
+    Uint64 wall_ns = 0, end_ns = (Uint64)BENCH_TIMESTEP_SECONDS * 1000000000ull;
+    while (wall_ns < end_ns) {
+        Uint64 elapsed_ns;
+        if (loop->hz > 0.0) {
+            // Exact frame times, rounded the way a real nanosecond clock would be
+            elapsed_ns = (Uint64)((result->frames + 1) * 1e9 / loop->hz) - (Uint64)(result->frames * 1e9 / loop->hz);
+        } else {
+            elapsed_ns = 2000000 + NextRandom(&seed) % 38000000;
+        }
+        if (loop->stalls && result->frames % 60 == 59) {
+            elapsed_ns += 400000000;
+        }
+        elapsed_ns = SDL_min(elapsed_ns, end_ns - wall_ns);
+        wall_ns += elapsed_ns;
+
+        Uint32 due = AccumulateFixedTimestep(&timestep, elapsed_ns);
+        RunFixedTicks(&timestep, due, SimulateTick, world);
+        result->ticks_per_frame[due]++;
+        result->frames++;
+
+        // Drawn one tick behind the simulation, alpha of the way to the latest tick
+        float alpha = GetFixedTimestepAlpha(&timestep);
+        float matrix[16];
+        InterpolateWorldMatrix(world->probe_previous, world->probe_current, alpha, matrix);
+        if (world->ticks >= 1) {
+            float expected = BENCH_TIMESTEP_PROBE_SPEED * world->dt * ((float)world->ticks - 1.0f + alpha);
+            float raw_expected = BENCH_TIMESTEP_PROBE_SPEED * world->dt * ((float)world->ticks + alpha);
+            result->interpolated_error = SDL_max(result->interpolated_error, SDL_fabsf(matrix[12] - expected));
+            result->raw_error = SDL_max(result->raw_error, SDL_fabsf(world->probe_current[12] - raw_expected));
+        }
+    }
+    result->stats = timestep.stats;
+    return true;
+}
+
+// Ticks that take 1.5x the time they simulate, plus 2 ms of rendering: the
+// next frame's elapsed time is whatever this one's ticks cost.
+static void ModelSpiral(Uint32 max_ticks, Uint32 frames, Uint32 *last_ticks, double *last_frame_ms)
+{
+    FixedTimestep timestep;
+    InitFixedTimestep(&timestep, BENCH_TIMESTEP_HZ, max_ticks);
+    Uint64 elapsed_ns = 1000000000ull / 60;
+    for (Uint32 frame = 0; frame < frames; frame++) {
+        Uint32 due = AccumulateFixedTimestep(&timestep, elapsed_ns);
+        *last_ticks = due;
+        elapsed_ns = (Uint64)(due * 1.5 * 1e9 / BENCH_TIMESTEP_HZ) + 2000000;
+        *last_frame_ms = elapsed_ns / 1e6;
+    }
+}
+
+int BenchTimestep(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    static const TimestepLoop loops[] = {
+        { "30 Hz", 30.0, false },
+        { "60 Hz", 60.0, false },
+        { "144 Hz", 144.0, false },
+        { "240 Hz", 240.0, false },
+        { "variable", 0.0, false },
+        { "60 Hz + stalls", 60.0, true },
+    };
+    JobSystem *jobs = CreateJobSystem(-1);
+    TimestepWorld *reference = new TimestepWorld();
+    bool ok = jobs != NULL;
+
+    SDL_Log("%d Hz simulation of %d transforms, at most %d ticks a frame, %d s of each render loop:", BENCH_TIMESTEP_HZ,
+            BENCH_TIMESTEP_PARENTS * (BENCH_TIMESTEP_CHILDREN + 1) + 1, BENCH_TIMESTEP_MAX_TICKS, BENCH_TIMESTEP_SECONDS);
+    SDL_Log("  %-16s %7s %7s %8s %10s  %-22s %12s %12s", "loop", "frames", "ticks", "dropped", "tick ms", "ticks/frame 0 1 2 3+",
+            "lerp error", "raw error");
+    for (Uint32 l = 0; ok && l < SDL_arraysize(loops); l++) {
+        // A fresh world each run, so entities are created and iterated in the same order
+        TimestepWorld *target = l == 0 ? reference : new TimestepWorld();
+        LoopResult result;
+        Uint64 start = SDL_GetTicksNS();
+        ok = RunLoop(&loops[l], jobs, target, &result);
+        double ms = BenchElapsedMS(start);
+        if (!ok) {
+            SDL_Log("FAIL: could not create the world: %s", SDL_GetError());
+            if (target != reference) {
+                DestroyTimestepWorld(target);
+                delete target;
+            }
+            break;
+        }
+        Uint32 more = 0;
+        for (int t = 3; t <= BENCH_TIMESTEP_MAX_TICKS; t++) {
+            more += result.ticks_per_frame[t];
+        }
+        SDL_Log("  %-16s %7u %7llu %8llu %10.3f  %5u %4u %4u %4u %12.6f %12.6f  (%.0f ms)", loops[l].name, result.frames,
+                (unsigned long long)result.stats.ticks, (unsigned long long)result.stats.dropped_ticks, result.stats.tick_average_ms,
+                result.ticks_per_frame[0], result.ticks_per_frame[1], result.ticks_per_frame[2], more,
+                result.interpolated_error, result.raw_error, ms);
+
+        // Same tick, same world, whatever the frames looked like
+        Uint64 common = SDL_min(target->ticks, reference->ticks);
+        common = SDL_min(common, (Uint64)BENCH_TIMESTEP_MAX_RECORDED);
+        for (Uint64 t = 0; ok && t < common; t++) {
+            if (target->hashes[t] != reference->hashes[t]) {
+                SDL_Log("FAIL: %s diverges from %s at tick %llu", loops[l].name, loops[0].name, (unsigned long long)t);
+                ok = false;
+            }
+        }
+        bool expect_drops = loops[l].stalls;
+        if (ok && ((result.stats.dropped_ticks > 0) != expect_drops ||
+                   (!expect_drops && result.stats.ticks != (Uint64)BENCH_TIMESTEP_HZ * BENCH_TIMESTEP_SECONDS))) {
+            SDL_Log("FAIL: %s ran %llu ticks, dropping %llu", loops[l].name, (unsigned long long)result.stats.ticks,
+                    (unsigned long long)result.stats.dropped_ticks);
+            ok = false;
+        }
+        // The probe moves 0.025 a tick; drawn interpolated it should be off by float rounding only
+        if (ok && !expect_drops && result.interpolated_error > 1e-3f) {
+            SDL_Log("FAIL: %s interpolated probe is %.6f off", loops[l].name, result.interpolated_error);
+            ok = false;
+        }
+        if (target != reference) {
+            DestroyTimestepWorld(target);
+            delete target;
+        }
+    }
+    DestroyTimestepWorld(reference);
+
+    if (ok) {
+        Uint32 capped_ticks, uncapped_ticks;
+        double capped_ms, uncapped_ms;
+        ModelSpiral(BENCH_TIMESTEP_MAX_TICKS, 30, &capped_ticks, &capped_ms);
+        ModelSpiral(1000000, 30, &uncapped_ticks, &uncapped_ms);
+        SDL_Log("Ticks costing 1.5x their time, after 30 frames: capped %u ticks, %.1f ms frames; uncapped %u ticks, %.1f ms frames",
+                capped_ticks, capped_ms, uncapped_ticks, uncapped_ms);
+        if (capped_ticks > BENCH_TIMESTEP_MAX_TICKS || uncapped_ticks <= 10 * BENCH_TIMESTEP_MAX_TICKS) {
+            SDL_Log("FAIL: the cap did not hold frame time, or the uncapped model did not spiral");
+            ok = false;
+        }
+    }
+
+    delete reference;
+    DestroyJobSystem(jobs);
+    return ok ? 0 : 1;
+}
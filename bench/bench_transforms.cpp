@@ -0,0 +1,123 @@
+#include <SDL3/SDL.h>
+#include <transform.hpp>
+
+#include "bench.hpp"
+
+// 1000 root objects with 100 descendants each (branching 4, depth 4): a
+// scene of props and skeletons rather than a flat particle field.
+#define BENCH_TRANSFORM_ROOTS 1000
+#define BENCH_TRANSFORM_PER_ROOT 100
+#define BENCH_TRANSFORM_BRANCHING 4
+#define BENCH_TRANSFORM_FRAMES 100
+
+static const char *PATH_NAMES[] = { "auto", "scalar", "sse2", "avx2" };
+
+// Moves every stride-th root, which makes its whole subtree dirty.
+static void AnimateRoots(TransformHierarchy *hierarchy, const entt::entity *roots, Uint32 stride, int frame)
+{
+    float angle = frame * 0.01f;
+    for (Uint32 i = 0; i < BENCH_TRANSFORM_ROOTS; i += stride) {
+        SetLocalPosition(hierarchy, roots[i], (float)i, SDL_sinf(angle), 0.0f);
+        SetLocalRotation(hierarchy, roots[i], 0.0f, SDL_sinf(angle * 0.5f), 0.0f, SDL_cosf(angle * 0.5f));
+    }
+}
+
+int BenchTransforms(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    entt::registry registry;
+    TransformHierarchy *hierarchies[TRANSFORM_UPDATE_AVX2 + 1] = {};
+    entt::entity roots[BENCH_TRANSFORM_ROOTS];
+    Uint32 count = BENCH_TRANSFORM_ROOTS * BENCH_TRANSFORM_PER_ROOT;
+    entt::entity *entities = static_cast<entt::entity*>(SDL_malloc(count * sizeof(entt::entity)));
+
+    for (int path = TRANSFORM_UPDATE_SCALAR; path <= TRANSFORM_UPDATE_AVX2; path++) {
+        hierarchies[path] = CreateTransformHierarchy(BENCH_TRANSFORM_ROOTS * BENCH_TRANSFORM_PER_ROOT);
+    }
+
+    // Children are created interleaved across roots, so the depth sort has real work to do.
+    for (Uint32 r = 0; r < BENCH_TRANSFORM_ROOTS; r++) {
+        roots[r] = registry.create();
+        for (int path = TRANSFORM_UPDATE_SCALAR; path <= TRANSFORM_UPDATE_AVX2; path++) {
+            AddTransform(hierarchies[path], roots[r], entt::null);
+        }
+    }
+    Uint32 seed = 12345;
+    for (Uint32 r = 0; r < BENCH_TRANSFORM_ROOTS; r++) {
+        entt::entity *nodes = entities + r * BENCH_TRANSFORM_PER_ROOT;
+        nodes[0] = roots[r];
+        for (Uint32 n = 1; n < BENCH_TRANSFORM_PER_ROOT; n++) {
+            nodes[n] = registry.create();
+            seed = seed * 1664525 + 1013904223;
+            LocalTransform local = {
+                { (float)(seed >> 24) / 255.0f, 0.5f, 0.0f },
+                { 0.0f, 0.0f, 0.38268343f, 0.92387953f },
+                { 0.9f, 0.9f, 0.9f }
+            };
+            for (int path = TRANSFORM_UPDATE_SCALAR; path <= TRANSFORM_UPDATE_AVX2; path++) {
+                AddTransform(hierarchies[path], nodes[n], nodes[(n - 1) / BENCH_TRANSFORM_BRANCHING]);
+                SetLocalTransform(hierarchies[path], nodes[n], &local);
+            }
+        }
+    }
+    Uint64 start = SDL_GetTicksNS();
+    UpdateTransforms(hierarchies[TRANSFORM_UPDATE_SCALAR], TRANSFORM_UPDATE_SCALAR);
+    SDL_Log("%u transforms, depth %u; first update with sort %.3f ms", count,
+            GetTransformStats(hierarchies[TRANSFORM_UPDATE_SCALAR]).depth, BenchElapsedMS(start));
+
+    static const struct { const char *name; Uint32 stride; } cases[] = {
+        { "all moving", 1 },
+        { "1% moving", 100 },
+        { "static", 0 },
+    };
+    int result = 0;
+    for (const auto &bench_case : cases) {
+        SDL_Log("%s, one thread, mean of %d frames:", bench_case.name, BENCH_TRANSFORM_FRAMES);
+        double scalar_ms = 0.0;
+        for (int path = TRANSFORM_UPDATE_SCALAR; path <= TRANSFORM_UPDATE_AVX2; path++) {
+            TransformHierarchy *hierarchy = hierarchies[path];
+            if (ResolveTransformUpdatePath((TransformUpdatePath)path) != path) {
+                SDL_Log("  %-6s not supported on this CPU/compiler", PATH_NAMES[path]);
+                continue;
+            }
+            UpdateTransforms(hierarchy, (TransformUpdatePath)path);
+
+            double total_ms = 0.0;
+            Uint32 updated = 0;
+            for (int frame = 0; frame < BENCH_TRANSFORM_FRAMES; frame++) {
+                if (bench_case.stride > 0) {
+                    AnimateRoots(hierarchy, roots, bench_case.stride, frame);
+                }
+                start = SDL_GetTicksNS();
+                updated = UpdateTransforms(hierarchy, (TransformUpdatePath)path);
+                total_ms += BenchElapsedMS(start);
+            }
+            double mean_ms = total_ms / BENCH_TRANSFORM_FRAMES;
+            if (path == TRANSFORM_UPDATE_SCALAR) {
+                scalar_ms = mean_ms;
+            }
+
+            // Every path ran the same frames, so the matrices have to match exactly.
+            bool matches = true;
+            for (Uint32 i = 0; i < count && matches; i++) {
+                float expected[16], actual[16];
+                GetWorldMatrix(hierarchies[TRANSFORM_UPDATE_SCALAR], entities[i], expected);
+                GetWorldMatrix(hierarchy, entities[i], actual);
+                matches = SDL_memcmp(expected, actual, sizeof(expected)) == 0;
+            }
+            SDL_Log("  %-6s %8.4f ms  %7.1f M/s (%.2fx)  %6u updated  %s", PATH_NAMES[path], mean_ms,
+                    updated / (mean_ms * 1e3), mean_ms > 0.0 ? scalar_ms / mean_ms : 0.0, updated,
+                    matches ? "matches scalar" : "MISMATCH");
+            if (!matches) {
+                result = 1;
+            }
+        }
+    }
+
+    for (int path = TRANSFORM_UPDATE_SCALAR; path <= TRANSFORM_UPDATE_AVX2; path++) {
+        DestroyTransformHierarchy(hierarchies[path]);
+    }
+    SDL_free(entities);
+    return result;
+}
@@ -0,0 +1,370 @@
+#include <SDL3/SDL.h>
+#include <upload_manager.hpp>
+
+#include "bench.hpp"
+
+// The upload ring's allocation, wraparound and release, then the upload
+// manager on top of it without a device: frame budget splitting, full-ring
+// stalls, refused uploads and all-or-nothing mip sets. Headless flushes
+// complete at once, so only the CPU side (ring bookkeeping and staging
+// copies) is timed.
+#define BENCH_RING_BYTES (64 * 1024)
+#define BENCH_RING_LIVE 8192
+#define BENCH_RING_ALLOCATIONS 1000000
+#define BENCH_UPLOAD_FRAMES 200
+#define BENCH_UPLOADS_PER_FRAME 256
+#define BENCH_UPLOAD_BYTES 1024
+
+static Uint32 NextRandom(Uint32 *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed >> 8;
+}
+
+static void SDLCALL CountRelease(void *userdata, const void *data)
+{
+    (void)data;
+    (*static_cast<int*>(userdata))++;
+}
+
+typedef struct ReleaseRecord
+{
+    int count;
+    const void *data;
+} ReleaseRecord;
+
+static void SDLCALL RecordRelease(void *userdata, const void *data)
+{
+    ReleaseRecord *record = static_cast<ReleaseRecord*>(userdata);
+    record->count++;
+    record->data = data;
+}
+
+static bool CheckRing(void)
+{
+    UploadRing ring;
+    InitUploadRing(&ring, 4096);
+    Uint32 first, second, wrapped, offset;
+    if (!UploadRingAllocate(&ring, 1000, 16, &first) || !UploadRingAllocate(&ring, 2500, 512, &second) ||
+        first != 0 || second != 1024) {
+        SDL_Log("FAIL: ring allocations are misplaced");
+        return false;
+    }
+
+    // Doesn't fit before the end, and the wrapped region would run into the first allocation
+    if (UploadRingAllocate(&ring, 1000, 16, &wrapped)) {
+        SDL_Log("FAIL: full ring handed out an overlapping region at %u", wrapped);
+        return false;
+    }
+    // Once that's released the wrapped region takes its place, and the skipped end counts as used
+    UploadRingRelease(&ring, 1000);
+    if (!UploadRingAllocate(&ring, 1000, 16, &wrapped) || wrapped != 0 || GetUploadRingUsed(&ring) != 4096) {
+        SDL_Log("FAIL: wrapped allocation is misplaced or its padding is not counted");
+        return false;
+    }
+    if (UploadRingAllocate(&ring, 16, 16, &offset)) {
+        SDL_Log("FAIL: full ring handed out the padding at %u", offset);
+        return false;
+    }
+
+    UploadRingRelease(&ring, ring.head);
+    if (UploadRingAllocate(&ring, 0, 16, &offset) || UploadRingAllocate(&ring, 4097, 16, &offset)) {
+        SDL_Log("FAIL: ring accepted an empty or oversized allocation");
+        return false;
+    }
+    if (!UploadRingAllocate(&ring, 4096, 512, &offset) || offset != 0 || GetUploadRingUsed(&ring) != 4096) {
+        SDL_Log("FAIL: an empty ring could not hand out its whole capacity");
+        return false;
+    }
+    return true;
+}
+
+typedef struct LiveRegion
+{
+    Uint32 offset;
+    Uint32 size;
+    Uint64 end;
+} LiveRegion;
+
+// Random sizes and alignments, releasing the oldest allocation whenever the
+// ring is full. With check set, every byte's owner is tracked and a region
+// handed out twice fails the run.
+static bool RunRing(Uint32 allocations, bool check, Uint64 *checksum)
+{
+    LiveRegion *live = static_cast<LiveRegion*>(SDL_malloc(BENCH_RING_LIVE * sizeof(LiveRegion)));
+    Uint8 *used = check ? static_cast<Uint8*>(SDL_calloc(1, BENCH_RING_BYTES)) : NULL;
+    if (live == NULL || (check && used == NULL)) {
+        SDL_free(live);
+        SDL_free(used);
+        return false;
+    }
+
+    UploadRing ring;
+    InitUploadRing(&ring, BENCH_RING_BYTES);
+    Uint32 first = 0, count = 0;
+    Uint32 seed = 1;
+    bool ok = true;
+    for (Uint32 i = 0; i < allocations && ok; i++) {
+        Uint32 random = NextRandom(&seed);
+        Uint32 size = 1 + random % 8192;
+        Uint32 alignment = random & 0x10000 ? 512 : 16;
+        Uint32 offset;
+        while (!UploadRingAllocate(&ring, size, alignment, &offset)) {
+            if (count == 0) {
+                SDL_Log("FAIL: empty ring refused %u bytes", size);
+                ok = false;
+                break;
+            }
+            const LiveRegion *oldest = &live[first];
+            UploadRingRelease(&ring, oldest->end);
+            if (check) {
+                SDL_memset(used + oldest->offset, 0, oldest->size);
+            }
+            first = (first + 1) % BENCH_RING_LIVE;
+            count--;
+        }
+        if (!ok) {
+            break;
+        }
+        if (check) {
+            if (offset % alignment != 0 || offset + size > BENCH_RING_BYTES || count == BENCH_RING_LIVE) {
+                SDL_Log("FAIL: allocation %u of %u bytes at %u is misaligned or out of range", i, size, offset);
+                ok = false;
+                break;
+            }
+            for (Uint32 b = 0; b < size; b++) {
+                if (used[offset + b]) {
+                    SDL_Log("FAIL: allocation %u at %u overlaps a live region", i, offset);
+                    ok = false;
+                    break;
+                }
+                used[offset + b] = 1;
+            }
+        }
+        LiveRegion *region = &live[(first + count++) % BENCH_RING_LIVE];
+        region->offset = offset;
+        region->size = size;
+        region->end = ring.head;
+        *checksum += offset;
+    }
+    SDL_free(live);
+    SDL_free(used);
+    return ok;
+}
+
+static bool CheckManager(void)
+{
+    int released = 0;
+    Uint8 data[48 * 1024] = {};
+    SDL_GPUBuffer *buffer = reinterpret_cast<SDL_GPUBuffer*>(16);
+    SDL_GPUTextureRegion region = {};
+    region.texture = reinterpret_cast<SDL_GPUTexture*>(32);
+
+    UploadManager *manager = CreateUploadManager(NULL, BENCH_RING_BYTES, 16 * 1024);
+    if (manager == NULL) {
+        return false;
+    }
+    bool ok = true;
+
+    // A buffer upload over the budget is split across frames and released once, when it's all staged
+    UploadTicket split = QueueBufferUpload(manager, data, 40 * 1024, buffer, 0, CountRelease, &released);
+    Uint64 frame_bytes[3];
+    for (int frame = 0; frame < 3; frame++) {
+        FlushUploads(manager);
+        frame_bytes[frame] = GetUploadManagerStats(manager).bytes_last_frame;
+        if (frame < 2 && (IsUploadStaged(manager, split) || released != 0)) {
+            SDL_Log("FAIL: split upload staged after %d frames", frame + 1);
+            ok = false;
+        }
+    }
+    if (ok && (frame_bytes[0] != 16 * 1024 || frame_bytes[1] != 16 * 1024 || frame_bytes[2] != 8 * 1024 ||
+               !IsUploadComplete(manager, split) || released != 1)) {
+        SDL_Log("FAIL: split upload went out as %u/%u/%u bytes with %d releases",
+                (unsigned)frame_bytes[0], (unsigned)frame_bytes[1], (unsigned)frame_bytes[2], released);
+        ok = false;
+    }
+
+    // A texture can't be split: over the budget it waits for a frame of its own
+    UploadTicket small = QueueBufferUpload(manager, data, 4096, buffer, 0, CountRelease, &released);
+    UploadTicket texture = QueueTextureUpload(manager, data, 32 * 1024, &region, 0, 0, CountRelease, &released);
+    FlushUploads(manager);
+    UploadManagerStats stats = GetUploadManagerStats(manager);
+    if (ok && (!IsUploadStaged(manager, small) || IsUploadStaged(manager, texture) || stats.bytes_last_frame != 4096)) {
+        SDL_Log("FAIL: texture over the budget shared a frame (%u bytes staged)", (unsigned)stats.bytes_last_frame);
+        ok = false;
+    }
+    FlushUploads(manager);
+    stats = GetUploadManagerStats(manager);
+    if (ok && (!IsUploadComplete(manager, texture) || stats.bytes_last_frame != 32 * 1024 || released != 3)) {
+        SDL_Log("FAIL: texture over the budget did not go whole in the next frame");
+        ok = false;
+    }
+
+    // Empty and oversized uploads are refused and released at once, and nothing behind them stalls
+    int refused = 0;
+    if (ok && (QueueBufferUpload(manager, data, 0, buffer, 0, CountRelease, &refused) != 0 ||
+               QueueTextureUpload(manager, data, 0, &region, 0, 0, CountRelease, &refused) != 0 ||
+               QueueTextureUpload(manager, data, BENCH_RING_BYTES + 1, &region, 0, 0, CountRelease, &refused) != 0 ||
+               refused != 3)) {
+        SDL_Log("FAIL: empty or oversized uploads were queued (%d released)", refused);
+        ok = false;
+    }
+    UploadTicket after = QueueBufferUpload(manager, data, 256, buffer, 0, CountRelease, &released);
+    FlushUploads(manager);
+    stats = GetUploadManagerStats(manager);
+    if (ok && (!IsUploadComplete(manager, after) || stats.pending_uploads != 0 || stats.pending_bytes != 0)) {
+        SDL_Log("FAIL: upload after a refused one is stuck (%u pending)", stats.pending_uploads);
+        ok = false;
+    }
+    DestroyUploadManager(manager);
+
+    // A ring smaller than a frame's work stalls until the next flush, whatever the budget
+    manager = CreateUploadManager(NULL, 8192, 0);
+    if (manager == NULL) {
+        return false;
+    }
+    UploadTicket first = QueueTextureUpload(manager, data, 6000, &region, 0, 0, CountRelease, &released);
+    UploadTicket second = QueueTextureUpload(manager, data, 6000, &region, 0, 0, CountRelease, &released);
+    UploadTicket large = QueueBufferUpload(manager, data, 20000, buffer, 0, CountRelease, &released);
+    Uint32 flushes = 0;
+    while (GetUploadManagerStats(manager).pending_uploads > 0 && flushes < 10) {
+        FlushUploads(manager);
+        stats = GetUploadManagerStats(manager);
+        if (ok && (stats.ring_high_water > 8192 || stats.bytes_last_frame > 8192)) {
+            SDL_Log("FAIL: a flush staged %u bytes into an 8192 byte ring", (unsigned)stats.bytes_last_frame);
+            ok = false;
+        }
+        flushes++;
+    }
+    // 6000 | 6000 | 8192 | 8192 | 3616: each texture waits for the other's region, the buffer for an empty ring
+    if (ok && (flushes != 5 || !IsUploadComplete(manager, first) || !IsUploadComplete(manager, second) ||
+               !IsUploadComplete(manager, large) || released != 7)) {
+        SDL_Log("FAIL: full ring took %u flushes, %d releases", flushes, released);
+        ok = false;
+    }
+
+    // Destroying the manager releases what is still queued
+    QueueBufferUpload(manager, data, 100, buffer, 0, CountRelease, &released);
+    DestroyUploadManager(manager);
+    if (ok && released != 8) {
+        SDL_Log("FAIL: queued upload was not released on destroy");
+        ok = false;
+    }
+    return ok;
+}
+
+// A texture's mips go all or nothing: a bad region anywhere queues none of
+// them and releases the data once, and a good set releases it once, after the last.
+static bool CheckTextureGroups(void)
+{
+    static Uint8 data[32 * 1024];
+    SDL_GPUTextureRegion destination = {};
+    destination.texture = reinterpret_cast<SDL_GPUTexture*>(32);
+    TextureUploadRegion regions[3];
+    for (Uint32 i = 0; i < 3; i++) {
+        regions[i].offset = i * 8192;
+        regions[i].size = 8192;
+        regions[i].destination = destination;
+        regions[i].destination.mip_level = i;
+    }
+
+    UploadManager *manager = CreateUploadManager(NULL, 16 * 1024, 10 * 1024);
+    if (manager == NULL) {
+        return false;
+    }
+    bool ok = true;
+    const Uint32 bad_sizes[] = { 16 * 1024 + 1, 0 };
+    for (Uint32 bad = 0; bad < 3 && ok; bad++) {
+        for (Uint32 size : bad_sizes) {
+            TextureUploadRegion broken[3];
+            SDL_memcpy(broken, regions, sizeof(broken));
+            broken[bad].size = size;
+            ReleaseRecord record = {};
+            UploadTicket ticket = QueueTextureUploads(manager, data, broken, 3, RecordRelease, &record);
+            FlushUploads(manager);
+            UploadManagerStats stats = GetUploadManagerStats(manager);
+            if (ticket != 0 || record.count != 1 || record.data != data || stats.pending_uploads != 0 || stats.copies_last_frame != 0) {
+                SDL_Log("FAIL: %u byte region %u of 3 queued %u uploads, released %d times",
+                        size, bad, stats.pending_uploads + stats.copies_last_frame, record.count);
+                ok = false;
+                break;
+            }
+        }
+    }
+    ReleaseRecord record = {};
+    if (ok && (QueueTextureUploads(manager, data, regions, 0, RecordRelease, &record) != 0 || record.count != 1)) {
+        SDL_Log("FAIL: an empty set of regions was queued");
+        ok = false;
+    }
+
+    // Over the budget, one mip goes out per frame; the data is held until the last
+    record = {};
+    UploadTicket ticket = QueueTextureUploads(manager, data, regions, 3, RecordRelease, &record);
+    for (Uint32 frame = 0; frame < 3 && ok; frame++) {
+        FlushUploads(manager);
+        UploadManagerStats stats = GetUploadManagerStats(manager);
+        bool last = frame == 2;
+        if (ticket == 0 || stats.copies_last_frame != 1 || IsUploadComplete(manager, ticket) != last || record.count != (last ? 1 : 0)) {
+            SDL_Log("FAIL: mip %u of 3 staged with %u copies, %d releases", frame, stats.copies_last_frame, record.count);
+            ok = false;
+        }
+    }
+    if (ok && record.data != data) {
+        SDL_Log("FAIL: release was not given the start of the data");
+        ok = false;
+    }
+    DestroyUploadManager(manager);
+    return ok;
+}
+
+int BenchUpload(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    Uint64 checksum = 0;
+    if (!CheckRing() || !RunRing(BENCH_RING_ALLOCATIONS / 10, true, &checksum) || !CheckManager() || !CheckTextureGroups()) {
+        return 1;
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    RunRing(BENCH_RING_ALLOCATIONS, false, &checksum);
+    double ring_ms = BenchElapsedMS(start);
+
+    Uint8 *data = static_cast<Uint8*>(SDL_malloc(BENCH_UPLOADS_PER_FRAME * BENCH_UPLOAD_BYTES));
+    UploadManager *manager = CreateUploadManager(NULL, 4 * 1024 * 1024, 0);
+    if (data == NULL || manager == NULL) {
+        SDL_free(data);
+        DestroyUploadManager(manager);
+        return 1;
+    }
+    SDL_memset(data, 0x5a, BENCH_UPLOADS_PER_FRAME * BENCH_UPLOAD_BYTES);
+    SDL_GPUBuffer *buffer = reinterpret_cast<SDL_GPUBuffer*>(16);
+    UploadTicket last = 0;
+    start = SDL_GetTicksNS();
+    for (Uint32 frame = 0; frame < BENCH_UPLOAD_FRAMES; frame++) {
+        for (Uint32 i = 0; i < BENCH_UPLOADS_PER_FRAME; i++) {
+            last = QueueBufferUpload(manager, data + i * BENCH_UPLOAD_BYTES, BENCH_UPLOAD_BYTES, buffer,
+                                     i * BENCH_UPLOAD_BYTES, NULL, NULL);
+        }
+        FlushUploads(manager);
+    }
+    double upload_ms = BenchElapsedMS(start);
+    UploadManagerStats stats = GetUploadManagerStats(manager);
+    bool complete = IsUploadComplete(manager, last);
+    DestroyUploadManager(manager);
+    SDL_free(data);
+    if (!complete || stats.pending_uploads != 0) {
+        SDL_Log("FAIL: %u uploads still pending after the last flush", stats.pending_uploads);
+        return 1;
+    }
+
+    Uint32 uploads = BENCH_UPLOAD_FRAMES * BENCH_UPLOADS_PER_FRAME;
+    SDL_Log("%d ring allocations of 1-8192 bytes into %d KB (checksum %llu)",
+            BENCH_RING_ALLOCATIONS, BENCH_RING_BYTES / 1024, (unsigned long long)checksum);
+    SDL_Log("  ring allocate  %8.2f ms  %6.1f ns/allocation", ring_ms, ring_ms * 1e6 / BENCH_RING_ALLOCATIONS);
+    SDL_Log("  stage uploads  %8.2f ms  %6.1f ns/upload of %d bytes, %.2f GB/s",
+            upload_ms, upload_ms * 1e6 / uploads, BENCH_UPLOAD_BYTES,
+            (double)uploads * BENCH_UPLOAD_BYTES / (upload_ms * 1e6));
+    return 0;
+}
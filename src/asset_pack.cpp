@@ -0,0 +1,381 @@
+#include <SDL3/SDL.h>
+#include <asset_pack.hpp>
+#include <mesh.hpp>
+#include <profiler.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct AssetPack
+{
+    const Uint8 *data;
+    Uint64 size;
+    const AssetPackHeader *header;
+    const AssetPackEntry *entries;
+    const char *names;
+};
+
+static const Uint8* MapAssetFile(const char *path, Uint64 *size)
+{
+    *size = 0;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER file_size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return NULL;
+    }
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) {
+        return NULL;
+    }
+    *size = (Uint64)file_size.QuadPart;
+    return static_cast<const Uint8*>(data);
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    *size = (Uint64)info.st_size;
+    return static_cast<const Uint8*>(data);
+#endif
+}
+
+static void UnmapAssetFile(const Uint8 *data, Uint64 size)
+{
+    if (data == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<Uint8*>(data), (size_t)size);
+#endif
+}
+
+static bool IsRangeInside(Uint64 offset, Uint64 size, Uint64 limit)
+{
+    return offset <= limit && size <= limit - offset;
+}
+
+// Everything the getters hand out has to lie inside the entry, and the entry inside the file.
+static bool IsPackedAssetValid(const Uint8 *data, const AssetPackHeader *header, const AssetPackEntry *entry)
+{
+    // The name has to end before the file does.
+    Uint64 names_size = header->file_size - header->names_offset;
+    if (entry->name_offset >= names_size) {
+        return false;
+    }
+    const char *name = reinterpret_cast<const char*>(data + header->names_offset + entry->name_offset);
+    size_t name_limit = (size_t)(names_size - entry->name_offset);
+    if (SDL_strnlen(name, name_limit) == name_limit) {
+        return false;
+    }
+    if (entry->offset % ASSET_PACK_ALIGNMENT != 0 || !IsRangeInside(entry->offset, entry->size, header->toc_offset)) {
+        return false;
+    }
+
+    const Uint8 *payload = data + entry->offset;
+    switch (entry->type) {
+    case ASSET_PACK_TYPE_IMAGE: {
+        const AssetPackImage *image = reinterpret_cast<const AssetPackImage*>(payload);
+        if (entry->size < sizeof(AssetPackImage) || image->num_mips == 0 || image->num_mips > ASSET_PACK_MAX_MIPS) {
+            return false;
+        }
+        for (Uint32 mip = 0; mip < image->num_mips; mip++) {
+            if (!IsRangeInside(image->mip_offsets[mip], image->mip_sizes[mip], entry->size)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case ASSET_PACK_TYPE_SHADER: {
+        const AssetPackShader *shader = reinterpret_cast<const AssetPackShader*>(payload);
+        if (entry->size < sizeof(AssetPackShader) || shader->num_formats > ASSET_PACK_MAX_SHADER_FORMATS) {
+            return false;
+        }
+        for (Uint32 i = 0; i < shader->num_formats; i++) {
+            const AssetPackShaderCode *code = &shader->code[i];
+            if (!IsRangeInside(code->offset, code->size, entry->size) ||
+                SDL_strnlen(code->entry_point, sizeof(code->entry_point)) == sizeof(code->entry_point)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case ASSET_PACK_TYPE_MESH: {
+        // The vertex input is fixed to PackedMeshVertex, and every index has to
+        // name a vertex, or the GPU would fetch past the vertex buffer.
+        const AssetPackMesh *mesh = reinterpret_cast<const AssetPackMesh*>(payload);
+        if (entry->size < sizeof(AssetPackMesh) || mesh->vertex_stride != sizeof(PackedMeshVertex) ||
+            (mesh->index_size != sizeof(Uint16) && mesh->index_size != sizeof(Uint32)) || mesh->num_indices % 3 != 0 ||
+            mesh->vertices_offset % alignof(PackedMeshVertex) != 0 || mesh->indices_offset % mesh->index_size != 0 ||
+            !IsRangeInside(mesh->vertices_offset, (Uint64)mesh->num_vertices * mesh->vertex_stride, entry->size) ||
+            !IsRangeInside(mesh->indices_offset, (Uint64)mesh->num_indices * mesh->index_size, entry->size)) {
+            return false;
+        }
+        const Uint8 *indices = payload + mesh->indices_offset;
+        for (Uint32 i = 0; i < mesh->num_indices; i++) {
+            Uint32 index = mesh->index_size == sizeof(Uint16) ? reinterpret_cast<const Uint16*>(indices)[i] :
+                                                                reinterpret_cast<const Uint32*>(indices)[i];
+            if (index >= mesh->num_vertices) {
+                return false;
+            }
+        }
+        return true;
+    }
+    default:
+        // Lookups are by type, so entries of an unknown type are never handed out.
+        return true;
+    }
+}
+
+AssetPack* OpenAssetPack(const char *pack_file_name)
+{
+    char full_path[256];
+    SDL_snprintf(full_path, sizeof(full_path), "%s../%s", SDL_GetBasePath(), pack_file_name);
+    return OpenAssetPackFromPath(full_path);
+}
+
+AssetPack* OpenAssetPackFromPath(const char *full_path)
+{
+    PROFILE_FUNCTION();
+    Uint64 size;
+    const Uint8 *data = MapAssetFile(full_path, &size);
+    if (data == NULL) {
+        SDL_Log("Failed to map asset pack: %s", full_path);
+        return NULL;
+    }
+
+    // Validate the header, the table and every entry once so lookups and getters never have to.
+    const AssetPackHeader *header = reinterpret_cast<const AssetPackHeader*>(data);
+    if (size < sizeof(AssetPackHeader) ||
+        header->magic != ASSET_PACK_MAGIC ||
+        header->version != ASSET_PACK_VERSION ||
+        header->file_size != size ||
+        header->toc_offset % alignof(AssetPackEntry) != 0 ||
+        header->names_offset > size ||
+        !IsRangeInside(header->toc_offset, (Uint64)header->num_entries * sizeof(AssetPackEntry), header->names_offset)) {
+        SDL_Log("Invalid or outdated asset pack: %s", full_path);
+        UnmapAssetFile(data, size);
+        return NULL;
+    }
+    const AssetPackEntry *entries = reinterpret_cast<const AssetPackEntry*>(data + header->toc_offset);
+    for (Uint32 i = 0; i < header->num_entries; i++) {
+        if (!IsPackedAssetValid(data, header, &entries[i])) {
+            SDL_Log("Asset pack entry %u is out of bounds or malformed: %s", i, full_path);
+            UnmapAssetFile(data, size);
+            return NULL;
+        }
+    }
+
+    AssetPack *pack = static_cast<AssetPack*>(SDL_malloc(sizeof(AssetPack)));
+    if (pack == NULL) {
+        UnmapAssetFile(data, size);
+        return NULL;
+    }
+    pack->data = data;
+    pack->size = size;
+    pack->header = header;
+    pack->entries = entries;
+    pack->names = reinterpret_cast<const char*>(data + header->names_offset);
+    return pack;
+}
+
+void CloseAssetPack(AssetPack *pack)
+{
+    if (pack == NULL) {
+        return;
+    }
+    UnmapAssetFile(pack->data, pack->size);
+    SDL_free(pack);
+}
+
+const void* FindPackedAsset(const AssetPack *pack, const char *name, AssetPackType type, Uint64 *size)
+{
+    Uint32 low = 0;
+    Uint32 high = pack->header->num_entries;
+    while (low < high) {
+        Uint32 middle = low + (high - low) / 2;
+        const AssetPackEntry *entry = &pack->entries[middle];
+        int order = SDL_strcmp(pack->names + entry->name_offset, name);
+        if (order == 0) {
+            if (entry->type != (Uint32)type) {
+                break;
+            }
+            if (size != NULL) {
+                *size = entry->size;
+            }
+            return pack->data + entry->offset;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+const AssetPackImage* GetPackedImage(const AssetPack *pack, const char *image_file_name)
+{
+    return static_cast<const AssetPackImage*>(FindPackedAsset(pack, image_file_name, ASSET_PACK_TYPE_IMAGE, NULL));
+}
+
+const void* GetPackedImageMip(const AssetPackImage *image, Uint32 mip, Uint32 *size)
+{
+    if (mip >= image->num_mips) {
+        return NULL;
+    }
+    if (size != NULL) {
+        *size = image->mip_sizes[mip];
+    }
+    return reinterpret_cast<const Uint8*>(image) + image->mip_offsets[mip];
+}
+
+const AssetPackMesh* GetPackedMesh(const AssetPack *pack, const char *mesh_file_name)
+{
+    return static_cast<const AssetPackMesh*>(FindPackedAsset(pack, mesh_file_name, ASSET_PACK_TYPE_MESH, NULL));
+}
+
+const void* GetPackedMeshVertices(const AssetPackMesh *mesh)
+{
+    return reinterpret_cast<const Uint8*>(mesh) + mesh->vertices_offset;
+}
+
+const void* GetPackedMeshIndices(const AssetPackMesh *mesh)
+{
+    return reinterpret_cast<const Uint8*>(mesh) + mesh->indices_offset;
+}
+
+// Picks the stored bytecode in the same preference order as LoadShader.
+static const AssetPackShaderCode* SelectShaderCode(SDL_GPUDevice *gpu_device, const AssetPackShader *shader)
+{
+    static const SDL_GPUShaderFormat preferred_formats[] = {
+        SDL_GPU_SHADERFORMAT_DXIL,
+        SDL_GPU_SHADERFORMAT_MSL,
+        SDL_GPU_SHADERFORMAT_SPIRV,
+    };
+
+    SDL_GPUShaderFormat backend_formats = SDL_GetGPUShaderFormats(gpu_device);
+    for (Uint32 i = 0; i < SDL_arraysize(preferred_formats); i++) {
+        if (!(backend_formats & preferred_formats[i])) {
+            continue;
+        }
+        for (Uint32 j = 0; j < shader->num_formats; j++) {
+            if (shader->code[j].format == preferred_formats[i]) {
+                return &shader->code[j];
+            }
+        }
+    }
+    return NULL;
+}
+
+SDL_GPUShader* LoadPackedShader(SDL_GPUDevice *gpu_device, const AssetPack *pack, const char *shader_filename)
+{
+    PROFILE_FUNCTION();
+    const AssetPackShader *packed = static_cast<const AssetPackShader*>(FindPackedAsset(pack, shader_filename, ASSET_PACK_TYPE_SHADER, NULL));
+    if (packed == NULL) {
+        SDL_Log("Shader not in asset pack: %s", shader_filename);
+        return NULL;
+    }
+
+    SDL_GPUShaderStage stage;
+    if (SDL_strstr(shader_filename, ".vert")) {
+        stage = SDL_GPU_SHADERSTAGE_VERTEX;
+    } else if (SDL_strstr(shader_filename, ".frag")) {
+        stage = SDL_GPU_SHADERSTAGE_FRAGMENT;
+    } else {
+        SDL_Log("Invalid shader stage!");
+        return NULL;
+    }
+
+    const AssetPackShaderCode *code = SelectShaderCode(gpu_device, packed);
+    if (code == NULL) {
+        SDL_Log("%s", "Unrecognized backend shader format!");
+        return NULL;
+    }
+
+    SDL_GPUShaderCreateInfo shader_info = {
+        .code_size = code->size,
+        .code = reinterpret_cast<const Uint8*>(packed) + code->offset,
+        .entrypoint = code->entry_point,
+        .format = code->format,
+        .stage = stage,
+        .num_samplers = packed->num_samplers,
+        .num_storage_textures = packed->num_storage_textures,
+        .num_storage_buffers = packed->num_storage_buffers,
+        .num_uniform_buffers = packed->num_uniform_buffers
+    };
+
+    SDL_GPUShader *shader = SDL_CreateGPUShader(gpu_device, &shader_info);
+    if (shader == NULL) {
+        SDL_Log("Failed to create shader! %s", SDL_GetError());
+    }
+    return shader;
+}
+
+SDL_GPUComputePipeline* LoadPackedComputePipeline(SDL_GPUDevice *gpu_device, const AssetPack *pack, const char *shader_filename)
+{
+    const AssetPackShader *packed = static_cast<const AssetPackShader*>(FindPackedAsset(pack, shader_filename, ASSET_PACK_TYPE_SHADER, NULL));
+    if (packed == NULL) {
+        SDL_Log("Shader not in asset pack: %s", shader_filename);
+        return NULL;
+    }
+    if (SDL_strstr(shader_filename, ".comp") == NULL) {
+        SDL_Log("%s is not a compute shader", shader_filename);
+        return NULL;
+    }
+
+    const AssetPackShaderCode *code = SelectShaderCode(gpu_device, packed);
+    if (code == NULL) {
+        SDL_Log("%s", "Unrecognized backend shader format!");
+        return NULL;
+    }
+
+    SDL_GPUComputePipelineCreateInfo pipeline_info = {
+        .code_size = code->size,
+        .code = reinterpret_cast<const Uint8*>(packed) + code->offset,
+        .entrypoint = code->entry_point,
+        .format = code->format,
+        .num_samplers = packed->num_samplers,
+        .num_readonly_storage_textures = packed->num_readonly_storage_textures,
+        .num_readonly_storage_buffers = packed->num_readonly_storage_buffers,
+        .num_readwrite_storage_textures = packed->num_readwrite_storage_textures,
+        .num_readwrite_storage_buffers = packed->num_readwrite_storage_buffers,
+        .num_uniform_buffers = packed->num_uniform_buffers,
+        .threadcount_x = packed->threadcount_x,
+        .threadcount_y = packed->threadcount_y,
+        .threadcount_z = packed->threadcount_z
+    };
+
+    SDL_GPUComputePipeline *pipeline = SDL_CreateGPUComputePipeline(gpu_device, &pipeline_info);
+    if (pipeline == NULL) {
+        SDL_Log("Failed to create compute pipeline! %s", SDL_GetError());
+    }
+    return pipeline;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Single-file asset pack produced offline by the cook target (tools/cook.cpp).
+// The runtime maps the whole file and hands out pointers straight into it:
+// images are stored as GPU-ready R8G8B8A8 mip chains, shaders as precompiled
+// bytecode for every backend together with their resource counts, and meshes
+// as optimized, quantized vertex and index buffers (see mesh.hpp).
+//
+// Layout: AssetPackHeader, payloads (each ASSET_PACK_ALIGNMENT aligned), the
+// table of contents sorted by name, then the NUL-terminated name strings.
+// Opening a pack checks every entry against that layout (names, payload
+// bounds, the offsets inside each payload and mesh indices), so a truncated
+// or corrupt pack fails to open instead of handing out pointers past the
+// mapping or index buffers that reach past their vertices.
+// Asset names are the same strings the loose loaders take, e.g.
+// "assets/Images/ravioli.bmp", "assets/Shaders/SolidColor.frag" or
+// "assets/Meshes/cube.obj".
+
+#define ASSET_PACK_MAGIC 0x4B415041   // "APAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 64
+#define ASSET_PACK_MAX_MIPS 16
+#define ASSET_PACK_MAX_SHADER_FORMATS 3
+
+typedef enum AssetPackType
+{
+    ASSET_PACK_TYPE_IMAGE = 1,
+    ASSET_PACK_TYPE_SHADER = 2,
+    ASSET_PACK_TYPE_MESH = 3,
+} AssetPackType;
+
+typedef struct AssetPackHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 num_entries;
+    Uint32 reserved;
+    Uint64 toc_offset;
+    Uint64 names_offset;
+    Uint64 file_size;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry
+{
+    Uint32 name_offset;     // Relative to names_offset
+    Uint32 type;            // AssetPackType
+    Uint64 offset;          // Relative to the start of the pack
+    Uint64 size;
+} AssetPackEntry;
+
+typedef struct AssetPackImage
+{
+    Uint32 width;
+    Uint32 height;
+    Uint32 num_mips;
+    Uint32 format;                              // SDL_GPUTextureFormat
+    Uint32 mip_offsets[ASSET_PACK_MAX_MIPS];    // Relative to this struct
+    Uint32 mip_sizes[ASSET_PACK_MAX_MIPS];
+} AssetPackImage;
+
+// PackedMeshVertex vertices; position = position_offset + position_scale * snorm.
+typedef struct AssetPackMesh
+{
+    Uint32 num_vertices;
+    Uint32 num_indices;
+    Uint32 index_size;                          // 2 or 4 bytes
+    Uint32 vertex_stride;
+    Uint32 vertices_offset;                     // Relative to this struct
+    Uint32 indices_offset;
+    float position_offset[3];
+    float position_scale[3];
+} AssetPackMesh;
+
+typedef struct AssetPackShaderCode
+{
+    Uint32 format;          // SDL_GPUShaderFormat
+    Uint32 offset;          // Relative to the owning AssetPackShader
+    Uint32 size;
+    char entry_point[12];
+} AssetPackShaderCode;
+
+typedef struct AssetPackShader
+{
+    Uint32 stage;           // SDL_ShaderCross_ShaderStage
+    Uint32 num_samplers;
+    Uint32 num_uniform_buffers;
+    Uint32 num_storage_textures;            // Graphics stages
+    Uint32 num_storage_buffers;
+    Uint32 num_readonly_storage_textures;   // Compute stage
+    Uint32 num_readonly_storage_buffers;
+    Uint32 num_readwrite_storage_textures;
+    Uint32 num_readwrite_storage_buffers;
+    Uint32 threadcount_x;
+    Uint32 threadcount_y;
+    Uint32 threadcount_z;
+    Uint32 num_formats;
+    AssetPackShaderCode code[ASSET_PACK_MAX_SHADER_FORMATS];
+} AssetPackShader;
+
+typedef struct AssetPack AssetPack;
+
+// pack_file_name is relative to the assets root, like LoadImage.
+AssetPack* OpenAssetPack(const char *pack_file_name);
+AssetPack* OpenAssetPackFromPath(const char *full_path);
+void CloseAssetPack(AssetPack *pack);
+
+// Binary search over the table of contents. The returned pointer stays valid
+// until CloseAssetPack.
+const void* FindPackedAsset(const AssetPack *pack, const char *name, AssetPackType type, Uint64 *size);
+
+const AssetPackImage* GetPackedImage(const AssetPack *pack, const char *image_file_name);
+const void* GetPackedImageMip(const AssetPackImage *image, Uint32 mip, Uint32 *size);
+
+const AssetPackMesh* GetPackedMesh(const AssetPack *pack, const char *mesh_file_name);
+const void* GetPackedMeshVertices(const AssetPackMesh *mesh);
+const void* GetPackedMeshIndices(const AssetPackMesh *mesh);
+
+// Creates the shader from the bytecode matching the device's backend; nothing
+// is compiled or reflected at runtime.
+SDL_GPUShader* LoadPackedShader(SDL_GPUDevice *gpu_device, const AssetPack *pack, const char *shader_filename);
+SDL_GPUComputePipeline* LoadPackedComputePipeline(SDL_GPUDevice *gpu_device, const AssetPack *pack, const char *shader_filename);
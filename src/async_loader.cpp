@@ -0,0 +1,607 @@
+#include <SDL3/SDL.h>
+#include <async_loader.hpp>
+#include <compressed_texture.hpp>
+#include <graphics.hpp>
+#include <hdr_image.hpp>
+#include <jobs.hpp>
+#include <mipmap.hpp>
+#include <profiler.hpp>
+
+#define MAX_ASSET_NAME 256
+
+typedef struct AssetCallback
+{
+    AssetLoadedCallback fn;
+    void *userdata;
+} AssetCallback;
+
+typedef struct AsyncAsset AsyncAsset;
+struct AsyncAsset
+{
+    char name[MAX_ASSET_NAME];
+    bool texture;               // GPU texture, otherwise a CPU surface
+    bool srgb;
+    SDL_AtomicInt state;        // AssetState; load jobs move QUEUED -> LOADING
+
+    // Main thread only
+    int refs;
+    AssetPriority priority;
+    SDL_GPUTexture *gpu_texture;
+    SDL_Surface *image;
+    UploadTicket ticket;
+    AssetCallback *callbacks;
+    Uint32 num_callbacks;
+    Uint32 callback_capacity;
+
+    // Pending queue links, guarded by the queue mutex
+    AsyncAsset *queue_prev;
+    AsyncAsset *queue_next;
+
+    // Written by the load job before the asset is pushed onto the completion queue
+    bool succeeded;
+    SDL_Surface *decoded_surface;
+    MipChain mips;
+    void *file_data;
+    CompressedImage compressed;
+    HDRImage hdr;
+    AsyncAsset *completed_next;
+};
+
+struct AsyncLoader
+{
+    SDL_GPUDevice *gpu_device;
+    UploadManager *upload_manager;
+
+    // One job is submitted per queued asset and counted here.
+    JobSystem *jobs;
+    JobCounter counter;
+
+    // One FIFO per priority; a load job always takes from the highest non-empty one.
+    SDL_Mutex *queue_mutex;
+    AsyncAsset *queue_head[ASSET_PRIORITY_COUNT];
+    AsyncAsset *queue_tail[ASSET_PRIORITY_COUNT];
+    bool quit;
+
+    // Lock-free stack of finished loads: load jobs push, the main thread takes
+    // the whole list at once, so there is no ABA to worry about.
+    void *completed;
+
+    AsyncAsset **assets;        // Slot i is handle i + 1; one slot per distinct request
+    Uint32 num_assets;
+    Uint32 asset_capacity;
+    Uint32 num_uploading;
+    Uint32 deduplicated;
+};
+
+static void LinkQueued(AsyncLoader *loader, AsyncAsset *asset)
+{
+    AssetPriority priority = asset->priority;
+    asset->queue_next = NULL;
+    asset->queue_prev = loader->queue_tail[priority];
+    if (loader->queue_tail[priority] != NULL) {
+        loader->queue_tail[priority]->queue_next = asset;
+    } else {
+        loader->queue_head[priority] = asset;
+    }
+    loader->queue_tail[priority] = asset;
+}
+
+static void UnlinkQueued(AsyncLoader *loader, AsyncAsset *asset)
+{
+    AssetPriority priority = asset->priority;
+    if (asset->queue_prev != NULL) {
+        asset->queue_prev->queue_next = asset->queue_next;
+    } else {
+        loader->queue_head[priority] = asset->queue_next;
+    }
+    if (asset->queue_next != NULL) {
+        asset->queue_next->queue_prev = asset->queue_prev;
+    } else {
+        loader->queue_tail[priority] = asset->queue_prev;
+    }
+    asset->queue_prev = NULL;
+    asset->queue_next = NULL;
+}
+
+static void DecodeAsset(JobSystem *jobs, AsyncAsset *asset)
+{
+    PROFILE_FUNCTION();
+    if (!asset->texture || SDL_strstr(asset->name, ".bmp")) {
+        asset->decoded_surface = LoadImage(asset->name, 4);
+        asset->succeeded = asset->decoded_surface != NULL;
+        if (asset->succeeded && asset->texture) {
+            // Textures get their full mip chain here, off the main thread; the surface isn't needed after that.
+            SDL_Surface *surface = asset->decoded_surface;
+            asset->succeeded = GenerateMipChain(surface->pixels, (Uint32)surface->w, (Uint32)surface->h, (Uint32)surface->pitch,
+                                                asset->srgb, MIP_FILTER_BOX, 0, jobs, &asset->mips);
+            SDL_DestroySurface(surface);
+            asset->decoded_surface = NULL;
+        }
+        return;
+    }
+
+    char full_path[256];
+    SDL_snprintf(full_path, sizeof(full_path), "%s../%s", SDL_GetBasePath(), asset->name);
+
+    size_t file_size;
+    asset->file_data = SDL_LoadFile(full_path, &file_size);
+    if (asset->file_data == NULL) {
+        SDL_Log("Failed to load texture: %s", full_path);
+        return;
+    }
+
+    if (SDL_strstr(asset->name, ".hdr")) {
+        // Expanded to half floats here; the file itself isn't needed after that.
+        asset->succeeded = DecodeHDR(asset->file_data, file_size, HDR_PIXELFORMAT_RGBA16F, jobs, &asset->hdr);
+        if (asset->succeeded) {
+            SDL_free(asset->file_data);
+            asset->file_data = NULL;
+            return;
+        }
+    } else if (SDL_strstr(asset->name, ".dds")) {
+        asset->succeeded = ParseDDS(asset->file_data, file_size, &asset->compressed);
+    } else if (SDL_strstr(asset->name, ".astc")) {
+        asset->succeeded = ParseASTC(asset->file_data, file_size, asset->srgb, &asset->compressed);
+    } else {
+        asset->succeeded = SDL_SetError("No decoder for this file type");
+    }
+    if (!asset->succeeded) {
+        SDL_Log("Failed to parse %s: %s", full_path, SDL_GetError());
+        SDL_free(asset->file_data);
+        asset->file_data = NULL;
+    }
+}
+
+static void PushCompleted(AsyncLoader *loader, AsyncAsset *asset)
+{
+    void *head;
+    do {
+        head = SDL_GetAtomicPointer(&loader->completed);
+        asset->completed_next = static_cast<AsyncAsset*>(head);
+    } while (!SDL_CompareAndSwapAtomicPointer(&loader->completed, head, asset));
+}
+
+// Takes whichever queued asset is most urgent now rather than the one that was
+// queued with it, so reprioritising and releasing still work; a job that finds
+// the queue empty (its asset was released) does nothing.
+static void RunAssetLoadJob(void *userdata)
+{
+    AsyncLoader *loader = static_cast<AsyncLoader*>(userdata);
+
+    SDL_LockMutex(loader->queue_mutex);
+    AsyncAsset *asset = NULL;
+    for (int priority = ASSET_PRIORITY_COUNT - 1; priority >= 0 && asset == NULL && !loader->quit; priority--) {
+        asset = loader->queue_head[priority];
+    }
+    if (asset == NULL) {
+        SDL_UnlockMutex(loader->queue_mutex);
+        return;
+    }
+    UnlinkQueued(loader, asset);
+    SDL_SetAtomicInt(&asset->state, ASSET_STATE_LOADING);
+    SDL_UnlockMutex(loader->queue_mutex);
+
+    // Mip and HDR conversion fan out with ParallelFor, which keeps this job's LOW priority.
+    DecodeAsset(loader->jobs, asset);
+    PushCompleted(loader, asset);
+}
+
+AsyncLoader* CreateAsyncLoader(SDL_GPUDevice *gpu_device, UploadManager *upload_manager, JobSystem *jobs)
+{
+    AsyncLoader *loader = static_cast<AsyncLoader*>(SDL_calloc(1, sizeof(AsyncLoader)));
+    if (loader == NULL) {
+        return NULL;
+    }
+    loader->gpu_device = gpu_device;
+    loader->upload_manager = upload_manager;
+    loader->jobs = jobs;
+    loader->queue_mutex = SDL_CreateMutex();
+    if (loader->queue_mutex == NULL) {
+        SDL_Log("Failed to create asset queue lock! %s", SDL_GetError());
+        DestroyAsyncLoader(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+static void FreeDecodedData(AsyncAsset *asset)
+{
+    SDL_DestroySurface(asset->decoded_surface);
+    asset->decoded_surface = NULL;
+    FreeMipChain(&asset->mips);
+    SDL_free(asset->file_data);
+    asset->file_data = NULL;
+    FreeHDRImage(&asset->hdr);
+}
+
+static void UnloadAsset(AsyncLoader *loader, AsyncAsset *asset)
+{
+    FreeDecodedData(asset);
+    SDL_DestroySurface(asset->image);
+    asset->image = NULL;
+    if (asset->gpu_texture != NULL) {
+        SDL_ReleaseGPUTexture(loader->gpu_device, asset->gpu_texture);
+        asset->gpu_texture = NULL;
+    }
+    asset->num_callbacks = 0;
+    SDL_SetAtomicInt(&asset->state, ASSET_STATE_UNLOADED);
+}
+
+void DestroyAsyncLoader(AsyncLoader *loader)
+{
+    if (loader == NULL) {
+        return;
+    }
+
+    // Jobs still queued see quit and return; the ones already decoding finish.
+    if (loader->queue_mutex != NULL) {
+        SDL_LockMutex(loader->queue_mutex);
+        loader->quit = true;
+        SDL_UnlockMutex(loader->queue_mutex);
+        WaitForCounter(loader->jobs, &loader->counter);
+    }
+
+    // Anything mid-upload has handed its source data to the upload manager,
+    // which releases it; only our own copies are freed here.
+    for (Uint32 i = 0; i < loader->num_assets; i++) {
+        UnloadAsset(loader, loader->assets[i]);
+        SDL_free(loader->assets[i]->callbacks);
+        SDL_free(loader->assets[i]);
+    }
+    SDL_free(loader->assets);
+    SDL_DestroyMutex(loader->queue_mutex);
+    SDL_free(loader);
+}
+
+static AsyncAsset* GetAsset(const AsyncLoader *loader, AssetHandle handle)
+{
+    if (handle == 0 || handle > loader->num_assets) {
+        return NULL;
+    }
+    return loader->assets[handle - 1];
+}
+
+static bool AddCallback(AsyncAsset *asset, AssetLoadedCallback fn, void *userdata)
+{
+    if (asset->num_callbacks == asset->callback_capacity) {
+        Uint32 new_capacity = SDL_max(asset->callback_capacity * 2, 2u);
+        AssetCallback *callbacks = static_cast<AssetCallback*>(SDL_realloc(asset->callbacks, new_capacity * sizeof(AssetCallback)));
+        if (callbacks == NULL) {
+            return false;
+        }
+        asset->callbacks = callbacks;
+        asset->callback_capacity = new_capacity;
+    }
+    asset->callbacks[asset->num_callbacks++] = { fn, userdata };
+    return true;
+}
+
+static void RunCallbacks(AsyncLoader *loader, AssetHandle handle)
+{
+    // Callbacks may request or release assets, so re-fetch the asset every time.
+    for (Uint32 i = 0; ; i++) {
+        AsyncAsset *asset = GetAsset(loader, handle);
+        if (i >= asset->num_callbacks) {
+            asset->num_callbacks = 0;
+            break;
+        }
+        AssetCallback callback = asset->callbacks[i];
+        callback.fn(loader, handle, callback.userdata);
+    }
+}
+
+static AssetHandle RequestAsset(AsyncLoader *loader, const char *file_name, bool texture, bool srgb, AssetPriority priority,
+                                AssetLoadedCallback callback, void *userdata)
+{
+    if (SDL_strlen(file_name) >= MAX_ASSET_NAME) {
+        SDL_Log("Asset name too long: %s", file_name);
+        return 0;
+    }
+
+    // Linear scan: a scene references a few hundred distinct assets at most.
+    AssetHandle handle = 0;
+    for (Uint32 i = 0; i < loader->num_assets; i++) {
+        AsyncAsset *asset = loader->assets[i];
+        if (asset->texture == texture && asset->srgb == srgb && SDL_strcmp(asset->name, file_name) == 0) {
+            handle = i + 1;
+            break;
+        }
+    }
+
+    if (handle == 0) {
+        if (loader->num_assets == loader->asset_capacity) {
+            Uint32 new_capacity = SDL_max(loader->asset_capacity * 2, 64u);
+            AsyncAsset **assets = static_cast<AsyncAsset**>(SDL_realloc(loader->assets, new_capacity * sizeof(AsyncAsset*)));
+            if (assets == NULL) {
+                return 0;
+            }
+            loader->assets = assets;
+            loader->asset_capacity = new_capacity;
+        }
+        AsyncAsset *asset = static_cast<AsyncAsset*>(SDL_calloc(1, sizeof(AsyncAsset)));
+        if (asset == NULL) {
+            return 0;
+        }
+        SDL_strlcpy(asset->name, file_name, sizeof(asset->name));
+        asset->texture = texture;
+        asset->srgb = srgb;
+        SDL_SetAtomicInt(&asset->state, ASSET_STATE_UNLOADED);
+        loader->assets[loader->num_assets++] = asset;
+        handle = loader->num_assets;
+    } else if (GetAsset(loader, handle)->refs > 0) {
+        loader->deduplicated++;
+    }
+
+    AsyncAsset *asset = GetAsset(loader, handle);
+    asset->refs++;
+
+    SDL_LockMutex(loader->queue_mutex);
+    AssetState state = (AssetState)SDL_GetAtomicInt(&asset->state);
+    if (state == ASSET_STATE_UNLOADED) {
+        asset->priority = priority;
+        SDL_SetAtomicInt(&asset->state, ASSET_STATE_QUEUED);
+        LinkQueued(loader, asset);
+        SubmitJobWithPriority(loader->jobs, RunAssetLoadJob, loader, &loader->counter, JOB_PRIORITY_LOW);
+    } else if (state == ASSET_STATE_QUEUED && priority > asset->priority) {
+        UnlinkQueued(loader, asset);
+        asset->priority = priority;
+        LinkQueued(loader, asset);
+    }
+    SDL_UnlockMutex(loader->queue_mutex);
+
+    if (callback != NULL) {
+        if (state == ASSET_STATE_READY || state == ASSET_STATE_FAILED) {
+            callback(loader, handle, userdata);
+        } else {
+            AddCallback(asset, callback, userdata);
+        }
+    }
+    return handle;
+}
+
+AssetHandle LoadTextureAsync(AsyncLoader *loader, const char *file_name, bool srgb, AssetPriority priority,
+                             AssetLoadedCallback callback, void *userdata)
+{
+    if (loader->upload_manager == NULL) {
+        SDL_Log("LoadTextureAsync needs an upload manager: %s", file_name);
+        return 0;
+    }
+    return RequestAsset(loader, file_name, true, srgb, priority, callback, userdata);
+}
+
+AssetHandle LoadImageAsync(AsyncLoader *loader, const char *file_name, AssetPriority priority,
+                           AssetLoadedCallback callback, void *userdata)
+{
+    return RequestAsset(loader, file_name, false, false, priority, callback, userdata);
+}
+
+void ReleaseAsset(AsyncLoader *loader, AssetHandle handle)
+{
+    AsyncAsset *asset = GetAsset(loader, handle);
+    if (asset == NULL || asset->refs == 0) {
+        return;
+    }
+    if (--asset->refs > 0) {
+        return;
+    }
+
+    SDL_LockMutex(loader->queue_mutex);
+    AssetState state = (AssetState)SDL_GetAtomicInt(&asset->state);
+    if (state == ASSET_STATE_QUEUED) {
+        UnlinkQueued(loader, asset);
+        SDL_SetAtomicInt(&asset->state, ASSET_STATE_UNLOADED);
+    }
+    SDL_UnlockMutex(loader->queue_mutex);
+
+    // LOADING is discarded when it comes back, UPLOADING once the copy has
+    // executed: the texture can't go away while an upload still targets it.
+    asset->num_callbacks = 0;
+    if (state == ASSET_STATE_READY || state == ASSET_STATE_FAILED) {
+        UnloadAsset(loader, asset);
+    }
+}
+
+static void ReleaseUploadFile(void *userdata, const void *data)
+{
+    SDL_free(userdata);
+}
+
+static SDL_GPUTexture* CreateUploadTexture(AsyncLoader *loader, SDL_GPUTextureFormat format, Uint32 width, Uint32 height,
+                                           Uint32 num_levels)
+{
+    SDL_GPUTextureCreateInfo texture_info = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = format,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width = width,
+        .height = height,
+        .layer_count_or_depth = 1,
+        .num_levels = num_levels
+    };
+    SDL_GPUTexture *texture = SDL_CreateGPUTexture(loader->gpu_device, &texture_info);
+    if (texture == NULL) {
+        SDL_Log("Failed to create texture! %s", SDL_GetError());
+    }
+    return texture;
+}
+
+// Main thread: turns a decoded asset into its final form. Returns the next state.
+static AssetState FinishAsset(AsyncLoader *loader, AsyncAsset *asset)
+{
+    if (!asset->succeeded) {
+        return ASSET_STATE_FAILED;
+    }
+    if (!asset->texture) {
+        asset->image = asset->decoded_surface;
+        asset->decoded_surface = NULL;
+        return ASSET_STATE_READY;
+    }
+
+    if (asset->file_data != NULL) {
+        // Ownership of the file moves to the upload manager, which frees it once staged (or at once on failure).
+        void *file_data = asset->file_data;
+        asset->file_data = NULL;
+        asset->gpu_texture = StreamCompressedTexture(loader->gpu_device, loader->upload_manager, &asset->compressed,
+                                                     ReleaseUploadFile, file_data, &asset->ticket);
+        if (asset->gpu_texture == NULL) {
+            return ASSET_STATE_FAILED;
+        }
+        return ASSET_STATE_UPLOADING;
+    }
+
+    if (asset->hdr.pixels != NULL) {
+        HDRImage hdr = asset->hdr;
+        asset->hdr.pixels = NULL;
+        asset->gpu_texture = CreateUploadTexture(loader, GetHDRTextureFormat(hdr.format), hdr.width, hdr.height, 1);
+        if (asset->gpu_texture == NULL) {
+            FreeHDRImage(&hdr);
+            return ASSET_STATE_FAILED;
+        }
+        SDL_GPUTextureRegion destination = {
+            .texture = asset->gpu_texture,
+            .w = hdr.width,
+            .h = hdr.height,
+            .d = 1
+        };
+        // Goes to the upload manager whole, so it has to fit its ring (an 8K RGBA16F map is 256 MB; cook those to BC6H).
+        asset->ticket = QueueTextureUpload(loader->upload_manager, hdr.pixels, (Uint32)hdr.size, &destination, 0, 0,
+                                           ReleaseUploadFile, hdr.pixels);
+        if (asset->ticket == 0) {
+            SDL_ReleaseGPUTexture(loader->gpu_device, asset->gpu_texture);
+            asset->gpu_texture = NULL;
+            return ASSET_STATE_FAILED;
+        }
+        return ASSET_STATE_UPLOADING;
+    }
+
+    MipChain mips = asset->mips;
+    asset->mips.pixels = NULL;
+    SDL_GPUTextureFormat format = asset->srgb ? SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+    asset->gpu_texture = CreateUploadTexture(loader, format, mips.mip_widths[0], mips.mip_heights[0], mips.num_mips);
+    if (asset->gpu_texture == NULL) {
+        FreeMipChain(&mips);
+        return ASSET_STATE_FAILED;
+    }
+
+    TextureUploadRegion regions[MIP_CHAIN_MAX_MIPS];
+    for (Uint32 mip = 0; mip < mips.num_mips; mip++) {
+        regions[mip] = {
+            .offset = mips.mip_offsets[mip],
+            .size = (Uint32)mips.mip_sizes[mip],
+            .destination = {
+                .texture = asset->gpu_texture,
+                .mip_level = mip,
+                .w = mips.mip_widths[mip],
+                .h = mips.mip_heights[mip],
+                .d = 1
+            }
+        };
+    }
+    // All or nothing: on failure the chain is already freed and no copy targets the texture.
+    asset->ticket = QueueTextureUploads(loader->upload_manager, mips.pixels, regions, mips.num_mips, ReleaseUploadFile, mips.pixels);
+    if (asset->ticket == 0) {
+        SDL_ReleaseGPUTexture(loader->gpu_device, asset->gpu_texture);
+        asset->gpu_texture = NULL;
+        return ASSET_STATE_FAILED;
+    }
+    return ASSET_STATE_UPLOADING;
+}
+
+void UpdateAsyncLoader(AsyncLoader *loader)
+{
+    PROFILE_FUNCTION();
+    // With no workers only a LOW job's own waits would pick the decodes up, so
+    // nothing would; run them here instead, at the cost of a hitch.
+    if (GetJobWorkerCount(loader->jobs) == 0) {
+        WaitForCounter(loader->jobs, &loader->counter);
+    }
+
+    // Take everything the load jobs finished and put it back in completion order.
+    AsyncAsset *completed = static_cast<AsyncAsset*>(SDL_SetAtomicPointer(&loader->completed, NULL));
+    AsyncAsset *ordered = NULL;
+    while (completed != NULL) {
+        AsyncAsset *next = completed->completed_next;
+        completed->completed_next = ordered;
+        ordered = completed;
+        completed = next;
+    }
+
+    for (AsyncAsset *asset = ordered; asset != NULL; ) {
+        AsyncAsset *next = asset->completed_next;
+        asset->completed_next = NULL;
+
+        if (asset->refs == 0) {
+            UnloadAsset(loader, asset);
+        } else {
+            AssetState state = FinishAsset(loader, asset);
+            SDL_SetAtomicInt(&asset->state, state);
+            if (state == ASSET_STATE_UPLOADING) {
+                loader->num_uploading++;
+            }
+        }
+        asset = next;
+    }
+
+    // Promote finished uploads. Callbacks run last, after all state is consistent.
+    for (Uint32 i = 0; i < loader->num_assets && loader->num_uploading > 0; i++) {
+        AsyncAsset *asset = loader->assets[i];
+        if (SDL_GetAtomicInt(&asset->state) != ASSET_STATE_UPLOADING || !IsUploadComplete(loader->upload_manager, asset->ticket)) {
+            continue;
+        }
+        loader->num_uploading--;
+        if (asset->refs == 0) {
+            UnloadAsset(loader, asset);
+        } else {
+            SDL_SetAtomicInt(&asset->state, ASSET_STATE_READY);
+        }
+    }
+
+    for (Uint32 i = 0; i < loader->num_assets; i++) {
+        AsyncAsset *asset = loader->assets[i];
+        AssetState state = (AssetState)SDL_GetAtomicInt(&asset->state);
+        if (asset->num_callbacks > 0 && (state == ASSET_STATE_READY || state == ASSET_STATE_FAILED)) {
+            RunCallbacks(loader, i + 1);
+        }
+    }
+}
+
+AssetState GetAssetState(const AsyncLoader *loader, AssetHandle handle)
+{
+    AsyncAsset *asset = GetAsset(loader, handle);
+    return asset != NULL ? (AssetState)SDL_GetAtomicInt(&asset->state) : ASSET_STATE_UNLOADED;
+}
+
+SDL_GPUTexture* GetAssetTexture(const AsyncLoader *loader, AssetHandle handle)
+{
+    AsyncAsset *asset = GetAsset(loader, handle);
+    if (asset == NULL || SDL_GetAtomicInt(&asset->state) != ASSET_STATE_READY) {
+        return NULL;
+    }
+    return asset->gpu_texture;
+}
+
+SDL_Surface* GetAssetImage(const AsyncLoader *loader, AssetHandle handle)
+{
+    AsyncAsset *asset = GetAsset(loader, handle);
+    if (asset == NULL || SDL_GetAtomicInt(&asset->state) != ASSET_STATE_READY) {
+        return NULL;
+    }
+    return asset->image;
+}
+
+AsyncLoaderStats GetAsyncLoaderStats(const AsyncLoader *loader)
+{
+    AsyncLoaderStats stats = {};
+    for (Uint32 i = 0; i < loader->num_assets; i++) {
+        switch (SDL_GetAtomicInt(&loader->assets[i]->state)) {
+            case ASSET_STATE_QUEUED: stats.queued++; break;
+            case ASSET_STATE_LOADING: stats.loading++; break;
+            case ASSET_STATE_UPLOADING: stats.uploading++; break;
+            case ASSET_STATE_READY: stats.ready++; break;
+            case ASSET_STATE_FAILED: stats.failed++; break;
+            default: break;
+        }
+    }
+    stats.deduplicated = loader->deduplicated;
+    return stats;
+}
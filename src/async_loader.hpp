@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+#include <upload_manager.hpp>
+
+// Background asset loading. Requests return a handle immediately; file reads,
+// decoding and format conversion run as JOB_PRIORITY_LOW jobs, and the
+// results come back to the main thread through a lock-free completion queue
+// drained by UpdateAsyncLoader. Every function here is main-thread only.
+
+typedef Uint32 AssetHandle;     // 0 is never a valid handle
+
+typedef enum AssetPriority
+{
+    ASSET_PRIORITY_LOW,         // Prefetch, far away
+    ASSET_PRIORITY_NORMAL,
+    ASSET_PRIORITY_HIGH,        // Visible this frame
+    ASSET_PRIORITY_COUNT
+} AssetPriority;
+
+typedef enum AssetState
+{
+    ASSET_STATE_UNLOADED,
+    ASSET_STATE_QUEUED,
+    ASSET_STATE_LOADING,        // Decoding in a job
+    ASSET_STATE_UPLOADING,      // Decoded, texture data streaming through the upload manager
+    ASSET_STATE_READY,
+    ASSET_STATE_FAILED
+} AssetState;
+
+typedef struct AsyncLoaderStats
+{
+    Uint32 queued;
+    Uint32 loading;
+    Uint32 uploading;
+    Uint32 ready;
+    Uint32 failed;
+    Uint32 deduplicated;        // Requests served by an asset that was already known
+} AsyncLoaderStats;
+
+typedef struct AsyncLoader AsyncLoader;
+
+// Called on the main thread once the asset is READY or FAILED.
+typedef void (*AssetLoadedCallback)(AsyncLoader *loader, AssetHandle handle, void *userdata);
+
+// upload_manager may be NULL if only LoadImageAsync is used. jobs must outlive
+// the loader; with no workers, UpdateAsyncLoader decodes on the main thread.
+AsyncLoader* CreateAsyncLoader(SDL_GPUDevice *gpu_device, UploadManager *upload_manager, JobSystem *jobs);
+// Waits for the decodes in flight and frees everything, loaded or not.
+void DestroyAsyncLoader(AsyncLoader *loader);
+
+// .bmp (converted like LoadImage), .hdr (RGBA16F), .dds or .astc, relative to the assets root.
+// Asking for an asset that is already queued or loaded returns the same handle
+// and takes another reference; a higher priority moves a queued request forward.
+// A callback for an asset that is already READY runs before this returns.
+AssetHandle LoadTextureAsync(AsyncLoader *loader, const char *file_name, bool srgb, AssetPriority priority,
+                             AssetLoadedCallback callback, void *userdata);
+// CPU-side only: a .bmp decoded to ABGR8888, as LoadImage returns it.
+AssetHandle LoadImageAsync(AsyncLoader *loader, const char *file_name, AssetPriority priority,
+                           AssetLoadedCallback callback, void *userdata);
+
+// Drops a reference. The last one frees the surface/texture; a load still in
+// flight finishes in its job and is then discarded.
+void ReleaseAsset(AsyncLoader *loader, AssetHandle handle);
+
+// Once per frame, before FlushUploads: hands decoded assets to the upload
+// manager, promotes finished uploads to READY and runs callbacks.
+void UpdateAsyncLoader(AsyncLoader *loader);
+
+AssetState GetAssetState(const AsyncLoader *loader, AssetHandle handle);
+// NULL until the asset is READY.
+SDL_GPUTexture* GetAssetTexture(const AsyncLoader *loader, AssetHandle handle);
+SDL_Surface* GetAssetImage(const AsyncLoader *loader, AssetHandle handle);
+
+AsyncLoaderStats GetAsyncLoaderStats(const AsyncLoader *loader);
@@ -0,0 +1,593 @@
+#include <SDL3/SDL.h>
+#include <batching.hpp>
+
+#define BATCH_PACK_CHUNK 4096       // Sprites or instances per packing job
+#define SPRITE_VERTICES 6           // Two triangles, expanded by PullSpriteBatch.vert
+
+static void TransposeMatrix(const float in[16], float out[16])
+{
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            out[row * 4 + column] = in[column * 4 + row];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Packing
+// ---------------------------------------------------------------------------
+
+// Scalar only: each sprite is a few loads and one 64-byte store, so packing
+// runs at memory bandwidth and an SSE2 transpose measured no faster.
+void PackSprites(const SpriteStreams *streams, Uint32 first, Uint32 count, GPUSprite *out)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        Uint32 j = first + i;
+        GPUSprite *sprite = &out[i];
+        sprite->x = streams->x[j];
+        sprite->y = streams->y[j];
+        sprite->z = streams->z[j];
+        sprite->rotation = streams->rotation[j];
+        sprite->scale_x = streams->scale_x[j];
+        sprite->scale_y = streams->scale_y[j];
+        sprite->padding[0] = 0.0f;
+        sprite->padding[1] = 0.0f;
+        sprite->u = streams->u[j];
+        sprite->v = streams->v[j];
+        sprite->w = streams->w[j];
+        sprite->h = streams->h[j];
+        Uint32 color = streams->color[j];
+        sprite->color[0] = (float)(color & 0xFF) * (1.0f / 255.0f);
+        sprite->color[1] = (float)((color >> 8) & 0xFF) * (1.0f / 255.0f);
+        sprite->color[2] = (float)((color >> 16) & 0xFF) * (1.0f / 255.0f);
+        sprite->color[3] = (float)(color >> 24) * (1.0f / 255.0f);
+    }
+}
+
+static void PackInstancesScalar(const GPUInstance *source, const Uint32 *order, Uint32 count, GPUInstance *out)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        const GPUInstance *instance = &source[order[i]];
+        TransposeMatrix(instance->model, out[i].model);
+        for (int c = 0; c < 4; c++) {
+            out[i].color[c] = instance->color[c];
+        }
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+// Mapped upload memory is often write-combined and never read back here, so
+// aligned output bypasses the cache.
+static inline void StoreVector(float *out, __m128 value, bool stream)
+{
+    if (stream) {
+        _mm_stream_ps(out, value);
+    } else {
+        _mm_storeu_ps(out, value);
+    }
+}
+
+static void PackInstancesSSE2(const GPUInstance *source, const Uint32 *order, Uint32 count, GPUInstance *out)
+{
+    bool stream = ((uintptr_t)out & 15) == 0;
+    for (Uint32 i = 0; i < count; i++) {
+        const GPUInstance *instance = &source[order[i]];
+        __m128 row0 = _mm_loadu_ps(instance->model + 0);
+        __m128 row1 = _mm_loadu_ps(instance->model + 4);
+        __m128 row2 = _mm_loadu_ps(instance->model + 8);
+        __m128 row3 = _mm_loadu_ps(instance->model + 12);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        StoreVector(out[i].model + 0, row0, stream);
+        StoreVector(out[i].model + 4, row1, stream);
+        StoreVector(out[i].model + 8, row2, stream);
+        StoreVector(out[i].model + 12, row3, stream);
+        StoreVector(out[i].color, _mm_loadu_ps(instance->color), stream);
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+}
+#endif
+
+BatchPackPath ResolveBatchPackPath(BatchPackPath path)
+{
+#ifdef SDL_SSE2_INTRINSICS
+    if ((path == BATCH_PACK_AUTO || path == BATCH_PACK_SSE2) && SDL_HasSSE2()) {
+        return BATCH_PACK_SSE2;
+    }
+#endif
+    return BATCH_PACK_SCALAR;
+}
+
+void PackInstances(const GPUInstance *source, const Uint32 *order, Uint32 count, GPUInstance *out, BatchPackPath path)
+{
+#ifdef SDL_SSE2_INTRINSICS
+    if (ResolveBatchPackPath(path) == BATCH_PACK_SSE2) {
+        PackInstancesSSE2(source, order, count, out);
+        return;
+    }
+#endif
+    PackInstancesScalar(source, order, count, out);
+}
+
+// ---------------------------------------------------------------------------
+// Shared upload path
+// ---------------------------------------------------------------------------
+
+typedef struct PackJob
+{
+    BatchPackPath path;             // Instances only
+    const SpriteStreams *streams;   // Sprites: streams[first, first + count)
+    Uint32 first;
+    const GPUInstance *source;      // Instances: source[order[0, count)]
+    const Uint32 *order;
+    Uint32 count;
+    void *out;
+} PackJob;
+
+static void RunSpritePackJob(void *userdata)
+{
+    PackJob *job = static_cast<PackJob*>(userdata);
+    PackSprites(job->streams, job->first, job->count, static_cast<GPUSprite*>(job->out));
+}
+
+static void RunInstancePackJob(void *userdata)
+{
+    PackJob *job = static_cast<PackJob*>(userdata);
+    PackInstances(job->source, job->order, job->count, static_cast<GPUInstance*>(job->out), job->path);
+}
+
+// The calling thread packs the first chunk itself and helps with the rest while it waits.
+static void RunPackJobs(JobSystem *jobs, PackJob *pack_jobs, Uint32 count, JobFunction fn)
+{
+    if (count == 0) {
+        return;
+    }
+    if (jobs == NULL) {
+        for (Uint32 i = 0; i < count; i++) {
+            fn(&pack_jobs[i]);
+        }
+        return;
+    }
+    JobCounter counter;
+    SDL_SetAtomicInt(&counter.pending, 0);
+    for (Uint32 i = 1; i < count; i++) {
+        SubmitJob(jobs, fn, &pack_jobs[i], &counter);
+    }
+    fn(&pack_jobs[0]);
+    WaitForCounter(jobs, &counter);
+}
+
+static bool ReservePackJobs(PackJob **pack_jobs, Uint32 *capacity, Uint32 count)
+{
+    if (count <= *capacity) {
+        return true;
+    }
+    Uint32 new_capacity = SDL_max(count, *capacity * 2);
+    PackJob *grown = static_cast<PackJob*>(SDL_realloc(*pack_jobs, new_capacity * sizeof(PackJob)));
+    if (grown == NULL) {
+        return false;
+    }
+    *pack_jobs = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// This frame's packed data in the frame allocator's buffer. SDL binds storage
+// buffers whole, so the data starts on a whole element from the buffer's start
+// and the draws index it from first.
+typedef struct BatchData
+{
+    SDL_GPUBuffer *buffer;          // NULL without a device
+    Uint32 first;                   // Element index of the data in buffer
+    void *mapped;
+} BatchData;
+
+static bool AllocBatchData(FrameAllocator *frame_allocator, Uint32 count, Uint32 stride, BatchData *data)
+{
+    SDL_zerop(data);
+    if (count == 0) {
+        return true;
+    }
+    // The allocator only aligns to powers of two: take 16, which keeps the SSE2
+    // stores aligned, plus the slack to move up to a multiple of stride.
+    SDL_assert(stride % 16 == 0);
+    FrameBufferAllocation allocation;
+    if (!FrameAllocBuffer(frame_allocator, count * stride + stride - 16, 16, &allocation)) {
+        return SDL_SetError("Frame allocator has no room for %u batched elements", count);
+    }
+    Uint32 skip = (stride - allocation.offset % stride) % stride;
+    data->buffer = allocation.buffer;
+    data->first = (allocation.offset + skip) / stride;
+    data->mapped = static_cast<Uint8*>(allocation.data) + skip;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Instancing
+// ---------------------------------------------------------------------------
+
+typedef struct InstanceGroup
+{
+    int mesh;
+    int material;
+    Uint32 first;
+    Uint32 count;
+} InstanceGroup;
+
+// Vertex uniform block of PullPositionColorInstanced.vert.
+typedef struct InstanceUniforms
+{
+    float view_projection[16];
+    Uint32 base_instance;
+    Uint32 padding[3];
+} InstanceUniforms;
+
+struct InstanceBatcher
+{
+    JobSystem *jobs;
+    BatchData data;
+    Uint32 max_instances;
+
+    InstanceMesh *meshes;
+    int num_meshes;
+    InstanceMaterial *materials;
+    int num_materials;
+
+    // This frame's instances in the order they were added
+    GPUInstance *sources;
+    Uint64 *keys;                   // material << 32 | mesh
+    Uint32 *order;
+    Uint64 *temp_keys;
+    Uint32 *temp_order;
+    Uint32 count;
+
+    InstanceGroup *groups;
+    Uint32 num_groups;
+    PackJob *pack_jobs;
+    Uint32 pack_jobs_capacity;
+
+    InstanceBatchStats stats;
+};
+
+InstanceBatcher* CreateInstanceBatcher(JobSystem *jobs, Uint32 max_instances)
+{
+    InstanceBatcher *batcher = static_cast<InstanceBatcher*>(SDL_calloc(1, sizeof(InstanceBatcher)));
+    if (batcher == NULL) {
+        return NULL;
+    }
+    batcher->jobs = jobs;
+    batcher->max_instances = max_instances;
+    batcher->sources = static_cast<GPUInstance*>(SDL_malloc(max_instances * sizeof(GPUInstance)));
+    batcher->keys = static_cast<Uint64*>(SDL_malloc(max_instances * sizeof(Uint64)));
+    batcher->order = static_cast<Uint32*>(SDL_malloc(max_instances * sizeof(Uint32)));
+    batcher->temp_keys = static_cast<Uint64*>(SDL_malloc(max_instances * sizeof(Uint64)));
+    batcher->temp_order = static_cast<Uint32*>(SDL_malloc(max_instances * sizeof(Uint32)));
+    batcher->groups = static_cast<InstanceGroup*>(SDL_malloc(max_instances * sizeof(InstanceGroup)));
+    if (batcher->sources == NULL || batcher->keys == NULL || batcher->order == NULL ||
+        batcher->temp_keys == NULL || batcher->temp_order == NULL || batcher->groups == NULL) {
+        DestroyInstanceBatcher(batcher);
+        return NULL;
+    }
+    return batcher;
+}
+
+void DestroyInstanceBatcher(InstanceBatcher *batcher)
+{
+    if (batcher == NULL) {
+        return;
+    }
+    SDL_free(batcher->meshes);
+    SDL_free(batcher->materials);
+    SDL_free(batcher->sources);
+    SDL_free(batcher->keys);
+    SDL_free(batcher->order);
+    SDL_free(batcher->temp_keys);
+    SDL_free(batcher->temp_order);
+    SDL_free(batcher->groups);
+    SDL_free(batcher->pack_jobs);
+    SDL_free(batcher);
+}
+
+int AddInstanceMesh(InstanceBatcher *batcher, const InstanceMesh *mesh)
+{
+    InstanceMesh *meshes = static_cast<InstanceMesh*>(SDL_realloc(batcher->meshes, (batcher->num_meshes + 1) * sizeof(InstanceMesh)));
+    if (meshes == NULL) {
+        return -1;
+    }
+    batcher->meshes = meshes;
+    batcher->meshes[batcher->num_meshes] = *mesh;
+    return batcher->num_meshes++;
+}
+
+int AddInstanceMaterial(InstanceBatcher *batcher, const InstanceMaterial *material)
+{
+    if (material->num_fragment_samplers > RENDER_PACKET_MAX_SAMPLERS) {
+        SDL_SetError("Instance material has too many samplers (max %d)", RENDER_PACKET_MAX_SAMPLERS);
+        return -1;
+    }
+    InstanceMaterial *materials = static_cast<InstanceMaterial*>(SDL_realloc(batcher->materials, (batcher->num_materials + 1) * sizeof(InstanceMaterial)));
+    if (materials == NULL) {
+        return -1;
+    }
+    batcher->materials = materials;
+    batcher->materials[batcher->num_materials] = *material;
+    return batcher->num_materials++;
+}
+
+void ClearInstanceBatcher(InstanceBatcher *batcher)
+{
+    batcher->count = 0;
+    batcher->num_groups = 0;
+}
+
+bool AddInstance(InstanceBatcher *batcher, int mesh, int material, const float model[16], const float color[4])
+{
+    if (mesh < 0 || mesh >= batcher->num_meshes || material < 0 || material >= batcher->num_materials) {
+        return SDL_SetError("Unknown instance mesh %d or material %d", mesh, material);
+    }
+    if (batcher->count == batcher->max_instances) {
+        return SDL_SetError("Instance batcher is full (%u instances)", batcher->max_instances);
+    }
+    Uint32 index = batcher->count++;
+    GPUInstance *instance = &batcher->sources[index];
+    SDL_memcpy(instance->model, model, sizeof(instance->model));
+    SDL_memcpy(instance->color, color, sizeof(instance->color));
+    batcher->keys[index] = (Uint64)material << 32 | (Uint32)mesh;
+    batcher->order[index] = index;
+    return true;
+}
+
+bool UploadInstanceBatcher(InstanceBatcher *batcher, FrameAllocator *frame_allocator)
+{
+    InstanceBatchStats *stats = &batcher->stats;
+    Uint32 count = batcher->count;
+
+    // Stable, so a group keeps the order its instances were added in
+    Uint64 start = SDL_GetTicksNS();
+    RadixSortKeys(batcher->keys, batcher->order, batcher->temp_keys, batcher->temp_order, count);
+    batcher->num_groups = 0;
+    for (Uint32 i = 0; i < count; i++) {
+        if (i == 0 || batcher->keys[i] != batcher->keys[i - 1]) {
+            InstanceGroup *group = &batcher->groups[batcher->num_groups++];
+            group->material = (int)(batcher->keys[i] >> 32);
+            group->mesh = (int)(batcher->keys[i] & 0xFFFFFFFF);
+            group->first = i;
+            group->count = 0;
+        }
+        batcher->groups[batcher->num_groups - 1].count++;
+    }
+    stats->sort_ms = (SDL_GetTicksNS() - start) / 1e6;
+
+    start = SDL_GetTicksNS();
+    Uint32 num_jobs = (count + BATCH_PACK_CHUNK - 1) / BATCH_PACK_CHUNK;
+    if (!ReservePackJobs(&batcher->pack_jobs, &batcher->pack_jobs_capacity, num_jobs)) {
+        return false;
+    }
+    if (!AllocBatchData(frame_allocator, count, sizeof(GPUInstance), &batcher->data)) {
+        batcher->num_groups = 0;
+        return false;
+    }
+    GPUInstance *mapped = static_cast<GPUInstance*>(batcher->data.mapped);
+    BatchPackPath path = ResolveBatchPackPath(BATCH_PACK_AUTO);
+    for (Uint32 i = 0; i < num_jobs; i++) {
+        PackJob *job = &batcher->pack_jobs[i];
+        SDL_zerop(job);
+        job->path = path;
+        job->source = batcher->sources;
+        job->order = batcher->order + i * BATCH_PACK_CHUNK;
+        job->count = SDL_min(count - i * BATCH_PACK_CHUNK, (Uint32)BATCH_PACK_CHUNK);
+        job->out = mapped + i * BATCH_PACK_CHUNK;
+    }
+    RunPackJobs(batcher->jobs, batcher->pack_jobs, num_jobs, RunInstancePackJob);
+
+    stats->instances = count;
+    stats->groups = batcher->num_groups;
+    stats->chunks = num_jobs;
+    stats->pack_ms = (SDL_GetTicksNS() - start) / 1e6;
+    return true;
+}
+
+void SubmitInstanceBatcher(InstanceBatcher *batcher, RenderBucket *bucket, Uint32 layer, const float view_projection[16])
+{
+    InstanceUniforms uniforms;
+    SDL_zero(uniforms);
+    TransposeMatrix(view_projection, uniforms.view_projection);
+
+    for (Uint32 g = 0; g < batcher->num_groups; g++) {
+        const InstanceGroup *group = &batcher->groups[g];
+        const InstanceMesh *mesh = &batcher->meshes[group->mesh];
+        const InstanceMaterial *material = &batcher->materials[group->material];
+
+        DrawPacket packet;
+        SDL_zero(packet);
+        packet.sort_key = MakeOpaqueSortKey(layer, material->pipeline_id, (Uint32)group->material, 0, (Uint32)group->mesh);
+        packet.pipeline = material->pipeline;
+        packet.vertex_buffer = mesh->vertex_buffer;
+        packet.index_buffer = mesh->index_buffer;
+        packet.index_element_size = mesh->index_element_size;
+        packet.vertex_storage_buffers[0] = batcher->data.buffer;
+        packet.num_vertex_storage_buffers = 1;
+        SDL_memcpy(packet.fragment_samplers, material->fragment_samplers, sizeof(packet.fragment_samplers));
+        packet.num_fragment_samplers = material->num_fragment_samplers;
+        packet.num_elements = mesh->num_elements;
+        packet.num_instances = group->count;
+        uniforms.base_instance = batcher->data.first + group->first;
+        if (!SubmitDrawPacket(bucket, &packet, &uniforms, sizeof(uniforms), NULL, 0)) {
+            SDL_Log("Instance batch: %s", SDL_GetError());
+            return;
+        }
+    }
+}
+
+InstanceBatchStats GetInstanceBatchStats(const InstanceBatcher *batcher)
+{
+    return batcher->stats;
+}
+
+// ---------------------------------------------------------------------------
+// Sprites
+// ---------------------------------------------------------------------------
+
+typedef struct SpriteRun
+{
+    SDL_GPUTextureSamplerBinding texture;
+    SpriteStreams streams;
+    Uint32 first;                   // Index of its first sprite in the buffer
+} SpriteRun;
+
+struct SpriteBatch
+{
+    JobSystem *jobs;
+    BatchData data;
+    Uint32 max_sprites;
+
+    SpriteRun *runs;
+    Uint32 num_runs;
+    Uint32 runs_capacity;
+    Uint32 count;
+
+    PackJob *pack_jobs;
+    Uint32 pack_jobs_capacity;
+
+    SpriteBatchStats stats;
+};
+
+SpriteBatch* CreateSpriteBatch(JobSystem *jobs, Uint32 max_sprites)
+{
+    SpriteBatch *batch = static_cast<SpriteBatch*>(SDL_calloc(1, sizeof(SpriteBatch)));
+    if (batch == NULL) {
+        return NULL;
+    }
+    batch->jobs = jobs;
+    batch->max_sprites = max_sprites;
+    return batch;
+}
+
+void DestroySpriteBatch(SpriteBatch *batch)
+{
+    if (batch == NULL) {
+        return;
+    }
+    SDL_free(batch->runs);
+    SDL_free(batch->pack_jobs);
+    SDL_free(batch);
+}
+
+void ClearSpriteBatch(SpriteBatch *batch)
+{
+    batch->num_runs = 0;
+    batch->count = 0;
+}
+
+bool AddSprites(SpriteBatch *batch, const SDL_GPUTextureSamplerBinding *texture, const SpriteStreams *streams)
+{
+    if (streams->count == 0) {
+        return true;
+    }
+    if (streams->count > batch->max_sprites - batch->count) {
+        return SDL_SetError("Sprite batch is full (%u sprites)", batch->max_sprites);
+    }
+    if (batch->num_runs == batch->runs_capacity) {
+        Uint32 capacity = SDL_max(batch->runs_capacity * 2, 16u);
+        SpriteRun *runs = static_cast<SpriteRun*>(SDL_realloc(batch->runs, capacity * sizeof(SpriteRun)));
+        if (runs == NULL) {
+            return false;
+        }
+        batch->runs = runs;
+        batch->runs_capacity = capacity;
+    }
+    SpriteRun *run = &batch->runs[batch->num_runs++];
+    run->texture = *texture;
+    run->streams = *streams;
+    run->first = batch->count;
+    batch->count += streams->count;
+    return true;
+}
+
+bool UploadSpriteBatch(SpriteBatch *batch, FrameAllocator *frame_allocator)
+{
+    Uint64 start = SDL_GetTicksNS();
+    Uint32 num_jobs = 0;
+    for (Uint32 r = 0; r < batch->num_runs; r++) {
+        num_jobs += (batch->runs[r].streams.count + BATCH_PACK_CHUNK - 1) / BATCH_PACK_CHUNK;
+    }
+    if (!ReservePackJobs(&batch->pack_jobs, &batch->pack_jobs_capacity, num_jobs)) {
+        return false;
+    }
+    if (!AllocBatchData(frame_allocator, batch->count, sizeof(GPUSprite), &batch->data)) {
+        batch->num_runs = 0;
+        return false;
+    }
+    GPUSprite *mapped = static_cast<GPUSprite*>(batch->data.mapped);
+
+    Uint32 job_index = 0;
+    for (Uint32 r = 0; r < batch->num_runs; r++) {
+        const SpriteRun *run = &batch->runs[r];
+        for (Uint32 first = 0; first < run->streams.count; first += BATCH_PACK_CHUNK) {
+            PackJob *job = &batch->pack_jobs[job_index++];
+            SDL_zerop(job);
+            job->streams = &run->streams;
+            job->first = first;
+            job->count = SDL_min(run->streams.count - first, (Uint32)BATCH_PACK_CHUNK);
+            job->out = mapped + run->first + first;
+        }
+    }
+    RunPackJobs(batch->jobs, batch->pack_jobs, num_jobs, RunSpritePackJob);
+
+    batch->stats.sprites = batch->count;
+    batch->stats.chunks = num_jobs;
+    batch->stats.pack_ms = (SDL_GetTicksNS() - start) / 1e6;
+    return true;
+}
+
+static bool SameTexture(const SDL_GPUTextureSamplerBinding *a, const SDL_GPUTextureSamplerBinding *b)
+{
+    return a->texture == b->texture && a->sampler == b->sampler;
+}
+
+void SubmitSpriteBatch(SpriteBatch *batch, RenderBucket *bucket, SDL_GPUGraphicsPipeline *pipeline, Uint32 pipeline_id,
+                       Uint32 layer, const float view_projection[16])
+{
+    float uniforms[16];
+    TransposeMatrix(view_projection, uniforms);
+
+    // Neighbouring runs with the same texture share a draw; the draw index
+    // goes where the depth would be so the draws keep their order.
+    Uint32 num_draws = 0;
+    for (Uint32 r = 0; r < batch->num_runs;) {
+        const SpriteRun *run = &batch->runs[r];
+        Uint32 count = run->streams.count;
+        for (r++; r < batch->num_runs && SameTexture(&batch->runs[r].texture, &run->texture); r++) {
+            count += batch->runs[r].streams.count;
+        }
+
+        DrawPacket packet;
+        SDL_zero(packet);
+        packet.sort_key = MakeOpaqueSortKey(layer, pipeline_id, 0, num_draws, 0);
+        packet.pipeline = pipeline;
+        packet.vertex_storage_buffers[0] = batch->data.buffer;
+        packet.num_vertex_storage_buffers = 1;
+        packet.fragment_samplers[0] = run->texture;
+        packet.num_fragment_samplers = 1;
+        packet.num_elements = count * SPRITE_VERTICES;
+        packet.num_instances = 1;
+        packet.first_element = (batch->data.first + run->first) * SPRITE_VERTICES;
+        if (!SubmitDrawPacket(bucket, &packet, uniforms, sizeof(uniforms), NULL, 0)) {
+            SDL_Log("Sprite batch: %s", SDL_GetError());
+            break;
+        }
+        num_draws++;
+    }
+    batch->stats.draws = num_draws;
+}
+
+SpriteBatchStats GetSpriteBatchStats(const SpriteBatch *batch)
+{
+    return batch->stats;
+}
+
+const GPUSprite* GetHeadlessSpriteData(const SpriteBatch *batch)
+{
+    return batch->data.buffer == NULL ? static_cast<const GPUSprite*>(batch->data.mapped) : NULL;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <frame_allocator.hpp>
+#include <jobs.hpp>
+#include <render_queue.hpp>
+
+// Draw batching on top of the render queue.
+//
+// InstanceBatcher collects individual mesh draws, groups those that share a
+// mesh and a material, and draws each group as one instanced draw. Per-instance
+// data goes into a storage buffer that the vertex shader indexes with
+// BaseInstance + SV_InstanceID (PullPositionColorInstanced.vert). The base is
+// a uniform because SV_InstanceID does not include first_instance on every
+// backend.
+//
+// SpriteBatch draws 2D sprites pull-style: the sprites go into a storage
+// buffer and PullSpriteBatch.vert expands each into six vertices from
+// SV_VertexID, so there is no vertex buffer and one draw covers every sprite
+// until the texture changes.
+//
+// Both pack their GPU data straight into the frame allocator's region for the
+// frame, split into chunks across the job system; FlushFrameAllocator copies
+// it over with the frame's other transient data, and the draws read the
+// allocator's buffer from where the data starts. Upload after
+// BeginFrameAllocator and before FlushFrameAllocator, then submit the draws
+// into a render bucket. A frame allocator without a device packs into CPU
+// memory, for headless benchmarks.
+
+// ---------------------------------------------------------------------------
+// Packing (CPU only)
+// ---------------------------------------------------------------------------
+
+// Instance packing only; sprites have one path.
+typedef enum BatchPackPath
+{
+    BATCH_PACK_AUTO,            // Best path the CPU supports
+    BATCH_PACK_SCALAR,
+    BATCH_PACK_SSE2             // Memory bound; wider vectors gain nothing
+} BatchPackPath;
+
+// StructuredBuffer<SpriteData> element of PullSpriteBatch.vert and SpriteBatch.comp.
+typedef struct GPUSprite
+{
+    float x, y, z;
+    float rotation;
+    float scale_x, scale_y;
+    float padding[2];
+    float u, v, w, h;
+    float color[4];
+} GPUSprite;
+
+// Sprites as structure-of-arrays streams, the way a sprite system keeps them.
+// Texture rectangles are normalised; colors are RGBA8 with red in the low byte.
+typedef struct SpriteStreams
+{
+    const float *x, *y, *z;
+    const float *rotation;
+    const float *scale_x, *scale_y;
+    const float *u, *v, *w, *h;
+    const Uint32 *color;
+    Uint32 count;
+} SpriteStreams;
+
+// Per-instance data of PullPositionColorInstanced.vert. The model matrix is
+// transposed for HLSL, like every matrix this renderer hands a shader.
+typedef struct GPUInstance
+{
+    float model[16];
+    float color[4];
+} GPUInstance;
+
+// Converts sprites [first, first + count) of streams into out[0, count).
+void PackSprites(const SpriteStreams *streams, Uint32 first, Uint32 count, GPUSprite *out);
+// out[i] = source[order[i]] with the matrix transposed from column-major.
+// Every path writes the same bytes.
+void PackInstances(const GPUInstance *source, const Uint32 *order, Uint32 count, GPUInstance *out, BatchPackPath path);
+BatchPackPath ResolveBatchPackPath(BatchPackPath path);
+
+// ---------------------------------------------------------------------------
+// Instancing
+// ---------------------------------------------------------------------------
+
+typedef struct InstanceMesh
+{
+    SDL_GPUBufferBinding vertex_buffer;
+    SDL_GPUBufferBinding index_buffer;          // buffer NULL draws non-indexed
+    SDL_GPUIndexElementSize index_element_size;
+    Uint32 num_elements;                        // Vertices, or indices when indexed
+} InstanceMesh;
+
+typedef struct InstanceMaterial
+{
+    SDL_GPUGraphicsPipeline *pipeline;
+    Uint32 pipeline_id;                         // For the sort key, e.g. the shader registry id
+    SDL_GPUTextureSamplerBinding fragment_samplers[RENDER_PACKET_MAX_SAMPLERS];
+    Uint32 num_fragment_samplers;
+} InstanceMaterial;
+
+typedef struct InstanceBatchStats
+{
+    Uint32 instances;
+    Uint32 groups;              // Instanced draws
+    Uint32 chunks;              // Packing jobs
+    double sort_ms;
+    double pack_ms;
+} InstanceBatchStats;
+
+typedef struct InstanceBatcher InstanceBatcher;
+
+// jobs may be NULL, which packs on the calling thread.
+InstanceBatcher* CreateInstanceBatcher(JobSystem *jobs, Uint32 max_instances);
+void DestroyInstanceBatcher(InstanceBatcher *batcher);
+
+// Meshes and materials live as long as the batcher. Return an id, or -1.
+int AddInstanceMesh(InstanceBatcher *batcher, const InstanceMesh *mesh);
+int AddInstanceMaterial(InstanceBatcher *batcher, const InstanceMaterial *material);
+
+// Starts a frame.
+void ClearInstanceBatcher(InstanceBatcher *batcher);
+// model is column-major (glm). One thread at a time.
+bool AddInstance(InstanceBatcher *batcher, int mesh, int material, const float model[16], const float color[4]);
+// Groups the instances and packs them into frame_allocator's current frame.
+// Main thread.
+bool UploadInstanceBatcher(InstanceBatcher *batcher, FrameAllocator *frame_allocator);
+// One packet per group. view_projection is column-major.
+void SubmitInstanceBatcher(InstanceBatcher *batcher, RenderBucket *bucket, Uint32 layer, const float view_projection[16]);
+
+InstanceBatchStats GetInstanceBatchStats(const InstanceBatcher *batcher);
+
+// ---------------------------------------------------------------------------
+// Sprites
+// ---------------------------------------------------------------------------
+
+typedef struct SpriteBatchStats
+{
+    Uint32 sprites;
+    Uint32 draws;
+    Uint32 chunks;              // Packing jobs
+    double pack_ms;
+} SpriteBatchStats;
+
+typedef struct SpriteBatch SpriteBatch;
+
+// jobs may be NULL, which packs on the calling thread.
+SpriteBatch* CreateSpriteBatch(JobSystem *jobs, Uint32 max_sprites);
+void DestroySpriteBatch(SpriteBatch *batch);
+
+// Starts a frame.
+void ClearSpriteBatch(SpriteBatch *batch);
+// Appends streams->count sprites drawn with texture. Sprites draw in the order
+// they were added, and a texture change starts a new draw, so add them grouped
+// by texture where the blending order allows. The streams are read by
+// UploadSpriteBatch and must stay valid until then.
+bool AddSprites(SpriteBatch *batch, const SDL_GPUTextureSamplerBinding *texture, const SpriteStreams *streams);
+// Packs every sprite into frame_allocator's current frame. Main thread.
+bool UploadSpriteBatch(SpriteBatch *batch, FrameAllocator *frame_allocator);
+// One packet per texture run, in order. pipeline must use PullSpriteBatch.vert;
+// view_projection is column-major.
+void SubmitSpriteBatch(SpriteBatch *batch, RenderBucket *bucket, SDL_GPUGraphicsPipeline *pipeline, Uint32 pipeline_id,
+                       Uint32 layer, const float view_projection[16]);
+
+SpriteBatchStats GetSpriteBatchStats(const SpriteBatch *batch);
+// The sprites the last upload packed into a frame allocator without a device,
+// until that frame's slot comes round again; NULL with a device.
+const GPUSprite* GetHeadlessSpriteData(const SpriteBatch *batch);
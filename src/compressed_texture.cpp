@@ -0,0 +1,436 @@
+#include <SDL3/SDL.h>
+#include <compressed_texture.hpp>
+#include <profiler.hpp>
+
+#define DDS_MAGIC 0x20534444    // "DDS "
+#define ASTC_MAGIC 0x5CA1AB13
+
+#define DDS_HEADER_SIZE 124
+#define DDS_PIXELFORMAT_SIZE 32
+#define DDS_DX10_HEADER_SIZE 20
+
+#define DDPF_FOURCC 0x4
+#define DDSCAPS2_CUBEMAP 0x200
+#define DDSCAPS2_CUBEMAP_ALL_FACES 0xFC00
+#define DDSCAPS2_VOLUME 0x200000
+#define DDS_DIMENSION_TEXTURE2D 3
+#define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+
+// Generous limits that keep every size computation far away from overflow.
+#define MAX_TEXTURE_DIMENSION 16384
+#define MAX_TEXTURE_LAYERS 2048
+
+#define FOURCC(a, b, c, d) ((Uint32)(a) | ((Uint32)(b) << 8) | ((Uint32)(c) << 16) | ((Uint32)(d) << 24))
+
+static Uint32 ReadU32(const Uint8 *bytes)
+{
+    return (Uint32)bytes[0] | ((Uint32)bytes[1] << 8) | ((Uint32)bytes[2] << 16) | ((Uint32)bytes[3] << 24);
+}
+
+static Uint32 ReadU24(const Uint8 *bytes)
+{
+    return (Uint32)bytes[0] | ((Uint32)bytes[1] << 8) | ((Uint32)bytes[2] << 16);
+}
+
+static void SetBlockFormat(CompressedImage *image, SDL_GPUTextureFormat format, Uint32 block_width, Uint32 block_height, Uint32 block_size)
+{
+    image->format = format;
+    image->block_width = block_width;
+    image->block_height = block_height;
+    image->block_size = block_size;
+}
+
+static bool SetFormatFromFourCC(CompressedImage *image, Uint32 fourcc)
+{
+    switch (fourcc) {
+    case FOURCC('D', 'X', 'T', '1'):
+        SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM, 4, 4, 8);
+        return true;
+    case FOURCC('D', 'X', 'T', '2'):
+    case FOURCC('D', 'X', 'T', '3'):
+        SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM, 4, 4, 16);
+        return true;
+    case FOURCC('D', 'X', 'T', '4'):
+    case FOURCC('D', 'X', 'T', '5'):
+        SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM, 4, 4, 16);
+        return true;
+    case FOURCC('A', 'T', 'I', '1'):
+    case FOURCC('B', 'C', '4', 'U'):
+        SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM, 4, 4, 8);
+        return true;
+    case FOURCC('A', 'T', 'I', '2'):
+    case FOURCC('B', 'C', '5', 'U'):
+        SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM, 4, 4, 16);
+        return true;
+    default:
+        return SDL_SetError("Unsupported DDS FourCC 0x%08x", fourcc);
+    }
+}
+
+static bool SetFormatFromDXGI(CompressedImage *image, Uint32 dxgi_format)
+{
+    switch (dxgi_format) {
+    case 2:  SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT, 1, 1, 16); return true;
+    case 10: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, 1, 1, 8); return true;
+    case 26: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT, 1, 1, 4); return true;
+    case 28: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 1, 1, 4); return true;
+    case 29: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB, 1, 1, 4); return true;
+    case 71: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM, 4, 4, 8); return true;
+    case 72: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB, 4, 4, 8); return true;
+    case 74: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM, 4, 4, 16); return true;
+    case 75: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC2_RGBA_UNORM_SRGB, 4, 4, 16); return true;
+    case 77: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM, 4, 4, 16); return true;
+    case 78: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB, 4, 4, 16); return true;
+    case 80: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM, 4, 4, 8); return true;
+    case 83: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM, 4, 4, 16); return true;
+    case 95: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT, 4, 4, 16); return true;
+    case 96: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC6H_RGB_FLOAT, 4, 4, 16); return true;
+    case 98: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM, 4, 4, 16); return true;
+    case 99: SetBlockFormat(image, SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB, 4, 4, 16); return true;
+    default:
+        return SDL_SetError("Unsupported DXGI format %u", dxgi_format);
+    }
+}
+
+Uint64 GetCompressedMipSize(const CompressedImage *image, Uint32 mip)
+{
+    Uint32 width = SDL_max(image->width >> mip, 1u);
+    Uint32 height = SDL_max(image->height >> mip, 1u);
+    Uint64 blocks_x = (width + image->block_width - 1) / image->block_width;
+    Uint64 blocks_y = (height + image->block_height - 1) / image->block_height;
+    return blocks_x * blocks_y * image->block_size;
+}
+
+// Shared tail of both parsers: validates dimensions and that every subresource fits.
+static bool FinishImage(CompressedImage *image, const Uint8 *data, size_t available)
+{
+    if (image->width == 0 || image->height == 0 ||
+        image->width > MAX_TEXTURE_DIMENSION || image->height > MAX_TEXTURE_DIMENSION) {
+        return SDL_SetError("Invalid texture size %ux%u", image->width, image->height);
+    }
+    if (image->num_layers == 0 || image->num_layers > MAX_TEXTURE_LAYERS) {
+        return SDL_SetError("Invalid layer count %u", image->num_layers);
+    }
+
+    Uint32 max_mips = 1;
+    while ((SDL_max(image->width, image->height) >> max_mips) > 0) {
+        max_mips++;
+    }
+    if (image->num_mips == 0 || image->num_mips > max_mips) {
+        return SDL_SetError("Invalid mip count %u for %ux%u", image->num_mips, image->width, image->height);
+    }
+
+    image->layer_size = 0;
+    for (Uint32 mip = 0; mip < image->num_mips; mip++) {
+        image->layer_size += GetCompressedMipSize(image, mip);
+    }
+    image->data_size = image->layer_size * image->num_layers;
+    if (image->data_size > available || image->data_size > SDL_MAX_UINT32) {
+        return SDL_SetError("Texture data truncated: need %" SDL_PRIu64 " bytes, have %" SDL_PRIu64,
+                            image->data_size, (Uint64)available);
+    }
+    image->data = data;
+    return true;
+}
+
+bool ParseDDS(const void *file_data, size_t file_size, CompressedImage *image)
+{
+    const Uint8 *bytes = static_cast<const Uint8*>(file_data);
+    SDL_zerop(image);
+
+    if (file_size < 4 + DDS_HEADER_SIZE || ReadU32(bytes) != DDS_MAGIC) {
+        return SDL_SetError("Not a DDS file");
+    }
+
+    const Uint8 *header = bytes + 4;
+    const Uint8 *pixel_format = header + 72;
+    if (ReadU32(header) != DDS_HEADER_SIZE || ReadU32(pixel_format) != DDS_PIXELFORMAT_SIZE) {
+        return SDL_SetError("Corrupt DDS header");
+    }
+
+    image->height = ReadU32(header + 8);
+    image->width = ReadU32(header + 12);
+    image->num_mips = SDL_max(ReadU32(header + 24), 1u);
+    Uint32 caps2 = ReadU32(header + 108);
+
+    if (!(ReadU32(pixel_format + 4) & DDPF_FOURCC)) {
+        return SDL_SetError("Uncompressed legacy DDS files are not supported");
+    }
+    if (caps2 & DDSCAPS2_VOLUME) {
+        return SDL_SetError("Volume DDS files are not supported");
+    }
+
+    size_t data_offset = 4 + DDS_HEADER_SIZE;
+    bool is_cube;
+    Uint32 array_size = 1;
+
+    Uint32 fourcc = ReadU32(pixel_format + 8);
+    if (fourcc == FOURCC('D', 'X', '1', '0')) {
+        if (file_size < data_offset + DDS_DX10_HEADER_SIZE) {
+            return SDL_SetError("DDS DX10 header truncated");
+        }
+        const Uint8 *dx10 = bytes + data_offset;
+        data_offset += DDS_DX10_HEADER_SIZE;
+
+        if (!SetFormatFromDXGI(image, ReadU32(dx10))) {
+            return false;
+        }
+        if (ReadU32(dx10 + 4) != DDS_DIMENSION_TEXTURE2D) {
+            return SDL_SetError("Only 2D DDS textures are supported");
+        }
+        is_cube = (ReadU32(dx10 + 8) & DDS_RESOURCE_MISC_TEXTURECUBE) != 0;
+        array_size = ReadU32(dx10 + 12);
+        if (array_size == 0 || array_size > MAX_TEXTURE_LAYERS) {
+            return SDL_SetError("Invalid DDS array size %u", array_size);
+        }
+    } else {
+        if (!SetFormatFromFourCC(image, fourcc)) {
+            return false;
+        }
+        is_cube = (caps2 & DDSCAPS2_CUBEMAP) != 0;
+        if (is_cube && (caps2 & DDSCAPS2_CUBEMAP_ALL_FACES) != DDSCAPS2_CUBEMAP_ALL_FACES) {
+            return SDL_SetError("Partial DDS cubemaps are not supported");
+        }
+    }
+
+    if (is_cube) {
+        if (image->width != image->height) {
+            return SDL_SetError("DDS cubemap faces must be square");
+        }
+        image->num_layers = array_size * 6;
+        image->type = array_size > 1 ? SDL_GPU_TEXTURETYPE_CUBE_ARRAY : SDL_GPU_TEXTURETYPE_CUBE;
+    } else {
+        image->num_layers = array_size;
+        image->type = array_size > 1 ? SDL_GPU_TEXTURETYPE_2D_ARRAY : SDL_GPU_TEXTURETYPE_2D;
+    }
+
+    return FinishImage(image, bytes + data_offset, file_size - data_offset);
+}
+
+bool ParseASTC(const void *file_data, size_t file_size, bool srgb, CompressedImage *image)
+{
+    static const struct
+    {
+        Uint8 block_width;
+        Uint8 block_height;
+        SDL_GPUTextureFormat unorm;
+        SDL_GPUTextureFormat srgb;
+    } astc_formats[] = {
+        { 4, 4, SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM_SRGB },
+        { 5, 4, SDL_GPU_TEXTUREFORMAT_ASTC_5x4_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_5x4_UNORM_SRGB },
+        { 5, 5, SDL_GPU_TEXTUREFORMAT_ASTC_5x5_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_5x5_UNORM_SRGB },
+        { 6, 5, SDL_GPU_TEXTUREFORMAT_ASTC_6x5_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_6x5_UNORM_SRGB },
+        { 6, 6, SDL_GPU_TEXTUREFORMAT_ASTC_6x6_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_6x6_UNORM_SRGB },
+        { 8, 5, SDL_GPU_TEXTUREFORMAT_ASTC_8x5_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_8x5_UNORM_SRGB },
+        { 8, 6, SDL_GPU_TEXTUREFORMAT_ASTC_8x6_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_8x6_UNORM_SRGB },
+        { 8, 8, SDL_GPU_TEXTUREFORMAT_ASTC_8x8_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_8x8_UNORM_SRGB },
+        { 10, 5, SDL_GPU_TEXTUREFORMAT_ASTC_10x5_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_10x5_UNORM_SRGB },
+        { 10, 6, SDL_GPU_TEXTUREFORMAT_ASTC_10x6_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_10x6_UNORM_SRGB },
+        { 10, 8, SDL_GPU_TEXTUREFORMAT_ASTC_10x8_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_10x8_UNORM_SRGB },
+        { 10, 10, SDL_GPU_TEXTUREFORMAT_ASTC_10x10_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_10x10_UNORM_SRGB },
+        { 12, 10, SDL_GPU_TEXTUREFORMAT_ASTC_12x10_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_12x10_UNORM_SRGB },
+        { 12, 12, SDL_GPU_TEXTUREFORMAT_ASTC_12x12_UNORM, SDL_GPU_TEXTUREFORMAT_ASTC_12x12_UNORM_SRGB },
+    };
+
+    const Uint8 *bytes = static_cast<const Uint8*>(file_data);
+    SDL_zerop(image);
+
+    // 16-byte header: magic, block size x/y/z, then 24-bit image size x/y/z.
+    if (file_size < 16 || ReadU32(bytes) != ASTC_MAGIC) {
+        return SDL_SetError("Not an ASTC file");
+    }
+    if (bytes[6] != 1 || ReadU24(bytes + 13) != 1) {
+        return SDL_SetError("3D ASTC textures are not supported");
+    }
+
+    for (Uint32 i = 0; i < SDL_arraysize(astc_formats); i++) {
+        if (astc_formats[i].block_width == bytes[4] && astc_formats[i].block_height == bytes[5]) {
+            SetBlockFormat(image, srgb ? astc_formats[i].srgb : astc_formats[i].unorm, bytes[4], bytes[5], 16);
+            break;
+        }
+    }
+    if (image->block_size == 0) {
+        return SDL_SetError("Unsupported ASTC block size %ux%u", bytes[4], bytes[5]);
+    }
+
+    // The container has no mips or layers.
+    image->width = ReadU24(bytes + 7);
+    image->height = ReadU24(bytes + 10);
+    image->num_mips = 1;
+    image->num_layers = 1;
+    image->type = SDL_GPU_TEXTURETYPE_2D;
+
+    return FinishImage(image, bytes + 16, file_size - 16);
+}
+
+static SDL_GPUTexture* CreateTextureForImage(SDL_GPUDevice *gpu_device, const CompressedImage *image)
+{
+    if (!SDL_GPUTextureSupportsFormat(gpu_device, image->format, image->type, SDL_GPU_TEXTUREUSAGE_SAMPLER)) {
+        SDL_Log("Texture format %d is not supported by this GPU", (int)image->format);
+        return NULL;
+    }
+
+    SDL_GPUTextureCreateInfo texture_info = {
+        .type = image->type,
+        .format = image->format,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width = image->width,
+        .height = image->height,
+        .layer_count_or_depth = image->num_layers,
+        .num_levels = image->num_mips
+    };
+    SDL_GPUTexture *texture = SDL_CreateGPUTexture(gpu_device, &texture_info);
+    if (texture == NULL) {
+        SDL_Log("Failed to create texture! %s", SDL_GetError());
+    }
+    return texture;
+}
+
+SDL_GPUTexture* CreateCompressedTexture(SDL_GPUDevice *gpu_device, const CompressedImage *image)
+{
+    SDL_GPUTexture *texture = CreateTextureForImage(gpu_device, image);
+    if (texture == NULL) {
+        return NULL;
+    }
+
+    SDL_GPUTransferBufferCreateInfo transfer_info = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = (Uint32)image->data_size
+    };
+    SDL_GPUTransferBuffer *transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
+    if (transfer_buffer == NULL) {
+        SDL_Log("Failed to create transfer buffer! %s", SDL_GetError());
+        SDL_ReleaseGPUTexture(gpu_device, texture);
+        return NULL;
+    }
+
+    // The file already has the GPU's layout (layer-major, tightly packed blocks): one memcpy.
+    void *mapped = SDL_MapGPUTransferBuffer(gpu_device, transfer_buffer, false);
+    if (mapped == NULL) {
+        SDL_Log("Failed to map transfer buffer! %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
+        SDL_ReleaseGPUTexture(gpu_device, texture);
+        return NULL;
+    }
+    SDL_memcpy(mapped, image->data, (size_t)image->data_size);
+    SDL_UnmapGPUTransferBuffer(gpu_device, transfer_buffer);
+
+    SDL_GPUCommandBuffer *command_buffer = SDL_AcquireGPUCommandBuffer(gpu_device);
+    if (command_buffer == NULL) {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
+        SDL_ReleaseGPUTexture(gpu_device, texture);
+        return NULL;
+    }
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(command_buffer);
+    Uint32 offset = 0;
+    for (Uint32 layer = 0; layer < image->num_layers; layer++) {
+        for (Uint32 mip = 0; mip < image->num_mips; mip++) {
+            SDL_GPUTextureTransferInfo source = {
+                .transfer_buffer = transfer_buffer,
+                .offset = offset,
+            };
+            SDL_GPUTextureRegion destination = {
+                .texture = texture,
+                .mip_level = mip,
+                .layer = layer,
+                .w = SDL_max(image->width >> mip, 1u),
+                .h = SDL_max(image->height >> mip, 1u),
+                .d = 1
+            };
+            SDL_UploadToGPUTexture(copy_pass, &source, &destination, false);
+            offset += (Uint32)GetCompressedMipSize(image, mip);
+        }
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+    SDL_SubmitGPUCommandBuffer(command_buffer);
+
+    SDL_ReleaseGPUTransferBuffer(gpu_device, transfer_buffer);
+    return texture;
+}
+
+SDL_GPUTexture* StreamCompressedTexture(
+    SDL_GPUDevice *gpu_device,
+    UploadManager *upload_manager,
+    const CompressedImage *image,
+    UploadDataReleaseFunction release,
+    void *userdata,
+    UploadTicket *ticket
+) {
+    Uint32 count = image->num_layers * image->num_mips;
+    TextureUploadRegion *regions = static_cast<TextureUploadRegion*>(SDL_malloc(count * sizeof(TextureUploadRegion)));
+    SDL_GPUTexture *texture = regions != NULL ? CreateTextureForImage(gpu_device, image) : NULL;
+    if (texture == NULL) {
+        SDL_free(regions);
+        if (release != NULL) {
+            release(userdata, image->data);
+        }
+        return NULL;
+    }
+
+    Uint64 offset = 0;
+    for (Uint32 layer = 0; layer < image->num_layers; layer++) {
+        for (Uint32 mip = 0; mip < image->num_mips; mip++) {
+            Uint32 mip_size = (Uint32)GetCompressedMipSize(image, mip);
+            regions[layer * image->num_mips + mip] = {
+                .offset = offset,
+                .size = mip_size,
+                .destination = {
+                    .texture = texture,
+                    .mip_level = mip,
+                    .layer = layer,
+                    .w = SDL_max(image->width >> mip, 1u),
+                    .h = SDL_max(image->height >> mip, 1u),
+                    .d = 1
+                }
+            };
+            offset += mip_size;
+        }
+    }
+    UploadTicket last_ticket = QueueTextureUploads(upload_manager, image->data, regions, count, release, userdata);
+    SDL_free(regions);
+    if (last_ticket == 0) {
+        SDL_ReleaseGPUTexture(gpu_device, texture);
+        return NULL;
+    }
+
+    if (ticket != NULL) {
+        *ticket = last_ticket;
+    }
+    return texture;
+}
+
+SDL_GPUTexture* LoadCompressedTexture(SDL_GPUDevice *gpu_device, const char *image_file_name, bool srgb)
+{
+    PROFILE_FUNCTION();
+    char full_path[256];
+    SDL_snprintf(full_path, sizeof(full_path), "%s../%s", SDL_GetBasePath(), image_file_name);
+
+    size_t file_size;
+    void *file_data = SDL_LoadFile(full_path, &file_size);
+    if (file_data == NULL) {
+        SDL_Log("Failed to load texture: %s", full_path);
+        return NULL;
+    }
+
+    CompressedImage image;
+    bool parsed;
+    if (SDL_strstr(image_file_name, ".dds")) {
+        parsed = ParseDDS(file_data, file_size, &image);
+    } else if (SDL_strstr(image_file_name, ".astc")) {
+        parsed = ParseASTC(file_data, file_size, srgb, &image);
+    } else {
+        parsed = SDL_SetError("Unknown compressed texture container");
+    }
+
+    SDL_GPUTexture *texture = NULL;
+    if (parsed) {
+        texture = CreateCompressedTexture(gpu_device, &image);
+    } else {
+        SDL_Log("Failed to parse %s: %s", full_path, SDL_GetError());
+    }
+
+    SDL_free(file_data);
+    return texture;
+}
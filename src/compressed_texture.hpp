@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <upload_manager.hpp>
+
+// DDS (BC1-BC7, DX10 extended header, uncompressed HDR) and ASTC container
+// parsing plus direct upload of the compressed blocks. The parsers only read
+// inside [data, data + size), never allocate and report failures through
+// SDL_SetError, so they can be run on arbitrary bytes without a GPU.
+
+typedef struct CompressedImage
+{
+    SDL_GPUTextureFormat format;
+    SDL_GPUTextureType type;    // 2D, 2D_ARRAY, CUBE or CUBE_ARRAY
+    Uint32 width;
+    Uint32 height;
+    Uint32 num_layers;          // Array elements times faces
+    Uint32 num_mips;
+    Uint32 block_width;         // 1x1 for uncompressed formats
+    Uint32 block_height;
+    Uint32 block_size;          // Bytes per block
+    const Uint8 *data;          // Points into the parsed file: every mip of layer 0, then layer 1, ...
+    Uint64 layer_size;
+    Uint64 data_size;           // layer_size * num_layers
+} CompressedImage;
+
+bool ParseDDS(const void *file_data, size_t file_size, CompressedImage *image);
+bool ParseASTC(const void *file_data, size_t file_size, bool srgb, CompressedImage *image);
+
+Uint64 GetCompressedMipSize(const CompressedImage *image, Uint32 mip);
+
+// Creates the texture and uploads every mip of every layer through a single
+// transfer buffer and copy pass. The image data is copied once, as-is.
+SDL_GPUTexture* CreateCompressedTexture(SDL_GPUDevice *gpu_device, const CompressedImage *image);
+
+// Same, but streamed through the upload manager. image->data must stay valid
+// until release is called, which happens on failure too (NULL is returned and
+// nothing was queued); the texture can be sampled once ticket completes.
+SDL_GPUTexture* StreamCompressedTexture(
+    SDL_GPUDevice *gpu_device,
+    UploadManager *upload_manager,
+    const CompressedImage *image,
+    UploadDataReleaseFunction release,
+    void *userdata,
+    UploadTicket *ticket
+);
+
+// .dds or .astc, relative to the assets root like LoadImage. ASTC files don't
+// record a colour space; srgb selects the _UNORM_SRGB format for them.
+SDL_GPUTexture* LoadCompressedTexture(SDL_GPUDevice *gpu_device, const char *image_file_name, bool srgb);
@@ -0,0 +1,885 @@
+#include <SDL3/SDL.h>
+#include <culling.hpp>
+
+#define CULL_INVALID SDL_MAX_UINT32
+#define CULL_MIN_CAPACITY 64
+#define CULL_STATIC_BIT 0x80000000u    // In the sparse index: the slot is in the static group
+#define CULL_LEAF_SIZE 16              // Objects per BVH leaf: two AVX2 batches
+#define CULL_BINS 16                   // SAH bins along the split axis
+#define CULL_SAH_MAX_DEPTH 40          // Deeper nodes split at the median so the tree stays shallow
+#define CULL_STACK_SIZE 128
+#define CULL_FLOAT_MAX 3.402823466e+38f
+
+typedef enum CullBoundsArray
+{
+    CULL_CENTER_X,
+    CULL_CENTER_Y,
+    CULL_CENTER_Z,
+    CULL_EXTENT_X,
+    CULL_EXTENT_Y,
+    CULL_EXTENT_Z,
+    CULL_RADIUS,
+    CULL_BOUNDS_COUNT
+} CullBoundsArray;
+
+typedef enum CullGroupIndex
+{
+    CULL_GROUP_DYNAMIC,
+    CULL_GROUP_STATIC,
+    CULL_GROUP_COUNT
+} CullGroupIndex;
+
+// Dense structure-of-arrays bounds. The static group is kept in BVH leaf order.
+typedef struct CullGroup
+{
+    Uint32 count;
+    Uint32 capacity;
+    float *bounds[CULL_BOUNDS_COUNT];
+    entt::entity *entities;
+} CullGroup;
+
+// Depth-first order: an interior node's first child is the next node, so
+// children always come after their parent.
+typedef struct CullNode
+{
+    float min[3];
+    float max[3];
+    Uint32 first;                   // Static objects [first, first + count) under this node
+    Uint32 count;
+    Uint32 right;                   // Second child; 0 for a leaf
+    Uint32 parent;                  // CULL_INVALID for the root
+} CullNode;
+
+struct CullWorld
+{
+    CullGroup groups[CULL_GROUP_COUNT];
+
+    // Entity index -> slot, with CULL_STATIC_BIT for the static group
+    Uint32 *sparse;
+    Uint32 sparse_capacity;
+
+    CullNode *nodes;
+    Uint32 num_nodes;
+    Uint32 node_capacity;
+    Uint32 *leaves;                 // Static slot -> its leaf, once built
+    Uint32 leaves_capacity;
+    Uint8 *node_dirty;              // Bounds below changed; refit at the next update
+
+    bool needs_build;
+    bool needs_refit;
+    CullStats stats;
+};
+
+// ---------------------------------------------------------------------------
+// Bounds
+// ---------------------------------------------------------------------------
+
+void ExtractFrustum(const float view_projection[16], Frustum *frustum)
+{
+    // Gribb-Hartmann: each plane is the last row of the matrix plus or minus another.
+    const float *m = view_projection;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            float row = m[j * 4 + i];
+            float last = m[j * 4 + 3];
+            frustum->planes[i * 2 + 0][j] = last + row;
+            frustum->planes[i * 2 + 1][j] = last - row;
+        }
+    }
+    for (int p = 0; p < 6; p++) {
+        float *plane = frustum->planes[p];
+        float length = SDL_sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        float scale = length > 0.0f ? 1.0f / length : 0.0f;
+        for (int j = 0; j < 4; j++) {
+            plane[j] *= scale;
+        }
+    }
+}
+
+static float GetBoundsRadius(const CullBounds *bounds)
+{
+    if (bounds->radius > 0.0f) {
+        return bounds->radius;
+    }
+    const float *e = bounds->extents;
+    return SDL_sqrtf(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+}
+
+void TransformCullBounds(const CullBounds *local, const float matrix[16], CullBounds *world)
+{
+    const float *c = local->center;
+    const float *e = local->extents;
+    float max_scale = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        world->center[i] = matrix[12 + i] + matrix[i] * c[0] + matrix[4 + i] * c[1] + matrix[8 + i] * c[2];
+        world->extents[i] = SDL_fabsf(matrix[i]) * e[0] + SDL_fabsf(matrix[4 + i]) * e[1] + SDL_fabsf(matrix[8 + i]) * e[2];
+        const float *column = matrix + i * 4;
+        max_scale = SDL_max(max_scale, column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+    }
+    world->radius = GetBoundsRadius(local) * SDL_sqrtf(max_scale);
+}
+
+// ---------------------------------------------------------------------------
+// Storage
+// ---------------------------------------------------------------------------
+
+static bool ReserveGroup(CullGroup *group, Uint32 capacity)
+{
+    if (capacity <= group->capacity) {
+        return true;
+    }
+    capacity = SDL_max(capacity, SDL_max(group->capacity * 2, (Uint32)CULL_MIN_CAPACITY));
+    for (int i = 0; i < CULL_BOUNDS_COUNT; i++) {
+        float *data = static_cast<float*>(SDL_realloc(group->bounds[i], capacity * sizeof(float)));
+        if (data == NULL) {
+            return false;
+        }
+        group->bounds[i] = data;
+    }
+    entt::entity *entities = static_cast<entt::entity*>(SDL_realloc(group->entities, capacity * sizeof(entt::entity)));
+    if (entities == NULL) {
+        return false;
+    }
+    group->entities = entities;
+    group->capacity = capacity;
+    return true;
+}
+
+static bool ReserveSparse(CullWorld *world, Uint32 index)
+{
+    if (index < world->sparse_capacity) {
+        return true;
+    }
+    Uint32 capacity = SDL_max(index + 1, SDL_max(world->sparse_capacity * 2, (Uint32)CULL_MIN_CAPACITY));
+    Uint32 *sparse = static_cast<Uint32*>(SDL_realloc(world->sparse, capacity * sizeof(Uint32)));
+    if (sparse == NULL) {
+        return false;
+    }
+    for (Uint32 i = world->sparse_capacity; i < capacity; i++) {
+        sparse[i] = CULL_INVALID;
+    }
+    world->sparse = sparse;
+    world->sparse_capacity = capacity;
+    return true;
+}
+
+// Returns the sparse entry (slot plus group bit) or CULL_INVALID.
+static Uint32 FindObject(const CullWorld *world, entt::entity entity)
+{
+    if (entity == entt::null) {
+        return CULL_INVALID;
+    }
+    Uint32 index = (Uint32)entt::to_entity(entity);
+    if (index >= world->sparse_capacity) {
+        return CULL_INVALID;
+    }
+    Uint32 entry = world->sparse[index];
+    if (entry == CULL_INVALID) {
+        return CULL_INVALID;
+    }
+    const CullGroup *group = &world->groups[(entry & CULL_STATIC_BIT) ? CULL_GROUP_STATIC : CULL_GROUP_DYNAMIC];
+    if (group->entities[entry & ~CULL_STATIC_BIT] != entity) {
+        return CULL_INVALID;
+    }
+    return entry;
+}
+
+static void WriteBounds(CullGroup *group, Uint32 slot, const CullBounds *bounds)
+{
+    group->bounds[CULL_CENTER_X][slot] = bounds->center[0];
+    group->bounds[CULL_CENTER_Y][slot] = bounds->center[1];
+    group->bounds[CULL_CENTER_Z][slot] = bounds->center[2];
+    group->bounds[CULL_EXTENT_X][slot] = bounds->extents[0];
+    group->bounds[CULL_EXTENT_Y][slot] = bounds->extents[1];
+    group->bounds[CULL_EXTENT_Z][slot] = bounds->extents[2];
+    group->bounds[CULL_RADIUS][slot] = GetBoundsRadius(bounds);
+}
+
+CullWorld* CreateCullWorld(Uint32 initial_capacity)
+{
+    CullWorld *world = static_cast<CullWorld*>(SDL_calloc(1, sizeof(CullWorld)));
+    if (world == NULL) {
+        return NULL;
+    }
+    if (!ReserveGroup(&world->groups[CULL_GROUP_DYNAMIC], initial_capacity)) {
+        DestroyCullWorld(world);
+        return NULL;
+    }
+    return world;
+}
+
+void DestroyCullWorld(CullWorld *world)
+{
+    if (world == NULL) {
+        return;
+    }
+    for (CullGroup &group : world->groups) {
+        for (int i = 0; i < CULL_BOUNDS_COUNT; i++) {
+            SDL_free(group.bounds[i]);
+        }
+        SDL_free(group.entities);
+    }
+    SDL_free(world->sparse);
+    SDL_free(world->nodes);
+    SDL_free(world->leaves);
+    SDL_free(world->node_dirty);
+    SDL_free(world);
+}
+
+bool AddCullObject(CullWorld *world, entt::entity entity, const CullBounds *bounds, bool is_static)
+{
+    if (entity == entt::null || FindObject(world, entity) != CULL_INVALID) {
+        return false;
+    }
+    Uint32 index = (Uint32)entt::to_entity(entity);
+    CullGroup *group = &world->groups[is_static ? CULL_GROUP_STATIC : CULL_GROUP_DYNAMIC];
+    if (!ReserveSparse(world, index) || !ReserveGroup(group, group->count + 1)) {
+        return false;
+    }
+    Uint32 slot = group->count++;
+    group->entities[slot] = entity;
+    WriteBounds(group, slot, bounds);
+    world->sparse[index] = slot | (is_static ? CULL_STATIC_BIT : 0);
+    world->needs_build = world->needs_build || is_static;
+    return true;
+}
+
+void RemoveCullObject(CullWorld *world, entt::entity entity)
+{
+    Uint32 entry = FindObject(world, entity);
+    if (entry == CULL_INVALID) {
+        return;
+    }
+    bool is_static = (entry & CULL_STATIC_BIT) != 0;
+    CullGroup *group = &world->groups[is_static ? CULL_GROUP_STATIC : CULL_GROUP_DYNAMIC];
+    Uint32 slot = entry & ~CULL_STATIC_BIT;
+    Uint32 last = --group->count;
+    if (slot != last) {
+        for (int i = 0; i < CULL_BOUNDS_COUNT; i++) {
+            group->bounds[i][slot] = group->bounds[i][last];
+        }
+        group->entities[slot] = group->entities[last];
+        world->sparse[entt::to_entity(group->entities[slot])] = slot | (is_static ? CULL_STATIC_BIT : 0);
+    }
+    world->sparse[entt::to_entity(entity)] = CULL_INVALID;
+    world->needs_build = world->needs_build || is_static;
+}
+
+bool HasCullObject(const CullWorld *world, entt::entity entity)
+{
+    return FindObject(world, entity) != CULL_INVALID;
+}
+
+bool SetCullBounds(CullWorld *world, entt::entity entity, const CullBounds *bounds)
+{
+    Uint32 entry = FindObject(world, entity);
+    if (entry == CULL_INVALID) {
+        return false;
+    }
+    if (!(entry & CULL_STATIC_BIT)) {
+        WriteBounds(&world->groups[CULL_GROUP_DYNAMIC], entry, bounds);
+        return true;
+    }
+    Uint32 slot = entry & ~CULL_STATIC_BIT;
+    WriteBounds(&world->groups[CULL_GROUP_STATIC], slot, bounds);
+    if (!world->needs_build) {
+        // Flag the path to the root; it stops where an earlier move already flagged it.
+        for (Uint32 node = world->leaves[slot]; node != CULL_INVALID && !world->node_dirty[node]; node = world->nodes[node].parent) {
+            world->node_dirty[node] = 1;
+        }
+        world->needs_refit = true;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// BVH
+// ---------------------------------------------------------------------------
+
+static float SurfaceArea(const float min[3], const float max[3])
+{
+    float x = max[0] - min[0], y = max[1] - min[1], z = max[2] - min[2];
+    return x * y + y * z + z * x;
+}
+
+static void GrowBox(float min[3], float max[3], const CullGroup *group, Uint32 slot)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        float center = group->bounds[CULL_CENTER_X + axis][slot];
+        float extent = group->bounds[CULL_EXTENT_X + axis][slot];
+        min[axis] = SDL_min(min[axis], center - extent);
+        max[axis] = SDL_max(max[axis], center + extent);
+    }
+}
+
+static void ResetBox(float min[3], float max[3])
+{
+    for (int axis = 0; axis < 3; axis++) {
+        min[axis] = CULL_FLOAT_MAX;
+        max[axis] = -CULL_FLOAT_MAX;
+    }
+}
+
+static void RefitNode(CullWorld *world, Uint32 index)
+{
+    CullNode *node = &world->nodes[index];
+    ResetBox(node->min, node->max);
+    if (node->right == 0) {
+        for (Uint32 i = node->first; i < node->first + node->count; i++) {
+            GrowBox(node->min, node->max, &world->groups[CULL_GROUP_STATIC], i);
+        }
+        return;
+    }
+    const CullNode *children[2] = { &world->nodes[index + 1], &world->nodes[node->right] };
+    for (const CullNode *child : children) {
+        for (int axis = 0; axis < 3; axis++) {
+            node->min[axis] = SDL_min(node->min[axis], child->min[axis]);
+            node->max[axis] = SDL_max(node->max[axis], child->max[axis]);
+        }
+    }
+}
+
+// Packed copy of a static object's bounds for the build, which permutes these
+// rather than chasing indices into the SoA arrays.
+typedef struct CullBuildItem
+{
+    float min[3];
+    float max[3];
+    float center[3];
+    Uint32 slot;
+} CullBuildItem;
+
+typedef struct CullBuild
+{
+    CullWorld *world;
+    CullBuildItem *items;
+    Uint32 depth;
+    bool failed;
+} CullBuild;
+
+static void SwapItems(CullBuildItem *items, Uint32 a, Uint32 b)
+{
+    CullBuildItem swap = items[a];
+    items[a] = items[b];
+    items[b] = swap;
+}
+
+// Quickselect: items[first, first + count) partitioned so the k-th smallest
+// center along axis is at first + k, smaller ones before it.
+static void SelectByCenter(CullBuildItem *items, Uint32 first, Uint32 count, int axis, Uint32 k)
+{
+    Uint32 lo = first, hi = first + count - 1, target = first + k;
+    while (lo < hi) {
+        float pivot = items[lo + (hi - lo) / 2].center[axis];
+        Uint32 i = lo, j = hi;
+        while (i <= j) {
+            while (items[i].center[axis] < pivot) {
+                i++;
+            }
+            while (items[j].center[axis] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                SwapItems(items, i, j);
+                i++;
+                if (j == 0) {
+                    break;
+                }
+                j--;
+            }
+        }
+        if (target <= j) {
+            hi = j;
+        } else if (target >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+}
+
+static Uint32 AllocateNode(CullWorld *world)
+{
+    if (world->num_nodes == world->node_capacity) {
+        Uint32 capacity = SDL_max(world->node_capacity * 2, (Uint32)CULL_MIN_CAPACITY);
+        CullNode *nodes = static_cast<CullNode*>(SDL_realloc(world->nodes, capacity * sizeof(CullNode)));
+        if (nodes == NULL) {
+            return CULL_INVALID;
+        }
+        world->nodes = nodes;
+        world->node_capacity = capacity;
+    }
+    return world->num_nodes++;
+}
+
+static void GrowBoxByBox(float min[3], float max[3], const float other_min[3], const float other_max[3])
+{
+    for (int axis = 0; axis < 3; axis++) {
+        min[axis] = SDL_min(min[axis], other_min[axis]);
+        max[axis] = SDL_max(max[axis], other_max[axis]);
+    }
+}
+
+static int GetBin(const CullBuildItem *item, int axis, float center_min, float bin_scale)
+{
+    return SDL_min((int)((item->center[axis] - center_min) * bin_scale), CULL_BINS - 1);
+}
+
+// Splits along the widest axis of the centers, at the best of CULL_BINS - 1
+// surface area heuristic planes, or at the median when that degenerates.
+static Uint32 PartitionObjects(CullBuild *build, Uint32 first, Uint32 count, Uint32 depth)
+{
+    CullBuildItem *items = build->items;
+    float center_min[3], center_max[3];
+    ResetBox(center_min, center_max);
+    for (Uint32 i = first; i < first + count; i++) {
+        GrowBoxByBox(center_min, center_max, items[i].center, items[i].center);
+    }
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (center_max[i] - center_min[i] > center_max[axis] - center_min[axis]) {
+            axis = i;
+        }
+    }
+    float width = center_max[axis] - center_min[axis];
+    Uint32 median = count / 2;
+    if (width <= 0.0f || depth >= CULL_SAH_MAX_DEPTH) {
+        SelectByCenter(items, first, count, axis, median);
+        return median;
+    }
+
+    Uint32 bin_counts[CULL_BINS] = {};
+    float bin_min[CULL_BINS][3], bin_max[CULL_BINS][3];
+    for (int b = 0; b < CULL_BINS; b++) {
+        ResetBox(bin_min[b], bin_max[b]);
+    }
+    float bin_scale = CULL_BINS / width;
+    for (Uint32 i = first; i < first + count; i++) {
+        int b = GetBin(&items[i], axis, center_min[axis], bin_scale);
+        bin_counts[b]++;
+        GrowBoxByBox(bin_min[b], bin_max[b], items[i].min, items[i].max);
+    }
+
+    // Sweep from the right for the right-hand costs, then from the left to pick the split.
+    float right_area[CULL_BINS];
+    Uint32 right_count[CULL_BINS];
+    float sweep_min[3], sweep_max[3];
+    ResetBox(sweep_min, sweep_max);
+    Uint32 sweep_count = 0;
+    for (int b = CULL_BINS - 1; b > 0; b--) {
+        GrowBoxByBox(sweep_min, sweep_max, bin_min[b], bin_max[b]);
+        sweep_count += bin_counts[b];
+        right_area[b] = sweep_count > 0 ? SurfaceArea(sweep_min, sweep_max) : 0.0f;
+        right_count[b] = sweep_count;
+    }
+    ResetBox(sweep_min, sweep_max);
+    sweep_count = 0;
+    int best_split = -1;
+    float best_cost = 0.0f;
+    for (int b = 1; b < CULL_BINS; b++) {
+        GrowBoxByBox(sweep_min, sweep_max, bin_min[b - 1], bin_max[b - 1]);
+        sweep_count += bin_counts[b - 1];
+        if (sweep_count == 0 || right_count[b] == 0) {
+            continue;
+        }
+        float cost = SurfaceArea(sweep_min, sweep_max) * sweep_count + right_area[b] * right_count[b];
+        if (best_split < 0 || cost < best_cost) {
+            best_split = b;
+            best_cost = cost;
+        }
+    }
+    if (best_split < 0) {
+        SelectByCenter(items, first, count, axis, median);
+        return median;
+    }
+
+    Uint32 i = first, j = first + count;
+    while (i < j) {
+        if (GetBin(&items[i], axis, center_min[axis], bin_scale) < best_split) {
+            i++;
+        } else {
+            SwapItems(items, i, --j);
+        }
+    }
+    return i - first;
+}
+
+static Uint32 BuildNode(CullBuild *build, Uint32 first, Uint32 count, Uint32 parent, Uint32 depth)
+{
+    CullWorld *world = build->world;
+    Uint32 index = AllocateNode(world);
+    if (index == CULL_INVALID) {
+        build->failed = true;
+        return CULL_INVALID;
+    }
+    build->depth = SDL_max(build->depth, depth);
+    CullNode *node = &world->nodes[index];
+    node->first = first;
+    node->count = count;
+    node->right = 0;
+    node->parent = parent;
+
+    if (count > CULL_LEAF_SIZE) {
+        Uint32 left_count = PartitionObjects(build, first, count, depth);
+        BuildNode(build, first, left_count, index, depth + 1);
+        Uint32 right = BuildNode(build, first + left_count, count - left_count, index, depth + 1);
+        if (build->failed) {
+            return CULL_INVALID;
+        }
+        world->nodes[index].right = right;
+    }
+    return index;
+}
+
+static bool BuildBVH(CullWorld *world)
+{
+    CullGroup *group = &world->groups[CULL_GROUP_STATIC];
+    world->num_nodes = 0;
+    world->needs_build = false;
+    world->needs_refit = false;
+    world->stats.bvh_depth = 0;
+    if (group->count == 0) {
+        return true;
+    }
+
+    if (world->leaves_capacity < group->count) {
+        Uint32 *leaves = static_cast<Uint32*>(SDL_realloc(world->leaves, group->capacity * sizeof(Uint32)));
+        if (leaves == NULL) {
+            world->needs_build = true;
+            return false;
+        }
+        world->leaves = leaves;
+        world->leaves_capacity = group->capacity;
+    }
+    // Items double as scratch for reordering the arrays afterwards.
+    CullBuildItem *items = static_cast<CullBuildItem*>(SDL_malloc(group->count * sizeof(CullBuildItem)));
+    void *scratch = SDL_malloc(group->count * SDL_max(sizeof(float), sizeof(entt::entity)));
+    if (items == NULL || scratch == NULL) {
+        SDL_free(items);
+        SDL_free(scratch);
+        world->needs_build = true;
+        return false;
+    }
+    for (Uint32 slot = 0; slot < group->count; slot++) {
+        CullBuildItem *item = &items[slot];
+        for (int axis = 0; axis < 3; axis++) {
+            float center = group->bounds[CULL_CENTER_X + axis][slot];
+            float extent = group->bounds[CULL_EXTENT_X + axis][slot];
+            item->min[axis] = center - extent;
+            item->max[axis] = center + extent;
+            item->center[axis] = center;
+        }
+        item->slot = slot;
+    }
+
+    CullBuild build = { world, items, 0, false };
+    BuildNode(&build, 0, group->count, CULL_INVALID, 0);
+    Uint8 *node_dirty = build.failed ? NULL : static_cast<Uint8*>(SDL_realloc(world->node_dirty, world->node_capacity));
+    if (node_dirty == NULL) {
+        SDL_free(items);
+        SDL_free(scratch);
+        world->num_nodes = 0;
+        world->needs_build = true;
+        return false;
+    }
+    world->node_dirty = node_dirty;
+    SDL_memset(node_dirty, 0, world->num_nodes);
+
+    // Objects move into leaf order so every subtree is one contiguous run.
+    float *floats = static_cast<float*>(scratch);
+    for (int i = 0; i < CULL_BOUNDS_COUNT; i++) {
+        for (Uint32 slot = 0; slot < group->count; slot++) {
+            floats[slot] = group->bounds[i][items[slot].slot];
+        }
+        SDL_memcpy(group->bounds[i], floats, group->count * sizeof(float));
+    }
+    entt::entity *entities = static_cast<entt::entity*>(scratch);
+    for (Uint32 slot = 0; slot < group->count; slot++) {
+        entities[slot] = group->entities[items[slot].slot];
+    }
+    SDL_memcpy(group->entities, entities, group->count * sizeof(entt::entity));
+    for (Uint32 slot = 0; slot < group->count; slot++) {
+        world->sparse[entt::to_entity(group->entities[slot])] = slot | CULL_STATIC_BIT;
+    }
+
+    for (Uint32 index = world->num_nodes; index-- > 0;) {
+        RefitNode(world, index);
+        const CullNode *node = &world->nodes[index];
+        if (node->right == 0) {
+            for (Uint32 slot = node->first; slot < node->first + node->count; slot++) {
+                world->leaves[slot] = index;
+            }
+        }
+    }
+    world->stats.bvh_depth = build.depth + 1;
+    world->stats.builds++;
+    SDL_free(items);
+    SDL_free(scratch);
+    return true;
+}
+
+void UpdateCullWorld(CullWorld *world)
+{
+    if (world->needs_build) {
+        if (!BuildBVH(world)) {
+            SDL_Log("Out of memory building the culling BVH for %u objects", world->groups[CULL_GROUP_STATIC].count);
+        }
+        return;
+    }
+    if (world->needs_refit) {
+        // Children come after their parents, so one backwards pass refits bottom-up.
+        for (Uint32 index = world->num_nodes; index-- > 0;) {
+            if (world->node_dirty[index]) {
+                RefitNode(world, index);
+                world->node_dirty[index] = 0;
+            }
+        }
+        world->needs_refit = false;
+        world->stats.refits++;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Plane tests
+// ---------------------------------------------------------------------------
+
+// The planes a range is tested against, with their absolute normals for the
+// AABB's projected extent. An object is culled when
+// dot(n, center) + d + min(radius, dot(|n|, extents)) < 0 for any of them.
+typedef struct CullPlanes
+{
+    float planes[6][4];
+    float abs_normals[6][3];
+    int count;
+} CullPlanes;
+
+static Uint32 CullRangeScalar(const CullGroup *group, Uint32 first, Uint32 last, const CullPlanes *planes, entt::entity *visible)
+{
+    float *const *b = group->bounds;
+    Uint32 count = 0;
+    for (Uint32 i = first; i < last; i++) {
+        bool inside = true;
+        for (int p = 0; p < planes->count && inside; p++) {
+            const float *n = planes->planes[p];
+            const float *a = planes->abs_normals[p];
+            float distance = ((n[0] * b[CULL_CENTER_X][i] + n[1] * b[CULL_CENTER_Y][i]) + n[2] * b[CULL_CENTER_Z][i]) + n[3];
+            float extent = (a[0] * b[CULL_EXTENT_X][i] + a[1] * b[CULL_EXTENT_Y][i]) + a[2] * b[CULL_EXTENT_Z][i];
+            inside = distance + SDL_min(b[CULL_RADIUS][i], extent) >= 0.0f;
+        }
+        visible[count] = group->entities[i];
+        count += inside;
+    }
+    return count;
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static Uint32 CullRangeSSE2(const CullGroup *group, Uint32 first, Uint32 last, const CullPlanes *planes, entt::entity *visible)
+{
+    float *const *b = group->bounds;
+    const __m128 zero = _mm_setzero_ps();
+    Uint32 count = 0;
+    Uint32 i = first;
+    for (; i + 4 <= last; i += 4) {
+        __m128 cx = _mm_loadu_ps(b[CULL_CENTER_X] + i);
+        __m128 cy = _mm_loadu_ps(b[CULL_CENTER_Y] + i);
+        __m128 cz = _mm_loadu_ps(b[CULL_CENTER_Z] + i);
+        __m128 ex = _mm_loadu_ps(b[CULL_EXTENT_X] + i);
+        __m128 ey = _mm_loadu_ps(b[CULL_EXTENT_Y] + i);
+        __m128 ez = _mm_loadu_ps(b[CULL_EXTENT_Z] + i);
+        __m128 radius = _mm_loadu_ps(b[CULL_RADIUS] + i);
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < planes->count; p++) {
+            const float *n = planes->planes[p];
+            const float *a = planes->abs_normals[p];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), cx), _mm_mul_ps(_mm_set1_ps(n[1]), cy)),
+                                                    _mm_mul_ps(_mm_set1_ps(n[2]), cz)), _mm_set1_ps(n[3]));
+            __m128 extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[0]), ex), _mm_mul_ps(_mm_set1_ps(a[1]), ey)),
+                                       _mm_mul_ps(_mm_set1_ps(a[2]), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(radius, extent)), zero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; lane++) {
+            visible[count] = group->entities[i + lane];
+            count += (mask >> lane) & 1;
+        }
+    }
+    return count + CullRangeScalar(group, i, last, planes, visible + count);
+}
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+SDL_TARGETING("avx2")
+static Uint32 CullRangeAVX2(const CullGroup *group, Uint32 first, Uint32 last, const CullPlanes *planes, entt::entity *visible)
+{
+    float *const *b = group->bounds;
+    const __m256 zero = _mm256_setzero_ps();
+    Uint32 count = 0;
+    Uint32 i = first;
+    for (; i + 8 <= last; i += 8) {
+        __m256 cx = _mm256_loadu_ps(b[CULL_CENTER_X] + i);
+        __m256 cy = _mm256_loadu_ps(b[CULL_CENTER_Y] + i);
+        __m256 cz = _mm256_loadu_ps(b[CULL_CENTER_Z] + i);
+        __m256 ex = _mm256_loadu_ps(b[CULL_EXTENT_X] + i);
+        __m256 ey = _mm256_loadu_ps(b[CULL_EXTENT_Y] + i);
+        __m256 ez = _mm256_loadu_ps(b[CULL_EXTENT_Z] + i);
+        __m256 radius = _mm256_loadu_ps(b[CULL_RADIUS] + i);
+        __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for (int p = 0; p < planes->count; p++) {
+            const float *n = planes->planes[p];
+            const float *a = planes->abs_normals[p];
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[0]), cx),
+                                                                        _mm256_mul_ps(_mm256_set1_ps(n[1]), cy)),
+                                                          _mm256_mul_ps(_mm256_set1_ps(n[2]), cz)), _mm256_set1_ps(n[3]));
+            __m256 extent = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a[0]), ex), _mm256_mul_ps(_mm256_set1_ps(a[1]), ey)),
+                                          _mm256_mul_ps(_mm256_set1_ps(a[2]), ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(radius, extent)), zero, _CMP_GE_OQ));
+        }
+        // Branch-free compaction: every lane is written, only visible ones advance.
+        int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; lane++) {
+            visible[count] = group->entities[i + lane];
+            count += (mask >> lane) & 1;
+        }
+    }
+    // GCC doesn't always clear the upper halves on the way out of a target("avx2")
+    // function, and the SSE code that runs between small leaves then pays for it.
+    _mm256_zeroupper();
+#ifdef SDL_SSE2_INTRINSICS
+    // Leaves are often not a multiple of 8; SSE2 takes the next 4.
+    return count + CullRangeSSE2(group, i, last, planes, visible + count);
+#else
+    return count + CullRangeScalar(group, i, last, planes, visible + count);
+#endif
+}
+#endif
+
+static Uint32 CullRange(const CullGroup *group, Uint32 first, Uint32 last, const CullPlanes *planes, CullPath path, entt::entity *visible)
+{
+    switch (path) {
+#ifdef SDL_AVX2_INTRINSICS
+        case CULL_AVX2: return CullRangeAVX2(group, first, last, planes, visible);
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+        case CULL_SSE2: return CullRangeSSE2(group, first, last, planes, visible);
+#endif
+        default: return CullRangeScalar(group, first, last, planes, visible);
+    }
+}
+
+static void SelectPlanes(const Frustum *frustum, Uint32 mask, CullPlanes *planes)
+{
+    planes->count = 0;
+    for (int p = 0; p < 6; p++) {
+        if (mask & (1u << p)) {
+            for (int j = 0; j < 4; j++) {
+                planes->planes[planes->count][j] = frustum->planes[p][j];
+            }
+            for (int j = 0; j < 3; j++) {
+                planes->abs_normals[planes->count][j] = SDL_fabsf(frustum->planes[p][j]);
+            }
+            planes->count++;
+        }
+    }
+}
+
+CullPath ResolveCullPath(CullPath path)
+{
+#ifdef SDL_AVX2_INTRINSICS
+    if ((path == CULL_AUTO || path == CULL_AVX2) && SDL_HasAVX2()) {
+        return CULL_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if ((path == CULL_AUTO || path == CULL_AVX2 || path == CULL_SSE2) && SDL_HasSSE2()) {
+        return CULL_SSE2;
+    }
+#endif
+    return CULL_SCALAR;
+}
+
+Uint32 CullFrustum(const CullWorld *world, const Frustum *frustum, CullPath path, entt::entity *visible, CullViewStats *stats)
+{
+    path = ResolveCullPath(path);
+    CullViewStats view_stats;
+    SDL_zero(view_stats);
+    CullPlanes all_planes;
+    SelectPlanes(frustum, 0x3F, &all_planes);
+
+    const CullGroup *dynamic_group = &world->groups[CULL_GROUP_DYNAMIC];
+    Uint32 count = CullRange(dynamic_group, 0, dynamic_group->count, &all_planes, path, visible);
+    view_stats.tested += dynamic_group->count;
+
+    // Stale boxes could cull something visible; test every static object instead.
+    const CullGroup *static_group = &world->groups[CULL_GROUP_STATIC];
+    if (world->needs_build || world->needs_refit) {
+        count += CullRange(static_group, 0, static_group->count, &all_planes, path, visible + count);
+        view_stats.tested += static_group->count;
+    } else if (world->num_nodes > 0) {
+        // Each entry carries the planes its node still straddles.
+        Uint32 stack[CULL_STACK_SIZE][2];
+        int top = 0;
+        stack[top][0] = 0;
+        stack[top][1] = 0x3F;
+        top++;
+        while (top > 0) {
+            top--;
+            const CullNode *node = &world->nodes[stack[top][0]];
+            Uint32 mask = stack[top][1];
+            view_stats.nodes_visited++;
+
+            bool outside = false;
+            for (int p = 0; p < 6 && !outside; p++) {
+                if (!(mask & (1u << p))) {
+                    continue;
+                }
+                const float *n = frustum->planes[p];
+                float distance = n[3], extent = 0.0f;
+                for (int axis = 0; axis < 3; axis++) {
+                    distance += n[axis] * (node->min[axis] + node->max[axis]) * 0.5f;
+                    extent += SDL_fabsf(n[axis]) * (node->max[axis] - node->min[axis]) * 0.5f;
+                }
+                if (distance + extent < 0.0f) {
+                    outside = true;
+                } else if (distance - extent >= 0.0f) {
+                    mask &= ~(1u << p);
+                }
+            }
+            if (outside) {
+                continue;
+            }
+            if (mask == 0) {
+                SDL_memcpy(visible + count, static_group->entities + node->first, node->count * sizeof(entt::entity));
+                count += node->count;
+                view_stats.nodes_inside++;
+            } else if (node->right == 0) {
+                CullPlanes planes;
+                SelectPlanes(frustum, mask, &planes);
+                count += CullRange(static_group, node->first, node->first + node->count, &planes, path, visible + count);
+                view_stats.tested += node->count;
+            } else {
+                Uint32 index = (Uint32)(node - world->nodes);
+                stack[top][0] = node->right;
+                stack[top][1] = mask;
+                stack[top + 1][0] = index + 1;
+                stack[top + 1][1] = mask;
+                top += 2;
+            }
+        }
+    }
+
+    view_stats.visible = count;
+    if (stats != NULL) {
+        *stats = view_stats;
+    }
+    return count;
+}
+
+CullStats GetCullStats(const CullWorld *world)
+{
+    CullStats stats = world->stats;
+    stats.dynamic_count = world->groups[CULL_GROUP_DYNAMIC].count;
+    stats.static_count = world->groups[CULL_GROUP_STATIC].count;
+    stats.count = stats.dynamic_count + stats.static_count;
+    stats.bvh_nodes = world->num_nodes;
+    return stats;
+}
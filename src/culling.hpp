@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <entt/entt.hpp>
+
+// Frustum culling for registry entities. Every object has an AABB (center and
+// half extents) and a bounding sphere around the same center, stored
+// structure-of-arrays and tested against the six planes 8 (AVX2) or 4 (SSE2)
+// at a time; an object is culled if either volume is fully outside a plane.
+//
+// Dynamic objects are tested brute force every view. Static objects sit in a
+// BVH whose leaves hold contiguous runs of the arrays: subtrees outside the
+// frustum are skipped, subtrees fully inside are copied out without tests,
+// and leaves on the boundary only test the planes they straddle. Moving a
+// static object refits the boxes above it; adding or removing one rebuilds
+// the tree at the next update.
+//
+// CullFrustum only reads the world, so several views may cull at once.
+
+typedef enum CullPath
+{
+    CULL_AUTO,                  // Best path the CPU supports
+    CULL_SCALAR,
+    CULL_SSE2,
+    CULL_AVX2
+} CullPath;
+
+// Normalised planes a, b, c, d facing inwards: a point is inside all of them
+// when a*x + b*y + c*z + d >= 0. Order: left, right, bottom, top, near, far.
+typedef struct Frustum
+{
+    float planes[6][4];
+} Frustum;
+
+typedef struct CullBounds
+{
+    float center[3];
+    float extents[3];           // Half size of the AABB
+    float radius;               // Sphere around center; 0 takes the AABB's corner distance
+} CullBounds;
+
+typedef struct CullStats
+{
+    Uint32 count;
+    Uint32 static_count;
+    Uint32 dynamic_count;
+    Uint32 bvh_nodes;
+    Uint32 bvh_depth;
+    Uint32 builds;              // Full BVH builds after static adds/removes
+    Uint32 refits;              // Updates that refit moved static objects
+} CullStats;
+
+typedef struct CullViewStats
+{
+    Uint32 tested;              // Objects tested individually
+    Uint32 visible;
+    Uint32 nodes_visited;
+    Uint32 nodes_inside;        // Subtrees accepted without testing their objects
+} CullViewStats;
+
+typedef struct CullWorld CullWorld;
+
+// From a column-major (glm) view-projection matrix with OpenGL clip depth,
+// -w <= z <= w, as glm::perspective builds it.
+void ExtractFrustum(const float view_projection[16], Frustum *frustum);
+// World bounds of local bounds under a column-major affine matrix.
+void TransformCullBounds(const CullBounds *local, const float matrix[16], CullBounds *world);
+
+CullWorld* CreateCullWorld(Uint32 initial_capacity);
+void DestroyCullWorld(CullWorld *world);
+
+// Static objects are expected to move rarely if at all.
+bool AddCullObject(CullWorld *world, entt::entity entity, const CullBounds *bounds, bool is_static);
+void RemoveCullObject(CullWorld *world, entt::entity entity);
+bool HasCullObject(const CullWorld *world, entt::entity entity);
+bool SetCullBounds(CullWorld *world, entt::entity entity, const CullBounds *bounds);
+
+// Rebuilds or refits the BVH after changes. Call before culling.
+void UpdateCullWorld(CullWorld *world);
+
+// Writes the visible entities to visible, which needs room for every object,
+// and returns how many. All paths produce the same set. stats may be NULL.
+Uint32 CullFrustum(const CullWorld *world, const Frustum *frustum, CullPath path, entt::entity *visible, CullViewStats *stats);
+
+CullStats GetCullStats(const CullWorld *world);
+CullPath ResolveCullPath(CullPath path);
@@ -0,0 +1,113 @@
+#include <SDL3/SDL.h>
+#include <fixed_timestep.hpp>
+#include <profiler.hpp>
+
+#define FIXED_TIMESTEP_UNIT 1000000000ull     // Accumulator units per tick
+#define FIXED_TIMESTEP_SMOOTHING 0.05
+#define FIXED_TIMESTEP_SNAP_NS 200000         // Frame times this close to whole ticks count as whole ticks
+
+void InitFixedTimestep(FixedTimestep *timestep, Uint32 hz, Uint32 max_ticks_per_frame)
+{
+    SDL_zerop(timestep);
+    timestep->hz = SDL_max(hz, 1u);
+    timestep->max_ticks_per_frame = SDL_max(max_ticks_per_frame, 1u);
+    timestep->stats.hz = timestep->hz;
+}
+
+Uint32 AccumulateFixedTimestep(FixedTimestep *timestep, Uint64 elapsed_ns)
+{
+    FixedTimestepStats *stats = &timestep->stats;
+    stats->frame_ms = elapsed_ns / 1e6;
+
+    // A frame longer than the cap allows can't be caught up anyway; clamping
+    // first also keeps ns * hz far from overflowing after a long stall
+    Uint64 limit_ns = (Uint64)(timestep->max_ticks_per_frame + 1) * FIXED_TIMESTEP_UNIT / timestep->hz;
+    Uint64 dropped_ns = elapsed_ns > limit_ns ? elapsed_ns - limit_ns : 0;
+    Uint64 units = (elapsed_ns - dropped_ns) * timestep->hz;
+
+    // A 60 Hz display measures 16.666 or 16.667 ms frames around exactly two
+    // 120 Hz ticks, which would alternate 1, 2 and 3 ticks a frame and judder.
+    // What snapping adds or removes is carried, and paid back before it adds
+    // up to more than the tolerance, so ticks stay that close to the clock.
+    Sint64 owed = (Sint64)units + timestep->snap_error;
+    Sint64 whole = (Sint64)((units + FIXED_TIMESTEP_UNIT / 2) / FIXED_TIMESTEP_UNIT * FIXED_TIMESTEP_UNIT);
+    Sint64 snap = (Sint64)FIXED_TIMESTEP_SNAP_NS * timestep->hz;
+    if (whole > 0 && owed - whole < snap && whole - owed < snap) {
+        units = (Uint64)whole;
+        timestep->snap_error = owed - whole;
+    } else {
+        units = (Uint64)SDL_max(owed, (Sint64)0);
+        timestep->snap_error = SDL_min(owed, (Sint64)0);
+    }
+    timestep->accumulator += units;
+
+    Uint64 due = timestep->accumulator / FIXED_TIMESTEP_UNIT;
+    Uint64 dropped = dropped_ns * timestep->hz / FIXED_TIMESTEP_UNIT;
+    if (due > timestep->max_ticks_per_frame) {
+        dropped += due - timestep->max_ticks_per_frame;
+        due = timestep->max_ticks_per_frame;
+    }
+    // The fraction of a tick left over stays, whatever was dropped
+    timestep->accumulator %= FIXED_TIMESTEP_UNIT;
+    if (dropped > 0) {
+        stats->dropped_ticks += dropped;
+        stats->capped_frames++;
+    }
+    stats->ticks_last_frame = (Uint32)due;
+    return (Uint32)due;
+}
+
+void SetFixedTickClock(FixedTimestep *timestep, Uint64 frame_ns)
+{
+    // The last tick due ends where the leftover fraction of a tick begins
+    Uint64 period_ns = FIXED_TIMESTEP_UNIT / timestep->hz;
+    Uint64 remainder_ns = timestep->accumulator / timestep->hz;
+    timestep->tick_end_ns = frame_ns + period_ns - remainder_ns - (Uint64)timestep->stats.ticks_last_frame * period_ns;
+}
+
+void RunFixedTicks(FixedTimestep *timestep, Uint32 count, FixedTickFunction fn, void *userdata)
+{
+    FixedTimestepStats *stats = &timestep->stats;
+    double dt = GetFixedTimestepDelta(timestep);
+    for (Uint32 i = 0; i < count; i++) {
+        PROFILE_ZONE("Tick");
+        Uint64 start = SDL_GetTicksNS();
+        fn(timestep->next_tick++, dt, userdata);
+        double elapsed_ms = (SDL_GetTicksNS() - start) / 1e6;
+        timestep->tick_end_ns += FIXED_TIMESTEP_UNIT / timestep->hz;
+
+        stats->ticks++;
+        stats->tick_ms = elapsed_ms;
+        stats->tick_average_ms = stats->tick_average_ms == 0.0 ? elapsed_ms
+                               : stats->tick_average_ms + (elapsed_ms - stats->tick_average_ms) * FIXED_TIMESTEP_SMOOTHING;
+        stats->tick_max_ms = SDL_max(stats->tick_max_ms, elapsed_ms);
+    }
+}
+
+float GetFixedTimestepAlpha(const FixedTimestep *timestep)
+{
+    return (float)((double)timestep->accumulator / FIXED_TIMESTEP_UNIT);
+}
+
+void InterpolateWorldMatrix(const float previous[16], const float current[16], float alpha, float matrix[16])
+{
+    for (int column = 0; column < 3; column++) {
+        const float *a = &previous[column * 4], *b = &current[column * 4];
+        float *out = &matrix[column * 4];
+        float length_a = SDL_sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+        float length_b = SDL_sqrtf(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+        for (int row = 0; row < 4; row++) {
+            out[row] = a[row] + (b[row] - a[row]) * alpha;
+        }
+        float length = SDL_sqrtf(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+        if (length > 0.0f) {
+            float scale = (length_a + (length_b - length_a) * alpha) / length;
+            out[0] *= scale;
+            out[1] *= scale;
+            out[2] *= scale;
+        }
+    }
+    for (int row = 0; row < 4; row++) {
+        matrix[12 + row] = previous[12 + row] + (current[12 + row] - previous[12 + row]) * alpha;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Fixed-rate simulation ticks decoupled from the render rate. Each frame adds
+// its elapsed time; whole ticks' worth of it is simulated, the remainder
+// carries over and becomes the alpha rendering interpolates with, between
+// the last two ticks' states. Time is kept as nanoseconds times the tick rate,
+// so 60 or 120 Hz ticks are exact and never drift.
+//
+// A tick's outcome depends only on its index and the state before it, so
+// every render rate produces the same sequence of states. When ticks cost
+// more than they simulate, the backlog would grow every frame (the spiral of
+// death); past max_ticks_per_frame the remaining backlog is dropped instead,
+// and the game runs slow rather than freezing.
+
+typedef void (*FixedTickFunction)(Uint64 tick, double dt, void *userdata);
+
+typedef struct FixedTimestepStats
+{
+    Uint32 hz;
+    Uint64 ticks;               // Run since init
+    Uint32 ticks_last_frame;    // Due at the last AccumulateFixedTimestep
+    double tick_ms;             // Last tick
+    double tick_average_ms;     // Exponential moving average
+    double tick_max_ms;
+    double frame_ms;            // Elapsed time the last frame added
+    Uint64 dropped_ticks;       // Skipped by the per-frame cap
+    Uint32 capped_frames;
+} FixedTimestepStats;
+
+typedef struct FixedTimestep
+{
+    Uint32 hz;
+    Uint32 max_ticks_per_frame;
+    Uint64 accumulator;         // Unsimulated time in ns * hz; a tick is 1e9 of it
+    Sint64 snap_error;          // Measured time snapping has yet to add back, in the same units
+    Uint64 next_tick;
+    Uint64 tick_end_ns;         // Wall time the running tick, or else the next, ends at; see SetFixedTickClock
+    FixedTimestepStats stats;
+} FixedTimestep;
+
+void InitFixedTimestep(FixedTimestep *timestep, Uint32 hz, Uint32 max_ticks_per_frame);
+
+// Adds a frame's elapsed time and returns how many ticks are due, at most
+// max_ticks_per_frame. The time beyond that is dropped.
+Uint32 AccumulateFixedTimestep(FixedTimestep *timestep, Uint64 elapsed_ns);
+
+// Places the ticks just made due on the wall clock: frame_ns is the time the
+// frame's elapsed time was measured to. Each tick's end time is then in
+// tick_end_ns while it runs, for picking up the timestamped input it covers.
+void SetFixedTickClock(FixedTimestep *timestep, Uint64 frame_ns);
+
+// Runs count ticks through fn with the fixed dt, timing each. May be called
+// from another thread than AccumulateFixedTimestep, but not concurrently with it.
+void RunFixedTicks(FixedTimestep *timestep, Uint32 count, FixedTickFunction fn, void *userdata);
+
+// How far rendering is between the last two ticks, in [0, 1).
+float GetFixedTimestepAlpha(const FixedTimestep *timestep);
+static inline double GetFixedTimestepDelta(const FixedTimestep *timestep)
+{
+    return 1.0 / timestep->hz;
+}
+
+// Column-major 4x4 world matrices of the last two ticks. Translation is
+// interpolated linearly; each basis column is interpolated and rescaled to its
+// interpolated length, so a spinning object doesn't shrink mid-tick. Good for
+// rotations under a quarter turn per tick.
+void InterpolateWorldMatrix(const float previous[16], const float current[16], float alpha, float matrix[16]);
@@ -0,0 +1,286 @@
+#include <SDL3/SDL.h>
+#include <frame_allocator.hpp>
+
+// The arena base is cache-line aligned so small alignments never waste a line.
+#define FRAME_ARENA_BASE_ALIGNMENT 64
+
+typedef struct FrameSlot
+{
+    FrameArena arena;
+    Uint32 gpu_offset;              // Start of this slot's region in the buffer
+    Uint32 gpu_used;
+    Uint32 gpu_flushed;             // Bytes already copied to the buffer
+    SDL_GPUFence *fence;            // Of the last frame submitted from this slot
+} FrameSlot;
+
+struct FrameAllocator
+{
+    SDL_GPUDevice *gpu_device;
+    SDL_GPUBuffer *buffer;
+    SDL_GPUTransferBuffer *transfer_buffer;
+    Uint8 *mapped;                  // Transfer buffer while mapped, or the headless region
+    Uint8 *headless;                // Stands in for the buffer without a device
+
+    FrameSlot slots[FRAME_ALLOCATOR_MAX_FRAMES];
+    Uint32 num_slots;
+    Uint32 current;
+    Uint32 gpu_region_size;
+    bool begun;
+
+    Uint64 frames;
+    size_t cpu_last_frame;
+    size_t cpu_high_water;
+    Uint32 gpu_last_frame;
+    Uint32 gpu_high_water;
+    Uint32 failures;
+    Uint32 fence_waits;
+};
+
+bool InitFrameArena(FrameArena *arena, size_t capacity)
+{
+    SDL_zerop(arena);
+    if (capacity == 0) {
+        return true;
+    }
+    arena->base = static_cast<Uint8*>(SDL_aligned_alloc(FRAME_ARENA_BASE_ALIGNMENT, capacity));
+    if (arena->base == NULL) {
+        return false;
+    }
+    arena->capacity = capacity;
+    return true;
+}
+
+void FreeFrameArena(FrameArena *arena)
+{
+    SDL_aligned_free(arena->base);
+    SDL_zerop(arena);
+}
+
+void* FrameArenaAlloc(FrameArena *arena, size_t size, size_t alignment)
+{
+    SDL_assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    // Align the address rather than the offset so alignments above the base's still hold.
+    uintptr_t base = (uintptr_t)arena->base;
+    uintptr_t start = (base + arena->used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t offset = start - base;
+    if (offset > arena->capacity || size > arena->capacity - offset) {
+        return NULL;
+    }
+    arena->used = offset + size;
+    return arena->base + offset;
+}
+
+FrameAllocator* CreateFrameAllocator(SDL_GPUDevice *gpu_device, Uint32 frames_in_flight, size_t cpu_bytes_per_frame, Uint32 gpu_bytes_per_frame)
+{
+    if (frames_in_flight == 0 || frames_in_flight > FRAME_ALLOCATOR_MAX_FRAMES) {
+        SDL_SetError("Frame allocator supports 1 to %d frames in flight", FRAME_ALLOCATOR_MAX_FRAMES);
+        return NULL;
+    }
+
+    FrameAllocator *allocator = static_cast<FrameAllocator*>(SDL_calloc(1, sizeof(FrameAllocator)));
+    if (allocator == NULL) {
+        return NULL;
+    }
+    allocator->gpu_device = gpu_device;
+    allocator->num_slots = frames_in_flight;
+    allocator->gpu_region_size = (gpu_bytes_per_frame + FRAME_BUFFER_ALIGNMENT - 1) & ~(Uint32)(FRAME_BUFFER_ALIGNMENT - 1);
+    Uint32 gpu_size = allocator->gpu_region_size * frames_in_flight;
+
+    for (Uint32 i = 0; i < frames_in_flight; i++) {
+        if (!InitFrameArena(&allocator->slots[i].arena, cpu_bytes_per_frame)) {
+            DestroyFrameAllocator(allocator);
+            return NULL;
+        }
+        allocator->slots[i].gpu_offset = i * allocator->gpu_region_size;
+    }
+
+    if (gpu_size == 0) {
+        return allocator;
+    }
+    if (gpu_device == NULL) {
+        allocator->headless = static_cast<Uint8*>(SDL_aligned_alloc(FRAME_BUFFER_ALIGNMENT, gpu_size));
+        if (allocator->headless == NULL) {
+            DestroyFrameAllocator(allocator);
+            return NULL;
+        }
+        return allocator;
+    }
+
+    // Vertex, index or storage data; the region a frame writes is never in use by the GPU.
+    SDL_GPUBufferCreateInfo buffer_info = {};
+    buffer_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_INDEX | SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
+    buffer_info.size = gpu_size;
+    allocator->buffer = SDL_CreateGPUBuffer(gpu_device, &buffer_info);
+    SDL_GPUTransferBufferCreateInfo transfer_info = {};
+    transfer_info.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_info.size = gpu_size;
+    allocator->transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
+    if (allocator->buffer == NULL || allocator->transfer_buffer == NULL) {
+        SDL_Log("Failed to create frame buffer ring! %s", SDL_GetError());
+        DestroyFrameAllocator(allocator);
+        return NULL;
+    }
+    return allocator;
+}
+
+static void WaitForSlot(FrameAllocator *allocator, FrameSlot *slot)
+{
+    if (slot->fence == NULL) {
+        return;
+    }
+    if (!SDL_QueryGPUFence(allocator->gpu_device, slot->fence)) {
+        SDL_WaitForGPUFences(allocator->gpu_device, true, &slot->fence, 1);
+        allocator->fence_waits++;
+    }
+    SDL_ReleaseGPUFence(allocator->gpu_device, slot->fence);
+    slot->fence = NULL;
+}
+
+void DestroyFrameAllocator(FrameAllocator *allocator)
+{
+    if (allocator == NULL) {
+        return;
+    }
+    for (Uint32 i = 0; i < allocator->num_slots; i++) {
+        WaitForSlot(allocator, &allocator->slots[i]);
+        FreeFrameArena(&allocator->slots[i].arena);
+    }
+    if (allocator->mapped != NULL && allocator->headless == NULL) {
+        SDL_UnmapGPUTransferBuffer(allocator->gpu_device, allocator->transfer_buffer);
+    }
+    SDL_ReleaseGPUTransferBuffer(allocator->gpu_device, allocator->transfer_buffer);
+    SDL_ReleaseGPUBuffer(allocator->gpu_device, allocator->buffer);
+    SDL_aligned_free(allocator->headless);
+    SDL_free(allocator);
+}
+
+void BeginFrameAllocator(FrameAllocator *allocator)
+{
+    // A frame begun but never submitted keeps its slot and starts over.
+    FrameSlot *slot = &allocator->slots[allocator->current];
+    WaitForSlot(allocator, slot);
+    ResetFrameArena(&slot->arena);
+    slot->gpu_used = 0;
+    slot->gpu_flushed = 0;
+    allocator->begun = true;
+    allocator->frames++;
+}
+
+void* FrameAlloc(FrameAllocator *allocator, size_t size, size_t alignment)
+{
+    SDL_assert(allocator->begun);
+    void *memory = FrameArenaAlloc(&allocator->slots[allocator->current].arena, size, alignment);
+    if (memory == NULL) {
+        allocator->failures++;
+    }
+    return memory;
+}
+
+bool FrameAllocBuffer(FrameAllocator *allocator, Uint32 size, Uint32 alignment, FrameBufferAllocation *allocation)
+{
+    SDL_assert(allocator->begun);
+    SDL_assert(alignment == 0 || (alignment & (alignment - 1)) == 0);
+    FrameSlot *slot = &allocator->slots[allocator->current];
+    alignment = alignment != 0 ? alignment : FRAME_BUFFER_ALIGNMENT;
+    // Aligned within the whole buffer, as the binding offset is
+    Uint64 start = ((Uint64)slot->gpu_offset + slot->gpu_used + alignment - 1) & ~(Uint64)(alignment - 1);
+    start -= slot->gpu_offset;
+    if (size == 0 || start + size > allocator->gpu_region_size) {
+        allocator->failures++;
+        return false;
+    }
+
+    if (allocator->mapped == NULL) {
+        if (allocator->headless != NULL) {
+            allocator->mapped = allocator->headless;
+        } else {
+            // Not cycled: the slot's region is idle once its fence has signalled, and
+            // the regions still in flight are never written.
+            allocator->mapped = static_cast<Uint8*>(SDL_MapGPUTransferBuffer(allocator->gpu_device, allocator->transfer_buffer, false));
+            if (allocator->mapped == NULL) {
+                SDL_Log("Failed to map frame buffer ring! %s", SDL_GetError());
+                allocator->failures++;
+                return false;
+            }
+        }
+    }
+
+    slot->gpu_used = (Uint32)(start + size);
+    allocation->buffer = allocator->buffer;
+    allocation->offset = slot->gpu_offset + (Uint32)start;
+    allocation->data = allocator->mapped + allocation->offset;
+    return true;
+}
+
+void FlushFrameAllocator(FrameAllocator *allocator, SDL_GPUCommandBuffer *command_buffer)
+{
+    FrameSlot *slot = &allocator->slots[allocator->current];
+    if (allocator->headless != NULL || allocator->mapped == NULL) {
+        slot->gpu_flushed = slot->gpu_used;
+        allocator->mapped = NULL;
+        return;
+    }
+    SDL_UnmapGPUTransferBuffer(allocator->gpu_device, allocator->transfer_buffer);
+    allocator->mapped = NULL;
+    if (slot->gpu_used == slot->gpu_flushed) {
+        return;
+    }
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(command_buffer);
+    SDL_GPUTransferBufferLocation source = {};
+    source.transfer_buffer = allocator->transfer_buffer;
+    source.offset = slot->gpu_offset + slot->gpu_flushed;
+    SDL_GPUBufferRegion destination = {};
+    destination.buffer = allocator->buffer;
+    destination.offset = source.offset;
+    destination.size = slot->gpu_used - slot->gpu_flushed;
+    SDL_UploadToGPUBuffer(copy_pass, &source, &destination, false);
+    SDL_EndGPUCopyPass(copy_pass);
+    slot->gpu_flushed = slot->gpu_used;
+}
+
+bool SubmitFrameAllocator(FrameAllocator *allocator, SDL_GPUCommandBuffer *command_buffer)
+{
+    FrameSlot *slot = &allocator->slots[allocator->current];
+    if (slot->gpu_flushed != slot->gpu_used) {
+        SDL_Log("Frame allocator: %u bytes allocated after the flush were not uploaded", slot->gpu_used - slot->gpu_flushed);
+    }
+
+    bool submitted = true;
+    if (allocator->gpu_device != NULL) {
+        if (allocator->mapped != NULL) {
+            SDL_UnmapGPUTransferBuffer(allocator->gpu_device, allocator->transfer_buffer);
+            allocator->mapped = NULL;
+        }
+        // A failed submit leaves nothing in flight, so a NULL fence is still correct.
+        slot->fence = SDL_SubmitGPUCommandBufferAndAcquireFence(command_buffer);
+        submitted = slot->fence != NULL;
+    }
+
+    allocator->cpu_last_frame = slot->arena.used;
+    allocator->cpu_high_water = SDL_max(allocator->cpu_high_water, slot->arena.used);
+    allocator->gpu_last_frame = slot->gpu_used;
+    allocator->gpu_high_water = SDL_max(allocator->gpu_high_water, slot->gpu_used);
+    allocator->current = (allocator->current + 1) % allocator->num_slots;
+    allocator->begun = false;
+    return submitted;
+}
+
+FrameAllocatorStats GetFrameAllocatorStats(const FrameAllocator *allocator)
+{
+    const FrameSlot *slot = &allocator->slots[allocator->current];
+    FrameAllocatorStats stats = {};
+    stats.frames_in_flight = allocator->num_slots;
+    stats.frames = allocator->frames;
+    stats.cpu_capacity = slot->arena.capacity;
+    stats.cpu_used = allocator->begun ? slot->arena.used : 0;
+    stats.cpu_last_frame = allocator->cpu_last_frame;
+    stats.cpu_high_water = allocator->cpu_high_water;
+    stats.gpu_capacity = allocator->gpu_region_size;
+    stats.gpu_used = allocator->begun ? slot->gpu_used : 0;
+    stats.gpu_last_frame = allocator->gpu_last_frame;
+    stats.gpu_high_water = allocator->gpu_high_water;
+    stats.failures = allocator->failures;
+    stats.fence_waits = allocator->fence_waits;
+    return stats;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Transient per-frame memory. Each frame in flight owns a fixed CPU arena and
+// a fixed region of one GPU buffer, both handed out with a bump pointer and
+// reset in one step when that frame comes round again and its fence has
+// signalled. Nothing is allocated from the heap after creation: a request
+// that does not fit fails and is counted, so size the arenas from the
+// reported high-water marks.
+//
+// A frame runs BeginFrameAllocator, then any number of allocations, then
+// FlushFrameAllocator into the frame's command buffer ahead of the passes
+// that read the GPU data, then SubmitFrameAllocator in place of
+// SDL_SubmitGPUCommandBuffer so the allocator keeps the frame's fence.
+
+#define FRAME_ALLOCATOR_MAX_FRAMES 4
+// GPU allocations start on this boundary by default, and each frame's region too
+#define FRAME_BUFFER_ALIGNMENT 256
+
+// A fixed-size bump arena, also usable on its own (one per thread).
+typedef struct FrameArena
+{
+    Uint8 *base;
+    size_t capacity;
+    size_t used;
+} FrameArena;
+
+bool InitFrameArena(FrameArena *arena, size_t capacity);
+void FreeFrameArena(FrameArena *arena);
+// alignment is a power of two. NULL when the arena is full; it never grows.
+void* FrameArenaAlloc(FrameArena *arena, size_t size, size_t alignment);
+static inline void ResetFrameArena(FrameArena *arena)
+{
+    arena->used = 0;
+}
+
+// Part of the frame's GPU region. Fill data before FlushFrameAllocator, then
+// bind buffer at offset as a vertex or index buffer. SDL binds storage buffers
+// whole, so shaders reading one this way need offset passed in, e.g. as a
+// uniform.
+typedef struct FrameBufferAllocation
+{
+    SDL_GPUBuffer *buffer;      // NULL without a device
+    Uint32 offset;
+    void *data;
+} FrameBufferAllocation;
+
+typedef struct FrameAllocatorStats
+{
+    Uint32 frames_in_flight;
+    Uint64 frames;              // Frames begun
+    size_t cpu_capacity;        // Per frame
+    size_t cpu_used;            // By the current frame so far
+    size_t cpu_last_frame;      // By the last submitted frame
+    size_t cpu_high_water;      // Most any frame has used
+    Uint32 gpu_capacity;
+    Uint32 gpu_used;
+    Uint32 gpu_last_frame;
+    Uint32 gpu_high_water;
+    Uint32 failures;            // Allocations that did not fit
+    Uint32 fence_waits;         // Begins that had to wait for the GPU
+} FrameAllocatorStats;
+
+typedef struct FrameAllocator FrameAllocator;
+
+// gpu_device may be NULL: the GPU region is then plain memory and fences
+// count as signalled, for tools and benchmarks. gpu_bytes_per_frame may be 0
+// for a CPU-only allocator. Main thread only.
+FrameAllocator* CreateFrameAllocator(SDL_GPUDevice *gpu_device, Uint32 frames_in_flight, size_t cpu_bytes_per_frame, Uint32 gpu_bytes_per_frame);
+// Waits for every frame still in flight.
+void DestroyFrameAllocator(FrameAllocator *allocator);
+
+// Starts the next frame, waiting only if the GPU still uses its slot.
+// Everything the slot's previous frame allocated is gone afterwards.
+void BeginFrameAllocator(FrameAllocator *allocator);
+
+// CPU memory valid until this slot comes round again.
+void* FrameAlloc(FrameAllocator *allocator, size_t size, size_t alignment);
+// GPU memory for this frame. alignment 0 means FRAME_BUFFER_ALIGNMENT.
+bool FrameAllocBuffer(FrameAllocator *allocator, Uint32 size, Uint32 alignment, FrameBufferAllocation *allocation);
+
+// Copies this frame's GPU allocations into place. Call outside any pass and
+// before the passes that read them; allocations after this are not uploaded.
+void FlushFrameAllocator(FrameAllocator *allocator, SDL_GPUCommandBuffer *command_buffer);
+// Submits command_buffer and keeps its fence for the slot. command_buffer is
+// ignored without a device.
+bool SubmitFrameAllocator(FrameAllocator *allocator, SDL_GPUCommandBuffer *command_buffer);
+
+FrameAllocatorStats GetFrameAllocatorStats(const FrameAllocator *allocator);
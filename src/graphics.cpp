@@ -1,16 +1,15 @@
 #include <SDL3/SDL.h>
 #include <glm/glm.hpp>
 #include <SDL3_shadercross/SDL_shadercross.h> 
+#include <graphics.hpp>
+#include <jobs.hpp>
+#include <profiler.hpp>
+#include <shader_cache.hpp>
 
 using namespace::glm;
 
-typedef struct PositionTextureVertex
-{
-    float x, y, z;
-    float u, v;
-} PositionTextureVertex;
-
-
+// Written once by InitializeAssetLoader before any loader runs; read-only after
+// that, so loads on job workers and the shader registry thread can share it.
 static const char* base_path = NULL;
 void InitializeAssetLoader()
 {
@@ -25,8 +24,7 @@ SDL_GPUShader* LoadShader(
     Uint32 storage_buffer_count,
     Uint32 storage_texture_count
 ) {
-
-    InitializeAssetLoader();
+    PROFILE_FUNCTION();
 
     SDL_GPUShaderStage stage;
     if (SDL_strstr(shader_filename, ".vert"))
@@ -99,123 +97,391 @@ SDL_GPUShader* LoadShader(
     return shader;
 }
 
-SDL_GPUShader* ShaderCrossLoadShader(SDL_GPUDevice* gpu_device, const char* shader_filename) {
-    // Initialize
-    InitializeAssetLoader();
-    if (!SDL_ShaderCross_Init()) {
+// ShaderCross keeps DXC and SPIRV-Cross loaded between Init and Quit, so nested
+// loads share one session instead of paying for it per shader. Main thread only.
+static int shadercross_session_count = 0;
+
+bool BeginShaderCrossSession()
+{
+    if (shadercross_session_count == 0 && !SDL_ShaderCross_Init()) {
         SDL_Log("ShaderCross failed to initialize!");
-        return NULL;
+        return false;
     }
-    
-    // Determine shader stage
+    shadercross_session_count++;
+    return true;
+}
+
+void EndShaderCrossSession()
+{
+    if (shadercross_session_count > 0 && --shadercross_session_count == 0) {
+        SDL_ShaderCross_Quit();
+    }
+}
+
+// Result of the CPU half of a ShaderCross load: SPIR-V plus reflection, either
+// borrowed from the shader cache or freshly produced by DXC.
+typedef struct CompiledShader
+{
+    char full_path[256];
+    const char *entry_point;
     SDL_ShaderCross_ShaderStage stage;
-    bool is_compute = false;
+    const Uint8 *spirv;
+    size_t spirv_size;
+    const SDL_ShaderCross_GraphicsShaderMetadata *graphics_metadata;   // Vertex and fragment shaders
+    const SDL_ShaderCross_ComputePipelineMetadata *compute_metadata;   // Compute shaders
+
+    ShaderCacheEntry cache_entry;                               // Owns the data on a cache hit
+    Uint8 *spirv_buffer;                                        // Owns the data on a cache miss
+    SDL_ShaderCross_GraphicsShaderMetadata *reflected_metadata;
+    SDL_ShaderCross_ComputePipelineMetadata *reflected_compute_metadata;
+} CompiledShader;
+
+static void ReleaseCompiledShader(CompiledShader *compiled)
+{
+    ShaderCacheReleaseEntry(&compiled->cache_entry);
+    SDL_free(compiled->spirv_buffer);
+    SDL_free(compiled->reflected_metadata);
+    SDL_free(compiled->reflected_compute_metadata);
+    compiled->spirv_buffer = NULL;
+    compiled->reflected_metadata = NULL;
+    compiled->reflected_compute_metadata = NULL;
+    compiled->spirv = NULL;
+    compiled->graphics_metadata = NULL;
+    compiled->compute_metadata = NULL;
+}
+
+// Reads, compiles and reflects one shader. Touches no GPU state, so it is safe
+// to run on worker threads as long as a ShaderCross session is open.
+static bool CompileShaderToSPIRV(const char *shader_filename, CompiledShader *compiled)
+{
+    PROFILE_FUNCTION();
+    SDL_zerop(compiled);
+    compiled->entry_point = "main";
+    SDL_snprintf(compiled->full_path, sizeof(compiled->full_path), "%s../%s.hlsl", base_path, shader_filename);
+
+    // Determine shader stage
     if (SDL_strstr(shader_filename, ".vert")) {
-        stage = SDL_SHADERCROSS_SHADERSTAGE_VERTEX;
+        compiled->stage = SDL_SHADERCROSS_SHADERSTAGE_VERTEX;
     }
     else if (SDL_strstr(shader_filename, ".frag")) {
-        stage = SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
+        compiled->stage = SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
     }
     else if (SDL_strstr(shader_filename, ".comp")) {
-        stage = SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
-        is_compute = true;
+        compiled->stage = SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
     }
     else {
         SDL_Log("Invalid shader stage!");
-        SDL_ShaderCross_Quit();
-        return NULL;
+        return false;
     }
-    
-    char full_path[256];
+
     size_t code_size;
-    SDL_GPUShader* shader = NULL;
-    SDL_snprintf(full_path, sizeof(full_path), "%s../%s.hlsl", base_path, shader_filename);
-    char* code = static_cast<char*>(SDL_LoadFile(full_path, &code_size));
+    char* code = static_cast<char*>(SDL_LoadFile(compiled->full_path, &code_size));
     if (code == NULL) {
-        SDL_Log("Failed to load shader from disk! %s", full_path);
-        SDL_ShaderCross_Quit();
-        return NULL;
+        SDL_Log("Failed to load shader from disk! %s", compiled->full_path);
+        return false;
     }
-    
-    const char *entry_point = "main";
+
+    // Warm path: the cache holds SPIR-V and reflection for this exact source/stage/entry point
+    Uint64 cache_key = ShaderCacheKey(code, code_size, NULL, compiled->stage, compiled->entry_point);
+    if (ShaderCacheLoad(cache_key, &compiled->cache_entry)) {
+        compiled->spirv = compiled->cache_entry.spirv;
+        compiled->spirv_size = compiled->cache_entry.spirv_size;
+        compiled->graphics_metadata = &compiled->cache_entry.graphics_metadata;
+        compiled->compute_metadata = &compiled->cache_entry.compute_metadata;
+        SDL_free(code);
+        return true;
+    }
+
     SDL_ShaderCross_HLSL_Info hlsl_info = {0};
     hlsl_info.source = static_cast<const char*>(code);
-    hlsl_info.entrypoint = entry_point;
+    hlsl_info.entrypoint = compiled->entry_point;
     hlsl_info.include_dir = NULL;
     hlsl_info.defines = NULL;
-    hlsl_info.shader_stage = stage;
+    hlsl_info.shader_stage = compiled->stage;
     hlsl_info.enable_debug = false;
-    hlsl_info.name = full_path;
+    hlsl_info.name = compiled->full_path;
     hlsl_info.props = 0;
     
     size_t bytecode_size;
-    Uint8* spirv_buffer = static_cast<Uint8*>(SDL_ShaderCross_CompileSPIRVFromHLSL(
+    compiled->spirv_buffer = static_cast<Uint8*>(SDL_ShaderCross_CompileSPIRVFromHLSL(
         &hlsl_info,
         &bytecode_size));
+    SDL_free(code);
     
-    if (spirv_buffer == NULL) {
+    if (compiled->spirv_buffer == NULL) {
         SDL_Log("Shader Compilation failed. %s", SDL_GetError());
-        SDL_free(code);
-        SDL_ShaderCross_Quit();
+        return false;
+    }
+
+    compiled->spirv = compiled->spirv_buffer;
+    compiled->spirv_size = bytecode_size;
+
+    // Get metadata through reflection; compute shaders also report their thread group size
+    if (compiled->stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+        compiled->reflected_compute_metadata = SDL_ShaderCross_ReflectComputeSPIRV(compiled->spirv_buffer, bytecode_size, 0);
+        if (compiled->reflected_compute_metadata == NULL) {
+            SDL_Log("Failed to reflect compute shader metadata. %s", SDL_GetError());
+            ReleaseCompiledShader(compiled);
+            return false;
+        }
+        ShaderCacheStoreCompute(cache_key, compiled->spirv_buffer, bytecode_size, compiled->reflected_compute_metadata);
+        compiled->compute_metadata = compiled->reflected_compute_metadata;
+    } else {
+        compiled->reflected_metadata = SDL_ShaderCross_ReflectGraphicsSPIRV(compiled->spirv_buffer, bytecode_size, 0);
+        if (compiled->reflected_metadata == NULL) {
+            SDL_Log("Failed to reflect shader metadata. %s", SDL_GetError());
+            ReleaseCompiledShader(compiled);
+            return false;
+        }
+        ShaderCacheStore(cache_key, compiled->stage, compiled->spirv_buffer, bytecode_size, compiled->reflected_metadata);
+        compiled->graphics_metadata = compiled->reflected_metadata;
+    }
+    return true;
+}
+
+// The GPU half of a ShaderCross load; must run on the thread that owns the device.
+static SDL_GPUShader* CreateShaderFromCompiled(SDL_GPUDevice* gpu_device, const CompiledShader *compiled)
+{
+    if (compiled->stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+        // Handle compute shaders - note this returns a compute pipeline, not a shader
+        SDL_Log("Compute shaders require different handling - use ShaderCrossLoadComputePipeline for %s", compiled->full_path);
         return NULL;
     }
-    
+
     // Properly initialize SPIRV info
     SDL_ShaderCross_SPIRV_Info spirv_info = {0};
-    spirv_info.bytecode = spirv_buffer;
-    spirv_info.bytecode_size = bytecode_size;
-    spirv_info.entrypoint = entry_point;
-    spirv_info.shader_stage = stage;
+    spirv_info.bytecode = compiled->spirv;
+    spirv_info.bytecode_size = compiled->spirv_size;
+    spirv_info.entrypoint = compiled->entry_point;
+    spirv_info.shader_stage = compiled->stage;
     spirv_info.enable_debug = false;
-    spirv_info.name = full_path;
+    spirv_info.name = compiled->full_path;
     spirv_info.props = 0;
-    
-    if (is_compute) {
-        // Handle compute shaders - note this returns a compute pipeline, not a shader
-        SDL_Log("Compute shaders require different handling - this function only supports graphics shaders");
-        SDL_free(code);
-        SDL_free(spirv_buffer);
-        SDL_ShaderCross_Quit();
-        return NULL;
-    } else {
-        // Get metadata through reflection
-        SDL_ShaderCross_GraphicsShaderMetadata* metadata = 
-            SDL_ShaderCross_ReflectGraphicsSPIRV(spirv_buffer, bytecode_size, 0);
-        
-        if (metadata == NULL) {
-            SDL_Log("Failed to reflect shader metadata. %s", SDL_GetError());
-            SDL_free(code);
-            SDL_free(spirv_buffer);
-            SDL_ShaderCross_Quit();
-            return NULL;
-        }
-        
-        // Compile the graphics shader
-        shader = SDL_ShaderCross_CompileGraphicsShaderFromSPIRV(
-            gpu_device, 
-            &spirv_info, 
-            metadata, 
-            0);  // Use 0 instead of SDL_PropertiesID {0}
-        
-        // Clean up metadata
-        SDL_free(metadata);
-    }
-    
-    // Clean up temporary resources
-    SDL_free(code);
-    SDL_free(spirv_buffer);
-    
+
+    SDL_GPUShader* shader = SDL_ShaderCross_CompileGraphicsShaderFromSPIRV(
+        gpu_device, 
+        &spirv_info, 
+        compiled->graphics_metadata, 
+        0);  // Use 0 instead of SDL_PropertiesID {0}
+
     if (shader == NULL) {
         SDL_Log("Failed to compile shader from SPIRV. %s", SDL_GetError());
     }
-    
-    // De-initialize Shadercross
-    SDL_ShaderCross_Quit();
     return shader;
 }
 
+SDL_GPUShader* ShaderCrossLoadShader(SDL_GPUDevice* gpu_device, const char* shader_filename) {
+    PROFILE_FUNCTION();
+    // Initialize
+    if (!BeginShaderCrossSession()) {
+        return NULL;
+    }
+
+    SDL_GPUShader* shader = NULL;
+    CompiledShader compiled;
+    if (CompileShaderToSPIRV(shader_filename, &compiled)) {
+        shader = CreateShaderFromCompiled(gpu_device, &compiled);
+        ReleaseCompiledShader(&compiled);
+    }
+
+    EndShaderCrossSession();
+    return shader;
+}
+
+CompiledShader* ShaderCrossCompileShader(const char* shader_filename)
+{
+    CompiledShader *compiled = static_cast<CompiledShader*>(SDL_malloc(sizeof(CompiledShader)));
+    if (compiled == NULL) {
+        return NULL;
+    }
+    if (!CompileShaderToSPIRV(shader_filename, compiled)) {
+        SDL_free(compiled);
+        return NULL;
+    }
+    return compiled;
+}
+
+SDL_GPUShader* ShaderCrossCreateCompiledShader(SDL_GPUDevice* gpu_device, const CompiledShader* compiled)
+{
+    return CreateShaderFromCompiled(gpu_device, compiled);
+}
+
+void FreeCompiledShader(CompiledShader* compiled)
+{
+    if (compiled != NULL) {
+        ReleaseCompiledShader(compiled);
+        SDL_free(compiled);
+    }
+}
+
+static SDL_GPUComputePipeline* CreateComputePipelineFromCompiled(SDL_GPUDevice* gpu_device, const CompiledShader *compiled)
+{
+    if (compiled->stage != SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+        SDL_Log("%s is not a compute shader", compiled->full_path);
+        return NULL;
+    }
+
+    SDL_ShaderCross_SPIRV_Info spirv_info = {0};
+    spirv_info.bytecode = compiled->spirv;
+    spirv_info.bytecode_size = compiled->spirv_size;
+    spirv_info.entrypoint = compiled->entry_point;
+    spirv_info.shader_stage = compiled->stage;
+    spirv_info.enable_debug = false;
+    spirv_info.name = compiled->full_path;
+    spirv_info.props = 0;
+
+    // Thread counts and every resource count come from reflection, never from the caller
+    SDL_GPUComputePipeline* pipeline = SDL_ShaderCross_CompileComputePipelineFromSPIRV(
+        gpu_device,
+        &spirv_info,
+        compiled->compute_metadata,
+        0);
+
+    if (pipeline == NULL) {
+        SDL_Log("Failed to create compute pipeline from SPIRV. %s", SDL_GetError());
+    }
+    return pipeline;
+}
+
+SDL_GPUComputePipeline* ShaderCrossLoadComputePipeline(SDL_GPUDevice* gpu_device, const char* shader_filename)
+{
+    if (!BeginShaderCrossSession()) {
+        return NULL;
+    }
+
+    SDL_GPUComputePipeline* pipeline = NULL;
+    CompiledShader compiled;
+    if (CompileShaderToSPIRV(shader_filename, &compiled)) {
+        pipeline = CreateComputePipelineFromCompiled(gpu_device, &compiled);
+        ReleaseCompiledShader(&compiled);
+    }
+
+    EndShaderCrossSession();
+    return pipeline;
+}
+
+typedef struct ShaderBatchJob
+{
+    const ShaderBatchEntry *entries;
+    CompiledShader *compiled;
+    bool *succeeded;
+} ShaderBatchJob;
+
+static void CompileShaderBatchItem(Uint32 index, void *userdata)
+{
+    ShaderBatchJob *job = static_cast<ShaderBatchJob*>(userdata);
+    job->succeeded[index] = CompileShaderToSPIRV(job->entries[index].shader_filename, &job->compiled[index]);
+}
+
+bool ShaderCrossLoadShaderBatch(SDL_GPUDevice* gpu_device, ShaderBatchEntry* entries, Uint32 num_entries, JobSystem* jobs)
+{
+    PROFILE_FUNCTION();
+    for (Uint32 i = 0; i < num_entries; i++) {
+        entries[i].shader = NULL;
+        entries[i].compute_pipeline = NULL;
+    }
+    if (num_entries == 0) {
+        return true;
+    }
+    if (!BeginShaderCrossSession()) {
+        return false;
+    }
+
+    Uint64 start_ticks = SDL_GetTicksNS();
+
+    ShaderBatchJob job;
+    job.entries = entries;
+    job.compiled = static_cast<CompiledShader*>(SDL_calloc(num_entries, sizeof(CompiledShader)));
+    job.succeeded = static_cast<bool*>(SDL_calloc(num_entries, sizeof(bool)));
+    if (job.compiled == NULL || job.succeeded == NULL) {
+        SDL_free(job.compiled);
+        SDL_free(job.succeeded);
+        EndShaderCrossSession();
+        return false;
+    }
+
+    // DXC and reflection run as jobs; only shader object creation stays on this thread.
+    ParallelFor(jobs, num_entries, CompileShaderBatchItem, &job);
+
+    Uint64 compile_ticks = SDL_GetTicksNS();
+
+    bool all_loaded = true;
+    for (Uint32 i = 0; i < num_entries; i++) {
+        if (job.succeeded[i]) {
+            if (job.compiled[i].stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+                entries[i].compute_pipeline = CreateComputePipelineFromCompiled(gpu_device, &job.compiled[i]);
+            } else {
+                entries[i].shader = CreateShaderFromCompiled(gpu_device, &job.compiled[i]);
+            }
+            ReleaseCompiledShader(&job.compiled[i]);
+        }
+        if (entries[i].shader == NULL && entries[i].compute_pipeline == NULL) {
+            SDL_Log("Batch shader load failed for %s", entries[i].shader_filename);
+            all_loaded = false;
+        }
+    }
+
+    SDL_Log("Loaded %u shaders: compile %.2f ms, create %.2f ms",
+            num_entries,
+            (compile_ticks - start_ticks) / 1e6,
+            (SDL_GetTicksNS() - compile_ticks) / 1e6);
+
+    SDL_free(job.compiled);
+    SDL_free(job.succeeded);
+    EndShaderCrossSession();
+    return all_loaded;
+}
+
+static int CompareManifestNames(const void *a, const void *b)
+{
+    return SDL_strcmp(*static_cast<char* const*>(a), *static_cast<char* const*>(b));
+}
+
+char **BuildShaderManifest(const char *directory, int *count)
+{
+    *count = 0;
+
+    char full_path[256];
+    SDL_snprintf(full_path, sizeof(full_path), "%s../%s", base_path, directory);
+
+    int num_files = 0;
+    char **files = SDL_GlobDirectory(full_path, "*.hlsl", 0, &num_files);
+    if (files == NULL) {
+        SDL_Log("Failed to list shaders in %s: %s", full_path, SDL_GetError());
+        return NULL;
+    }
+
+    // One allocation: the pointer array followed by "directory/name" strings without ".hlsl"
+    size_t directory_length = SDL_strlen(directory);
+    size_t total_size = (num_files + 1) * sizeof(char*);
+    for (int i = 0; i < num_files; i++) {
+        total_size += directory_length + 1 + SDL_strlen(files[i]) + 1;
+    }
+
+    char **manifest = static_cast<char**>(SDL_malloc(total_size));
+    if (manifest == NULL) {
+        SDL_free(files);
+        return NULL;
+    }
+
+    char *names = reinterpret_cast<char*>(manifest + num_files + 1);
+    for (int i = 0; i < num_files; i++) {
+        size_t name_length = SDL_strlen(files[i]) - 5; // strip ".hlsl"
+        manifest[i] = names;
+        SDL_snprintf(names, directory_length + 1 + name_length + 1, "%s/%.*s", directory, (int)name_length, files[i]);
+        names += directory_length + 1 + name_length + 1;
+    }
+    manifest[num_files] = NULL;
+    SDL_free(files);
+
+    SDL_qsort(manifest, num_files, sizeof(char*), CompareManifestNames);
+    *count = num_files;
+    return manifest;
+}
+
 SDL_Surface *LoadImage(const char *image_file_name, int desired_channels)
 {
+    PROFILE_FUNCTION();
     char full_path[256];
     SDL_Surface *result;
     SDL_PixelFormat format;
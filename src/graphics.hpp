@@ -1,6 +1,8 @@
 #pragma once
 
 #include <SDL3/SDL.h>
+#include <SDL3_shadercross/SDL_shadercross.h>
+#include <jobs.hpp>
 
 typedef struct PositionTextureVertex
 {
@@ -19,6 +21,40 @@ SDL_GPUShader* LoadShader(
 
 SDL_GPUShader* ShaderCrossLoadShader(SDL_GPUDevice* gpu_device, const char* shader_filename);
 
+// ShaderCrossLoadShader in two halves. The compile reads, compiles and reflects
+// without touching the GPU, so it may run on any thread while the main thread
+// holds a ShaderCross session open. Creating the shader must happen on the
+// main thread. Free with FreeCompiledShader.
+typedef struct CompiledShader CompiledShader;
+CompiledShader* ShaderCrossCompileShader(const char* shader_filename);
+SDL_GPUShader* ShaderCrossCreateCompiledShader(SDL_GPUDevice* gpu_device, const CompiledShader* compiled);
+void FreeCompiledShader(CompiledShader* compiled);
+
+// Builds a compute pipeline from a .comp HLSL file. Thread counts and resource
+// counts are taken from SDL_ShaderCross_ReflectComputeSPIRV.
+SDL_GPUComputePipeline* ShaderCrossLoadComputePipeline(SDL_GPUDevice* gpu_device, const char* shader_filename);
+
+// Keeps ShaderCross initialized across several loads. Calls nest; main thread only.
+bool BeginShaderCrossSession();
+void EndShaderCrossSession();
+
+typedef struct ShaderBatchEntry
+{
+    const char *shader_filename;    // Same form as ShaderCrossLoadShader, e.g. "assets/Shaders/SolidColor.frag"
+    SDL_GPUShader *shader;                      // Filled in for .vert/.frag; NULL if this shader failed
+    SDL_GPUComputePipeline *compute_pipeline;   // Filled in for .comp; NULL if this shader failed
+} ShaderBatchEntry;
+
+// Compiles and reflects every entry as jobs under a single ShaderCross session,
+// then creates the GPU shaders on the calling thread. Returns false if any
+// entry failed; the others are still loaded. jobs may be NULL.
+bool ShaderCrossLoadShaderBatch(SDL_GPUDevice* gpu_device, ShaderBatchEntry* entries, Uint32 num_entries, JobSystem* jobs);
+
+// Lists every *.hlsl under directory (relative to the assets root, like the
+// loaders) as sorted shader names without the extension. Free with SDL_free.
+char **BuildShaderManifest(const char *directory, int *count);
+
+// Call once on the main thread at startup, before any of the loaders here run.
 void InitializeAssetLoader();
 
 SDL_Surface *LoadImage(const char *image_file_name, int desired_channels);
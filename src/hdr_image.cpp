@@ -0,0 +1,511 @@
+#include <SDL3/SDL.h>
+#include <hdr_image.hpp>
+#include <jobs.hpp>
+
+#define HDR_MAX_DIMENSION 65535
+#define HDR_MAX_HEADER_LINE 256
+#define HDR_CONVERT_ROWS_PER_JOB 32
+#define HDR_HALF_MAX 65504.0f
+
+// ---------------------------------------------------------------------------
+// Header
+// ---------------------------------------------------------------------------
+
+typedef struct HDRHeader
+{
+    Uint32 width;
+    Uint32 height;
+    bool bottom_up;             // "+Y": first scanline in the file is the bottom row
+    size_t data_offset;
+} HDRHeader;
+
+// Copies the next '\n'-terminated line into line; false at the end of the data.
+static bool ReadHeaderLine(const Uint8 *data, size_t size, size_t *offset, char *line)
+{
+    size_t length = 0;
+    while (*offset < size && data[*offset] != '\n') {
+        if (length + 1 >= HDR_MAX_HEADER_LINE) {
+            return SDL_SetError("HDR header line too long");
+        }
+        line[length++] = (char)data[(*offset)++];
+    }
+    if (*offset >= size) {
+        return SDL_SetError("HDR header truncated");
+    }
+    (*offset)++;
+    line[length] = '\0';
+    return true;
+}
+
+// "-Y 768 +X 512": reads the axis ('Y'/'X' with sign) and its size.
+static const char* ParseAxis(const char *text, char axis, char *sign, Uint32 *size)
+{
+    while (*text == ' ') {
+        text++;
+    }
+    if ((text[0] != '-' && text[0] != '+') || text[1] != axis || text[2] != ' ') {
+        return NULL;
+    }
+    *sign = text[0];
+    text += 3;
+
+    Uint32 value = 0;
+    if (*text < '0' || *text > '9') {
+        return NULL;
+    }
+    while (*text >= '0' && *text <= '9') {
+        value = value * 10 + (Uint32)(*text++ - '0');
+        if (value > HDR_MAX_DIMENSION) {
+            return NULL;
+        }
+    }
+    *size = value;
+    return text;
+}
+
+static bool ParseHeader(const void *file_data, size_t file_size, HDRHeader *header)
+{
+    const Uint8 *data = static_cast<const Uint8*>(file_data);
+    if (file_size < 2 || data[0] != '#' || data[1] != '?') {
+        return SDL_SetError("Not a Radiance HDR file");
+    }
+
+    char line[HDR_MAX_HEADER_LINE];
+    size_t offset = 0;
+    for (;;) {
+        if (!ReadHeaderLine(data, file_size, &offset, line)) {
+            return false;
+        }
+        if (line[0] == '\0') {
+            break;
+        }
+        if (SDL_strncmp(line, "FORMAT=", 7) == 0 && SDL_strcmp(line + 7, "32-bit_rle_rgbe") != 0) {
+            return SDL_SetError("Unsupported HDR format %s", line + 7);
+        }
+    }
+
+    if (!ReadHeaderLine(data, file_size, &offset, line)) {
+        return false;
+    }
+    char y_sign, x_sign;
+    const char *text = ParseAxis(line, 'Y', &y_sign, &header->height);
+    if (text != NULL) {
+        text = ParseAxis(text, 'X', &x_sign, &header->width);
+    }
+    if (text == NULL || x_sign != '+') {
+        return SDL_SetError("Unsupported HDR orientation: %s", line);
+    }
+    if (header->width == 0 || header->height == 0) {
+        return SDL_SetError("HDR image has no pixels");
+    }
+    header->bottom_up = y_sign == '+';
+    header->data_offset = offset;
+    return true;
+}
+
+bool ParseHDRHeader(const void *file_data, size_t file_size, Uint32 *width, Uint32 *height)
+{
+    HDRHeader header;
+    if (!ParseHeader(file_data, file_size, &header)) {
+        return false;
+    }
+    *width = header.width;
+    *height = header.height;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Scanlines
+// ---------------------------------------------------------------------------
+
+static bool DecodeScanline(const Uint8 **cursor, const Uint8 *end, Uint8 *row, Uint32 width)
+{
+    const Uint8 *p = *cursor;
+
+    // Per-channel RLE: 2, 2, width (big endian), then R, G, B and E runs in turn.
+    if (width >= 8 && width <= 0x7FFF && end - p >= 4 && p[0] == 2 && p[1] == 2 && (p[2] & 0x80) == 0) {
+        if ((((Uint32)p[2] << 8) | p[3]) != width) {
+            return SDL_SetError("HDR scanline width mismatch");
+        }
+        p += 4;
+        for (int channel = 0; channel < 4; channel++) {
+            Uint8 *out = row + channel;
+            Uint32 x = 0;
+            while (x < width) {
+                if (p >= end) {
+                    return SDL_SetError("HDR data truncated");
+                }
+                Uint32 count = *p++;
+                if (count > 128) {
+                    count -= 128;
+                    if (count > width - x || p >= end) {
+                        return SDL_SetError("Bad HDR run");
+                    }
+                    Uint8 value = *p++;
+                    for (Uint32 i = 0; i < count; i++) {
+                        out[(x++) * 4] = value;
+                    }
+                } else {
+                    if (count == 0 || count > width - x || (size_t)(end - p) < count) {
+                        return SDL_SetError("Bad HDR literal run");
+                    }
+                    for (Uint32 i = 0; i < count; i++) {
+                        out[(x++) * 4] = *p++;
+                    }
+                }
+            }
+        }
+        *cursor = p;
+        return true;
+    }
+
+    // Flat pixels, where 1,1,1,n repeats the previous pixel (old-style RLE;
+    // consecutive repeats scale the count by 256 each).
+    Uint32 x = 0;
+    int shift = 0;
+    while (x < width) {
+        if (end - p < 4) {
+            return SDL_SetError("HDR data truncated");
+        }
+        if (p[0] == 1 && p[1] == 1 && p[2] == 1) {
+            Uint64 count = (Uint64)p[3] << shift;
+            if (x == 0 || shift > 16 || count > width - x) {
+                return SDL_SetError("Bad HDR repeat");
+            }
+            for (Uint64 i = 0; i < count; i++, x++) {
+                SDL_memcpy(row + x * 4, row + (x - 1) * 4, 4);
+            }
+            shift += 8;
+        } else {
+            SDL_memcpy(row + x * 4, p, 4);
+            x++;
+            shift = 0;
+        }
+        p += 4;
+    }
+    *cursor = p;
+    return true;
+}
+
+static bool DecodeScanlines(const void *file_data, size_t file_size, const HDRHeader *header, Uint8 *rgbe)
+{
+    const Uint8 *cursor = static_cast<const Uint8*>(file_data) + header->data_offset;
+    const Uint8 *end = static_cast<const Uint8*>(file_data) + file_size;
+    size_t row_size = (size_t)header->width * 4;
+
+    for (Uint32 y = 0; y < header->height; y++) {
+        Uint32 row = header->bottom_up ? header->height - 1 - y : y;
+        if (!DecodeScanline(&cursor, end, rgbe + row * row_size, header->width)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DecodeHDRScanlines(const void *file_data, size_t file_size, Uint8 *rgbe, Uint32 width, Uint32 height)
+{
+    HDRHeader header;
+    if (!ParseHeader(file_data, file_size, &header)) {
+        return false;
+    }
+    if (header.width != width || header.height != height) {
+        return SDL_SetError("HDR size is %ux%u, not %ux%u", header.width, header.height, width, height);
+    }
+    return DecodeScanlines(file_data, file_size, &header, rgbe);
+}
+
+// ---------------------------------------------------------------------------
+// RGBE -> RGBA conversion
+// ---------------------------------------------------------------------------
+//
+// value = (mantissa / 256) * 2^(exponent - 128). The power of two is built
+// straight from the exponent bits as (exponent - 1) << 23, saturating, so 0
+// maps to 0.0 for free; exponent 1 (values below 1e-38) flushes to zero too.
+// Both multiplies are exact or correctly rounded the same way on every path.
+
+#define RGBE_SCALE (1.0f / 256.0f)
+
+static inline Uint32 RGBEExponentBits(Uint8 exponent)
+{
+    return exponent > 0 ? (Uint32)(exponent - 1) << 23 : 0;
+}
+
+static inline float RGBEComponent(Uint8 mantissa, Uint32 exponent_bits)
+{
+    float scale;
+    SDL_memcpy(&scale, &exponent_bits, sizeof(scale));
+    return ((float)mantissa * RGBE_SCALE) * scale;
+}
+
+// Round-to-nearest-even float -> half for non-negative values no larger than
+// 65504 (the only inputs here), matching F16C's _mm256_cvtps_ph.
+static inline Uint16 FloatToHalf(float value)
+{
+    Uint32 bits;
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    if (bits < (113u << 23)) {
+        // Denormal half: let the FPU do the rounding by adding a magic constant.
+        const Uint32 magic_bits = ((127 - 15) + (23 - 10) + 1) << 23;
+        float magic;
+        SDL_memcpy(&magic, &magic_bits, sizeof(magic));
+        value += magic;
+        SDL_memcpy(&bits, &value, sizeof(bits));
+        return (Uint16)(bits - magic_bits);
+    }
+    Uint32 mantissa_odd = (bits >> 13) & 1;
+    bits += ((Uint32)(15 - 127) << 23) + 0xFFF + mantissa_odd;
+    return (Uint16)(bits >> 13);
+}
+
+static void ConvertRGBEToFloatScalar(const Uint8 *rgbe, float *rgba, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++, rgbe += 4, rgba += 4) {
+        Uint32 exponent_bits = RGBEExponentBits(rgbe[3]);
+        rgba[0] = RGBEComponent(rgbe[0], exponent_bits);
+        rgba[1] = RGBEComponent(rgbe[1], exponent_bits);
+        rgba[2] = RGBEComponent(rgbe[2], exponent_bits);
+        rgba[3] = 1.0f;
+    }
+}
+
+static void ConvertRGBEToHalfScalar(const Uint8 *rgbe, Uint16 *rgba, Uint32 count)
+{
+    const Uint16 half_one = 0x3C00;
+    for (Uint32 i = 0; i < count; i++, rgbe += 4, rgba += 4) {
+        Uint32 exponent_bits = RGBEExponentBits(rgbe[3]);
+        rgba[0] = FloatToHalf(SDL_min(RGBEComponent(rgbe[0], exponent_bits), HDR_HALF_MAX));
+        rgba[1] = FloatToHalf(SDL_min(RGBEComponent(rgbe[1], exponent_bits), HDR_HALF_MAX));
+        rgba[2] = FloatToHalf(SDL_min(RGBEComponent(rgbe[2], exponent_bits), HDR_HALF_MAX));
+        rgba[3] = half_one;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+
+// Subtracts 1 from every E byte, saturating, before the bytes are widened.
+static inline __m128i BiasExponentsSSE2(__m128i bytes)
+{
+    return _mm_subs_epu8(bytes, _mm_set1_epi32(0x01000000));
+}
+
+// One pixel per register: R, G, B, E - 1 widened to four 32-bit lanes.
+static inline __m128 RGBEToFloatSSE2(__m128i pixel)
+{
+    const __m128 scale = _mm_set1_ps(RGBE_SCALE);
+    const __m128 alpha_one = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+    __m128 mantissa = _mm_cvtepi32_ps(pixel);
+    __m128 exponent = _mm_castsi128_ps(_mm_slli_epi32(_mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3)), 23));
+    __m128 value = _mm_mul_ps(_mm_mul_ps(mantissa, scale), exponent);
+    return _mm_or_ps(_mm_and_ps(value, rgb_mask), alpha_one);
+}
+
+// Vector form of FloatToHalf, left in 32-bit lanes.
+static inline __m128i FloatToHalfSSE2(__m128 value)
+{
+    const __m128i denormal_limit = _mm_set1_epi32(113 << 23);
+    const __m128i magic_bits = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i rebias = _mm_set1_epi32((int)(((Uint32)(15 - 127) << 23) + 0xFFF));
+    const __m128i one = _mm_set1_epi32(1);
+
+    value = _mm_min_ps(value, _mm_set1_ps(HDR_HALF_MAX));
+    __m128i bits = _mm_castps_si128(value);
+    __m128i denormal = _mm_cmplt_epi32(bits, denormal_limit);
+
+    __m128i denormal_result = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(value, _mm_castsi128_ps(magic_bits))), magic_bits);
+    __m128i mantissa_odd = _mm_and_si128(_mm_srli_epi32(bits, 13), one);
+    __m128i normal_result = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, rebias), mantissa_odd), 13);
+
+    return _mm_or_si128(_mm_and_si128(denormal, denormal_result), _mm_andnot_si128(denormal, normal_result));
+}
+
+static void ConvertRGBEToFloatSSE2(const Uint8 *rgbe, float *rgba, Uint32 count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    Uint32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i bytes = BiasExponentsSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbe + i * 4)));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_ps(rgba + i * 4 + 0, RGBEToFloatSSE2(_mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_ps(rgba + i * 4 + 4, RGBEToFloatSSE2(_mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_ps(rgba + i * 4 + 8, RGBEToFloatSSE2(_mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_ps(rgba + i * 4 + 12, RGBEToFloatSSE2(_mm_unpackhi_epi16(high, zero)));
+    }
+    ConvertRGBEToFloatScalar(rgbe + i * 4, rgba + i * 4, count - i);
+}
+
+static void ConvertRGBEToHalfSSE2(const Uint8 *rgbe, Uint16 *rgba, Uint32 count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    Uint32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i bytes = BiasExponentsSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbe + i * 4)));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i h0 = FloatToHalfSSE2(RGBEToFloatSSE2(_mm_unpacklo_epi16(low, zero)));
+        __m128i h1 = FloatToHalfSSE2(RGBEToFloatSSE2(_mm_unpackhi_epi16(low, zero)));
+        __m128i h2 = FloatToHalfSSE2(RGBEToFloatSSE2(_mm_unpacklo_epi16(high, zero)));
+        __m128i h3 = FloatToHalfSSE2(RGBEToFloatSSE2(_mm_unpackhi_epi16(high, zero)));
+        // Halves are at most 0x7BFF, so the signed saturating pack is exact.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4 + 0), _mm_packs_epi32(h0, h1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4 + 8), _mm_packs_epi32(h2, h3));
+    }
+    ConvertRGBEToHalfScalar(rgbe + i * 4, rgba + i * 4, count - i);
+}
+
+#endif // SDL_SSE2_INTRINSICS
+
+#ifdef SDL_AVX2_INTRINSICS
+
+// Two pixels per register, one per 128-bit lane.
+SDL_TARGETING("avx2") static inline __m256 RGBEToFloatAVX2(__m128i two_pixels)
+{
+    __m256i pixel = _mm256_cvtepu8_epi32(two_pixels);
+    __m256 mantissa = _mm256_cvtepi32_ps(pixel);
+    __m256 exponent = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3)), 23));
+    __m256 value = _mm256_mul_ps(_mm256_mul_ps(mantissa, _mm256_set1_ps(RGBE_SCALE)), exponent);
+    return _mm256_blend_ps(value, _mm256_set1_ps(1.0f), 0x88);
+}
+
+SDL_TARGETING("avx2") static void ConvertRGBEToFloatAVX2(const Uint8 *rgbe, float *rgba, Uint32 count)
+{
+    Uint32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i bytes = BiasExponentsSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbe + i * 4)));
+        _mm256_storeu_ps(rgba + i * 4 + 0, RGBEToFloatAVX2(bytes));
+        _mm256_storeu_ps(rgba + i * 4 + 8, RGBEToFloatAVX2(_mm_unpackhi_epi64(bytes, bytes)));
+    }
+    ConvertRGBEToFloatScalar(rgbe + i * 4, rgba + i * 4, count - i);
+}
+
+// Every AVX2 CPU also has F16C, whose conversion is exactly round-to-nearest-even.
+SDL_TARGETING("avx2,f16c") static void ConvertRGBEToHalfAVX2(const Uint8 *rgbe, Uint16 *rgba, Uint32 count)
+{
+    const __m256 half_max = _mm256_set1_ps(HDR_HALF_MAX);
+    Uint32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i bytes = BiasExponentsSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbe + i * 4)));
+        __m256 low = _mm256_min_ps(RGBEToFloatAVX2(bytes), half_max);
+        __m256 high = _mm256_min_ps(RGBEToFloatAVX2(_mm_unpackhi_epi64(bytes, bytes)), half_max);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4 + 0), _mm256_cvtps_ph(low, _MM_FROUND_TO_NEAREST_INT));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4 + 8), _mm256_cvtps_ph(high, _MM_FROUND_TO_NEAREST_INT));
+    }
+    ConvertRGBEToHalfScalar(rgbe + i * 4, rgba + i * 4, count - i);
+}
+
+#endif // SDL_AVX2_INTRINSICS
+
+HDRConvertPath ResolveHDRConvertPath(HDRConvertPath path)
+{
+#ifdef SDL_AVX2_INTRINSICS
+    if ((path == HDR_CONVERT_AUTO || path == HDR_CONVERT_AVX2) && SDL_HasAVX2()) {
+        return HDR_CONVERT_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if ((path == HDR_CONVERT_AUTO || path == HDR_CONVERT_AVX2 || path == HDR_CONVERT_SSE2) && SDL_HasSSE2()) {
+        return HDR_CONVERT_SSE2;
+    }
+#endif
+    return HDR_CONVERT_SCALAR;
+}
+
+void ConvertRGBEToFloat(const Uint8 *rgbe, float *rgba, Uint32 count, HDRConvertPath path)
+{
+    switch (ResolveHDRConvertPath(path)) {
+#ifdef SDL_AVX2_INTRINSICS
+        case HDR_CONVERT_AVX2: ConvertRGBEToFloatAVX2(rgbe, rgba, count); return;
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+        case HDR_CONVERT_SSE2: ConvertRGBEToFloatSSE2(rgbe, rgba, count); return;
+#endif
+        default: ConvertRGBEToFloatScalar(rgbe, rgba, count); return;
+    }
+}
+
+void ConvertRGBEToHalf(const Uint8 *rgbe, Uint16 *rgba, Uint32 count, HDRConvertPath path)
+{
+    switch (ResolveHDRConvertPath(path)) {
+#ifdef SDL_AVX2_INTRINSICS
+        case HDR_CONVERT_AVX2: ConvertRGBEToHalfAVX2(rgbe, rgba, count); return;
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+        case HDR_CONVERT_SSE2: ConvertRGBEToHalfSSE2(rgbe, rgba, count); return;
+#endif
+        default: ConvertRGBEToHalfScalar(rgbe, rgba, count); return;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Whole image
+// ---------------------------------------------------------------------------
+
+typedef struct HDRConvertJob
+{
+    const Uint8 *rgbe;
+    HDRImage *image;
+    HDRConvertPath path;
+} HDRConvertJob;
+
+static void ConvertRowBlock(Uint32 index, void *userdata)
+{
+    HDRConvertJob *job = static_cast<HDRConvertJob*>(userdata);
+    Uint32 first_row = index * HDR_CONVERT_ROWS_PER_JOB;
+    Uint32 num_rows = SDL_min(HDR_CONVERT_ROWS_PER_JOB, job->image->height - first_row);
+    size_t first = (size_t)first_row * job->image->width;
+    Uint32 count = num_rows * job->image->width;
+
+    if (job->image->format == HDR_PIXELFORMAT_RGBA16F) {
+        ConvertRGBEToHalf(job->rgbe + first * 4, static_cast<Uint16*>(job->image->pixels) + first * 4, count, job->path);
+    } else {
+        ConvertRGBEToFloat(job->rgbe + first * 4, static_cast<float*>(job->image->pixels) + first * 4, count, job->path);
+    }
+}
+
+bool DecodeHDR(const void *file_data, size_t file_size, HDRPixelFormat format, JobSystem *jobs, HDRImage *image)
+{
+    HDRHeader header;
+    if (!ParseHeader(file_data, file_size, &header)) {
+        return false;
+    }
+
+    Uint64 num_pixels = (Uint64)header.width * header.height;
+    Uint8 *rgbe = static_cast<Uint8*>(SDL_malloc((size_t)num_pixels * 4));
+    if (rgbe == NULL) {
+        return false;
+    }
+    if (!DecodeScanlines(file_data, file_size, &header, rgbe)) {
+        SDL_free(rgbe);
+        return false;
+    }
+
+    image->width = header.width;
+    image->height = header.height;
+    image->format = format;
+    image->size = num_pixels * 4 * (format == HDR_PIXELFORMAT_RGBA16F ? sizeof(Uint16) : sizeof(float));
+    image->pixels = SDL_malloc((size_t)image->size);
+    if (image->pixels == NULL) {
+        SDL_free(rgbe);
+        return false;
+    }
+
+    // The RLE pass is inherently serial; the conversion is split into jobs.
+    HDRConvertJob job = { rgbe, image, HDR_CONVERT_AUTO };
+    ParallelFor(jobs, (header.height + HDR_CONVERT_ROWS_PER_JOB - 1) / HDR_CONVERT_ROWS_PER_JOB, ConvertRowBlock, &job);
+
+    SDL_free(rgbe);
+    return true;
+}
+
+void FreeHDRImage(HDRImage *image)
+{
+    SDL_free(image->pixels);
+    image->pixels = NULL;
+}
+
+SDL_GPUTextureFormat GetHDRTextureFormat(HDRPixelFormat format)
+{
+    return format == HDR_PIXELFORMAT_RGBA16F ? SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT : SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+
+// Radiance .hdr (RGBE) reader. Scanlines may be flat, old-style RLE or the
+// usual per-channel RLE. Decoding runs in two steps: the RLE pass produces
+// RGBE bytes, then a SIMD kernel (AVX2+F16C, SSE2 or scalar, picked at
+// runtime) expands them to RGBA half or float on the job system. Like the
+// DDS/ASTC parsers, nothing is read outside [data, data + size).
+
+typedef enum HDRPixelFormat
+{
+    HDR_PIXELFORMAT_RGBA16F,    // SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT
+    HDR_PIXELFORMAT_RGBA32F     // SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT
+} HDRPixelFormat;
+
+typedef enum HDRConvertPath
+{
+    HDR_CONVERT_AUTO,           // Best path the CPU supports
+    HDR_CONVERT_SCALAR,
+    HDR_CONVERT_SSE2,
+    HDR_CONVERT_AVX2
+} HDRConvertPath;
+
+typedef struct HDRImage
+{
+    Uint32 width;
+    Uint32 height;
+    HDRPixelFormat format;
+    void *pixels;               // Tightly packed rows, top row first; SDL_malloc'd
+    Uint64 size;
+} HDRImage;
+
+// Reads the header only.
+bool ParseHDRHeader(const void *file_data, size_t file_size, Uint32 *width, Uint32 *height);
+
+// Writes width * height * 4 RGBE bytes, top row first.
+bool DecodeHDRScanlines(const void *file_data, size_t file_size, Uint8 *rgbe, Uint32 width, Uint32 height);
+
+// jobs may be NULL, which converts on the calling thread.
+bool DecodeHDR(const void *file_data, size_t file_size, HDRPixelFormat format, JobSystem *jobs, HDRImage *image);
+void FreeHDRImage(HDRImage *image);
+
+SDL_GPUTextureFormat GetHDRTextureFormat(HDRPixelFormat format);
+
+// The conversion kernels, exposed for the benchmark. Alpha is 1. Half output
+// is clamped to 65504 so bright texels never become infinity; all paths
+// produce bit-identical results.
+HDRConvertPath ResolveHDRConvertPath(HDRConvertPath path);
+void ConvertRGBEToFloat(const Uint8 *rgbe, float *rgba, Uint32 count, HDRConvertPath path);
+void ConvertRGBEToHalf(const Uint8 *rgbe, Uint16 *rgba, Uint32 count, HDRConvertPath path);
@@ -0,0 +1,284 @@
+#include <SDL3/SDL.h>
+#include <input.hpp>
+
+struct InputRecorder
+{
+    InputEvent *events;         // Ring of mask + 1
+    Uint32 mask;
+    SDL_SpinLock push_lock;     // Serializes producers: head, high_water and the pointer latch
+    SDL_AtomicU32 head;         // Events ever pushed; stored under push_lock
+    SDL_AtomicU32 tail;         // Events ever consumed; only the consumer stores it
+    SDL_AtomicInt dropped;
+    SDL_AtomicU32 high_water;
+
+    // Newest pointer position, under a sequence count that is odd while the producer writes it
+    SDL_AtomicU32 pointer_sequence;
+    float pointer_x, pointer_y;
+    Uint64 pointer_timestamp;
+};
+
+InputRecorder* CreateInputRecorder(Uint32 capacity)
+{
+    Uint32 size = 1;
+    while (size < capacity && size < 0x80000000u) {
+        size <<= 1;
+    }
+    InputRecorder *recorder = static_cast<InputRecorder*>(SDL_calloc(1, sizeof(InputRecorder)));
+    if (recorder == NULL) {
+        return NULL;
+    }
+    recorder->events = static_cast<InputEvent*>(SDL_malloc(size * sizeof(InputEvent)));
+    if (recorder->events == NULL) {
+        SDL_free(recorder);
+        return NULL;
+    }
+    recorder->mask = size - 1;
+    return recorder;
+}
+
+void DestroyInputRecorder(InputRecorder *recorder)
+{
+    if (recorder == NULL) {
+        return;
+    }
+    SDL_free(recorder->events);
+    SDL_free(recorder);
+}
+
+// Called with push_lock held.
+static bool PushInputEventLocked(InputRecorder *recorder, const InputEvent *event)
+{
+    Uint32 head = SDL_GetAtomicU32(&recorder->head);
+    Uint32 queued = head - SDL_GetAtomicU32(&recorder->tail);
+    if (queued > recorder->mask) {
+        SDL_AddAtomicInt(&recorder->dropped, 1);
+        return false;
+    }
+    recorder->events[head & recorder->mask] = *event;
+    // Publishes the event: the consumer reads head before the slot
+    SDL_SetAtomicU32(&recorder->head, head + 1);
+    if (queued + 1 > SDL_GetAtomicU32(&recorder->high_water)) {
+        SDL_SetAtomicU32(&recorder->high_water, queued + 1);
+    }
+    return true;
+}
+
+bool PushInputEvent(InputRecorder *recorder, const InputEvent *event)
+{
+    SDL_LockSpinlock(&recorder->push_lock);
+    bool pushed = PushInputEventLocked(recorder, event);
+    SDL_UnlockSpinlock(&recorder->push_lock);
+    return pushed;
+}
+
+// Called with push_lock held, so there is one writer.
+static void LatchPointer(InputRecorder *recorder, float x, float y, Uint64 timestamp)
+{
+    Uint32 sequence = SDL_GetAtomicU32(&recorder->pointer_sequence);
+    SDL_SetAtomicU32(&recorder->pointer_sequence, sequence + 1);
+    // The odd count must be visible before any of the payload; pairs with the reader's acquire
+    SDL_MemoryBarrierRelease();
+    recorder->pointer_x = x;
+    recorder->pointer_y = y;
+    recorder->pointer_timestamp = timestamp;
+    SDL_MemoryBarrierRelease();
+    SDL_SetAtomicU32(&recorder->pointer_sequence, sequence + 2);
+}
+
+bool RecordInputEvent(InputRecorder *recorder, const SDL_Event *event)
+{
+    InputEvent input = {};
+    input.timestamp = event->common.timestamp != 0 ? event->common.timestamp : SDL_GetTicksNS();
+    switch (event->type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        // Held-key repeats aren't presses
+        if (event->key.repeat) {
+            return false;
+        }
+        input.type = INPUT_KEY;
+        input.device = event->key.which;
+        input.code = (Uint16)event->key.scancode;
+        input.down = event->key.down;
+        break;
+    case SDL_EVENT_MOUSE_MOTION:
+        input.type = INPUT_MOUSE_MOTION;
+        input.device = event->motion.which;
+        input.x = event->motion.x;
+        input.y = event->motion.y;
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        input.type = INPUT_MOUSE_BUTTON;
+        input.device = event->button.which;
+        input.code = event->button.button;
+        input.down = event->button.down;
+        input.x = event->button.x;
+        input.y = event->button.y;
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        input.type = INPUT_MOUSE_WHEEL;
+        input.device = event->wheel.which;
+        input.x = event->wheel.x;
+        input.y = event->wheel.y;
+        break;
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+        input.type = INPUT_GAMEPAD_BUTTON;
+        input.device = event->gbutton.which;
+        input.code = event->gbutton.button;
+        input.down = event->gbutton.down;
+        break;
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        input.type = INPUT_GAMEPAD_AXIS;
+        input.device = event->gaxis.which;
+        input.code = event->gaxis.axis;
+        input.x = SDL_max(event->gaxis.value / (float)SDL_JOYSTICK_AXIS_MAX, -1.0f);
+        break;
+    default:
+        return false;
+    }
+    SDL_LockSpinlock(&recorder->push_lock);
+    if (input.type == INPUT_MOUSE_MOTION) {
+        LatchPointer(recorder, input.x, input.y, input.timestamp);
+    }
+    bool pushed = PushInputEventLocked(recorder, &input);
+    SDL_UnlockSpinlock(&recorder->push_lock);
+    return pushed;
+}
+
+bool SDLCALL InputEventWatch(void *userdata, SDL_Event *event)
+{
+    RecordInputEvent(static_cast<InputRecorder*>(userdata), event);
+    return true;
+}
+
+Uint32 ConsumeInputEvents(InputRecorder *recorder, Uint64 before_ns, InputEvent *events, Uint32 max_events)
+{
+    Uint32 tail = SDL_GetAtomicU32(&recorder->tail);
+    Uint32 head = SDL_GetAtomicU32(&recorder->head);
+    Uint32 count = 0;
+    while (tail != head && count < max_events) {
+        const InputEvent *event = &recorder->events[tail & recorder->mask];
+        if (event->timestamp >= before_ns) {
+            break;
+        }
+        events[count++] = *event;
+        tail++;
+    }
+    // Hands the slots back: the producer reads tail before reusing them
+    SDL_SetAtomicU32(&recorder->tail, tail);
+    return count;
+}
+
+bool GetLatestPointer(const InputRecorder *recorder, float *x, float *y, Uint64 *timestamp)
+{
+    InputRecorder *mutable_recorder = const_cast<InputRecorder*>(recorder);
+    for (;;) {
+        Uint32 sequence = SDL_GetAtomicU32(&mutable_recorder->pointer_sequence);
+        if (sequence & 1) {
+            SDL_CPUPauseInstruction();
+            continue;
+        }
+        *x = recorder->pointer_x;
+        *y = recorder->pointer_y;
+        *timestamp = recorder->pointer_timestamp;
+        SDL_MemoryBarrierAcquire();
+        if (SDL_GetAtomicU32(&mutable_recorder->pointer_sequence) == sequence) {
+            return sequence != 0;
+        }
+    }
+}
+
+InputStats GetInputStats(const InputRecorder *recorder)
+{
+    InputRecorder *mutable_recorder = const_cast<InputRecorder*>(recorder);
+    InputStats stats;
+    Uint32 tail = SDL_GetAtomicU32(&mutable_recorder->tail);
+    Uint32 head = SDL_GetAtomicU32(&mutable_recorder->head);
+    stats.recorded = head;
+    stats.dropped = (Uint32)SDL_GetAtomicInt(&mutable_recorder->dropped);
+    stats.consumed = tail;
+    stats.queued = head - tail;
+    stats.queued_high_water = SDL_GetAtomicU32(&mutable_recorder->high_water);
+    return stats;
+}
+
+void ApplyInputEvent(InputState *state, const InputEvent *event)
+{
+    bool press = false;
+    switch (event->type) {
+    case INPUT_KEY:
+        if (event->code < SDL_SCANCODE_COUNT) {
+            Uint64 bit = (Uint64)1 << (event->code % 64);
+            state->keys[event->code / 64] = event->down ? state->keys[event->code / 64] | bit : state->keys[event->code / 64] & ~bit;
+        }
+        press = event->down;
+        break;
+    case INPUT_MOUSE_MOTION:
+        state->mouse_x = event->x;
+        state->mouse_y = event->y;
+        break;
+    case INPUT_MOUSE_BUTTON:
+        if (event->code >= 1 && event->code <= 32) {
+            Uint32 bit = 1u << (event->code - 1);
+            state->mouse_buttons = event->down ? state->mouse_buttons | bit : state->mouse_buttons & ~bit;
+        }
+        state->mouse_x = event->x;
+        state->mouse_y = event->y;
+        press = event->down;
+        break;
+    case INPUT_GAMEPAD_BUTTON:
+        if (event->code < 32) {
+            Uint32 bit = 1u << event->code;
+            state->gamepad_buttons = event->down ? state->gamepad_buttons | bit : state->gamepad_buttons & ~bit;
+        }
+        press = event->down;
+        break;
+    case INPUT_GAMEPAD_AXIS:
+        if (event->code < SDL_GAMEPAD_AXIS_COUNT) {
+            state->gamepad_axes[event->code] = event->x;
+        }
+        break;
+    default:
+        break;
+    }
+    if (press) {
+        state->last_press = event->timestamp;
+    }
+    state->last_event = event->timestamp;
+}
+
+void AddInputLatencySample(InputLatency *latency, double ms)
+{
+    latency->samples_ms[latency->next] = (float)ms;
+    latency->next = (latency->next + 1) % INPUT_LATENCY_SAMPLES;
+    latency->count = SDL_min(latency->count + 1, (Uint32)INPUT_LATENCY_SAMPLES);
+}
+
+static int CompareFloats(const void *a, const void *b)
+{
+    float x = *static_cast<const float*>(a), y = *static_cast<const float*>(b);
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+InputLatencyStats GetInputLatencyStats(const InputLatency *latency)
+{
+    InputLatencyStats stats = {};
+    stats.samples = latency->count;
+    if (latency->count == 0) {
+        return stats;
+    }
+    float sorted[INPUT_LATENCY_SAMPLES];
+    SDL_memcpy(sorted, latency->samples_ms, latency->count * sizeof(float));
+    SDL_qsort(sorted, latency->count, sizeof(float), CompareFloats);
+    double sum = 0.0;
+    for (Uint32 i = 0; i < latency->count; i++) {
+        sum += sorted[i];
+    }
+    stats.average_ms = sum / latency->count;
+    stats.p50_ms = sorted[(latency->count - 1) / 2];
+    stats.p99_ms = sorted[(latency->count - 1) * 99 / 100];
+    stats.max_ms = sorted[latency->count - 1];
+    return stats;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Keyboard, mouse and gamepad events recorded the moment SDL queues them,
+// with SDL's nanosecond timestamps (the SDL_GetTicksNS clock), into a
+// ring with one consumer. Producers come from an event watch, which runs on
+// whichever thread pushes an event (usually the one pumping events, but
+// SDL_PushEvent and some platforms' input threads are others), so pushes are
+// serialized by a spinlock; the consumer never takes it. The consumer is the simulation,
+// which takes events up to each fixed tick's end time, so an event lands in
+// the tick its timestamp falls in whatever the frame rate, and hit timing
+// can be judged from the timestamp itself rather than the tick or frame.
+//
+// The newest pointer position is also kept apart from the ring, readable from
+// any thread, for late latching: the render side reads it as late as it can
+// before submitting, after pumping events once more.
+
+#define INPUT_LATENCY_SAMPLES 256
+
+typedef enum InputEventType
+{
+    INPUT_KEY,
+    INPUT_MOUSE_MOTION,
+    INPUT_MOUSE_BUTTON,
+    INPUT_MOUSE_WHEEL,
+    INPUT_GAMEPAD_BUTTON,
+    INPUT_GAMEPAD_AXIS
+} InputEventType;
+
+typedef struct InputEvent
+{
+    Uint64 timestamp;           // ns, SDL_GetTicksNS clock
+    Uint32 device;              // Keyboard, mouse or joystick instance
+    Uint16 type;                // InputEventType
+    Uint16 code;                // Scancode, mouse or gamepad button, gamepad axis
+    bool down;
+    float x, y;                 // Pointer position, wheel scroll, or axis value in [-1, 1] in x
+} InputEvent;
+
+typedef struct InputStats
+{
+    Uint32 recorded;
+    Uint32 dropped;             // Ring full; the consumer fell behind
+    Uint32 consumed;
+    Uint32 queued;
+    Uint32 queued_high_water;
+} InputStats;
+
+// What the simulation knows of the devices, built from consumed events.
+typedef struct InputState
+{
+    Uint64 keys[SDL_SCANCODE_COUNT / 64];
+    Uint32 mouse_buttons;       // Bit n - 1 for SDL button n
+    Uint32 gamepad_buttons;     // Any gamepad; bit per SDL_GamepadButton
+    float gamepad_axes[SDL_GAMEPAD_AXIS_COUNT];
+    float mouse_x, mouse_y;
+    Uint64 last_press;          // Timestamp of the newest key or button press
+    Uint64 last_event;
+} InputState;
+
+typedef struct InputLatencyStats
+{
+    Uint32 samples;
+    double average_ms;
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+} InputLatencyStats;
+
+// The last INPUT_LATENCY_SAMPLES input-to-submit times.
+typedef struct InputLatency
+{
+    float samples_ms[INPUT_LATENCY_SAMPLES];
+    Uint32 count;
+    Uint32 next;
+} InputLatency;
+
+typedef struct InputRecorder InputRecorder;
+
+// capacity is rounded up to a power of two.
+InputRecorder* CreateInputRecorder(Uint32 capacity);
+void DestroyInputRecorder(InputRecorder *recorder);
+
+// Producer side, any thread. Returns false for events that aren't
+// keyboard, mouse or gamepad input, and when the ring is full (counted as dropped).
+bool RecordInputEvent(InputRecorder *recorder, const SDL_Event *event);
+bool PushInputEvent(InputRecorder *recorder, const InputEvent *event);
+// For SDL_AddEventWatch with the recorder as userdata; never filters anything out.
+bool SDLCALL InputEventWatch(void *userdata, SDL_Event *event);
+
+// Consumer side, one thread at a time. Copies out, oldest first, up to
+// max_events events timestamped before before_ns and returns how many.
+Uint32 ConsumeInputEvents(InputRecorder *recorder, Uint64 before_ns, InputEvent *events, Uint32 max_events);
+
+// Any thread: the newest pointer position and when it was recorded. False
+// until the pointer has moved.
+bool GetLatestPointer(const InputRecorder *recorder, float *x, float *y, Uint64 *timestamp);
+
+InputStats GetInputStats(const InputRecorder *recorder);
+
+void ApplyInputEvent(InputState *state, const InputEvent *event);
+static inline bool IsInputKeyDown(const InputState *state, SDL_Scancode scancode)
+{
+    return (state->keys[scancode / 64] >> (scancode % 64)) & 1;
+}
+
+void AddInputLatencySample(InputLatency *latency, double ms);
+InputLatencyStats GetInputLatencyStats(const InputLatency *latency);
@@ -0,0 +1,634 @@
+#include <SDL3/SDL.h>
+
+#include <jobs.hpp>
+#include <profiler.hpp>
+
+int GetWorkerThreadCount()
+{
+    return SDL_max(SDL_GetNumLogicalCPUCores(), 1);
+}
+
+// ---------------------------------------------------------------------------
+// Job system
+// ---------------------------------------------------------------------------
+
+#define JOB_MAX_WORKERS 64
+#define JOB_DEQUE_INITIAL_CAPACITY 256
+#define JOB_QUEUE_INITIAL_CAPACITY 64
+#define JOB_WAIT_SPINS 64           // Failed attempts to find work before a waiter yields
+#define JOB_CACHE_LINE 64
+
+typedef struct Job
+{
+    JobFunction fn;
+    void *userdata;
+    JobCounter *counter;
+    JobPriority priority;           // Known from the queue it was taken from; not in JobSlot
+} Job;
+
+// Thieves read a slot while the owner may be reusing it (their CAS on top
+// then fails), so every field is accessed atomically.
+typedef struct JobSlot
+{
+    void *fn;
+    void *userdata;
+    void *counter;
+} JobSlot;
+
+typedef struct JobDequeBuffer JobDequeBuffer;
+struct JobDequeBuffer
+{
+    Uint32 capacity;                // Power of two
+    JobSlot *slots;                 // Follows the header in the same allocation
+    JobDequeBuffer *retired;        // The smaller buffer it replaced; thieves may still be reading it
+};
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013). The
+// owner pushes and pops at the bottom, anyone steals from the top, and only
+// taking the last job needs a CAS. SDL's atomics are sequentially consistent,
+// which covers the fences the algorithm needs. Indices wrap; only their
+// differences matter. top and bottom sit on separate cache lines.
+typedef struct JobDeque
+{
+    SDL_AtomicInt top;
+    char padding0[JOB_CACHE_LINE];
+    SDL_AtomicInt bottom;
+    void *buffer;                   // JobDequeBuffer, replaced when it grows
+    char padding1[JOB_CACHE_LINE];
+} JobDeque;
+
+// Locked FIFO for submissions from threads that don't own a deque, and for
+// main-thread-only jobs.
+typedef struct JobQueue
+{
+    SDL_Mutex *mutex;
+    Job *jobs;
+    Uint32 capacity;                // Power of two
+    Uint32 front;
+    Uint32 back;
+    SDL_AtomicInt count;            // Lets takers skip the lock when it's empty
+} JobQueue;
+
+// One per worker, one for the main thread, and a last one whose deques are
+// unused that counts for every other thread.
+typedef struct JobThreadState
+{
+    JobDeque deques[JOB_PRIORITY_COUNT];
+    SDL_AtomicInt executed;
+    SDL_AtomicInt stolen;
+    SDL_AtomicInt steal_attempts;
+    char padding[JOB_CACHE_LINE];
+} JobThreadState;
+
+struct JobSystem
+{
+    SDL_Thread *threads[JOB_MAX_WORKERS];
+    int num_workers;
+    int num_started;                // Workers whose threads are running
+    JobThreadState *states;         // num_workers + 2
+    JobQueue shared[JOB_PRIORITY_COUNT];
+    JobQueue main_thread_queue;
+    SDL_AtomicInt main_thread_executed;
+
+    SDL_Mutex *sleep_mutex;
+    SDL_Condition *wake_condition;
+    SDL_AtomicInt queued;           // Jobs in any deque or shared queue
+    SDL_AtomicInt sleeping;         // Workers waiting on wake_condition
+    SDL_AtomicInt quit;
+};
+
+typedef struct JobWorker
+{
+    JobSystem *jobs;
+    int index;                      // Deque owned by this thread; num_workers for the main thread
+    Uint32 seed;                    // Picks where to start looking for jobs to steal
+} JobWorker;
+
+static thread_local JobWorker tls_worker = { NULL, -1, 0 };
+// Of the job running on this thread, innermost first
+static thread_local JobPriority tls_priority = JOB_PRIORITY_NORMAL;
+
+static int GetCurrentWorker(const JobSystem *jobs)
+{
+    return tls_worker.jobs == jobs ? tls_worker.index : -1;
+}
+
+static JobThreadState* GetCurrentState(JobSystem *jobs)
+{
+    int self = GetCurrentWorker(jobs);
+    return &jobs->states[self >= 0 ? self : jobs->num_workers + 1];
+}
+
+// ---------------------------------------------------------------------------
+// Deques
+// ---------------------------------------------------------------------------
+
+static JobDequeBuffer* CreateJobDequeBuffer(Uint32 capacity)
+{
+    JobDequeBuffer *buffer = static_cast<JobDequeBuffer*>(SDL_malloc(sizeof(JobDequeBuffer) + capacity * sizeof(JobSlot)));
+    if (buffer == NULL) {
+        return NULL;
+    }
+    buffer->capacity = capacity;
+    buffer->slots = reinterpret_cast<JobSlot*>(buffer + 1);
+    buffer->retired = NULL;
+    return buffer;
+}
+
+static bool InitJobDeque(JobDeque *deque)
+{
+    SDL_SetAtomicInt(&deque->top, 0);
+    SDL_SetAtomicInt(&deque->bottom, 0);
+    JobDequeBuffer *buffer = CreateJobDequeBuffer(JOB_DEQUE_INITIAL_CAPACITY);
+    SDL_SetAtomicPointer(&deque->buffer, buffer);
+    return buffer != NULL;
+}
+
+static void FreeJobDeque(JobDeque *deque)
+{
+    JobDequeBuffer *buffer = static_cast<JobDequeBuffer*>(SDL_GetAtomicPointer(&deque->buffer));
+    while (buffer != NULL) {
+        JobDequeBuffer *retired = buffer->retired;
+        SDL_free(buffer);
+        buffer = retired;
+    }
+}
+
+static void WriteJobSlot(JobSlot *slot, const Job *job)
+{
+    SDL_SetAtomicPointer(&slot->fn, reinterpret_cast<void*>(job->fn));
+    SDL_SetAtomicPointer(&slot->userdata, job->userdata);
+    SDL_SetAtomicPointer(&slot->counter, job->counter);
+}
+
+static void ReadJobSlot(JobSlot *slot, Job *job)
+{
+    job->fn = reinterpret_cast<JobFunction>(SDL_GetAtomicPointer(&slot->fn));
+    job->userdata = SDL_GetAtomicPointer(&slot->userdata);
+    job->counter = static_cast<JobCounter*>(SDL_GetAtomicPointer(&slot->counter));
+}
+
+// Owner only.
+static bool PushJobDeque(JobDeque *deque, const Job *job)
+{
+    Uint32 bottom = (Uint32)SDL_GetAtomicInt(&deque->bottom);
+    Uint32 top = (Uint32)SDL_GetAtomicInt(&deque->top);
+    JobDequeBuffer *buffer = static_cast<JobDequeBuffer*>(SDL_GetAtomicPointer(&deque->buffer));
+    if (bottom - top >= buffer->capacity) {
+        JobDequeBuffer *grown = CreateJobDequeBuffer(buffer->capacity * 2);
+        if (grown == NULL) {
+            return false;
+        }
+        for (Uint32 i = top; i != bottom; i++) {
+            Job moved;
+            ReadJobSlot(&buffer->slots[i & (buffer->capacity - 1)], &moved);
+            WriteJobSlot(&grown->slots[i & (grown->capacity - 1)], &moved);
+        }
+        grown->retired = buffer;
+        SDL_SetAtomicPointer(&deque->buffer, grown);
+        buffer = grown;
+    }
+    WriteJobSlot(&buffer->slots[bottom & (buffer->capacity - 1)], job);
+    SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+    return true;
+}
+
+// Owner only.
+static bool PopJobDeque(JobDeque *deque, Job *job)
+{
+    Uint32 bottom = (Uint32)SDL_GetAtomicInt(&deque->bottom) - 1;
+    JobDequeBuffer *buffer = static_cast<JobDequeBuffer*>(SDL_GetAtomicPointer(&deque->buffer));
+    SDL_SetAtomicInt(&deque->bottom, (int)bottom);
+    Uint32 top = (Uint32)SDL_GetAtomicInt(&deque->top);
+    Sint32 size = (Sint32)(bottom - top);
+    if (size < 0) {
+        SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+        return false;
+    }
+    ReadJobSlot(&buffer->slots[bottom & (buffer->capacity - 1)], job);
+    if (size > 0) {
+        return true;
+    }
+    // The last job: a thief may be taking it at the same moment.
+    bool won = SDL_CompareAndSwapAtomicInt(&deque->top, (int)top, (int)(top + 1));
+    SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+    return won;
+}
+
+// Any thread. Fails if empty or if another thread took the job first.
+static bool StealJobDeque(JobDeque *deque, Job *job)
+{
+    Uint32 top = (Uint32)SDL_GetAtomicInt(&deque->top);
+    Uint32 bottom = (Uint32)SDL_GetAtomicInt(&deque->bottom);
+    if ((Sint32)(bottom - top) <= 0) {
+        return false;
+    }
+    JobDequeBuffer *buffer = static_cast<JobDequeBuffer*>(SDL_GetAtomicPointer(&deque->buffer));
+    ReadJobSlot(&buffer->slots[top & (buffer->capacity - 1)], job);
+    return SDL_CompareAndSwapAtomicInt(&deque->top, (int)top, (int)(top + 1));
+}
+
+// ---------------------------------------------------------------------------
+// Locked queues
+// ---------------------------------------------------------------------------
+
+static bool InitJobQueue(JobQueue *queue)
+{
+    queue->mutex = SDL_CreateMutex();
+    queue->jobs = static_cast<Job*>(SDL_malloc(JOB_QUEUE_INITIAL_CAPACITY * sizeof(Job)));
+    queue->capacity = JOB_QUEUE_INITIAL_CAPACITY;
+    queue->front = 0;
+    queue->back = 0;
+    SDL_SetAtomicInt(&queue->count, 0);
+    return queue->mutex != NULL && queue->jobs != NULL;
+}
+
+static void FreeJobQueue(JobQueue *queue)
+{
+    SDL_DestroyMutex(queue->mutex);
+    SDL_free(queue->jobs);
+}
+
+static bool PushJobQueue(JobQueue *queue, const Job *job)
+{
+    SDL_LockMutex(queue->mutex);
+    if (queue->back - queue->front == queue->capacity) {
+        Job *jobs = static_cast<Job*>(SDL_malloc(queue->capacity * 2 * sizeof(Job)));
+        if (jobs == NULL) {
+            SDL_UnlockMutex(queue->mutex);
+            return false;
+        }
+        for (Uint32 i = queue->front; i != queue->back; i++) {
+            jobs[i & (queue->capacity * 2 - 1)] = queue->jobs[i & (queue->capacity - 1)];
+        }
+        SDL_free(queue->jobs);
+        queue->jobs = jobs;
+        queue->capacity *= 2;
+    }
+    queue->jobs[queue->back & (queue->capacity - 1)] = *job;
+    queue->back++;
+    SDL_AddAtomicInt(&queue->count, 1);
+    SDL_UnlockMutex(queue->mutex);
+    return true;
+}
+
+static bool PopJobQueue(JobQueue *queue, Job *job)
+{
+    if (SDL_GetAtomicInt(&queue->count) == 0) {
+        return false;
+    }
+    SDL_LockMutex(queue->mutex);
+    bool found = queue->front != queue->back;
+    if (found) {
+        *job = queue->jobs[queue->front & (queue->capacity - 1)];
+        queue->front++;
+        SDL_AddAtomicInt(&queue->count, -1);
+    }
+    SDL_UnlockMutex(queue->mutex);
+    return found;
+}
+
+// ---------------------------------------------------------------------------
+// Scheduling
+// ---------------------------------------------------------------------------
+
+// Highest priority first, down to lowest; within one, own deque, then the
+// shared queue, then steal from the other deques starting at a random one.
+static bool TakeJob(JobSystem *jobs, int self, JobPriority lowest, Job *job, bool *stolen)
+{
+    if (SDL_GetAtomicInt(&jobs->queued) == 0) {
+        return false;
+    }
+    int num_deques = jobs->num_workers + 1;
+    tls_worker.seed = tls_worker.seed * 1664525 + 1013904223;
+    int start = (int)((tls_worker.seed >> 16) % (Uint32)num_deques);
+    JobThreadState *state = GetCurrentState(jobs);
+
+    bool found = false;
+    *stolen = false;
+    for (int priority = 0; priority <= lowest && !found; priority++) {
+        found = (self >= 0 && PopJobDeque(&jobs->states[self].deques[priority], job)) ||
+                PopJobQueue(&jobs->shared[priority], job);
+        for (int i = 0; i < num_deques && !found; i++) {
+            int victim = (start + i) % num_deques;
+            if (victim != self) {
+                SDL_AddAtomicInt(&state->steal_attempts, 1);
+                found = *stolen = StealJobDeque(&jobs->states[victim].deques[priority], job);
+            }
+        }
+        job->priority = (JobPriority)priority;
+    }
+    if (found) {
+        SDL_AddAtomicInt(&jobs->queued, -1);
+        if (*stolen) {
+            SDL_AddAtomicInt(&state->stolen, 1);
+        }
+    }
+    return found;
+}
+
+static void RunJob(JobSystem *jobs, const Job *job)
+{
+    JobPriority outer = tls_priority;
+    tls_priority = job->priority;
+    job->fn(job->userdata);
+    tls_priority = outer;
+    SDL_AddAtomicInt(&GetCurrentState(jobs)->executed, 1);
+    if (job->counter != NULL) {
+        SDL_AddAtomicInt(&job->counter->pending, -1);
+    }
+}
+
+static bool RunOneMainThreadJob(JobSystem *jobs)
+{
+    Job job;
+    if (!PopJobQueue(&jobs->main_thread_queue, &job)) {
+        return false;
+    }
+    SDL_AddAtomicInt(&jobs->main_thread_executed, 1);
+    RunJob(jobs, &job);
+    return true;
+}
+
+static int JobWorkerThread(void *data)
+{
+    tls_worker = *static_cast<JobWorker*>(data);
+    SDL_free(data);
+    JobSystem *jobs = tls_worker.jobs;
+    SetProfilerThreadName("JobWorker");
+
+    for (;;) {
+        Job job;
+        bool stolen;
+        if (TakeJob(jobs, tls_worker.index, JOB_PRIORITY_LOW, &job, &stolen)) {
+            RunJob(jobs, &job);
+            continue;
+        }
+        // Submitters only signal when someone is sleeping. sleeping goes up
+        // before queued is checked, so either the worker sees the new job or
+        // the submitter sees the sleeper.
+        SDL_LockMutex(jobs->sleep_mutex);
+        SDL_AddAtomicInt(&jobs->sleeping, 1);
+        while (SDL_GetAtomicInt(&jobs->queued) == 0 && !SDL_GetAtomicInt(&jobs->quit)) {
+            SDL_WaitCondition(jobs->wake_condition, jobs->sleep_mutex);
+        }
+        SDL_AddAtomicInt(&jobs->sleeping, -1);
+        bool quit = SDL_GetAtomicInt(&jobs->queued) == 0 && SDL_GetAtomicInt(&jobs->quit);
+        SDL_UnlockMutex(jobs->sleep_mutex);
+        if (quit) {
+            return 0;
+        }
+    }
+}
+
+JobSystem* CreateJobSystem(int num_workers)
+{
+    if (num_workers < 0) {
+        num_workers = GetWorkerThreadCount() - 1;
+    }
+    num_workers = SDL_clamp(num_workers, 0, JOB_MAX_WORKERS);
+
+    JobSystem *jobs = static_cast<JobSystem*>(SDL_calloc(1, sizeof(JobSystem)));
+    if (jobs == NULL) {
+        return NULL;
+    }
+    jobs->num_workers = num_workers;
+    jobs->states = static_cast<JobThreadState*>(SDL_calloc(num_workers + 2, sizeof(JobThreadState)));
+    jobs->sleep_mutex = SDL_CreateMutex();
+    jobs->wake_condition = SDL_CreateCondition();
+    bool ok = jobs->states != NULL && jobs->sleep_mutex != NULL && jobs->wake_condition != NULL;
+    for (int i = 0; ok && i <= num_workers; i++) {
+        for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+            ok = InitJobDeque(&jobs->states[i].deques[priority]) && ok;
+        }
+    }
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        ok = InitJobQueue(&jobs->shared[priority]) && ok;
+    }
+    ok = InitJobQueue(&jobs->main_thread_queue) && ok;
+    if (!ok) {
+        SDL_Log("Failed to create job system: %s", SDL_GetError());
+        DestroyJobSystem(jobs);
+        return NULL;
+    }
+
+    // The creating thread owns the last deque, so its submissions skip the shared queue.
+    tls_worker.jobs = jobs;
+    tls_worker.index = num_workers;
+    tls_worker.seed = (Uint32)SDL_GetTicksNS();
+
+    for (int i = 0; i < num_workers; i++) {
+        JobWorker *worker = static_cast<JobWorker*>(SDL_malloc(sizeof(JobWorker)));
+        if (worker == NULL) {
+            break;
+        }
+        worker->jobs = jobs;
+        worker->index = i;
+        worker->seed = (Uint32)i * 0x9E3779B9u + 1;
+        jobs->threads[i] = SDL_CreateThread(JobWorkerThread, "JobWorker", worker);
+        if (jobs->threads[i] == NULL) {
+            // Jobs still run: waiters execute them, and the remaining workers steal.
+            SDL_Log("Failed to create job worker %d: %s", i, SDL_GetError());
+            SDL_free(worker);
+        } else {
+            jobs->num_started++;
+        }
+    }
+    return jobs;
+}
+
+void DestroyJobSystem(JobSystem *jobs)
+{
+    if (jobs == NULL) {
+        return;
+    }
+    if (jobs->sleep_mutex != NULL && jobs->wake_condition != NULL) {
+        SDL_LockMutex(jobs->sleep_mutex);
+        SDL_SetAtomicInt(&jobs->quit, 1);
+        SDL_BroadcastCondition(jobs->wake_condition);
+        SDL_UnlockMutex(jobs->sleep_mutex);
+    }
+    for (int i = 0; i < jobs->num_workers; i++) {
+        if (jobs->threads[i] != NULL) {
+            SDL_WaitThread(jobs->threads[i], NULL);
+        }
+    }
+    if (jobs->states != NULL) {
+        // Workers that failed to start leave jobs behind; finish them here.
+        for (;;) {
+            Job job;
+            bool stolen;
+            if (TakeJob(jobs, GetCurrentWorker(jobs), JOB_PRIORITY_LOW, &job, &stolen)) {
+                RunJob(jobs, &job);
+            } else if (!RunOneMainThreadJob(jobs)) {
+                break;
+            }
+        }
+        for (int i = 0; i <= jobs->num_workers; i++) {
+            for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+                FreeJobDeque(&jobs->states[i].deques[priority]);
+            }
+        }
+        SDL_free(jobs->states);
+    }
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        FreeJobQueue(&jobs->shared[priority]);
+    }
+    FreeJobQueue(&jobs->main_thread_queue);
+    SDL_DestroyCondition(jobs->wake_condition);
+    SDL_DestroyMutex(jobs->sleep_mutex);
+    if (tls_worker.jobs == jobs) {
+        tls_worker.jobs = NULL;
+        tls_worker.index = -1;
+    }
+    SDL_free(jobs);
+}
+
+void SubmitJobWithPriority(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter, JobPriority priority)
+{
+    priority = (JobPriority)SDL_clamp((int)priority, 0, JOB_PRIORITY_COUNT - 1);
+    Job job = { fn, userdata, counter, priority };
+    if (counter != NULL) {
+        SDL_AddAtomicInt(&counter->pending, 1);
+    }
+    int self = GetCurrentWorker(jobs);
+
+    // Counted before it's visible, so a taker never sees a job that isn't counted.
+    SDL_AddAtomicInt(&jobs->queued, 1);
+    bool pushed = self >= 0 ? PushJobDeque(&jobs->states[self].deques[priority], &job)
+                            : PushJobQueue(&jobs->shared[priority], &job);
+    if (!pushed) {
+        // Nowhere to put it: run it here rather than lose it.
+        SDL_AddAtomicInt(&jobs->queued, -1);
+        RunJob(jobs, &job);
+        return;
+    }
+
+    if (SDL_GetAtomicInt(&jobs->sleeping) > 0) {
+        SDL_LockMutex(jobs->sleep_mutex);
+        SDL_SignalCondition(jobs->wake_condition);
+        SDL_UnlockMutex(jobs->sleep_mutex);
+    }
+}
+
+void SubmitJob(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter)
+{
+    SubmitJobWithPriority(jobs, fn, userdata, counter, JOB_PRIORITY_NORMAL);
+}
+
+void SubmitMainThreadJob(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter)
+{
+    Job job = { fn, userdata, counter, JOB_PRIORITY_NORMAL };
+    if (counter != NULL) {
+        SDL_AddAtomicInt(&counter->pending, 1);
+    }
+    if (!PushJobQueue(&jobs->main_thread_queue, &job)) {
+        SDL_Log("Dropped a main thread job: out of memory");
+        if (counter != NULL) {
+            SDL_AddAtomicInt(&counter->pending, -1);
+        }
+    }
+}
+
+void WaitForCounter(JobSystem *jobs, JobCounter *counter)
+{
+    int self = GetCurrentWorker(jobs);
+    bool main_thread = self == jobs->num_workers;
+    JobPriority lowest = tls_priority == JOB_PRIORITY_LOW || jobs->num_started == 0 ? JOB_PRIORITY_LOW : JOB_PRIORITY_NORMAL;
+    int spins = 0;
+    while (SDL_GetAtomicInt(&counter->pending) > 0) {
+        Job job;
+        bool stolen;
+        if (main_thread && RunOneMainThreadJob(jobs)) {
+            spins = 0;
+        } else if (TakeJob(jobs, self, lowest, &job, &stolen)) {
+            RunJob(jobs, &job);
+            spins = 0;
+        } else if (++spins < JOB_WAIT_SPINS) {
+            SDL_CPUPauseInstruction();
+        } else {
+            // The last jobs are running elsewhere; don't starve them of the core.
+            SDL_Delay(0);
+            spins = 0;
+        }
+    }
+}
+
+typedef struct ParallelForState
+{
+    ParallelForFunction fn;
+    void *userdata;
+    Uint32 count;
+    SDL_AtomicInt next_index;
+} ParallelForState;
+
+static void RunParallelForItems(void *userdata)
+{
+    // Hand out one index at a time; work items (shader compiles, file decodes)
+    // are coarse and uneven, so dynamic distribution beats static slicing.
+    ParallelForState *state = static_cast<ParallelForState*>(userdata);
+    for (;;) {
+        Uint32 index = (Uint32)SDL_AddAtomicInt(&state->next_index, 1);
+        if (index >= state->count) {
+            break;
+        }
+        state->fn(index, state->userdata);
+    }
+}
+
+void ParallelFor(JobSystem *jobs, Uint32 count, ParallelForFunction fn, void *userdata)
+{
+    if (count == 0) {
+        return;
+    }
+
+    ParallelForState state;
+    state.fn = fn;
+    state.userdata = userdata;
+    state.count = count;
+    SDL_SetAtomicInt(&state.next_index, 0);
+
+    // One job per other thread that could help; each takes indices until none are left.
+    JobCounter counter;
+    SDL_SetAtomicInt(&counter.pending, 0);
+    int helpers = jobs != NULL ? SDL_min(jobs->num_started, (int)count - 1) : 0;
+    for (int i = 0; i < helpers; i++) {
+        SubmitJobWithPriority(jobs, RunParallelForItems, &state, &counter, tls_priority);
+    }
+    RunParallelForItems(&state);
+    if (jobs != NULL) {
+        WaitForCounter(jobs, &counter);
+    }
+}
+
+int RunMainThreadJobs(JobSystem *jobs)
+{
+    if (GetCurrentWorker(jobs) != jobs->num_workers) {
+        return 0;
+    }
+    int count = 0;
+    while (RunOneMainThreadJob(jobs)) {
+        count++;
+    }
+    return count;
+}
+
+int GetJobWorkerCount(const JobSystem *jobs)
+{
+    return jobs->num_started;
+}
+
+JobSystemStats GetJobSystemStats(JobSystem *jobs)
+{
+    JobSystemStats stats;
+    SDL_zero(stats);
+    stats.num_workers = jobs->num_workers;
+    for (int i = 0; i < jobs->num_workers + 2; i++) {
+        JobThreadState *state = &jobs->states[i];
+        stats.executed += (Uint32)SDL_GetAtomicInt(&state->executed);
+        stats.stolen += (Uint32)SDL_GetAtomicInt(&state->stolen);
+        stats.steal_attempts += (Uint32)SDL_GetAtomicInt(&state->steal_attempts);
+    }
+    stats.main_thread = (Uint32)SDL_GetAtomicInt(&jobs->main_thread_executed);
+    return stats;
+}
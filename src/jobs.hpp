@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Logical cores, at least 1.
+int GetWorkerThreadCount();
+
+// ---------------------------------------------------------------------------
+// Job system
+// ---------------------------------------------------------------------------
+//
+// A persistent pool for per-frame work. Every worker, and the thread that
+// created the pool (the main thread), owns a lock-free Chase-Lev deque per
+// priority: it pushes and pops its own jobs at the bottom (LIFO, cache-warm)
+// and idle workers steal from the top of the others'. Jobs submitted from any
+// other thread go through a locked shared queue. Waiting on a counter runs
+// other jobs instead of blocking, so jobs may submit and wait on more jobs.
+//
+// Jobs that must run on the main thread (SDL GPU calls, window calls) are
+// queued separately and only run there, when the main thread waits on a
+// counter or calls RunMainThreadJobs.
+//
+// A wait only runs LOW jobs if the waiter is itself a LOW job (or the pool has
+// no workers), so waiting on the frame never picks up a long background
+// decode. Waiting on LOW jobs from anywhere else leaves them to the workers.
+
+typedef struct JobSystem JobSystem;
+typedef void (*JobFunction)(void *userdata);
+
+// Outstanding jobs. Zero-initialise; a counter may be reused once it is back to 0.
+typedef struct JobCounter
+{
+    SDL_AtomicInt pending;
+} JobCounter;
+
+// Higher priorities are taken first, from every queue, before any lower one.
+typedef enum JobPriority
+{
+    JOB_PRIORITY_HIGH,          // On the frame's critical path
+    JOB_PRIORITY_NORMAL,
+    JOB_PRIORITY_LOW,           // Background work: streaming, decoding
+    JOB_PRIORITY_COUNT
+} JobPriority;
+
+// Counts since creation; they wrap, so compare differences.
+typedef struct JobSystemStats
+{
+    int num_workers;
+    Uint32 executed;            // Jobs run, on any thread
+    Uint32 stolen;              // Of those, taken from another thread's deque
+    Uint32 steal_attempts;      // Deques probed for work, including empty ones
+    Uint32 main_thread;         // Main-thread-only jobs run
+} JobSystemStats;
+
+// num_workers -1 leaves one core for the main thread; 0 runs every job on
+// whichever thread waits for it. The calling thread becomes the pool's main thread.
+JobSystem* CreateJobSystem(int num_workers);
+// Waits for the workers to finish everything already submitted.
+void DestroyJobSystem(JobSystem *jobs);
+
+// counter may be NULL. SubmitJob uses JOB_PRIORITY_NORMAL.
+void SubmitJob(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter);
+void SubmitJobWithPriority(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter, JobPriority priority);
+// Queues a job that only the main thread will run. May be called from any thread.
+void SubmitMainThreadJob(JobSystem *jobs, JobFunction fn, void *userdata, JobCounter *counter);
+
+// Runs queued jobs on the calling thread until the counter reaches 0. On the
+// main thread that includes main-thread-only jobs.
+void WaitForCounter(JobSystem *jobs, JobCounter *counter);
+
+typedef void (*ParallelForFunction)(Uint32 index, void *userdata);
+
+// Runs fn(i, userdata) for every i in [0, count) as jobs and returns once every
+// index has been processed; the calling thread takes part. The jobs get the
+// priority of the job calling this (NORMAL outside any), so a background
+// decode's work stays in the background. jobs NULL runs every index here.
+void ParallelFor(JobSystem *jobs, Uint32 count, ParallelForFunction fn, void *userdata);
+// Runs the main-thread-only jobs queued so far; returns how many. Main thread only.
+int RunMainThreadJobs(JobSystem *jobs);
+
+// Workers actually running, which can be fewer than were asked for.
+int GetJobWorkerCount(const JobSystem *jobs);
+JobSystemStats GetJobSystemStats(JobSystem *jobs);
@@ -0,0 +1,669 @@
+#include <SDL3/SDL.h>
+#include <lod.hpp>
+
+#define LOD_MAX_PASSES 64
+#define LOD_ERROR_STEPS 6       // Sample spacing along a triangle's edges when measuring its error
+#define LOD_GRID_MAX_CELLS 128  // Per axis
+#define LOD_NO_ERROR_LIMIT 1e30f
+
+// Symmetric 4x4 matrix of the summed plane equations, and the summed area.
+typedef struct Quadric
+{
+    float a2, ab, ac, ad;
+    float b2, bc, bd;
+    float c2, cd;
+    float d2;
+    float weight;
+} Quadric;
+
+typedef struct LODCandidate
+{
+    Uint32 source;
+    Uint32 target;
+    float error;
+} LODCandidate;
+
+typedef struct PositionKey
+{
+    float position[3];
+    Uint32 vertex;
+} PositionKey;
+
+static void AddQuadric(Quadric *q, const Quadric *other)
+{
+    float *out = &q->a2;
+    const float *in = &other->a2;
+    for (size_t i = 0; i < sizeof(Quadric) / sizeof(float); i++) {
+        out[i] += in[i];
+    }
+}
+
+// Area-weighted squared distance to the planes, over the area: an RMS
+// distance once square-rooted.
+static float EvaluateQuadric(const Quadric *q, const float p[3])
+{
+    float x = p[0], y = p[1], z = p[2];
+    float value = q->a2 * x * x + q->b2 * y * y + q->c2 * z * z + q->d2 +
+                  2.0f * (q->ab * x * y + q->ac * x * z + q->bc * y * z + q->ad * x + q->bd * y + q->cd * z);
+    return q->weight > 0.0f ? SDL_sqrtf(SDL_max(value, 0.0f) / q->weight) : 0.0f;
+}
+
+static void Cross(const float a[3], const float b[3], const float c[3], float normal[3])
+{
+    float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+static void AddTriangleQuadric(Quadric *quadrics, const MeshVertex *vertices, const Uint32 *corners)
+{
+    const float *a = vertices[corners[0]].position, *b = vertices[corners[1]].position, *c = vertices[corners[2]].position;
+    float n[3];
+    Cross(a, b, c, n);
+    float length = SDL_sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length <= 0.0f) {
+        return;
+    }
+    n[0] /= length;
+    n[1] /= length;
+    n[2] /= length;
+    float d = -(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]);
+    float w = length * 0.5f;
+    Quadric q = {
+        w * n[0] * n[0], w * n[0] * n[1], w * n[0] * n[2], w * n[0] * d,
+        w * n[1] * n[1], w * n[1] * n[2], w * n[1] * d,
+        w * n[2] * n[2], w * n[2] * d,
+        w * d * d,
+        w,
+    };
+    for (int i = 0; i < 3; i++) {
+        AddQuadric(&quadrics[corners[i]], &q);
+    }
+}
+
+// Squared distance from p to the nearest point of triangle abc (Ericson,
+// Real-Time Collision Detection 5.1.5).
+static float TriangleDistanceSquared(const float p[3], const float a[3], const float b[3], const float c[3])
+{
+    float ab[3], ac[3], ap[3];
+    for (int axis = 0; axis < 3; axis++) {
+        ab[axis] = b[axis] - a[axis];
+        ac[axis] = c[axis] - a[axis];
+        ap[axis] = p[axis] - a[axis];
+    }
+    float d1 = ab[0] * ap[0] + ab[1] * ap[1] + ab[2] * ap[2];
+    float d2 = ac[0] * ap[0] + ac[1] * ap[1] + ac[2] * ap[2];
+    float d3 = ab[0] * (p[0] - b[0]) + ab[1] * (p[1] - b[1]) + ab[2] * (p[2] - b[2]);
+    float d4 = ac[0] * (p[0] - b[0]) + ac[1] * (p[1] - b[1]) + ac[2] * (p[2] - b[2]);
+    float d5 = ab[0] * (p[0] - c[0]) + ab[1] * (p[1] - c[1]) + ab[2] * (p[2] - c[2]);
+    float d6 = ac[0] * (p[0] - c[0]) + ac[1] * (p[1] - c[1]) + ac[2] * (p[2] - c[2]);
+    float va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+    // Barycentric v and w of the nearest point, by which feature's Voronoi region p is in. Edges of
+    // no length, as degenerate triangles at a sphere's poles have, would divide zero by zero
+    float v = 0.0f, w = 0.0f;
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        // a
+    } else if (d3 >= 0.0f && d4 <= d3) {
+        v = 1.0f;
+    } else if (d6 >= 0.0f && d5 <= d6) {
+        w = 1.0f;
+    } else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        v = d1 > 0.0f ? d1 / (d1 - d3) : 0.0f;
+    } else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        w = d2 > 0.0f ? d2 / (d2 - d6) : 0.0f;
+    } else if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        w = d4 - d3 > 0.0f ? (d4 - d3) / ((d4 - d3) + (d5 - d6)) : 0.0f;
+        v = 1.0f - w;
+    } else if (va + vb + vc > 0.0f) {
+        v = vb / (va + vb + vc);
+        w = vc / (va + vb + vc);
+    }
+    float distance_squared = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        float d = ap[axis] - ab[axis] * v - ac[axis] * w;
+        distance_squared += d * d;
+    }
+    return distance_squared;
+}
+
+static int ComparePositionKeys(const void *a, const void *b)
+{
+    const PositionKey *x = static_cast<const PositionKey*>(a);
+    const PositionKey *y = static_cast<const PositionKey*>(b);
+    for (int axis = 0; axis < 3; axis++) {
+        if (x->position[axis] != y->position[axis]) {
+            return x->position[axis] < y->position[axis] ? -1 : 1;
+        }
+    }
+    return x->vertex < y->vertex ? -1 : x->vertex > y->vertex ? 1 : 0;
+}
+
+static int CompareEdges(const void *a, const void *b)
+{
+    Uint64 x = *static_cast<const Uint64*>(a), y = *static_cast<const Uint64*>(b);
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int CompareCandidates(const void *a, const void *b)
+{
+    const LODCandidate *x = static_cast<const LODCandidate*>(a);
+    const LODCandidate *y = static_cast<const LODCandidate*>(b);
+    if (x->error != y->error) {
+        return x->error < y->error ? -1 : 1;
+    }
+    return x->source < y->source ? -1 : x->source > y->source ? 1 : 0;
+}
+
+// Vertices sharing a position with another (UV or normal seams), on an edge
+// with one triangle (borders) or more than two (non-manifold) never move.
+static bool FindLockedVertices(const Mesh *mesh, const Uint32 *indices, Uint32 num_indices, Uint8 *locked)
+{
+    Uint32 num_vertices = mesh->num_vertices;
+    PositionKey *keys = static_cast<PositionKey*>(SDL_malloc(num_vertices * sizeof(PositionKey)));
+    Uint32 *position_ids = static_cast<Uint32*>(SDL_malloc(num_vertices * sizeof(Uint32)));
+    Uint64 *edges = static_cast<Uint64*>(SDL_malloc(num_indices * sizeof(Uint64)));
+    if (keys == NULL || position_ids == NULL || edges == NULL) {
+        SDL_free(edges);
+        SDL_free(position_ids);
+        SDL_free(keys);
+        return false;
+    }
+
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        SDL_memcpy(keys[v].position, mesh->vertices[v].position, sizeof(keys[v].position));
+        keys[v].vertex = v;
+    }
+    SDL_qsort(keys, num_vertices, sizeof(PositionKey), ComparePositionKeys);
+    for (Uint32 first = 0; first < num_vertices;) {
+        Uint32 end = first + 1;
+        while (end < num_vertices && SDL_memcmp(keys[end].position, keys[first].position, sizeof(keys[first].position)) == 0) {
+            end++;
+        }
+        for (Uint32 i = first; i < end; i++) {
+            position_ids[keys[i].vertex] = keys[first].vertex;
+            locked[keys[i].vertex] = end - first > 1;
+        }
+        first = end;
+    }
+
+    // Edges by position, so a seam's two sides count as one edge
+    for (Uint32 i = 0; i < num_indices; i += 3) {
+        for (int c = 0; c < 3; c++) {
+            Uint32 a = position_ids[indices[i + c]], b = position_ids[indices[i + (c + 1) % 3]];
+            edges[i + c] = a < b ? (Uint64)a << 32 | b : (Uint64)b << 32 | a;
+        }
+    }
+    SDL_qsort(edges, num_indices, sizeof(Uint64), CompareEdges);
+    for (Uint32 first = 0; first < num_indices;) {
+        Uint32 end = first + 1;
+        while (end < num_indices && edges[end] == edges[first]) {
+            end++;
+        }
+        if (end - first != 2) {
+            locked[edges[first] >> 32] = 1;
+            locked[edges[first] & 0xFFFFFFFF] = 1;
+        }
+        first = end;
+    }
+    // Positions were locked through their first vertex; spread to the rest
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        locked[v] |= locked[position_ids[v]];
+    }
+
+    SDL_free(edges);
+    SDL_free(position_ids);
+    SDL_free(keys);
+    return true;
+}
+
+// Moving source onto target must not turn any remaining triangle around, or
+// stand it on edge against the shading normals of its corners: a collapse that
+// folds a triangle along the surface costs its quadrics nothing.
+static bool CollapseFlips(const Mesh *mesh, const Uint32 *indices, const Uint32 *offsets, const Uint32 *adjacency,
+                          Uint32 source, Uint32 target)
+{
+    for (Uint32 i = offsets[source]; i < offsets[source + 1]; i++) {
+        const Uint32 *corners = &indices[adjacency[i] * 3];
+        if (corners[0] == target || corners[1] == target || corners[2] == target) {
+            continue;       // Collapses away
+        }
+        const float *p[3], *moved[3];
+        for (int c = 0; c < 3; c++) {
+            p[c] = mesh->vertices[corners[c]].position;
+            moved[c] = corners[c] == source ? mesh->vertices[target].position : p[c];
+        }
+        float before[3], after[3];
+        Cross(p[0], p[1], p[2], before);
+        Cross(moved[0], moved[1], moved[2], after);
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        for (int c = 0; c < 3; c++) {
+            const float *n = mesh->vertices[corners[c] == source ? target : corners[c]].normal;
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+        float after_length = SDL_sqrtf(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+        float before_length = SDL_sqrtf(before[0] * before[0] + before[1] * before[1] + before[2] * before[2]);
+        float normal_length = SDL_sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.25f * before_length * after_length ||
+            normal[0] * after[0] + normal[1] * after[1] + normal[2] * after[2] <= 0.25f * normal_length * after_length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Triangles binned by the cells of a uniform grid their bounds overlap, for
+// nearest-triangle queries.
+typedef struct TriangleGrid
+{
+    const MeshVertex *vertices;
+    const Uint32 *indices;
+    float origin[3];
+    float cell_size;
+    int size[3];
+    Uint32 *offsets;            // Cell c's triangles are triangles[offsets[c]] up to triangles[offsets[c + 1]]
+    Uint32 *triangles;
+} TriangleGrid;
+
+static void GetTriangleCells(const TriangleGrid *grid, const Uint32 *corners, int low[3], int high[3])
+{
+    for (int axis = 0; axis < 3; axis++) {
+        float a = grid->vertices[corners[0]].position[axis];
+        float b = grid->vertices[corners[1]].position[axis];
+        float c = grid->vertices[corners[2]].position[axis];
+        float min = SDL_min(a, SDL_min(b, c)), max = SDL_max(a, SDL_max(b, c));
+        low[axis] = SDL_clamp((int)((min - grid->origin[axis]) / grid->cell_size), 0, grid->size[axis] - 1);
+        high[axis] = SDL_clamp((int)((max - grid->origin[axis]) / grid->cell_size), 0, grid->size[axis] - 1);
+    }
+}
+
+static bool BuildTriangleGrid(TriangleGrid *grid, const MeshVertex *vertices, const Uint32 *indices, Uint32 num_indices)
+{
+    SDL_zerop(grid);
+    grid->vertices = vertices;
+    grid->indices = indices;
+    float min[3] = { LOD_NO_ERROR_LIMIT, LOD_NO_ERROR_LIMIT, LOD_NO_ERROR_LIMIT };
+    float max[3] = { -LOD_NO_ERROR_LIMIT, -LOD_NO_ERROR_LIMIT, -LOD_NO_ERROR_LIMIT };
+    double edges = 0.0;
+    for (Uint32 i = 0; i < num_indices; i++) {
+        const float *p = vertices[indices[i]].position;
+        const float *next = vertices[indices[i - i % 3 + (i + 1) % 3]].position;
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = SDL_min(min[axis], p[axis]);
+            max[axis] = SDL_max(max[axis], p[axis]);
+        }
+        edges += SDL_sqrtf((next[0] - p[0]) * (next[0] - p[0]) + (next[1] - p[1]) * (next[1] - p[1]) +
+                           (next[2] - p[2]) * (next[2] - p[2]));
+    }
+    // About an edge a cell, with no axis over LOD_GRID_MAX_CELLS
+    grid->cell_size = SDL_max((float)(edges / SDL_max(num_indices, 1u)), 1e-6f);
+    for (int axis = 0; axis < 3; axis++) {
+        grid->cell_size = SDL_max(grid->cell_size, (max[axis] - min[axis]) / LOD_GRID_MAX_CELLS);
+    }
+    Uint32 num_cells = 1;
+    for (int axis = 0; axis < 3; axis++) {
+        grid->origin[axis] = num_indices > 0 ? min[axis] : 0.0f;
+        grid->size[axis] = num_indices > 0 ? SDL_min((int)((max[axis] - min[axis]) / grid->cell_size) + 1, LOD_GRID_MAX_CELLS) : 1;
+        num_cells *= grid->size[axis];
+    }
+
+    grid->offsets = static_cast<Uint32*>(SDL_calloc(num_cells + 1, sizeof(Uint32)));
+    if (grid->offsets == NULL) {
+        return false;
+    }
+    // Count, then place
+    for (int placing = 0; placing < 2; placing++) {
+        for (Uint32 i = 0; i < num_indices; i += 3) {
+            int low[3], high[3];
+            GetTriangleCells(grid, &indices[i], low, high);
+            for (int z = low[2]; z <= high[2]; z++) {
+                for (int y = low[1]; y <= high[1]; y++) {
+                    for (int x = low[0]; x <= high[0]; x++) {
+                        Uint32 cell = ((Uint32)z * grid->size[1] + y) * grid->size[0] + x;
+                        if (placing) {
+                            grid->triangles[grid->offsets[cell]++] = i / 3;
+                        } else {
+                            grid->offsets[cell + 1]++;
+                        }
+                    }
+                }
+            }
+        }
+        if (placing) {
+            for (Uint32 c = num_cells; c > 0; c--) {
+                grid->offsets[c] = grid->offsets[c - 1];
+            }
+            grid->offsets[0] = 0;
+        } else {
+            for (Uint32 c = 0; c < num_cells; c++) {
+                grid->offsets[c + 1] += grid->offsets[c];
+            }
+            grid->triangles = static_cast<Uint32*>(SDL_malloc(SDL_max(grid->offsets[num_cells], 1u) * sizeof(Uint32)));
+            if (grid->triangles == NULL) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void FreeTriangleGrid(TriangleGrid *grid)
+{
+    SDL_free(grid->triangles);
+    SDL_free(grid->offsets);
+    SDL_zerop(grid);
+}
+
+static void AddCellTriangles(const TriangleGrid *grid, int x, int y, int z, const float p[3], float enough, float *nearest)
+{
+    Uint32 cell = ((Uint32)z * grid->size[1] + y) * grid->size[0] + x;
+    for (Uint32 j = grid->offsets[cell]; j < grid->offsets[cell + 1] && *nearest > enough; j++) {
+        const Uint32 *corners = &grid->indices[grid->triangles[j] * 3];
+        float distance_squared = TriangleDistanceSquared(p, grid->vertices[corners[0]].position, grid->vertices[corners[1]].position,
+                                                         grid->vertices[corners[2]].position);
+        *nearest = SDL_min(*nearest, distance_squared);
+    }
+}
+
+// Squared distance from p to the nearest triangle, searching shells of cells
+// outward until nothing further out can be nearer, or until a triangle no
+// further than enough (squared) turns up: past that the caller does not care.
+static float GetNearestTriangleDistanceSquared(const TriangleGrid *grid, const float p[3], float enough)
+{
+    int center[3], max_radius = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = SDL_clamp((int)((p[axis] - grid->origin[axis]) / grid->cell_size), 0, grid->size[axis] - 1);
+        max_radius = SDL_max(max_radius, grid->size[axis]);
+    }
+    float nearest = LOD_NO_ERROR_LIMIT;
+    for (int r = 0; r <= max_radius; r++) {
+        for (int z = SDL_max(center[2] - r, 0); z <= SDL_min(center[2] + r, grid->size[2] - 1); z++) {
+            for (int y = SDL_max(center[1] - r, 0); y <= SDL_min(center[1] + r, grid->size[1] - 1); y++) {
+                // Inside the shell's faces in y and z, only its two ends in x are new
+                bool face = SDL_abs(z - center[2]) == r || SDL_abs(y - center[1]) == r;
+                int step = face ? 1 : SDL_max(2 * r, 1);
+                for (int x = center[0] - r; x <= center[0] + r && nearest > enough; x += step) {
+                    if (x >= 0 && x < grid->size[0]) {
+                        AddCellTriangles(grid, x, y, z, p, enough, &nearest);
+                    }
+                }
+            }
+        }
+        // Cells not searched yet are at least r cells from p's
+        float searched = r * grid->cell_size;
+        if (nearest <= enough || nearest <= searched * searched) {
+            break;
+        }
+    }
+    return nearest;
+}
+
+// The largest distance between the simplified surface and the input one,
+// both ways: from points spread over each remaining triangle to the nearest
+// input triangle, and from each input vertex to the nearest remaining one.
+static bool MeasureSimplifiedError(const Mesh *mesh, const Uint32 *indices, Uint32 num_indices, const Uint32 *simplified,
+                                   Uint32 num_simplified, float *error)
+{
+    TriangleGrid input, output;
+    bool ok = BuildTriangleGrid(&input, mesh->vertices, indices, num_indices);
+    ok = BuildTriangleGrid(&output, mesh->vertices, simplified, num_simplified) && ok;
+
+    float max_squared = 0.0f;
+    for (Uint32 i = 0; ok && i < num_simplified; i += 3) {
+        const float *p[3] = { mesh->vertices[simplified[i]].position, mesh->vertices[simplified[i + 1]].position,
+                              mesh->vertices[simplified[i + 2]].position };
+        for (int s = 0; s <= LOD_ERROR_STEPS; s++) {
+            for (int t = 0; s + t <= LOD_ERROR_STEPS; t++) {
+                int u = LOD_ERROR_STEPS - s - t;
+                if (s == LOD_ERROR_STEPS || t == LOD_ERROR_STEPS || u == LOD_ERROR_STEPS) {
+                    continue;       // Corners are input vertices
+                }
+                float q[3];
+                for (int axis = 0; axis < 3; axis++) {
+                    q[axis] = (u * p[0][axis] + s * p[1][axis] + t * p[2][axis]) / LOD_ERROR_STEPS;
+                }
+                max_squared = SDL_max(max_squared, GetNearestTriangleDistanceSquared(&input, q, max_squared));
+            }
+        }
+    }
+    for (Uint32 i = 0; ok && i < num_indices; i++) {
+        const float *p = mesh->vertices[indices[i]].position;
+        max_squared = SDL_max(max_squared, GetNearestTriangleDistanceSquared(&output, p, max_squared));
+    }
+    *error = SDL_sqrtf(max_squared);
+
+    FreeTriangleGrid(&output);
+    FreeTriangleGrid(&input);
+    return ok;
+}
+
+Uint32 SimplifyMesh(const Mesh *mesh, const Uint32 *indices, Uint32 num_indices, Uint32 target_indices, float target_error,
+                    Uint32 *destination, float *result_error)
+{
+    Uint32 num_vertices = mesh->num_vertices;
+    num_indices -= num_indices % 3;
+    Uint32 num_input = num_indices;
+    SDL_memcpy(destination, indices, num_indices * sizeof(Uint32));
+    *result_error = 0.0f;
+
+    Quadric *quadrics = static_cast<Quadric*>(SDL_calloc(num_vertices, sizeof(Quadric)));
+    Uint8 *locked = static_cast<Uint8*>(SDL_calloc(num_vertices, 1));
+    Uint8 *touched = static_cast<Uint8*>(SDL_malloc(num_vertices));
+    Uint32 *offsets = static_cast<Uint32*>(SDL_malloc((num_vertices + 1) * sizeof(Uint32)));
+    Uint32 *adjacency = static_cast<Uint32*>(SDL_malloc(num_indices * sizeof(Uint32)));
+    Uint32 *remap = static_cast<Uint32*>(SDL_malloc(num_vertices * sizeof(Uint32)));
+    LODCandidate *candidates = static_cast<LODCandidate*>(SDL_malloc(num_vertices * sizeof(LODCandidate)));
+    bool ok = quadrics != NULL && locked != NULL && touched != NULL && offsets != NULL && adjacency != NULL &&
+              remap != NULL && candidates != NULL && FindLockedVertices(mesh, indices, num_indices, locked);
+
+    for (Uint32 i = 0; ok && i < num_indices; i += 3) {
+        AddTriangleQuadric(quadrics, mesh->vertices, &destination[i]);
+    }
+
+    for (int pass = 0; ok && pass < LOD_MAX_PASSES && num_indices > target_indices; pass++) {
+        // Triangles around each vertex
+        SDL_memset(offsets, 0, (num_vertices + 1) * sizeof(Uint32));
+        for (Uint32 i = 0; i < num_indices; i++) {
+            offsets[destination[i] + 1]++;
+        }
+        for (Uint32 v = 0; v < num_vertices; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        for (Uint32 i = 0; i < num_indices; i++) {
+            adjacency[offsets[destination[i]]++] = i / 3;
+        }
+        for (Uint32 v = num_vertices; v > 0; v--) {
+            offsets[v] = offsets[v - 1];
+        }
+        offsets[0] = 0;
+
+        // The cheapest neighbour for every vertex that may move
+        for (Uint32 v = 0; v < num_vertices; v++) {
+            candidates[v].source = v;
+            candidates[v].target = v;
+            candidates[v].error = LOD_NO_ERROR_LIMIT;
+        }
+        for (Uint32 i = 0; i < num_indices; i += 3) {
+            for (int c = 0; c < 3; c++) {
+                for (int direction = 1; direction <= 2; direction++) {
+                    Uint32 source = destination[i + c], target = destination[i + (c + direction) % 3];
+                    if (locked[source]) {
+                        continue;
+                    }
+                    Quadric merged = quadrics[source];
+                    AddQuadric(&merged, &quadrics[target]);
+                    float error = EvaluateQuadric(&merged, mesh->vertices[target].position);
+                    if (error < candidates[source].error) {
+                        candidates[source].target = target;
+                        candidates[source].error = error;
+                    }
+                }
+            }
+        }
+        Uint32 num_candidates = 0;
+        for (Uint32 v = 0; v < num_vertices; v++) {
+            if (candidates[v].target != v) {
+                candidates[num_candidates++] = candidates[v];
+            }
+        }
+        SDL_qsort(candidates, num_candidates, sizeof(LODCandidate), CompareCandidates);
+
+        // Independent collapses only: nothing around a collapsed vertex changes again this pass
+        for (Uint32 v = 0; v < num_vertices; v++) {
+            remap[v] = v;
+        }
+        SDL_memset(touched, 0, num_vertices);
+        Uint32 triangles_left = num_indices / 3, target_triangles = target_indices / 3;
+        Uint32 collapses = 0;
+        for (Uint32 i = 0; i < num_candidates && triangles_left > target_triangles; i++) {
+            const LODCandidate *candidate = &candidates[i];
+            if (candidate->error > target_error) {
+                break;
+            }
+            Uint32 source = candidate->source, target = candidate->target;
+            if (touched[source] || touched[target] || CollapseFlips(mesh, destination, offsets, adjacency, source, target)) {
+                continue;
+            }
+            for (Uint32 j = offsets[source]; j < offsets[source + 1]; j++) {
+                const Uint32 *corners = &destination[adjacency[j] * 3];
+                if (corners[0] == target || corners[1] == target || corners[2] == target) {
+                    triangles_left--;
+                }
+                for (int c = 0; c < 3; c++) {
+                    touched[corners[c]] = 1;
+                }
+            }
+            remap[source] = target;
+            AddQuadric(&quadrics[target], &quadrics[source]);
+            collapses++;
+        }
+        if (collapses == 0) {
+            break;
+        }
+
+        Uint32 written = 0;
+        for (Uint32 i = 0; i < num_indices; i += 3) {
+            Uint32 a = remap[destination[i]], b = remap[destination[i + 1]], c = remap[destination[i + 2]];
+            if (a != b && b != c && c != a) {
+                destination[written++] = a;
+                destination[written++] = b;
+                destination[written++] = c;
+            }
+        }
+        num_indices = written;
+    }
+
+    // The quadrics order the collapses, but are an area-weighted RMS distance:
+    // what LOD selection needs is the worst one, measured
+    if (num_indices < num_input &&
+        !MeasureSimplifiedError(mesh, indices, num_input, destination, num_indices, result_error)) {
+        SDL_memcpy(destination, indices, num_input * sizeof(Uint32));
+        num_indices = num_input;
+        *result_error = 0.0f;
+    }
+
+    SDL_free(candidates);
+    SDL_free(remap);
+    SDL_free(adjacency);
+    SDL_free(offsets);
+    SDL_free(touched);
+    SDL_free(locked);
+    SDL_free(quadrics);
+    return num_indices;
+}
+
+bool BuildMeshLODChain(const Mesh *mesh, float ratio, Uint32 min_triangles, MeshLODChain *chain)
+{
+    SDL_zerop(chain);
+    // Each level is at most as big as the last, so MESH_MAX_LODS copies of LOD 0 is enough
+    chain->indices = static_cast<Uint32*>(SDL_malloc((size_t)mesh->num_indices * MESH_MAX_LODS * sizeof(Uint32)));
+    if (chain->indices == NULL) {
+        return false;
+    }
+    SDL_memcpy(chain->indices, mesh->indices, mesh->num_indices * sizeof(Uint32));
+    chain->lods[0].num_indices = mesh->num_indices;
+    chain->num_lods = 1;
+    chain->num_indices = mesh->num_indices;
+
+    while (chain->num_lods < MESH_MAX_LODS) {
+        const MeshLOD *previous = &chain->lods[chain->num_lods - 1];
+        if (previous->num_indices / 3 < min_triangles * 2) {
+            break;
+        }
+        MeshLOD *lod = &chain->lods[chain->num_lods];
+        Uint32 target = (Uint32)(previous->num_indices / 3 * ratio) * 3;
+        // Simplify the original each time so errors are against the real surface
+        float error;
+        lod->first_index = chain->num_indices;
+        lod->num_indices = SimplifyMesh(mesh, mesh->indices, mesh->num_indices, target, LOD_NO_ERROR_LIMIT,
+                                        &chain->indices[lod->first_index], &error);
+        lod->error = SDL_max(error, previous->error);
+        // Locked borders can stop it short; a level barely smaller than the last is not worth having
+        if (lod->num_indices == 0 || lod->num_indices > previous->num_indices * 0.9f) {
+            break;
+        }
+        OptimizeVertexCache(&chain->indices[lod->first_index], lod->num_indices, mesh->num_vertices);
+        chain->num_indices += lod->num_indices;
+        chain->num_lods++;
+    }
+
+    Uint32 *shrunk = static_cast<Uint32*>(SDL_realloc(chain->indices, chain->num_indices * sizeof(Uint32)));
+    if (shrunk != NULL) {
+        chain->indices = shrunk;
+    }
+    return true;
+}
+
+void FreeMeshLODChain(MeshLODChain *chain)
+{
+    SDL_free(chain->indices);
+    SDL_zerop(chain);
+}
+
+// ---------------------------------------------------------------------------
+// Selection
+// ---------------------------------------------------------------------------
+
+void InitLODView(LODView *view, const float projection[16], float viewport_height, const float eye[3], float threshold, float hysteresis)
+{
+    SDL_memcpy(view->eye, eye, sizeof(view->eye));
+    // Column 1, row 1 is cot(fov / 2): NDC units per unit at distance 1
+    view->pixels_per_unit = projection[5] * viewport_height * 0.5f;
+    view->threshold = threshold;
+    view->hysteresis = hysteresis;
+}
+
+static float GetLODErrorScale(const LODView *view, const float center[3], float radius)
+{
+    float d[3] = { center[0] - view->eye[0], center[1] - view->eye[1], center[2] - view->eye[2] };
+    float distance = SDL_sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) - radius;
+    return distance > 0.0f ? view->pixels_per_unit / distance : LOD_NO_ERROR_LIMIT;
+}
+
+float GetLODPixelError(const LODView *view, const float center[3], float radius, float error)
+{
+    return error * GetLODErrorScale(view, center, radius);
+}
+
+Uint32 SelectLOD(const LODView *view, const float center[3], float radius, const MeshLOD *lods, Uint32 num_lods,
+                 float error_scale, Uint32 current)
+{
+    float scale = GetLODErrorScale(view, center, radius) * error_scale;
+    // Errors only grow down the chain
+    Uint32 lod = 0;
+    while (lod + 1 < num_lods && lods[lod + 1].error * scale <= view->threshold) {
+        lod++;
+    }
+    if (lod <= current) {
+        return lod;     // Finer straight away: never show more error than asked for
+    }
+    Uint32 coarser = SDL_min(current, num_lods - 1);
+    float switch_threshold = view->threshold * (1.0f - view->hysteresis);
+    while (coarser < lod && lods[coarser + 1].error * scale <= switch_threshold) {
+        coarser++;
+    }
+    return coarser;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <mesh.hpp>
+
+// Level-of-detail chains and their selection.
+//
+// Offline, SimplifyMesh collapses edges in order of quadric error (Garland
+// and Heckbert), each vertex carrying the area-weighted planes of every
+// triangle merged into it. Collapses move a vertex onto a neighbour, so every
+// LOD indexes the original vertex buffer and a chain is one vertex buffer
+// plus a range of indices per level. Vertices on borders and attribute seams
+// stay put, and collapses that would flip a triangle are skipped. A LOD's
+// error is then measured rather than taken from the quadrics, which average
+// over area: the largest distance between it and the original surface either
+// way, sampled across every triangle.
+//
+// At runtime SelectLOD projects each LOD's error at the nearest point of the
+// object's bounding sphere and picks the coarsest LOD under a pixel
+// threshold. Moving to a coarser LOD needs the error to be a margin under the
+// threshold, so an object sitting at a switch distance does not flicker
+// between two levels.
+
+#define MESH_MAX_LODS 8
+
+typedef struct MeshLOD
+{
+    Uint32 first_index;         // Into MeshLODChain::indices
+    Uint32 num_indices;
+    float error;                // In the mesh's units; never less than a finer LOD's
+} MeshLOD;
+
+typedef struct MeshLODChain
+{
+    Uint32 *indices;            // Every LOD's triangles, finest first; SDL_malloc'd
+    Uint32 num_indices;
+    MeshLOD lods[MESH_MAX_LODS];
+    Uint32 num_lods;
+} MeshLODChain;
+
+typedef struct LODView
+{
+    float eye[3];
+    float pixels_per_unit;      // Pixels an error of 1 covers at distance 1
+    float threshold;            // Pixels
+    float hysteresis;           // Fraction of the threshold a coarser LOD must be under to switch to it
+} LODView;
+
+// Writes at most num_indices indices whose triangle count is at or above
+// target_indices / 3, stopping early where the next collapse's quadric (RMS)
+// error would exceed target_error. Returns the index count; *result_error gets
+// the largest distance measured between the result and the input.
+Uint32 SimplifyMesh(const Mesh *mesh, const Uint32 *indices, Uint32 num_indices, Uint32 target_indices, float target_error,
+                    Uint32 *destination, float *result_error);
+
+// LOD 0 is the mesh as it is; each following LOD aims for ratio of the
+// previous one's triangles, until a level has under min_triangles or stops
+// shrinking. Every LOD is reordered for the vertex cache.
+bool BuildMeshLODChain(const Mesh *mesh, float ratio, Uint32 min_triangles, MeshLODChain *chain);
+void FreeMeshLODChain(MeshLODChain *chain);
+
+// projection is column-major with clip y in column 1, as glm::perspective and
+// Camera::getProjectionMatrix give it.
+void InitLODView(LODView *view, const float projection[16], float viewport_height, const float eye[3], float threshold, float hysteresis);
+// Pixels an error covers at the sphere's nearest point; infinite inside it.
+float GetLODPixelError(const LODView *view, const float center[3], float radius, float error);
+// lods' errors are scaled by error_scale (e.g. the object's largest world
+// scale) to the units of center and radius. current is the LOD shown last
+// frame, or 0 for a new object.
+Uint32 SelectLOD(const LODView *view, const float center[3], float radius, const MeshLOD *lods, Uint32 num_lods,
+                 float error_scale, Uint32 current);
@@ -6,6 +6,25 @@
 #include "imgui_impl_sdlgpu3.h"
 #include <stdio.h>
 #include <graphics.hpp>
+#include <shader_cache.hpp>
+#include <shader_registry.hpp>
+#include <asset_pack.hpp>
+#include <mesh.hpp>
+#include <upload_manager.hpp>
+#include <async_loader.hpp>
+#include <transform.hpp>
+#include <jobs.hpp>
+#include <scheduler.hpp>
+#include <culling.hpp>
+#include <render_queue.hpp>
+#include <batching.hpp>
+#include <render_graph.hpp>
+#include <pipeline_cache.hpp>
+#include <frame_allocator.hpp>
+#include <fixed_timestep.hpp>
+#include <input.hpp>
+#include <profiler.hpp>
+#include <profiler_window.hpp>
 #include <glm/glm.hpp>
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE  // for DirectX-like clip space (0 to 1)
@@ -40,10 +59,87 @@ struct Camera {
     }
 };
 
+// What the render side needs from one frame's simulation
+struct FrameSnapshot {
+    glm::mat4 model = glm::mat4(1.0f);          // After the latest tick
+    glm::mat4 previous_model = glm::mat4(1.0f); // After the tick before; drawn `alpha` of the way from it to model
+    float alpha = 0.0f;
+    FixedTimestepStats timestep_stats = {};
+    Uint32 input_events = 0;                    // Consumed by this frame's ticks
+    TransformStats transform_stats = {};
+    SchedulerStats scheduler_stats = {};
+    SystemStats system_stats[SCHEDULER_MAX_SYSTEMS] = {};
+    bool model_visible = true;
+    CullViewStats cull_stats = {};
+};
+
+// PackedMesh.vert's uniforms
+struct PackedMeshUniforms {
+    glm::mat4 transform;                        // Transposed MVP
+    float position_offset[4];                   // Dequantization, from the cooked mesh
+    float position_scale[4];
+};
+
 struct AppState {
     SDL_Window* window = nullptr;
     SDL_GPUDevice* gpu_device = nullptr;
-    SDL_GPUGraphicsPipeline* pipeline = nullptr;
+    AssetPack* asset_pack = nullptr;
+    ShaderRegistry* shader_registry = nullptr;
+    PipelineCache* pipeline_cache = nullptr;
+    ShaderBatchEntry* preloaded_shaders = nullptr;     // Startup batch, only while pipelines are first created
+    Uint32 num_preloaded_shaders = 0;
+    char** shader_manifest = nullptr;                  // Owns the batch's names under Shaders/Source
+    UploadManager* upload_manager = nullptr;
+    AsyncLoader* async_loader = nullptr;
+    TransformHierarchy* transforms = nullptr;
+    JobSystem* jobs = nullptr;
+    SystemScheduler* scheduler = nullptr;
+    CullWorld* culling = nullptr;
+    RenderQueue* render_queue = nullptr;
+    RenderGraph* render_graph = nullptr;
+    FrameAllocator* frame_allocator = nullptr;
+    ProfilerWindow* profiler_window = nullptr;
+    InputRecorder* input = nullptr;
+    int pipeline_id = -1;
+
+    // The cooked cube, drawn straight from the pack's quantized vertices once its upload completes
+    const AssetPackMesh* mesh = nullptr;
+    SDL_GPUBuffer* mesh_vertex_buffer = nullptr;
+    SDL_GPUBuffer* mesh_index_buffer = nullptr;
+    SDL_GPUGraphicsPipeline* mesh_pipeline = nullptr;   // Owned by the pipeline cache
+    UploadTicket mesh_ticket = 0;
+
+    // A ring of tinted triangles, one instanced draw through the batcher
+    InstanceBatcher* instances = nullptr;
+    SDL_GPUBuffer* instance_vertex_buffer = nullptr;
+    int instance_mesh = -1;
+    int instance_material = -1;
+    UploadTicket instance_ticket = 0;
+    bool instances_uploaded = false;
+
+    entt::registry registry;
+    entt::entity model_entity = entt::null;
+    CullBounds model_bounds = { {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, 0.0f };
+    std::vector<entt::entity> visible;
+
+    // Frame N simulates into `simulated` on the job system while frame N-1 is drawn from `rendered`
+    JobCounter simulation_counter = {};
+    FrameSnapshot simulated;
+    FrameSnapshot rendered;
+    double simulation_wait_ms = 0.0;
+
+    // The systems tick at a fixed rate whatever the frame rate; each frame runs the ticks its time covers
+    FixedTimestep timestep = {};
+    Uint32 ticks_due = 0;
+    Uint64 last_frame_ns = 0;
+
+    // Ticks take the input events timestamped within them; only the simulation touches `input_state`
+    InputState input_state = {};
+    // Latency test: the triangle follows the pointer, and input-to-submit time is measured per move
+    bool latency_test = false;
+    bool late_latch = true;
+    Uint64 last_pointer_ns = 0;
+    InputLatency input_latency = {};
     
     int window_width = 1280;
     int window_height = 720;
@@ -54,6 +150,7 @@ struct AppState {
 
     bool show_demo_window = true;
     bool show_another_window = false;
+    bool show_profiler = true;
     ImVec4 clear_color = {0.45f, 0.55f, 0.60f, 1.0f};
 
 
@@ -61,6 +158,303 @@ struct AppState {
 
 
 
+// The triangle's shaders; every other shader the app draws with lives under Shaders/Source
+#define TRIANGLE_VERTEX_SHADER "assets/Shaders/vertex_shader.vert"
+#define TRIANGLE_FRAGMENT_SHADER "assets/Shaders/SolidColor.frag"
+
+// Releases whatever the startup batch loaded that no pipeline adopted
+static void ReleasePreloadedShaders(AppState* state)
+{
+    for (Uint32 i = 0; i < state->num_preloaded_shaders; i++)
+    {
+        if (state->preloaded_shaders[i].shader != NULL)
+            SDL_ReleaseGPUShader(state->gpu_device, state->preloaded_shaders[i].shader);
+    }
+    SDL_free(state->preloaded_shaders);
+    SDL_free(state->shader_manifest);
+    state->preloaded_shaders = nullptr;
+    state->num_preloaded_shaders = 0;
+    state->shader_manifest = nullptr;
+}
+
+// Pipeline cache shader loader: shaders the startup batch already compiled,
+// then the cooked pack, then ShaderCross
+static SDL_GPUShader* LoadPipelineShader(SDL_GPUDevice* gpu_device, const char* shader_filename, void* userdata)
+{
+    AppState* state = static_cast<AppState*>(userdata);
+    for (Uint32 i = 0; i < state->num_preloaded_shaders; i++)
+    {
+        ShaderBatchEntry* entry = &state->preloaded_shaders[i];
+        if (entry->shader != NULL && SDL_strcmp(entry->shader_filename, shader_filename) == 0)
+        {
+            SDL_GPUShader* shader = entry->shader;
+            entry->shader = NULL;   // The cache releases it from here on
+            return shader;
+        }
+    }
+    SDL_GPUShader* shader = NULL;
+    if (state->asset_pack != NULL)
+        shader = LoadPackedShader(gpu_device, state->asset_pack, shader_filename);
+    return shader != NULL ? shader : ShaderCrossLoadShader(gpu_device, shader_filename);
+}
+
+// Buffers and pipeline for a cooked mesh. The data goes to the upload manager straight from the
+// mapped pack, which stays open until after the last flush.
+static bool LoadPackedMeshDraw(AppState* state, const char* mesh_file_name, SDL_GPUTextureFormat color_format)
+{
+    const AssetPackMesh* mesh = GetPackedMesh(state->asset_pack, mesh_file_name);
+    if (mesh == NULL)
+    {
+        SDL_Log("Mesh not in asset pack: %s", mesh_file_name);
+        return false;
+    }
+
+    SDL_GPUVertexBufferDescription vertex_buffer;
+    SDL_GPUVertexAttribute attributes[3];
+    GetPackedMeshVertexInput(&vertex_buffer, attributes);
+    SDL_GPUColorTargetDescription color_target = { .format = color_format };
+    SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {
+        .vertex_input_state = {
+            .vertex_buffer_descriptions = &vertex_buffer,
+            .num_vertex_buffers = 1,
+            .vertex_attributes = attributes,
+            .num_vertex_attributes = 3
+        },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+        .rasterizer_state = {
+            .fill_mode = SDL_GPU_FILLMODE_FILL,
+            // The scene pass has no depth buffer; culling back faces keeps a convex mesh right
+            .cull_mode = SDL_GPU_CULLMODE_BACK,
+            .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE
+        },
+        .target_info = {
+            .color_target_descriptions = &color_target,
+            .num_color_targets = 1,
+        }
+    };
+    state->mesh_pipeline = GetCachedPipeline(state->pipeline_cache, "assets/Shaders/Source/PackedMesh.vert",
+                                             "assets/Shaders/Source/PackedMesh.frag", &pipeline_create_info);
+    if (state->mesh_pipeline == NULL)
+    {
+        SDL_Log("Failed to create mesh pipeline! %s", SDL_GetError());
+        return false;
+    }
+
+    Uint32 vertices_size = mesh->num_vertices * mesh->vertex_stride;
+    Uint32 indices_size = mesh->num_indices * mesh->index_size;
+    SDL_GPUBufferCreateInfo vertex_info = { .usage = SDL_GPU_BUFFERUSAGE_VERTEX, .size = vertices_size };
+    SDL_GPUBufferCreateInfo index_info = { .usage = SDL_GPU_BUFFERUSAGE_INDEX, .size = indices_size };
+    state->mesh_vertex_buffer = SDL_CreateGPUBuffer(state->gpu_device, &vertex_info);
+    state->mesh_index_buffer = SDL_CreateGPUBuffer(state->gpu_device, &index_info);
+    if (state->mesh_vertex_buffer == NULL || state->mesh_index_buffer == NULL)
+    {
+        SDL_Log("Failed to create mesh buffers! %s", SDL_GetError());
+        return false;
+    }
+
+    // Uploads complete in order, so the indices' ticket covers the vertices too
+    UploadTicket vertices_ticket = QueueBufferUpload(state->upload_manager, GetPackedMeshVertices(mesh), vertices_size,
+                                                     state->mesh_vertex_buffer, 0, NULL, NULL);
+    state->mesh_ticket = QueueBufferUpload(state->upload_manager, GetPackedMeshIndices(mesh), indices_size,
+                                           state->mesh_index_buffer, 0, NULL, NULL);
+    if (vertices_ticket == 0 || state->mesh_ticket == 0)
+    {
+        return false;
+    }
+    state->mesh = mesh;
+    return true;
+}
+
+// White so the instance color is the tint; PullPositionColorInstanced.vert's inputs
+struct InstanceVertex
+{
+    float position[3];
+    Uint8 color[4];
+};
+static const InstanceVertex INSTANCE_TRIANGLE[3] = {
+    { { -1.0f, -1.0f, 0.0f }, { 255, 255, 255, 255 } },
+    { {  1.0f, -1.0f, 0.0f }, { 255, 255, 255, 255 } },
+    { {  0.0f,  1.0f, 0.0f }, { 255, 255, 255, 255 } },
+};
+#define INSTANCE_RING_COUNT 48
+
+// The instance batcher with one mesh and one material, sorting after the cooked mesh
+static bool LoadInstancedDraw(AppState* state, SDL_GPUTextureFormat color_format)
+{
+    SDL_GPUVertexBufferDescription vertex_buffer = {};
+    vertex_buffer.slot = 0;
+    vertex_buffer.pitch = sizeof(InstanceVertex);
+    vertex_buffer.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
+    SDL_GPUVertexAttribute attributes[2] = {};
+    attributes[0].location = 0;
+    attributes[0].format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3;
+    attributes[0].offset = offsetof(InstanceVertex, position);
+    attributes[1].location = 1;
+    attributes[1].format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM;
+    attributes[1].offset = offsetof(InstanceVertex, color);
+    SDL_GPUColorTargetDescription color_target = { .format = color_format };
+    SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {
+        .vertex_input_state = {
+            .vertex_buffer_descriptions = &vertex_buffer,
+            .num_vertex_buffers = 1,
+            .vertex_attributes = attributes,
+            .num_vertex_attributes = 2
+        },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+        .rasterizer_state = {
+            .fill_mode = SDL_GPU_FILLMODE_FILL,
+        },
+        .target_info = {
+            .color_target_descriptions = &color_target,
+            .num_color_targets = 1,
+        }
+    };
+    InstanceMaterial material = {};
+    material.pipeline = GetCachedPipeline(state->pipeline_cache, "assets/Shaders/Source/PullPositionColorInstanced.vert",
+                                          "assets/Shaders/Source/SolidColor.frag", &pipeline_create_info);
+    material.pipeline_id = (Uint32)state->pipeline_id + 2;     // After the cooked mesh
+    if (material.pipeline == NULL)
+    {
+        SDL_Log("Failed to create instanced pipeline! %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_GPUBufferCreateInfo vertex_info = { .usage = SDL_GPU_BUFFERUSAGE_VERTEX, .size = sizeof(INSTANCE_TRIANGLE) };
+    state->instance_vertex_buffer = SDL_CreateGPUBuffer(state->gpu_device, &vertex_info);
+    if (state->instance_vertex_buffer == NULL)
+    {
+        SDL_Log("Failed to create instance vertex buffer! %s", SDL_GetError());
+        return false;
+    }
+    state->instance_ticket = QueueBufferUpload(state->upload_manager, INSTANCE_TRIANGLE, sizeof(INSTANCE_TRIANGLE),
+                                               state->instance_vertex_buffer, 0, NULL, NULL);
+    if (state->instance_ticket == 0)
+    {
+        return false;
+    }
+
+    state->instances = CreateInstanceBatcher(state->jobs, INSTANCE_RING_COUNT);
+    if (state->instances == NULL)
+    {
+        return false;
+    }
+    InstanceMesh mesh = {};
+    mesh.vertex_buffer.buffer = state->instance_vertex_buffer;
+    mesh.num_elements = 3;
+    state->instance_mesh = AddInstanceMesh(state->instances, &mesh);
+    state->instance_material = AddInstanceMaterial(state->instances, &material);
+    return state->instance_mesh >= 0 && state->instance_material >= 0;
+}
+
+// Pipelines created this run, prewarmed at the next startup
+static void GetPipelineManifestPath(char* path, size_t size)
+{
+    SDL_snprintf(path, size, "%s../pipelines.manifest", SDL_GetBasePath());
+}
+
+// The point on the z = 0 plane under a window position, for the latency test's triangle
+static glm::vec3 PointerToWorld(const AppState* state, float x, float y)
+{
+    glm::mat4 inverse = glm::inverse(state->camera.getProjectionMatrix(state->aspect_ratio) * state->camera.getViewMatrix());
+    float ndc_x = 2.0f * x / (float)state->window_width - 1.0f;
+    float ndc_y = 1.0f - 2.0f * y / (float)state->window_height;
+    glm::vec4 near_point = inverse * glm::vec4(ndc_x, ndc_y, 0.0f, 1.0f);
+    glm::vec4 far_point = inverse * glm::vec4(ndc_x, ndc_y, 1.0f, 1.0f);
+    glm::vec3 a = glm::vec3(near_point) / near_point.w, b = glm::vec3(far_point) / far_point.w;
+    return a + (b - a) * (a.z / (a.z - b.z));
+}
+
+// Scheduler system: world matrices for everything that moved since last frame
+static void TransformSystem(SystemContext *context, entt::registry &registry, void *userdata)
+{
+    UpdateTransforms(static_cast<TransformHierarchy*>(userdata), TRANSFORM_UPDATE_AUTO);
+}
+
+// Scheduler system: world bounds from the transforms, then the camera's visible set
+static void CullingSystem(SystemContext *context, entt::registry &registry, void *userdata)
+{
+    AppState* state = static_cast<AppState*>(userdata);
+    float model[16];
+    CullBounds bounds;
+    GetWorldMatrix(state->transforms, state->model_entity, model);
+    TransformCullBounds(&state->model_bounds, model, &bounds);
+    SetCullBounds(state->culling, state->model_entity, &bounds);
+    UpdateCullWorld(state->culling);
+
+    Frustum frustum;
+    glm::mat4 view_projection = state->camera.getProjectionMatrix(state->aspect_ratio) * state->camera.getViewMatrix();
+    ExtractFrustum(glm::value_ptr(view_projection), &frustum);
+    state->visible.resize(GetCullStats(state->culling).count);
+    FrameSnapshot* snapshot = &state->simulated;
+    Uint32 num_visible = CullFrustum(state->culling, &frustum, CULL_AUTO, state->visible.data(), &snapshot->cull_stats);
+    snapshot->model_visible = false;
+    for (Uint32 i = 0; i < num_visible; i++)
+    {
+        snapshot->model_visible = snapshot->model_visible || state->visible[i] == state->model_entity;
+    }
+}
+
+// One fixed tick: the systems, then the model's world matrix, keeping the
+// previous tick's to interpolate from
+static void SimulateTick(Uint64 tick, double dt, void *userdata)
+{
+    AppState* state = static_cast<AppState*>(userdata);
+    FrameSnapshot* snapshot = &state->simulated;
+
+    // Everything that happened before the tick ends, in order; a press keeps its own timestamp for judging
+    InputEvent events[64];
+    Uint32 count;
+    while ((count = ConsumeInputEvents(state->input, state->timestep.tick_end_ns, events, SDL_arraysize(events))) > 0)
+    {
+        for (Uint32 i = 0; i < count; i++)
+        {
+            ApplyInputEvent(&state->input_state, &events[i]);
+        }
+        snapshot->input_events += count;
+    }
+
+    RunSystems(state->scheduler, state->registry, false);
+    snapshot->previous_model = snapshot->model;
+    GetWorldMatrix(state->transforms, state->model_entity, glm::value_ptr(snapshot->model));
+}
+
+// Job: run the ticks due this frame, then copy out what rendering needs, so
+// the main thread never reads simulation state while it's changing
+static void SimulateFrame(void *userdata)
+{
+    PROFILE_ZONE("Simulate");
+    AppState* state = static_cast<AppState*>(userdata);
+    state->simulated.input_events = 0;
+    RunFixedTicks(&state->timestep, state->ticks_due, SimulateTick, state);
+
+    FrameSnapshot* snapshot = &state->simulated;
+    snapshot->timestep_stats = state->timestep.stats;
+    snapshot->transform_stats = GetTransformStats(state->transforms);
+    snapshot->scheduler_stats = GetSchedulerStats(state->scheduler);
+    for (Uint32 i = 0; i < snapshot->scheduler_stats.num_systems; i++)
+    {
+        snapshot->system_stats[i] = GetSystemStats(state->scheduler, (int)i);
+    }
+}
+
+// Render graph pass: the sorted scene draws
+static void ScenePass(const RenderPassContext *context, void *userdata)
+{
+    AppState* state = static_cast<AppState*>(userdata);
+    ExecuteRenderQueue(state->render_queue, context->command_buffer, context->render_pass, 0, 255);
+}
+
+// Render graph pass: ImGui uploads its vertices before the render pass opens
+static void PrepareImGuiPass(const RenderPassContext *context, void *userdata)
+{
+    ImGui_ImplSDLGPU3_PrepareDrawData(ImGui::GetDrawData(), context->command_buffer);
+}
+
+static void ImGuiPass(const RenderPassContext *context, void *userdata)
+{
+    ImGui_ImplSDLGPU3_RenderDrawData(ImGui::GetDrawData(), context->command_buffer, context->render_pass);
+}
+
 // --------------
 // SDL_AppInit()
 // --------------
@@ -68,6 +462,8 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
     AppState* state = new AppState();   // Allocate your app state
     *appstate = static_cast<void*>(state); // Store it in the void** provided
+    SetProfilerThreadName("Main");
+    PROFILE_ZONE("Startup");
 
 
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
@@ -76,6 +472,10 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         return SDL_APP_FAILURE;
     }
 
+    // Paths the loaders and the shader cache share; set once here, before any job or background thread can read them
+    InitializeAssetLoader();
+    InitializeShaderCache(NULL);
+
     float main_scale = SDL_GetDisplayContentScale(SDL_GetPrimaryDisplay());
     SDL_WindowFlags window_flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY;
     state->window = SDL_CreateWindow("Gaming",
@@ -127,21 +527,84 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         ImGui_ImplSDLGPU3_Init(&init_info);
     }
     
+    // One pool for everything: per-frame systems, shader compiles and background asset decodes
+    state->jobs = CreateJobSystem(-1);
+    if (state->jobs == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
     //GPU setup
     //Loading Shaders
-    SDL_GPUShader* vertex_shader = ShaderCrossLoadShader(state->gpu_device, "assets/Shaders/vertex_shader.vert");
-    if (vertex_shader == NULL) {
+    // The whole graphics shader set up front, so the pipelines below and the cache's prewarm
+    // find them loaded; compute shaders are built by their own passes
+    int num_manifest = 0;
+    state->shader_manifest = BuildShaderManifest("assets/Shaders/Source", &num_manifest);
+    state->preloaded_shaders = static_cast<ShaderBatchEntry*>(SDL_calloc(2 + num_manifest, sizeof(ShaderBatchEntry)));
+    if (state->preloaded_shaders == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+    ShaderBatchEntry* shader_batch = state->preloaded_shaders;
+    Uint32 num_shaders = 0;
+    shader_batch[num_shaders++].shader_filename = TRIANGLE_VERTEX_SHADER;
+    shader_batch[num_shaders++].shader_filename = TRIANGLE_FRAGMENT_SHADER;
+    for (int i = 0; i < num_manifest; i++)
+    {
+        if (!SDL_strstr(state->shader_manifest[i], ".comp"))
+            shader_batch[num_shaders++].shader_filename = state->shader_manifest[i];
+    }
+    state->num_preloaded_shaders = num_shaders;
+
+    // Prefer the precompiled bytecode from the cooked pack (built by the cook target); whatever
+    // it lacks is compiled as one batch, in parallel under a single ShaderCross session
+    state->asset_pack = OpenAssetPack("assets.pack");
+    ShaderBatchEntry* missing = static_cast<ShaderBatchEntry*>(SDL_calloc(num_shaders, sizeof(ShaderBatchEntry)));
+    Uint32* missing_index = static_cast<Uint32*>(SDL_calloc(num_shaders, sizeof(Uint32)));
+    if (missing == NULL || missing_index == NULL)
+    {
+        SDL_free(missing);
+        SDL_free(missing_index);
+        return SDL_APP_FAILURE;
+    }
+    Uint32 num_missing = 0;
+    for (Uint32 i = 0; i < num_shaders; i++)
+    {
+        if (state->asset_pack != NULL)
+            shader_batch[i].shader = LoadPackedShader(state->gpu_device, state->asset_pack, shader_batch[i].shader_filename);
+        if (shader_batch[i].shader == NULL)
+        {
+            missing[num_missing].shader_filename = shader_batch[i].shader_filename;
+            missing_index[num_missing++] = i;
+        }
+    }
+    if (!ShaderCrossLoadShaderBatch(state->gpu_device, missing, num_missing, state->jobs))
+    {
         SDL_Log("Shader failed to load. %s", SDL_GetError());
     }
+    for (Uint32 i = 0; i < num_missing; i++)
+    {
+        shader_batch[missing_index[i]].shader = missing[i].shader;
+    }
+    SDL_free(missing);
+    SDL_free(missing_index);
 
-    SDL_GPUShader* fragment_shader = ShaderCrossLoadShader(state->gpu_device, "assets/Shaders/SolidColor.frag");
-    if (fragment_shader == NULL) {
-        SDL_Log("Shader failed to load. %s", SDL_GetError());
+    ShaderCacheStats shader_cache_stats = GetShaderCacheStats();
+    SDL_Log("Shaders: %u loaded, %u compiled; shader cache: %u hits, %u misses",
+            num_shaders, num_missing, shader_cache_stats.hits, shader_cache_stats.misses);
+
+    // Create every pipeline the last run used before the first frame, so none compiles mid-frame
+    state->pipeline_cache = CreatePipelineCache(state->gpu_device, LoadPipelineShader, state);
+    if (state->pipeline_cache == NULL)
+    {
+        SDL_Log("Failed to create pipeline cache! %s", SDL_GetError());
+        return SDL_APP_FAILURE;
     }
+    char manifest_path[256];
+    GetPipelineManifestPath(manifest_path, sizeof(manifest_path));
+    PrewarmPipelineCache(state->pipeline_cache, manifest_path);
 
     SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {
-        .vertex_shader = vertex_shader,
-        .fragment_shader = fragment_shader,
         .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
         .rasterizer_state = {
             .fill_mode = SDL_GPU_FILLMODE_FILL,
@@ -154,16 +617,137 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         }
     };
     
-    state->pipeline = SDL_CreateGPUGraphicsPipeline(state->gpu_device, &pipeline_create_info);
-    if (state->pipeline == NULL)
+    SDL_GPUGraphicsPipeline* pipeline = GetCachedPipeline(state->pipeline_cache,
+                                                          TRIANGLE_VERTEX_SHADER,
+                                                          TRIANGLE_FRAGMENT_SHADER,
+                                                          &pipeline_create_info);
+
+    if (pipeline == NULL)
     {
         SDL_Log("Failed to create fill pipeline! %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
 
+    // Edits to the .hlsl sources are recompiled in the background and swapped in between frames
+    state->shader_registry = CreateShaderRegistry(state->gpu_device);
+    if (state->shader_registry == NULL)
+    {
+        SDL_Log("Failed to create shader registry!");
+        return SDL_APP_FAILURE;
+    }
+    state->pipeline_id = RegisterSharedGraphicsPipeline(state->shader_registry,
+                                                        TRIANGLE_VERTEX_SHADER,
+                                                        TRIANGLE_FRAGMENT_SHADER,
+                                                        &pipeline_create_info,
+                                                        pipeline);
+    if (state->pipeline_id < 0)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+
+    // 64 MB staging ring, at most 16 MB of it copied per frame
+    state->upload_manager = CreateUploadManager(state->gpu_device, 64 * 1024 * 1024, 16 * 1024 * 1024);
+    if (state->upload_manager == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // The cooked cube; without a pack, or the mesh in it, the scene is just the triangle
+    if (state->asset_pack != NULL)
+    {
+        LoadPackedMeshDraw(state, "assets/Meshes/cube.obj", SDL_GetGPUSwapchainTextureFormat(state->gpu_device, state->window));
+    }
+
+    // Textures requested from here on decode as background jobs instead of blocking the window
+    state->async_loader = CreateAsyncLoader(state->gpu_device, state->upload_manager, state->jobs);
+    if (state->async_loader == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // Scene transforms; the drawn model's world matrix comes from here
+    state->transforms = CreateTransformHierarchy(1024);
+    if (state->transforms == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+    state->model_entity = state->registry.create();
+    AddTransform(state->transforms, state->model_entity, entt::null);
+
+    // Visibility; the model is dynamic since its transform can change every frame
+    state->culling = CreateCullWorld(1024);
+    if (state->culling == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+    AddCullObject(state->culling, state->model_entity, &state->model_bounds, false);
+
+    // Per-frame systems run across the job system's workers
+    state->scheduler = CreateSystemScheduler(state->jobs);
+    if (state->scheduler == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // Packs on the job system, so after it; without it the scene just lacks the ring
+    if (!LoadInstancedDraw(state, SDL_GetGPUSwapchainTextureFormat(state->gpu_device, state->window)))
+    {
+        DestroyInstanceBatcher(state->instances);
+        state->instances = nullptr;
+    }
+    // Every startup pipeline exists now; shaders none of them adopted are done with
+    ReleasePreloadedShaders(state);
+
+    // 120 Hz ticks; past 8 a frame the backlog is dropped instead of growing
+    InitFixedTimestep(&state->timestep, 120, 8);
+    const ComponentID transform_writes[] = { GetComponentID<TransformHierarchy>() };
+    const SystemDesc transform_system = { "transforms", TransformSystem, state->transforms, NULL, 0, transform_writes, 1 };
+    AddSystem(state->scheduler, &transform_system);
+    const ComponentID culling_reads[] = { GetComponentID<TransformHierarchy>() };
+    const ComponentID culling_writes[] = { GetComponentID<CullWorld>() };
+    const SystemDesc culling_system = { "culling", CullingSystem, state, culling_reads, 1, culling_writes, 1 };
+    AddSystem(state->scheduler, &culling_system);
+
+    state->render_queue = CreateRenderQueue();
+    if (state->render_queue == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // Passes are declared every frame; the graph keeps its transient textures between frames
+    state->render_graph = CreateRenderGraph(state->gpu_device);
+    if (state->render_graph == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // Zones from every thread, drawn per frame; "Save trace" writes next to the assets folder
+    char trace_path[256];
+    SDL_snprintf(trace_path, sizeof(trace_path), "%s../profile.json", SDL_GetBasePath());
+    state->profiler_window = CreateProfilerWindow(trace_path);
+    if (state->profiler_window == NULL)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    // Input is recorded as SDL queues it, on the thread pumping events, not when SDL_AppEvent gets to it
+    state->input = CreateInputRecorder(4096);
+    if (state->input == NULL || !SDL_AddEventWatch(InputEventWatch, state->input))
+    {
+        SDL_Log("Failed to set up input recording! %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
 
-    SDL_ReleaseGPUShader(state->gpu_device, vertex_shader);
-    SDL_ReleaseGPUShader(state->gpu_device, fragment_shader);
+    // Transient per-frame CPU and GPU memory, one slot per frame in flight
+    state->frame_allocator = CreateFrameAllocator(state->gpu_device, 3, 1024 * 1024, 4 * 1024 * 1024);
+    if (state->frame_allocator == NULL)
+    {
+        SDL_Log("Failed to create frame allocator! %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+
+    state->last_frame_ns = SDL_GetTicksNS();
     return SDL_APP_CONTINUE; // success
 }
 
@@ -177,6 +761,10 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
     if (event->type == SDL_EVENT_QUIT)
         return SDL_APP_SUCCESS;
 
+    // Gamepads only send events once opened; SDL closes them again at SDL_Quit
+    if (event->type == SDL_EVENT_GAMEPAD_ADDED)
+        SDL_OpenGamepad(event->gdevice.which);
+
     
 
     return SDL_APP_CONTINUE; // keep going
@@ -192,17 +780,54 @@ SDL_AppResult SDL_AppIterate(void *appstate)
     if (SDL_GetWindowFlags(state->window) & SDL_WINDOW_MINIMIZED)
     {
         SDL_Delay(10);
+        state->last_frame_ns = SDL_GetTicksNS();   // Paused, not behind
         return SDL_APP_CONTINUE;
     }
 
-    ImGui_ImplSDLGPU3_NewFrame();
-    ImGui_ImplSDL3_NewFrame();
-    ImGui::NewFrame();
+    MarkProfilerFrame();
+    PROFILE_ZONE("Frame");
+
+    // The pointer as of frame start, what the latency test draws without late latching
+    float pointer_x = 0.0f, pointer_y = 0.0f;
+    Uint64 pointer_ns = 0;
+    GetLatestPointer(state->input, &pointer_x, &pointer_y, &pointer_ns);
+
+    // Frame boundary: pick up any pipelines the shader registry finished rebuilding
+    UpdateShaderRegistry(state->shader_registry);
+    // Finished asset loads queue their texture data before this frame's upload flush
+    UpdateAsyncLoader(state->async_loader);
+    // Streamed texture/buffer data goes out in its own copy pass ahead of this frame's draws
+    FlushUploads(state->upload_manager);
+    // This frame's transient memory; waits only if the GPU still reads the slot from three frames ago
+    {
+        PROFILE_ZONE("BeginFrameAllocator");
+        BeginFrameAllocator(state->frame_allocator);
+    }
+
+    {
+        PROFILE_ZONE("ImGui::NewFrame");
+        ImGui_ImplSDLGPU3_NewFrame();
+        ImGui_ImplSDL3_NewFrame();
+        ImGui::NewFrame();
+    }
 
     ImGuiIO& io = ImGui::GetIO();
 
     SDL_GetWindowSize(state->window, &state->window_width, &state->window_height);
 
+    // The ticks this frame's time covers; what's left over is how far between ticks it's drawn
+    Uint64 frame_ns = SDL_GetTicksNS();
+    state->ticks_due = AccumulateFixedTimestep(&state->timestep, frame_ns - state->last_frame_ns);
+    state->simulated.alpha = GetFixedTimestepAlpha(&state->timestep);
+    SetFixedTickClock(&state->timestep, frame_ns);
+    state->last_frame_ns = frame_ns;
+
+    // Simulate frame N on the workers while the main thread records and submits frame N-1.
+    // GPU calls stay here; systems that need one use SubmitMainThreadJob.
+    SubmitJobWithPriority(state->jobs, SimulateFrame, state, &state->simulation_counter, JOB_PRIORITY_HIGH);
+    InterpolateWorldMatrix(glm::value_ptr(state->rendered.previous_model), glm::value_ptr(state->rendered.model),
+                           state->rendered.alpha, glm::value_ptr(state->camera.model));
+
 
 
     // ImGui windows
@@ -210,6 +835,7 @@ SDL_AppResult SDL_AppIterate(void *appstate)
         ImGui::ShowDemoWindow(&state->show_demo_window);
     // Imgui stuff
     {
+        PROFILE_ZONE("StatsWindow");
         static float f = 0.0f;
         static int counter = 0;
 
@@ -217,6 +843,12 @@ SDL_AppResult SDL_AppIterate(void *appstate)
         ImGui::Text("This is some useful text.");
         ImGui::Checkbox("Demo Window", &state->show_demo_window);
         ImGui::Checkbox("Another Window", &state->show_another_window);
+        ImGui::Checkbox("Profiler", &state->show_profiler);
+        bool latency_changed = ImGui::Checkbox("Latency test", &state->latency_test);
+        ImGui::SameLine();
+        latency_changed = ImGui::Checkbox("Late latching", &state->late_latch) || latency_changed;
+        if (latency_changed)
+            state->input_latency = {};
         ImGui::SliderFloat("float", &f, 0.0f, 1.0f);
         ImGui::ColorEdit4("clear color", (float*)&state->clear_color);
         if (ImGui::Button("Button")) counter++;
@@ -224,6 +856,76 @@ SDL_AppResult SDL_AppIterate(void *appstate)
         ImGui::Text("counter = %d", counter);
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
                     1000.0f / io.Framerate, io.Framerate);
+        ShaderCacheStats shader_cache_stats = GetShaderCacheStats();
+        ImGui::Text("Shader cache: %u hits, %u misses", shader_cache_stats.hits, shader_cache_stats.misses);
+        ShaderRegistryStats shader_registry_stats = GetShaderRegistryStats(state->shader_registry);
+        ImGui::Text("Shader reloads: %u, failed: %u", shader_registry_stats.reloads, shader_registry_stats.failures);
+        PipelineCacheStats pipeline_stats = GetPipelineCacheStats(state->pipeline_cache);
+        ImGui::Text("Pipelines: %u, %u prewarmed in %.1f ms; %u/%u requests hit, %u created late, worst %.2f ms",
+                    pipeline_stats.pipelines, pipeline_stats.prewarmed, pipeline_stats.prewarm_ms,
+                    pipeline_stats.hits, pipeline_stats.requests, pipeline_stats.misses, pipeline_stats.max_create_ms);
+        UploadManagerStats upload_stats = GetUploadManagerStats(state->upload_manager);
+        ImGui::Text("Uploads: %u pending (%.1f MB), %.1f MB last frame, ring %.1f/%.1f MB",
+                    upload_stats.pending_uploads, upload_stats.pending_bytes / (1024.0 * 1024.0),
+                    upload_stats.bytes_last_frame / (1024.0 * 1024.0),
+                    upload_stats.ring_used / (1024.0 * 1024.0), upload_stats.ring_capacity / (1024.0 * 1024.0));
+        AsyncLoaderStats loader_stats = GetAsyncLoaderStats(state->async_loader);
+        ImGui::Text("Assets: %u queued, %u loading, %u uploading, %u ready, %u failed",
+                    loader_stats.queued, loader_stats.loading, loader_stats.uploading, loader_stats.ready, loader_stats.failed);
+        const FrameSnapshot& rendered = state->rendered;
+        ImGui::Text("Transforms: %u, depth %u, %u updated last frame",
+                    rendered.transform_stats.count, rendered.transform_stats.depth, rendered.transform_stats.updated_last_update);
+        const FixedTimestepStats& timestep_stats = rendered.timestep_stats;
+        ImGui::Text("Simulation: %u Hz, %u ticks last frame (%.2f ms), tick %.3f ms avg, %.3f ms max, %llu dropped",
+                    timestep_stats.hz, timestep_stats.ticks_last_frame, timestep_stats.frame_ms, timestep_stats.tick_average_ms,
+                    timestep_stats.tick_max_ms, (unsigned long long)timestep_stats.dropped_ticks);
+        InputStats input_stats = GetInputStats(state->input);
+        ImGui::Text("Input: %u recorded, %u dropped, %u queued (peak %u), %u taken by last frame's ticks",
+                    input_stats.recorded, input_stats.dropped, input_stats.queued, input_stats.queued_high_water,
+                    rendered.input_events);
+        if (state->latency_test)
+        {
+            InputLatencyStats latency_stats = GetInputLatencyStats(&state->input_latency);
+            ImGui::Text("Input to submit (%s): %.2f ms avg, %.2f p50, %.2f p99, %.2f max over %u moves",
+                        state->late_latch ? "late latched" : "frame start", latency_stats.average_ms, latency_stats.p50_ms,
+                        latency_stats.p99_ms, latency_stats.max_ms, latency_stats.samples);
+        }
+        ImGui::Text("Systems: %u, %.3f ms (%.3f ms serial), critical path %u",
+                    rendered.scheduler_stats.num_systems, rendered.scheduler_stats.frame_ms,
+                    rendered.scheduler_stats.serial_ms, rendered.scheduler_stats.critical_path);
+        for (Uint32 i = 0; i < rendered.scheduler_stats.num_systems; i++)
+        {
+            const SystemStats& system_stats = rendered.system_stats[i];
+            ImGui::Text("  %-12s %.3f ms avg, %.3f ms max, %u chunks",
+                        system_stats.name, system_stats.average_ms, system_stats.max_ms, system_stats.chunks_last_frame);
+        }
+        ImGui::Text("Culling: %u visible, %u tested, %u BVH nodes visited",
+                    rendered.cull_stats.visible, rendered.cull_stats.tested, rendered.cull_stats.nodes_visited);
+        RenderQueueStats queue_stats = GetRenderQueueStats(state->render_queue);
+        ImGui::Text("Render queue: %u draws; binds issued/skipped: pipelines %u/%u, buffers %u/%u, samplers %u/%u, uniforms %u/%u",
+                    queue_stats.draws, queue_stats.pipeline_binds, queue_stats.pipeline_binds_skipped,
+                    queue_stats.buffer_binds, queue_stats.buffer_binds_skipped,
+                    queue_stats.sampler_binds, queue_stats.sampler_binds_skipped,
+                    queue_stats.uniform_pushes, queue_stats.uniform_pushes_skipped);
+        if (state->instances != NULL)
+        {
+            InstanceBatchStats instance_stats = GetInstanceBatchStats(state->instances);
+            ImGui::Text("Instances: %u in %u draws, %u pack jobs; grouping %.3f ms, packing %.3f ms",
+                        instance_stats.instances, instance_stats.groups, instance_stats.chunks,
+                        instance_stats.sort_ms, instance_stats.pack_ms);
+        }
+        FrameAllocatorStats frame_stats = GetFrameAllocatorStats(state->frame_allocator);
+        ImGui::Text("Frame memory: CPU %.1f KB (peak %.1f/%.1f KB), GPU %.1f KB (peak %.1f/%.1f KB), %u failed, %u fence waits",
+                    frame_stats.cpu_last_frame / 1024.0, frame_stats.cpu_high_water / 1024.0, frame_stats.cpu_capacity / 1024.0,
+                    frame_stats.gpu_last_frame / 1024.0, frame_stats.gpu_high_water / 1024.0, frame_stats.gpu_capacity / 1024.0,
+                    frame_stats.failures, frame_stats.fence_waits);
+        RenderGraphStats graph_stats = GetRenderGraphStats(state->render_graph);
+        ImGui::Text("Render graph: %u passes, %u culled, %u merged into %u render passes, %u/%u textures",
+                    graph_stats.passes, graph_stats.culled, graph_stats.merged, graph_stats.groups,
+                    graph_stats.physical_textures, graph_stats.transient_textures);
+        JobSystemStats job_stats = GetJobSystemStats(state->jobs);
+        ImGui::Text("Jobs: %d workers, %u run, %u stolen; waited %.3f ms for simulation",
+                    job_stats.num_workers, job_stats.executed, job_stats.stolen, state->simulation_wait_ms);
         ImGui::End();
     }
 
@@ -236,8 +938,17 @@ SDL_AppResult SDL_AppIterate(void *appstate)
         ImGui::End();
     }
 
+    if (state->show_profiler)
+    {
+        PROFILE_ZONE("ProfilerWindow");
+        DrawProfilerWindow(state->profiler_window, &state->show_profiler);
+    }
+
     // Render
-    ImGui::Render();
+    {
+        PROFILE_ZONE("ImGui::Render");
+        ImGui::Render();
+    }
     ImDrawData* draw_data = ImGui::GetDrawData();
     bool is_minimized = (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f);
 
@@ -245,58 +956,156 @@ SDL_AppResult SDL_AppIterate(void *appstate)
     SDL_GPUCommandBuffer* command_buffer = SDL_AcquireGPUCommandBuffer(state->gpu_device);
     if (command_buffer == NULL) {
         SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        WaitForCounter(state->jobs, &state->simulation_counter);
         return SDL_APP_FAILURE;
     }
 
     SDL_GPUTexture* swapchain_texture;
-    if (!SDL_AcquireGPUSwapchainTexture(command_buffer, state->window, &swapchain_texture, NULL, NULL)) {
+    Uint32 swapchain_width = 0, swapchain_height = 0;
+    bool acquired;
+    {
+        // Blocks here when the GPU or the display is the bottleneck
+        PROFILE_ZONE("AcquireSwapchain");
+        acquired = SDL_AcquireGPUSwapchainTexture(command_buffer, state->window, &swapchain_texture, &swapchain_width, &swapchain_height);
+    }
+    if (!acquired) {
         SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        WaitForCounter(state->jobs, &state->simulation_counter);
         return SDL_APP_FAILURE;
     }
 
+    // The instance ring, packed into this frame's allocator region; the allocator's flush copies it
+    state->instances_uploaded = false;
+    if (state->instances != NULL && IsUploadComplete(state->upload_manager, state->instance_ticket))
+    {
+        PROFILE_ZONE("Instances");
+        ClearInstanceBatcher(state->instances);
+        float seconds = (float)(SDL_GetTicksNS() / 1e9);
+        for (int i = 0; i < INSTANCE_RING_COUNT; i++)
+        {
+            float angle = seconds * 0.5f + i * (2.0f * SDL_PI_F / INSTANCE_RING_COUNT);
+            glm::mat4 model = glm::rotate(glm::scale(glm::translate(glm::mat4(1.0f),
+                                                                    glm::vec3(SDL_cosf(angle) * 2.0f, SDL_sinf(angle) * 1.2f, 0.0f)),
+                                                     glm::vec3(0.08f)),
+                                          angle * 3.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+            float hue = (float)i / INSTANCE_RING_COUNT * 2.0f * SDL_PI_F;
+            float color[4] = { 0.5f + 0.5f * SDL_cosf(hue), 0.5f + 0.5f * SDL_cosf(hue - 2.094f),
+                               0.5f + 0.5f * SDL_cosf(hue + 2.094f), 1.0f };
+            AddInstance(state->instances, state->instance_mesh, state->instance_material, glm::value_ptr(model), color);
+        }
+        state->instances_uploaded = UploadInstanceBatcher(state->instances, state->frame_allocator);
+    }
 
-    glm::mat4 mvp_transposed = glm::transpose(state->camera.getMVP(state->aspect_ratio));  // Required for HLSL (row-major)
-
-    SDL_PushGPUVertexUniformData(command_buffer, 0, &mvp_transposed, sizeof(mvp_transposed));
+    // Scene draws go through the render queue: submitted, sorted, then replayed inside the pass
+    {
+        PROFILE_ZONE("RenderQueue");
+        ResetRenderQueue(state->render_queue);
+        RenderBucket* bucket = AcquireRenderBucket(state->render_queue);
+        if (state->latency_test)
+        {
+            // Late latch: after the swapchain wait, pump once more and draw the newest pointer, so only
+            // recording and submit separate it from the GPU. Uniforms are copied when pushed, so this
+            // is as late as the pose can change.
+            if (state->late_latch)
+            {
+                PROFILE_ZONE("LateLatch");
+                SDL_PumpEvents();
+                GetLatestPointer(state->input, &pointer_x, &pointer_y, &pointer_ns);
+            }
+            state->camera.model = glm::scale(glm::translate(glm::mat4(1.0f), PointerToWorld(state, pointer_x, pointer_y)),
+                                              glm::vec3(0.25f));
+        }
+        if ((state->rendered.model_visible || state->latency_test) && bucket != NULL)
+        {
+            glm::mat4 mvp_transposed = glm::transpose(state->camera.getMVP(state->aspect_ratio));  // Required for HLSL (row-major)
+            DrawPacket packet = {};
+            packet.sort_key = MakeOpaqueSortKey(0, (Uint32)state->pipeline_id, 0, 0, 0);
+            packet.pipeline = GetRegisteredPipeline(state->shader_registry, state->pipeline_id);
+            packet.num_elements = 3;
+            packet.num_instances = 1;
+            SubmitDrawPacket(bucket, &packet, &mvp_transposed, sizeof(mvp_transposed), NULL, 0);
+        }
+        if (state->mesh != NULL && bucket != NULL && IsUploadComplete(state->upload_manager, state->mesh_ticket))
+        {
+            // Beside the triangle, turning so the cooked normals show
+            float seconds = (float)(SDL_GetTicksNS() / 1e9);
+            glm::mat4 model = glm::rotate(glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(-1.2f, 0.0f, 0.0f)), glm::vec3(0.3f)),
+                                          seconds, glm::vec3(0.3f, 1.0f, 0.0f));
+            PackedMeshUniforms uniforms = {};
+            uniforms.transform = glm::transpose(state->camera.getProjectionMatrix(state->aspect_ratio) *
+                                                state->camera.getViewMatrix() * model);
+            SDL_memcpy(uniforms.position_offset, state->mesh->position_offset, sizeof(state->mesh->position_offset));
+            SDL_memcpy(uniforms.position_scale, state->mesh->position_scale, sizeof(state->mesh->position_scale));
+            DrawPacket packet = {};
+            packet.sort_key = MakeOpaqueSortKey(0, (Uint32)state->pipeline_id + 1, 0, 0, 0);   // After the registry's pipeline
+            packet.pipeline = state->mesh_pipeline;
+            packet.vertex_buffer.buffer = state->mesh_vertex_buffer;
+            packet.index_buffer.buffer = state->mesh_index_buffer;
+            packet.index_element_size = state->mesh->index_size == sizeof(Uint16) ? SDL_GPU_INDEXELEMENTSIZE_16BIT : SDL_GPU_INDEXELEMENTSIZE_32BIT;
+            packet.num_elements = state->mesh->num_indices;
+            packet.num_instances = 1;
+            SubmitDrawPacket(bucket, &packet, &uniforms, sizeof(uniforms), NULL, 0);
+        }
+        if (state->instances_uploaded && bucket != NULL)
+        {
+            glm::mat4 view_projection = state->camera.getProjectionMatrix(state->aspect_ratio) * state->camera.getViewMatrix();
+            SubmitInstanceBatcher(state->instances, bucket, 0, glm::value_ptr(view_projection));
+        }
+        SortRenderQueue(state->render_queue);
+        FlushFrameAllocator(state->frame_allocator, command_buffer);
+    }
 
-    //my renderpass
+    // The frame's passes; the scene and ImGui both draw to the swapchain and share one render pass
     if (swapchain_texture != NULL) {
-        SDL_GPUColorTargetInfo color_target_info = {0};
-        color_target_info.texture = swapchain_texture;
-        color_target_info.clear_color = {state->clear_color.x, state->clear_color.y, state->clear_color.z, state->clear_color.w};
-        color_target_info.load_op = SDL_GPU_LOADOP_CLEAR;
-        color_target_info.store_op = SDL_GPU_STOREOP_STORE;
-
-        SDL_GPURenderPass* render_pass = SDL_BeginGPURenderPass(command_buffer, &color_target_info, 1, NULL);
-
-
-        SDL_BindGPUGraphicsPipeline(render_pass, state->pipeline);
-
-        
-        SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
-        SDL_EndGPURenderPass(render_pass);
+        PROFILE_ZONE("RenderGraph");
+        ResetRenderGraph(state->render_graph);
+        RenderTextureDesc swapchain_desc = {};
+        swapchain_desc.name = "Swapchain";
+        swapchain_desc.format = SDL_GetGPUSwapchainTextureFormat(state->gpu_device, state->window);
+        swapchain_desc.width = swapchain_width;
+        swapchain_desc.height = swapchain_height;
+        swapchain_desc.sample_count = SDL_GPU_SAMPLECOUNT_1;
+        RenderResource swapchain = ImportRenderTexture(state->render_graph, swapchain_texture, &swapchain_desc);
+        SetRenderGraphOutput(state->render_graph, swapchain);
+
+        SDL_FColor clear_color = { state->clear_color.x, state->clear_color.y, state->clear_color.z, state->clear_color.w };
+        const RenderPassDesc scene_pass = { "Scene", RENDER_PASS_GRAPHICS, ScenePass, NULL, state, false };
+        int pass = AddRenderPass(state->render_graph, &scene_pass);
+        AddRenderPassColorTarget(state->render_graph, pass, swapchain, SDL_GPU_LOADOP_CLEAR, clear_color);
+
+        if (!is_minimized)
+        {
+            const RenderPassDesc imgui_pass = { "ImGui", RENDER_PASS_GRAPHICS, ImGuiPass, PrepareImGuiPass, state, false };
+            pass = AddRenderPass(state->render_graph, &imgui_pass);
+            AddRenderPassColorTarget(state->render_graph, pass, swapchain, SDL_GPU_LOADOP_LOAD, clear_color);
+        }
 
+        if (!CompileRenderGraph(state->render_graph) || !ExecuteRenderGraph(state->render_graph, command_buffer))
+        {
+            SDL_Log("Render graph failed: %s", SDL_GetError());
+        }
     }
 
-    //imgui gpu render pass
-    if (swapchain_texture && !is_minimized)
     {
-        ImGui_ImplSDLGPU3_PrepareDrawData(draw_data, command_buffer);
-
-        SDL_GPUColorTargetInfo target_info = {};
-        target_info.texture = swapchain_texture;
-        target_info.clear_color = SDL_FColor{ state->clear_color.x, state->clear_color.y, state->clear_color.z, state->clear_color.w };
-        target_info.load_op = SDL_GPU_LOADOP_LOAD;
-        target_info.store_op = SDL_GPU_STOREOP_STORE;
-
-        SDL_GPURenderPass* render_pass = SDL_BeginGPURenderPass(command_buffer, &target_info, 1, nullptr);
-        ImGui_ImplSDLGPU3_RenderDrawData(draw_data, command_buffer, render_pass);
-        SDL_EndGPURenderPass(render_pass);
+        PROFILE_ZONE("Submit");
+        SubmitFrameAllocator(state->frame_allocator, command_buffer);
+    }
+    // Input to submit for each pointer move the latency test drew
+    if (state->latency_test && pointer_ns != 0 && pointer_ns != state->last_pointer_ns)
+    {
+        AddInputLatencySample(&state->input_latency, (SDL_GetTicksNS() - pointer_ns) / 1e6);
+        state->last_pointer_ns = pointer_ns;
     }
 
-
-    SDL_SubmitGPUCommandBuffer(command_buffer);
-    
+    // Frame N's simulation becomes what frame N+1 draws. Anything it queued for
+    // the main thread runs here while we wait.
+    {
+        PROFILE_ZONE("WaitForSimulation");
+        Uint64 wait_start = SDL_GetTicksNS();
+        WaitForCounter(state->jobs, &state->simulation_counter);
+        state->simulation_wait_ms = (SDL_GetTicksNS() - wait_start) / 1e6;
+    }
+    state->rendered = state->simulated;
 
     return SDL_APP_CONTINUE;
 }
@@ -309,13 +1118,44 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     AppState* state = static_cast<AppState*>(appstate);
 
     SDL_WaitForGPUIdle(state->gpu_device);
+    ReleasePreloadedShaders(state);     // Only left if startup failed part way
 
     ImGui_ImplSDL3_Shutdown();
     ImGui_ImplSDLGPU3_Shutdown();
     ImGui::DestroyContext();
 
     
-    SDL_ReleaseGPUGraphicsPipeline(state->gpu_device, state->pipeline);
+    if (state->jobs != NULL)
+        WaitForCounter(state->jobs, &state->simulation_counter);
+    DestroySystemScheduler(state->scheduler);
+    DestroyInstanceBatcher(state->instances);
+    DestroyAsyncLoader(state->async_loader);
+    DestroyJobSystem(state->jobs);
+    DestroyFrameAllocator(state->frame_allocator);
+    DestroyProfilerWindow(state->profiler_window);
+    if (state->input != NULL)
+        SDL_RemoveEventWatch(InputEventWatch, state->input);
+    DestroyInputRecorder(state->input);
+    DestroyRenderGraph(state->render_graph);
+    DestroyRenderQueue(state->render_queue);
+    DestroyCullWorld(state->culling);
+    DestroyTransformHierarchy(state->transforms);
+    DestroyUploadManager(state->upload_manager);
+    if (state->mesh_vertex_buffer != NULL)
+        SDL_ReleaseGPUBuffer(state->gpu_device, state->mesh_vertex_buffer);
+    if (state->mesh_index_buffer != NULL)
+        SDL_ReleaseGPUBuffer(state->gpu_device, state->mesh_index_buffer);
+    if (state->instance_vertex_buffer != NULL)
+        SDL_ReleaseGPUBuffer(state->gpu_device, state->instance_vertex_buffer);
+    DestroyShaderRegistry(state->shader_registry);
+    if (state->pipeline_cache != NULL)
+    {
+        char manifest_path[256];
+        GetPipelineManifestPath(manifest_path, sizeof(manifest_path));
+        SavePipelineManifest(state->pipeline_cache, manifest_path);
+    }
+    DestroyPipelineCache(state->pipeline_cache);
+    CloseAssetPack(state->asset_pack);
 
     
     SDL_ReleaseWindowFromGPUDevice(state->gpu_device, state->window);
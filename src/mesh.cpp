@@ -0,0 +1,932 @@
+#include <SDL3/SDL.h>
+#include <mesh.hpp>
+#include <profiler.hpp>
+
+#define MESH_INVALID_INDEX 0xFFFFFFFFu
+#define MESH_SCORE_CACHE_SIZE 32        // Modelled LRU for triangle scoring; larger than the real FIFO on purpose
+#define MESH_SCORE_MAX_VALENCE 32
+#define MESH_FETCH_CACHE_LINES 64       // 4 KB of 64-byte lines, direct-mapped
+
+static bool GrowArray(void **array, Uint32 *capacity, Uint32 needed, size_t element_size)
+{
+    if (needed <= *capacity) {
+        return true;
+    }
+    Uint32 new_capacity = SDL_max(*capacity * 2, SDL_max(needed, 64u));
+    void *grown = SDL_realloc(*array, (size_t)new_capacity * element_size);
+    if (grown == NULL) {
+        return false;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static void Normalize(float v[3])
+{
+    float length = SDL_sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length > 0.0f) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    } else {
+        v[0] = 0.0f;
+        v[1] = 0.0f;
+        v[2] = 1.0f;
+    }
+}
+
+// Twice the triangle's area along its normal.
+static void TriangleNormal(const float a[3], const float b[3], const float c[3], float normal[3])
+{
+    float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// ---------------------------------------------------------------------------
+// OBJ import
+// ---------------------------------------------------------------------------
+
+typedef struct ObjParser
+{
+    float *positions;           // xyz
+    Uint32 num_positions, positions_capacity;
+    float *uvs;                 // uv
+    Uint32 num_uvs, uvs_capacity;
+    float *normals;             // xyz
+    Uint32 num_normals, normals_capacity;
+
+    MeshVertex *vertices;
+    Uint32 num_vertices, vertices_capacity;
+    Uint32 *vertex_keys;        // Position, uv and normal index per vertex
+    Uint32 vertex_keys_capacity;
+    Uint32 *indices;
+    Uint32 num_indices, indices_capacity;
+
+    Uint32 *table;              // Open addressing, vertex index or MESH_INVALID_INDEX
+    Uint32 table_mask;
+} ObjParser;
+
+static bool IsLineSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static bool ParseFloat(const char **cursor, float *value)
+{
+    const char *text = *cursor;
+    while (IsLineSpace(*text)) {
+        text++;
+    }
+    char *end;
+    *value = (float)SDL_strtod(text, &end);
+    if (end == text) {
+        return false;
+    }
+    *cursor = end;
+    return true;
+}
+
+// OBJ indices are 1-based, negative ones count back from the latest element.
+static bool ResolveIndex(long index, Uint32 count, Uint32 *resolved)
+{
+    if (index > 0 && (Uint32)index <= count) {
+        *resolved = (Uint32)index - 1;
+        return true;
+    }
+    if (index < 0 && (Uint32)-index <= count) {
+        *resolved = count - (Uint32)-index;
+        return true;
+    }
+    return false;
+}
+
+static Uint32 HashVertexKey(const Uint32 key[3])
+{
+    Uint32 hash = key[0] * 0x9E3779B1u ^ key[1] * 0x85EBCA77u ^ key[2] * 0xC2B2AE3Du;
+    return hash ^ (hash >> 15);
+}
+
+static bool GrowVertexTable(ObjParser *parser)
+{
+    Uint32 size = parser->table != NULL ? (parser->table_mask + 1) * 2 : 1024;
+    Uint32 *table = static_cast<Uint32*>(SDL_malloc(size * sizeof(Uint32)));
+    if (table == NULL) {
+        return false;
+    }
+    SDL_memset(table, 0xFF, size * sizeof(Uint32));
+    for (Uint32 v = 0; v < parser->num_vertices; v++) {
+        Uint32 slot = HashVertexKey(&parser->vertex_keys[v * 3]) & (size - 1);
+        while (table[slot] != MESH_INVALID_INDEX) {
+            slot = (slot + 1) & (size - 1);
+        }
+        table[slot] = v;
+    }
+    SDL_free(parser->table);
+    parser->table = table;
+    parser->table_mask = size - 1;
+    return true;
+}
+
+static bool AddFaceVertex(ObjParser *parser, const Uint32 key[3])
+{
+    if (parser->table == NULL || (parser->num_vertices + 1) * 2 > parser->table_mask + 1) {
+        if (!GrowVertexTable(parser)) {
+            return false;
+        }
+    }
+    Uint32 slot = HashVertexKey(key) & parser->table_mask;
+    for (;;) {
+        Uint32 v = parser->table[slot];
+        if (v == MESH_INVALID_INDEX) {
+            break;
+        }
+        const Uint32 *existing = &parser->vertex_keys[v * 3];
+        if (existing[0] == key[0] && existing[1] == key[1] && existing[2] == key[2]) {
+            if (!GrowArray((void**)&parser->indices, &parser->indices_capacity, parser->num_indices + 1, sizeof(Uint32))) {
+                return false;
+            }
+            parser->indices[parser->num_indices++] = v;
+            return true;
+        }
+        slot = (slot + 1) & parser->table_mask;
+    }
+
+    Uint32 v = parser->num_vertices;
+    if (!GrowArray((void**)&parser->vertices, &parser->vertices_capacity, v + 1, sizeof(MeshVertex)) ||
+        !GrowArray((void**)&parser->vertex_keys, &parser->vertex_keys_capacity, v + 1, 3 * sizeof(Uint32)) ||
+        !GrowArray((void**)&parser->indices, &parser->indices_capacity, parser->num_indices + 1, sizeof(Uint32))) {
+        return false;
+    }
+    SDL_memcpy(&parser->vertex_keys[v * 3], key, 3 * sizeof(Uint32));
+
+    MeshVertex *vertex = &parser->vertices[v];
+    SDL_memcpy(vertex->position, &parser->positions[key[0] * 3], sizeof(vertex->position));
+    if (key[1] != MESH_INVALID_INDEX) {
+        vertex->uv[0] = parser->uvs[key[1] * 2];
+        vertex->uv[1] = 1.0f - parser->uvs[key[1] * 2 + 1];
+    } else {
+        vertex->uv[0] = 0.0f;
+        vertex->uv[1] = 0.0f;
+    }
+    if (key[2] != MESH_INVALID_INDEX) {
+        SDL_memcpy(vertex->normal, &parser->normals[key[2] * 3], sizeof(vertex->normal));
+        Normalize(vertex->normal);
+    } else {
+        SDL_zeroa(vertex->normal);
+    }
+
+    parser->table[slot] = v;
+    parser->num_vertices++;
+    parser->indices[parser->num_indices++] = v;
+    return true;
+}
+
+// "f 1/2/3 4//6 7 ...": fans the polygon out from its first corner.
+static bool ParseFace(ObjParser *parser, const char *cursor, int line)
+{
+    Uint32 first[3], previous[3];
+    int corners = 0;
+    for (;;) {
+        while (IsLineSpace(*cursor)) {
+            cursor++;
+        }
+        if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r' || *cursor == '#') {
+            break;
+        }
+        Uint32 key[3] = { MESH_INVALID_INDEX, MESH_INVALID_INDEX, MESH_INVALID_INDEX };
+        const Uint32 counts[3] = { parser->num_positions, parser->num_uvs, parser->num_normals };
+        for (int component = 0; component < 3; component++) {
+            if (component > 0) {
+                if (*cursor != '/') {
+                    break;
+                }
+                cursor++;
+                if (*cursor == '/') {
+                    continue;       // "1//3": no texture coordinate
+                }
+            }
+            char *end;
+            long index = SDL_strtol(cursor, &end, 10);
+            if (end == cursor || !ResolveIndex(index, counts[component], &key[component])) {
+                SDL_SetError("OBJ line %d: bad face index", line);
+                return false;
+            }
+            cursor = end;
+        }
+        if (key[0] == MESH_INVALID_INDEX) {
+            SDL_SetError("OBJ line %d: face corner without a position", line);
+            return false;
+        }
+
+        if (corners >= 2 && (!AddFaceVertex(parser, first) || !AddFaceVertex(parser, previous) || !AddFaceVertex(parser, key))) {
+            return false;
+        }
+        if (corners == 0) {
+            SDL_memcpy(first, key, sizeof(first));
+        }
+        SDL_memcpy(previous, key, sizeof(previous));
+        corners++;
+    }
+    if (corners < 3) {
+        SDL_SetError("OBJ line %d: face with %d corners", line, corners);
+        return false;
+    }
+    return true;
+}
+
+static bool ParseAttribute(float **array, Uint32 *count, Uint32 *capacity, int components, const char *cursor, int line)
+{
+    if (!GrowArray((void**)array, capacity, *count + 1, components * sizeof(float))) {
+        return false;
+    }
+    float *values = &(*array)[*count * components];
+    for (int i = 0; i < components; i++) {
+        if (!ParseFloat(&cursor, &values[i])) {
+            SDL_SetError("OBJ line %d: expected %d numbers", line, components);
+            return false;
+        }
+    }
+    (*count)++;
+    return true;
+}
+
+// Area-weighted normals per position, so UV seams do not show as creases.
+static bool GenerateMissingNormals(ObjParser *parser)
+{
+    bool missing = false;
+    for (Uint32 v = 0; v < parser->num_vertices && !missing; v++) {
+        missing = parser->vertex_keys[v * 3 + 2] == MESH_INVALID_INDEX;
+    }
+    if (!missing) {
+        return true;
+    }
+    float *sums = static_cast<float*>(SDL_calloc(parser->num_positions, 3 * sizeof(float)));
+    if (sums == NULL) {
+        return false;
+    }
+    for (Uint32 i = 0; i + 2 < parser->num_indices; i += 3) {
+        const Uint32 *corners = &parser->indices[i];
+        float normal[3];
+        TriangleNormal(parser->vertices[corners[0]].position, parser->vertices[corners[1]].position,
+                       parser->vertices[corners[2]].position, normal);
+        for (int c = 0; c < 3; c++) {
+            float *sum = &sums[parser->vertex_keys[corners[c] * 3] * 3];
+            sum[0] += normal[0];
+            sum[1] += normal[1];
+            sum[2] += normal[2];
+        }
+    }
+    for (Uint32 v = 0; v < parser->num_vertices; v++) {
+        if (parser->vertex_keys[v * 3 + 2] == MESH_INVALID_INDEX) {
+            SDL_memcpy(parser->vertices[v].normal, &sums[parser->vertex_keys[v * 3] * 3], 3 * sizeof(float));
+            Normalize(parser->vertices[v].normal);
+        }
+    }
+    SDL_free(sums);
+    return true;
+}
+
+bool ParseOBJ(const char *text, Mesh *mesh)
+{
+    SDL_zerop(mesh);
+    ObjParser parser;
+    SDL_zero(parser);
+
+    bool ok = true;
+    int line = 1;
+    for (const char *cursor = text; ok && *cursor != '\0'; line++) {
+        while (IsLineSpace(*cursor)) {
+            cursor++;
+        }
+        if (cursor[0] == 'v' && IsLineSpace(cursor[1])) {
+            ok = ParseAttribute(&parser.positions, &parser.num_positions, &parser.positions_capacity, 3, cursor + 2, line);
+        } else if (cursor[0] == 'v' && cursor[1] == 't' && IsLineSpace(cursor[2])) {
+            ok = ParseAttribute(&parser.uvs, &parser.num_uvs, &parser.uvs_capacity, 2, cursor + 3, line);
+        } else if (cursor[0] == 'v' && cursor[1] == 'n' && IsLineSpace(cursor[2])) {
+            ok = ParseAttribute(&parser.normals, &parser.num_normals, &parser.normals_capacity, 3, cursor + 3, line);
+        } else if (cursor[0] == 'f' && IsLineSpace(cursor[1])) {
+            ok = ParseFace(&parser, cursor + 2, line);
+        }
+        // Everything else (groups, materials, smoothing, comments) does not change the geometry
+        const char *end = SDL_strchr(cursor, '\n');
+        cursor = end != NULL ? end + 1 : cursor + SDL_strlen(cursor);
+    }
+    if (ok && parser.num_indices == 0) {
+        SDL_SetError("OBJ has no faces");
+        ok = false;
+    }
+    ok = ok && GenerateMissingNormals(&parser);
+
+    SDL_free(parser.positions);
+    SDL_free(parser.uvs);
+    SDL_free(parser.normals);
+    SDL_free(parser.vertex_keys);
+    SDL_free(parser.table);
+    if (!ok) {
+        SDL_free(parser.vertices);
+        SDL_free(parser.indices);
+        return false;
+    }
+    mesh->vertices = parser.vertices;
+    mesh->num_vertices = parser.num_vertices;
+    mesh->indices = parser.indices;
+    mesh->num_indices = parser.num_indices;
+    return true;
+}
+
+bool LoadOBJ(const char *path, Mesh *mesh)
+{
+    PROFILE_FUNCTION();
+    char *text = static_cast<char*>(SDL_LoadFile(path, NULL));
+    if (text == NULL) {
+        SDL_zerop(mesh);
+        return false;
+    }
+    bool ok = ParseOBJ(text, mesh);
+    SDL_free(text);
+    return ok;
+}
+
+void FreeMesh(Mesh *mesh)
+{
+    SDL_free(mesh->vertices);
+    SDL_free(mesh->indices);
+    SDL_zerop(mesh);
+}
+
+// ---------------------------------------------------------------------------
+// Vertex cache
+// ---------------------------------------------------------------------------
+
+typedef struct VertexScoreTables
+{
+    float cache[MESH_SCORE_CACHE_SIZE + 1];         // By position + 1; 0 is not cached
+    float valence[MESH_SCORE_MAX_VALENCE + 1];      // By remaining triangles
+} VertexScoreTables;
+
+static void InitVertexScoreTables(VertexScoreTables *tables)
+{
+    tables->cache[0] = 0.0f;
+    for (int position = 0; position < MESH_SCORE_CACHE_SIZE; position++) {
+        // The last triangle's corners score the same so its winding does not matter
+        tables->cache[position + 1] = position < 3 ? 0.75f :
+            SDL_powf(1.0f - (float)(position - 3) / (MESH_SCORE_CACHE_SIZE - 3), 1.5f);
+    }
+    tables->valence[0] = 0.0f;
+    for (int remaining = 1; remaining <= MESH_SCORE_MAX_VALENCE; remaining++) {
+        // Favours finishing off vertices with few triangles left
+        tables->valence[remaining] = 2.0f * SDL_powf((float)remaining, -0.5f);
+    }
+}
+
+static float VertexScore(const VertexScoreTables *tables, int cache_position, Uint32 remaining)
+{
+    if (remaining == 0) {
+        return -1.0f;
+    }
+    return tables->cache[cache_position + 1] + tables->valence[SDL_min(remaining, (Uint32)MESH_SCORE_MAX_VALENCE)];
+}
+
+void OptimizeVertexCache(Uint32 *indices, Uint32 num_indices, Uint32 num_vertices)
+{
+    Uint32 num_triangles = num_indices / 3;
+    if (num_triangles == 0) {
+        return;
+    }
+    VertexScoreTables tables;
+    InitVertexScoreTables(&tables);
+
+    // Per vertex, the triangles still to emit: adjacency[offsets[v], offsets[v] + remaining[v])
+    Uint32 *offsets = static_cast<Uint32*>(SDL_calloc(num_vertices + 1, sizeof(Uint32)));
+    Uint32 *remaining = static_cast<Uint32*>(SDL_calloc(num_vertices, sizeof(Uint32)));
+    Uint32 *adjacency = static_cast<Uint32*>(SDL_malloc(num_triangles * 3 * sizeof(Uint32)));
+    float *vertex_scores = static_cast<float*>(SDL_malloc(num_vertices * sizeof(float)));
+    float *triangle_scores = static_cast<float*>(SDL_malloc(num_triangles * sizeof(float)));
+    Uint8 *emitted = static_cast<Uint8*>(SDL_calloc(num_triangles, 1));
+    Uint32 *output = static_cast<Uint32*>(SDL_malloc(num_triangles * 3 * sizeof(Uint32)));
+    if (offsets == NULL || remaining == NULL || adjacency == NULL || vertex_scores == NULL || triangle_scores == NULL ||
+        emitted == NULL || output == NULL) {
+        // Leaves the order alone; it is still a valid mesh
+        SDL_free(output);
+        SDL_free(emitted);
+        SDL_free(triangle_scores);
+        SDL_free(vertex_scores);
+        SDL_free(adjacency);
+        SDL_free(remaining);
+        SDL_free(offsets);
+        return;
+    }
+
+    for (Uint32 i = 0; i < num_triangles * 3; i++) {
+        remaining[indices[i]]++;
+    }
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+        remaining[v] = 0;
+    }
+    for (Uint32 t = 0; t < num_triangles; t++) {
+        for (int c = 0; c < 3; c++) {
+            Uint32 v = indices[t * 3 + c];
+            adjacency[offsets[v] + remaining[v]++] = t;
+        }
+    }
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        vertex_scores[v] = VertexScore(&tables, -1, remaining[v]);
+    }
+    Uint32 best = 0;
+    for (Uint32 t = 0; t < num_triangles; t++) {
+        const Uint32 *corners = &indices[t * 3];
+        triangle_scores[t] = vertex_scores[corners[0]] + vertex_scores[corners[1]] + vertex_scores[corners[2]];
+        if (triangle_scores[t] > triangle_scores[best]) {
+            best = t;
+        }
+    }
+
+    Uint32 cache[MESH_SCORE_CACHE_SIZE + 3];
+    Uint32 cache_count = 0;
+    Uint32 next_unemitted = 0;
+    for (Uint32 emitted_count = 0; emitted_count < num_triangles; emitted_count++) {
+        if (best == MESH_INVALID_INDEX) {
+            // Nothing in the cache has triangles left: restart at the next one in input order
+            while (emitted[next_unemitted]) {
+                next_unemitted++;
+            }
+            best = next_unemitted;
+        }
+        const Uint32 *corners = &indices[best * 3];
+        SDL_memcpy(&output[emitted_count * 3], corners, 3 * sizeof(Uint32));
+        emitted[best] = 1;
+
+        for (int c = 0; c < 3; c++) {
+            Uint32 v = corners[c];
+            Uint32 *list = &adjacency[offsets[v]];
+            for (Uint32 i = 0; i < remaining[v]; i++) {
+                if (list[i] == best) {
+                    list[i] = list[--remaining[v]];
+                    break;
+                }
+            }
+        }
+
+        // The triangle's corners move to the front, the rest shift back
+        Uint32 new_cache[MESH_SCORE_CACHE_SIZE + 3];
+        Uint32 new_count = 0;
+        for (int c = 0; c < 3; c++) {
+            new_cache[new_count++] = corners[c];
+        }
+        for (Uint32 i = 0; i < cache_count; i++) {
+            Uint32 v = cache[i];
+            if (v != corners[0] && v != corners[1] && v != corners[2]) {
+                new_cache[new_count++] = v;
+            }
+        }
+
+        // Vertices pushed out past the end are rescored as uncached
+        for (Uint32 i = 0; i < new_count; i++) {
+            Uint32 v = new_cache[i];
+            float score = VertexScore(&tables, i < MESH_SCORE_CACHE_SIZE ? (int)i : -1, remaining[v]);
+            float delta = score - vertex_scores[v];
+            vertex_scores[v] = score;
+            const Uint32 *list = &adjacency[offsets[v]];
+            for (Uint32 j = 0; j < remaining[v]; j++) {
+                triangle_scores[list[j]] += delta;
+            }
+        }
+        best = MESH_INVALID_INDEX;
+        float best_score = -1e30f;
+        cache_count = SDL_min(new_count, (Uint32)MESH_SCORE_CACHE_SIZE);
+        for (Uint32 i = 0; i < cache_count; i++) {
+            Uint32 v = new_cache[i];
+            cache[i] = v;
+            const Uint32 *list = &adjacency[offsets[v]];
+            for (Uint32 j = 0; j < remaining[v]; j++) {
+                if (triangle_scores[list[j]] > best_score) {
+                    best_score = triangle_scores[list[j]];
+                    best = list[j];
+                }
+            }
+        }
+    }
+
+    SDL_memcpy(indices, output, num_triangles * 3 * sizeof(Uint32));
+    SDL_free(output);
+    SDL_free(emitted);
+    SDL_free(triangle_scores);
+    SDL_free(vertex_scores);
+    SDL_free(adjacency);
+    SDL_free(remaining);
+    SDL_free(offsets);
+}
+
+// ---------------------------------------------------------------------------
+// Overdraw
+// ---------------------------------------------------------------------------
+
+// A FIFO cache as timestamps: a vertex is cached if fewer than
+// MESH_ANALYZE_CACHE_SIZE misses happened since it was loaded.
+typedef struct FifoCache
+{
+    Uint32 *timestamps;
+    Uint32 time;
+} FifoCache;
+
+static void ResetFifoCache(FifoCache *cache)
+{
+    cache->time += MESH_ANALYZE_CACHE_SIZE + 1;
+}
+
+static Uint32 SimulateTriangle(FifoCache *cache, const Uint32 *corners)
+{
+    Uint32 misses = 0;
+    for (int c = 0; c < 3; c++) {
+        Uint32 v = corners[c];
+        if (cache->time - cache->timestamps[v] > MESH_ANALYZE_CACHE_SIZE) {
+            cache->timestamps[v] = cache->time++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+typedef struct OverdrawCluster
+{
+    Uint32 first;               // Triangle
+    Uint32 count;
+    float sort_key;
+} OverdrawCluster;
+
+static int CompareClusters(const void *a, const void *b)
+{
+    const OverdrawCluster *x = static_cast<const OverdrawCluster*>(a);
+    const OverdrawCluster *y = static_cast<const OverdrawCluster*>(b);
+    if (x->sort_key != y->sort_key) {
+        return x->sort_key > y->sort_key ? -1 : 1;
+    }
+    return x->first < y->first ? -1 : x->first > y->first ? 1 : 0;
+}
+
+void OptimizeOverdraw(Uint32 *indices, Uint32 num_indices, const MeshVertex *vertices, Uint32 num_vertices, float threshold)
+{
+    Uint32 num_triangles = num_indices / 3;
+    if (num_triangles == 0) {
+        return;
+    }
+    FifoCache cache;
+    cache.timestamps = static_cast<Uint32*>(SDL_calloc(num_vertices, sizeof(Uint32)));
+    cache.time = MESH_ANALYZE_CACHE_SIZE + 1;
+    Uint8 *starts = static_cast<Uint8*>(SDL_calloc(num_triangles + 1, 1));
+    OverdrawCluster *clusters = static_cast<OverdrawCluster*>(SDL_malloc(num_triangles * sizeof(OverdrawCluster)));
+    Uint32 *output = static_cast<Uint32*>(SDL_malloc(num_triangles * 3 * sizeof(Uint32)));
+    if (cache.timestamps == NULL || starts == NULL || clusters == NULL || output == NULL) {
+        SDL_free(output);
+        SDL_free(clusters);
+        SDL_free(starts);
+        SDL_free(cache.timestamps);
+        return;
+    }
+
+    // Hard boundaries: triangles that share nothing with the cache start over anyway
+    for (Uint32 t = 0; t < num_triangles; t++) {
+        starts[t] = SimulateTriangle(&cache, &indices[t * 3]) == 3;
+    }
+    starts[0] = 1;
+    starts[num_triangles] = 1;
+
+    // Soft boundaries: split a hard cluster wherever the segment so far is already
+    // within threshold of the whole cluster's ACMR, so reordering costs at most that much
+    Uint32 num_clusters = 0;
+    for (Uint32 first = 0; first < num_triangles;) {
+        Uint32 end = first + 1;
+        while (!starts[end]) {
+            end++;
+        }
+        ResetFifoCache(&cache);
+        Uint32 cluster_misses = 0;
+        for (Uint32 t = first; t < end; t++) {
+            cluster_misses += SimulateTriangle(&cache, &indices[t * 3]);
+        }
+        float limit = threshold * (float)cluster_misses / (float)(end - first);
+
+        ResetFifoCache(&cache);
+        Uint32 segment = first, segment_misses = 0;
+        for (Uint32 t = first; t < end; t++) {
+            segment_misses += SimulateTriangle(&cache, &indices[t * 3]);
+            if (t + 1 == end || (float)segment_misses <= limit * (float)(t + 1 - segment)) {
+                clusters[num_clusters].first = segment;
+                clusters[num_clusters].count = t + 1 - segment;
+                num_clusters++;
+                segment = t + 1;
+                segment_misses = 0;
+                // Sorting may put anything before the next segment, so it is judged from a cold cache
+                ResetFifoCache(&cache);
+            }
+        }
+        first = end;
+    }
+
+    // Clusters whose area-weighted normal points away from the mesh's centroid
+    // are on the outside and likely to occlude the rest: draw those first
+    float center[3] = { 0.0f, 0.0f, 0.0f };
+    float total_area = 0.0f;
+    for (Uint32 t = 0; t < num_triangles; t++) {
+        const float *a = vertices[indices[t * 3]].position, *b = vertices[indices[t * 3 + 1]].position,
+                    *c = vertices[indices[t * 3 + 2]].position;
+        float normal[3];
+        TriangleNormal(a, b, c, normal);
+        float area = SDL_sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (int axis = 0; axis < 3; axis++) {
+            center[axis] += (a[axis] + b[axis] + c[axis]) * area;
+        }
+        total_area += area;
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] /= total_area > 0.0f ? 3.0f * total_area : 1.0f;
+    }
+    for (Uint32 i = 0; i < num_clusters; i++) {
+        OverdrawCluster *cluster = &clusters[i];
+        float centroid[3] = { 0.0f, 0.0f, 0.0f }, cluster_normal[3] = { 0.0f, 0.0f, 0.0f };
+        float cluster_area = 0.0f;
+        for (Uint32 t = cluster->first; t < cluster->first + cluster->count; t++) {
+            const float *a = vertices[indices[t * 3]].position, *b = vertices[indices[t * 3 + 1]].position,
+                        *c = vertices[indices[t * 3 + 2]].position;
+            float normal[3];
+            TriangleNormal(a, b, c, normal);
+            float area = SDL_sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for (int axis = 0; axis < 3; axis++) {
+                centroid[axis] += (a[axis] + b[axis] + c[axis]) * area;
+                cluster_normal[axis] += normal[axis];
+            }
+            cluster_area += area;
+        }
+        Normalize(cluster_normal);
+        cluster->sort_key = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            centroid[axis] /= cluster_area > 0.0f ? 3.0f * cluster_area : 1.0f;
+            cluster->sort_key += (centroid[axis] - center[axis]) * cluster_normal[axis];
+        }
+    }
+    SDL_qsort(clusters, num_clusters, sizeof(OverdrawCluster), CompareClusters);
+
+    Uint32 written = 0;
+    for (Uint32 i = 0; i < num_clusters; i++) {
+        SDL_memcpy(&output[written], &indices[clusters[i].first * 3], clusters[i].count * 3 * sizeof(Uint32));
+        written += clusters[i].count * 3;
+    }
+    SDL_memcpy(indices, output, written * sizeof(Uint32));
+
+    SDL_free(output);
+    SDL_free(clusters);
+    SDL_free(starts);
+    SDL_free(cache.timestamps);
+}
+
+// ---------------------------------------------------------------------------
+// Vertex fetch
+// ---------------------------------------------------------------------------
+
+Uint32 OptimizeVertexFetch(MeshVertex *vertices, Uint32 *indices, Uint32 num_indices, Uint32 num_vertices)
+{
+    Uint32 *remap = static_cast<Uint32*>(SDL_malloc(num_vertices * sizeof(Uint32)));
+    MeshVertex *original = static_cast<MeshVertex*>(SDL_malloc(num_vertices * sizeof(MeshVertex)));
+    if (remap == NULL || original == NULL) {
+        SDL_free(original);
+        SDL_free(remap);
+        return num_vertices;
+    }
+    SDL_memset(remap, 0xFF, num_vertices * sizeof(Uint32));
+    SDL_memcpy(original, vertices, num_vertices * sizeof(MeshVertex));
+
+    Uint32 next = 0;
+    for (Uint32 i = 0; i < num_indices; i++) {
+        Uint32 v = indices[i];
+        if (remap[v] == MESH_INVALID_INDEX) {
+            remap[v] = next;
+            vertices[next] = original[v];
+            next++;
+        }
+        indices[i] = remap[v];
+    }
+    SDL_free(original);
+    SDL_free(remap);
+    return next;
+}
+
+bool OptimizeMesh(Mesh *mesh)
+{
+    if (mesh->num_indices % 3 != 0) {
+        SDL_SetError("Mesh has %u indices, not a triangle list", mesh->num_indices);
+        return false;
+    }
+    OptimizeVertexCache(mesh->indices, mesh->num_indices, mesh->num_vertices);
+    OptimizeOverdraw(mesh->indices, mesh->num_indices, mesh->vertices, mesh->num_vertices, MESH_OVERDRAW_THRESHOLD);
+    mesh->num_vertices = OptimizeVertexFetch(mesh->vertices, mesh->indices, mesh->num_indices, mesh->num_vertices);
+    return true;
+}
+
+MeshStats AnalyzeMesh(const Uint32 *indices, Uint32 num_indices, Uint32 num_vertices, Uint32 vertex_stride)
+{
+    MeshStats stats = {};
+    Uint32 num_triangles = num_indices / 3;
+    FifoCache cache;
+    cache.timestamps = static_cast<Uint32*>(SDL_calloc(num_vertices, sizeof(Uint32)));
+    Uint8 *referenced = static_cast<Uint8*>(SDL_calloc(num_vertices, 1));
+    if (num_triangles == 0 || cache.timestamps == NULL || referenced == NULL) {
+        SDL_free(referenced);
+        SDL_free(cache.timestamps);
+        return stats;
+    }
+    cache.time = MESH_ANALYZE_CACHE_SIZE + 1;
+
+    Uint64 lines[MESH_FETCH_CACHE_LINES];
+    SDL_memset(lines, 0xFF, sizeof(lines));
+    Uint64 misses = 0, bytes_fetched = 0, bytes_referenced = 0;
+    for (Uint32 t = 0; t < num_triangles; t++) {
+        misses += SimulateTriangle(&cache, &indices[t * 3]);
+        for (int c = 0; c < 3; c++) {
+            Uint32 v = indices[t * 3 + c];
+            if (!referenced[v]) {
+                referenced[v] = 1;
+                bytes_referenced += vertex_stride;
+            }
+            // Every line the vertex touches goes through the fetch cache
+            Uint64 first_line = (Uint64)v * vertex_stride / 64, last_line = ((Uint64)v * vertex_stride + vertex_stride - 1) / 64;
+            for (Uint64 line = first_line; line <= last_line; line++) {
+                Uint64 *slot = &lines[line % MESH_FETCH_CACHE_LINES];
+                if (*slot != line) {
+                    *slot = line;
+                    bytes_fetched += 64;
+                }
+            }
+        }
+    }
+    Uint32 num_referenced = (Uint32)(bytes_referenced / SDL_max(vertex_stride, 1u));
+    stats.acmr = (float)misses / (float)num_triangles;
+    stats.atvr = num_referenced > 0 ? (float)misses / (float)num_referenced : 0.0f;
+    stats.overfetch = bytes_referenced > 0 ? (float)bytes_fetched / (float)bytes_referenced : 0.0f;
+    SDL_free(referenced);
+    SDL_free(cache.timestamps);
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// Quantization
+// ---------------------------------------------------------------------------
+
+// Round-to-nearest-even float -> half, saturating to infinity.
+static Uint16 FloatToHalf(float value)
+{
+    Uint32 bits;
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    Uint16 sign = (Uint16)((bits >> 16) & 0x8000);
+    bits &= 0x7FFFFFFF;
+    if (bits >= 0x47800000) {
+        return sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00);
+    }
+    if (bits < (113u << 23)) {
+        // Denormal half: let the FPU do the rounding by adding a magic constant.
+        const Uint32 magic_bits = ((127 - 15) + (23 - 10) + 1) << 23;
+        float magic, magnitude;
+        SDL_memcpy(&magic, &magic_bits, sizeof(magic));
+        SDL_memcpy(&magnitude, &bits, sizeof(magnitude));
+        magnitude += magic;
+        SDL_memcpy(&bits, &magnitude, sizeof(bits));
+        return sign | (Uint16)(bits - magic_bits);
+    }
+    Uint32 mantissa_odd = (bits >> 13) & 1;
+    bits += ((Uint32)(15 - 127) << 23) + 0xFFF + mantissa_odd;
+    return sign | (Uint16)(bits >> 13);
+}
+
+static float HalfToFloat(Uint16 half)
+{
+    Uint32 sign = (Uint32)(half & 0x8000) << 16;
+    Uint32 exponent = (half >> 10) & 0x1F;
+    Uint32 mantissa = half & 0x3FF;
+    float value;
+    if (exponent == 0) {
+        value = SDL_ldexpf((float)mantissa, -24);
+        Uint32 bits;
+        SDL_memcpy(&bits, &value, sizeof(bits));
+        bits |= sign;
+        SDL_memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    Uint32 bits = sign | (exponent == 31 ? 0x7F800000 | (mantissa << 13) : ((exponent + 112) << 23) | (mantissa << 13));
+    SDL_memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static Sint16 FloatToSnorm16(float value)
+{
+    return (Sint16)SDL_roundf(SDL_clamp(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+static Sint8 FloatToSnorm8(float value)
+{
+    return (Sint8)SDL_roundf(SDL_clamp(value, -1.0f, 1.0f) * 127.0f);
+}
+
+static float SnormToFloat(int value, float max)
+{
+    return SDL_max((float)value / max, -1.0f);
+}
+
+static float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Projects the unit sphere onto an octahedron, then unfolds the lower half.
+static void EncodeOctahedral(const float normal[3], Sint8 encoded[2])
+{
+    float sum = SDL_fabsf(normal[0]) + SDL_fabsf(normal[1]) + SDL_fabsf(normal[2]);
+    float x = sum > 0.0f ? normal[0] / sum : 0.0f;
+    float y = sum > 0.0f ? normal[1] / sum : 0.0f;
+    if (normal[2] < 0.0f) {
+        float folded_x = (1.0f - SDL_fabsf(y)) * SignNotZero(x);
+        y = (1.0f - SDL_fabsf(x)) * SignNotZero(y);
+        x = folded_x;
+    }
+    encoded[0] = FloatToSnorm8(x);
+    encoded[1] = FloatToSnorm8(y);
+}
+
+static void DecodeOctahedral(const Sint8 encoded[2], float normal[3])
+{
+    float x = SnormToFloat(encoded[0], 127.0f), y = SnormToFloat(encoded[1], 127.0f);
+    float z = 1.0f - SDL_fabsf(x) - SDL_fabsf(y);
+    float t = SDL_max(-z, 0.0f);
+    normal[0] = x - t * SignNotZero(x);
+    normal[1] = y - t * SignNotZero(y);
+    normal[2] = z;
+    Normalize(normal);
+}
+
+void ComputeMeshQuantization(const MeshVertex *vertices, Uint32 num_vertices, MeshQuantization *quantization)
+{
+    float low[3] = { 0.0f, 0.0f, 0.0f }, high[3] = { 0.0f, 0.0f, 0.0f };
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        for (int axis = 0; axis < 3; axis++) {
+            float p = vertices[v].position[axis];
+            low[axis] = v == 0 ? p : SDL_min(low[axis], p);
+            high[axis] = v == 0 ? p : SDL_max(high[axis], p);
+        }
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        quantization->offset[axis] = (low[axis] + high[axis]) * 0.5f;
+        float scale = (high[axis] - low[axis]) * 0.5f;
+        quantization->scale[axis] = scale > 0.0f ? scale : 1.0f;
+    }
+}
+
+void PackMeshVertices(const MeshVertex *vertices, Uint32 num_vertices, const MeshQuantization *quantization, PackedMeshVertex *packed)
+{
+    for (Uint32 v = 0; v < num_vertices; v++) {
+        const MeshVertex *vertex = &vertices[v];
+        PackedMeshVertex *out = &packed[v];
+        for (int axis = 0; axis < 3; axis++) {
+            out->position[axis] = FloatToSnorm16((vertex->position[axis] - quantization->offset[axis]) / quantization->scale[axis]);
+        }
+        out->position[3] = 0;
+        EncodeOctahedral(vertex->normal, out->normal);
+        out->normal[2] = 0;
+        out->normal[3] = 0;
+        out->uv[0] = FloatToHalf(vertex->uv[0]);
+        out->uv[1] = FloatToHalf(vertex->uv[1]);
+    }
+}
+
+void UnpackMeshVertex(const PackedMeshVertex *packed, const MeshQuantization *quantization, MeshVertex *vertex)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        vertex->position[axis] = quantization->offset[axis] + quantization->scale[axis] * SnormToFloat(packed->position[axis], 32767.0f);
+    }
+    DecodeOctahedral(packed->normal, vertex->normal);
+    vertex->uv[0] = HalfToFloat(packed->uv[0]);
+    vertex->uv[1] = HalfToFloat(packed->uv[1]);
+}
+
+void GetPackedMeshVertexInput(SDL_GPUVertexBufferDescription *buffer, SDL_GPUVertexAttribute attributes[3])
+{
+    SDL_zerop(buffer);
+    buffer->slot = 0;
+    buffer->pitch = sizeof(PackedMeshVertex);
+    buffer->input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
+
+    attributes[0].location = 0;
+    attributes[0].buffer_slot = 0;
+    attributes[0].format = SDL_GPU_VERTEXELEMENTFORMAT_SHORT4_NORM;
+    attributes[0].offset = offsetof(PackedMeshVertex, position);
+    attributes[1].location = 1;
+    attributes[1].buffer_slot = 0;
+    attributes[1].format = SDL_GPU_VERTEXELEMENTFORMAT_BYTE4_NORM;
+    attributes[1].offset = offsetof(PackedMeshVertex, normal);
+    attributes[2].location = 2;
+    attributes[2].buffer_slot = 0;
+    attributes[2].format = SDL_GPU_VERTEXELEMENTFORMAT_HALF2;
+    attributes[2].offset = offsetof(PackedMeshVertex, uv);
+}
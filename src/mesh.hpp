@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Offline mesh import and optimization, used by the cook target. A mesh is
+// loaded from OBJ as indexed float vertices, then:
+//
+//   - OptimizeVertexCache reorders triangles for the post-transform vertex
+//     cache (Forsyth's linear-speed scoring);
+//   - OptimizeOverdraw splits that order into clusters where the cache
+//     restarts anyway and sorts them so outward-facing ones draw first,
+//     trading a little cache efficiency (bounded by threshold) for early-z;
+//   - OptimizeVertexFetch renumbers vertices in first-use order so the
+//     vertex fetch walks memory forwards.
+//
+// PackMeshVertices then quantizes the result to 16 bytes a vertex, half of
+// MeshVertex: positions as 16-bit snorm against a per-mesh offset and scale,
+// octahedral 8-bit normals and half-float UVs (PackedMesh.vert.hlsl).
+
+#define MESH_ANALYZE_CACHE_SIZE 16      // FIFO entries, as on most desktop GPUs
+#define MESH_OVERDRAW_THRESHOLD 1.05f   // ACMR the overdraw pass may give up, relative
+
+typedef struct MeshVertex
+{
+    float position[3];
+    float normal[3];
+    float uv[2];
+} MeshVertex;
+
+typedef struct Mesh
+{
+    MeshVertex *vertices;       // SDL_malloc'd
+    Uint32 num_vertices;
+    Uint32 *indices;            // Triangle list, counter-clockwise
+    Uint32 num_indices;
+} Mesh;
+
+typedef struct PackedMeshVertex
+{
+    Sint16 position[4];         // SHORT4_NORM, w unused
+    Sint8 normal[4];            // BYTE4_NORM, octahedral in xy
+    Uint16 uv[2];               // HALF2
+} PackedMeshVertex;
+
+// position = offset + scale * snorm
+typedef struct MeshQuantization
+{
+    float offset[3];
+    float scale[3];
+} MeshQuantization;
+
+typedef struct MeshStats
+{
+    float acmr;                 // Vertex shader invocations per triangle: 0.5 at best, 3 at worst
+    float atvr;                 // Invocations per vertex: 1 at best
+    float overfetch;            // Vertex bytes read through a 4 KB cache per vertex byte
+} MeshStats;
+
+// Positions, texture coordinates and normals from v/vt/vn and f lines;
+// polygons are fanned into triangles. Vertices sharing all three indices are
+// merged, V is flipped to the GPU's top-left origin, and a file without
+// normals gets smooth area-weighted ones.
+bool LoadOBJ(const char *path, Mesh *mesh);
+// text is NUL-terminated.
+bool ParseOBJ(const char *text, Mesh *mesh);
+void FreeMesh(Mesh *mesh);
+
+void OptimizeVertexCache(Uint32 *indices, Uint32 num_indices, Uint32 num_vertices);
+// indices should already be cache-optimized.
+void OptimizeOverdraw(Uint32 *indices, Uint32 num_indices, const MeshVertex *vertices, Uint32 num_vertices, float threshold);
+// Reorders vertices in place and renumbers indices; unreferenced vertices are
+// dropped. Returns the new vertex count.
+Uint32 OptimizeVertexFetch(MeshVertex *vertices, Uint32 *indices, Uint32 num_indices, Uint32 num_vertices);
+// All three, in order.
+bool OptimizeMesh(Mesh *mesh);
+
+MeshStats AnalyzeMesh(const Uint32 *indices, Uint32 num_indices, Uint32 num_vertices, Uint32 vertex_stride);
+
+void ComputeMeshQuantization(const MeshVertex *vertices, Uint32 num_vertices, MeshQuantization *quantization);
+void PackMeshVertices(const MeshVertex *vertices, Uint32 num_vertices, const MeshQuantization *quantization, PackedMeshVertex *packed);
+// What the vertex shader sees, for checking precision.
+void UnpackMeshVertex(const PackedMeshVertex *packed, const MeshQuantization *quantization, MeshVertex *vertex);
+
+// Vertex input state for PackedMeshVertex at buffer slot 0, locations 0-2.
+void GetPackedMeshVertexInput(SDL_GPUVertexBufferDescription *buffer, SDL_GPUVertexAttribute attributes[3]);
@@ -0,0 +1,352 @@
+#include <SDL3/SDL.h>
+#include <mipmap.hpp>
+#include <jobs.hpp>
+
+#define MIP_MAX_TAPS 6
+#define MIP_BAND_PIXELS 65536       // Output texels per ParallelFor item
+#define MIP_KAISER_ALPHA 4.0
+#define MIP_KAISER_RADIUS 3.0
+#define SRGB_GUESS_STEPS 4096
+
+// ---------------------------------------------------------------------------
+// sRGB tables
+// ---------------------------------------------------------------------------
+//
+// Decoding is a 256-entry table. Encoding rounds in sRGB space exactly: code k
+// covers the linear values between the decoded midpoints k - 0.5 and k + 0.5,
+// and a 4096-step guess table is fine enough that it is never off by more
+// than one, so one comparison against the midpoint finishes the job.
+
+typedef struct MipTables
+{
+    float srgb_to_linear[256];
+    float unorm_to_float[256];
+    float srgb_midpoints[256];      // Linear value halfway (in sRGB) to the next code; last is > 1
+    Uint8 srgb_guess[SRGB_GUESS_STEPS];
+} MipTables;
+
+static double SRGBToLinear(double value)
+{
+    return value <= 0.04045 ? value / 12.92 : SDL_pow((value + 0.055) / 1.055, 2.4);
+}
+
+static MipTables BuildMipTables()
+{
+    MipTables tables;
+    for (int i = 0; i < 256; i++) {
+        tables.srgb_to_linear[i] = (float)SRGBToLinear(i / 255.0);
+        tables.unorm_to_float[i] = i / 255.0f;
+        tables.srgb_midpoints[i] = i < 255 ? (float)SRGBToLinear((i + 0.5) / 255.0) : 2.0f;
+    }
+    int code = 0;
+    for (int i = 0; i < SRGB_GUESS_STEPS; i++) {
+        float linear = (float)i / (SRGB_GUESS_STEPS - 1);
+        while (linear >= tables.srgb_midpoints[code]) {
+            code++;
+        }
+        tables.srgb_guess[i] = (Uint8)code;
+    }
+    return tables;
+}
+
+static const MipTables* GetMipTables()
+{
+    static const MipTables tables = BuildMipTables();
+    return &tables;
+}
+
+static inline Uint8 EncodeSRGB(const MipTables *tables, float linear)
+{
+    Uint8 code = tables->srgb_guess[(int)(linear * (SRGB_GUESS_STEPS - 1))];
+    return code + (linear >= tables->srgb_midpoints[code] ? 1 : 0);
+}
+
+// ---------------------------------------------------------------------------
+// Texel math: one RGBA texel per SSE register, scalar otherwise
+// ---------------------------------------------------------------------------
+
+#ifdef SDL_SSE2_INTRINSICS
+typedef __m128 Texel;
+static inline Texel TexelZero() { return _mm_setzero_ps(); }
+static inline Texel TexelLoad(const float *p) { return _mm_loadu_ps(p); }
+static inline void TexelStore(float *p, Texel t) { _mm_storeu_ps(p, t); }
+static inline Texel TexelMulAdd(Texel acc, Texel t, float w) { return _mm_add_ps(acc, _mm_mul_ps(t, _mm_set1_ps(w))); }
+static inline Texel TexelSaturate(Texel t) { return _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+#else
+typedef struct Texel { float v[4]; } Texel;
+static inline Texel TexelZero() { Texel t = { { 0.0f, 0.0f, 0.0f, 0.0f } }; return t; }
+static inline Texel TexelLoad(const float *p) { Texel t = { { p[0], p[1], p[2], p[3] } }; return t; }
+static inline void TexelStore(float *p, Texel t) { SDL_memcpy(p, t.v, sizeof(t.v)); }
+static inline Texel TexelMulAdd(Texel acc, Texel t, float w)
+{
+    for (int c = 0; c < 4; c++) {
+        acc.v[c] += t.v[c] * w;
+    }
+    return acc;
+}
+static inline Texel TexelSaturate(Texel t)
+{
+    for (int c = 0; c < 4; c++) {
+        t.v[c] = SDL_clamp(t.v[c], 0.0f, 1.0f);
+    }
+    return t;
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Filters
+// ---------------------------------------------------------------------------
+
+// Output texel x reads source texels 2x + first_tap ... 2x + first_tap + num_taps - 1.
+typedef struct MipKernel
+{
+    int first_tap;
+    int num_taps;
+    float weights[MIP_MAX_TAPS];
+} MipKernel;
+
+static double BesselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x * x) / (4.0 * k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static MipKernel BuildKernel(MipFilter filter)
+{
+    MipKernel kernel;
+    if (filter == MIP_FILTER_BOX) {
+        kernel.first_tap = 0;
+        kernel.num_taps = 2;
+        kernel.weights[0] = kernel.weights[1] = 0.5f;
+        return kernel;
+    }
+
+    // Half-band sinc (cutoff at the new Nyquist) under a Kaiser window, taps at
+    // distances +-0.5, +-1.5, +-2.5 source texels from the output centre.
+    kernel.first_tap = -2;
+    kernel.num_taps = MIP_MAX_TAPS;
+    double weights[MIP_MAX_TAPS];
+    double total = 0.0;
+    for (int k = 0; k < MIP_MAX_TAPS; k++) {
+        double distance = k - 2.5;
+        double x = distance * 0.5 * SDL_PI_D;
+        double sinc = SDL_sin(x) / x;
+        double ratio = distance / MIP_KAISER_RADIUS;
+        double window = BesselI0(MIP_KAISER_ALPHA * SDL_sqrt(SDL_max(1.0 - ratio * ratio, 0.0))) / BesselI0(MIP_KAISER_ALPHA);
+        weights[k] = sinc * window;
+        total += weights[k];
+    }
+    for (int k = 0; k < MIP_MAX_TAPS; k++) {
+        kernel.weights[k] = (float)(weights[k] / total);
+    }
+    return kernel;
+}
+
+typedef struct MipLevelJob
+{
+    const MipTables *tables;
+    const MipKernel *kernel;
+    bool srgb;
+
+    const Uint8 *source_pixels;     // Level 0: RGBA8 with source_pitch
+    Uint32 source_pitch;
+    const float *source_linear;     // Later levels: the previous level, linear float
+    Uint32 source_width;
+    Uint32 source_height;
+
+    float *linear;                  // This level in linear float, for the next one; NULL on the last
+    Uint8 *pixels;                  // This level, RGBA8
+    Uint32 width;
+    Uint32 height;
+    Uint32 rows_per_band;
+    SDL_AtomicInt failed;
+} MipLevelJob;
+
+static void DecodeSourceRow(const MipLevelJob *job, Uint32 y, float *row)
+{
+    const Uint8 *source = job->source_pixels + (size_t)y * job->source_pitch;
+    const float *rgb_table = job->srgb ? job->tables->srgb_to_linear : job->tables->unorm_to_float;
+    for (Uint32 x = 0; x < job->source_width; x++) {
+        row[x * 4 + 0] = rgb_table[source[x * 4 + 0]];
+        row[x * 4 + 1] = rgb_table[source[x * 4 + 1]];
+        row[x * 4 + 2] = rgb_table[source[x * 4 + 2]];
+        row[x * 4 + 3] = job->tables->unorm_to_float[source[x * 4 + 3]];
+    }
+}
+
+static void FilterRow(const MipLevelJob *job, const float *source, float *destination)
+{
+    const MipKernel *kernel = job->kernel;
+    int last = (int)job->source_width - 1;
+    for (Uint32 x = 0; x < job->width; x++) {
+        int first = (int)x * 2 + kernel->first_tap;
+        Texel sum = TexelZero();
+        for (int k = 0; k < kernel->num_taps; k++) {
+            int tap = SDL_clamp(first + k, 0, last);
+            sum = TexelMulAdd(sum, TexelLoad(source + tap * 4), kernel->weights[k]);
+        }
+        TexelStore(destination + x * 4, sum);
+    }
+}
+
+static void EncodeRow(const MipLevelJob *job, const float *linear, Uint8 *pixels)
+{
+    const MipTables *tables = job->tables;
+    for (Uint32 x = 0; x < job->width * 4; x += 4) {
+        if (job->srgb) {
+            pixels[x + 0] = EncodeSRGB(tables, linear[x + 0]);
+            pixels[x + 1] = EncodeSRGB(tables, linear[x + 1]);
+            pixels[x + 2] = EncodeSRGB(tables, linear[x + 2]);
+        } else {
+            pixels[x + 0] = (Uint8)(linear[x + 0] * 255.0f + 0.5f);
+            pixels[x + 1] = (Uint8)(linear[x + 1] * 255.0f + 0.5f);
+            pixels[x + 2] = (Uint8)(linear[x + 2] * 255.0f + 0.5f);
+        }
+        pixels[x + 3] = (Uint8)(linear[x + 3] * 255.0f + 0.5f);
+    }
+}
+
+// One band of output rows: every source row it touches is filtered
+// horizontally once into scratch, then the columns are combined vertically.
+static void FilterBand(Uint32 band, void *userdata)
+{
+    MipLevelJob *job = static_cast<MipLevelJob*>(userdata);
+    const MipKernel *kernel = job->kernel;
+
+    Uint32 first_row = band * job->rows_per_band;
+    Uint32 last_row = SDL_min(first_row + job->rows_per_band, job->height);
+    int first_source = (int)first_row * 2 + kernel->first_tap;
+    int num_source_rows = (int)(last_row - first_row - 1) * 2 + kernel->num_taps;
+
+    size_t row_floats = (size_t)job->width * 4;
+    float *scratch = static_cast<float*>(SDL_malloc((num_source_rows * row_floats + row_floats + job->source_width * 4) * sizeof(float)));
+    if (scratch == NULL) {
+        SDL_SetAtomicInt(&job->failed, 1);
+        return;
+    }
+    float *output_row = scratch + num_source_rows * row_floats;
+    float *decoded_row = output_row + row_floats;
+
+    for (int i = 0; i < num_source_rows; i++) {
+        Uint32 y = (Uint32)SDL_clamp(first_source + i, 0, (int)job->source_height - 1);
+        const float *source = job->source_linear + (size_t)y * job->source_width * 4;
+        if (job->source_pixels != NULL) {
+            DecodeSourceRow(job, y, decoded_row);
+            source = decoded_row;
+        }
+        FilterRow(job, source, scratch + i * row_floats);
+    }
+
+    for (Uint32 y = first_row; y < last_row; y++) {
+        const float *rows = scratch + (size_t)((y - first_row) * 2) * row_floats;
+        float *linear = job->linear != NULL ? job->linear + (size_t)y * row_floats : output_row;
+        for (Uint32 x = 0; x < row_floats; x += 4) {
+            Texel sum = TexelZero();
+            for (int k = 0; k < kernel->num_taps; k++) {
+                sum = TexelMulAdd(sum, TexelLoad(rows + k * row_floats + x), kernel->weights[k]);
+            }
+            // Kaiser lobes can ring past [0, 1]; clamp before the next level sees it.
+            TexelStore(linear + x, TexelSaturate(sum));
+        }
+        EncodeRow(job, linear, job->pixels + (size_t)y * job->width * 4);
+    }
+
+    SDL_free(scratch);
+}
+
+// ---------------------------------------------------------------------------
+// Chain
+// ---------------------------------------------------------------------------
+
+Uint32 GetMipCount(Uint32 width, Uint32 height)
+{
+    Uint32 count = 1;
+    while ((width > 1 || height > 1) && count < MIP_CHAIN_MAX_MIPS) {
+        width = SDL_max(width / 2, 1u);
+        height = SDL_max(height / 2, 1u);
+        count++;
+    }
+    return count;
+}
+
+bool GenerateMipChain(const void *pixels, Uint32 width, Uint32 height, Uint32 pitch,
+                      bool srgb, MipFilter filter, Uint32 max_mips, JobSystem *jobs, MipChain *chain)
+{
+    SDL_zerop(chain);
+    chain->num_mips = GetMipCount(width, height);
+    if (max_mips > 0) {
+        chain->num_mips = SDL_min(chain->num_mips, max_mips);
+    }
+
+    Uint64 size = 0;
+    for (Uint32 mip = 0; mip < chain->num_mips; mip++) {
+        chain->mip_widths[mip] = SDL_max(width >> mip, 1u);
+        chain->mip_heights[mip] = SDL_max(height >> mip, 1u);
+        chain->mip_offsets[mip] = size;
+        chain->mip_sizes[mip] = (Uint64)chain->mip_widths[mip] * chain->mip_heights[mip] * 4;
+        size += chain->mip_sizes[mip];
+    }
+    chain->size = size;
+    chain->pixels = static_cast<Uint8*>(SDL_malloc((size_t)size));
+    if (chain->pixels == NULL) {
+        return false;
+    }
+    for (Uint32 y = 0; y < height; y++) {
+        SDL_memcpy(chain->pixels + (size_t)y * width * 4, static_cast<const Uint8*>(pixels) + (size_t)y * pitch, (size_t)width * 4);
+    }
+
+    // Linear float copies of the level being read and the level being written.
+    float *linear[2] = { NULL, NULL };
+    if (chain->num_mips > 2) {
+        size_t linear_size = (size_t)chain->mip_widths[1] * chain->mip_heights[1] * 4 * sizeof(float);
+        linear[0] = static_cast<float*>(SDL_malloc(linear_size));
+        linear[1] = static_cast<float*>(SDL_malloc(linear_size));
+        if (linear[0] == NULL || linear[1] == NULL) {
+            SDL_free(linear[0]);
+            SDL_free(linear[1]);
+            FreeMipChain(chain);
+            return false;
+        }
+    }
+
+    const MipKernel kernel = BuildKernel(filter);
+    for (Uint32 mip = 1; mip < chain->num_mips; mip++) {
+        MipLevelJob job;
+        job.tables = GetMipTables();
+        job.kernel = &kernel;
+        job.srgb = srgb;
+        job.source_pixels = mip == 1 ? chain->pixels : NULL;
+        job.source_pitch = width * 4;
+        job.source_linear = mip == 1 ? NULL : linear[mip & 1];
+        job.source_width = chain->mip_widths[mip - 1];
+        job.source_height = chain->mip_heights[mip - 1];
+        job.linear = mip + 1 < chain->num_mips ? linear[(mip + 1) & 1] : NULL;
+        job.pixels = chain->pixels + chain->mip_offsets[mip];
+        job.width = chain->mip_widths[mip];
+        job.height = chain->mip_heights[mip];
+        job.rows_per_band = SDL_max(MIP_BAND_PIXELS / job.width, 1u);
+        SDL_SetAtomicInt(&job.failed, 0);
+
+        ParallelFor(jobs, (job.height + job.rows_per_band - 1) / job.rows_per_band, FilterBand, &job);
+        if (SDL_GetAtomicInt(&job.failed)) {
+            SDL_free(linear[0]);
+            SDL_free(linear[1]);
+            FreeMipChain(chain);
+            return false;
+        }
+    }
+
+    SDL_free(linear[0]);
+    SDL_free(linear[1]);
+    return true;
+}
+
+void FreeMipChain(MipChain *chain)
+{
+    SDL_free(chain->pixels);
+    chain->pixels = NULL;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+
+// CPU mip chain generation for RGBA8 images. sRGB data is filtered in linear
+// light (decoded once, encoded with exact sRGB rounding per level); alpha and
+// non-sRGB data are filtered as-is. Each level is made from the previous one
+// with a separable 2:1 filter, SSE2 across the four channels, and large
+// levels are split into row bands on the job system.
+
+#define MIP_CHAIN_MAX_MIPS 16
+
+typedef enum MipFilter
+{
+    MIP_FILTER_BOX,             // 2x2 average: fast, a little aliased
+    MIP_FILTER_KAISER           // 6-tap Kaiser-windowed sinc: sharper, for offline cooking
+} MipFilter;
+
+typedef struct MipChain
+{
+    Uint32 num_mips;
+    Uint32 mip_widths[MIP_CHAIN_MAX_MIPS];
+    Uint32 mip_heights[MIP_CHAIN_MAX_MIPS];
+    Uint64 mip_offsets[MIP_CHAIN_MAX_MIPS];     // Into pixels
+    Uint64 mip_sizes[MIP_CHAIN_MAX_MIPS];
+    Uint8 *pixels;              // Every level tightly packed, mip 0 first; SDL_malloc'd
+    Uint64 size;
+} MipChain;
+
+// Full chain length down to 1x1 (floor halving, as the GPU sizes levels).
+Uint32 GetMipCount(Uint32 width, Uint32 height);
+
+// pixels is width x height RGBA8 with the given row pitch; mip 0 is copied
+// into the chain unchanged. max_mips 0 means the full chain. jobs may be NULL,
+// which filters on the calling thread.
+bool GenerateMipChain(const void *pixels, Uint32 width, Uint32 height, Uint32 pitch,
+                      bool srgb, MipFilter filter, Uint32 max_mips, JobSystem *jobs, MipChain *chain);
+void FreeMipChain(MipChain *chain);
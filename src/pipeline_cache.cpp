@@ -0,0 +1,709 @@
+#include <SDL3/SDL.h>
+#include <pipeline_cache.hpp>
+#include <profiler.hpp>
+
+// Bump whenever the state encoding or the file layout changes; old manifests
+// are then ignored.
+#define PIPELINE_MANIFEST_MAGIC SDL_FOURCC('P', 'S', 'O', 'M')
+#define PIPELINE_MANIFEST_VERSION 1
+
+#define PIPELINE_SHADER_NAME_LENGTH 128
+#define PIPELINE_MAX_VERTEX_BUFFERS 16
+#define PIPELINE_MAX_VERTEX_ATTRIBUTES 16
+#define PIPELINE_MAX_COLOR_TARGETS 4
+// Fixed state plus the largest vertex layout and target list
+#define PIPELINE_STATE_MAX_WORDS (40 + 4 * PIPELINE_MAX_VERTEX_BUFFERS + 4 * PIPELINE_MAX_VERTEX_ATTRIBUTES + 10 * PIPELINE_MAX_COLOR_TARGETS)
+
+// Manifest layout:
+//   PipelineManifestHeader
+//   per pipeline: PipelineManifestRecord, vertex then fragment shader name
+//   (NUL-terminated, padded to 4 bytes together), num_words state words
+typedef struct PipelineManifestHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 num_pipelines;
+    Uint32 reserved;
+} PipelineManifestHeader;
+
+typedef struct PipelineManifestRecord
+{
+    Uint64 key;
+    Uint32 names_size;
+    Uint32 num_words;
+} PipelineManifestRecord;
+
+typedef struct PipelineEntry
+{
+    Uint64 key;
+    char vertex_shader[PIPELINE_SHADER_NAME_LENGTH];
+    char fragment_shader[PIPELINE_SHADER_NAME_LENGTH];
+    Uint32 state[PIPELINE_STATE_MAX_WORDS];
+    Uint32 num_words;
+    SDL_GPUGraphicsPipeline *pipeline;
+} PipelineEntry;
+
+typedef struct CachedShader
+{
+    char name[PIPELINE_SHADER_NAME_LENGTH];
+    SDL_GPUShader *shader;
+} CachedShader;
+
+// A create-info decoded from state words, with the arrays it points to.
+typedef struct DecodedPipelineState
+{
+    SDL_GPUGraphicsPipelineCreateInfo create_info;
+    SDL_GPUVertexBufferDescription vertex_buffers[PIPELINE_MAX_VERTEX_BUFFERS];
+    SDL_GPUVertexAttribute vertex_attributes[PIPELINE_MAX_VERTEX_ATTRIBUTES];
+    SDL_GPUColorTargetDescription color_targets[PIPELINE_MAX_COLOR_TARGETS];
+} DecodedPipelineState;
+
+struct PipelineCache
+{
+    SDL_GPUDevice *gpu_device;
+    PipelineShaderLoader loader;
+    void *loader_userdata;
+
+    PipelineEntry *entries;
+    Uint32 num_entries;
+    Uint32 entries_capacity;
+    Uint32 *table;                  // Open addressing: entry index + 1, 0 when empty
+    Uint32 table_capacity;          // Power of two, at most half full
+
+    CachedShader *shaders;
+    Uint32 num_shaders;
+    Uint32 shaders_capacity;
+
+    bool prewarming;
+    PipelineCacheStats stats;
+};
+
+// ---------------------------------------------------------------------------
+// State encoding
+// ---------------------------------------------------------------------------
+
+static Uint32 FloatBits(float value)
+{
+    Uint32 bits;
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float BitsFloat(Uint32 bits)
+{
+    float value;
+    SDL_memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void EncodeStencilState(const SDL_GPUStencilOpState *state, Uint32 *words, Uint32 *n)
+{
+    words[(*n)++] = (Uint32)state->fail_op;
+    words[(*n)++] = (Uint32)state->pass_op;
+    words[(*n)++] = (Uint32)state->depth_fail_op;
+    words[(*n)++] = (Uint32)state->compare_op;
+}
+
+// Every state field of create_info as 32-bit words, arrays by value and
+// without padding, so equal state encodes equal and decodes back. Returns the
+// word count, or 0 if the state has more buffers, attributes or targets than
+// SDL allows.
+static Uint32 EncodePipelineState(const SDL_GPUGraphicsPipelineCreateInfo *create_info, Uint32 *words)
+{
+    const SDL_GPUVertexInputState *vertex_input = &create_info->vertex_input_state;
+    const SDL_GPUGraphicsPipelineTargetInfo *target_info = &create_info->target_info;
+    if (vertex_input->num_vertex_buffers > PIPELINE_MAX_VERTEX_BUFFERS ||
+        vertex_input->num_vertex_attributes > PIPELINE_MAX_VERTEX_ATTRIBUTES ||
+        target_info->num_color_targets > PIPELINE_MAX_COLOR_TARGETS) {
+        SDL_SetError("Pipeline state has too many vertex buffers, attributes or color targets");
+        return 0;
+    }
+
+    Uint32 n = 0;
+    words[n++] = vertex_input->num_vertex_buffers;
+    for (Uint32 i = 0; i < vertex_input->num_vertex_buffers; i++) {
+        const SDL_GPUVertexBufferDescription *buffer = &vertex_input->vertex_buffer_descriptions[i];
+        words[n++] = buffer->slot;
+        words[n++] = buffer->pitch;
+        words[n++] = (Uint32)buffer->input_rate;
+        words[n++] = buffer->instance_step_rate;
+    }
+    words[n++] = vertex_input->num_vertex_attributes;
+    for (Uint32 i = 0; i < vertex_input->num_vertex_attributes; i++) {
+        const SDL_GPUVertexAttribute *attribute = &vertex_input->vertex_attributes[i];
+        words[n++] = attribute->location;
+        words[n++] = attribute->buffer_slot;
+        words[n++] = (Uint32)attribute->format;
+        words[n++] = attribute->offset;
+    }
+    words[n++] = (Uint32)create_info->primitive_type;
+
+    const SDL_GPURasterizerState *rasterizer = &create_info->rasterizer_state;
+    words[n++] = (Uint32)rasterizer->fill_mode;
+    words[n++] = (Uint32)rasterizer->cull_mode;
+    words[n++] = (Uint32)rasterizer->front_face;
+    words[n++] = FloatBits(rasterizer->depth_bias_constant_factor);
+    words[n++] = FloatBits(rasterizer->depth_bias_clamp);
+    words[n++] = FloatBits(rasterizer->depth_bias_slope_factor);
+    words[n++] = rasterizer->enable_depth_bias;
+    words[n++] = rasterizer->enable_depth_clip;
+
+    const SDL_GPUMultisampleState *multisample = &create_info->multisample_state;
+    words[n++] = (Uint32)multisample->sample_count;
+    words[n++] = multisample->sample_mask;
+    words[n++] = multisample->enable_mask;
+
+    const SDL_GPUDepthStencilState *depth_stencil = &create_info->depth_stencil_state;
+    words[n++] = (Uint32)depth_stencil->compare_op;
+    EncodeStencilState(&depth_stencil->back_stencil_state, words, &n);
+    EncodeStencilState(&depth_stencil->front_stencil_state, words, &n);
+    words[n++] = depth_stencil->compare_mask;
+    words[n++] = depth_stencil->write_mask;
+    words[n++] = depth_stencil->enable_depth_test;
+    words[n++] = depth_stencil->enable_depth_write;
+    words[n++] = depth_stencil->enable_stencil_test;
+
+    words[n++] = target_info->num_color_targets;
+    for (Uint32 i = 0; i < target_info->num_color_targets; i++) {
+        const SDL_GPUColorTargetDescription *target = &target_info->color_target_descriptions[i];
+        words[n++] = (Uint32)target->format;
+        words[n++] = (Uint32)target->blend_state.src_color_blendfactor;
+        words[n++] = (Uint32)target->blend_state.dst_color_blendfactor;
+        words[n++] = (Uint32)target->blend_state.color_blend_op;
+        words[n++] = (Uint32)target->blend_state.src_alpha_blendfactor;
+        words[n++] = (Uint32)target->blend_state.dst_alpha_blendfactor;
+        words[n++] = (Uint32)target->blend_state.alpha_blend_op;
+        words[n++] = target->blend_state.color_write_mask;
+        words[n++] = target->blend_state.enable_blend;
+        words[n++] = target->blend_state.enable_color_write_mask;
+    }
+    words[n++] = (Uint32)target_info->depth_stencil_format;
+    words[n++] = target_info->has_depth_stencil_target;
+    return n;
+}
+
+typedef struct WordReader
+{
+    const Uint32 *words;
+    Uint32 count;
+    Uint32 position;
+    bool overrun;
+} WordReader;
+
+static Uint32 ReadWord(WordReader *reader)
+{
+    if (reader->position == reader->count) {
+        reader->overrun = true;
+        return 0;
+    }
+    return reader->words[reader->position++];
+}
+
+static void DecodeStencilState(WordReader *reader, SDL_GPUStencilOpState *state)
+{
+    state->fail_op = (SDL_GPUStencilOp)ReadWord(reader);
+    state->pass_op = (SDL_GPUStencilOp)ReadWord(reader);
+    state->depth_fail_op = (SDL_GPUStencilOp)ReadWord(reader);
+    state->compare_op = (SDL_GPUCompareOp)ReadWord(reader);
+}
+
+// The inverse of EncodePipelineState, for words read from a manifest.
+static bool DecodePipelineState(const Uint32 *words, Uint32 count, DecodedPipelineState *decoded)
+{
+    SDL_zerop(decoded);
+    WordReader reader = { words, count, 0, false };
+    SDL_GPUGraphicsPipelineCreateInfo *create_info = &decoded->create_info;
+
+    SDL_GPUVertexInputState *vertex_input = &create_info->vertex_input_state;
+    vertex_input->num_vertex_buffers = ReadWord(&reader);
+    if (vertex_input->num_vertex_buffers > PIPELINE_MAX_VERTEX_BUFFERS) {
+        return false;
+    }
+    for (Uint32 i = 0; i < vertex_input->num_vertex_buffers; i++) {
+        SDL_GPUVertexBufferDescription *buffer = &decoded->vertex_buffers[i];
+        buffer->slot = ReadWord(&reader);
+        buffer->pitch = ReadWord(&reader);
+        buffer->input_rate = (SDL_GPUVertexInputRate)ReadWord(&reader);
+        buffer->instance_step_rate = ReadWord(&reader);
+    }
+    vertex_input->vertex_buffer_descriptions = decoded->vertex_buffers;
+    vertex_input->num_vertex_attributes = ReadWord(&reader);
+    if (vertex_input->num_vertex_attributes > PIPELINE_MAX_VERTEX_ATTRIBUTES) {
+        return false;
+    }
+    for (Uint32 i = 0; i < vertex_input->num_vertex_attributes; i++) {
+        SDL_GPUVertexAttribute *attribute = &decoded->vertex_attributes[i];
+        attribute->location = ReadWord(&reader);
+        attribute->buffer_slot = ReadWord(&reader);
+        attribute->format = (SDL_GPUVertexElementFormat)ReadWord(&reader);
+        attribute->offset = ReadWord(&reader);
+    }
+    vertex_input->vertex_attributes = decoded->vertex_attributes;
+    create_info->primitive_type = (SDL_GPUPrimitiveType)ReadWord(&reader);
+
+    SDL_GPURasterizerState *rasterizer = &create_info->rasterizer_state;
+    rasterizer->fill_mode = (SDL_GPUFillMode)ReadWord(&reader);
+    rasterizer->cull_mode = (SDL_GPUCullMode)ReadWord(&reader);
+    rasterizer->front_face = (SDL_GPUFrontFace)ReadWord(&reader);
+    rasterizer->depth_bias_constant_factor = BitsFloat(ReadWord(&reader));
+    rasterizer->depth_bias_clamp = BitsFloat(ReadWord(&reader));
+    rasterizer->depth_bias_slope_factor = BitsFloat(ReadWord(&reader));
+    rasterizer->enable_depth_bias = ReadWord(&reader) != 0;
+    rasterizer->enable_depth_clip = ReadWord(&reader) != 0;
+
+    SDL_GPUMultisampleState *multisample = &create_info->multisample_state;
+    multisample->sample_count = (SDL_GPUSampleCount)ReadWord(&reader);
+    multisample->sample_mask = ReadWord(&reader);
+    multisample->enable_mask = ReadWord(&reader) != 0;
+
+    SDL_GPUDepthStencilState *depth_stencil = &create_info->depth_stencil_state;
+    depth_stencil->compare_op = (SDL_GPUCompareOp)ReadWord(&reader);
+    DecodeStencilState(&reader, &depth_stencil->back_stencil_state);
+    DecodeStencilState(&reader, &depth_stencil->front_stencil_state);
+    depth_stencil->compare_mask = (Uint8)ReadWord(&reader);
+    depth_stencil->write_mask = (Uint8)ReadWord(&reader);
+    depth_stencil->enable_depth_test = ReadWord(&reader) != 0;
+    depth_stencil->enable_depth_write = ReadWord(&reader) != 0;
+    depth_stencil->enable_stencil_test = ReadWord(&reader) != 0;
+
+    SDL_GPUGraphicsPipelineTargetInfo *target_info = &create_info->target_info;
+    target_info->num_color_targets = ReadWord(&reader);
+    if (target_info->num_color_targets > PIPELINE_MAX_COLOR_TARGETS) {
+        return false;
+    }
+    for (Uint32 i = 0; i < target_info->num_color_targets; i++) {
+        SDL_GPUColorTargetDescription *target = &decoded->color_targets[i];
+        target->format = (SDL_GPUTextureFormat)ReadWord(&reader);
+        target->blend_state.src_color_blendfactor = (SDL_GPUBlendFactor)ReadWord(&reader);
+        target->blend_state.dst_color_blendfactor = (SDL_GPUBlendFactor)ReadWord(&reader);
+        target->blend_state.color_blend_op = (SDL_GPUBlendOp)ReadWord(&reader);
+        target->blend_state.src_alpha_blendfactor = (SDL_GPUBlendFactor)ReadWord(&reader);
+        target->blend_state.dst_alpha_blendfactor = (SDL_GPUBlendFactor)ReadWord(&reader);
+        target->blend_state.alpha_blend_op = (SDL_GPUBlendOp)ReadWord(&reader);
+        target->blend_state.color_write_mask = (SDL_GPUColorComponentFlags)ReadWord(&reader);
+        target->blend_state.enable_blend = ReadWord(&reader) != 0;
+        target->blend_state.enable_color_write_mask = ReadWord(&reader) != 0;
+    }
+    target_info->color_target_descriptions = decoded->color_targets;
+    target_info->depth_stencil_format = (SDL_GPUTextureFormat)ReadWord(&reader);
+    target_info->has_depth_stencil_target = ReadWord(&reader) != 0;
+    return !reader.overrun && reader.position == count;
+}
+
+static Uint64 HashBytes(Uint64 hash, const void *data, size_t size)
+{
+    // 64-bit FNV-1a
+    const Uint8 *bytes = static_cast<const Uint8*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static Uint64 HashPipelineState(const char *vertex_shader, const char *fragment_shader, const Uint32 *words, Uint32 num_words)
+{
+    Uint64 hash = 0xcbf29ce484222325ULL;
+    // Terminators included so "ab" + "c" never collides with "a" + "bc"
+    hash = HashBytes(hash, vertex_shader, SDL_strlen(vertex_shader) + 1);
+    hash = HashBytes(hash, fragment_shader, SDL_strlen(fragment_shader) + 1);
+    // FNV-1a a word at a time: a quarter of the multiplies, which are most of
+    // a lookup. Each step only carries bits upwards, so finish with a mix that
+    // brings the high bits down into the table index.
+    for (Uint32 i = 0; i < num_words; i++) {
+        hash ^= words[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    // HashPipelineDesc returns 0 for state it cannot encode
+    return hash != 0 ? hash : 1;
+}
+
+Uint64 HashPipelineDesc(const char *vertex_shader, const char *fragment_shader, const SDL_GPUGraphicsPipelineCreateInfo *create_info)
+{
+    Uint32 words[PIPELINE_STATE_MAX_WORDS];
+    Uint32 num_words = EncodePipelineState(create_info, words);
+    return num_words > 0 ? HashPipelineState(vertex_shader, fragment_shader, words, num_words) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Cache
+// ---------------------------------------------------------------------------
+
+PipelineCache* CreatePipelineCache(SDL_GPUDevice *gpu_device, PipelineShaderLoader loader, void *loader_userdata)
+{
+    if (gpu_device != NULL && loader == NULL) {
+        SDL_SetError("Pipeline cache needs a shader loader");
+        return NULL;
+    }
+    PipelineCache *cache = static_cast<PipelineCache*>(SDL_calloc(1, sizeof(PipelineCache)));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->gpu_device = gpu_device;
+    cache->loader = loader;
+    cache->loader_userdata = loader_userdata;
+    return cache;
+}
+
+void DestroyPipelineCache(PipelineCache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+    for (Uint32 i = 0; i < cache->num_entries; i++) {
+        if (cache->entries[i].pipeline != NULL) {
+            SDL_ReleaseGPUGraphicsPipeline(cache->gpu_device, cache->entries[i].pipeline);
+        }
+    }
+    for (Uint32 i = 0; i < cache->num_shaders; i++) {
+        if (cache->shaders[i].shader != NULL) {
+            SDL_ReleaseGPUShader(cache->gpu_device, cache->shaders[i].shader);
+        }
+    }
+    SDL_free(cache->entries);
+    SDL_free(cache->table);
+    SDL_free(cache->shaders);
+    SDL_free(cache);
+}
+
+static bool MatchesEntry(const PipelineEntry *entry, Uint64 key, const char *vertex_shader, const char *fragment_shader,
+                         const Uint32 *words, Uint32 num_words)
+{
+    return entry->key == key && entry->num_words == num_words &&
+           SDL_memcmp(entry->state, words, num_words * sizeof(Uint32)) == 0 &&
+           SDL_strcmp(entry->vertex_shader, vertex_shader) == 0 &&
+           SDL_strcmp(entry->fragment_shader, fragment_shader) == 0;
+}
+
+// Slot of the matching entry, or of the empty slot it would go in.
+static Uint32 FindTableSlot(const PipelineCache *cache, Uint64 key, const char *vertex_shader, const char *fragment_shader,
+                            const Uint32 *words, Uint32 num_words)
+{
+    Uint32 mask = cache->table_capacity - 1;
+    for (Uint32 slot = (Uint32)key & mask;; slot = (slot + 1) & mask) {
+        Uint32 index = cache->table[slot];
+        if (index == 0 || MatchesEntry(&cache->entries[index - 1], key, vertex_shader, fragment_shader, words, num_words)) {
+            return slot;
+        }
+    }
+}
+
+static bool GrowTable(PipelineCache *cache)
+{
+    Uint32 capacity = SDL_max(cache->table_capacity * 2, 64u);
+    Uint32 *table = static_cast<Uint32*>(SDL_calloc(capacity, sizeof(Uint32)));
+    if (table == NULL) {
+        return false;
+    }
+    SDL_free(cache->table);
+    cache->table = table;
+    cache->table_capacity = capacity;
+    for (Uint32 i = 0; i < cache->num_entries; i++) {
+        const PipelineEntry *entry = &cache->entries[i];
+        Uint32 mask = capacity - 1;
+        Uint32 slot = (Uint32)entry->key & mask;
+        while (table[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = i + 1;
+    }
+    return true;
+}
+
+// Loads each shader once; pipelines keep what they need, so these are only
+// held for the next permutation that uses them.
+static SDL_GPUShader* GetCachedShader(PipelineCache *cache, const char *name)
+{
+    for (Uint32 i = 0; i < cache->num_shaders; i++) {
+        if (SDL_strcmp(cache->shaders[i].name, name) == 0) {
+            return cache->shaders[i].shader;
+        }
+    }
+    if (cache->num_shaders == cache->shaders_capacity) {
+        Uint32 capacity = SDL_max(cache->shaders_capacity * 2, 16u);
+        CachedShader *shaders = static_cast<CachedShader*>(SDL_realloc(cache->shaders, capacity * sizeof(CachedShader)));
+        if (shaders == NULL) {
+            return NULL;
+        }
+        cache->shaders = shaders;
+        cache->shaders_capacity = capacity;
+    }
+    SDL_GPUShader *shader = cache->loader(cache->gpu_device, name, cache->loader_userdata);
+    if (shader == NULL) {
+        SDL_Log("Pipeline cache: failed to load %s", name);
+        return NULL;
+    }
+    CachedShader *cached = &cache->shaders[cache->num_shaders++];
+    SDL_strlcpy(cached->name, name, sizeof(cached->name));
+    cached->shader = shader;
+    return shader;
+}
+
+static SDL_GPUGraphicsPipeline* CreateEntryPipeline(PipelineCache *cache, const PipelineEntry *entry,
+                                                    const SDL_GPUGraphicsPipelineCreateInfo *create_info)
+{
+    PROFILE_FUNCTION();
+    Uint64 start = SDL_GetTicksNS();
+    SDL_GPUShader *vertex_shader = GetCachedShader(cache, entry->vertex_shader);
+    SDL_GPUShader *fragment_shader = GetCachedShader(cache, entry->fragment_shader);
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+    if (vertex_shader != NULL && fragment_shader != NULL) {
+        SDL_GPUGraphicsPipelineCreateInfo info = *create_info;
+        info.vertex_shader = vertex_shader;
+        info.fragment_shader = fragment_shader;
+        info.props = 0;
+        pipeline = SDL_CreateGPUGraphicsPipeline(cache->gpu_device, &info);
+        if (pipeline == NULL) {
+            SDL_Log("Pipeline cache: failed to create %s + %s: %s", entry->vertex_shader, entry->fragment_shader, SDL_GetError());
+        }
+    }
+
+    double elapsed_ms = (SDL_GetTicksNS() - start) / 1e6;
+    cache->stats.create_ms += elapsed_ms;
+    cache->stats.max_create_ms = SDL_max(cache->stats.max_create_ms, elapsed_ms);
+    if (pipeline == NULL) {
+        cache->stats.failures++;
+    } else if (!cache->prewarming) {
+        SDL_Log("Pipeline cache: %s + %s was not prewarmed, created it in %.2f ms",
+                entry->vertex_shader, entry->fragment_shader, elapsed_ms);
+    }
+    return pipeline;
+}
+
+// Finds or adds the entry for a request. created is set when it was added.
+static PipelineEntry* FindOrAddEntry(PipelineCache *cache, const char *vertex_shader, const char *fragment_shader,
+                                     const Uint32 *words, Uint32 num_words, bool *created)
+{
+    *created = false;
+    if (SDL_strlen(vertex_shader) >= PIPELINE_SHADER_NAME_LENGTH || SDL_strlen(fragment_shader) >= PIPELINE_SHADER_NAME_LENGTH) {
+        SDL_SetError("Shader name too long for the pipeline cache");
+        return NULL;
+    }
+    if ((cache->num_entries + 1) * 2 > cache->table_capacity && !GrowTable(cache)) {
+        return NULL;
+    }
+    Uint64 key = HashPipelineState(vertex_shader, fragment_shader, words, num_words);
+    Uint32 slot = FindTableSlot(cache, key, vertex_shader, fragment_shader, words, num_words);
+    if (cache->table[slot] != 0) {
+        return &cache->entries[cache->table[slot] - 1];
+    }
+
+    if (cache->num_entries == cache->entries_capacity) {
+        Uint32 capacity = SDL_max(cache->entries_capacity * 2, 32u);
+        PipelineEntry *entries = static_cast<PipelineEntry*>(SDL_realloc(cache->entries, capacity * sizeof(PipelineEntry)));
+        if (entries == NULL) {
+            return NULL;
+        }
+        cache->entries = entries;
+        cache->entries_capacity = capacity;
+    }
+    PipelineEntry *entry = &cache->entries[cache->num_entries];
+    SDL_zerop(entry);
+    entry->key = key;
+    SDL_strlcpy(entry->vertex_shader, vertex_shader, sizeof(entry->vertex_shader));
+    SDL_strlcpy(entry->fragment_shader, fragment_shader, sizeof(entry->fragment_shader));
+    SDL_memcpy(entry->state, words, num_words * sizeof(Uint32));
+    entry->num_words = num_words;
+    cache->table[slot] = ++cache->num_entries;
+    *created = true;
+    return entry;
+}
+
+// Drops the entry FindOrAddEntry just added, so a pipeline that failed to create is neither a hit
+// nor saved. Nothing was inserted after it, so no other entry's probe runs through its slot.
+static void RemoveAddedEntry(PipelineCache *cache, const PipelineEntry *entry)
+{
+    Uint32 slot = FindTableSlot(cache, entry->key, entry->vertex_shader, entry->fragment_shader, entry->state, entry->num_words);
+    cache->table[slot] = 0;
+    cache->num_entries--;
+}
+
+SDL_GPUGraphicsPipeline* GetCachedPipeline(PipelineCache *cache, const char *vertex_shader, const char *fragment_shader,
+                                           const SDL_GPUGraphicsPipelineCreateInfo *create_info)
+{
+    cache->stats.requests++;
+    Uint32 words[PIPELINE_STATE_MAX_WORDS];
+    Uint32 num_words = EncodePipelineState(create_info, words);
+    bool created;
+    PipelineEntry *entry = num_words > 0 ? FindOrAddEntry(cache, vertex_shader, fragment_shader, words, num_words, &created) : NULL;
+    if (entry == NULL) {
+        cache->stats.failures++;
+        return NULL;
+    }
+    if (!created) {
+        cache->stats.hits++;
+        return entry->pipeline;
+    }
+    cache->stats.misses++;
+    if (cache->gpu_device == NULL) {
+        return NULL;
+    }
+    SDL_GPUGraphicsPipeline *pipeline = CreateEntryPipeline(cache, entry, create_info);
+    if (pipeline == NULL) {
+        RemoveAddedEntry(cache, entry);
+        return NULL;
+    }
+    entry->pipeline = pipeline;
+    return pipeline;
+}
+
+// ---------------------------------------------------------------------------
+// Manifest
+// ---------------------------------------------------------------------------
+
+static size_t GetNamesSize(const char *vertex_shader, const char *fragment_shader)
+{
+    size_t size = SDL_strlen(vertex_shader) + 1 + SDL_strlen(fragment_shader) + 1;
+    return (size + 3) & ~(size_t)3;
+}
+
+// Without a device every entry is only recorded; with one, only pipelines that exist are worth prewarming.
+static bool IsSavedEntry(const PipelineCache *cache, const PipelineEntry *entry)
+{
+    return cache->gpu_device == NULL || entry->pipeline != NULL;
+}
+
+bool SavePipelineManifest(const PipelineCache *cache, const char *path)
+{
+    PROFILE_FUNCTION();
+    size_t total_size = sizeof(PipelineManifestHeader);
+    Uint32 num_saved = 0;
+    for (Uint32 i = 0; i < cache->num_entries; i++) {
+        const PipelineEntry *entry = &cache->entries[i];
+        if (!IsSavedEntry(cache, entry)) {
+            continue;
+        }
+        num_saved++;
+        total_size += sizeof(PipelineManifestRecord) + GetNamesSize(entry->vertex_shader, entry->fragment_shader) +
+                      entry->num_words * sizeof(Uint32);
+    }
+    Uint8 *blob = static_cast<Uint8*>(SDL_calloc(1, total_size));
+    if (blob == NULL) {
+        return false;
+    }
+
+    PipelineManifestHeader *header = reinterpret_cast<PipelineManifestHeader*>(blob);
+    header->magic = PIPELINE_MANIFEST_MAGIC;
+    header->version = PIPELINE_MANIFEST_VERSION;
+    header->num_pipelines = num_saved;
+    size_t offset = sizeof(PipelineManifestHeader);
+    for (Uint32 i = 0; i < cache->num_entries; i++) {
+        const PipelineEntry *entry = &cache->entries[i];
+        if (!IsSavedEntry(cache, entry)) {
+            continue;
+        }
+        PipelineManifestRecord record = { entry->key, (Uint32)GetNamesSize(entry->vertex_shader, entry->fragment_shader), entry->num_words };
+        SDL_memcpy(blob + offset, &record, sizeof(record));
+        offset += sizeof(record);
+        size_t vertex_length = SDL_strlen(entry->vertex_shader) + 1;
+        SDL_memcpy(blob + offset, entry->vertex_shader, vertex_length);
+        SDL_memcpy(blob + offset + vertex_length, entry->fragment_shader, SDL_strlen(entry->fragment_shader) + 1);
+        offset += record.names_size;
+        SDL_memcpy(blob + offset, entry->state, entry->num_words * sizeof(Uint32));
+        offset += entry->num_words * sizeof(Uint32);
+    }
+
+    // Write to a temporary file and rename so a crash never leaves a torn manifest.
+    char temp_path[320];
+    SDL_snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    bool saved = SDL_SaveFile(temp_path, blob, total_size) && SDL_RenamePath(temp_path, path);
+    if (!saved) {
+        SDL_Log("Failed to write pipeline manifest %s: %s", path, SDL_GetError());
+        SDL_RemovePath(temp_path);
+    }
+    SDL_free(blob);
+    return saved;
+}
+
+int PrewarmPipelineCache(PipelineCache *cache, const char *path)
+{
+    PROFILE_FUNCTION();
+    size_t size;
+    Uint8 *blob = static_cast<Uint8*>(SDL_LoadFile(path, &size));
+    if (blob == NULL) {
+        return 0;
+    }
+    const PipelineManifestHeader *header = reinterpret_cast<const PipelineManifestHeader*>(blob);
+    if (size < sizeof(PipelineManifestHeader) || header->magic != PIPELINE_MANIFEST_MAGIC) {
+        SDL_Log("Pipeline manifest %s is corrupt", path);
+        SDL_free(blob);
+        return -1;
+    }
+    if (header->version != PIPELINE_MANIFEST_VERSION) {
+        SDL_Log("Pipeline manifest %s is from another version, ignoring it", path);
+        SDL_free(blob);
+        return 0;
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    cache->prewarming = true;
+    int created = 0;
+    bool corrupt = false;
+    size_t offset = sizeof(PipelineManifestHeader);
+    for (Uint32 i = 0; i < header->num_pipelines && !corrupt; i++) {
+        PipelineManifestRecord record;
+        if (size - offset < sizeof(record)) {
+            corrupt = true;
+            break;
+        }
+        SDL_memcpy(&record, blob + offset, sizeof(record));
+        offset += sizeof(record);
+        if (record.num_words > PIPELINE_STATE_MAX_WORDS || size - offset < record.names_size + record.num_words * sizeof(Uint32)) {
+            corrupt = true;
+            break;
+        }
+        // Both names must end inside the record's names
+        const char *vertex_shader = reinterpret_cast<const char*>(blob + offset);
+        size_t vertex_length = SDL_strnlen(vertex_shader, record.names_size);
+        const char *fragment_shader = vertex_shader + vertex_length + 1;
+        if (vertex_length + 1 >= record.names_size ||
+            SDL_strnlen(fragment_shader, record.names_size - vertex_length - 1) == record.names_size - vertex_length - 1) {
+            corrupt = true;
+            break;
+        }
+        offset += record.names_size;
+        Uint32 words[PIPELINE_STATE_MAX_WORDS];
+        SDL_memcpy(words, blob + offset, record.num_words * sizeof(Uint32));
+        offset += record.num_words * sizeof(Uint32);
+
+        DecodedPipelineState decoded;
+        if (!DecodePipelineState(words, record.num_words, &decoded) ||
+            HashPipelineState(vertex_shader, fragment_shader, words, record.num_words) != record.key) {
+            corrupt = true;
+            break;
+        }
+        bool added;
+        PipelineEntry *entry = FindOrAddEntry(cache, vertex_shader, fragment_shader, words, record.num_words, &added);
+        if (entry == NULL || !added) {
+            continue;
+        }
+        if (cache->gpu_device != NULL) {
+            entry->pipeline = CreateEntryPipeline(cache, entry, &decoded.create_info);
+            if (entry->pipeline == NULL) {
+                RemoveAddedEntry(cache, entry);
+                continue;
+            }
+        }
+        created++;
+    }
+    cache->prewarming = false;
+    cache->stats.prewarmed += (Uint32)created;
+    cache->stats.prewarm_ms += (SDL_GetTicksNS() - start) / 1e6;
+    SDL_free(blob);
+
+    if (corrupt) {
+        SDL_Log("Pipeline manifest %s is corrupt after %d pipelines", path, created);
+        return -1;
+    }
+    return created;
+}
+
+PipelineCacheStats GetPipelineCacheStats(const PipelineCache *cache)
+{
+    PipelineCacheStats stats = cache->stats;
+    stats.pipelines = cache->num_entries;
+    return stats;
+}
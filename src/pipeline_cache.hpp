@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Graphics pipeline (PSO) cache. Pipelines are requested by shader names plus
+// a create-info, and identical requests share one pipeline. The key hashes
+// every state field by value: the vertex layout, primitive type, rasterizer,
+// multisample and depth-stencil state, and each color target's format and
+// blend state. Pointers, padding and props are not part of it.
+//
+// Every pipeline created is remembered in a manifest. Saving it at shutdown
+// and prewarming from it at the next startup creates those pipelines before
+// the first frame, so nothing compiles mid-frame. Pipelines from the cache do
+// not hot reload; register them with the shader registry for that.
+
+typedef struct PipelineCache PipelineCache;
+
+// Returns a new shader reference the cache releases, or NULL, e.g.
+// ShaderCrossLoadShader or a loader that tries the asset pack first.
+typedef SDL_GPUShader* (*PipelineShaderLoader)(SDL_GPUDevice *gpu_device, const char *shader_filename, void *userdata);
+
+typedef struct PipelineCacheStats
+{
+    Uint32 pipelines;
+    Uint32 requests;
+    Uint32 hits;
+    Uint32 misses;              // Pipelines created on request, after any prewarm
+    Uint32 prewarmed;
+    Uint32 failures;
+    double create_ms;           // Total spent creating pipelines, shaders included
+    double max_create_ms;       // Longest single creation: the worst hitch
+    double prewarm_ms;
+} PipelineCacheStats;
+
+// gpu_device may be NULL to only hash and record, for tools and benchmarks;
+// requests then return NULL and loader may be NULL too. Main thread only.
+PipelineCache* CreatePipelineCache(SDL_GPUDevice *gpu_device, PipelineShaderLoader loader, void *loader_userdata);
+// Releases every pipeline and shader the cache created.
+void DestroyPipelineCache(PipelineCache *cache);
+
+// The pipeline for vertex_shader + fragment_shader (names handed to the
+// loader) with create_info's state, created on the first
+// request. create_info's shader fields and props are ignored. The cache owns
+// the result.
+SDL_GPUGraphicsPipeline* GetCachedPipeline(PipelineCache *cache, const char *vertex_shader, const char *fragment_shader,
+                                           const SDL_GPUGraphicsPipelineCreateInfo *create_info);
+
+// Key GetCachedPipeline uses, for tools and tests.
+Uint64 HashPipelineDesc(const char *vertex_shader, const char *fragment_shader, const SDL_GPUGraphicsPipelineCreateInfo *create_info);
+
+// Writes every pipeline in the cache to path.
+bool SavePipelineManifest(const PipelineCache *cache, const char *path);
+// Creates every pipeline listed in path. A missing manifest is not an error.
+// Returns the number of pipelines created, or -1 if the file is corrupt.
+int PrewarmPipelineCache(PipelineCache *cache, const char *path);
+
+PipelineCacheStats GetPipelineCacheStats(const PipelineCache *cache);
@@ -0,0 +1,281 @@
+#include <SDL3/SDL.h>
+#include <profiler.hpp>
+
+#define PROFILER_EVENT_MASK (PROFILER_EVENTS_PER_THREAD - 1)
+// Readers skip this many of the oldest events, so a thread can keep writing
+// while they copy without reaching what they are reading
+#define PROFILER_READ_SLACK (PROFILER_EVENTS_PER_THREAD / 4)
+#define PROFILER_READ_ATTEMPTS 4
+#define PROFILER_THREAD_NAME_LENGTH 32
+
+typedef struct ProfilerThread
+{
+    ProfileEvent *events;       // Ring; allocated on the first zone of the first thread in the slot, never freed
+    SDL_AtomicU32 head;         // Events ever written; only the owner stores it
+    SDL_AtomicInt in_use;       // A live thread owns the slot
+    Uint32 depth;               // Zones open; owner only
+    SDL_ThreadID id;
+    char name[PROFILER_THREAD_NAME_LENGTH];
+} ProfilerThread;
+
+static ProfilerThread profiler_threads[PROFILER_MAX_THREADS];
+static SDL_AtomicInt profiler_num_threads;
+static SDL_AtomicInt profiler_dropped_threads;
+static SDL_SpinLock profiler_thread_lock;
+
+static Uint64 profiler_frames[PROFILER_MAX_FRAMES];
+static SDL_AtomicU32 profiler_num_frames;
+
+// Gives the slot back when its thread exits, so short-lived threads
+// (a bench's job systems) reuse slots instead of using them up. The events stay. Kept
+// apart from the plain pointers below, which need no guard to reach.
+typedef struct ProfilerThreadOwner
+{
+    ProfilerThread *thread = NULL;
+
+    ~ProfilerThreadOwner()
+    {
+        if (thread != NULL) {
+            SDL_SetAtomicInt(&thread->in_use, 0);
+        }
+    }
+} ProfilerThreadOwner;
+
+static thread_local ProfilerThread *tls_profiler_thread;
+static thread_local bool tls_profiler_failed;
+static thread_local ProfilerThreadOwner tls_profiler_owner;
+
+static ProfilerThread* GetProfilerThread()
+{
+    if (tls_profiler_thread != NULL || tls_profiler_failed) {
+        return tls_profiler_thread;
+    }
+
+    SDL_LockSpinlock(&profiler_thread_lock);
+    int num_threads = SDL_GetAtomicInt(&profiler_num_threads);
+    ProfilerThread *thread = NULL;
+    for (int i = 0; i < num_threads && thread == NULL; i++) {
+        if (SDL_GetAtomicInt(&profiler_threads[i].in_use) == 0) {
+            thread = &profiler_threads[i];
+        }
+    }
+    if (thread == NULL && num_threads < PROFILER_MAX_THREADS) {
+        thread = &profiler_threads[num_threads];
+        thread->events = static_cast<ProfileEvent*>(SDL_malloc(PROFILER_EVENTS_PER_THREAD * sizeof(ProfileEvent)));
+        if (thread->events != NULL) {
+            SDL_SetAtomicInt(&profiler_num_threads, num_threads + 1);
+        } else {
+            thread = NULL;
+        }
+    }
+    if (thread != NULL) {
+        thread->id = SDL_GetCurrentThreadID();
+        thread->depth = 0;
+        SDL_snprintf(thread->name, sizeof(thread->name), "Thread %" SDL_PRIu64, (Uint64)thread->id);
+        SDL_SetAtomicInt(&thread->in_use, 1);
+    }
+    SDL_UnlockSpinlock(&profiler_thread_lock);
+
+    if (thread == NULL) {
+        SDL_AddAtomicInt(&profiler_dropped_threads, 1);
+        tls_profiler_failed = true;
+        return NULL;
+    }
+    tls_profiler_owner.thread = thread;
+    tls_profiler_thread = thread;
+    return thread;
+}
+
+void SetProfilerThreadName(const char *name)
+{
+    ProfilerThread *thread = GetProfilerThread();
+    if (thread != NULL) {
+        SDL_LockSpinlock(&profiler_thread_lock);
+        SDL_strlcpy(thread->name, name, sizeof(thread->name));
+        SDL_UnlockSpinlock(&profiler_thread_lock);
+    }
+}
+
+const char* GetProfilerThreadName(Uint32 thread)
+{
+    return thread < (Uint32)SDL_GetAtomicInt(&profiler_num_threads) ? profiler_threads[thread].name : "";
+}
+
+Uint32 BeginProfileZone()
+{
+    ProfilerThread *thread = GetProfilerThread();
+    return thread != NULL ? thread->depth++ : 0;
+}
+
+void EndProfileZone(const char *name, Uint64 start, Uint32 depth)
+{
+    Uint64 end = SDL_GetPerformanceCounter();
+    ProfilerThread *thread = tls_profiler_thread;
+    if (thread == NULL) {
+        return;
+    }
+    thread->depth = depth;
+    Uint32 head = SDL_GetAtomicU32(&thread->head);
+    ProfileEvent *event = &thread->events[head & PROFILER_EVENT_MASK];
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    event->thread = (Uint16)(thread - profiler_threads);
+    event->depth = (Uint16)depth;
+    SDL_SetAtomicU32(&thread->head, head + 1);
+}
+
+void MarkProfilerFrame()
+{
+    Uint32 count = SDL_GetAtomicU32(&profiler_num_frames);
+    profiler_frames[count % PROFILER_MAX_FRAMES] = SDL_GetPerformanceCounter();
+    SDL_SetAtomicU32(&profiler_num_frames, count + 1);
+}
+
+bool GetProfilerFrame(Uint32 age, Uint64 *start, Uint64 *end)
+{
+    Uint32 count = SDL_GetAtomicU32(&profiler_num_frames);
+    // The oldest slot is about to be overwritten; don't hand it out
+    if (age >= count || age >= PROFILER_MAX_FRAMES - 1) {
+        return false;
+    }
+    Uint32 frame = count - 1 - age;
+    *start = profiler_frames[frame % PROFILER_MAX_FRAMES];
+    *end = age == 0 ? SDL_GetPerformanceCounter() : profiler_frames[(frame + 1) % PROFILER_MAX_FRAMES];
+    return true;
+}
+
+// One thread's events overlapping [start, end). The copy is retried if the
+// thread wrote far enough meanwhile to have overwritten part of it.
+static Uint32 CopyThreadEvents(ProfilerThread *thread, Uint64 start, Uint64 end, ProfileEvent *events, Uint32 max_events)
+{
+    for (int attempt = 0; attempt < PROFILER_READ_ATTEMPTS; attempt++) {
+        Uint32 head = SDL_GetAtomicU32(&thread->head);
+        Uint32 available = SDL_min(head, (Uint32)(PROFILER_EVENTS_PER_THREAD - PROFILER_READ_SLACK));
+        Uint32 first = head - available;
+
+        // Events are written as zones end, so end times only go up: skip to the
+        // window. Offsets from first, since head wraps.
+        Uint32 low = 0, high = available;
+        while (low < high) {
+            Uint32 middle = low + (high - low) / 2;
+            if (thread->events[(first + middle) & PROFILER_EVENT_MASK].end <= start) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        Uint32 written = 0;
+        for (Uint32 i = low; i < available && written < max_events; i++) {
+            const ProfileEvent *event = &thread->events[(first + i) & PROFILER_EVENT_MASK];
+            if (event->start < end && event->end > start) {
+                events[written++] = *event;
+            }
+        }
+
+        Uint32 after = SDL_GetAtomicU32(&thread->head);
+        if (after - head <= PROFILER_READ_SLACK) {
+            return written;
+        }
+    }
+    return 0;
+}
+
+Uint32 CopyProfilerEvents(Uint64 start, Uint64 end, ProfileEvent *events, Uint32 max_events)
+{
+    Uint32 written = 0;
+    int num_threads = SDL_GetAtomicInt(&profiler_num_threads);
+    for (int i = 0; i < num_threads && written < max_events; i++) {
+        written += CopyThreadEvents(&profiler_threads[i], start, end, &events[written], max_events - written);
+    }
+    return written;
+}
+
+ProfilerStats GetProfilerStats()
+{
+    ProfilerStats stats;
+    SDL_zero(stats);
+    stats.threads = (Uint32)SDL_GetAtomicInt(&profiler_num_threads);
+    for (Uint32 i = 0; i < stats.threads; i++) {
+        Uint32 head = SDL_GetAtomicU32(&profiler_threads[i].head);
+        stats.events += head;
+        stats.overwritten += head > PROFILER_EVENTS_PER_THREAD ? head - PROFILER_EVENTS_PER_THREAD : 0;
+    }
+    stats.dropped_threads = (Uint32)SDL_GetAtomicInt(&profiler_dropped_threads);
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// Chrome trace export
+// ---------------------------------------------------------------------------
+
+static void WriteJSONString(SDL_IOStream *io, const char *text)
+{
+    SDL_WriteU8(io, '"');
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            SDL_IOprintf(io, "\\%c", *c);
+        } else if ((Uint8)*c < 0x20) {
+            SDL_IOprintf(io, "\\u%04x", (Uint8)*c);
+        } else {
+            SDL_WriteU8(io, (Uint8)*c);
+        }
+    }
+    SDL_WriteU8(io, '"');
+}
+
+bool WriteProfilerTrace(const char *path)
+{
+    Uint32 num_threads = (Uint32)SDL_GetAtomicInt(&profiler_num_threads);
+    Uint32 max_events = num_threads * PROFILER_EVENTS_PER_THREAD;
+    ProfileEvent *events = static_cast<ProfileEvent*>(SDL_malloc(SDL_max(max_events, 1u) * sizeof(ProfileEvent)));
+    if (events == NULL) {
+        return false;
+    }
+    Uint32 num_events = CopyProfilerEvents(0, SDL_MAX_UINT64, events, max_events);
+
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (io == NULL) {
+        SDL_Log("Failed to write profiler trace %s: %s", path, SDL_GetError());
+        SDL_free(events);
+        return false;
+    }
+
+    // Microseconds from the earliest event
+    Uint64 origin = SDL_MAX_UINT64;
+    for (Uint32 i = 0; i < num_events; i++) {
+        origin = SDL_min(origin, events[i].start);
+    }
+    double us_per_tick = 1e6 / (double)SDL_GetPerformanceFrequency();
+
+    SDL_IOprintf(io, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (Uint32 i = 0; i < num_threads; i++) {
+        SDL_IOprintf(io, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i);
+        WriteJSONString(io, profiler_threads[i].name);
+        SDL_IOprintf(io, "}},\n");
+    }
+    Uint32 num_frames = SDL_GetAtomicU32(&profiler_num_frames);
+    for (Uint32 age = SDL_min(num_frames, (Uint32)PROFILER_MAX_FRAMES - 1); age-- > 0;) {
+        Uint64 frame_start, frame_end;
+        if (num_events > 0 && GetProfilerFrame(age, &frame_start, &frame_end) && frame_start >= origin) {
+            SDL_IOprintf(io, "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f},\n",
+                         (frame_start - origin) * us_per_tick);
+        }
+    }
+    for (Uint32 i = 0; i < num_events; i++) {
+        const ProfileEvent *event = &events[i];
+        SDL_IOprintf(io, "{\"name\":");
+        WriteJSONString(io, event->name);
+        SDL_IOprintf(io, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n", event->thread,
+                     (event->start - origin) * us_per_tick, (event->end - event->start) * us_per_tick);
+    }
+    // A closing metadata event saves tracking which entry is the last for its comma
+    SDL_IOprintf(io, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"VideoGame\"}}\n]}\n");
+
+    bool ok = SDL_CloseIO(io);
+    SDL_free(events);
+    if (ok) {
+        SDL_Log("Wrote %u profiler events to %s", num_events, path);
+    }
+    return ok;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// CPU instrumentation. PROFILE_ZONE("name") times the rest of its scope on
+// whichever thread runs it. Every thread writes finished zones into its own
+// ring, so recording takes no lock: two SDL_GetPerformanceCounter reads and
+// one store. Rings keep the most recent PROFILER_EVENTS_PER_THREAD zones and
+// overwrite the oldest. Readers (the timeline window, trace export) copy
+// events out while threads keep writing and drop any that were overwritten
+// mid-copy.
+//
+// Building with PROFILER_ENABLED=0 compiles every zone out; the rest of the
+// API stays so callers need no #ifs, it just has nothing to report.
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILER_EVENTS_PER_THREAD 16384   // Power of two; 512 KB a thread
+#define PROFILER_MAX_THREADS 64
+#define PROFILER_MAX_FRAMES 256            // Frame boundaries remembered
+
+typedef struct ProfileEvent
+{
+    const char *name;           // Must outlive the capture; literals are safest
+    Uint64 start;               // SDL_GetPerformanceCounter ticks
+    Uint64 end;
+    Uint16 thread;              // Index into the profiler's threads
+    Uint16 depth;               // Zones open around this one on its thread
+} ProfileEvent;
+
+typedef struct ProfilerStats
+{
+    Uint32 threads;
+    Uint64 events;              // Recorded since startup, across threads
+    Uint64 overwritten;         // Of those, lost to ring wrap-around
+    Uint32 dropped_threads;     // Threads past PROFILER_MAX_THREADS, which record nothing
+} ProfilerStats;
+
+// Optional: shows in the timeline and trace instead of the thread ID. name is copied.
+void SetProfilerThreadName(const char *name);
+const char* GetProfilerThreadName(Uint32 thread);
+
+// Called once per frame, at its start; the timeline draws from one mark to the next.
+void MarkProfilerFrame();
+// The start of the frame `age` frames back, 0 being the one in progress.
+// False if it has not happened or has been forgotten.
+bool GetProfilerFrame(Uint32 age, Uint64 *start, Uint64 *end);
+
+// Copies the events overlapping [start, end) from every thread, at most
+// max_events of them, oldest first per thread. Returns how many were written.
+Uint32 CopyProfilerEvents(Uint64 start, Uint64 end, ProfileEvent *events, Uint32 max_events);
+
+// Everything still in the rings as Chrome trace event JSON, which
+// chrome://tracing, Perfetto and Speedscope open.
+bool WriteProfilerTrace(const char *path);
+
+ProfilerStats GetProfilerStats();
+
+// Zone recording; use PROFILE_ZONE rather than calling these directly.
+Uint32 BeginProfileZone();
+void EndProfileZone(const char *name, Uint64 start, Uint32 depth);
+
+#if PROFILER_ENABLED
+struct ProfileZone
+{
+    const char *name;
+    Uint64 start;
+    Uint32 depth;
+
+    explicit ProfileZone(const char *zone_name) : name(zone_name)
+    {
+        depth = BeginProfileZone();
+        start = SDL_GetPerformanceCounter();
+    }
+    ~ProfileZone()
+    {
+        EndProfileZone(name, start, depth);
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_ZONE_CONCAT2(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profile_zone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
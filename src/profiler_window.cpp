@@ -0,0 +1,235 @@
+#include <SDL3/SDL.h>
+#include "imgui.h"
+#include <profiler.hpp>
+#include <profiler_window.hpp>
+
+#define PROFILER_WINDOW_MAX_EVENTS 16384
+#define PROFILER_WINDOW_HISTORY 120         // Frames in the frame time graph
+#define PROFILER_WINDOW_MAX_ZONES 64        // Distinct zone names totalled per frame
+#define PROFILER_WINDOW_TOP_ZONES 12
+#define PROFILER_WINDOW_MAX_DEPTH 32
+
+typedef struct ZoneTotal
+{
+    const char *name;
+    Uint64 ticks;
+    Uint32 calls;
+} ZoneTotal;
+
+struct ProfilerWindow
+{
+    char trace_path[256];
+    char status[300];
+    ProfileEvent *events;       // The frame shown
+    Uint32 num_events;
+    Uint64 frame_start;
+    Uint64 frame_end;
+    float history[PROFILER_WINDOW_HISTORY];
+    ZoneTotal zones[PROFILER_WINDOW_MAX_ZONES];
+    Uint32 num_zones;
+    bool paused;
+    float zoom;
+};
+
+ProfilerWindow* CreateProfilerWindow(const char *trace_path)
+{
+    ProfilerWindow *window = static_cast<ProfilerWindow*>(SDL_calloc(1, sizeof(ProfilerWindow)));
+    if (window == NULL) {
+        return NULL;
+    }
+    window->events = static_cast<ProfileEvent*>(SDL_malloc(PROFILER_WINDOW_MAX_EVENTS * sizeof(ProfileEvent)));
+    if (window->events == NULL) {
+        SDL_free(window);
+        return NULL;
+    }
+    SDL_strlcpy(window->trace_path, trace_path, sizeof(window->trace_path));
+    window->zoom = 1.0f;
+    return window;
+}
+
+void DestroyProfilerWindow(ProfilerWindow *window)
+{
+    if (window == NULL) {
+        return;
+    }
+    SDL_free(window->events);
+    SDL_free(window);
+}
+
+static int CompareZoneTotals(const void *a, const void *b)
+{
+    Uint64 x = static_cast<const ZoneTotal*>(a)->ticks, y = static_cast<const ZoneTotal*>(b)->ticks;
+    return x > y ? -1 : x < y ? 1 : 0;
+}
+
+// The frame `age` back becomes the one shown, with its zones totalled by name.
+static void CaptureFrame(ProfilerWindow *window, Uint32 age)
+{
+    if (!GetProfilerFrame(age, &window->frame_start, &window->frame_end)) {
+        window->num_events = 0;
+        window->num_zones = 0;
+        return;
+    }
+    window->num_events = CopyProfilerEvents(window->frame_start, window->frame_end, window->events, PROFILER_WINDOW_MAX_EVENTS);
+
+    window->num_zones = 0;
+    for (Uint32 i = 0; i < window->num_events; i++) {
+        const ProfileEvent *event = &window->events[i];
+        Uint32 z = 0;
+        while (z < window->num_zones && SDL_strcmp(window->zones[z].name, event->name) != 0) {
+            z++;
+        }
+        if (z == window->num_zones) {
+            if (z == PROFILER_WINDOW_MAX_ZONES) {
+                continue;
+            }
+            window->zones[z].name = event->name;
+            window->zones[z].ticks = 0;
+            window->zones[z].calls = 0;
+            window->num_zones++;
+        }
+        Uint64 start = SDL_max(event->start, window->frame_start), end = SDL_min(event->end, window->frame_end);
+        window->zones[z].ticks += end - start;
+        window->zones[z].calls++;
+    }
+    SDL_qsort(window->zones, window->num_zones, sizeof(ZoneTotal), CompareZoneTotals);
+}
+
+static ImU32 GetZoneColor(const char *name)
+{
+    Uint32 hash = 2166136261u;
+    for (const char *c = name; *c != '\0'; c++) {
+        hash = (hash ^ (Uint8)*c) * 16777619u;
+    }
+    return ImColor::HSV((hash % 360) / 360.0f, 0.45f, 0.75f);
+}
+
+static void DrawTimeline(ProfilerWindow *window, double ms_per_tick)
+{
+    // Deepest zone per thread sets each thread's lane height
+    int depths[PROFILER_MAX_THREADS];
+    for (int t = 0; t < PROFILER_MAX_THREADS; t++) {
+        depths[t] = -1;
+    }
+    for (Uint32 i = 0; i < window->num_events; i++) {
+        const ProfileEvent *event = &window->events[i];
+        depths[event->thread] = SDL_max(depths[event->thread], (int)SDL_min(event->depth, PROFILER_WINDOW_MAX_DEPTH - 1));
+    }
+    float row_height = ImGui::GetTextLineHeightWithSpacing();
+    float lane_y[PROFILER_MAX_THREADS];
+    float height = 0.0f;
+    for (int t = 0; t < PROFILER_MAX_THREADS; t++) {
+        lane_y[t] = height;
+        if (depths[t] >= 0) {
+            height += row_height * (depths[t] + 2);
+        }
+    }
+
+    ImGui::BeginChild("Timeline", ImVec2(0.0f, SDL_min(height, 400.0f) + ImGui::GetStyle().ScrollbarSize + 4.0f),
+                      ImGuiChildFlags_Borders, ImGuiWindowFlags_HorizontalScrollbar);
+    float width = ImGui::GetContentRegionAvail().x * window->zoom;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Dummy(ImVec2(width, height));
+    ImDrawList *draw_list = ImGui::GetWindowDrawList();
+    double ticks = (double)SDL_max(window->frame_end - window->frame_start, (Uint64)1);
+
+    for (int t = 0; t < PROFILER_MAX_THREADS; t++) {
+        if (depths[t] >= 0) {
+            ImVec2 label = ImVec2(ImGui::GetScrollX() + origin.x, origin.y + lane_y[t]);
+            draw_list->AddText(label, ImGui::GetColorU32(ImGuiCol_TextDisabled), GetProfilerThreadName((Uint32)t));
+        }
+    }
+    for (Uint32 i = 0; i < window->num_events; i++) {
+        const ProfileEvent *event = &window->events[i];
+        Uint64 start = SDL_max(event->start, window->frame_start), end = SDL_min(event->end, window->frame_end);
+        float depth = (float)SDL_min(event->depth, PROFILER_WINDOW_MAX_DEPTH - 1);
+        ImVec2 min = ImVec2(origin.x + (float)((start - window->frame_start) / ticks * width),
+                            origin.y + lane_y[event->thread] + row_height * (depth + 1.0f));
+        ImVec2 max = ImVec2(SDL_max(origin.x + (float)((end - window->frame_start) / ticks * width), min.x + 1.0f),
+                            min.y + row_height - 1.0f);
+        draw_list->AddRectFilled(min, max, GetZoneColor(event->name));
+        if (max.x - min.x > 8.0f) {
+            draw_list->PushClipRect(min, max, true);
+            draw_list->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32_BLACK, event->name);
+            draw_list->PopClipRect();
+        }
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            ImGui::SetTooltip("%s\n%.3f ms on %s", event->name, (event->end - event->start) * ms_per_tick,
+                              GetProfilerThreadName(event->thread));
+        }
+    }
+    ImGui::EndChild();
+}
+
+void DrawProfilerWindow(ProfilerWindow *window, bool *open)
+{
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+    double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    // Frame times, oldest on the left; clicking one pauses on it
+    if (!window->paused) {
+        for (int i = 0; i < PROFILER_WINDOW_HISTORY; i++) {
+            Uint64 start, end;
+            Uint32 age = PROFILER_WINDOW_HISTORY - i;
+            window->history[i] = GetProfilerFrame(age, &start, &end) ? (float)((end - start) * ms_per_tick) : 0.0f;
+        }
+        CaptureFrame(window, 1);
+    }
+    ImGui::PlotHistogram("##Frames", window->history, PROFILER_WINDOW_HISTORY, 0, "Frame time (click to inspect)",
+                         0.0f, FLT_MAX, ImVec2(-1.0f, 60.0f));
+    if (ImGui::IsItemClicked() && !window->paused) {
+        float x = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / SDL_max(ImGui::GetItemRectSize().x, 1.0f);
+        int index = SDL_clamp((int)(x * PROFILER_WINDOW_HISTORY), 0, PROFILER_WINDOW_HISTORY - 1);
+        CaptureFrame(window, (Uint32)(PROFILER_WINDOW_HISTORY - index));
+        window->paused = true;
+    }
+
+    ImGui::Checkbox("Pause", &window->paused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150.0f);
+    ImGui::SliderFloat("Zoom", &window->zoom, 1.0f, 64.0f, "%.0fx", ImGuiSliderFlags_Logarithmic);
+    ImGui::SameLine();
+    if (ImGui::Button("Save trace")) {
+        if (WriteProfilerTrace(window->trace_path)) {
+            SDL_snprintf(window->status, sizeof(window->status), "Saved %s", window->trace_path);
+        } else {
+            SDL_snprintf(window->status, sizeof(window->status), "Failed: %s", SDL_GetError());
+        }
+    }
+    if (window->status[0] != '\0') {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(window->status);
+    }
+
+    ProfilerStats stats = GetProfilerStats();
+    ImGui::Text("Frame %.3f ms, %u zones on %u threads; %llu recorded, %llu overwritten",
+                (window->frame_end - window->frame_start) * ms_per_tick, window->num_events, stats.threads,
+                (unsigned long long)stats.events, (unsigned long long)stats.overwritten);
+#if !PROFILER_ENABLED
+    ImGui::TextDisabled("Zones are compiled out (PROFILER_ENABLED=0)");
+#endif
+
+    DrawTimeline(window, ms_per_tick);
+
+    if (ImGui::BeginTable("Zones", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableHeadersRow();
+        for (Uint32 z = 0; z < SDL_min(window->num_zones, (Uint32)PROFILER_WINDOW_TOP_ZONES); z++) {
+            const ZoneTotal *zone = &window->zones[z];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone->name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", zone->ticks * ms_per_tick);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", zone->calls);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// ImGui view of the profiler: recent frame times, one frame's zones per
+// thread as a flame chart (nesting stacks downward), and the zones that took
+// longest in it. Pausing freezes the frame shown; "Save trace" writes
+// everything still in the rings as Chrome trace JSON.
+
+typedef struct ProfilerWindow ProfilerWindow;
+
+// trace_path is where "Save trace" writes; copied.
+ProfilerWindow* CreateProfilerWindow(const char *trace_path);
+void DestroyProfilerWindow(ProfilerWindow *window);
+
+// Call between ImGui::NewFrame and ImGui::Render. open may be NULL.
+void DrawProfilerWindow(ProfilerWindow *window, bool *open);
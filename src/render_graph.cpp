@@ -0,0 +1,815 @@
+#include <SDL3/SDL.h>
+#include <render_graph.hpp>
+
+#define RENDER_GRAPH_KEEP_FRAMES 8      // Textures unused this many frames are released
+
+typedef struct GraphAttachment
+{
+    RenderResource resource;            // -1 for no depth target
+    SDL_GPULoadOp load_op;
+    SDL_FColor clear_color;
+    float clear_depth;
+} GraphAttachment;
+
+typedef struct GraphResource
+{
+    RenderTextureDesc desc;
+    SDL_GPUTexture *imported;
+    bool is_imported;
+    bool output;
+    SDL_GPUTextureUsageFlags usage;     // Everything the passes do with it
+
+    // Compiled
+    int first_group;                    // -1 when no live pass touches it
+    int last_group;
+    int slot;                           // Physical texture, transient only
+} GraphResource;
+
+typedef struct GraphPass
+{
+    RenderPassDesc desc;
+    GraphAttachment color_targets[RENDER_PASS_MAX_COLOR_TARGETS];
+    Uint32 num_color_targets;
+    GraphAttachment depth_target;
+    RenderResource reads[RENDER_PASS_MAX_READS];
+    Uint32 num_reads;
+    RenderResource storage_writes[RENDER_PASS_MAX_STORAGE_WRITES];
+    Uint32 num_storage_writes;
+
+    // Compiled
+    Uint64 producers;                   // Bit per pass whose writes this one reads
+    Uint64 predecessors;                // Bit per pass this one must run after
+    bool live;
+    int order;
+    int group;
+} GraphPass;
+
+// Passes recorded into one SDL render or compute pass.
+typedef struct GraphGroup
+{
+    int first;                          // Into RenderGraph::order
+    int count;
+    SDL_GPUStoreOp color_store_ops[RENDER_PASS_MAX_COLOR_TARGETS];
+    SDL_GPUStoreOp depth_store_op;
+} GraphGroup;
+
+typedef struct GraphTexture
+{
+    SDL_GPUTexture *texture;
+    SDL_GPUTextureCreateInfo created;   // What texture was created with
+
+    // What this frame needs from it
+    RenderTextureDesc desc;
+    SDL_GPUTextureUsageFlags usage;
+    int busy_until;                     // Last group using it this frame
+    Uint64 last_frame;                  // Frame it was last assigned
+} GraphTexture;
+
+struct RenderGraph
+{
+    SDL_GPUDevice *gpu_device;
+    GraphPass passes[RENDER_GRAPH_MAX_PASSES];
+    Uint32 num_passes;
+    GraphResource resources[RENDER_GRAPH_MAX_RESOURCES];
+    Uint32 num_resources;
+    GraphTexture textures[RENDER_GRAPH_MAX_TEXTURES];
+    Uint32 num_textures;
+
+    // Compiled
+    int order[RENDER_GRAPH_MAX_PASSES];
+    Uint32 num_order;
+    GraphGroup groups[RENDER_GRAPH_MAX_PASSES];
+    Uint32 num_groups;
+    Uint64 frame;
+    bool compiled;
+
+    RenderGraphStats stats;
+};
+
+static Uint64 PassBit(int pass)
+{
+    return (Uint64)1 << pass;
+}
+
+static bool IsValidPass(const RenderGraph *graph, int pass)
+{
+    return pass >= 0 && (Uint32)pass < graph->num_passes;
+}
+
+static bool IsValidResource(const RenderGraph *graph, RenderResource resource)
+{
+    return resource >= 0 && (Uint32)resource < graph->num_resources;
+}
+
+RenderGraph* CreateRenderGraph(SDL_GPUDevice *gpu_device)
+{
+    RenderGraph *graph = static_cast<RenderGraph*>(SDL_calloc(1, sizeof(RenderGraph)));
+    if (graph == NULL) {
+        return NULL;
+    }
+    graph->gpu_device = gpu_device;
+    return graph;
+}
+
+void DestroyRenderGraph(RenderGraph *graph)
+{
+    if (graph == NULL) {
+        return;
+    }
+    for (Uint32 i = 0; i < graph->num_textures; i++) {
+        if (graph->textures[i].texture != NULL) {
+            SDL_ReleaseGPUTexture(graph->gpu_device, graph->textures[i].texture);
+        }
+    }
+    SDL_free(graph);
+}
+
+void ResetRenderGraph(RenderGraph *graph)
+{
+    graph->num_passes = 0;
+    graph->num_resources = 0;
+    graph->num_order = 0;
+    graph->num_groups = 0;
+    graph->compiled = false;
+}
+
+// ---------------------------------------------------------------------------
+// Declaration
+// ---------------------------------------------------------------------------
+
+static RenderResource AddResource(RenderGraph *graph, SDL_GPUTexture *imported, bool is_imported, const RenderTextureDesc *desc)
+{
+    if (graph->num_resources == RENDER_GRAPH_MAX_RESOURCES) {
+        SDL_SetError("Render graph is full (%d resources)", RENDER_GRAPH_MAX_RESOURCES);
+        return -1;
+    }
+    GraphResource *resource = &graph->resources[graph->num_resources];
+    SDL_zerop(resource);
+    resource->desc = *desc;
+    resource->imported = imported;
+    resource->is_imported = is_imported;
+    resource->slot = -1;
+    graph->compiled = false;
+    return (RenderResource)graph->num_resources++;
+}
+
+RenderResource CreateRenderTexture(RenderGraph *graph, const RenderTextureDesc *desc)
+{
+    return AddResource(graph, NULL, false, desc);
+}
+
+RenderResource ImportRenderTexture(RenderGraph *graph, SDL_GPUTexture *texture, const RenderTextureDesc *desc)
+{
+    return AddResource(graph, texture, true, desc);
+}
+
+void SetRenderGraphOutput(RenderGraph *graph, RenderResource resource)
+{
+    if (IsValidResource(graph, resource)) {
+        graph->resources[resource].output = true;
+        graph->compiled = false;
+    }
+}
+
+int AddRenderPass(RenderGraph *graph, const RenderPassDesc *desc)
+{
+    if (graph->num_passes == RENDER_GRAPH_MAX_PASSES) {
+        SDL_SetError("Render graph is full (%d passes)", RENDER_GRAPH_MAX_PASSES);
+        return -1;
+    }
+    GraphPass *pass = &graph->passes[graph->num_passes];
+    SDL_zerop(pass);
+    pass->desc = *desc;
+    pass->depth_target.resource = -1;
+    graph->compiled = false;
+    return (int)graph->num_passes++;
+}
+
+static GraphPass* GetDeclaredPass(RenderGraph *graph, int pass, RenderResource resource)
+{
+    if (!IsValidPass(graph, pass) || !IsValidResource(graph, resource)) {
+        SDL_SetError("Invalid render pass %d or resource %d", pass, resource);
+        return NULL;
+    }
+    graph->compiled = false;
+    return &graph->passes[pass];
+}
+
+bool AddRenderPassColorTarget(RenderGraph *graph, int pass, RenderResource resource, SDL_GPULoadOp load_op, SDL_FColor clear_color)
+{
+    GraphPass *graph_pass = GetDeclaredPass(graph, pass, resource);
+    if (graph_pass == NULL) {
+        return false;
+    }
+    if (graph_pass->desc.type != RENDER_PASS_GRAPHICS) {
+        return SDL_SetError("Render pass '%s' is not a graphics pass", graph_pass->desc.name);
+    }
+    if (graph_pass->num_color_targets == RENDER_PASS_MAX_COLOR_TARGETS) {
+        return SDL_SetError("Render pass '%s' has too many color targets", graph_pass->desc.name);
+    }
+    GraphAttachment *target = &graph_pass->color_targets[graph_pass->num_color_targets++];
+    target->resource = resource;
+    target->load_op = load_op;
+    target->clear_color = clear_color;
+    graph->resources[resource].usage |= SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+    return true;
+}
+
+bool SetRenderPassDepthTarget(RenderGraph *graph, int pass, RenderResource resource, SDL_GPULoadOp load_op, float clear_depth)
+{
+    GraphPass *graph_pass = GetDeclaredPass(graph, pass, resource);
+    if (graph_pass == NULL) {
+        return false;
+    }
+    if (graph_pass->desc.type != RENDER_PASS_GRAPHICS) {
+        return SDL_SetError("Render pass '%s' is not a graphics pass", graph_pass->desc.name);
+    }
+    graph_pass->depth_target.resource = resource;
+    graph_pass->depth_target.load_op = load_op;
+    graph_pass->depth_target.clear_depth = clear_depth;
+    graph->resources[resource].usage |= SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
+    return true;
+}
+
+bool AddRenderPassRead(RenderGraph *graph, int pass, RenderResource resource)
+{
+    GraphPass *graph_pass = GetDeclaredPass(graph, pass, resource);
+    if (graph_pass == NULL) {
+        return false;
+    }
+    if (graph_pass->num_reads == RENDER_PASS_MAX_READS) {
+        return SDL_SetError("Render pass '%s' has too many reads", graph_pass->desc.name);
+    }
+    graph_pass->reads[graph_pass->num_reads++] = resource;
+    graph->resources[resource].usage |= SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    return true;
+}
+
+bool AddRenderPassStorageWrite(RenderGraph *graph, int pass, RenderResource resource)
+{
+    GraphPass *graph_pass = GetDeclaredPass(graph, pass, resource);
+    if (graph_pass == NULL) {
+        return false;
+    }
+    if (graph_pass->desc.type != RENDER_PASS_COMPUTE) {
+        return SDL_SetError("Render pass '%s' is not a compute pass", graph_pass->desc.name);
+    }
+    if (graph_pass->num_storage_writes == RENDER_PASS_MAX_STORAGE_WRITES) {
+        return SDL_SetError("Render pass '%s' has too many storage writes", graph_pass->desc.name);
+    }
+    graph_pass->storage_writes[graph_pass->num_storage_writes++] = resource;
+    graph->resources[resource].usage |= SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Compiling
+// ---------------------------------------------------------------------------
+
+// Per-resource state while walking the passes in declaration order.
+typedef struct ResourceVersion
+{
+    int last_writer;
+    Uint64 readers;                     // Passes that read it since last_writer
+} ResourceVersion;
+
+static bool ReadResource(RenderGraph *graph, int pass, RenderResource resource, ResourceVersion *versions)
+{
+    GraphPass *graph_pass = &graph->passes[pass];
+    ResourceVersion *version = &versions[resource];
+    if (version->last_writer >= 0) {
+        graph_pass->producers |= PassBit(version->last_writer);
+        graph_pass->predecessors |= PassBit(version->last_writer);
+    } else if (!graph->resources[resource].is_imported) {
+        return SDL_SetError("Render pass '%s' reads '%s' before anything writes it",
+                            graph_pass->desc.name, graph->resources[resource].desc.name);
+    }
+    version->readers |= PassBit(pass);
+    return true;
+}
+
+// Writes wait for the previous write and for every read of it.
+static void WriteResource(RenderGraph *graph, int pass, RenderResource resource, ResourceVersion *versions)
+{
+    GraphPass *graph_pass = &graph->passes[pass];
+    ResourceVersion *version = &versions[resource];
+    if (version->last_writer >= 0) {
+        graph_pass->predecessors |= PassBit(version->last_writer);
+    }
+    graph_pass->predecessors |= version->readers & ~PassBit(pass);
+    version->last_writer = pass;
+    version->readers = 0;
+}
+
+static bool BuildDependencies(RenderGraph *graph, ResourceVersion *versions)
+{
+    for (Uint32 r = 0; r < graph->num_resources; r++) {
+        versions[r].last_writer = -1;
+        versions[r].readers = 0;
+    }
+    for (Uint32 p = 0; p < graph->num_passes; p++) {
+        GraphPass *pass = &graph->passes[p];
+        pass->producers = 0;
+        pass->predecessors = 0;
+
+        // Reads first: loading a target reads what the previous writer left
+        for (Uint32 i = 0; i < pass->num_reads; i++) {
+            if (!ReadResource(graph, (int)p, pass->reads[i], versions)) {
+                return false;
+            }
+        }
+        for (Uint32 i = 0; i < pass->num_color_targets; i++) {
+            if (pass->color_targets[i].load_op == SDL_GPU_LOADOP_LOAD &&
+                !ReadResource(graph, (int)p, pass->color_targets[i].resource, versions)) {
+                return false;
+            }
+        }
+        if (pass->depth_target.resource >= 0 && pass->depth_target.load_op == SDL_GPU_LOADOP_LOAD &&
+            !ReadResource(graph, (int)p, pass->depth_target.resource, versions)) {
+            return false;
+        }
+
+        for (Uint32 i = 0; i < pass->num_color_targets; i++) {
+            WriteResource(graph, (int)p, pass->color_targets[i].resource, versions);
+        }
+        if (pass->depth_target.resource >= 0) {
+            WriteResource(graph, (int)p, pass->depth_target.resource, versions);
+        }
+        for (Uint32 i = 0; i < pass->num_storage_writes; i++) {
+            WriteResource(graph, (int)p, pass->storage_writes[i], versions);
+        }
+    }
+    return true;
+}
+
+// Live passes: the last writers of every output, passes with side effects,
+// and everything they read from. Producers always come earlier in declaration
+// order, so one backwards sweep finds them all.
+static Uint64 FindLivePasses(const RenderGraph *graph, const ResourceVersion *versions)
+{
+    Uint64 live = 0;
+    for (Uint32 r = 0; r < graph->num_resources; r++) {
+        if (graph->resources[r].output && versions[r].last_writer >= 0) {
+            live |= PassBit(versions[r].last_writer);
+        }
+    }
+    for (Uint32 p = 0; p < graph->num_passes; p++) {
+        if (graph->passes[p].desc.side_effects) {
+            live |= PassBit((int)p);
+        }
+    }
+    for (int p = (int)graph->num_passes - 1; p >= 0; p--) {
+        if (live & PassBit(p)) {
+            live |= graph->passes[p].producers;
+        }
+    }
+    return live;
+}
+
+static bool HasTargets(const GraphPass *pass)
+{
+    return pass->num_color_targets > 0 || pass->depth_target.resource >= 0;
+}
+
+static bool IsAttachment(const GraphPass *pass, RenderResource resource)
+{
+    for (Uint32 i = 0; i < pass->num_color_targets; i++) {
+        if (pass->color_targets[i].resource == resource) {
+            return true;
+        }
+    }
+    return pass->depth_target.resource == resource;
+}
+
+// next can continue previous's SDL render pass: the same targets, none of them
+// cleared, and nothing sampled from them.
+static bool CanMergePasses(const RenderGraph *graph, int previous, int next)
+{
+    const GraphPass *a = &graph->passes[previous];
+    const GraphPass *b = &graph->passes[next];
+    if (a->desc.type != RENDER_PASS_GRAPHICS || b->desc.type != RENDER_PASS_GRAPHICS || !HasTargets(a)) {
+        return false;
+    }
+    if (a->num_color_targets != b->num_color_targets || a->depth_target.resource != b->depth_target.resource) {
+        return false;
+    }
+    for (Uint32 i = 0; i < b->num_color_targets; i++) {
+        if (a->color_targets[i].resource != b->color_targets[i].resource ||
+            b->color_targets[i].load_op == SDL_GPU_LOADOP_CLEAR) {
+            return false;
+        }
+    }
+    if (b->depth_target.resource >= 0 && b->depth_target.load_op == SDL_GPU_LOADOP_CLEAR) {
+        return false;
+    }
+    for (Uint32 i = 0; i < b->num_reads; i++) {
+        if (IsAttachment(a, b->reads[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Kahn's algorithm over the live passes. Among the ready passes, one that can
+// merge into the previous pass goes first, then declaration order.
+static void OrderPasses(RenderGraph *graph, Uint64 live)
+{
+    Uint64 scheduled = 0;
+    int previous = -1;
+    graph->num_order = 0;
+    while ((scheduled & live) != live) {
+        int next = -1;
+        for (Uint32 p = 0; p < graph->num_passes; p++) {
+            Uint64 bit = PassBit((int)p);
+            if (!(live & bit) || (scheduled & bit) || (graph->passes[p].predecessors & live & ~scheduled)) {
+                continue;
+            }
+            if (next < 0) {
+                next = (int)p;
+            }
+            if (previous >= 0 && CanMergePasses(graph, previous, (int)p)) {
+                next = (int)p;
+                break;
+            }
+        }
+        // Predecessors are always declared earlier, so something is always ready
+        SDL_assert(next >= 0);
+        graph->order[graph->num_order++] = next;
+        scheduled |= PassBit(next);
+        previous = next;
+    }
+}
+
+static void GroupPasses(RenderGraph *graph)
+{
+    graph->num_groups = 0;
+    for (Uint32 i = 0; i < graph->num_order; i++) {
+        GraphPass *pass = &graph->passes[graph->order[i]];
+        if (i > 0 && CanMergePasses(graph, graph->order[i - 1], graph->order[i])) {
+            graph->groups[graph->num_groups - 1].count++;
+            graph->stats.merged++;
+        } else {
+            GraphGroup *group = &graph->groups[graph->num_groups++];
+            SDL_zerop(group);
+            group->first = (int)i;
+            group->count = 1;
+        }
+        pass->order = (int)i;
+        pass->group = (int)graph->num_groups - 1;
+    }
+}
+
+static void TouchResource(RenderGraph *graph, RenderResource resource, int group)
+{
+    GraphResource *graph_resource = &graph->resources[resource];
+    if (graph_resource->first_group < 0) {
+        graph_resource->first_group = group;
+    }
+    graph_resource->last_group = group;
+}
+
+// Lifetimes are in groups, not passes: a merged render pass binds its targets
+// for its whole length.
+static void FindLifetimes(RenderGraph *graph)
+{
+    for (Uint32 r = 0; r < graph->num_resources; r++) {
+        graph->resources[r].first_group = -1;
+        graph->resources[r].last_group = -1;
+        graph->resources[r].slot = -1;
+    }
+    for (Uint32 i = 0; i < graph->num_order; i++) {
+        const GraphPass *pass = &graph->passes[graph->order[i]];
+        for (Uint32 j = 0; j < pass->num_reads; j++) {
+            TouchResource(graph, pass->reads[j], pass->group);
+        }
+        for (Uint32 j = 0; j < pass->num_color_targets; j++) {
+            TouchResource(graph, pass->color_targets[j].resource, pass->group);
+        }
+        if (pass->depth_target.resource >= 0) {
+            TouchResource(graph, pass->depth_target.resource, pass->group);
+        }
+        for (Uint32 j = 0; j < pass->num_storage_writes; j++) {
+            TouchResource(graph, pass->storage_writes[j], pass->group);
+        }
+    }
+}
+
+static SDL_GPUStoreOp ChooseStoreOp(RenderGraph *graph, RenderResource resource, int group)
+{
+    const GraphResource *graph_resource = &graph->resources[resource];
+    if (graph_resource->is_imported || graph_resource->output || graph_resource->last_group > group) {
+        return SDL_GPU_STOREOP_STORE;
+    }
+    graph->stats.stores_skipped++;
+    return SDL_GPU_STOREOP_DONT_CARE;
+}
+
+static void ChooseStoreOps(RenderGraph *graph)
+{
+    for (Uint32 g = 0; g < graph->num_groups; g++) {
+        GraphGroup *group = &graph->groups[g];
+        const GraphPass *pass = &graph->passes[graph->order[group->first]];
+        for (Uint32 i = 0; i < pass->num_color_targets; i++) {
+            group->color_store_ops[i] = ChooseStoreOp(graph, pass->color_targets[i].resource, (int)g);
+        }
+        if (pass->depth_target.resource >= 0) {
+            group->depth_store_op = ChooseStoreOp(graph, pass->depth_target.resource, (int)g);
+        }
+    }
+}
+
+static bool IsCompatibleTexture(const RenderTextureDesc *a, const RenderTextureDesc *b)
+{
+    return a->format == b->format && a->width == b->width && a->height == b->height && a->sample_count == b->sample_count;
+}
+
+static bool MatchesCreatedTexture(const GraphTexture *texture, const RenderTextureDesc *desc)
+{
+    return texture->texture != NULL && texture->created.format == desc->format &&
+           texture->created.width == desc->width && texture->created.height == desc->height &&
+           texture->created.sample_count == desc->sample_count;
+}
+
+// Aliases a texture that finished before first_group when there is one.
+// Otherwise takes an unused texture from an earlier frame, preferring one that
+// already exists in the right shape, then a new slot, then the longest unused.
+static int FindTextureSlot(RenderGraph *graph, const RenderTextureDesc *desc, int first_group)
+{
+    int unused = -1;
+    int matching = -1;
+    for (Uint32 t = 0; t < graph->num_textures; t++) {
+        const GraphTexture *texture = &graph->textures[t];
+        if (texture->last_frame == graph->frame) {
+            if (texture->busy_until < first_group && IsCompatibleTexture(&texture->desc, desc)) {
+                return (int)t;
+            }
+            continue;
+        }
+        if (matching < 0 && MatchesCreatedTexture(texture, desc)) {
+            matching = (int)t;
+        }
+        if (unused < 0 || texture->last_frame < graph->textures[unused].last_frame) {
+            unused = (int)t;
+        }
+    }
+    if (matching >= 0) {
+        return matching;
+    }
+    if (graph->num_textures < RENDER_GRAPH_MAX_TEXTURES) {
+        GraphTexture *texture = &graph->textures[graph->num_textures];
+        SDL_zerop(texture);
+        return (int)graph->num_textures++;
+    }
+    return unused;
+}
+
+static Uint64 GetTextureBytes(const RenderTextureDesc *desc)
+{
+    return (Uint64)SDL_CalculateGPUTextureFormatSize(desc->format, desc->width, desc->height, 1) << desc->sample_count;
+}
+
+static bool AliasTextures(RenderGraph *graph)
+{
+    // Transient resources in order of first use
+    int sorted[RENDER_GRAPH_MAX_RESOURCES];
+    Uint32 count = 0;
+    for (Uint32 r = 0; r < graph->num_resources; r++) {
+        const GraphResource *resource = &graph->resources[r];
+        if (resource->is_imported || resource->first_group < 0) {
+            continue;
+        }
+        Uint32 i = count++;
+        for (; i > 0 && graph->resources[sorted[i - 1]].first_group > resource->first_group; i--) {
+            sorted[i] = sorted[i - 1];
+        }
+        sorted[i] = (int)r;
+    }
+
+    for (Uint32 i = 0; i < count; i++) {
+        GraphResource *resource = &graph->resources[sorted[i]];
+        int slot = FindTextureSlot(graph, &resource->desc, resource->first_group);
+        if (slot < 0) {
+            return SDL_SetError("Render graph needs more than %d textures", RENDER_GRAPH_MAX_TEXTURES);
+        }
+        GraphTexture *texture = &graph->textures[slot];
+        if (texture->last_frame != graph->frame) {
+            texture->desc = resource->desc;
+            texture->usage = 0;
+            texture->last_frame = graph->frame;
+            graph->stats.physical_textures++;
+            graph->stats.allocated_bytes += GetTextureBytes(&resource->desc);
+        }
+        texture->busy_until = resource->last_group;
+        texture->usage |= resource->usage;
+        resource->slot = slot;
+        graph->stats.transient_textures++;
+        graph->stats.transient_bytes += GetTextureBytes(&resource->desc);
+    }
+    return true;
+}
+
+bool CompileRenderGraph(RenderGraph *graph)
+{
+    Uint64 start = SDL_GetTicksNS();
+    SDL_zero(graph->stats);
+    graph->stats.passes = graph->num_passes;
+    graph->compiled = false;
+    graph->frame++;
+
+    ResourceVersion versions[RENDER_GRAPH_MAX_RESOURCES];
+    if (!BuildDependencies(graph, versions)) {
+        return false;
+    }
+    Uint64 live = FindLivePasses(graph, versions);
+    for (Uint32 p = 0; p < graph->num_passes; p++) {
+        GraphPass *pass = &graph->passes[p];
+        pass->live = (live & PassBit((int)p)) != 0;
+        pass->order = -1;
+        pass->group = -1;
+        graph->stats.culled += pass->live ? 0 : 1;
+    }
+
+    OrderPasses(graph, live);
+    GroupPasses(graph);
+    FindLifetimes(graph);
+    ChooseStoreOps(graph);
+    if (!AliasTextures(graph)) {
+        return false;
+    }
+
+    graph->stats.groups = graph->num_groups;
+    graph->stats.compile_ms = (SDL_GetTicksNS() - start) / 1e6;
+    graph->compiled = true;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+// Creates the textures this frame assigned and releases long-unused ones.
+static bool UpdateTextures(RenderGraph *graph)
+{
+    for (Uint32 t = 0; t < graph->num_textures; t++) {
+        GraphTexture *texture = &graph->textures[t];
+        if (texture->last_frame != graph->frame) {
+            if (texture->texture != NULL && graph->frame - texture->last_frame > RENDER_GRAPH_KEEP_FRAMES) {
+                SDL_ReleaseGPUTexture(graph->gpu_device, texture->texture);
+                texture->texture = NULL;
+            }
+            continue;
+        }
+        if (MatchesCreatedTexture(texture, &texture->desc) && (texture->created.usage & texture->usage) == texture->usage) {
+            continue;
+        }
+        if (texture->texture != NULL) {
+            SDL_ReleaseGPUTexture(graph->gpu_device, texture->texture);
+        }
+        SDL_GPUTextureCreateInfo create_info = {};
+        create_info.type = SDL_GPU_TEXTURETYPE_2D;
+        create_info.format = texture->desc.format;
+        create_info.usage = texture->usage;
+        create_info.width = texture->desc.width;
+        create_info.height = texture->desc.height;
+        create_info.layer_count_or_depth = 1;
+        create_info.num_levels = 1;
+        create_info.sample_count = texture->desc.sample_count;
+        texture->texture = SDL_CreateGPUTexture(graph->gpu_device, &create_info);
+        if (texture->texture == NULL) {
+            SDL_Log("Failed to create render graph texture '%s': %s", texture->desc.name, SDL_GetError());
+            return false;
+        }
+        SDL_SetGPUTextureName(graph->gpu_device, texture->texture, texture->desc.name);
+        texture->created = create_info;
+    }
+    return true;
+}
+
+SDL_GPUTexture* GetRenderGraphTexture(const RenderGraph *graph, RenderResource resource)
+{
+    if (!IsValidResource(graph, resource)) {
+        return NULL;
+    }
+    const GraphResource *graph_resource = &graph->resources[resource];
+    if (graph_resource->is_imported) {
+        return graph_resource->imported;
+    }
+    return graph_resource->slot >= 0 ? graph->textures[graph_resource->slot].texture : NULL;
+}
+
+static bool ExecuteGroup(RenderGraph *graph, const GraphGroup *group, SDL_GPUCommandBuffer *command_buffer)
+{
+    const GraphPass *first = &graph->passes[graph->order[group->first]];
+    RenderPassContext context = {};
+    context.graph = graph;
+    context.command_buffer = command_buffer;
+    for (int i = 0; i < group->count; i++) {
+        const GraphPass *pass = &graph->passes[graph->order[group->first + i]];
+        if (pass->desc.prepare != NULL) {
+            pass->desc.prepare(&context, pass->desc.userdata);
+        }
+    }
+
+    if (first->desc.type == RENDER_PASS_COMPUTE) {
+        SDL_GPUStorageTextureReadWriteBinding bindings[RENDER_PASS_MAX_STORAGE_WRITES] = {};
+        for (Uint32 i = 0; i < first->num_storage_writes; i++) {
+            bindings[i].texture = GetRenderGraphTexture(graph, first->storage_writes[i]);
+        }
+        context.compute_pass = SDL_BeginGPUComputePass(command_buffer, bindings, first->num_storage_writes, NULL, 0);
+        if (context.compute_pass == NULL) {
+            SDL_Log("Failed to begin compute pass '%s': %s", first->desc.name, SDL_GetError());
+            return false;
+        }
+        first->desc.fn(&context, first->desc.userdata);
+        SDL_EndGPUComputePass(context.compute_pass);
+        return true;
+    }
+
+    SDL_GPUColorTargetInfo color_targets[RENDER_PASS_MAX_COLOR_TARGETS] = {};
+    for (Uint32 i = 0; i < first->num_color_targets; i++) {
+        color_targets[i].texture = GetRenderGraphTexture(graph, first->color_targets[i].resource);
+        color_targets[i].clear_color = first->color_targets[i].clear_color;
+        color_targets[i].load_op = first->color_targets[i].load_op;
+        color_targets[i].store_op = group->color_store_ops[i];
+    }
+    SDL_GPUDepthStencilTargetInfo depth_target = {};
+    if (first->depth_target.resource >= 0) {
+        depth_target.texture = GetRenderGraphTexture(graph, first->depth_target.resource);
+        depth_target.clear_depth = first->depth_target.clear_depth;
+        depth_target.load_op = first->depth_target.load_op;
+        depth_target.store_op = group->depth_store_op;
+        depth_target.stencil_load_op = SDL_GPU_LOADOP_DONT_CARE;
+        depth_target.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
+    }
+    context.render_pass = SDL_BeginGPURenderPass(command_buffer, color_targets, first->num_color_targets,
+                                                 first->depth_target.resource >= 0 ? &depth_target : NULL);
+    if (context.render_pass == NULL) {
+        SDL_Log("Failed to begin render pass '%s': %s", first->desc.name, SDL_GetError());
+        return false;
+    }
+    for (int i = 0; i < group->count; i++) {
+        const GraphPass *pass = &graph->passes[graph->order[group->first + i]];
+        pass->desc.fn(&context, pass->desc.userdata);
+    }
+    SDL_EndGPURenderPass(context.render_pass);
+    return true;
+}
+
+bool ExecuteRenderGraph(RenderGraph *graph, SDL_GPUCommandBuffer *command_buffer)
+{
+    if (!graph->compiled) {
+        return SDL_SetError("Render graph has not been compiled");
+    }
+    if (!UpdateTextures(graph)) {
+        return false;
+    }
+    for (Uint32 g = 0; g < graph->num_groups; g++) {
+        if (!ExecuteGroup(graph, &graph->groups[g], command_buffer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Queries
+// ---------------------------------------------------------------------------
+
+int GetRenderResourceSlot(const RenderGraph *graph, RenderResource resource)
+{
+    return IsValidResource(graph, resource) ? graph->resources[resource].slot : -1;
+}
+
+SDL_GPUStoreOp GetRenderTargetStoreOp(const RenderGraph *graph, int pass, RenderResource resource)
+{
+    if (!IsValidPass(graph, pass) || !graph->passes[pass].live) {
+        return SDL_GPU_STOREOP_STORE;
+    }
+    const GraphGroup *group = &graph->groups[graph->passes[pass].group];
+    const GraphPass *first = &graph->passes[graph->order[group->first]];
+    for (Uint32 i = 0; i < first->num_color_targets; i++) {
+        if (first->color_targets[i].resource == resource) {
+            return group->color_store_ops[i];
+        }
+    }
+    if (first->depth_target.resource >= 0 && first->depth_target.resource == resource) {
+        return group->depth_store_op;
+    }
+    return SDL_GPU_STOREOP_STORE;
+}
+
+RenderPassInfo GetRenderPassInfo(const RenderGraph *graph, int pass)
+{
+    RenderPassInfo info = { true, -1, -1 };
+    if (IsValidPass(graph, pass) && graph->compiled && graph->passes[pass].live) {
+        info.culled = false;
+        info.order = graph->passes[pass].order;
+        info.group = graph->passes[pass].group;
+    }
+    return info;
+}
+
+RenderGraphStats GetRenderGraphStats(const RenderGraph *graph)
+{
+    return graph->stats;
+}
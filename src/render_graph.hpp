@@ -0,0 +1,140 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Declarative frame graph. Every frame the renderer declares its passes and
+// the textures each one reads and writes; CompileRenderGraph then works out
+// the rest on the CPU:
+//
+//   - ordering: a pass runs after the passes whose output it reads, and
+//     reads and writes of a texture keep their declaration order;
+//   - culling: passes whose writes never reach an output texture, and have
+//     no side effects, are dropped;
+//   - merging: consecutive graphics passes that render into the same targets
+//     and load them share one SDL render pass;
+//   - store ops: targets nothing reads afterwards are not stored;
+//   - aliasing: transient textures whose lifetimes do not overlap share one
+//     GPU texture when their format, size and sample count match.
+//
+// SDL_gpu has no placed resources, so aliasing is texture reuse rather than
+// memory heap overlap. Compiling needs no GPU device; ExecuteRenderGraph
+// creates the textures it needs and keeps them across frames.
+
+#define RENDER_GRAPH_MAX_PASSES 64
+#define RENDER_GRAPH_MAX_RESOURCES 64
+#define RENDER_GRAPH_MAX_TEXTURES 32
+#define RENDER_PASS_MAX_COLOR_TARGETS 4
+#define RENDER_PASS_MAX_READS 8
+#define RENDER_PASS_MAX_STORAGE_WRITES 4
+
+// Index of a texture declared this frame, or -1.
+typedef int RenderResource;
+
+typedef struct RenderGraph RenderGraph;
+
+typedef enum RenderPassType
+{
+    RENDER_PASS_GRAPHICS,
+    RENDER_PASS_COMPUTE
+} RenderPassType;
+
+// Handed to a pass's callbacks. render_pass is set for graphics passes and
+// compute_pass for compute passes; prepare callbacks get neither.
+typedef struct RenderPassContext
+{
+    RenderGraph *graph;
+    SDL_GPUCommandBuffer *command_buffer;
+    SDL_GPURenderPass *render_pass;
+    SDL_GPUComputePass *compute_pass;
+} RenderPassContext;
+
+typedef void (*RenderPassFunction)(const RenderPassContext *context, void *userdata);
+
+typedef struct RenderPassDesc
+{
+    const char *name;                   // Must outlive the frame
+    RenderPassType type;
+    RenderPassFunction fn;              // Records the pass
+    RenderPassFunction prepare;         // Optional. Runs before the SDL render pass opens, e.g. for uploads
+    void *userdata;
+    bool side_effects;                  // Never culled, e.g. readbacks
+} RenderPassDesc;
+
+typedef struct RenderTextureDesc
+{
+    const char *name;                   // Must outlive the frame
+    SDL_GPUTextureFormat format;
+    Uint32 width;
+    Uint32 height;
+    SDL_GPUSampleCount sample_count;
+} RenderTextureDesc;
+
+// Where a pass landed after compiling.
+typedef struct RenderPassInfo
+{
+    bool culled;
+    int order;                          // Position in execution order, -1 if culled
+    int group;                          // SDL render or compute pass it runs in, -1 if culled
+} RenderPassInfo;
+
+typedef struct RenderGraphStats
+{
+    Uint32 passes;                      // Declared
+    Uint32 culled;
+    Uint32 groups;                      // SDL render and compute passes begun
+    Uint32 merged;                      // Passes that joined the previous pass's render pass
+    Uint32 transient_textures;          // Declared and used
+    Uint32 physical_textures;           // GPU textures backing them
+    Uint64 transient_bytes;             // Without aliasing
+    Uint64 allocated_bytes;             // With aliasing
+    Uint32 stores_skipped;              // Targets given STOREOP_DONT_CARE
+    double compile_ms;
+} RenderGraphStats;
+
+// gpu_device may be NULL to only compile, for tests and benchmarks.
+RenderGraph* CreateRenderGraph(SDL_GPUDevice *gpu_device);
+// Releases the graph's textures.
+void DestroyRenderGraph(RenderGraph *graph);
+
+// Starts a frame's declarations, forgetting the previous frame's passes and
+// resources but keeping its GPU textures for reuse.
+void ResetRenderGraph(RenderGraph *graph);
+
+// A texture that lives only within the frame. Its contents are undefined
+// until a pass clears or writes it.
+RenderResource CreateRenderTexture(RenderGraph *graph, const RenderTextureDesc *desc);
+// An existing texture, e.g. the swapchain. Its contents are defined on entry.
+RenderResource ImportRenderTexture(RenderGraph *graph, SDL_GPUTexture *texture, const RenderTextureDesc *desc);
+// Marks a texture whose final contents are needed after the frame. Passes
+// that do not contribute to an output (or have side effects) are culled.
+void SetRenderGraphOutput(RenderGraph *graph, RenderResource resource);
+
+// Returns the pass index, or -1. Declaration order is the reference order.
+int AddRenderPass(RenderGraph *graph, const RenderPassDesc *desc);
+// Graphics passes. LOADOP_LOAD reads the target as well as writing it.
+bool AddRenderPassColorTarget(RenderGraph *graph, int pass, RenderResource resource, SDL_GPULoadOp load_op, SDL_FColor clear_color);
+bool SetRenderPassDepthTarget(RenderGraph *graph, int pass, RenderResource resource, SDL_GPULoadOp load_op, float clear_depth);
+// Sampled (or storage) read by either kind of pass.
+bool AddRenderPassRead(RenderGraph *graph, int pass, RenderResource resource);
+// Compute passes: bound as a read-write storage texture. A full overwrite
+// unless the pass also reads it.
+bool AddRenderPassStorageWrite(RenderGraph *graph, int pass, RenderResource resource);
+
+// Orders, culls, merges and aliases this frame's passes. Fails on a pass that
+// reads a transient texture nothing has written yet.
+bool CompileRenderGraph(RenderGraph *graph);
+
+// Creates any missing textures and records every live pass into
+// command_buffer. Main thread, outside any render or copy pass.
+bool ExecuteRenderGraph(RenderGraph *graph, SDL_GPUCommandBuffer *command_buffer);
+
+// The GPU texture behind a resource, valid from ExecuteRenderGraph until the
+// next reset. NULL before then for transient textures.
+SDL_GPUTexture* GetRenderGraphTexture(const RenderGraph *graph, RenderResource resource);
+// Index of the physical texture a transient resource was aliased to, -1 for
+// imported or unused ones. Equal slots share memory.
+int GetRenderResourceSlot(const RenderGraph *graph, RenderResource resource);
+// The store op a pass's target got, for the pass that ends its render pass.
+SDL_GPUStoreOp GetRenderTargetStoreOp(const RenderGraph *graph, int pass, RenderResource resource);
+RenderPassInfo GetRenderPassInfo(const RenderGraph *graph, int pass);
+RenderGraphStats GetRenderGraphStats(const RenderGraph *graph);
@@ -0,0 +1,499 @@
+#include <SDL3/SDL.h>
+#include <render_queue.hpp>
+
+#define RENDER_BUCKET_INITIAL_PACKETS 256
+#define RENDER_BUCKET_INITIAL_UNIFORM_BYTES 4096
+// Sorted entries refer to packets as bucket << RENDER_REF_INDEX_BITS | index
+#define RENDER_REF_INDEX_BITS 26
+#define RENDER_REF_INDEX_MASK ((1u << RENDER_REF_INDEX_BITS) - 1)
+// Sorted packets are scattered across the buckets; replay fetches this far ahead
+#define RENDER_REPLAY_PREFETCH 8
+
+typedef struct StoredPacket
+{
+    DrawPacket packet;
+    Uint32 vertex_uniforms_offset;
+    Uint32 vertex_uniforms_size;
+    Uint32 fragment_uniforms_offset;
+    Uint32 fragment_uniforms_size;
+} StoredPacket;
+
+struct RenderBucket
+{
+    StoredPacket *packets;
+    Uint32 count;
+    Uint32 capacity;
+    Uint8 *uniforms;                // Uniform data of every packet, back to back
+    Uint32 uniforms_size;
+    Uint32 uniforms_capacity;
+};
+
+struct RenderQueue
+{
+    RenderBucket buckets[RENDER_QUEUE_MAX_BUCKETS];
+    SDL_AtomicInt num_buckets;      // Acquired this frame; may overshoot the maximum
+
+    // Merged and sorted by SortRenderQueue
+    Uint64 *keys;
+    Uint32 *refs;
+    Uint64 *temp_keys;
+    Uint32 *temp_refs;
+    Uint32 sorted_count;
+    Uint32 sort_capacity;
+
+    RenderQueueStats stats;
+};
+
+Uint32 QuantizeSortDepth(float view_depth, float near_plane, float far_plane, bool back_to_front)
+{
+    float t = (view_depth - near_plane) / (far_plane - near_plane);
+    t = SDL_clamp(t, 0.0f, 1.0f);
+    Uint32 depth = (Uint32)(t * 65535.0f + 0.5f);
+    return back_to_front ? 65535 - depth : depth;
+}
+
+RenderQueue* CreateRenderQueue()
+{
+    return static_cast<RenderQueue*>(SDL_calloc(1, sizeof(RenderQueue)));
+}
+
+void DestroyRenderQueue(RenderQueue *queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    for (RenderBucket &bucket : queue->buckets) {
+        SDL_free(bucket.packets);
+        SDL_free(bucket.uniforms);
+    }
+    SDL_free(queue->keys);
+    SDL_free(queue->refs);
+    SDL_free(queue->temp_keys);
+    SDL_free(queue->temp_refs);
+    SDL_free(queue);
+}
+
+static Uint32 GetAcquiredBucketCount(const RenderQueue *queue)
+{
+    return (Uint32)SDL_min(SDL_GetAtomicInt(const_cast<SDL_AtomicInt*>(&queue->num_buckets)), RENDER_QUEUE_MAX_BUCKETS);
+}
+
+void ResetRenderQueue(RenderQueue *queue)
+{
+    Uint32 num_buckets = GetAcquiredBucketCount(queue);
+    for (Uint32 i = 0; i < num_buckets; i++) {
+        queue->buckets[i].count = 0;
+        queue->buckets[i].uniforms_size = 0;
+    }
+    SDL_SetAtomicInt(&queue->num_buckets, 0);
+    queue->sorted_count = 0;
+    SDL_zero(queue->stats);
+}
+
+RenderBucket* AcquireRenderBucket(RenderQueue *queue)
+{
+    int index = SDL_AddAtomicInt(&queue->num_buckets, 1);
+    if (index >= RENDER_QUEUE_MAX_BUCKETS) {
+        SDL_SetError("Too many render buckets this frame (max %d)", RENDER_QUEUE_MAX_BUCKETS);
+        return NULL;
+    }
+    return &queue->buckets[index];
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RENDER_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define RENDER_PREFETCH(address)
+#endif
+
+// ---------------------------------------------------------------------------
+// Submission
+// ---------------------------------------------------------------------------
+
+static bool CopyUniforms(RenderBucket *bucket, const void *data, Uint32 size, Uint32 *offset)
+{
+    *offset = bucket->uniforms_size;
+    if (size == 0) {
+        return true;
+    }
+    if (bucket->uniforms_size + size > bucket->uniforms_capacity) {
+        Uint32 capacity = SDL_max(bucket->uniforms_capacity * 2, (Uint32)RENDER_BUCKET_INITIAL_UNIFORM_BYTES);
+        capacity = SDL_max(capacity, bucket->uniforms_size + size);
+        Uint8 *uniforms = static_cast<Uint8*>(SDL_realloc(bucket->uniforms, capacity));
+        if (uniforms == NULL) {
+            return false;
+        }
+        bucket->uniforms = uniforms;
+        bucket->uniforms_capacity = capacity;
+    }
+    SDL_memcpy(bucket->uniforms + bucket->uniforms_size, data, size);
+    bucket->uniforms_size += size;
+    return true;
+}
+
+bool SubmitDrawPacket(RenderBucket *bucket, const DrawPacket *packet,
+                      const void *vertex_uniforms, Uint32 vertex_uniforms_size,
+                      const void *fragment_uniforms, Uint32 fragment_uniforms_size)
+{
+    if (packet->num_fragment_samplers > RENDER_PACKET_MAX_SAMPLERS ||
+        packet->num_vertex_storage_buffers > RENDER_PACKET_MAX_STORAGE_BUFFERS) {
+        return SDL_SetError("Draw packet has too many samplers or storage buffers (max %d, %d)",
+                            RENDER_PACKET_MAX_SAMPLERS, RENDER_PACKET_MAX_STORAGE_BUFFERS);
+    }
+    if (bucket->count == bucket->capacity) {
+        if (bucket->capacity > RENDER_REF_INDEX_MASK) {
+            return SDL_SetError("Render bucket is full");
+        }
+        Uint32 capacity = SDL_max(bucket->capacity * 2, (Uint32)RENDER_BUCKET_INITIAL_PACKETS);
+        StoredPacket *packets = static_cast<StoredPacket*>(SDL_realloc(bucket->packets, capacity * sizeof(StoredPacket)));
+        if (packets == NULL) {
+            return false;
+        }
+        bucket->packets = packets;
+        bucket->capacity = capacity;
+    }
+
+    StoredPacket *stored = &bucket->packets[bucket->count];
+    Uint32 uniforms_size = bucket->uniforms_size;
+    if (!CopyUniforms(bucket, vertex_uniforms, vertex_uniforms_size, &stored->vertex_uniforms_offset) ||
+        !CopyUniforms(bucket, fragment_uniforms, fragment_uniforms_size, &stored->fragment_uniforms_offset)) {
+        bucket->uniforms_size = uniforms_size;
+        return false;
+    }
+    stored->packet = *packet;
+    stored->vertex_uniforms_size = vertex_uniforms_size;
+    stored->fragment_uniforms_size = fragment_uniforms_size;
+    bucket->count++;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Sorting
+// ---------------------------------------------------------------------------
+
+void RadixSortKeys(Uint64 *keys, Uint32 *values, Uint64 *temp_keys, Uint32 *temp_values, Uint32 count)
+{
+    if (count < 2) {
+        return;
+    }
+
+    // Every digit's histogram in one pass over the keys
+    Uint32 histograms[8][256];
+    SDL_zero(histograms);
+    for (Uint32 i = 0; i < count; i++) {
+        Uint64 key = keys[i];
+        for (int digit = 0; digit < 8; digit++) {
+            histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+        }
+    }
+
+    Uint64 *source_keys = keys, *dest_keys = temp_keys;
+    Uint32 *source_values = values, *dest_values = temp_values;
+    for (int digit = 0; digit < 8; digit++) {
+        int shift = digit * 8;
+        Uint32 *histogram = histograms[digit];
+        // A digit all keys share would leave the order unchanged
+        if (histogram[(keys[0] >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        Uint32 offsets[256];
+        Uint32 sum = 0;
+        for (int i = 0; i < 256; i++) {
+            offsets[i] = sum;
+            sum += histogram[i];
+        }
+        for (Uint32 i = 0; i < count; i++) {
+            Uint32 slot = offsets[(source_keys[i] >> shift) & 0xFF]++;
+            dest_keys[slot] = source_keys[i];
+            dest_values[slot] = source_values[i];
+        }
+        Uint64 *swap_keys = source_keys;
+        source_keys = dest_keys;
+        dest_keys = swap_keys;
+        Uint32 *swap_values = source_values;
+        source_values = dest_values;
+        dest_values = swap_values;
+    }
+
+    if (source_keys != keys) {
+        SDL_memcpy(keys, source_keys, count * sizeof(Uint64));
+        SDL_memcpy(values, source_values, count * sizeof(Uint32));
+    }
+}
+
+static bool ReserveSortArrays(RenderQueue *queue, Uint32 count)
+{
+    if (count <= queue->sort_capacity) {
+        return true;
+    }
+    Uint32 capacity = SDL_max(count, queue->sort_capacity * 2);
+    Uint64 *keys = static_cast<Uint64*>(SDL_realloc(queue->keys, capacity * sizeof(Uint64)));
+    if (keys != NULL) {
+        queue->keys = keys;
+    }
+    Uint32 *refs = static_cast<Uint32*>(SDL_realloc(queue->refs, capacity * sizeof(Uint32)));
+    if (refs != NULL) {
+        queue->refs = refs;
+    }
+    Uint64 *temp_keys = static_cast<Uint64*>(SDL_realloc(queue->temp_keys, capacity * sizeof(Uint64)));
+    if (temp_keys != NULL) {
+        queue->temp_keys = temp_keys;
+    }
+    Uint32 *temp_refs = static_cast<Uint32*>(SDL_realloc(queue->temp_refs, capacity * sizeof(Uint32)));
+    if (temp_refs != NULL) {
+        queue->temp_refs = temp_refs;
+    }
+    if (keys == NULL || refs == NULL || temp_keys == NULL || temp_refs == NULL) {
+        return false;
+    }
+    queue->sort_capacity = capacity;
+    return true;
+}
+
+void SortRenderQueue(RenderQueue *queue)
+{
+    Uint64 start = SDL_GetTicksNS();
+    Uint32 num_buckets = GetAcquiredBucketCount(queue);
+    Uint32 total = 0;
+    for (Uint32 i = 0; i < num_buckets; i++) {
+        total += queue->buckets[i].count;
+    }
+    if (!ReserveSortArrays(queue, total)) {
+        SDL_Log("Render queue: out of memory sorting %u packets", total);
+        queue->sorted_count = 0;
+        return;
+    }
+
+    // Bucket order breaks ties between equal keys
+    Uint32 count = 0;
+    for (Uint32 b = 0; b < num_buckets; b++) {
+        const RenderBucket *bucket = &queue->buckets[b];
+        for (Uint32 i = 0; i < bucket->count; i++) {
+            queue->keys[count] = bucket->packets[i].packet.sort_key;
+            queue->refs[count] = b << RENDER_REF_INDEX_BITS | i;
+            count++;
+        }
+    }
+    RadixSortKeys(queue->keys, queue->refs, queue->temp_keys, queue->temp_refs, count);
+    queue->sorted_count = count;
+
+    queue->stats.packets = count;
+    queue->stats.buckets = num_buckets;
+    queue->stats.sort_ms += (SDL_GetTicksNS() - start) / 1e6;
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+typedef struct BindState
+{
+    SDL_GPUGraphicsPipeline *pipeline;
+    SDL_GPUBufferBinding vertex_buffer;
+    SDL_GPUBufferBinding index_buffer;
+    SDL_GPUIndexElementSize index_element_size;
+    SDL_GPUBuffer *storage_buffers[RENDER_PACKET_MAX_STORAGE_BUFFERS];
+    Uint32 num_storage_buffers;
+    SDL_GPUTextureSamplerBinding samplers[RENDER_PACKET_MAX_SAMPLERS];
+    Uint32 num_samplers;
+    const Uint8 *vertex_uniforms;
+    Uint32 vertex_uniforms_size;
+    const Uint8 *fragment_uniforms;
+    Uint32 fragment_uniforms_size;
+} BindState;
+
+static bool SameBinding(const SDL_GPUBufferBinding *a, const SDL_GPUBufferBinding *b)
+{
+    return a->buffer == b->buffer && a->offset == b->offset;
+}
+
+static bool SameStorageBuffers(const BindState *state, const DrawPacket *packet)
+{
+    if (packet->num_vertex_storage_buffers > state->num_storage_buffers) {
+        return false;
+    }
+    for (Uint32 i = 0; i < packet->num_vertex_storage_buffers; i++) {
+        if (packet->vertex_storage_buffers[i] != state->storage_buffers[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SameSamplers(const BindState *state, const DrawPacket *packet)
+{
+    if (packet->num_fragment_samplers > state->num_samplers) {
+        return false;
+    }
+    for (Uint32 i = 0; i < packet->num_fragment_samplers; i++) {
+        if (packet->fragment_samplers[i].texture != state->samplers[i].texture ||
+            packet->fragment_samplers[i].sampler != state->samplers[i].sampler) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compares by content: packets rebuilt every frame rarely share a pointer.
+static bool SameUniforms(const Uint8 *bound, Uint32 bound_size, const Uint8 *data, Uint32 size)
+{
+    return bound != NULL && bound_size == size && SDL_memcmp(bound, data, size) == 0;
+}
+
+static const StoredPacket* GetSortedPacket(const RenderQueue *queue, Uint32 i, const RenderBucket **bucket)
+{
+    Uint32 ref = queue->refs[i];
+    *bucket = &queue->buckets[ref >> RENDER_REF_INDEX_BITS];
+    return &(*bucket)->packets[ref & RENDER_REF_INDEX_MASK];
+}
+
+static Uint32 FindFirstLayer(const RenderQueue *queue, Uint32 layer)
+{
+    Uint32 low = 0, high = queue->sorted_count;
+    while (low < high) {
+        Uint32 mid = low + (high - low) / 2;
+        if (GetSortKeyLayer(queue->keys[mid]) < layer) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void ExecuteRenderQueue(RenderQueue *queue, SDL_GPUCommandBuffer *command_buffer, SDL_GPURenderPass *render_pass,
+                        Uint32 first_layer, Uint32 last_layer)
+{
+    Uint64 start = SDL_GetTicksNS();
+    RenderQueueStats *stats = &queue->stats;
+    BindState state;
+    SDL_zero(state);
+
+    for (Uint32 i = FindFirstLayer(queue, first_layer); i < queue->sorted_count; i++) {
+        if (GetSortKeyLayer(queue->keys[i]) > last_layer) {
+            break;
+        }
+        if (i + RENDER_REPLAY_PREFETCH < queue->sorted_count) {
+            const RenderBucket *ahead_bucket;
+            const StoredPacket *ahead = GetSortedPacket(queue, i + RENDER_REPLAY_PREFETCH, &ahead_bucket);
+            RENDER_PREFETCH(ahead);
+            RENDER_PREFETCH(reinterpret_cast<const Uint8*>(ahead) + 64);
+            RENDER_PREFETCH(reinterpret_cast<const Uint8*>(ahead) + 128);
+            RENDER_PREFETCH(ahead_bucket->uniforms + ahead->vertex_uniforms_offset);
+        }
+        const RenderBucket *bucket;
+        const StoredPacket *stored = GetSortedPacket(queue, i, &bucket);
+        const DrawPacket *packet = &stored->packet;
+        if (packet->pipeline == NULL) {
+            continue;
+        }
+
+        if (packet->pipeline != state.pipeline) {
+            if (render_pass != NULL) {
+                SDL_BindGPUGraphicsPipeline(render_pass, packet->pipeline);
+            }
+            state.pipeline = packet->pipeline;
+            stats->pipeline_binds++;
+        } else {
+            stats->pipeline_binds_skipped++;
+        }
+
+        if (packet->vertex_buffer.buffer != NULL) {
+            if (!SameBinding(&packet->vertex_buffer, &state.vertex_buffer)) {
+                if (render_pass != NULL) {
+                    SDL_BindGPUVertexBuffers(render_pass, 0, &packet->vertex_buffer, 1);
+                }
+                state.vertex_buffer = packet->vertex_buffer;
+                stats->buffer_binds++;
+            } else {
+                stats->buffer_binds_skipped++;
+            }
+        }
+
+        bool indexed = packet->index_buffer.buffer != NULL;
+        if (indexed) {
+            if (!SameBinding(&packet->index_buffer, &state.index_buffer) ||
+                packet->index_element_size != state.index_element_size) {
+                if (render_pass != NULL) {
+                    SDL_BindGPUIndexBuffer(render_pass, &packet->index_buffer, packet->index_element_size);
+                }
+                state.index_buffer = packet->index_buffer;
+                state.index_element_size = packet->index_element_size;
+                stats->buffer_binds++;
+            } else {
+                stats->buffer_binds_skipped++;
+            }
+        }
+
+        if (packet->num_vertex_storage_buffers > 0) {
+            if (!SameStorageBuffers(&state, packet)) {
+                if (render_pass != NULL) {
+                    SDL_BindGPUVertexStorageBuffers(render_pass, 0, packet->vertex_storage_buffers, packet->num_vertex_storage_buffers);
+                }
+                SDL_memcpy(state.storage_buffers, packet->vertex_storage_buffers, packet->num_vertex_storage_buffers * sizeof(SDL_GPUBuffer*));
+                state.num_storage_buffers = SDL_max(state.num_storage_buffers, packet->num_vertex_storage_buffers);
+                stats->buffer_binds++;
+            } else {
+                stats->buffer_binds_skipped++;
+            }
+        }
+
+        if (packet->num_fragment_samplers > 0) {
+            if (!SameSamplers(&state, packet)) {
+                if (render_pass != NULL) {
+                    SDL_BindGPUFragmentSamplers(render_pass, 0, packet->fragment_samplers, packet->num_fragment_samplers);
+                }
+                SDL_memcpy(state.samplers, packet->fragment_samplers, packet->num_fragment_samplers * sizeof(SDL_GPUTextureSamplerBinding));
+                state.num_samplers = SDL_max(state.num_samplers, packet->num_fragment_samplers);
+                stats->sampler_binds++;
+            } else {
+                stats->sampler_binds_skipped++;
+            }
+        }
+
+        if (stored->vertex_uniforms_size > 0) {
+            const Uint8 *data = bucket->uniforms + stored->vertex_uniforms_offset;
+            if (!SameUniforms(state.vertex_uniforms, state.vertex_uniforms_size, data, stored->vertex_uniforms_size)) {
+                if (render_pass != NULL) {
+                    SDL_PushGPUVertexUniformData(command_buffer, 0, data, stored->vertex_uniforms_size);
+                }
+                state.vertex_uniforms = data;
+                state.vertex_uniforms_size = stored->vertex_uniforms_size;
+                stats->uniform_pushes++;
+            } else {
+                stats->uniform_pushes_skipped++;
+            }
+        }
+        if (stored->fragment_uniforms_size > 0) {
+            const Uint8 *data = bucket->uniforms + stored->fragment_uniforms_offset;
+            if (!SameUniforms(state.fragment_uniforms, state.fragment_uniforms_size, data, stored->fragment_uniforms_size)) {
+                if (render_pass != NULL) {
+                    SDL_PushGPUFragmentUniformData(command_buffer, 0, data, stored->fragment_uniforms_size);
+                }
+                state.fragment_uniforms = data;
+                state.fragment_uniforms_size = stored->fragment_uniforms_size;
+                stats->uniform_pushes++;
+            } else {
+                stats->uniform_pushes_skipped++;
+            }
+        }
+
+        if (render_pass != NULL) {
+            if (indexed) {
+                SDL_DrawGPUIndexedPrimitives(render_pass, packet->num_elements, packet->num_instances,
+                                             packet->first_element, packet->vertex_offset, packet->first_instance);
+            } else {
+                SDL_DrawGPUPrimitives(render_pass, packet->num_elements, packet->num_instances,
+                                      packet->first_element, packet->first_instance);
+            }
+        }
+        stats->draws++;
+    }
+    stats->execute_ms += (SDL_GetTicksNS() - start) / 1e6;
+}
+
+RenderQueueStats GetRenderQueueStats(const RenderQueue *queue)
+{
+    return queue->stats;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Deferred draw submission. Systems describe each draw as a small packet with
+// a 64-bit sort key; at the end of the frame the packets are radix-sorted by
+// key and replayed into a render pass, skipping pipeline, buffer, sampler and
+// uniform binds that match what is already bound.
+//
+// Submission is lock-free: every submitting thread (or job) takes its own
+// bucket with one atomic increment and appends to it without synchronisation.
+// The buckets are merged when the queue is sorted.
+
+#define RENDER_QUEUE_MAX_BUCKETS 64
+#define RENDER_PACKET_MAX_SAMPLERS 4
+#define RENDER_PACKET_MAX_STORAGE_BUFFERS 2
+
+// Sort key, most significant first:
+//   layer:8 | pipeline:12 | material:16 | depth:16 | texture:12
+// Opaque layers group by state and draw front to back within a material.
+// Translucent layers need strict back-to-front order, so their key moves the
+// depth up to just below the layer:
+//   layer:8 | depth:16 | pipeline:12 | material:16 | texture:12
+#define RENDER_KEY_LAYER_BITS 8
+#define RENDER_KEY_PIPELINE_BITS 12
+#define RENDER_KEY_MATERIAL_BITS 16
+#define RENDER_KEY_DEPTH_BITS 16
+#define RENDER_KEY_TEXTURE_BITS 12
+
+static inline Uint64 RenderKeyField(Uint32 value, int bits, int shift)
+{
+    return (Uint64)(value & ((1u << bits) - 1)) << shift;
+}
+
+static inline Uint64 MakeOpaqueSortKey(Uint32 layer, Uint32 pipeline, Uint32 material, Uint32 depth, Uint32 texture)
+{
+    return RenderKeyField(layer, RENDER_KEY_LAYER_BITS, 56) |
+           RenderKeyField(pipeline, RENDER_KEY_PIPELINE_BITS, 44) |
+           RenderKeyField(material, RENDER_KEY_MATERIAL_BITS, 28) |
+           RenderKeyField(depth, RENDER_KEY_DEPTH_BITS, 12) |
+           RenderKeyField(texture, RENDER_KEY_TEXTURE_BITS, 0);
+}
+
+static inline Uint64 MakeTranslucentSortKey(Uint32 layer, Uint32 pipeline, Uint32 material, Uint32 depth, Uint32 texture)
+{
+    return RenderKeyField(layer, RENDER_KEY_LAYER_BITS, 56) |
+           RenderKeyField(depth, RENDER_KEY_DEPTH_BITS, 40) |
+           RenderKeyField(pipeline, RENDER_KEY_PIPELINE_BITS, 28) |
+           RenderKeyField(material, RENDER_KEY_MATERIAL_BITS, 12) |
+           RenderKeyField(texture, RENDER_KEY_TEXTURE_BITS, 0);
+}
+
+static inline Uint32 GetSortKeyLayer(Uint64 key)
+{
+    return (Uint32)(key >> 56);
+}
+
+// View depth between near_plane and far_plane as a 16-bit key field, clamped.
+// back_to_front inverts it so the farthest draws sort first.
+Uint32 QuantizeSortDepth(float view_depth, float near_plane, float far_plane, bool back_to_front);
+
+typedef struct DrawPacket
+{
+    Uint64 sort_key;
+    SDL_GPUGraphicsPipeline *pipeline;
+    SDL_GPUBufferBinding vertex_buffer;         // buffer NULL binds nothing
+    SDL_GPUBufferBinding index_buffer;          // buffer NULL draws non-indexed
+    SDL_GPUIndexElementSize index_element_size;
+    SDL_GPUBuffer *vertex_storage_buffers[RENDER_PACKET_MAX_STORAGE_BUFFERS];   // Instance or sprite data
+    Uint32 num_vertex_storage_buffers;
+    SDL_GPUTextureSamplerBinding fragment_samplers[RENDER_PACKET_MAX_SAMPLERS];
+    Uint32 num_fragment_samplers;
+    Uint32 num_elements;                        // Vertices, or indices when indexed
+    Uint32 num_instances;
+    Uint32 first_element;
+    Sint32 vertex_offset;                       // Indexed draws only
+    Uint32 first_instance;
+} DrawPacket;
+
+// Counts for the current frame, reset by ResetRenderQueue.
+typedef struct RenderQueueStats
+{
+    Uint32 packets;
+    Uint32 buckets;
+    Uint32 draws;
+    Uint32 pipeline_binds;
+    Uint32 pipeline_binds_skipped;
+    Uint32 buffer_binds;            // Vertex, index and vertex storage
+    Uint32 buffer_binds_skipped;
+    Uint32 sampler_binds;
+    Uint32 sampler_binds_skipped;
+    Uint32 uniform_pushes;
+    Uint32 uniform_pushes_skipped;
+    double sort_ms;
+    double execute_ms;
+} RenderQueueStats;
+
+typedef struct RenderQueue RenderQueue;
+typedef struct RenderBucket RenderBucket;
+
+RenderQueue* CreateRenderQueue();
+void DestroyRenderQueue(RenderQueue *queue);
+
+// Starts a frame: empties every bucket, keeping their memory. No submitter may
+// be running.
+void ResetRenderQueue(RenderQueue *queue);
+
+// Any thread. The bucket belongs to the caller until the next reset and must
+// only be submitted to from one thread at a time. NULL once all
+// RENDER_QUEUE_MAX_BUCKETS are taken this frame.
+RenderBucket* AcquireRenderBucket(RenderQueue *queue);
+
+// Copies the packet and its slot 0 uniform data (either may be NULL/0). The
+// uniforms are pushed before the draw unless they match the last push.
+bool SubmitDrawPacket(RenderBucket *bucket, const DrawPacket *packet,
+                      const void *vertex_uniforms, Uint32 vertex_uniforms_size,
+                      const void *fragment_uniforms, Uint32 fragment_uniforms_size);
+
+// Merges the buckets and sorts every packet by key. Once all submitters are done.
+void SortRenderQueue(RenderQueue *queue);
+
+// Replays the sorted packets whose layer is in [first_layer, last_layer] into
+// render_pass. Bind state starts empty, as it does in a new render pass.
+// A NULL render_pass only counts binds and draws, for headless benchmarks.
+void ExecuteRenderQueue(RenderQueue *queue, SDL_GPUCommandBuffer *command_buffer, SDL_GPURenderPass *render_pass,
+                        Uint32 first_layer, Uint32 last_layer);
+
+RenderQueueStats GetRenderQueueStats(const RenderQueue *queue);
+
+// Sorts count 64-bit keys, carrying values along, with a stable 8-bit LSD
+// radix sort. Digits every key shares are skipped. temp_keys/temp_values
+// need room for count entries; the result ends up in keys/values.
+void RadixSortKeys(Uint64 *keys, Uint32 *values, Uint64 *temp_keys, Uint32 *temp_values, Uint32 count);
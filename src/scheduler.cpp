@@ -0,0 +1,299 @@
+#include <SDL3/SDL.h>
+#include <scheduler.hpp>
+#include <profiler.hpp>
+
+#define SYSTEM_NAME_LENGTH 64
+#define SYSTEM_TIMING_SMOOTHING 0.05    // Weight of the newest frame in average_ms
+
+typedef struct System
+{
+    char name[SYSTEM_NAME_LENGTH];
+    SystemFunction fn;
+    void *userdata;
+    ComponentID reads[SYSTEM_MAX_COMPONENTS];
+    Uint32 num_reads;
+    ComponentID writes[SYSTEM_MAX_COMPONENTS];
+    Uint32 num_writes;
+    bool enabled;
+
+    // Rebuilt every frame
+    Uint64 successors;              // Bit per system that waits for this one
+    SDL_AtomicInt remaining;        // Predecessors still running
+    SDL_AtomicInt chunks;
+    SystemStats stats;
+} System;
+
+struct SystemContext
+{
+    SystemScheduler *scheduler;
+    System *system;
+};
+
+struct SystemScheduler
+{
+    JobSystem *jobs;
+    System systems[SCHEDULER_MAX_SYSTEMS];
+    SystemContext contexts[SCHEDULER_MAX_SYSTEMS];
+    Uint32 num_systems;
+
+    // Current frame
+    entt::registry *registry;
+    bool serial;
+    JobCounter frame_counter;
+
+    SchedulerStats stats;
+};
+
+static bool ContainsComponent(const ComponentID *components, Uint32 count, ComponentID component)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        if (components[i] == component) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Two systems conflict if either writes something the other reads or writes.
+static bool SystemsConflict(const System *a, const System *b)
+{
+    for (Uint32 i = 0; i < a->num_writes; i++) {
+        if (ContainsComponent(b->reads, b->num_reads, a->writes[i]) ||
+            ContainsComponent(b->writes, b->num_writes, a->writes[i])) {
+            return true;
+        }
+    }
+    for (Uint32 i = 0; i < b->num_writes; i++) {
+        if (ContainsComponent(a->reads, a->num_reads, b->writes[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SystemScheduler* CreateSystemScheduler(JobSystem *jobs)
+{
+    SystemScheduler *scheduler = static_cast<SystemScheduler*>(SDL_calloc(1, sizeof(SystemScheduler)));
+    if (scheduler == NULL) {
+        return NULL;
+    }
+    scheduler->jobs = jobs;
+    return scheduler;
+}
+
+void DestroySystemScheduler(SystemScheduler *scheduler)
+{
+    SDL_free(scheduler);
+}
+
+int AddSystem(SystemScheduler *scheduler, const SystemDesc *desc)
+{
+    if (scheduler->num_systems == SCHEDULER_MAX_SYSTEMS) {
+        SDL_SetError("Too many systems (max %d)", SCHEDULER_MAX_SYSTEMS);
+        return -1;
+    }
+    if (desc->num_reads > SYSTEM_MAX_COMPONENTS || desc->num_writes > SYSTEM_MAX_COMPONENTS) {
+        SDL_SetError("System %s touches too many components (max %d each)", desc->name, SYSTEM_MAX_COMPONENTS);
+        return -1;
+    }
+
+    int index = (int)scheduler->num_systems++;
+    System *system = &scheduler->systems[index];
+    SDL_zerop(system);
+    SDL_strlcpy(system->name, desc->name, sizeof(system->name));
+    system->fn = desc->fn;
+    system->userdata = desc->userdata;
+    for (Uint32 i = 0; i < desc->num_reads; i++) {
+        system->reads[i] = desc->reads[i];
+    }
+    system->num_reads = desc->num_reads;
+    for (Uint32 i = 0; i < desc->num_writes; i++) {
+        system->writes[i] = desc->writes[i];
+    }
+    system->num_writes = desc->num_writes;
+    system->enabled = true;
+    system->stats.name = system->name;
+
+    scheduler->contexts[index].scheduler = scheduler;
+    scheduler->contexts[index].system = system;
+    return index;
+}
+
+void SetSystemEnabled(SystemScheduler *scheduler, int system, bool enabled)
+{
+    if (system >= 0 && system < (int)scheduler->num_systems) {
+        scheduler->systems[system].enabled = enabled;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+static void ExecuteSystem(SystemContext *context)
+{
+    SystemScheduler *scheduler = context->scheduler;
+    System *system = context->system;
+
+    PROFILE_ZONE(system->name);
+    SDL_SetAtomicInt(&system->chunks, 0);
+    Uint64 start = SDL_GetTicksNS();
+    system->fn(context, *scheduler->registry, system->userdata);
+    double elapsed_ms = (SDL_GetTicksNS() - start) / 1e6;
+
+    SystemStats *stats = &system->stats;
+    stats->last_ms = elapsed_ms;
+    stats->average_ms = stats->average_ms == 0.0 ? elapsed_ms
+                      : stats->average_ms + (elapsed_ms - stats->average_ms) * SYSTEM_TIMING_SMOOTHING;
+    stats->max_ms = SDL_max(stats->max_ms, elapsed_ms);
+    stats->chunks_last_frame = (Uint32)SDL_GetAtomicInt(&system->chunks);
+}
+
+static void RunSystemJob(void *userdata)
+{
+    SystemContext *context = static_cast<SystemContext*>(userdata);
+    SystemScheduler *scheduler = context->scheduler;
+    ExecuteSystem(context);
+
+    // Release successors whose last predecessor this was. They are submitted
+    // before this job's own count is dropped, so the frame can't end early.
+    Uint64 successors = context->system->successors;
+    for (Uint32 next = 0; successors != 0; next++, successors >>= 1) {
+        if ((successors & 1) && SDL_AddAtomicInt(&scheduler->systems[next].remaining, -1) == 1) {
+            SubmitJob(scheduler->jobs, RunSystemJob, &scheduler->contexts[next], &scheduler->frame_counter);
+        }
+    }
+}
+
+void RunSystems(SystemScheduler *scheduler, entt::registry &registry, bool serial)
+{
+    Uint64 start = SDL_GetTicksNS();
+    scheduler->registry = &registry;
+    scheduler->serial = serial || scheduler->jobs == NULL;
+
+    // Dependency graph over the enabled systems: an edge from every earlier
+    // conflicting system. Redundant (transitive) edges are harmless.
+    Uint32 depths[SCHEDULER_MAX_SYSTEMS];
+    Uint32 critical_path = 0;
+    for (Uint32 i = 0; i < scheduler->num_systems; i++) {
+        System *system = &scheduler->systems[i];
+        system->successors = 0;
+        system->stats.num_dependencies = 0;
+        depths[i] = 0;
+        if (!system->enabled) {
+            continue;
+        }
+        for (Uint32 j = 0; j < i; j++) {
+            System *earlier = &scheduler->systems[j];
+            if (earlier->enabled && SystemsConflict(earlier, system)) {
+                earlier->successors |= (Uint64)1 << i;
+                system->stats.num_dependencies++;
+                depths[i] = SDL_max(depths[i], depths[j]);
+            }
+        }
+        depths[i]++;
+        critical_path = SDL_max(critical_path, depths[i]);
+        SDL_SetAtomicInt(&system->remaining, (int)system->stats.num_dependencies);
+    }
+
+    if (scheduler->serial) {
+        for (Uint32 i = 0; i < scheduler->num_systems; i++) {
+            if (scheduler->systems[i].enabled) {
+                ExecuteSystem(&scheduler->contexts[i]);
+            }
+        }
+    } else {
+        SDL_SetAtomicInt(&scheduler->frame_counter.pending, 0);
+        for (Uint32 i = 0; i < scheduler->num_systems; i++) {
+            System *system = &scheduler->systems[i];
+            if (system->enabled && system->stats.num_dependencies == 0) {
+                SubmitJob(scheduler->jobs, RunSystemJob, &scheduler->contexts[i], &scheduler->frame_counter);
+            }
+        }
+        WaitForCounter(scheduler->jobs, &scheduler->frame_counter);
+    }
+
+    SchedulerStats *stats = &scheduler->stats;
+    stats->num_systems = scheduler->num_systems;
+    stats->serial_ms = 0.0;
+    for (Uint32 i = 0; i < scheduler->num_systems; i++) {
+        if (scheduler->systems[i].enabled) {
+            stats->serial_ms += scheduler->systems[i].stats.last_ms;
+        }
+    }
+    stats->critical_path = critical_path;
+    stats->frame_ms = (SDL_GetTicksNS() - start) / 1e6;
+    scheduler->registry = NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Chunks
+// ---------------------------------------------------------------------------
+
+typedef struct SystemChunk
+{
+    SystemChunkFunction fn;
+    void *userdata;
+    Uint32 first;
+    Uint32 last;
+} SystemChunk;
+
+static void RunSystemChunk(void *userdata)
+{
+    SystemChunk *chunk = static_cast<SystemChunk*>(userdata);
+    chunk->fn(chunk->first, chunk->last, chunk->userdata);
+}
+
+void SystemParallelFor(SystemContext *context, Uint32 count, Uint32 chunk_size, SystemChunkFunction fn, void *userdata)
+{
+    if (count == 0) {
+        return;
+    }
+    chunk_size = SDL_max(chunk_size, 1u);
+    Uint32 num_chunks = (count + chunk_size - 1) / chunk_size;
+    SDL_AddAtomicInt(&context->system->chunks, (int)num_chunks);
+
+    SystemScheduler *scheduler = context->scheduler;
+    SystemChunk *chunks = NULL;
+    if (!scheduler->serial && num_chunks > 1) {
+        chunks = static_cast<SystemChunk*>(SDL_malloc(num_chunks * sizeof(SystemChunk)));
+    }
+    if (chunks == NULL) {
+        // Same chunk boundaries as the parallel path, one after another.
+        for (Uint32 first = 0; first < count; first += chunk_size) {
+            fn(first, SDL_min(first + chunk_size, count), userdata);
+        }
+        return;
+    }
+
+    // The calling thread takes the first chunk itself and helps with the rest while it waits.
+    JobCounter counter;
+    SDL_SetAtomicInt(&counter.pending, 0);
+    for (Uint32 i = 0; i < num_chunks; i++) {
+        chunks[i].fn = fn;
+        chunks[i].userdata = userdata;
+        chunks[i].first = i * chunk_size;
+        chunks[i].last = SDL_min(chunks[i].first + chunk_size, count);
+        if (i > 0) {
+            SubmitJob(scheduler->jobs, RunSystemChunk, &chunks[i], &counter);
+        }
+    }
+    RunSystemChunk(&chunks[0]);
+    WaitForCounter(scheduler->jobs, &counter);
+    SDL_free(chunks);
+}
+
+SystemStats GetSystemStats(const SystemScheduler *scheduler, int system)
+{
+    if (system < 0 || system >= (int)scheduler->num_systems) {
+        SystemStats stats;
+        SDL_zero(stats);
+        return stats;
+    }
+    return scheduler->systems[system].stats;
+}
+
+SchedulerStats GetSchedulerStats(const SystemScheduler *scheduler)
+{
+    return scheduler->stats;
+}
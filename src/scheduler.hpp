@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <entt/entt.hpp>
+#include <jobs.hpp>
+
+// Runs a frame's ECS systems across the job system. Each system declares the
+// components (or any other shared type, e.g. TransformHierarchy) it reads and
+// writes. Two systems conflict if either writes something the other touches;
+// conflicting systems run in registration order and everything else runs
+// concurrently, so the results match a serial run in registration order.
+// Large views are split into chunks with SystemParallelFor/ForEachChunked.
+
+#define SCHEDULER_MAX_SYSTEMS 64
+#define SYSTEM_MAX_COMPONENTS 16
+
+typedef Uint32 ComponentID;
+
+template <typename T>
+ComponentID GetComponentID()
+{
+    return (ComponentID)entt::type_hash<T>::value();
+}
+
+typedef struct SystemContext SystemContext;
+typedef void (*SystemFunction)(SystemContext *context, entt::registry &registry, void *userdata);
+// Processes [first, last) of a chunked range.
+typedef void (*SystemChunkFunction)(Uint32 first, Uint32 last, void *userdata);
+
+typedef struct SystemDesc
+{
+    const char *name;
+    SystemFunction fn;
+    void *userdata;
+    const ComponentID *reads;
+    Uint32 num_reads;
+    const ComponentID *writes;
+    Uint32 num_writes;
+} SystemDesc;
+
+typedef struct SystemStats
+{
+    const char *name;
+    double last_ms;             // Start to finish, including its chunks
+    double average_ms;          // Exponential moving average
+    double max_ms;
+    Uint32 chunks_last_frame;
+    Uint32 num_dependencies;    // Systems it waited for last frame
+} SystemStats;
+
+typedef struct SchedulerStats
+{
+    Uint32 num_systems;         // Registered, enabled or not
+    double frame_ms;            // Wall time of the last RunSystems
+    double serial_ms;           // Sum of the systems' times: the one-core cost
+    Uint32 critical_path;       // Longest dependency chain, in systems
+} SchedulerStats;
+
+typedef struct SystemScheduler SystemScheduler;
+
+// jobs may be NULL, which runs everything on the calling thread.
+SystemScheduler* CreateSystemScheduler(JobSystem *jobs);
+void DestroySystemScheduler(SystemScheduler *scheduler);
+
+// Returns the system's index, or -1. Registration order is the serial order.
+int AddSystem(SystemScheduler *scheduler, const SystemDesc *desc);
+void SetSystemEnabled(SystemScheduler *scheduler, int system, bool enabled);
+
+// Builds the dependency graph of the enabled systems and runs them, returning
+// once all have finished. serial runs them one after another in registration
+// order on the calling thread, chunks included, for reference and debugging.
+void RunSystems(SystemScheduler *scheduler, entt::registry &registry, bool serial);
+
+// Calls fn over [0, count) in chunk_size pieces, in parallel unless the frame
+// is serial. Chunks must write disjoint data. Returns when all are done.
+void SystemParallelFor(SystemContext *context, Uint32 count, Uint32 chunk_size, SystemChunkFunction fn, void *userdata);
+
+SystemStats GetSystemStats(const SystemScheduler *scheduler, int system);
+SchedulerStats GetSchedulerStats(const SystemScheduler *scheduler);
+
+// fn(entity, components&...) for every entity in registry.view<Components...>(),
+// chunk_size entities per job, walking the first component's pool.
+template <typename... Components, typename Function>
+void ForEachChunked(SystemContext *context, entt::registry &registry, Uint32 chunk_size, Function &&fn)
+{
+    auto view = registry.view<Components...>();
+    const auto *pool = view.handle();
+    if (pool == nullptr) {
+        return;
+    }
+
+    using View = decltype(view);
+    struct ChunkData
+    {
+        View *view;
+        const entt::entity *entities;
+        Function *fn;
+    } data = { &view, pool->data(), &fn };
+
+    SystemParallelFor(context, (Uint32)pool->size(), chunk_size, [](Uint32 first, Uint32 last, void *userdata) {
+        ChunkData *chunk = static_cast<ChunkData*>(userdata);
+        for (Uint32 i = first; i < last; i++) {
+            entt::entity entity = chunk->entities[i];
+            if (chunk->view->contains(entity)) {
+                (*chunk->fn)(entity, chunk->view->template get<Components>(entity)...);
+            }
+        }
+    }, &data);
+}
@@ -0,0 +1,332 @@
+#include <SDL3/SDL.h>
+#include <SDL3_shadercross/SDL_shadercross.h>
+
+#include <shader_cache.hpp>
+#include <profiler.hpp>
+
+// Bump whenever the file layout below changes; old entries then simply miss.
+#define SHADER_CACHE_MAGIC SDL_FOURCC('S', 'H', 'C', 'C')
+#define SHADER_CACHE_VERSION 2
+
+// On-disk layout, all in one file so a hit costs exactly one read:
+//   ShaderCacheHeader
+//   SDL_ShaderCross_IOVarMetadata[num_inputs + num_outputs]  (name holds an offset into the name table)
+//   name table (NUL-terminated UTF-8 strings)
+//   SPIR-V bytecode (4-byte aligned)
+typedef struct ShaderCacheHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint64 key;
+    Uint32 stage;
+    Uint32 iovar_size;         // sizeof(SDL_ShaderCross_IOVarMetadata) of the writer; differs between 32/64-bit
+    Uint32 num_samplers;
+    Uint32 num_storage_textures;       // Graphics only
+    Uint32 num_storage_buffers;        // Graphics only
+    Uint32 num_uniform_buffers;
+    Uint32 num_readonly_storage_textures;
+    Uint32 num_readonly_storage_buffers;
+    Uint32 num_readwrite_storage_textures;
+    Uint32 num_readwrite_storage_buffers;
+    Uint32 threadcount_x;
+    Uint32 threadcount_y;
+    Uint32 threadcount_z;
+    Uint32 num_inputs;
+    Uint32 num_outputs;
+    Uint32 names_size;
+    Uint32 spirv_offset;
+    Uint32 spirv_size;
+} ShaderCacheHeader;
+
+// Written once by InitializeShaderCache; loads and stores on worker threads only read it.
+static char cache_path[256] = {0};
+static SDL_AtomicInt cache_hits;
+static SDL_AtomicInt cache_misses;
+static SDL_AtomicInt cache_stores;
+static SDL_SpinLock cache_bytes_read_lock;     // SDL has no 64-bit atomics
+static Uint64 cache_bytes_read;
+
+void InitializeShaderCache(const char *cache_dir)
+{
+    if (cache_dir != NULL) {
+        SDL_snprintf(cache_path, sizeof(cache_path), "%s", cache_dir);
+    } else {
+        SDL_snprintf(cache_path, sizeof(cache_path), "%s../shader_cache/", SDL_GetBasePath());
+    }
+
+    if (!SDL_CreateDirectory(cache_path)) {
+        SDL_Log("Failed to create shader cache directory %s: %s", cache_path, SDL_GetError());
+    }
+}
+
+static Uint64 HashBytes(Uint64 hash, const void *data, size_t size)
+{
+    // 64-bit FNV-1a
+    const Uint8 *bytes = static_cast<const Uint8*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static Uint64 HashString(Uint64 hash, const char *str)
+{
+    // Hash the terminator too so "ab" + "c" never collides with "a" + "bc"
+    return str ? HashBytes(hash, str, SDL_strlen(str) + 1) : HashBytes(hash, "", 1);
+}
+
+Uint64 ShaderCacheKey(
+    const char *source,
+    size_t source_size,
+    const SDL_ShaderCross_HLSL_Define *defines,
+    SDL_ShaderCross_ShaderStage stage,
+    const char *entry_point
+) {
+    const Uint32 versions[] = {
+        SHADER_CACHE_VERSION,
+        SDL_SHADERCROSS_MAJOR_VERSION,
+        SDL_SHADERCROSS_MINOR_VERSION,
+        SDL_SHADERCROSS_MICRO_VERSION,
+        (Uint32)stage
+    };
+
+    Uint64 hash = 0xcbf29ce484222325ULL;
+    hash = HashBytes(hash, versions, sizeof(versions));
+    hash = HashString(hash, entry_point);
+    if (defines != NULL) {
+        for (const SDL_ShaderCross_HLSL_Define *define = defines; define->name != NULL; define++) {
+            hash = HashString(hash, define->name);
+            hash = HashString(hash, define->value);
+        }
+    }
+    hash = HashBytes(hash, source, source_size);
+    return hash;
+}
+
+static bool GetEntryPath(Uint64 key, char *path, size_t path_size)
+{
+    if (cache_path[0] == '\0') {
+        return false;
+    }
+    SDL_snprintf(path, path_size, "%s%016" SDL_PRIx64 ".spvcache", cache_path, key);
+    return true;
+}
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool ShaderCacheLoad(Uint64 key, ShaderCacheEntry *entry)
+{
+    PROFILE_FUNCTION();
+    SDL_zerop(entry);
+
+    char path[320];
+    size_t size;
+    Uint8 *blob = GetEntryPath(key, path, sizeof(path)) ? static_cast<Uint8*>(SDL_LoadFile(path, &size)) : NULL;
+    if (blob == NULL) {
+        SDL_AddAtomicInt(&cache_misses, 1);
+        return false;
+    }
+
+    const ShaderCacheHeader *header = reinterpret_cast<const ShaderCacheHeader*>(blob);
+    Uint32 num_iovars = 0;
+    size_t names_offset = 0;
+    bool valid = size >= sizeof(ShaderCacheHeader) &&
+                 header->magic == SHADER_CACHE_MAGIC &&
+                 header->version == SHADER_CACHE_VERSION &&
+                 header->key == key &&
+                 header->iovar_size == sizeof(SDL_ShaderCross_IOVarMetadata);
+    if (valid) {
+        // All in 64 bits: the counts come from disk and a corrupt pair must not wrap past the checks.
+        Uint64 iovars_end = sizeof(ShaderCacheHeader) +
+                            ((Uint64)header->num_inputs + header->num_outputs) * sizeof(SDL_ShaderCross_IOVarMetadata);
+        valid = iovars_end + header->names_size <= header->spirv_offset &&
+                (Uint64)header->spirv_offset + header->spirv_size <= size;
+        if (valid) {
+            num_iovars = header->num_inputs + header->num_outputs;
+            names_offset = (size_t)iovars_end;
+        }
+    }
+    if (!valid) {
+        // Stale or truncated entry; treat as a miss and let the caller overwrite it.
+        SDL_free(blob);
+        SDL_AddAtomicInt(&cache_misses, 1);
+        return false;
+    }
+
+    // Patch the name offsets into real pointers in place. A name must end inside
+    // the table; one that runs off the end is left NULL rather than read past it.
+    SDL_ShaderCross_IOVarMetadata *iovars = reinterpret_cast<SDL_ShaderCross_IOVarMetadata*>(blob + sizeof(ShaderCacheHeader));
+    char *names = reinterpret_cast<char*>(blob + names_offset);
+    for (Uint32 i = 0; i < num_iovars; i++) {
+        uintptr_t name_offset = reinterpret_cast<uintptr_t>(iovars[i].name);
+        size_t room = name_offset < header->names_size ? header->names_size - name_offset : 0;
+        bool terminated = room > 0 && SDL_strnlen(names + name_offset, room) < room;
+        iovars[i].name = terminated ? names + name_offset : NULL;
+    }
+
+    entry->blob = blob;
+    entry->spirv = blob + header->spirv_offset;
+    entry->spirv_size = header->spirv_size;
+    entry->stage = (SDL_ShaderCross_ShaderStage)header->stage;
+    entry->compute_metadata.num_samplers = header->num_samplers;
+    entry->compute_metadata.num_readonly_storage_textures = header->num_readonly_storage_textures;
+    entry->compute_metadata.num_readonly_storage_buffers = header->num_readonly_storage_buffers;
+    entry->compute_metadata.num_readwrite_storage_textures = header->num_readwrite_storage_textures;
+    entry->compute_metadata.num_readwrite_storage_buffers = header->num_readwrite_storage_buffers;
+    entry->compute_metadata.num_uniform_buffers = header->num_uniform_buffers;
+    entry->compute_metadata.threadcount_x = header->threadcount_x;
+    entry->compute_metadata.threadcount_y = header->threadcount_y;
+    entry->compute_metadata.threadcount_z = header->threadcount_z;
+    entry->graphics_metadata.num_samplers = header->num_samplers;
+    entry->graphics_metadata.num_storage_textures = header->num_storage_textures;
+    entry->graphics_metadata.num_storage_buffers = header->num_storage_buffers;
+    entry->graphics_metadata.num_uniform_buffers = header->num_uniform_buffers;
+    entry->graphics_metadata.num_inputs = header->num_inputs;
+    entry->graphics_metadata.inputs = header->num_inputs ? iovars : NULL;
+    entry->graphics_metadata.num_outputs = header->num_outputs;
+    entry->graphics_metadata.outputs = header->num_outputs ? iovars + header->num_inputs : NULL;
+
+    SDL_AddAtomicInt(&cache_hits, 1);
+    SDL_LockSpinlock(&cache_bytes_read_lock);
+    cache_bytes_read += size;
+    SDL_UnlockSpinlock(&cache_bytes_read_lock);
+    return true;
+}
+
+static bool WriteShaderCacheEntry(
+    ShaderCacheHeader *header,
+    const Uint8 *spirv,
+    size_t spirv_size,
+    const SDL_ShaderCross_GraphicsShaderMetadata *metadata
+) {
+    Uint32 num_iovars = metadata ? metadata->num_inputs + metadata->num_outputs : 0;
+    size_t names_size = 0;
+    for (Uint32 i = 0; i < num_iovars; i++) {
+        const SDL_ShaderCross_IOVarMetadata *iovar = i < metadata->num_inputs ? &metadata->inputs[i] : &metadata->outputs[i - metadata->num_inputs];
+        names_size += (iovar->name ? SDL_strlen(iovar->name) : 0) + 1;
+    }
+
+    size_t names_offset = sizeof(ShaderCacheHeader) + num_iovars * sizeof(SDL_ShaderCross_IOVarMetadata);
+    size_t spirv_offset = AlignUp(names_offset + names_size, 4);
+    size_t total_size = spirv_offset + spirv_size;
+
+    Uint8 *blob = static_cast<Uint8*>(SDL_calloc(1, total_size));
+    if (blob == NULL) {
+        return false;
+    }
+
+    header->magic = SHADER_CACHE_MAGIC;
+    header->version = SHADER_CACHE_VERSION;
+    header->iovar_size = sizeof(SDL_ShaderCross_IOVarMetadata);
+    header->num_inputs = metadata ? metadata->num_inputs : 0;
+    header->num_outputs = metadata ? metadata->num_outputs : 0;
+    header->names_size = (Uint32)names_size;
+    header->spirv_offset = (Uint32)spirv_offset;
+    header->spirv_size = (Uint32)spirv_size;
+    SDL_memcpy(blob, header, sizeof(ShaderCacheHeader));
+
+    SDL_ShaderCross_IOVarMetadata *iovars = reinterpret_cast<SDL_ShaderCross_IOVarMetadata*>(blob + sizeof(ShaderCacheHeader));
+    char *names = reinterpret_cast<char*>(blob + names_offset);
+    size_t name_offset = 0;
+    for (Uint32 i = 0; i < num_iovars; i++) {
+        const SDL_ShaderCross_IOVarMetadata *iovar = i < metadata->num_inputs ? &metadata->inputs[i] : &metadata->outputs[i - metadata->num_inputs];
+        iovars[i] = *iovar;
+        iovars[i].name = reinterpret_cast<char*>(name_offset);
+        size_t name_length = (iovar->name ? SDL_strlen(iovar->name) : 0) + 1;
+        SDL_memcpy(names + name_offset, iovar->name ? iovar->name : "", name_length);
+        name_offset += name_length;
+    }
+    SDL_memcpy(blob + spirv_offset, spirv, spirv_size);
+
+    // Write to a temporary file and rename so a concurrent reader never sees a torn entry.
+    char path[320];
+    char temp_path[336];
+    if (!GetEntryPath(header->key, path, sizeof(path))) {
+        SDL_free(blob);
+        return false;
+    }
+    SDL_snprintf(temp_path, sizeof(temp_path), "%s.%" SDL_PRIu64 ".tmp", path, (Uint64)SDL_GetCurrentThreadID());
+
+    bool stored = SDL_SaveFile(temp_path, blob, total_size) && SDL_RenamePath(temp_path, path);
+    if (!stored) {
+        SDL_Log("Failed to write shader cache entry %s: %s", path, SDL_GetError());
+        SDL_RemovePath(temp_path);
+    } else {
+        SDL_AddAtomicInt(&cache_stores, 1);
+    }
+
+    SDL_free(blob);
+    return stored;
+}
+
+bool ShaderCacheStore(
+    Uint64 key,
+    SDL_ShaderCross_ShaderStage stage,
+    const Uint8 *spirv,
+    size_t spirv_size,
+    const SDL_ShaderCross_GraphicsShaderMetadata *metadata
+) {
+    ShaderCacheHeader header;
+    SDL_zero(header);
+    header.key = key;
+    header.stage = (Uint32)stage;
+    header.num_samplers = metadata->num_samplers;
+    header.num_storage_textures = metadata->num_storage_textures;
+    header.num_storage_buffers = metadata->num_storage_buffers;
+    header.num_uniform_buffers = metadata->num_uniform_buffers;
+    return WriteShaderCacheEntry(&header, spirv, spirv_size, metadata);
+}
+
+bool ShaderCacheStoreCompute(
+    Uint64 key,
+    const Uint8 *spirv,
+    size_t spirv_size,
+    const SDL_ShaderCross_ComputePipelineMetadata *metadata
+) {
+    ShaderCacheHeader header;
+    SDL_zero(header);
+    header.key = key;
+    header.stage = (Uint32)SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
+    header.num_samplers = metadata->num_samplers;
+    header.num_uniform_buffers = metadata->num_uniform_buffers;
+    header.num_readonly_storage_textures = metadata->num_readonly_storage_textures;
+    header.num_readonly_storage_buffers = metadata->num_readonly_storage_buffers;
+    header.num_readwrite_storage_textures = metadata->num_readwrite_storage_textures;
+    header.num_readwrite_storage_buffers = metadata->num_readwrite_storage_buffers;
+    header.threadcount_x = metadata->threadcount_x;
+    header.threadcount_y = metadata->threadcount_y;
+    header.threadcount_z = metadata->threadcount_z;
+    return WriteShaderCacheEntry(&header, spirv, spirv_size, NULL);
+}
+
+void ShaderCacheReleaseEntry(ShaderCacheEntry *entry)
+{
+    SDL_free(entry->blob);
+    SDL_zerop(entry);
+}
+
+ShaderCacheStats GetShaderCacheStats()
+{
+    ShaderCacheStats stats;
+    stats.hits = (Uint32)SDL_GetAtomicInt(&cache_hits);
+    stats.misses = (Uint32)SDL_GetAtomicInt(&cache_misses);
+    stats.stores = (Uint32)SDL_GetAtomicInt(&cache_stores);
+    SDL_LockSpinlock(&cache_bytes_read_lock);
+    stats.bytes_read = cache_bytes_read;
+    SDL_UnlockSpinlock(&cache_bytes_read_lock);
+    return stats;
+}
+
+void ResetShaderCacheStats()
+{
+    SDL_SetAtomicInt(&cache_hits, 0);
+    SDL_SetAtomicInt(&cache_misses, 0);
+    SDL_SetAtomicInt(&cache_stores, 0);
+    SDL_LockSpinlock(&cache_bytes_read_lock);
+    cache_bytes_read = 0;
+    SDL_UnlockSpinlock(&cache_bytes_read_lock);
+}
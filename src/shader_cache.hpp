@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <SDL3_shadercross/SDL_shadercross.h>
+
+// Content-addressed on-disk cache for HLSL -> SPIR-V compilation results.
+// Entries are keyed on the shader source, defines, stage and entry point, and
+// store the SPIR-V together with the reflected metadata so a warm start never
+// has to run DXC or SPIRV-Cross reflection.
+
+typedef struct ShaderCacheStats
+{
+    Uint32 hits;
+    Uint32 misses;
+    Uint32 stores;
+    Uint64 bytes_read;
+} ShaderCacheStats;
+
+typedef struct ShaderCacheEntry
+{
+    void *blob;                // The single SDL_LoadFile allocation; everything below points into it
+    const Uint8 *spirv;
+    size_t spirv_size;
+    SDL_ShaderCross_ShaderStage stage;
+    SDL_ShaderCross_GraphicsShaderMetadata graphics_metadata;   // Vertex and fragment entries
+    SDL_ShaderCross_ComputePipelineMetadata compute_metadata;   // Compute entries
+} ShaderCacheEntry;
+
+// Passing NULL uses "<base path>../shader_cache/", next to the assets folder.
+// Call once on the main thread before any load or store; until then every
+// load misses and nothing is stored.
+void InitializeShaderCache(const char *cache_dir);
+
+Uint64 ShaderCacheKey(
+    const char *source,
+    size_t source_size,
+    const SDL_ShaderCross_HLSL_Define *defines,
+    SDL_ShaderCross_ShaderStage stage,
+    const char *entry_point
+);
+
+bool ShaderCacheLoad(Uint64 key, ShaderCacheEntry *entry);
+
+bool ShaderCacheStore(
+    Uint64 key,
+    SDL_ShaderCross_ShaderStage stage,
+    const Uint8 *spirv,
+    size_t spirv_size,
+    const SDL_ShaderCross_GraphicsShaderMetadata *metadata
+);
+
+bool ShaderCacheStoreCompute(
+    Uint64 key,
+    const Uint8 *spirv,
+    size_t spirv_size,
+    const SDL_ShaderCross_ComputePipelineMetadata *metadata
+);
+
+void ShaderCacheReleaseEntry(ShaderCacheEntry *entry);
+
+ShaderCacheStats GetShaderCacheStats();
+void ResetShaderCacheStats();
@@ -0,0 +1,483 @@
+#include <SDL3/SDL.h>
+#include <graphics.hpp>
+#include <profiler.hpp>
+#include <shader_registry.hpp>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#define MAX_REGISTERED_PIPELINES 64
+#define MAX_WATCHED_DIRECTORIES 64
+
+// Editors tend to save in several writes (truncate, write, rename); wait for
+// the burst to settle before compiling so we don't build a half-written file.
+#define SHADER_RELOAD_SETTLE_MS 50
+#define SHADER_POLL_INTERVAL_MS 250
+
+typedef struct RegisteredPipeline
+{
+    char vertex_shader[128];
+    char fragment_shader[128];
+    char vertex_source[256];        // Full paths of the .hlsl files
+    char fragment_source[256];
+    SDL_Time vertex_modify_time;    // Only used when polling
+    SDL_Time fragment_modify_time;
+
+    SDL_GPUGraphicsPipelineCreateInfo create_info;  // Arrays point into description_storage
+    void *description_storage;
+
+    SDL_GPUGraphicsPipeline *pipeline;  // Main thread only
+    bool owns_pipeline;                 // False while pipeline is the caller's shared one
+    void *pending;                      // Atomic PendingShaders; compiled, waiting for the next frame boundary
+    SDL_AtomicInt dirty;
+} RegisteredPipeline;
+
+// What the watcher thread hands over: SPIR-V and reflection only. The GPU
+// shaders and the pipeline are created from it on the main thread.
+typedef struct PendingShaders
+{
+    CompiledShader *vertex;
+    CompiledShader *fragment;
+    Uint64 compile_ns;
+} PendingShaders;
+
+typedef struct WatchedDirectory
+{
+    int watch;
+    char path[256];
+} WatchedDirectory;
+
+struct ShaderRegistry
+{
+    SDL_GPUDevice *gpu_device;
+
+    // Entries are filled in on the main thread before num_pipelines is bumped,
+    // so the watcher thread only ever sees complete entries.
+    RegisteredPipeline pipelines[MAX_REGISTERED_PIPELINES];
+    SDL_AtomicInt num_pipelines;
+
+    SDL_Thread *thread;
+    SDL_AtomicInt quit;
+    SDL_AtomicInt failures;
+    Uint32 reloads;
+
+    int inotify_fd;
+    WatchedDirectory watched[MAX_WATCHED_DIRECTORIES];
+    int num_watched;
+};
+
+static bool MarkPipelinesUsingSource(ShaderRegistry *registry, const char *source_path)
+{
+    bool marked = false;
+    int count = SDL_GetAtomicInt(&registry->num_pipelines);
+    for (int i = 0; i < count; i++) {
+        RegisteredPipeline *entry = &registry->pipelines[i];
+        if (SDL_strcmp(entry->vertex_source, source_path) == 0 ||
+            SDL_strcmp(entry->fragment_source, source_path) == 0) {
+            SDL_SetAtomicInt(&entry->dirty, 1);
+            marked = true;
+        }
+    }
+    return marked;
+}
+
+static SDL_Time GetModifyTime(const char *path)
+{
+    SDL_PathInfo info;
+    return SDL_GetPathInfo(path, &info) ? info.modify_time : 0;
+}
+
+#ifdef __linux__
+static void WatchDirectoryTree(ShaderRegistry *registry, const char *path);
+
+static SDL_EnumerationResult WatchSubdirectory(void *userdata, const char *dirname, const char *fname)
+{
+    char path[256];
+    SDL_snprintf(path, sizeof(path), "%s%s", dirname, fname);
+
+    SDL_PathInfo info;
+    if (SDL_GetPathInfo(path, &info) && info.type == SDL_PATHTYPE_DIRECTORY) {
+        WatchDirectoryTree(static_cast<ShaderRegistry*>(userdata), path);
+    }
+    return SDL_ENUM_CONTINUE;
+}
+
+static void WatchDirectoryTree(ShaderRegistry *registry, const char *path)
+{
+    if (registry->num_watched == MAX_WATCHED_DIRECTORIES) {
+        SDL_Log("Shader registry: too many directories, not watching %s", path);
+        return;
+    }
+
+    int watch = inotify_add_watch(registry->inotify_fd, path, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch < 0) {
+        SDL_Log("Shader registry: failed to watch %s", path);
+        return;
+    }
+
+    WatchedDirectory *watched = &registry->watched[registry->num_watched++];
+    watched->watch = watch;
+    SDL_strlcpy(watched->path, path, sizeof(watched->path));
+
+    SDL_EnumerateDirectory(path, WatchSubdirectory, registry);
+}
+
+static const char* GetWatchedPath(ShaderRegistry *registry, int watch)
+{
+    for (int i = 0; i < registry->num_watched; i++) {
+        if (registry->watched[i].watch == watch) {
+            return registry->watched[i].path;
+        }
+    }
+    return NULL;
+}
+
+// Reads whatever inotify has queued, waiting at most timeout_ms for the first event.
+static bool ReadShaderChanges(ShaderRegistry *registry, int timeout_ms)
+{
+    struct pollfd fd = { registry->inotify_fd, POLLIN, 0 };
+    if (poll(&fd, 1, timeout_ms) <= 0) {
+        return false;
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length = read(registry->inotify_fd, buffer, sizeof(buffer));
+    bool changed = false;
+
+    for (ssize_t offset = 0; offset < length; ) {
+        const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        const char *directory = GetWatchedPath(registry, event->wd);
+        if (directory == NULL || event->len == 0) {
+            continue;
+        }
+
+        char path[256];
+        SDL_snprintf(path, sizeof(path), "%s/%s", directory, event->name);
+
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                WatchDirectoryTree(registry, path);
+            }
+        } else if (SDL_strstr(event->name, ".hlsl") && MarkPipelinesUsingSource(registry, path)) {
+            changed = true;
+        }
+    }
+    return changed;
+}
+#endif
+
+static bool WaitForShaderChanges(ShaderRegistry *registry)
+{
+#ifdef __linux__
+    if (registry->inotify_fd >= 0) {
+        if (!ReadShaderChanges(registry, 100)) {
+            return false;
+        }
+        SDL_Delay(SHADER_RELOAD_SETTLE_MS);
+        while (ReadShaderChanges(registry, 0)) {
+        }
+        return true;
+    }
+#endif
+
+    // No file notifications on this platform; compare timestamps instead.
+    SDL_Delay(SHADER_POLL_INTERVAL_MS);
+    bool changed = false;
+    int count = SDL_GetAtomicInt(&registry->num_pipelines);
+    for (int i = 0; i < count; i++) {
+        RegisteredPipeline *entry = &registry->pipelines[i];
+        SDL_Time vertex_time = GetModifyTime(entry->vertex_source);
+        SDL_Time fragment_time = GetModifyTime(entry->fragment_source);
+        if (vertex_time != entry->vertex_modify_time || fragment_time != entry->fragment_modify_time) {
+            entry->vertex_modify_time = vertex_time;
+            entry->fragment_modify_time = fragment_time;
+            SDL_SetAtomicInt(&entry->dirty, 1);
+            changed = true;
+        }
+    }
+    if (changed) {
+        SDL_Delay(SHADER_RELOAD_SETTLE_MS);
+    }
+    return changed;
+}
+
+static void FreePendingShaders(PendingShaders *pending)
+{
+    if (pending != NULL) {
+        FreeCompiledShader(pending->vertex);
+        FreeCompiledShader(pending->fragment);
+        SDL_free(pending);
+    }
+}
+
+// Watcher thread: DXC and reflection only, under the session the main thread
+// opened in CreateShaderRegistry. No GPU calls happen here.
+static void RecompileShaders(ShaderRegistry *registry, RegisteredPipeline *entry)
+{
+    PROFILE_FUNCTION();
+    Uint64 start_ticks = SDL_GetTicksNS();
+
+    PendingShaders *pending = static_cast<PendingShaders*>(SDL_calloc(1, sizeof(PendingShaders)));
+    if (pending != NULL) {
+        pending->vertex = ShaderCrossCompileShader(entry->vertex_shader);
+        pending->fragment = ShaderCrossCompileShader(entry->fragment_shader);
+    }
+    if (pending == NULL || pending->vertex == NULL || pending->fragment == NULL) {
+        FreePendingShaders(pending);
+        SDL_Log("Shader reload failed for %s + %s, keeping the previous pipeline",
+                entry->vertex_shader, entry->fragment_shader);
+        SDL_AddAtomicInt(&registry->failures, 1);
+        return;
+    }
+    pending->compile_ns = SDL_GetTicksNS() - start_ticks;
+
+    // If the main thread hasn't picked up the previous compile yet, this one supersedes it.
+    FreePendingShaders(static_cast<PendingShaders*>(SDL_SetAtomicPointer(&entry->pending, pending)));
+}
+
+// Main thread: the GPU half of a reload. Returns NULL if the shaders or the
+// pipeline could not be created.
+static SDL_GPUGraphicsPipeline* CreatePendingPipeline(ShaderRegistry *registry, RegisteredPipeline *entry, const PendingShaders *pending)
+{
+    PROFILE_FUNCTION();
+    SDL_GPUShader *vertex_shader = ShaderCrossCreateCompiledShader(registry->gpu_device, pending->vertex);
+    SDL_GPUShader *fragment_shader = ShaderCrossCreateCompiledShader(registry->gpu_device, pending->fragment);
+
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+    if (vertex_shader != NULL && fragment_shader != NULL) {
+        SDL_GPUGraphicsPipelineCreateInfo create_info = entry->create_info;
+        create_info.vertex_shader = vertex_shader;
+        create_info.fragment_shader = fragment_shader;
+        pipeline = SDL_CreateGPUGraphicsPipeline(registry->gpu_device, &create_info);
+        if (pipeline == NULL) {
+            SDL_Log("Failed to create pipeline! %s", SDL_GetError());
+        }
+    }
+
+    if (vertex_shader != NULL) {
+        SDL_ReleaseGPUShader(registry->gpu_device, vertex_shader);
+    }
+    if (fragment_shader != NULL) {
+        SDL_ReleaseGPUShader(registry->gpu_device, fragment_shader);
+    }
+    return pipeline;
+}
+
+static int ShaderRegistryThread(void *data)
+{
+    ShaderRegistry *registry = static_cast<ShaderRegistry*>(data);
+    SetProfilerThreadName("ShaderRegistry");
+
+    while (!SDL_GetAtomicInt(&registry->quit)) {
+        if (!WaitForShaderChanges(registry)) {
+            continue;
+        }
+
+        int count = SDL_GetAtomicInt(&registry->num_pipelines);
+        for (int i = 0; i < count && !SDL_GetAtomicInt(&registry->quit); i++) {
+            RegisteredPipeline *entry = &registry->pipelines[i];
+            if (SDL_SetAtomicInt(&entry->dirty, 0)) {
+                RecompileShaders(registry, entry);
+            }
+        }
+    }
+    return 0;
+}
+
+ShaderRegistry* CreateShaderRegistry(SDL_GPUDevice* gpu_device)
+{
+    ShaderRegistry *registry = static_cast<ShaderRegistry*>(SDL_calloc(1, sizeof(ShaderRegistry)));
+    if (registry == NULL) {
+        return NULL;
+    }
+    registry->gpu_device = gpu_device;
+    registry->inotify_fd = -1;
+
+    // Keep DXC loaded for the registry's lifetime so reloads don't pay for Init/Quit.
+    if (!BeginShaderCrossSession()) {
+        SDL_free(registry);
+        return NULL;
+    }
+
+#ifdef __linux__
+    registry->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (registry->inotify_fd >= 0) {
+        char shader_directory[256];
+        SDL_snprintf(shader_directory, sizeof(shader_directory), "%s../assets/Shaders", SDL_GetBasePath());
+        WatchDirectoryTree(registry, shader_directory);
+    } else {
+        SDL_Log("Shader registry: inotify unavailable, falling back to polling");
+    }
+#endif
+
+    registry->thread = SDL_CreateThread(ShaderRegistryThread, "ShaderRegistry", registry);
+    if (registry->thread == NULL) {
+        SDL_Log("Failed to start shader registry thread. %s", SDL_GetError());
+    }
+    return registry;
+}
+
+void DestroyShaderRegistry(ShaderRegistry* registry)
+{
+    if (registry == NULL) {
+        return;
+    }
+
+    SDL_SetAtomicInt(&registry->quit, 1);
+    if (registry->thread != NULL) {
+        SDL_WaitThread(registry->thread, NULL);
+    }
+
+#ifdef __linux__
+    if (registry->inotify_fd >= 0) {
+        close(registry->inotify_fd);
+    }
+#endif
+
+    int count = SDL_GetAtomicInt(&registry->num_pipelines);
+    for (int i = 0; i < count; i++) {
+        RegisteredPipeline *entry = &registry->pipelines[i];
+        FreePendingShaders(static_cast<PendingShaders*>(SDL_SetAtomicPointer(&entry->pending, NULL)));
+        if (entry->owns_pipeline) {
+            SDL_ReleaseGPUGraphicsPipeline(registry->gpu_device, entry->pipeline);
+        }
+        SDL_free(entry->description_storage);
+    }
+
+    EndShaderCrossSession();
+    SDL_free(registry);
+}
+
+static int RegisterPipeline(
+    ShaderRegistry* registry,
+    const char* vertex_shader,
+    const char* fragment_shader,
+    const SDL_GPUGraphicsPipelineCreateInfo* create_info,
+    SDL_GPUGraphicsPipeline* pipeline,
+    bool owns_pipeline
+) {
+    int id = SDL_GetAtomicInt(&registry->num_pipelines);
+    if (id == MAX_REGISTERED_PIPELINES) {
+        SDL_Log("Shader registry is full, %s + %s will not hot reload", vertex_shader, fragment_shader);
+        return -1;
+    }
+
+    RegisteredPipeline *entry = &registry->pipelines[id];
+    SDL_zerop(entry);
+    SDL_strlcpy(entry->vertex_shader, vertex_shader, sizeof(entry->vertex_shader));
+    SDL_strlcpy(entry->fragment_shader, fragment_shader, sizeof(entry->fragment_shader));
+    SDL_snprintf(entry->vertex_source, sizeof(entry->vertex_source), "%s../%s.hlsl", SDL_GetBasePath(), vertex_shader);
+    SDL_snprintf(entry->fragment_source, sizeof(entry->fragment_source), "%s../%s.hlsl", SDL_GetBasePath(), fragment_shader);
+    entry->vertex_modify_time = GetModifyTime(entry->vertex_source);
+    entry->fragment_modify_time = GetModifyTime(entry->fragment_source);
+
+    // The caller's description arrays usually live on its stack; keep our own copy.
+    const SDL_GPUVertexInputState *vertex_input = &create_info->vertex_input_state;
+    size_t buffers_size = vertex_input->num_vertex_buffers * sizeof(SDL_GPUVertexBufferDescription);
+    size_t attributes_size = vertex_input->num_vertex_attributes * sizeof(SDL_GPUVertexAttribute);
+    size_t targets_size = create_info->target_info.num_color_targets * sizeof(SDL_GPUColorTargetDescription);
+
+    Uint8 *storage = static_cast<Uint8*>(SDL_malloc(SDL_max(buffers_size + attributes_size + targets_size, 1)));
+    if (storage == NULL) {
+        return -1;
+    }
+    if (buffers_size > 0) {
+        SDL_memcpy(storage, vertex_input->vertex_buffer_descriptions, buffers_size);
+    }
+    if (attributes_size > 0) {
+        SDL_memcpy(storage + buffers_size, vertex_input->vertex_attributes, attributes_size);
+    }
+    if (targets_size > 0) {
+        SDL_memcpy(storage + buffers_size + attributes_size, create_info->target_info.color_target_descriptions, targets_size);
+    }
+
+    entry->create_info = *create_info;
+    entry->create_info.vertex_shader = NULL;
+    entry->create_info.fragment_shader = NULL;
+    entry->create_info.vertex_input_state.vertex_buffer_descriptions = reinterpret_cast<SDL_GPUVertexBufferDescription*>(storage);
+    entry->create_info.vertex_input_state.vertex_attributes = reinterpret_cast<SDL_GPUVertexAttribute*>(storage + buffers_size);
+    entry->create_info.target_info.color_target_descriptions = reinterpret_cast<SDL_GPUColorTargetDescription*>(storage + buffers_size + attributes_size);
+    entry->description_storage = storage;
+    entry->pipeline = pipeline;
+    entry->owns_pipeline = owns_pipeline;
+
+    SDL_SetAtomicInt(&registry->num_pipelines, id + 1);
+    return id;
+}
+
+int RegisterGraphicsPipeline(
+    ShaderRegistry* registry,
+    const char* vertex_shader,
+    const char* fragment_shader,
+    const SDL_GPUGraphicsPipelineCreateInfo* create_info,
+    SDL_GPUGraphicsPipeline* pipeline
+) {
+    return RegisterPipeline(registry, vertex_shader, fragment_shader, create_info, pipeline, true);
+}
+
+int RegisterSharedGraphicsPipeline(
+    ShaderRegistry* registry,
+    const char* vertex_shader,
+    const char* fragment_shader,
+    const SDL_GPUGraphicsPipelineCreateInfo* create_info,
+    SDL_GPUGraphicsPipeline* pipeline
+) {
+    return RegisterPipeline(registry, vertex_shader, fragment_shader, create_info, pipeline, false);
+}
+
+void UpdateShaderRegistry(ShaderRegistry* registry)
+{
+    PROFILE_FUNCTION();
+    int count = SDL_GetAtomicInt(&registry->num_pipelines);
+    for (int i = 0; i < count; i++) {
+        RegisteredPipeline *entry = &registry->pipelines[i];
+        PendingShaders *pending = static_cast<PendingShaders*>(SDL_SetAtomicPointer(&entry->pending, NULL));
+        if (pending == NULL) {
+            continue;
+        }
+
+        Uint64 start_ticks = SDL_GetTicksNS();
+        SDL_GPUGraphicsPipeline *pipeline = CreatePendingPipeline(registry, entry, pending);
+        if (pipeline == NULL) {
+            SDL_Log("Shader reload failed for %s + %s, keeping the previous pipeline",
+                    entry->vertex_shader, entry->fragment_shader);
+            SDL_AddAtomicInt(&registry->failures, 1);
+            FreePendingShaders(pending);
+            continue;
+        }
+        SDL_Log("Recompiled %s + %s in %.2f ms, pipeline created in %.2f ms",
+                entry->vertex_shader, entry->fragment_shader,
+                pending->compile_ns / 1e6, (SDL_GetTicksNS() - start_ticks) / 1e6);
+        FreePendingShaders(pending);
+
+        // SDL defers the release until command buffers already using it have completed.
+        if (entry->owns_pipeline) {
+            SDL_ReleaseGPUGraphicsPipeline(registry->gpu_device, entry->pipeline);
+        }
+        entry->pipeline = pipeline;
+        entry->owns_pipeline = true;
+        registry->reloads++;
+    }
+}
+
+SDL_GPUGraphicsPipeline* GetRegisteredPipeline(ShaderRegistry* registry, int id)
+{
+    if (id < 0 || id >= SDL_GetAtomicInt(&registry->num_pipelines)) {
+        return NULL;
+    }
+    return registry->pipelines[id].pipeline;
+}
+
+ShaderRegistryStats GetShaderRegistryStats(ShaderRegistry* registry)
+{
+    ShaderRegistryStats stats;
+    stats.num_pipelines = (Uint32)SDL_GetAtomicInt(&registry->num_pipelines);
+    stats.reloads = registry->reloads;
+    stats.failures = (Uint32)SDL_GetAtomicInt(&registry->failures);
+    return stats;
+}
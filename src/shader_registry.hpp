@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Hot reload for graphics pipelines built from ShaderCross HLSL sources.
+// A background thread watches assets/Shaders (inotify on Linux, timestamp
+// polling elsewhere) and runs DXC and reflection for the pipelines whose
+// sources changed. It never touches the GPU device: the main thread creates
+// the shaders and pipeline from the compiled SPIR-V at the next frame
+// boundary. A failed compile is logged and the last good pipeline stays bound.
+
+typedef struct ShaderRegistry ShaderRegistry;
+
+typedef struct ShaderRegistryStats
+{
+    Uint32 num_pipelines;
+    Uint32 reloads;     // Pipelines swapped in by UpdateShaderRegistry
+    Uint32 failures;    // Recompiles that kept the previous pipeline
+} ShaderRegistryStats;
+
+// Holds a ShaderCross session until DestroyShaderRegistry. Main thread only.
+ShaderRegistry* CreateShaderRegistry(SDL_GPUDevice* gpu_device);
+void DestroyShaderRegistry(ShaderRegistry* registry);
+
+// Takes ownership of pipeline, which must have been created from create_info
+// with shaders loaded from vertex_shader/fragment_shader (same names as
+// ShaderCrossLoadShader). create_info is deep-copied; its shader fields are
+// ignored. Returns an id for GetRegisteredPipeline, or -1 on failure.
+int RegisterGraphicsPipeline(
+    ShaderRegistry* registry,
+    const char* vertex_shader,
+    const char* fragment_shader,
+    const SDL_GPUGraphicsPipelineCreateInfo* create_info,
+    SDL_GPUGraphicsPipeline* pipeline
+);
+
+// As RegisterGraphicsPipeline, but pipeline stays owned by the caller, e.g. a
+// pipeline cache. Rebuilt pipelines replace it without releasing it and are
+// the registry's own.
+int RegisterSharedGraphicsPipeline(
+    ShaderRegistry* registry,
+    const char* vertex_shader,
+    const char* fragment_shader,
+    const SDL_GPUGraphicsPipelineCreateInfo* create_info,
+    SDL_GPUGraphicsPipeline* pipeline
+);
+
+// Call once per frame before recording. Main thread only. Never waits on a
+// compile; it only creates pipelines from shaders the background thread has
+// already compiled, so a reload costs the frame its pipeline creation.
+void UpdateShaderRegistry(ShaderRegistry* registry);
+
+SDL_GPUGraphicsPipeline* GetRegisteredPipeline(ShaderRegistry* registry, int id);
+
+ShaderRegistryStats GetShaderRegistryStats(ShaderRegistry* registry);
@@ -0,0 +1,861 @@
+#include <SDL3/SDL.h>
+#include <transform.hpp>
+
+#define TRANSFORM_INVALID_SLOT SDL_MAX_UINT32
+#define TRANSFORM_MIN_CAPACITY 64
+#define TRANSFORM_ROOT_SLOT 0       // Identity parent of every root; never dirty, never moves
+
+typedef enum TransformLocal
+{
+    TRANSFORM_POSITION_X,
+    TRANSFORM_POSITION_Y,
+    TRANSFORM_POSITION_Z,
+    TRANSFORM_ROTATION_X,
+    TRANSFORM_ROTATION_Y,
+    TRANSFORM_ROTATION_Z,
+    TRANSFORM_ROTATION_W,
+    TRANSFORM_SCALE_X,
+    TRANSFORM_SCALE_Y,
+    TRANSFORM_SCALE_Z,
+    TRANSFORM_LOCAL_COUNT
+} TransformLocal;
+
+// World matrices are affine 3x4, row-major, in blocks of TRANSFORM_BLOCK
+// slots with a run per element: element row * 4 + column of a slot is at
+// TransformWorldIndex(slot, row * 4 + column). A SIMD batch writes one
+// contiguous block instead of twelve arrays, which the prefetchers can't
+// keep up with alongside the local and parent streams.
+#define TRANSFORM_WORLD_COUNT 12
+#define TRANSFORM_BLOCK 8
+#define TRANSFORM_BLOCK_FLOATS (TRANSFORM_WORLD_COUNT * TRANSFORM_BLOCK)
+
+struct TransformHierarchy
+{
+    // Dense slots sorted by depth (once needs_sort is clear); slot 0 is the root.
+    Uint32 count;
+    Uint32 capacity;
+    float *local[TRANSFORM_LOCAL_COUNT];
+    float *world;                   // capacity rounded up to a whole block
+    Uint32 *parents;
+    Uint32 *num_children;
+    Uint8 *dirty;                   // Local transform or parent changed by the caller
+    Uint8 *changed;                 // World matrix recomputed by the current update; cleared when it starts
+    entt::entity *entities;
+
+    // Entity index -> dense slot
+    Uint32 *sparse;
+    Uint32 sparse_capacity;
+
+    // Level d is slots [level_starts[d], level_starts[d + 1])
+    Uint32 *level_starts;
+    Uint32 num_levels;
+
+    bool needs_sort;
+    Uint32 num_dirty;
+    TransformStats stats;
+};
+
+// ---------------------------------------------------------------------------
+// Storage
+// ---------------------------------------------------------------------------
+
+typedef struct TransformArray
+{
+    void **data;
+    size_t element_size;
+} TransformArray;
+
+#define TRANSFORM_ARRAY_COUNT (TRANSFORM_LOCAL_COUNT + 5)
+
+static inline Uint32 TransformWorldIndex(Uint32 slot, int element)
+{
+    return (slot / TRANSFORM_BLOCK) * TRANSFORM_BLOCK_FLOATS + element * TRANSFORM_BLOCK + slot % TRANSFORM_BLOCK;
+}
+
+static void GetTransformArrays(TransformHierarchy *hierarchy, TransformArray arrays[TRANSFORM_ARRAY_COUNT])
+{
+    int n = 0;
+    for (int i = 0; i < TRANSFORM_LOCAL_COUNT; i++) {
+        arrays[n++] = { reinterpret_cast<void**>(&hierarchy->local[i]), sizeof(float) };
+    }
+    arrays[n++] = { reinterpret_cast<void**>(&hierarchy->parents), sizeof(Uint32) };
+    arrays[n++] = { reinterpret_cast<void**>(&hierarchy->num_children), sizeof(Uint32) };
+    arrays[n++] = { reinterpret_cast<void**>(&hierarchy->dirty), sizeof(Uint8) };
+    arrays[n++] = { reinterpret_cast<void**>(&hierarchy->changed), sizeof(Uint8) };
+    arrays[n++] = { reinterpret_cast<void**>(&hierarchy->entities), sizeof(entt::entity) };
+    SDL_assert(n == TRANSFORM_ARRAY_COUNT);
+}
+
+static bool ReserveTransforms(TransformHierarchy *hierarchy, Uint32 capacity)
+{
+    if (capacity <= hierarchy->capacity) {
+        return true;
+    }
+    capacity = SDL_max(capacity, SDL_max(hierarchy->capacity * 2, (Uint32)TRANSFORM_MIN_CAPACITY));
+    capacity = (capacity + TRANSFORM_BLOCK - 1) / TRANSFORM_BLOCK * TRANSFORM_BLOCK;
+
+    float *world = static_cast<float*>(SDL_realloc(hierarchy->world, capacity * TRANSFORM_WORLD_COUNT * sizeof(float)));
+    if (world == NULL) {
+        return false;
+    }
+    hierarchy->world = world;
+    TransformArray arrays[TRANSFORM_ARRAY_COUNT];
+    GetTransformArrays(hierarchy, arrays);
+    for (const TransformArray &array : arrays) {
+        void *data = SDL_realloc(*array.data, capacity * array.element_size);
+        if (data == NULL) {
+            return false;
+        }
+        *array.data = data;
+    }
+    hierarchy->capacity = capacity;
+    return true;
+}
+
+static bool ReserveSparse(TransformHierarchy *hierarchy, Uint32 index)
+{
+    if (index < hierarchy->sparse_capacity) {
+        return true;
+    }
+    Uint32 capacity = SDL_max(index + 1, SDL_max(hierarchy->sparse_capacity * 2, (Uint32)TRANSFORM_MIN_CAPACITY));
+    Uint32 *sparse = static_cast<Uint32*>(SDL_realloc(hierarchy->sparse, capacity * sizeof(Uint32)));
+    if (sparse == NULL) {
+        return false;
+    }
+    for (Uint32 i = hierarchy->sparse_capacity; i < capacity; i++) {
+        sparse[i] = TRANSFORM_INVALID_SLOT;
+    }
+    hierarchy->sparse = sparse;
+    hierarchy->sparse_capacity = capacity;
+    return true;
+}
+
+static Uint32 FindSlot(const TransformHierarchy *hierarchy, entt::entity entity)
+{
+    if (entity == entt::null) {
+        return TRANSFORM_INVALID_SLOT;
+    }
+    Uint32 index = (Uint32)entt::to_entity(entity);
+    if (index >= hierarchy->sparse_capacity) {
+        return TRANSFORM_INVALID_SLOT;
+    }
+    Uint32 slot = hierarchy->sparse[index];
+    if (slot == TRANSFORM_INVALID_SLOT || hierarchy->entities[slot] != entity) {
+        return TRANSFORM_INVALID_SLOT;
+    }
+    return slot;
+}
+
+static void SetIdentity(TransformHierarchy *hierarchy, Uint32 slot)
+{
+    for (int i = 0; i < TRANSFORM_LOCAL_COUNT; i++) {
+        hierarchy->local[i][slot] = 0.0f;
+    }
+    hierarchy->local[TRANSFORM_ROTATION_W][slot] = 1.0f;
+    hierarchy->local[TRANSFORM_SCALE_X][slot] = 1.0f;
+    hierarchy->local[TRANSFORM_SCALE_Y][slot] = 1.0f;
+    hierarchy->local[TRANSFORM_SCALE_Z][slot] = 1.0f;
+    for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+        hierarchy->world[TransformWorldIndex(slot, i)] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+static void MarkDirty(TransformHierarchy *hierarchy, Uint32 slot)
+{
+    if (!hierarchy->dirty[slot]) {
+        hierarchy->dirty[slot] = 1;
+        hierarchy->num_dirty++;
+    }
+}
+
+// Repoints every child of one slot at another. Only runs when the slot has children.
+static void ReparentChildren(TransformHierarchy *hierarchy, Uint32 from, Uint32 to, bool dirty)
+{
+    if (hierarchy->num_children[from] == 0) {
+        return;
+    }
+    for (Uint32 slot = 1; slot < hierarchy->count; slot++) {
+        if (hierarchy->parents[slot] == from) {
+            hierarchy->parents[slot] = to;
+            if (dirty) {
+                MarkDirty(hierarchy, slot);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Depth sort
+// ---------------------------------------------------------------------------
+
+// Breadth-first order: level by level, and within a level grouped by parent
+// in the parents' order, so siblings are adjacent and a subtree covers one
+// contiguous run per level. The SIMD batches then gather from a handful of
+// neighbouring parents, and a moving subtree fills whole batches instead of
+// one lane in each of many. Children keep their relative order, so an
+// already sorted hierarchy maps to itself and the arrays are only permuted
+// when something actually moved.
+static bool SortTransforms(TransformHierarchy *hierarchy)
+{
+    Uint32 count = hierarchy->count;
+    Uint32 *scratch = static_cast<Uint32*>(SDL_malloc((count * 5 + 2) * sizeof(Uint32)));
+    if (scratch == NULL) {
+        return false;
+    }
+    Uint32 *order = scratch;                    // new slot -> old slot
+    Uint32 *remap = scratch + count;            // old slot -> new slot
+    Uint32 *child_starts = scratch + count * 2; // Children of old slot s are children[child_starts[s]..child_starts[s + 1])
+    Uint32 *children = scratch + count * 3 + 1;
+    Uint32 *starts = scratch + count * 4 + 1;   // First new slot of each level, then the end
+
+    SDL_memset(child_starts, 0, (count + 1) * sizeof(Uint32));
+    for (Uint32 slot = 1; slot < count; slot++) {
+        child_starts[hierarchy->parents[slot] + 1]++;
+    }
+    for (Uint32 slot = 0; slot < count; slot++) {
+        child_starts[slot + 1] += child_starts[slot];
+    }
+    Uint32 *cursor = remap;     // Reused: next free child per parent
+    SDL_memcpy(cursor, child_starts, count * sizeof(Uint32));
+    for (Uint32 slot = 1; slot < count; slot++) {
+        children[cursor[hierarchy->parents[slot]]++] = slot;
+    }
+
+    Uint32 ordered = 1;
+    Uint32 num_levels = 1;
+    order[0] = TRANSFORM_ROOT_SLOT;
+    starts[0] = 0;
+    starts[1] = 1;
+    for (Uint32 level_first = 0, level_last = 1; level_first < level_last; level_first = level_last, level_last = ordered) {
+        for (Uint32 i = level_first; i < level_last; i++) {
+            for (Uint32 c = child_starts[order[i]]; c < child_starts[order[i] + 1]; c++) {
+                order[ordered++] = children[c];
+            }
+        }
+        if (ordered > level_last) {
+            starts[++num_levels] = ordered;
+        }
+    }
+    SDL_assert(ordered == count);
+
+    Uint32 *level_starts = static_cast<Uint32*>(SDL_realloc(hierarchy->level_starts, (num_levels + 1) * sizeof(Uint32)));
+    if (level_starts == NULL) {
+        SDL_free(scratch);
+        return false;
+    }
+    SDL_memcpy(level_starts, starts, (num_levels + 1) * sizeof(Uint32));
+    hierarchy->level_starts = level_starts;
+    hierarchy->num_levels = num_levels;
+    Uint32 max_depth = num_levels - 1;
+
+    bool moved = false;
+    for (Uint32 new_slot = 0; new_slot < count; new_slot++) {
+        remap[order[new_slot]] = new_slot;
+        moved |= order[new_slot] != new_slot;
+    }
+
+    if (moved) {
+        void *temp = SDL_malloc(count * sizeof(entt::entity) > count * sizeof(Uint32) ? count * sizeof(entt::entity) : count * sizeof(Uint32));
+        if (temp == NULL) {
+            SDL_free(scratch);
+            return false;
+        }
+        TransformArray arrays[TRANSFORM_ARRAY_COUNT];
+        GetTransformArrays(hierarchy, arrays);
+        for (const TransformArray &array : arrays) {
+            if (array.element_size == sizeof(Uint32)) {
+                const Uint32 *source = static_cast<const Uint32*>(*array.data);
+                Uint32 *destination = static_cast<Uint32*>(temp);
+                for (Uint32 slot = 0; slot < count; slot++) {
+                    destination[slot] = source[order[slot]];
+                }
+            } else if (array.element_size == sizeof(Uint8)) {
+                const Uint8 *source = static_cast<const Uint8*>(*array.data);
+                Uint8 *destination = static_cast<Uint8*>(temp);
+                for (Uint32 slot = 0; slot < count; slot++) {
+                    destination[slot] = source[order[slot]];
+                }
+            } else {
+                const Uint8 *source = static_cast<const Uint8*>(*array.data);
+                Uint8 *destination = static_cast<Uint8*>(temp);
+                for (Uint32 slot = 0; slot < count; slot++) {
+                    SDL_memcpy(destination + slot * array.element_size, source + order[slot] * array.element_size, array.element_size);
+                }
+            }
+            SDL_memcpy(*array.data, temp, count * array.element_size);
+        }
+        SDL_free(temp);
+
+        float *world = static_cast<float*>(SDL_malloc(hierarchy->capacity * TRANSFORM_WORLD_COUNT * sizeof(float)));
+        if (world == NULL) {
+            SDL_free(scratch);
+            return false;
+        }
+        for (Uint32 slot = 0; slot < count; slot++) {
+            for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+                world[TransformWorldIndex(slot, i)] = hierarchy->world[TransformWorldIndex(order[slot], i)];
+            }
+        }
+        SDL_free(hierarchy->world);
+        hierarchy->world = world;
+
+        for (Uint32 slot = 1; slot < count; slot++) {
+            hierarchy->parents[slot] = remap[hierarchy->parents[slot]];
+            hierarchy->sparse[(Uint32)entt::to_entity(hierarchy->entities[slot])] = slot;
+        }
+    }
+
+    SDL_free(scratch);
+    hierarchy->needs_sort = false;
+    hierarchy->stats.depth = max_depth;
+    hierarchy->stats.sorts++;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// World matrix kernels
+// ---------------------------------------------------------------------------
+//
+// world = parent_world * translate * rotate * scale, in affine 3x4. Every
+// path does the same float operations in the same order (no FMA), so the
+// results are bit-identical.
+
+// Propagates dirty flags for slots [first, first + count) and returns how
+// many of them need a new world matrix. Parents are on the level above, so
+// their changed flags are already final.
+static inline Uint32 PropagateChanged(TransformHierarchy *hierarchy, Uint32 first, Uint32 count)
+{
+    Uint32 num_changed = 0;
+    for (Uint32 slot = first; slot < first + count; slot++) {
+        Uint8 changed = hierarchy->dirty[slot] | hierarchy->changed[hierarchy->parents[slot]];
+        hierarchy->changed[slot] = changed;
+        hierarchy->dirty[slot] = 0;
+        num_changed += changed;
+    }
+    return num_changed;
+}
+
+// PropagateChanged for a SIMD batch of 4 or 8 slots, passing over a clean
+// batch without writing anything (changed was cleared when the update
+// began). Within a level parents never decrease, so the batch's parents are
+// the run from its first lane's to its last's, usually one or two slots.
+static inline Uint32 PropagateChangedBatch(TransformHierarchy *hierarchy, Uint32 first, Uint32 count)
+{
+    Uint8 dirty = 0;
+    for (Uint32 slot = first; slot < first + count; slot++) {
+        dirty |= hierarchy->dirty[slot];
+    }
+    if (dirty == 0) {
+        Uint32 parent = hierarchy->parents[first];
+        Uint32 parent_last = hierarchy->parents[first + count - 1];
+        while (parent <= parent_last && !hierarchy->changed[parent]) {
+            parent++;
+        }
+        if (parent > parent_last) {
+            return 0;
+        }
+    }
+    return PropagateChanged(hierarchy, first, count);
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+#define TRANSFORM_CLEAN_RUN 32
+
+// Whether TRANSFORM_CLEAN_RUN slots from first need nothing: none dirty and
+// no parent changed. After a clean batch the SIMD paths cross the rest of a
+// clean stretch a run at a time, so a sparse update isn't paced by checking
+// every batch of the untouched bulk.
+static inline bool IsRunClean(const TransformHierarchy *hierarchy, Uint32 first)
+{
+    const __m128i *dirty = reinterpret_cast<const __m128i*>(hierarchy->dirty + first);
+    __m128i any = _mm_or_si128(_mm_loadu_si128(dirty), _mm_loadu_si128(dirty + 1));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    Uint32 parent_last = hierarchy->parents[first + TRANSFORM_CLEAN_RUN - 1];
+    for (Uint32 parent = hierarchy->parents[first]; parent <= parent_last; parent++) {
+        if (hierarchy->changed[parent]) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+static void ComposeWorldScalar(TransformHierarchy *hierarchy, Uint32 slot)
+{
+    float *const *local = hierarchy->local;
+    float *world = hierarchy->world;
+    float x = local[TRANSFORM_ROTATION_X][slot];
+    float y = local[TRANSFORM_ROTATION_Y][slot];
+    float z = local[TRANSFORM_ROTATION_Z][slot];
+    float w = local[TRANSFORM_ROTATION_W][slot];
+    float sx = local[TRANSFORM_SCALE_X][slot];
+    float sy = local[TRANSFORM_SCALE_Y][slot];
+    float sz = local[TRANSFORM_SCALE_Z][slot];
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    float m[TRANSFORM_WORLD_COUNT] = {
+        (1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy - wz) * sy, 2.0f * (xz + wy) * sz, local[TRANSFORM_POSITION_X][slot],
+        2.0f * (xy + wz) * sx, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz - wx) * sz, local[TRANSFORM_POSITION_Y][slot],
+        2.0f * (xz - wy) * sx, 2.0f * (yz + wx) * sy, (1.0f - 2.0f * (xx + yy)) * sz, local[TRANSFORM_POSITION_Z][slot],
+    };
+
+    Uint32 parent = hierarchy->parents[slot];
+    float p[TRANSFORM_WORLD_COUNT];
+    for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+        p[i] = world[TransformWorldIndex(parent, i)];
+    }
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            float value = p[r * 4 + 0] * m[c] + p[r * 4 + 1] * m[4 + c] + p[r * 4 + 2] * m[8 + c];
+            if (c == 3) {
+                value = value + p[r * 4 + 3];
+            }
+            world[TransformWorldIndex(slot, r * 4 + c)] = value;
+        }
+    }
+}
+
+static Uint32 UpdateRangeScalar(TransformHierarchy *hierarchy, Uint32 first, Uint32 last)
+{
+    Uint32 updated = 0;
+    for (Uint32 slot = first; slot < last; slot++) {
+        if (PropagateChanged(hierarchy, slot, 1)) {
+            ComposeWorldScalar(hierarchy, slot);
+            updated++;
+        }
+    }
+    return updated;
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static Uint32 UpdateRangeSSE2(TransformHierarchy *hierarchy, Uint32 first, Uint32 last)
+{
+    float *const *local = hierarchy->local;
+    float *world = hierarchy->world;
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    // Scalar up to the first whole batch, so no batch straddles two blocks
+    Uint32 slot = SDL_min(last, (first + 3) & ~3u);
+    Uint32 updated = UpdateRangeScalar(hierarchy, first, slot);
+    for (; slot + 4 <= last; slot += 4) {
+        Uint32 num_changed = PropagateChangedBatch(hierarchy, slot, 4);
+        if (num_changed == 0) {
+            while (slot + 4 + TRANSFORM_CLEAN_RUN <= last && IsRunClean(hierarchy, slot + 4)) {
+                slot += TRANSFORM_CLEAN_RUN;
+            }
+            continue;
+        }
+        // Unchanged lanes recompute to the same bits, so the whole batch is written.
+        updated += num_changed;
+
+        __m128 x = _mm_loadu_ps(local[TRANSFORM_ROTATION_X] + slot);
+        __m128 y = _mm_loadu_ps(local[TRANSFORM_ROTATION_Y] + slot);
+        __m128 z = _mm_loadu_ps(local[TRANSFORM_ROTATION_Z] + slot);
+        __m128 w = _mm_loadu_ps(local[TRANSFORM_ROTATION_W] + slot);
+        __m128 sx = _mm_loadu_ps(local[TRANSFORM_SCALE_X] + slot);
+        __m128 sy = _mm_loadu_ps(local[TRANSFORM_SCALE_Y] + slot);
+        __m128 sz = _mm_loadu_ps(local[TRANSFORM_SCALE_Z] + slot);
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 m[TRANSFORM_WORLD_COUNT] = {
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+            _mm_loadu_ps(local[TRANSFORM_POSITION_X] + slot),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+            _mm_loadu_ps(local[TRANSFORM_POSITION_Y] + slot),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+            _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+            _mm_loadu_ps(local[TRANSFORM_POSITION_Z] + slot),
+        };
+
+        const Uint32 *parents = hierarchy->parents + slot;
+        const Uint32 parent_indices[4] = {
+            TransformWorldIndex(parents[0], 0), TransformWorldIndex(parents[1], 0),
+            TransformWorldIndex(parents[2], 0), TransformWorldIndex(parents[3], 0),
+        };
+        __m128 p[TRANSFORM_WORLD_COUNT];
+        for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+            const float *source = world + i * TRANSFORM_BLOCK;
+            p[i] = _mm_setr_ps(source[parent_indices[0]], source[parent_indices[1]], source[parent_indices[2]], source[parent_indices[3]]);
+        }
+        float *destination = world + TransformWorldIndex(slot, 0);
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 4; c++) {
+                __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[r * 4 + 0], m[c]), _mm_mul_ps(p[r * 4 + 1], m[4 + c])),
+                                          _mm_mul_ps(p[r * 4 + 2], m[8 + c]));
+                if (c == 3) {
+                    value = _mm_add_ps(value, p[r * 4 + 3]);
+                }
+                _mm_storeu_ps(destination + (r * 4 + c) * TRANSFORM_BLOCK, value);
+            }
+        }
+    }
+    return updated + UpdateRangeScalar(hierarchy, slot, last);
+}
+#endif
+
+#ifdef SDL_AVX2_INTRINSICS
+SDL_TARGETING("avx2")
+static Uint32 UpdateRangeAVX2(TransformHierarchy *hierarchy, Uint32 first, Uint32 last)
+{
+    float *const *local = hierarchy->local;
+    float *world = hierarchy->world;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    // Scalar up to the first whole block, so each batch is exactly one block
+    Uint32 slot = SDL_min(last, (first + TRANSFORM_BLOCK - 1) & ~(Uint32)(TRANSFORM_BLOCK - 1));
+    Uint32 updated = UpdateRangeScalar(hierarchy, first, slot);
+    for (; slot + TRANSFORM_BLOCK <= last; slot += TRANSFORM_BLOCK) {
+        Uint32 num_changed = PropagateChangedBatch(hierarchy, slot, TRANSFORM_BLOCK);
+        if (num_changed == 0) {
+            while (slot + TRANSFORM_BLOCK + TRANSFORM_CLEAN_RUN <= last && IsRunClean(hierarchy, slot + TRANSFORM_BLOCK)) {
+                slot += TRANSFORM_CLEAN_RUN;
+            }
+            continue;
+        }
+        updated += num_changed;
+
+        __m256 x = _mm256_loadu_ps(local[TRANSFORM_ROTATION_X] + slot);
+        __m256 y = _mm256_loadu_ps(local[TRANSFORM_ROTATION_Y] + slot);
+        __m256 z = _mm256_loadu_ps(local[TRANSFORM_ROTATION_Z] + slot);
+        __m256 w = _mm256_loadu_ps(local[TRANSFORM_ROTATION_W] + slot);
+        __m256 sx = _mm256_loadu_ps(local[TRANSFORM_SCALE_X] + slot);
+        __m256 sy = _mm256_loadu_ps(local[TRANSFORM_SCALE_Y] + slot);
+        __m256 sz = _mm256_loadu_ps(local[TRANSFORM_SCALE_Z] + slot);
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        __m256 m[TRANSFORM_WORLD_COUNT] = {
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+            _mm256_loadu_ps(local[TRANSFORM_POSITION_X] + slot),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+            _mm256_loadu_ps(local[TRANSFORM_POSITION_Y] + slot),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+            _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+            _mm256_loadu_ps(local[TRANSFORM_POSITION_Z] + slot),
+        };
+
+        // Siblings are adjacent, so the batch's parents are usually all in one
+        // block: a load and a lane permute per element instead of a gather.
+        const Uint32 *parent_slots = hierarchy->parents + slot;
+        __m256i parents = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(parent_slots));
+        __m256i lanes = _mm256_and_si256(parents, _mm256_set1_epi32(TRANSFORM_BLOCK - 1));
+        __m256 p[TRANSFORM_WORLD_COUNT];
+        if (parent_slots[0] / TRANSFORM_BLOCK == parent_slots[TRANSFORM_BLOCK - 1] / TRANSFORM_BLOCK) {
+            const float *source = world + TransformWorldIndex(parent_slots[0], 0) - parent_slots[0] % TRANSFORM_BLOCK;
+            for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+                p[i] = _mm256_permutevar8x32_ps(_mm256_loadu_ps(source + i * TRANSFORM_BLOCK), lanes);
+            }
+        } else {
+            __m256i blocks = _mm256_mullo_epi32(_mm256_srli_epi32(parents, 3), _mm256_set1_epi32(TRANSFORM_BLOCK_FLOATS));
+            __m256i indices = _mm256_add_epi32(blocks, lanes);
+            for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+                p[i] = _mm256_i32gather_ps(world + i * TRANSFORM_BLOCK, indices, 4);
+            }
+        }
+        float *destination = world + TransformWorldIndex(slot, 0);
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 4; c++) {
+                __m256 value = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p[r * 4 + 0], m[c]), _mm256_mul_ps(p[r * 4 + 1], m[4 + c])),
+                                             _mm256_mul_ps(p[r * 4 + 2], m[8 + c]));
+                if (c == 3) {
+                    value = _mm256_add_ps(value, p[r * 4 + 3]);
+                }
+                _mm256_storeu_ps(destination + (r * 4 + c) * TRANSFORM_BLOCK, value);
+            }
+        }
+    }
+    return updated + UpdateRangeScalar(hierarchy, slot, last);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+TransformHierarchy* CreateTransformHierarchy(Uint32 initial_capacity)
+{
+    TransformHierarchy *hierarchy = static_cast<TransformHierarchy*>(SDL_calloc(1, sizeof(TransformHierarchy)));
+    if (hierarchy == NULL) {
+        return NULL;
+    }
+    if (!ReserveTransforms(hierarchy, initial_capacity + 1)) {
+        DestroyTransformHierarchy(hierarchy);
+        return NULL;
+    }
+
+    hierarchy->count = 1;
+    SetIdentity(hierarchy, TRANSFORM_ROOT_SLOT);
+    hierarchy->parents[TRANSFORM_ROOT_SLOT] = TRANSFORM_ROOT_SLOT;
+    hierarchy->num_children[TRANSFORM_ROOT_SLOT] = 0;
+    hierarchy->dirty[TRANSFORM_ROOT_SLOT] = 0;
+    hierarchy->changed[TRANSFORM_ROOT_SLOT] = 0;
+    hierarchy->entities[TRANSFORM_ROOT_SLOT] = entt::null;
+    hierarchy->needs_sort = true;
+    return hierarchy;
+}
+
+void DestroyTransformHierarchy(TransformHierarchy *hierarchy)
+{
+    if (hierarchy == NULL) {
+        return;
+    }
+    TransformArray arrays[TRANSFORM_ARRAY_COUNT];
+    GetTransformArrays(hierarchy, arrays);
+    for (const TransformArray &array : arrays) {
+        SDL_free(*array.data);
+    }
+    SDL_free(hierarchy->world);
+    SDL_free(hierarchy->sparse);
+    SDL_free(hierarchy->level_starts);
+    SDL_free(hierarchy);
+}
+
+bool AddTransform(TransformHierarchy *hierarchy, entt::entity entity, entt::entity parent)
+{
+    if (entity == entt::null || FindSlot(hierarchy, entity) != TRANSFORM_INVALID_SLOT) {
+        return SDL_SetError("Entity is null or already has a transform");
+    }
+    Uint32 parent_slot = TRANSFORM_ROOT_SLOT;
+    if (parent != entt::null) {
+        parent_slot = FindSlot(hierarchy, parent);
+        if (parent_slot == TRANSFORM_INVALID_SLOT) {
+            return SDL_SetError("Parent has no transform");
+        }
+    }
+    if (!ReserveTransforms(hierarchy, hierarchy->count + 1) || !ReserveSparse(hierarchy, (Uint32)entt::to_entity(entity))) {
+        return false;
+    }
+
+    Uint32 slot = hierarchy->count++;
+    SetIdentity(hierarchy, slot);
+    hierarchy->parents[slot] = parent_slot;
+    hierarchy->num_children[slot] = 0;
+    hierarchy->num_children[parent_slot]++;
+    hierarchy->dirty[slot] = 0;
+    hierarchy->changed[slot] = 0;
+    hierarchy->entities[slot] = entity;
+    hierarchy->sparse[(Uint32)entt::to_entity(entity)] = slot;
+    MarkDirty(hierarchy, slot);
+    hierarchy->needs_sort = true;
+    return true;
+}
+
+void RemoveTransform(TransformHierarchy *hierarchy, entt::entity entity)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return;
+    }
+
+    // Orphans become roots: their local transform is now relative to the world.
+    hierarchy->num_children[TRANSFORM_ROOT_SLOT] += hierarchy->num_children[slot];
+    ReparentChildren(hierarchy, slot, TRANSFORM_ROOT_SLOT, true);
+    hierarchy->num_children[hierarchy->parents[slot]]--;
+    if (hierarchy->dirty[slot]) {
+        hierarchy->num_dirty--;
+    }
+    hierarchy->sparse[(Uint32)entt::to_entity(entity)] = TRANSFORM_INVALID_SLOT;
+
+    // Fill the hole with the last slot; the next update re-sorts.
+    Uint32 last = hierarchy->count - 1;
+    if (slot != last) {
+        TransformArray arrays[TRANSFORM_ARRAY_COUNT];
+        GetTransformArrays(hierarchy, arrays);
+        for (const TransformArray &array : arrays) {
+            Uint8 *data = static_cast<Uint8*>(*array.data);
+            SDL_memcpy(data + slot * array.element_size, data + last * array.element_size, array.element_size);
+        }
+        for (int i = 0; i < TRANSFORM_WORLD_COUNT; i++) {
+            hierarchy->world[TransformWorldIndex(slot, i)] = hierarchy->world[TransformWorldIndex(last, i)];
+        }
+        ReparentChildren(hierarchy, last, slot, false);
+        hierarchy->sparse[(Uint32)entt::to_entity(hierarchy->entities[slot])] = slot;
+    }
+    hierarchy->count--;
+    hierarchy->needs_sort = true;
+}
+
+bool HasTransform(const TransformHierarchy *hierarchy, entt::entity entity)
+{
+    return FindSlot(hierarchy, entity) != TRANSFORM_INVALID_SLOT;
+}
+
+bool SetTransformParent(TransformHierarchy *hierarchy, entt::entity entity, entt::entity parent)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return SDL_SetError("Entity has no transform");
+    }
+    Uint32 parent_slot = TRANSFORM_ROOT_SLOT;
+    if (parent != entt::null) {
+        parent_slot = FindSlot(hierarchy, parent);
+        if (parent_slot == TRANSFORM_INVALID_SLOT) {
+            return SDL_SetError("Parent has no transform");
+        }
+    }
+    for (Uint32 walk = parent_slot; walk != TRANSFORM_ROOT_SLOT; walk = hierarchy->parents[walk]) {
+        if (walk == slot) {
+            return SDL_SetError("Parenting would create a cycle");
+        }
+    }
+    if (hierarchy->parents[slot] == parent_slot) {
+        return true;
+    }
+
+    hierarchy->num_children[hierarchy->parents[slot]]--;
+    hierarchy->num_children[parent_slot]++;
+    hierarchy->parents[slot] = parent_slot;
+    MarkDirty(hierarchy, slot);
+    hierarchy->needs_sort = true;
+    return true;
+}
+
+void SetLocalTransform(TransformHierarchy *hierarchy, entt::entity entity, const LocalTransform *local)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return;
+    }
+    const float values[TRANSFORM_LOCAL_COUNT] = {
+        local->position[0], local->position[1], local->position[2],
+        local->rotation[0], local->rotation[1], local->rotation[2], local->rotation[3],
+        local->scale[0], local->scale[1], local->scale[2],
+    };
+    for (int i = 0; i < TRANSFORM_LOCAL_COUNT; i++) {
+        hierarchy->local[i][slot] = values[i];
+    }
+    MarkDirty(hierarchy, slot);
+}
+
+void SetLocalPosition(TransformHierarchy *hierarchy, entt::entity entity, float x, float y, float z)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return;
+    }
+    hierarchy->local[TRANSFORM_POSITION_X][slot] = x;
+    hierarchy->local[TRANSFORM_POSITION_Y][slot] = y;
+    hierarchy->local[TRANSFORM_POSITION_Z][slot] = z;
+    MarkDirty(hierarchy, slot);
+}
+
+void SetLocalRotation(TransformHierarchy *hierarchy, entt::entity entity, float x, float y, float z, float w)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return;
+    }
+    hierarchy->local[TRANSFORM_ROTATION_X][slot] = x;
+    hierarchy->local[TRANSFORM_ROTATION_Y][slot] = y;
+    hierarchy->local[TRANSFORM_ROTATION_Z][slot] = z;
+    hierarchy->local[TRANSFORM_ROTATION_W][slot] = w;
+    MarkDirty(hierarchy, slot);
+}
+
+bool GetLocalTransform(const TransformHierarchy *hierarchy, entt::entity entity, LocalTransform *local)
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return false;
+    }
+    float *values[TRANSFORM_LOCAL_COUNT] = {
+        &local->position[0], &local->position[1], &local->position[2],
+        &local->rotation[0], &local->rotation[1], &local->rotation[2], &local->rotation[3],
+        &local->scale[0], &local->scale[1], &local->scale[2],
+    };
+    for (int i = 0; i < TRANSFORM_LOCAL_COUNT; i++) {
+        *values[i] = hierarchy->local[i][slot];
+    }
+    return true;
+}
+
+TransformUpdatePath ResolveTransformUpdatePath(TransformUpdatePath path)
+{
+#ifdef SDL_AVX2_INTRINSICS
+    if ((path == TRANSFORM_UPDATE_AUTO || path == TRANSFORM_UPDATE_AVX2) && SDL_HasAVX2()) {
+        return TRANSFORM_UPDATE_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if ((path == TRANSFORM_UPDATE_AUTO || path == TRANSFORM_UPDATE_AVX2 || path == TRANSFORM_UPDATE_SSE2) && SDL_HasSSE2()) {
+        return TRANSFORM_UPDATE_SSE2;
+    }
+#endif
+    return TRANSFORM_UPDATE_SCALAR;
+}
+
+Uint32 UpdateTransforms(TransformHierarchy *hierarchy, TransformUpdatePath path)
+{
+    if (hierarchy->needs_sort && !SortTransforms(hierarchy)) {
+        SDL_Log("Out of memory sorting %u transforms", hierarchy->count - 1);
+        return 0;
+    }
+
+    hierarchy->stats.dirty_last_update = hierarchy->num_dirty;
+    hierarchy->stats.updated_last_update = 0;
+    if (hierarchy->num_dirty == 0) {
+        return 0;
+    }
+
+    SDL_memset(hierarchy->changed, 0, hierarchy->count);
+    path = ResolveTransformUpdatePath(path);
+    Uint32 updated = 0;
+    for (Uint32 depth = 1; depth < hierarchy->num_levels; depth++) {
+        Uint32 first = hierarchy->level_starts[depth];
+        Uint32 last = hierarchy->level_starts[depth + 1];
+        switch (path) {
+#ifdef SDL_AVX2_INTRINSICS
+            case TRANSFORM_UPDATE_AVX2: updated += UpdateRangeAVX2(hierarchy, first, last); break;
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+            case TRANSFORM_UPDATE_SSE2: updated += UpdateRangeSSE2(hierarchy, first, last); break;
+#endif
+            default: updated += UpdateRangeScalar(hierarchy, first, last); break;
+        }
+    }
+
+    hierarchy->num_dirty = 0;
+    hierarchy->stats.updated_last_update = updated;
+    return updated;
+}
+
+bool GetWorldMatrix(const TransformHierarchy *hierarchy, entt::entity entity, float matrix[16])
+{
+    Uint32 slot = FindSlot(hierarchy, entity);
+    if (slot == TRANSFORM_INVALID_SLOT) {
+        return false;
+    }
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 3; r++) {
+            matrix[c * 4 + r] = hierarchy->world[TransformWorldIndex(slot, r * 4 + c)];
+        }
+        matrix[c * 4 + 3] = c == 3 ? 1.0f : 0.0f;
+    }
+    return true;
+}
+
+TransformStats GetTransformStats(const TransformHierarchy *hierarchy)
+{
+    TransformStats stats = hierarchy->stats;
+    stats.count = hierarchy->count - 1;
+    return stats;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <entt/entt.hpp>
+
+// Parent/child transforms for registry entities. Local position, rotation and
+// scale live in structure-of-arrays pools (one float array per component)
+// kept in breadth-first order, by depth with siblings adjacent, so parents
+// always come before their children and UpdateTransforms is one linear pass:
+// each depth level is swept 8 (AVX2) or 4 (SSE2) transforms at a time,
+// gathering the parents' world matrices from the level above. Only dirty
+// transforms and their descendants are recomputed; a frame where nothing
+// moved costs nothing, and untouched stretches of a sparse one are skipped
+// in runs.
+//
+// Structural changes (add, remove, reparent) are cheap to make and are
+// folded in by a re-sort at the start of the next update.
+
+typedef enum TransformUpdatePath
+{
+    TRANSFORM_UPDATE_AUTO,      // Best path the CPU supports
+    TRANSFORM_UPDATE_SCALAR,
+    TRANSFORM_UPDATE_SSE2,
+    TRANSFORM_UPDATE_AVX2
+} TransformUpdatePath;
+
+typedef struct LocalTransform
+{
+    float position[3];
+    float rotation[4];          // Unit quaternion x, y, z, w
+    float scale[3];
+} LocalTransform;
+
+typedef struct TransformStats
+{
+    Uint32 count;
+    Uint32 depth;               // Levels below the root; 1 for a flat scene
+    Uint32 dirty_last_update;   // Set by the caller since the update before
+    Uint32 updated_last_update; // World matrices recomputed (dirty ones plus their descendants)
+    Uint32 sorts;               // Re-sorts after structural changes
+} TransformStats;
+
+typedef struct TransformHierarchy TransformHierarchy;
+
+TransformHierarchy* CreateTransformHierarchy(Uint32 initial_capacity);
+void DestroyTransformHierarchy(TransformHierarchy *hierarchy);
+
+// parent may be entt::null for a root. The new transform is the identity.
+bool AddTransform(TransformHierarchy *hierarchy, entt::entity entity, entt::entity parent);
+// Children of a removed transform become roots, keeping their local transform.
+void RemoveTransform(TransformHierarchy *hierarchy, entt::entity entity);
+bool HasTransform(const TransformHierarchy *hierarchy, entt::entity entity);
+// Fails if it would make a cycle.
+bool SetTransformParent(TransformHierarchy *hierarchy, entt::entity entity, entt::entity parent);
+
+void SetLocalTransform(TransformHierarchy *hierarchy, entt::entity entity, const LocalTransform *local);
+void SetLocalPosition(TransformHierarchy *hierarchy, entt::entity entity, float x, float y, float z);
+void SetLocalRotation(TransformHierarchy *hierarchy, entt::entity entity, float x, float y, float z, float w);
+bool GetLocalTransform(const TransformHierarchy *hierarchy, entt::entity entity, LocalTransform *local);
+
+// Recomputes world matrices. Returns how many were recomputed. All paths
+// produce bit-identical results.
+Uint32 UpdateTransforms(TransformHierarchy *hierarchy, TransformUpdatePath path);
+
+// Column-major 4x4 (glm layout), as of the last update.
+bool GetWorldMatrix(const TransformHierarchy *hierarchy, entt::entity entity, float matrix[16]);
+
+TransformStats GetTransformStats(const TransformHierarchy *hierarchy);
+TransformUpdatePath ResolveTransformUpdatePath(TransformUpdatePath path);
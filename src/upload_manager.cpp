@@ -0,0 +1,555 @@
+#include <SDL3/SDL.h>
+#include <upload_manager.hpp>
+#include <profiler.hpp>
+
+// D3D12 wants texture copy sources on 512-byte boundaries; SDL bounces
+// anything else through a temporary buffer, so keep texture regions aligned.
+#define TEXTURE_UPLOAD_ALIGNMENT 512
+#define BUFFER_UPLOAD_ALIGNMENT 16
+#define MAX_UPLOAD_FRAMES_IN_FLIGHT 8
+
+void InitUploadRing(UploadRing *ring, Uint32 capacity)
+{
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+bool UploadRingAllocate(UploadRing *ring, Uint32 size, Uint32 alignment, Uint32 *offset)
+{
+    if (size == 0 || size > ring->capacity) {
+        return false;
+    }
+    // Nothing live: start over at offset 0, or a region the size of the ring
+    // would never fit once the padding to the end is counted.
+    if (ring->head == ring->tail) {
+        ring->head = (ring->head + ring->capacity - 1) / ring->capacity * ring->capacity;
+        ring->tail = ring->head;
+    }
+
+    Uint64 start = (ring->head + alignment - 1) & ~(Uint64)(alignment - 1);
+    Uint32 ring_offset = (Uint32)(start % ring->capacity);
+
+    // Regions never straddle the end; skip the remainder and start over at 0.
+    if ((Uint64)ring_offset + size > ring->capacity) {
+        start += ring->capacity - ring_offset;
+        ring_offset = 0;
+    }
+    if (start + size - ring->tail > ring->capacity) {
+        return false;
+    }
+
+    ring->head = start + size;
+    *offset = ring_offset;
+    return true;
+}
+
+void UploadRingRelease(UploadRing *ring, Uint64 position)
+{
+    SDL_assert(position <= ring->head);
+    if (position > ring->tail) {
+        ring->tail = position;
+    }
+}
+
+Uint32 GetUploadRingUsed(const UploadRing *ring)
+{
+    return (Uint32)(ring->head - ring->tail);
+}
+
+typedef struct UploadRequest
+{
+    UploadTicket ticket;
+    const Uint8 *data;
+    Uint32 size;
+    Uint32 consumed;                // Bytes of a split buffer upload already staged
+    SDL_GPUTexture *texture;        // Exactly one of texture / buffer is set
+    SDL_GPUTextureRegion texture_region;
+    Uint32 pixels_per_row;
+    Uint32 rows_per_layer;
+    SDL_GPUBuffer *buffer;
+    Uint32 buffer_offset;
+    UploadDataReleaseFunction release;
+    void *userdata;
+    const void *release_data;       // data, or the start of a texture's shared block
+} UploadRequest;
+
+typedef struct UploadCopy
+{
+    Uint32 ring_offset;
+    Uint32 size;
+    SDL_GPUTextureRegion texture_region;
+    Uint32 pixels_per_row;
+    Uint32 rows_per_layer;
+    SDL_GPUBuffer *buffer;
+    Uint32 buffer_offset;
+} UploadCopy;
+
+typedef struct UploadFrame
+{
+    SDL_GPUFence *fence;
+    Uint64 ring_position;           // Ring head after this frame's copies
+    UploadTicket last_ticket;       // Every ticket up to this one completes with the fence
+} UploadFrame;
+
+struct UploadManager
+{
+    SDL_GPUDevice *gpu_device;
+    SDL_GPUTransferBuffer *transfer_buffer;
+    Uint8 *headless;                // Stands in for the transfer buffer without a device
+    UploadRing ring;
+    Uint32 frame_budget;
+    Uint32 ring_high_water;
+
+    // FIFO of queued uploads; first is the oldest not yet fully staged.
+    UploadRequest *requests;
+    Uint32 first_request;
+    Uint32 num_requests;
+    Uint32 request_capacity;
+    Uint64 pending_bytes;
+
+    UploadCopy *copies;             // Scratch for the current flush
+    Uint32 copy_capacity;
+
+    UploadFrame frames[MAX_UPLOAD_FRAMES_IN_FLIGHT];
+    Uint32 first_frame;
+    Uint32 num_frames;
+
+    UploadTicket next_ticket;       // Tickets start at 1
+    UploadTicket staged_ticket;     // Highest ticket fully copied into the ring
+    UploadTicket completed_ticket;  // Highest ticket whose copy has finished on the GPU
+
+    Uint64 bytes_last_frame;
+    Uint32 copies_last_frame;
+};
+
+UploadManager* CreateUploadManager(SDL_GPUDevice *gpu_device, Uint32 ring_size, Uint32 frame_budget)
+{
+    ring_size = (ring_size + TEXTURE_UPLOAD_ALIGNMENT - 1) & ~(Uint32)(TEXTURE_UPLOAD_ALIGNMENT - 1);
+
+    UploadManager *manager = static_cast<UploadManager*>(SDL_calloc(1, sizeof(UploadManager)));
+    if (manager == NULL) {
+        return NULL;
+    }
+
+    if (gpu_device == NULL) {
+        manager->headless = static_cast<Uint8*>(SDL_malloc(ring_size));
+        if (manager->headless == NULL) {
+            SDL_free(manager);
+            return NULL;
+        }
+    } else {
+        SDL_GPUTransferBufferCreateInfo transfer_info = {
+            .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+            .size = ring_size
+        };
+        manager->transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device, &transfer_info);
+        if (manager->transfer_buffer == NULL) {
+            SDL_Log("Failed to create upload ring! %s", SDL_GetError());
+            SDL_free(manager);
+            return NULL;
+        }
+    }
+
+    manager->gpu_device = gpu_device;
+    manager->frame_budget = frame_budget;
+    manager->next_ticket = 1;
+    InitUploadRing(&manager->ring, ring_size);
+    return manager;
+}
+
+static void ReleaseRequestData(UploadRequest *request)
+{
+    if (request->release != NULL) {
+        request->release(request->userdata, request->release_data);
+        request->release = NULL;
+    }
+}
+
+static void RetireUploadFrame(UploadManager *manager)
+{
+    UploadFrame *frame = &manager->frames[manager->first_frame];
+    SDL_ReleaseGPUFence(manager->gpu_device, frame->fence);
+    UploadRingRelease(&manager->ring, frame->ring_position);
+    manager->completed_ticket = frame->last_ticket;
+    manager->first_frame = (manager->first_frame + 1) % MAX_UPLOAD_FRAMES_IN_FLIGHT;
+    manager->num_frames--;
+}
+
+void DestroyUploadManager(UploadManager *manager)
+{
+    if (manager == NULL) {
+        return;
+    }
+
+    while (manager->num_frames > 0) {
+        UploadFrame *frame = &manager->frames[manager->first_frame];
+        SDL_WaitForGPUFences(manager->gpu_device, true, &frame->fence, 1);
+        RetireUploadFrame(manager);
+    }
+    for (Uint32 i = 0; i < manager->num_requests; i++) {
+        ReleaseRequestData(&manager->requests[manager->first_request + i]);
+    }
+
+    if (manager->transfer_buffer != NULL) {
+        SDL_ReleaseGPUTransferBuffer(manager->gpu_device, manager->transfer_buffer);
+    }
+    SDL_free(manager->headless);
+    SDL_free(manager->requests);
+    SDL_free(manager->copies);
+    SDL_free(manager);
+}
+
+void SetUploadFrameBudget(UploadManager *manager, Uint32 frame_budget)
+{
+    manager->frame_budget = frame_budget;
+}
+
+// Makes room for count more requests, so pushing them can't fail.
+static bool ReserveUploadRequests(UploadManager *manager, Uint32 count)
+{
+    // Slide the live requests back to the front before growing.
+    if (manager->first_request > 0 && manager->first_request + manager->num_requests + count > manager->request_capacity) {
+        SDL_memmove(manager->requests, manager->requests + manager->first_request, manager->num_requests * sizeof(UploadRequest));
+        manager->first_request = 0;
+    }
+    if (manager->num_requests + count > manager->request_capacity) {
+        Uint32 new_capacity = SDL_max(manager->request_capacity * 2, 64u);
+        while (new_capacity < manager->num_requests + count) {
+            new_capacity *= 2;
+        }
+        UploadRequest *requests = static_cast<UploadRequest*>(SDL_realloc(manager->requests, new_capacity * sizeof(UploadRequest)));
+        if (requests == NULL) {
+            return false;
+        }
+        manager->requests = requests;
+        manager->request_capacity = new_capacity;
+    }
+    return true;
+}
+
+static UploadRequest* PushUploadRequest(UploadManager *manager)
+{
+    if (!ReserveUploadRequests(manager, 1)) {
+        return NULL;
+    }
+
+    UploadRequest *request = &manager->requests[manager->first_request + manager->num_requests++];
+    SDL_zerop(request);
+    request->ticket = manager->next_ticket++;
+    return request;
+}
+
+UploadTicket QueueTextureUpload(
+    UploadManager *manager,
+    const void *data,
+    Uint32 size,
+    const SDL_GPUTextureRegion *destination,
+    Uint32 pixels_per_row,
+    Uint32 rows_per_layer,
+    UploadDataReleaseFunction release,
+    void *userdata
+) {
+    // A texture region can't be split, so it has to fit in the ring on its own.
+    // Nothing can be staged for an empty one, which would hold up the queue.
+    if (size == 0 || size > manager->ring.capacity) {
+        SDL_Log("Texture upload of %u bytes is empty or exceeds the %u byte upload ring", size, manager->ring.capacity);
+        if (release != NULL) {
+            release(userdata, data);
+        }
+        return 0;
+    }
+
+    UploadRequest *request = PushUploadRequest(manager);
+    if (request == NULL) {
+        if (release != NULL) {
+            release(userdata, data);
+        }
+        return 0;
+    }
+    request->data = static_cast<const Uint8*>(data);
+    request->size = size;
+    request->texture = destination->texture;
+    request->texture_region = *destination;
+    request->pixels_per_row = pixels_per_row;
+    request->rows_per_layer = rows_per_layer;
+    request->release = release;
+    request->userdata = userdata;
+    request->release_data = data;
+    manager->pending_bytes += size;
+    return request->ticket;
+}
+
+UploadTicket QueueTextureUploads(
+    UploadManager *manager,
+    const void *data,
+    const TextureUploadRegion *regions,
+    Uint32 count,
+    UploadDataReleaseFunction release,
+    void *userdata
+) {
+    // Check everything before queueing anything: a region queued ahead of a
+    // failure would still read data after release had freed it.
+    bool valid = count > 0;
+    for (Uint32 i = 0; i < count && valid; i++) {
+        if (regions[i].size == 0 || regions[i].size > manager->ring.capacity) {
+            SDL_Log("Texture upload %u of %u (%u bytes) is empty or exceeds the %u byte upload ring",
+                    i, count, regions[i].size, manager->ring.capacity);
+            valid = false;
+        }
+    }
+    if (!valid || !ReserveUploadRequests(manager, count)) {
+        if (release != NULL) {
+            release(userdata, data);
+        }
+        return 0;
+    }
+
+    // Uploads stage in order, so only the last one releases the data.
+    UploadRequest *request = NULL;
+    for (Uint32 i = 0; i < count; i++) {
+        request = PushUploadRequest(manager);
+        request->data = static_cast<const Uint8*>(data) + regions[i].offset;
+        request->size = regions[i].size;
+        request->texture = regions[i].destination.texture;
+        request->texture_region = regions[i].destination;
+        manager->pending_bytes += regions[i].size;
+    }
+    request->release = release;
+    request->userdata = userdata;
+    request->release_data = data;
+    return request->ticket;
+}
+
+UploadTicket QueueBufferUpload(
+    UploadManager *manager,
+    const void *data,
+    Uint32 size,
+    SDL_GPUBuffer *buffer,
+    Uint32 buffer_offset,
+    UploadDataReleaseFunction release,
+    void *userdata
+) {
+    if (size == 0) {
+        SDL_Log("Empty buffer upload");
+        if (release != NULL) {
+            release(userdata, data);
+        }
+        return 0;
+    }
+
+    UploadRequest *request = PushUploadRequest(manager);
+    if (request == NULL) {
+        if (release != NULL) {
+            release(userdata, data);
+        }
+        return 0;
+    }
+    request->data = static_cast<const Uint8*>(data);
+    request->size = size;
+    request->buffer = buffer;
+    request->buffer_offset = buffer_offset;
+    request->release = release;
+    request->userdata = userdata;
+    request->release_data = data;
+    manager->pending_bytes += size;
+    return request->ticket;
+}
+
+static UploadCopy* PushUploadCopy(UploadManager *manager, Uint32 *num_copies)
+{
+    if (*num_copies == manager->copy_capacity) {
+        Uint32 new_capacity = SDL_max(manager->copy_capacity * 2, 64u);
+        UploadCopy *copies = static_cast<UploadCopy*>(SDL_realloc(manager->copies, new_capacity * sizeof(UploadCopy)));
+        if (copies == NULL) {
+            return NULL;
+        }
+        manager->copies = copies;
+        manager->copy_capacity = new_capacity;
+    }
+    return &manager->copies[(*num_copies)++];
+}
+
+void FlushUploads(UploadManager *manager)
+{
+    PROFILE_FUNCTION();
+    // Recycle ring space from every frame the GPU has finished with.
+    while (manager->num_frames > 0 &&
+           SDL_QueryGPUFence(manager->gpu_device, manager->frames[manager->first_frame].fence)) {
+        RetireUploadFrame(manager);
+    }
+
+    manager->bytes_last_frame = 0;
+    manager->copies_last_frame = 0;
+    if (manager->num_requests == 0) {
+        return;
+    }
+
+    // Every fence slot busy: the GPU is far behind, so this is the one place we wait.
+    if (manager->num_frames == MAX_UPLOAD_FRAMES_IN_FLIGHT) {
+        SDL_WaitForGPUFences(manager->gpu_device, true, &manager->frames[manager->first_frame].fence, 1);
+        RetireUploadFrame(manager);
+    }
+
+    // Acquired before anything is staged: once a request is staged its ring
+    // space and ticket are committed, so a failure here must leave the queue
+    // as it was for the next frame to retry.
+    SDL_GPUCommandBuffer *command_buffer = NULL;
+    if (manager->headless == NULL) {
+        command_buffer = SDL_AcquireGPUCommandBuffer(manager->gpu_device);
+        if (command_buffer == NULL) {
+            SDL_Log("AcquireGPUCommandBuffer failed, retrying uploads next frame: %s", SDL_GetError());
+            return;
+        }
+    }
+
+    Uint8 *mapped = NULL;
+    Uint32 num_copies = 0;
+    Uint64 budget_used = 0;
+
+    while (manager->num_requests > 0) {
+        UploadRequest *request = &manager->requests[manager->first_request];
+        Uint32 remaining = request->size - request->consumed;
+        Uint64 budget_left = manager->frame_budget == 0 ? SDL_MAX_UINT64 :
+                             manager->frame_budget > budget_used ? manager->frame_budget - budget_used : 0;
+
+        // Textures go whole; the first upload of a frame may exceed the budget so it still makes progress.
+        Uint32 chunk = remaining;
+        if (request->buffer != NULL) {
+            chunk = (Uint32)SDL_min((Uint64)SDL_min(remaining, manager->ring.capacity), budget_left);
+        } else if (chunk > budget_left && budget_used > 0) {
+            break;
+        }
+        if (chunk == 0) {
+            break;
+        }
+
+        Uint32 ring_offset;
+        Uint32 alignment = request->texture != NULL ? TEXTURE_UPLOAD_ALIGNMENT : BUFFER_UPLOAD_ALIGNMENT;
+        if (!UploadRingAllocate(&manager->ring, chunk, alignment, &ring_offset)) {
+            break;  // Ring full until an earlier frame's fence signals
+        }
+
+        if (mapped == NULL && manager->headless != NULL) {
+            mapped = manager->headless;
+        } else if (mapped == NULL) {
+            // cycle=false: the regions the GPU may still be reading are never written.
+            mapped = static_cast<Uint8*>(SDL_MapGPUTransferBuffer(manager->gpu_device, manager->transfer_buffer, false));
+            if (mapped == NULL) {
+                SDL_Log("Failed to map upload ring! %s", SDL_GetError());
+                break;
+            }
+        }
+
+        UploadCopy *copy = PushUploadCopy(manager, &num_copies);
+        if (copy == NULL) {
+            break;
+        }
+        SDL_memcpy(mapped + ring_offset, request->data + request->consumed, chunk);
+
+        copy->ring_offset = ring_offset;
+        copy->size = chunk;
+        copy->texture_region = request->texture_region;
+        copy->pixels_per_row = request->pixels_per_row;
+        copy->rows_per_layer = request->rows_per_layer;
+        copy->buffer = request->buffer;
+        copy->buffer_offset = request->buffer_offset + request->consumed;
+
+        request->consumed += chunk;
+        budget_used += chunk;
+        manager->pending_bytes -= chunk;
+
+        if (request->consumed == request->size) {
+            manager->staged_ticket = request->ticket;
+            ReleaseRequestData(request);
+            manager->first_request++;
+            manager->num_requests--;
+        }
+    }
+
+    if (manager->num_requests == 0) {
+        manager->first_request = 0;
+    }
+    if (mapped != NULL && manager->headless == NULL) {
+        SDL_UnmapGPUTransferBuffer(manager->gpu_device, manager->transfer_buffer);
+    }
+    if (num_copies == 0) {
+        if (command_buffer != NULL) {
+            SDL_CancelGPUCommandBuffer(command_buffer);
+        }
+        return;
+    }
+
+    UploadFrame *frame = &manager->frames[(manager->first_frame + manager->num_frames) % MAX_UPLOAD_FRAMES_IN_FLIGHT];
+    frame->fence = NULL;
+    frame->ring_position = manager->ring.head;
+    frame->last_ticket = manager->staged_ticket;
+    if (command_buffer != NULL) {
+        SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(command_buffer);
+        for (Uint32 i = 0; i < num_copies; i++) {
+            const UploadCopy *copy = &manager->copies[i];
+            if (copy->buffer != NULL) {
+                SDL_GPUTransferBufferLocation source = {
+                    .transfer_buffer = manager->transfer_buffer,
+                    .offset = copy->ring_offset
+                };
+                SDL_GPUBufferRegion destination = {
+                    .buffer = copy->buffer,
+                    .offset = copy->buffer_offset,
+                    .size = copy->size
+                };
+                SDL_UploadToGPUBuffer(copy_pass, &source, &destination, false);
+            } else {
+                SDL_GPUTextureTransferInfo source = {
+                    .transfer_buffer = manager->transfer_buffer,
+                    .offset = copy->ring_offset,
+                    .pixels_per_row = copy->pixels_per_row,
+                    .rows_per_layer = copy->rows_per_layer
+                };
+                SDL_UploadToGPUTexture(copy_pass, &source, &copy->texture_region, false);
+            }
+        }
+        SDL_EndGPUCopyPass(copy_pass);
+
+        frame->fence = SDL_SubmitGPUCommandBufferAndAcquireFence(command_buffer);
+        if (frame->fence == NULL) {
+            // Without a fence we can't know when the region is free; wait it out instead of leaking ring space.
+            SDL_Log("Upload submit failed: %s", SDL_GetError());
+            SDL_WaitForGPUIdle(manager->gpu_device);
+        }
+    }
+    manager->ring_high_water = SDL_max(manager->ring_high_water, GetUploadRingUsed(&manager->ring));
+    if (frame->fence == NULL) {
+        // Headless, or the GPU was waited out: the copies are as good as done
+        UploadRingRelease(&manager->ring, frame->ring_position);
+        manager->completed_ticket = frame->last_ticket;
+    } else {
+        manager->num_frames++;
+    }
+    manager->bytes_last_frame = budget_used;
+    manager->copies_last_frame = num_copies;
+}
+
+bool IsUploadStaged(const UploadManager *manager, UploadTicket ticket)
+{
+    return ticket != 0 && ticket <= manager->staged_ticket;
+}
+
+bool IsUploadComplete(const UploadManager *manager, UploadTicket ticket)
+{
+    return ticket != 0 && ticket <= manager->completed_ticket;
+}
+
+UploadManagerStats GetUploadManagerStats(const UploadManager *manager)
+{
+    UploadManagerStats stats;
+    stats.ring_capacity = manager->ring.capacity;
+    stats.ring_used = GetUploadRingUsed(&manager->ring);
+    stats.ring_high_water = manager->ring_high_water;
+    stats.pending_uploads = manager->num_requests;
+    stats.pending_bytes = manager->pending_bytes;
+    stats.bytes_last_frame = manager->bytes_last_frame;
+    stats.copies_last_frame = manager->copies_last_frame;
+    stats.frames_in_flight = manager->num_frames;
+    return stats;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// Central streaming path for texture and buffer uploads. One large transfer
+// buffer is used as a ring: each upload gets an aligned region, all uploads
+// staged in a frame go out in a single copy pass, and regions come back once
+// the fence of the frame that used them signals. A per-frame byte budget
+// spreads big loads (a level's worth of textures) over several frames.
+
+// Ring bookkeeping, kept separate from the GPU objects so the allocation,
+// wraparound and release logic can be exercised without a device. Positions
+// are running byte counts; offset = position % capacity.
+typedef struct UploadRing
+{
+    Uint32 capacity;
+    Uint64 head;    // End of the newest allocation (wrap padding included)
+    Uint64 tail;    // Everything before this has been released
+} UploadRing;
+
+void InitUploadRing(UploadRing *ring, Uint32 capacity);
+// alignment must be a power of two that divides the capacity.
+bool UploadRingAllocate(UploadRing *ring, Uint32 size, Uint32 alignment, Uint32 *offset);
+// Releases every allocation that ended at or before position (a past head).
+void UploadRingRelease(UploadRing *ring, Uint64 position);
+Uint32 GetUploadRingUsed(const UploadRing *ring);
+
+// Called once the upload's bytes have been copied into the ring (or the
+// upload was dropped), so the source data can be freed. May be NULL.
+typedef void (*UploadDataReleaseFunction)(void *userdata, const void *data);
+
+typedef Uint64 UploadTicket;
+
+typedef struct UploadManagerStats
+{
+    Uint32 ring_capacity;
+    Uint32 ring_used;
+    Uint32 ring_high_water;
+    Uint32 pending_uploads;
+    Uint64 pending_bytes;
+    Uint64 bytes_last_frame;
+    Uint32 copies_last_frame;
+    Uint32 frames_in_flight;
+} UploadManagerStats;
+
+typedef struct UploadManager UploadManager;
+
+// gpu_device may be NULL: the ring is then plain memory and each flush's
+// copies count as complete at once, for tools and benchmarks.
+UploadManager* CreateUploadManager(SDL_GPUDevice *gpu_device, Uint32 ring_size, Uint32 frame_budget);
+// Waits for in-flight uploads, then drops (and releases) anything still queued.
+void DestroyUploadManager(UploadManager *manager);
+
+// 0 disables the budget.
+void SetUploadFrameBudget(UploadManager *manager, Uint32 frame_budget);
+
+// data must stay valid until release is called. Uploads are staged in the
+// order they were queued. Empty uploads are refused: 0 is returned and
+// release is called at once, as for any other upload that can't be queued. Texture data is laid out as SDL_UploadToGPUTexture
+// expects for destination (pixels_per_row / rows_per_layer of 0 mean tightly packed).
+UploadTicket QueueTextureUpload(
+    UploadManager *manager,
+    const void *data,
+    Uint32 size,
+    const SDL_GPUTextureRegion *destination,
+    Uint32 pixels_per_row,
+    Uint32 rows_per_layer,
+    UploadDataReleaseFunction release,
+    void *userdata
+);
+
+// One subresource of a texture, tightly packed at offset into the data shared
+// by all of them.
+typedef struct TextureUploadRegion
+{
+    Uint64 offset;
+    Uint32 size;
+    SDL_GPUTextureRegion destination;
+} TextureUploadRegion;
+
+// A texture's mips and layers from one block of data, queued all or nothing:
+// if any region is empty or doesn't fit the ring, none is queued, release is
+// called and 0 returned. Otherwise release is called once, after the last
+// region is staged, and the ticket returned completes with the whole texture.
+UploadTicket QueueTextureUploads(
+    UploadManager *manager,
+    const void *data,
+    const TextureUploadRegion *regions,
+    Uint32 count,
+    UploadDataReleaseFunction release,
+    void *userdata
+);
+
+// Buffer uploads larger than the frame budget are split across frames.
+UploadTicket QueueBufferUpload(
+    UploadManager *manager,
+    const void *data,
+    Uint32 size,
+    SDL_GPUBuffer *buffer,
+    Uint32 buffer_offset,
+    UploadDataReleaseFunction release,
+    void *userdata
+);
+
+// Once per frame, before the frame's own command buffer is submitted: recycles
+// ring space from finished frames, stages queued uploads up to the budget and
+// submits them in one copy pass. Never waits on the GPU unless every fence
+// slot is busy.
+void FlushUploads(UploadManager *manager);
+
+// Staged: copied into the ring, source data released. Complete: the copy has
+// executed on the GPU and the destination can be sampled.
+bool IsUploadStaged(const UploadManager *manager, UploadTicket ticket);
+bool IsUploadComplete(const UploadManager *manager, UploadTicket ticket);
+
+UploadManagerStats GetUploadManagerStats(const UploadManager *manager);
@@ -0,0 +1,206 @@
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+
+#include "bc6h.hpp"
+
+#define BC6H_MODE_11 0x03
+#define BC6H_ENDPOINT_BITS 10
+#define BC6H_MAX_QUANTIZED ((1 << BC6H_ENDPOINT_BITS) - 1)
+#define HALF_MAX_FINITE 0x7BFF
+
+static const int BC6H_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// The decoder's rules for unsigned BC6H: quantized endpoint -> 16-bit, then
+// interpolated, then scaled by 31/64 into half bits.
+static int Unquantize(int quantized)
+{
+    if (quantized == 0) {
+        return 0;
+    }
+    if (quantized == BC6H_MAX_QUANTIZED) {
+        return 0xFFFF;
+    }
+    return ((quantized << 16) + 0x8000) >> BC6H_ENDPOINT_BITS;
+}
+
+static int Interpolate(int unquantized0, int unquantized1, int weight)
+{
+    int value = ((64 - weight) * unquantized0 + weight * unquantized1 + 32) >> 6;
+    return (value * 31) >> 6;
+}
+
+// Quantized endpoint whose decoded value is closest to the target half bits.
+static int QuantizeEndpoint(int target)
+{
+    int guess = SDL_clamp(target / 31, 0, BC6H_MAX_QUANTIZED);
+    int best = guess;
+    int best_error = SDL_abs(Interpolate(Unquantize(guess), 0, 0) - target);
+    for (int candidate = SDL_max(guess - 1, 0); candidate <= SDL_min(guess + 1, BC6H_MAX_QUANTIZED); candidate++) {
+        int error = SDL_abs(Interpolate(Unquantize(candidate), 0, 0) - target);
+        if (error < best_error) {
+            best = candidate;
+            best_error = error;
+        }
+    }
+    return best;
+}
+
+static void WriteBits(Uint8 *block, int *position, Uint32 value, int count)
+{
+    for (int i = 0; i < count; i++, (*position)++) {
+        if (value & (1u << i)) {
+            block[*position >> 3] |= (Uint8)(1u << (*position & 7));
+        }
+    }
+}
+
+// Picks the best index for every texel against the decoded palette of the
+// given endpoints. Returns the total squared error.
+static Sint64 FitIndices(const int texels[16][3], const int endpoints[2][3], int indices[16])
+{
+    // Half bit patterns are roughly logarithmic, which is the space the
+    // hardware interpolates in, so the error is measured there too.
+    int palette[16][3];
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            palette[i][c] = Interpolate(Unquantize(endpoints[0][c]), Unquantize(endpoints[1][c]), BC6H_WEIGHTS[i]);
+        }
+    }
+
+    Sint64 total_error = 0;
+    for (int i = 0; i < 16; i++) {
+        Sint64 best_error = SDL_MAX_SINT64;
+        for (int index = 0; index < 16; index++) {
+            Sint64 error = 0;
+            for (int c = 0; c < 3; c++) {
+                Sint64 delta = palette[index][c] - texels[i][c];
+                error += delta * delta;
+            }
+            if (error < best_error) {
+                best_error = error;
+                indices[i] = index;
+            }
+        }
+        total_error += best_error;
+    }
+    return total_error;
+}
+
+static void EncodeBlock(const int texels[16][3], Uint8 *block)
+{
+    int low[3] = { HALF_MAX_FINITE, HALF_MAX_FINITE, HALF_MAX_FINITE };
+    int high[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            low[c] = SDL_min(low[c], texels[i][c]);
+            high[c] = SDL_max(high[c], texels[i][c]);
+        }
+    }
+
+    // Start from the bounding box corners...
+    int endpoints[2][3];
+    for (int c = 0; c < 3; c++) {
+        endpoints[0][c] = QuantizeEndpoint(low[c]);
+        endpoints[1][c] = QuantizeEndpoint(high[c]);
+    }
+    int indices[16];
+    Sint64 error = FitIndices(texels, endpoints, indices);
+
+    // ...then refit the endpoints to the chosen weights by least squares and
+    // keep the result if it decodes closer.
+    double sum_aa = 0.0, sum_ab = 0.0, sum_bb = 0.0;
+    for (int i = 0; i < 16; i++) {
+        double t = BC6H_WEIGHTS[indices[i]] / 64.0;
+        sum_aa += (1.0 - t) * (1.0 - t);
+        sum_ab += (1.0 - t) * t;
+        sum_bb += t * t;
+    }
+    double determinant = sum_aa * sum_bb - sum_ab * sum_ab;
+    if (determinant > 1e-6) {
+        int refit[2][3];
+        for (int c = 0; c < 3; c++) {
+            double sum_ax = 0.0, sum_bx = 0.0;
+            for (int i = 0; i < 16; i++) {
+                double t = BC6H_WEIGHTS[indices[i]] / 64.0;
+                sum_ax += (1.0 - t) * texels[i][c];
+                sum_bx += t * texels[i][c];
+            }
+            double a = (sum_bb * sum_ax - sum_ab * sum_bx) / determinant;
+            double b = (sum_aa * sum_bx - sum_ab * sum_ax) / determinant;
+            refit[0][c] = QuantizeEndpoint(SDL_clamp((int)(a + 0.5), 0, HALF_MAX_FINITE));
+            refit[1][c] = QuantizeEndpoint(SDL_clamp((int)(b + 0.5), 0, HALF_MAX_FINITE));
+        }
+        int refit_indices[16];
+        if (FitIndices(texels, refit, refit_indices) < error) {
+            SDL_memcpy(endpoints, refit, sizeof(endpoints));
+            SDL_memcpy(indices, refit_indices, sizeof(indices));
+        }
+    }
+
+    // The first index is stored with an implicit 0 top bit; the weights are
+    // symmetric, so swapping the endpoints and mirroring the indices fixes it.
+    if (indices[0] & 8) {
+        for (int c = 0; c < 3; c++) {
+            int swap = endpoints[0][c];
+            endpoints[0][c] = endpoints[1][c];
+            endpoints[1][c] = swap;
+        }
+        for (int i = 0; i < 16; i++) {
+            indices[i] = 15 - indices[i];
+        }
+    }
+
+    SDL_memset(block, 0, 16);
+    int position = 0;
+    WriteBits(block, &position, BC6H_MODE_11, 5);
+    for (int e = 0; e < 2; e++) {
+        for (int c = 0; c < 3; c++) {
+            WriteBits(block, &position, (Uint32)endpoints[e][c], BC6H_ENDPOINT_BITS);
+        }
+    }
+    WriteBits(block, &position, (Uint32)indices[0], 3);
+    for (int i = 1; i < 16; i++) {
+        WriteBits(block, &position, (Uint32)indices[i], 4);
+    }
+    SDL_assert(position == 128);
+}
+
+typedef struct BC6HJob
+{
+    const Uint16 *rgba;
+    Uint32 width;
+    Uint32 height;
+    Uint8 *blocks;
+} BC6HJob;
+
+static void EncodeBlockRow(Uint32 block_y, void *userdata)
+{
+    BC6HJob *job = static_cast<BC6HJob*>(userdata);
+    Uint32 blocks_wide = (job->width + 3) / 4;
+
+    for (Uint32 block_x = 0; block_x < blocks_wide; block_x++) {
+        // Partial edge blocks repeat the last row/column.
+        int texels[16][3];
+        for (int i = 0; i < 16; i++) {
+            Uint32 x = SDL_min(block_x * 4 + (i & 3), job->width - 1);
+            Uint32 y = SDL_min(block_y * 4 + (i >> 2), job->height - 1);
+            const Uint16 *texel = job->rgba + ((size_t)y * job->width + x) * 4;
+            for (int c = 0; c < 3; c++) {
+                int half = texel[c];
+                texels[i][c] = (half & 0x8000) ? 0 : SDL_min(half, HALF_MAX_FINITE);
+            }
+        }
+        EncodeBlock(texels, job->blocks + ((size_t)block_y * blocks_wide + block_x) * 16);
+    }
+}
+
+void EncodeBC6H(const Uint16 *rgba, Uint32 width, Uint32 height, JobSystem *jobs, Uint8 *blocks)
+{
+    BC6HJob job = { rgba, width, height, blocks };
+    ParallelFor(jobs, (height + 3) / 4, EncodeBlockRow, &job);
+}
+
+Uint64 GetBC6HSize(Uint32 width, Uint32 height)
+{
+    return (Uint64)((width + 3) / 4) * ((height + 3) / 4) * 16;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+#include <jobs.hpp>
+
+// Offline BC6H_UF16 encoder for the cooker. Each 4x4 block uses mode 11: one
+// subset with 10-bit endpoints and 4-bit indices. That is the simplest mode,
+// not the best, but it is exact about the format's unquantize/interpolate
+// rules and picks every index by measuring the decoded result, so the output
+// is what a GPU will reconstruct.
+//
+// rgba is RGBA16F (alpha ignored, negatives clamped to 0), width * height
+// texels. blocks receives ceil(w/4) * ceil(h/4) 16-byte blocks, row by row.
+// Block rows are encoded as jobs; jobs may be NULL.
+void EncodeBC6H(const Uint16 *rgba, Uint32 width, Uint32 height, JobSystem *jobs, Uint8 *blocks);
+
+Uint64 GetBC6HSize(Uint32 width, Uint32 height);
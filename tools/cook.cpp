@@ -0,0 +1,776 @@
+// Offline asset cooker. Converts the loose files under assets/ into a single
+// pack (see src/asset_pack.hpp) that the game maps and reads in place.
+//
+//   AssetCooker <assets dir> <output pack>
+//   AssetCooker --bench <assets dir> <pack>
+//   AssetCooker --check-shaders <assets dir>
+//
+// The bench mode compares the pack against the loose-file loaders, cold (page
+// cache dropped for every file first, Linux only) and warm. The check mode
+// reflects every shipped compute shader and compares the thread and binding
+// counts the pipelines are built from against the ones the sources declare.
+
+#include <SDL3/SDL.h>
+#include <SDL3_shadercross/SDL_shadercross.h>
+#include <asset_pack.hpp>
+#include <hdr_image.hpp>
+#include <jobs.hpp>
+#include <mesh.hpp>
+#include <mipmap.hpp>
+
+#include "bc6h.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+typedef struct CookedAsset
+{
+    std::string name;       // "assets/..." exactly as the runtime loaders are called
+    AssetPackType type;
+    std::vector<Uint8> payload;
+} CookedAsset;
+
+typedef struct CookContext
+{
+    std::vector<std::string> files;
+    std::vector<CookedAsset> assets;
+    int skipped;
+    JobSystem *jobs;        // Mips and BC6H blocks; NULL cooks on one thread
+} CookContext;
+
+static SDL_EnumerationResult CollectFile(void *userdata, const char *dirname, const char *fname)
+{
+    std::vector<std::string> *files = static_cast<std::vector<std::string>*>(userdata);
+    std::string path = std::string(dirname) + fname;
+
+    SDL_PathInfo info;
+    if (SDL_GetPathInfo(path.c_str(), &info)) {
+        if (info.type == SDL_PATHTYPE_DIRECTORY) {
+            SDL_EnumerateDirectory(path.c_str(), CollectFile, userdata);
+        } else if (info.type == SDL_PATHTYPE_FILE) {
+            files->push_back(path);
+        }
+    }
+    return SDL_ENUM_CONTINUE;
+}
+
+static bool EndsWith(const std::string &text, const char *suffix)
+{
+    size_t length = SDL_strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+static void AlignPayload(std::vector<Uint8> &payload, size_t alignment)
+{
+    payload.resize((payload.size() + alignment - 1) & ~(alignment - 1), 0);
+}
+
+// ---------------------------------------------------------------------------
+// Images
+// ---------------------------------------------------------------------------
+
+static bool CookImage(CookContext *context, const std::string &path, const std::string &name)
+{
+    SDL_Surface *loaded = SDL_LoadBMP(path.c_str());
+    if (loaded == NULL) {
+        SDL_Log("Failed to load BMP %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    // ABGR8888 is R,G,B,A in memory: the byte order of SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM.
+    SDL_Surface *surface = loaded;
+    if (loaded->format != SDL_PIXELFORMAT_ABGR8888) {
+        surface = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_ABGR8888);
+        SDL_DestroySurface(loaded);
+        if (surface == NULL) {
+            SDL_Log("Failed to convert %s: %s", path.c_str(), SDL_GetError());
+            return false;
+        }
+    }
+
+    // The images are all colour, so the chain is filtered in linear light and
+    // tagged sRGB; the Kaiser filter is too slow for load time but keeps
+    // distant mips sharper than a box.
+    MipChain mips;
+    bool generated = GenerateMipChain(surface->pixels, (Uint32)surface->w, (Uint32)surface->h, (Uint32)surface->pitch,
+                                      true, MIP_FILTER_KAISER, ASSET_PACK_MAX_MIPS, context->jobs, &mips);
+    SDL_DestroySurface(surface);
+    if (!generated) {
+        SDL_Log("Failed to generate mips for %s", path.c_str());
+        return false;
+    }
+
+    CookedAsset asset;
+    asset.name = name;
+    asset.type = ASSET_PACK_TYPE_IMAGE;
+
+    AssetPackImage image;
+    SDL_zero(image);
+    image.width = mips.mip_widths[0];
+    image.height = mips.mip_heights[0];
+    image.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB;
+    image.num_mips = mips.num_mips;
+
+    asset.payload.resize(sizeof(AssetPackImage));
+    for (Uint32 mip = 0; mip < mips.num_mips; mip++) {
+        AlignPayload(asset.payload, ASSET_PACK_ALIGNMENT);
+        image.mip_offsets[mip] = (Uint32)asset.payload.size();
+        image.mip_sizes[mip] = (Uint32)mips.mip_sizes[mip];
+        asset.payload.insert(asset.payload.end(), mips.pixels + mips.mip_offsets[mip],
+                             mips.pixels + mips.mip_offsets[mip] + mips.mip_sizes[mip]);
+    }
+    FreeMipChain(&mips);
+
+    SDL_memcpy(asset.payload.data(), &image, sizeof(image));
+    context->assets.push_back(std::move(asset));
+    return true;
+}
+
+// Radiance .hdr environment maps are stored as BC6H: 1 byte per texel instead of 8 for RGBA16F.
+static bool CookHDRImage(CookContext *context, const std::string &path, const std::string &name)
+{
+    size_t file_size;
+    void *file_data = SDL_LoadFile(path.c_str(), &file_size);
+    if (file_data == NULL) {
+        SDL_Log("Failed to read %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    HDRImage decoded;
+    bool decoded_ok = DecodeHDR(file_data, file_size, HDR_PIXELFORMAT_RGBA16F, context->jobs, &decoded);
+    SDL_free(file_data);
+    if (!decoded_ok) {
+        SDL_Log("Failed to decode %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    CookedAsset asset;
+    asset.name = name;
+    asset.type = ASSET_PACK_TYPE_IMAGE;
+
+    AssetPackImage image;
+    SDL_zero(image);
+    image.width = decoded.width;
+    image.height = decoded.height;
+    image.format = SDL_GPU_TEXTUREFORMAT_BC6H_RGB_UFLOAT;
+    image.num_mips = 1;
+
+    asset.payload.resize(sizeof(AssetPackImage));
+    AlignPayload(asset.payload, ASSET_PACK_ALIGNMENT);
+    image.mip_offsets[0] = (Uint32)asset.payload.size();
+    image.mip_sizes[0] = (Uint32)GetBC6HSize(decoded.width, decoded.height);
+    asset.payload.resize(image.mip_offsets[0] + image.mip_sizes[0]);
+
+    EncodeBC6H(static_cast<const Uint16*>(decoded.pixels), decoded.width, decoded.height, context->jobs,
+                &asset.payload[image.mip_offsets[0]]);
+    FreeHDRImage(&decoded);
+
+    SDL_memcpy(asset.payload.data(), &image, sizeof(image));
+    context->assets.push_back(std::move(asset));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Meshes
+// ---------------------------------------------------------------------------
+
+// OBJ meshes are reordered for the vertex cache, overdraw and fetch, then
+// quantized to PackedMeshVertex with 16-bit indices where they fit.
+static bool CookMesh(CookContext *context, const std::string &path, const std::string &name)
+{
+    Mesh mesh;
+    if (!LoadOBJ(path.c_str(), &mesh)) {
+        SDL_Log("Failed to load %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+    MeshStats before = AnalyzeMesh(mesh.indices, mesh.num_indices, mesh.num_vertices, sizeof(MeshVertex));
+    if (!OptimizeMesh(&mesh)) {
+        SDL_Log("Failed to optimize %s: %s", path.c_str(), SDL_GetError());
+        FreeMesh(&mesh);
+        return false;
+    }
+    MeshStats after = AnalyzeMesh(mesh.indices, mesh.num_indices, mesh.num_vertices, sizeof(PackedMeshVertex));
+
+    MeshQuantization quantization;
+    ComputeMeshQuantization(mesh.vertices, mesh.num_vertices, &quantization);
+
+    CookedAsset asset;
+    asset.name = name;
+    asset.type = ASSET_PACK_TYPE_MESH;
+
+    AssetPackMesh packed;
+    SDL_zero(packed);
+    packed.num_vertices = mesh.num_vertices;
+    packed.num_indices = mesh.num_indices;
+    packed.index_size = mesh.num_vertices <= 0x10000 ? sizeof(Uint16) : sizeof(Uint32);
+    packed.vertex_stride = sizeof(PackedMeshVertex);
+    SDL_memcpy(packed.position_offset, quantization.offset, sizeof(packed.position_offset));
+    SDL_memcpy(packed.position_scale, quantization.scale, sizeof(packed.position_scale));
+
+    asset.payload.resize(sizeof(AssetPackMesh));
+    AlignPayload(asset.payload, 16);
+    packed.vertices_offset = (Uint32)asset.payload.size();
+    asset.payload.resize(packed.vertices_offset + mesh.num_vertices * sizeof(PackedMeshVertex));
+    PackMeshVertices(mesh.vertices, mesh.num_vertices, &quantization, reinterpret_cast<PackedMeshVertex*>(&asset.payload[packed.vertices_offset]));
+
+    AlignPayload(asset.payload, 16);
+    packed.indices_offset = (Uint32)asset.payload.size();
+    asset.payload.resize(packed.indices_offset + mesh.num_indices * packed.index_size);
+    for (Uint32 i = 0; i < mesh.num_indices; i++) {
+        if (packed.index_size == sizeof(Uint16)) {
+            Uint16 index = (Uint16)mesh.indices[i];
+            SDL_memcpy(&asset.payload[packed.indices_offset + i * sizeof(Uint16)], &index, sizeof(index));
+        } else {
+            SDL_memcpy(&asset.payload[packed.indices_offset + i * sizeof(Uint32)], &mesh.indices[i], sizeof(Uint32));
+        }
+    }
+
+    SDL_Log("%s: %u triangles, ACMR %.2f -> %.2f, %u -> %u bytes", name.c_str(), mesh.num_indices / 3, before.acmr, after.acmr,
+            (Uint32)(mesh.num_vertices * sizeof(MeshVertex) + mesh.num_indices * sizeof(Uint32)), (Uint32)asset.payload.size());
+    FreeMesh(&mesh);
+    SDL_memcpy(asset.payload.data(), &packed, sizeof(packed));
+    context->assets.push_back(std::move(asset));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Shaders
+// ---------------------------------------------------------------------------
+
+static void AddShaderCode(AssetPackShader *shader, std::vector<Uint8> &payload, SDL_GPUShaderFormat format, const char *entry_point, const void *code, size_t size)
+{
+    AlignPayload(payload, 16);
+    AssetPackShaderCode *slot = &shader->code[shader->num_formats++];
+    slot->format = format;
+    slot->offset = (Uint32)payload.size();
+    slot->size = (Uint32)size;
+    SDL_strlcpy(slot->entry_point, entry_point, sizeof(slot->entry_point));
+    payload.insert(payload.end(), static_cast<const Uint8*>(code), static_cast<const Uint8*>(code) + size);
+}
+
+static bool CookShader(CookContext *context, const std::string &path, const std::string &name)
+{
+    SDL_ShaderCross_ShaderStage stage;
+    if (EndsWith(name, ".vert")) {
+        stage = SDL_SHADERCROSS_SHADERSTAGE_VERTEX;
+    } else if (EndsWith(name, ".frag")) {
+        stage = SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
+    } else if (EndsWith(name, ".comp")) {
+        stage = SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
+    } else {
+        SDL_Log("Invalid shader stage for %s", path.c_str());
+        return false;
+    }
+
+    size_t source_size;
+    char *source = static_cast<char*>(SDL_LoadFile(path.c_str(), &source_size));
+    if (source == NULL) {
+        SDL_Log("Failed to load shader source %s", path.c_str());
+        return false;
+    }
+
+    std::string include_dir = path.substr(0, path.find_last_of("/\\"));
+
+    SDL_ShaderCross_HLSL_Info hlsl_info;
+    SDL_zero(hlsl_info);
+    hlsl_info.source = source;
+    hlsl_info.entrypoint = "main";
+    hlsl_info.include_dir = include_dir.c_str();
+    hlsl_info.shader_stage = stage;
+    hlsl_info.name = path.c_str();
+
+    size_t spirv_size = 0;
+    Uint8 *spirv = static_cast<Uint8*>(SDL_ShaderCross_CompileSPIRVFromHLSL(&hlsl_info, &spirv_size));
+    if (spirv == NULL) {
+        SDL_Log("Failed to compile %s: %s", path.c_str(), SDL_GetError());
+        SDL_free(source);
+        return false;
+    }
+
+    CookedAsset asset;
+    asset.name = name;
+    asset.type = ASSET_PACK_TYPE_SHADER;
+
+    AssetPackShader shader;
+    SDL_zero(shader);
+    shader.stage = stage;
+
+    // Resource counts come from reflection so the runtime never has to reflect.
+    if (stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+        SDL_ShaderCross_ComputePipelineMetadata *metadata = SDL_ShaderCross_ReflectComputeSPIRV(spirv, spirv_size, 0);
+        if (metadata == NULL) {
+            SDL_Log("Failed to reflect %s: %s", path.c_str(), SDL_GetError());
+            SDL_free(spirv);
+            SDL_free(source);
+            return false;
+        }
+        shader.num_samplers = metadata->num_samplers;
+        shader.num_uniform_buffers = metadata->num_uniform_buffers;
+        shader.num_readonly_storage_textures = metadata->num_readonly_storage_textures;
+        shader.num_readonly_storage_buffers = metadata->num_readonly_storage_buffers;
+        shader.num_readwrite_storage_textures = metadata->num_readwrite_storage_textures;
+        shader.num_readwrite_storage_buffers = metadata->num_readwrite_storage_buffers;
+        shader.threadcount_x = metadata->threadcount_x;
+        shader.threadcount_y = metadata->threadcount_y;
+        shader.threadcount_z = metadata->threadcount_z;
+        SDL_free(metadata);
+    } else {
+        SDL_ShaderCross_GraphicsShaderMetadata *metadata = SDL_ShaderCross_ReflectGraphicsSPIRV(spirv, spirv_size, 0);
+        if (metadata == NULL) {
+            SDL_Log("Failed to reflect %s: %s", path.c_str(), SDL_GetError());
+            SDL_free(spirv);
+            SDL_free(source);
+            return false;
+        }
+        shader.num_samplers = metadata->num_samplers;
+        shader.num_uniform_buffers = metadata->num_uniform_buffers;
+        shader.num_storage_textures = metadata->num_storage_textures;
+        shader.num_storage_buffers = metadata->num_storage_buffers;
+        SDL_free(metadata);
+    }
+
+    asset.payload.resize(sizeof(AssetPackShader));
+    AddShaderCode(&shader, asset.payload, SDL_GPU_SHADERFORMAT_SPIRV, "main", spirv, spirv_size);
+
+    size_t dxil_size = 0;
+    void *dxil = SDL_ShaderCross_CompileDXILFromHLSL(&hlsl_info, &dxil_size);
+    if (dxil != NULL) {
+        AddShaderCode(&shader, asset.payload, SDL_GPU_SHADERFORMAT_DXIL, "main", dxil, dxil_size);
+        SDL_free(dxil);
+    } else {
+        SDL_Log("No DXIL for %s on this host, D3D12 will fall back to the loose loader", name.c_str());
+    }
+
+    SDL_ShaderCross_SPIRV_Info spirv_info;
+    SDL_zero(spirv_info);
+    spirv_info.bytecode = spirv;
+    spirv_info.bytecode_size = spirv_size;
+    spirv_info.entrypoint = "main";
+    spirv_info.shader_stage = stage;
+    spirv_info.name = path.c_str();
+
+    // SPIRV-Cross renames main to main0 for Metal, matching LoadShader.
+    char *msl = static_cast<char*>(SDL_ShaderCross_TranspileMSLFromSPIRV(&spirv_info));
+    if (msl != NULL) {
+        AddShaderCode(&shader, asset.payload, SDL_GPU_SHADERFORMAT_MSL, "main0", msl, SDL_strlen(msl) + 1);
+        SDL_free(msl);
+    }
+
+    SDL_memcpy(asset.payload.data(), &shader, sizeof(shader));
+    context->assets.push_back(std::move(asset));
+
+    SDL_free(spirv);
+    SDL_free(source);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Pack writer
+// ---------------------------------------------------------------------------
+
+static bool WritePack(CookContext *context, const char *output_path)
+{
+    std::sort(context->assets.begin(), context->assets.end(),
+              [](const CookedAsset &a, const CookedAsset &b) { return a.name < b.name; });
+
+    std::vector<Uint8> pack(sizeof(AssetPackHeader));
+    std::vector<AssetPackEntry> entries;
+    std::string names;
+
+    for (const CookedAsset &asset : context->assets) {
+        AlignPayload(pack, ASSET_PACK_ALIGNMENT);
+
+        AssetPackEntry entry;
+        entry.name_offset = (Uint32)names.size();
+        entry.type = asset.type;
+        entry.offset = pack.size();
+        entry.size = asset.payload.size();
+        entries.push_back(entry);
+
+        names.append(asset.name);
+        names.push_back('\0');
+        pack.insert(pack.end(), asset.payload.begin(), asset.payload.end());
+    }
+
+    AlignPayload(pack, ASSET_PACK_ALIGNMENT);
+    AssetPackHeader header;
+    SDL_zero(header);
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.num_entries = (Uint32)entries.size();
+    header.toc_offset = pack.size();
+    pack.insert(pack.end(), reinterpret_cast<const Uint8*>(entries.data()),
+                reinterpret_cast<const Uint8*>(entries.data() + entries.size()));
+    header.names_offset = pack.size();
+    pack.insert(pack.end(), names.begin(), names.end());
+    header.file_size = pack.size();
+    SDL_memcpy(pack.data(), &header, sizeof(header));
+
+    // Write next to the destination and rename so a running game never maps a partial pack.
+    std::string temp_path = std::string(output_path) + ".tmp";
+    if (!SDL_SaveFile(temp_path.c_str(), pack.data(), pack.size()) || !SDL_RenamePath(temp_path.c_str(), output_path)) {
+        SDL_Log("Failed to write %s: %s", output_path, SDL_GetError());
+        SDL_RemovePath(temp_path.c_str());
+        return false;
+    }
+
+    SDL_Log("Cooked %u assets (%d skipped) into %s, %.2f MB",
+            header.num_entries, context->skipped, output_path, pack.size() / (1024.0 * 1024.0));
+    return true;
+}
+
+static bool Cook(const char *assets_dir, const char *output_path)
+{
+    CookContext context;
+    context.skipped = 0;
+    context.jobs = CreateJobSystem(-1);
+
+    std::string root = assets_dir;
+    while (!root.empty() && (root.back() == '/' || root.back() == '\\')) {
+        root.pop_back();
+    }
+    // Names are rooted at "assets/" like the loaders' arguments, whatever the directory is called on disk.
+    SDL_EnumerateDirectory(root.c_str(), CollectFile, &context.files);
+    std::sort(context.files.begin(), context.files.end());
+
+    if (!SDL_ShaderCross_Init()) {
+        SDL_Log("ShaderCross failed to initialize!");
+        DestroyJobSystem(context.jobs);
+        return false;
+    }
+
+    bool succeeded = true;
+    for (const std::string &path : context.files) {
+        std::string name = "assets" + path.substr(root.size());
+        std::replace(name.begin(), name.end(), '\\', '/');
+
+        if (EndsWith(name, ".bmp")) {
+            succeeded &= CookImage(&context, path, name);
+        } else if (EndsWith(name, ".hdr")) {
+            succeeded &= CookHDRImage(&context, path, name);
+        } else if (EndsWith(name, ".obj")) {
+            succeeded &= CookMesh(&context, path, name);
+        } else if (EndsWith(name, ".hlsl")) {
+            succeeded &= CookShader(&context, path, name.substr(0, name.size() - 5));
+        } else {
+            context.skipped++;
+        }
+    }
+
+    SDL_ShaderCross_Quit();
+    DestroyJobSystem(context.jobs);
+    return succeeded && WritePack(&context, output_path);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static void DropFromPageCache(const char *path)
+{
+#ifdef __linux__
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+typedef struct BenchAsset
+{
+    std::string name;
+    std::string loose_path;     // Empty when there is no loose equivalent to compare against
+    AssetPackType type;
+} BenchAsset;
+
+// The current runtime path: LoadImage's SDL_LoadBMP + SDL_ConvertSurface, and
+// LoadShader's SDL_LoadFile of the precompiled .spv.
+static Uint64 LoadLoose(const std::vector<BenchAsset> &assets)
+{
+    Uint64 checksum = 0;
+    for (const BenchAsset &asset : assets) {
+        if (asset.type == ASSET_PACK_TYPE_IMAGE) {
+            SDL_Surface *surface = SDL_LoadBMP(asset.loose_path.c_str());
+            if (surface != NULL) {
+                SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
+                if (converted != NULL) {
+                    checksum += static_cast<const Uint8*>(converted->pixels)[0];
+                    SDL_DestroySurface(converted);
+                }
+                SDL_DestroySurface(surface);
+            }
+        } else {
+            size_t size;
+            void *code = SDL_LoadFile(asset.loose_path.c_str(), &size);
+            if (code != NULL) {
+                checksum += size;
+                SDL_free(code);
+            }
+        }
+    }
+    return checksum;
+}
+
+// Map, look every asset up and touch each page of its payload so cold runs pay for the I/O.
+static Uint64 LoadPacked(const char *pack_path, const std::vector<BenchAsset> &assets)
+{
+    AssetPack *pack = OpenAssetPackFromPath(pack_path);
+    if (pack == NULL) {
+        return 0;
+    }
+    Uint64 checksum = 0;
+    for (const BenchAsset &asset : assets) {
+        Uint64 size = 0;
+        const Uint8 *data = static_cast<const Uint8*>(FindPackedAsset(pack, asset.name.c_str(), asset.type, &size));
+        for (Uint64 offset = 0; data != NULL && offset < size; offset += 4096) {
+            checksum += data[offset];
+        }
+    }
+    CloseAssetPack(pack);
+    return checksum;
+}
+
+static int Bench(const char *assets_dir, const char *pack_path)
+{
+    AssetPack *pack = OpenAssetPackFromPath(pack_path);
+    if (pack == NULL) {
+        return 1;
+    }
+
+    // Read the table of contents back out of the pack to find the loose equivalents.
+    std::string root = assets_dir;
+    while (!root.empty() && (root.back() == '/' || root.back() == '\\')) {
+        root.pop_back();
+    }
+    CookContext context;
+    SDL_EnumerateDirectory(root.c_str(), CollectFile, &context.files);
+
+    std::vector<BenchAsset> assets;
+    for (const std::string &path : context.files) {
+        std::string name = "assets" + path.substr(root.size());
+        std::replace(name.begin(), name.end(), '\\', '/');
+
+        BenchAsset asset;
+        if (EndsWith(name, ".bmp") && GetPackedImage(pack, name.c_str()) != NULL) {
+            asset.name = name;
+            asset.loose_path = path;
+            asset.type = ASSET_PACK_TYPE_IMAGE;
+            assets.push_back(asset);
+        } else if (EndsWith(name, ".hlsl")) {
+            std::string shader_name = name.substr(0, name.size() - 5);
+            std::string spirv_path = path.substr(0, path.size() - 5) + ".spv";
+            SDL_PathInfo info;
+            if (SDL_GetPathInfo(spirv_path.c_str(), &info) &&
+                FindPackedAsset(pack, shader_name.c_str(), ASSET_PACK_TYPE_SHADER, NULL) != NULL) {
+                asset.name = shader_name;
+                asset.loose_path = spirv_path;
+                asset.type = ASSET_PACK_TYPE_SHADER;
+                assets.push_back(asset);
+            }
+        }
+    }
+    CloseAssetPack(pack);
+
+    const int warm_runs = 10;
+    double loose_cold = 0.0, pack_cold = 0.0;
+    double loose_warm = 1e30, pack_warm = 1e30;
+    Uint64 checksum = 0;
+
+#ifdef __linux__
+    for (const BenchAsset &asset : assets) {
+        DropFromPageCache(asset.loose_path.c_str());
+    }
+    Uint64 start = SDL_GetTicksNS();
+    checksum += LoadLoose(assets);
+    loose_cold = (SDL_GetTicksNS() - start) / 1e6;
+
+    DropFromPageCache(pack_path);
+    start = SDL_GetTicksNS();
+    checksum += LoadPacked(pack_path, assets);
+    pack_cold = (SDL_GetTicksNS() - start) / 1e6;
+#endif
+
+    for (int run = 0; run < warm_runs; run++) {
+        Uint64 start_ticks = SDL_GetTicksNS();
+        checksum += LoadLoose(assets);
+        loose_warm = SDL_min(loose_warm, (SDL_GetTicksNS() - start_ticks) / 1e6);
+
+        start_ticks = SDL_GetTicksNS();
+        checksum += LoadPacked(pack_path, assets);
+        pack_warm = SDL_min(pack_warm, (SDL_GetTicksNS() - start_ticks) / 1e6);
+    }
+
+    SDL_Log("%u assets compared (checksum %" SDL_PRIu64 ")", (Uint32)assets.size(), checksum);
+#ifdef __linux__
+    SDL_Log("cold: loose %8.3f ms   pack %8.3f ms", loose_cold, pack_cold);
+#else
+    SDL_Log("cold: not measured (no page cache control on this platform)");
+#endif
+    SDL_Log("warm: loose %8.3f ms   pack %8.3f ms   (best of %d)", loose_warm, pack_warm, warm_runs);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Compute shader check
+// ---------------------------------------------------------------------------
+
+typedef struct ExpectedComputeShader
+{
+    const char *name;       // Under Shaders/Source, without .hlsl
+    Uint32 num_samplers;
+    Uint32 num_readonly_storage_textures;
+    Uint32 num_readonly_storage_buffers;
+    Uint32 num_readwrite_storage_textures;
+    Uint32 num_readwrite_storage_buffers;
+    Uint32 num_uniform_buffers;
+    Uint32 threadcount_x;
+    Uint32 threadcount_y;
+    Uint32 threadcount_z;
+} ExpectedComputeShader;
+
+// What each source declares; a new .comp has to be added here.
+static const ExpectedComputeShader EXPECTED_COMPUTE_SHADERS[] = {
+    { "FillTexture.comp", 0, 0, 0, 1, 0, 0, 8, 8, 1 },
+    { "GradientTexture.comp", 0, 0, 0, 1, 0, 1, 8, 8, 1 },
+    { "LinearToSRGB.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+    { "LinearToST2084.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+    { "SpriteBatch.comp", 0, 0, 1, 0, 1, 0, 64, 1, 1 },
+    { "TexturedQuad.comp", 1, 0, 0, 1, 0, 1, 8, 8, 1 },
+    { "ToneMapACES.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+    { "ToneMapExtendedReinhardLuminance.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+    { "ToneMapHable.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+    { "ToneMapReinhard.comp", 0, 1, 0, 1, 0, 0, 8, 8, 1 },
+};
+
+static bool CheckComputeShader(const std::string &path, const ExpectedComputeShader *expected)
+{
+    size_t source_size;
+    char *source = static_cast<char*>(SDL_LoadFile(path.c_str(), &source_size));
+    if (source == NULL) {
+        SDL_Log("FAIL: could not load %s", path.c_str());
+        return false;
+    }
+    std::string include_dir = path.substr(0, path.find_last_of("/\\"));
+
+    SDL_ShaderCross_HLSL_Info hlsl_info;
+    SDL_zero(hlsl_info);
+    hlsl_info.source = source;
+    hlsl_info.entrypoint = "main";
+    hlsl_info.include_dir = include_dir.c_str();
+    hlsl_info.shader_stage = SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
+    hlsl_info.name = path.c_str();
+
+    size_t spirv_size = 0;
+    void *spirv = SDL_ShaderCross_CompileSPIRVFromHLSL(&hlsl_info, &spirv_size);
+    SDL_free(source);
+    if (spirv == NULL) {
+        SDL_Log("FAIL: could not compile %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+    SDL_ShaderCross_ComputePipelineMetadata *metadata = SDL_ShaderCross_ReflectComputeSPIRV(static_cast<Uint8*>(spirv), spirv_size, 0);
+    SDL_free(spirv);
+    if (metadata == NULL) {
+        SDL_Log("FAIL: could not reflect %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    bool matches =
+        metadata->num_samplers == expected->num_samplers &&
+        metadata->num_readonly_storage_textures == expected->num_readonly_storage_textures &&
+        metadata->num_readonly_storage_buffers == expected->num_readonly_storage_buffers &&
+        metadata->num_readwrite_storage_textures == expected->num_readwrite_storage_textures &&
+        metadata->num_readwrite_storage_buffers == expected->num_readwrite_storage_buffers &&
+        metadata->num_uniform_buffers == expected->num_uniform_buffers &&
+        metadata->threadcount_x == expected->threadcount_x &&
+        metadata->threadcount_y == expected->threadcount_y &&
+        metadata->threadcount_z == expected->threadcount_z;
+    // samplers, read-only textures/buffers, read-write textures/buffers, uniforms; threads
+    const char *format = "%s %s: %u, %u/%u, %u/%u, %u; %ux%ux%u";
+    SDL_Log(format, matches ? "ok  " : "FAIL", expected->name,
+            metadata->num_samplers, metadata->num_readonly_storage_textures, metadata->num_readonly_storage_buffers,
+            metadata->num_readwrite_storage_textures, metadata->num_readwrite_storage_buffers, metadata->num_uniform_buffers,
+            metadata->threadcount_x, metadata->threadcount_y, metadata->threadcount_z);
+    if (!matches) {
+        SDL_Log(format, "    ", "expected",
+                expected->num_samplers, expected->num_readonly_storage_textures, expected->num_readonly_storage_buffers,
+                expected->num_readwrite_storage_textures, expected->num_readwrite_storage_buffers, expected->num_uniform_buffers,
+                expected->threadcount_x, expected->threadcount_y, expected->threadcount_z);
+    }
+    SDL_free(metadata);
+    return matches;
+}
+
+static int CheckComputeShaders(const char *assets_dir)
+{
+    std::string root = assets_dir;
+    while (!root.empty() && (root.back() == '/' || root.back() == '\\')) {
+        root.pop_back();
+    }
+    std::string source_dir = root + "/Shaders/Source/";
+    std::vector<std::string> files;
+    SDL_EnumerateDirectory(source_dir.c_str(), CollectFile, &files);
+    std::sort(files.begin(), files.end());
+
+    if (!SDL_ShaderCross_Init()) {
+        SDL_Log("ShaderCross failed to initialize!");
+        return 1;
+    }
+
+    int failures = 0;
+    int checked = 0;
+    for (const std::string &path : files) {
+        if (!EndsWith(path, ".comp.hlsl")) {
+            continue;
+        }
+        std::string name = path.substr(source_dir.size(), path.size() - source_dir.size() - 5);
+        const ExpectedComputeShader *expected = NULL;
+        for (const ExpectedComputeShader &shader : EXPECTED_COMPUTE_SHADERS) {
+            if (name == shader.name) {
+                expected = &shader;
+            }
+        }
+        if (expected == NULL) {
+            SDL_Log("FAIL %s: not in EXPECTED_COMPUTE_SHADERS", name.c_str());
+            failures++;
+            continue;
+        }
+        failures += CheckComputeShader(path, expected) ? 0 : 1;
+        checked++;
+    }
+    if (checked != (int)SDL_arraysize(EXPECTED_COMPUTE_SHADERS)) {
+        SDL_Log("FAIL: %d of %d expected compute shaders found in %s", checked,
+                (int)SDL_arraysize(EXPECTED_COMPUTE_SHADERS), source_dir.c_str());
+        failures++;
+    }
+
+    SDL_ShaderCross_Quit();
+    SDL_Log("%d compute shaders reflected, %d failures", checked, failures);
+    return failures > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && SDL_strcmp(argv[1], "--bench") == 0) {
+        return Bench(argv[2], argv[3]);
+    }
+    if (argc == 3 && SDL_strcmp(argv[1], "--check-shaders") == 0) {
+        return CheckComputeShaders(argv[2]);
+    }
+    if (argc != 3) {
+        SDL_Log("Usage: %s <assets dir> <output pack>", argv[0]);
+        SDL_Log("       %s --bench <assets dir> <pack>", argv[0]);
+        SDL_Log("       %s --check-shaders <assets dir>", argv[0]);
+        return 1;
+    }
+    return Cook(argv[1], argv[2]) ? 0 : 1;
+}